@@ -0,0 +1,88 @@
+#version 120
+
+/**
+ * @project Spring RTS
+ * @file AdvSkyCloudsFragProg.glsl
+ * @brief Evaluates the CAdvSky cloud field on the GPU, replacing the
+ *        per-frame CPU generation of cloudDot3Tex (octave convolution,
+ *        thickness and shading transforms in CAdvSky::Update). One
+ *        texel per cloud-field cell; cloud drift is applied by the
+ *        texture matrix of the sky-dome pass as before.
+ *
+ * Copyright (C) 2008.  Licensed under the terms of the
+ * GNU GPL, v2 or later.
+ */
+
+uniform sampler2D randTex;     // 12 stacked 32x32 random slices, nearest
+uniform float octaveFades[6];  // cross-fade between the two slices of each octave
+uniform float cloudDensity;
+
+const float CLOUD_SIZE = 256.0;
+const float NUM_SLICES = 12.0;
+
+float Texel(float slice, vec2 ij) {
+	// the octave grids wrap at 32 cells, like the old kernel loops
+	vec2 wij = mod(ij, 32.0);
+	return texture2D(randTex, vec2((wij.x + 0.5) / 32.0, (slice * 32.0 + wij.y + 0.5) / (NUM_SLICES * 32.0))).x;
+}
+
+float SampleOctave(int a, vec2 cell) {
+	// smoothstep-weighted bilinear lookup, matching the CPU kernel
+	vec2 base = floor(cell);
+	vec2 w = smoothstep(0.0, 1.0, cell - base);
+
+	float fade = octaveFades[a];
+	float sliceA = float(a);
+	float sliceB = float(a) + 6.0;
+
+	float v00 = mix(Texel(sliceB, base                 ), Texel(sliceA, base                 ), fade);
+	float v10 = mix(Texel(sliceB, base + vec2(1.0, 0.0)), Texel(sliceA, base + vec2(1.0, 0.0)), fade);
+	float v01 = mix(Texel(sliceB, base + vec2(0.0, 1.0)), Texel(sliceA, base + vec2(0.0, 1.0)), fade);
+	float v11 = mix(Texel(sliceB, base + vec2(1.0, 1.0)), Texel(sliceA, base + vec2(1.0, 1.0)), fade);
+
+	return mix(mix(v00, v10, w.x), mix(v01, v11, w.x), w.y);
+}
+
+float RawClouds(vec2 pos) {
+	// sum of CLOUD_DETAIL octaves; octave a has grid spacing 32 >> a
+	// cells and weight 256 >> a, its grid point b sits at cell
+	// b * spacing + (spacing - 1)
+	float raw = 0.0;
+
+	for (int a = 0; a < 6; a++) {
+		float spacing = exp2(5.0 - float(a));
+		vec2 cell = (pos - (spacing - 1.0)) / spacing;
+
+		raw += SampleOctave(a, cell) * exp2(8.0 - float(a));
+	}
+
+	// slices hold unsigned bytes, undo the sampler normalization
+	return raw * 255.0;
+}
+
+float CloudThickness(float raw) {
+	// analytic form of the old alphaTransform[raw >> 7] table
+	float f = (1535.0 - raw / 128.0 - cloudDensity * 1024.0) / 1023.0;
+	return clamp(pow(max(f * 2.0, 0.0), 3.0), 0.0, 1.0) * 255.0;
+}
+
+void main() {
+	vec2 pos = gl_TexCoord[0].st * CLOUD_SIZE;
+
+	float raw = RawClouds(pos);
+	float thickness = CloudThickness(raw);
+
+	// vertical thickness gradient, standing in for the incremental
+	// column filter the CPU ran over ydif[]
+	float dif = (CloudThickness(RawClouds(pos + vec2(0.0, 2.0))) - CloudThickness(RawClouds(pos - vec2(0.0, 2.0)))) * 0.5;
+
+	// analytic form of the old thicknessTransform[raw >> 7] table
+	float f = (1535.0 - raw / 128.0 - cloudDensity * 1024.0) / 1023.0;
+	float d = min(1.0, f * 2.0);
+
+	float shade = clamp(128.0 + dif, 0.0, 255.0);
+	float sunThrough = 128.0 + d * 64.0 + thickness * 0.25;
+	float cover = clamp(raw / 256.0 - (1.0 - cloudDensity) * 256.0, 0.0, 255.0);
+
+	gl_FragColor = vec4(shade / 255.0, sunThrough / 255.0, 1.0, cover / 255.0);
+}
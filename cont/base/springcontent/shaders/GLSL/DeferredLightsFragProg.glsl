@@ -0,0 +1,68 @@
+#version 120
+
+// applies all dynamic point-lights binned into this fragment's screen
+// tile in a single pass over the geometry-buffer attachments; the tile
+// texture holds MAX_TILE_LIGHTS light slots per tile, each slot being
+// two RGBA32F texels (position + radius, color + unused)
+
+uniform sampler2D normTex;
+uniform sampler2D diffTex;
+uniform sampler2D depthTex;
+// depth of the other geometry-buffer (models when lighting ground and
+// vice versa); used to reject fragments covered by the other buffer
+uniform sampler2D otherDepthTex;
+uniform sampler2D tileTex;
+
+uniform mat4 viewProjMatrixInv; // pre-biased from [0,1]^3, see drawer
+
+uniform vec2 invScreenSize;
+uniform vec2 invTileTexSize;
+uniform vec2 viewPos;
+uniform float tilePixels;
+uniform float haveOtherDepth;
+
+void main() {
+	vec2 screenCoord = (gl_FragCoord.st - vec2(0.5)) * invScreenSize;
+
+	float z = texture2D(depthTex, screenCoord).x;
+
+	// no geometry was written here (cleared depth)
+	if (z >= 0.9999)
+		discard;
+
+	// covered by the nearer fragment of the other buffer
+	float zOther = mix(1.0, texture2D(otherDepthTex, screenCoord).x, haveOtherDepth);
+	if (zOther < (z - 0.0001))
+		discard;
+
+	vec4 worldPos4 = viewProjMatrixInv * vec4(screenCoord, z, 1.0);
+	vec3 worldPos = worldPos4.xyz / worldPos4.w;
+
+	vec3 normal = normalize(texture2D(normTex, screenCoord).xyz * 2.0 - vec3(1.0));
+	vec3 albedo = texture2D(diffTex, screenCoord).rgb;
+
+	vec2 tile = floor((gl_FragCoord.st - viewPos) / tilePixels);
+	float slotBase = tile.x * float(MAX_TILE_LIGHTS * 2);
+	float tileRow = (tile.y + 0.5) * invTileTexSize.y;
+
+	vec3 light = vec3(0.0);
+
+	for (int i = 0; i < MAX_TILE_LIGHTS; i++) {
+		vec4 posRad = texture2D(tileTex, vec2((slotBase + float(i * 2) + 0.5) * invTileTexSize.x, tileRow));
+
+		// empty slot terminates the tile's list
+		if (posRad.w <= 0.0)
+			break;
+
+		vec4 color = texture2D(tileTex, vec2((slotBase + float(i * 2) + 1.5) * invTileTexSize.x, tileRow));
+
+		vec3 lightVec = posRad.xyz - worldPos;
+		float lightDist = length(lightVec);
+		float atten = max(0.0, 1.0 - lightDist / posRad.w);
+		float cosAng = max(0.0, dot(normal, lightVec / max(lightDist, 1.0)));
+
+		light += color.rgb * (atten * atten * cosAng);
+	}
+
+	gl_FragColor = vec4(light * albedo, 1.0);
+}
@@ -0,0 +1,6 @@
+#version 120
+
+// the tile quads are submitted directly in NDC, no transform needed
+void main() {
+	gl_Position = vec4(gl_Vertex.xyz, 1.0);
+}
@@ -12,6 +12,7 @@ uniform vec3 camRight;
 
 uniform float frame;
 uniform vec3 windSpeed;
+uniform vec2 grassFadeDists; // x = maxDetailedDist, y = maxGrassDist
 
 uniform vec3 sunDir;
 uniform vec3 ambientLightColor;
@@ -99,7 +100,13 @@ void main() {
 	ambientDiffuseLightTerm = ambientLightColor + diffuseTerm * diffuseLightColor;
 #else
 	// billboards
-	gl_FrontColor.a *= gl_Normal.z; // alpha blend far turfs
+	// gl_Normal.z carries a per-square random in [1.0, 1.5]; computing the
+	// distance fade here (instead of when filling the arrays) keeps the
+	// billboard geometry camera-independent
+	float camDist = distance(camPos.xyz, gl_Vertex.xyz);
+	float gStep = clamp((camDist + 128.0 - grassFadeDists.y) / 127.0, 0.0, 1.0);
+	float dStep = clamp((camDist - grassFadeDists.x) / (128.0 * gl_Normal.z), 0.0, 1.0);
+	gl_FrontColor.a *= min(1.0 - gStep, dStep); // alpha blend far turfs
 	vec4 worldPos = /* gl_ModelViewMatrix * */ gl_Vertex; // MVM is empty in far draw pass
 
 	// get the camera angle on the billboard and select the corresponding sprite
@@ -0,0 +1,67 @@
+#version 120
+
+/**
+ * @project Spring RTS
+ * @file SMFShadingTexFragProg.glsl
+ * @brief Regenerates the SMF shading texture on the GPU from the
+ *        resident heightmap texture (see HeightMapTexture), replacing
+ *        the amortized CPU loop in CSMFReadMap::UpdateShadingTexture.
+ *        One texel per ground square; mirrors UpdateShadingTexPart.
+ *
+ * Copyright (C) 2009.  Licensed under the terms of the
+ * GNU GPL, v2 or later.
+ */
+
+uniform sampler2D heightMapTex;     // corner heights, (mapx+1) x (mapy+1), nearest
+uniform sampler2D waterColorsTex;   // waterHeightColors table, 1024 x 1
+
+uniform vec2 mapSize;               // (mapx, mapy) in ground squares
+uniform vec2 heightMapSizeInv;      // 1.0 / (mapx+1, mapy+1)
+uniform vec3 lightDir;
+uniform vec3 groundAmbientColor;    // premultiplied by SMF_INTENSITY_MULT
+uniform vec3 groundDiffuseColor;    // premultiplied by SMF_INTENSITY_MULT
+
+const float SQUARE_SIZE = 8.0;
+
+float CornerHeight(vec2 texel) {
+	return texture2D(heightMapTex, (texel + 0.5) * heightMapSizeInv).x;
+}
+
+void main() {
+	// gl_TexCoord[0].st spans the updated sub-rect in square coords
+	vec2 sq = floor(gl_TexCoord[0].st);
+
+	float hTL = CornerHeight(sq + vec2(0.0, 0.0));
+	float hTR = CornerHeight(sq + vec2(1.0, 0.0));
+	float hBL = CornerHeight(sq + vec2(0.0, 1.0));
+	float hBR = CornerHeight(sq + vec2(1.0, 1.0));
+
+	float height = (hTL + hTR + hBL + hBR) * 0.25;
+
+	// center normal, same two-face construction as UpdateFaceNormals
+	vec3 fnTL = normalize(vec3(-(hTR - hTL), SQUARE_SIZE, -(hBL - hTL)));
+	vec3 fnBR = normalize(vec3(  hBL - hBR , SQUARE_SIZE,   hTR - hBR ));
+	vec3 normal = normalize(fnTL + fnBR);
+
+	float diffuseCoeff = clamp(dot(lightDir, normal), 0.0, 1.0);
+	vec3 light = min(groundAmbientColor + groundDiffuseColor * diffuseCoeff, vec3(1.0));
+
+	if (height < 0.0) {
+		// underwater; modulate the absorption table like the CPU path
+		float tableIdx = min(-height, 1023.0);
+		vec3 waterColor = texture2D(waterColorsTex, vec2((tableIdx + 0.5) / 1024.0, 0.5)).rgb;
+
+		float lightIntensity = min((diffuseCoeff + 0.2) * 2.0, 1.0);
+		vec3 color = waterColor * lightIntensity;
+
+		if (height > -10.0) {
+			float wc = -height * 0.1;
+			color = waterColor * (lightIntensity * wc) + light * (1.0 - wc);
+		}
+
+		// alpha = EncodeHeight(height)
+		gl_FragColor = vec4(color, clamp((255.0 + 10.0 * height) / 255.0, 0.0, 1.0));
+	} else {
+		gl_FragColor = vec4(light, 1.0);
+	}
+}
@@ -62,6 +62,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <tuple>
 
 // Cast id to unsigned to catch negative ids in the same operations,
 // cast MAX_* to unsigned to suppress GCC comparison between signed/unsigned warning.
@@ -384,7 +385,7 @@ int CAICallback::GiveOrder(int unitId, Command* c)
 	if (unit->team != team)
 		return -5;
 
-	clientNet->Send(CBaseNetProtocol::Get().SendAICommand(gu->myPlayerNum, skirmishAIHandler.GetCurrentAIID(), unitId, c->GetID(), c->aiCommandId, c->options, c->params));
+	clientNet->Send(CBaseNetProtocol::Get().SendAICommand(gu->myPlayerNum, skirmishAIHandler.GetCurrentAIID(), unitId, c->GetID(), c->aiCommandId, c->options, std::vector<float>(c->params.begin(), c->params.end())));
 	return 0;
 }
 
@@ -806,31 +807,6 @@ float CAICallback::GetPathNodeCost(unsigned int x, unsigned int z) {
 
 
 
-static int FilterUnitsVector(const std::vector<CUnit*>& units, int* unitIds, int unitIds_max, bool (*includeUnit)(const CUnit*) = NULL)
-{
-	int a = 0;
-
-	if (unitIds_max < 0) {
-		unitIds = NULL;
-		unitIds_max = MAX_UNITS;
-	}
-
-	std::vector<CUnit*>::const_iterator ui;
-	for (ui = units.begin(); (ui != units.end()) && (a < unitIds_max); ++ui) {
-		CUnit* u = *ui;
-
-		if ((includeUnit == NULL) || (*includeUnit)(u)) {
-			if (unitIds != NULL) {
-				unitIds[a] = u->id;
-			}
-			a++;
-		}
-	}
-
-	return a;
-}
-
-
 static inline bool unit_IsNeutral(const CUnit* unit) {
 	return unit->IsNeutral();
 }
@@ -886,27 +862,92 @@ static inline bool unit_IsNeutralAndInLos(const CUnit* unit) {
 	return (unit_IsNeutral(unit) && unit_IsInLos(unit));
 }
 
+enum {
+	UNITQUERY_ENEMIES_LOS       = 0,
+	UNITQUERY_ENEMIES_RADAR_LOS = 1,
+	UNITQUERY_FRIENDLIES        = 2,
+	UNITQUERY_NEUTRALS_LOS      = 3,
+};
+
+// (query type, ally-team, x, z, radius); position and radius rounded to
+// whole elmos so effectively identical queries coalesce onto one entry
+typedef std::tuple<int, int, int, int, int> UnitQueryKey;
+
+static std::map<UnitQueryKey, std::vector<int> > cachedUnitQueries;
+static int cachedUnitQueriesFrame = -1;
+
+/**
+ * Frame-scoped cache in front of the spatial unit queries below; legacy
+ * AIs issue these dozens of times per frame with identical arguments, and
+ * instances on the same host can share results since the key carries the
+ * ally-team. Entries hold untruncated id lists, so one entry serves calls
+ * with different unitIds_max. You have to set myAllyTeamId before calling
+ * this function. NOT thread safe!
+ */
+static const std::vector<int>& GetCachedUnitQuery(int queryType, const float3& pos, float radius, bool (*includeUnit)(const CUnit*))
+{
+	if (gs->frameNum != cachedUnitQueriesFrame) {
+		cachedUnitQueries.clear();
+		cachedUnitQueriesFrame = gs->frameNum;
+	}
+
+	const UnitQueryKey key(queryType, myAllyTeamId, int(pos.x), int(pos.z), int(radius));
+	const auto it = cachedUnitQueries.find(key);
+
+	if (it != cachedUnitQueries.end())
+		return it->second;
+
+	// a negative radius selects the whole-map variant of the query
+	const std::vector<CUnit*>& units = (radius < 0.0f)?
+		unitHandler->GetActiveUnits():
+		quadField->GetUnitsExact(pos, radius);
+
+	std::vector<int>& cachedUnitIds = cachedUnitQueries[key];
+
+	for (const CUnit* u: units) {
+		if ((*includeUnit)(u))
+			cachedUnitIds.push_back(u->id);
+	}
+
+	return cachedUnitIds;
+}
+
+static int CopyCachedUnitIds(const std::vector<int>& cachedUnitIds, int* unitIds, int unitIds_max)
+{
+	int a = int(cachedUnitIds.size());
+
+	if (unitIds_max >= 0)
+		a = std::min(a, unitIds_max);
+
+	if (unitIds != NULL) {
+		for (int i = 0; i < a; i++) {
+			unitIds[i] = cachedUnitIds[i];
+		}
+	}
+
+	return a;
+}
+
 int CAICallback::GetEnemyUnits(int* unitIds, int unitIds_max)
 {
 	verify();
 	myAllyTeamId = teamHandler->AllyTeam(team);
-	return FilterUnitsVector(unitHandler->GetActiveUnits(), unitIds, unitIds_max, &unit_IsEnemyAndInLos);
+	return CopyCachedUnitIds(GetCachedUnitQuery(UNITQUERY_ENEMIES_LOS, ZeroVector, -1.0f, &unit_IsEnemyAndInLos), unitIds, unitIds_max);
 }
 
 int CAICallback::GetEnemyUnitsInRadarAndLos(int* unitIds, int unitIds_max)
 {
 	verify();
 	myAllyTeamId = teamHandler->AllyTeam(team);
-	return FilterUnitsVector(unitHandler->GetActiveUnits(), unitIds, unitIds_max, &unit_IsEnemyAndInLosOrRadar);
+	return CopyCachedUnitIds(GetCachedUnitQuery(UNITQUERY_ENEMIES_RADAR_LOS, ZeroVector, -1.0f, &unit_IsEnemyAndInLosOrRadar), unitIds, unitIds_max);
 }
 
 int CAICallback::GetEnemyUnits(int* unitIds, const float3& pos, float radius,
 		int unitIds_max)
 {
 	verify();
-	const std::vector<CUnit*>& units = quadField->GetUnitsExact(pos, radius);
 	myAllyTeamId = teamHandler->AllyTeam(team);
-	return FilterUnitsVector(units, unitIds, unitIds_max, &unit_IsEnemyAndInLos);
+	return CopyCachedUnitIds(GetCachedUnitQuery(UNITQUERY_ENEMIES_LOS, pos, radius, &unit_IsEnemyAndInLos), unitIds, unitIds_max);
 }
 
 
@@ -914,16 +955,15 @@ int CAICallback::GetFriendlyUnits(int* unitIds, int unitIds_max)
 {
 	verify();
 	myAllyTeamId = teamHandler->AllyTeam(team);
-	return FilterUnitsVector(unitHandler->GetActiveUnits(), unitIds, unitIds_max, &unit_IsFriendly);
+	return CopyCachedUnitIds(GetCachedUnitQuery(UNITQUERY_FRIENDLIES, ZeroVector, -1.0f, &unit_IsFriendly), unitIds, unitIds_max);
 }
 
 int CAICallback::GetFriendlyUnits(int* unitIds, const float3& pos, float radius,
 		int unitIds_max)
 {
 	verify();
-	const std::vector<CUnit*>& units = quadField->GetUnitsExact(pos, radius);
 	myAllyTeamId = teamHandler->AllyTeam(team);
-	return FilterUnitsVector(units, unitIds, unitIds_max, &unit_IsFriendly);
+	return CopyCachedUnitIds(GetCachedUnitQuery(UNITQUERY_FRIENDLIES, pos, radius, &unit_IsFriendly), unitIds, unitIds_max);
 }
 
 
@@ -931,15 +971,14 @@ int CAICallback::GetNeutralUnits(int* unitIds, int unitIds_max)
 {
 	verify();
 	myAllyTeamId = teamHandler->AllyTeam(team);
-	return FilterUnitsVector(unitHandler->GetActiveUnits(), unitIds, unitIds_max, &unit_IsNeutralAndInLos);
+	return CopyCachedUnitIds(GetCachedUnitQuery(UNITQUERY_NEUTRALS_LOS, ZeroVector, -1.0f, &unit_IsNeutralAndInLos), unitIds, unitIds_max);
 }
 
 int CAICallback::GetNeutralUnits(int* unitIds, const float3& pos, float radius, int unitIds_max)
 {
 	verify();
-	const std::vector<CUnit*>& units = quadField->GetUnitsExact(pos, radius);
 	myAllyTeamId = teamHandler->AllyTeam(team);
-	return FilterUnitsVector(units, unitIds, unitIds_max, &unit_IsNeutralAndInLos);
+	return CopyCachedUnitIds(GetCachedUnitQuery(UNITQUERY_NEUTRALS_LOS, pos, radius, &unit_IsNeutralAndInLos), unitIds, unitIds_max);
 }
 
 
@@ -19,12 +19,15 @@
 #include "Sim/Units/CommandAI/Command.h"
 #include "Sim/Weapons/WeaponDef.h"
 #include "Net/Protocol/NetProtocol.h"
+#include "System/Config/ConfigHandler.h"
 #include "System/Log/ILog.h"
 #include "System/TimeProfiler.h"
 #include "System/SafeUtil.h"
 
 #include "System/creg/STL_Map.h"
 
+CONFIG(int, AIEventBudgetMilliSecs).defaultValue(0).minimumValue(0).description("Per-frame time (in milliseconds) a Skirmish AI may spend handling events before it is reported as slow in the log, 0 disables the check.");
+
 CR_BIND(CEngineOutHandler, )
 CR_REG_METADATA(CEngineOutHandler, (
 	// FIXME:
@@ -135,6 +138,12 @@ void CEngineOutHandler::Update() {
 	const int frame = gs->frameNum;
 
 	DO_FOR_SKIRMISH_AIS(Update(frame))
+
+	// all per-frame events have been delivered at this point, so this
+	// accounts for everything an AI did since the previous sim frame
+	const float budgetMilliSecs = configHandler->GetInt("AIEventBudgetMilliSecs");
+
+	DO_FOR_SKIRMISH_AIS(CheckEventTime(frame, budgetMilliSecs))
 }
 
 
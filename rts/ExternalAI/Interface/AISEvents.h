@@ -56,8 +56,9 @@ enum EventTopic {
 	EVENT_ENEMY_CREATED                = 25,
 	EVENT_ENEMY_FINISHED               = 26,
 	EVENT_LUA_MESSAGE                  = 27,
+	EVENT_UNITS_DAMAGED                = 28,
 };
-const int NUM_EVENTS = 28;
+const int NUM_EVENTS = 29;
 
 
 
@@ -89,6 +90,7 @@ const int NUM_EVENTS = 28;
 		+ sizeof(struct SEnemyCreatedEvent) \
 		+ sizeof(struct SEnemyFinishedEvent) \
 		+ sizeof(struct SLuaMessageEvent) \
+		+ sizeof(struct SUnitsDamagedEvent) \
 		)
 
 /**
@@ -396,6 +398,29 @@ struct SEnemyFinishedEvent {
 	int enemy;
 }; //$ EVENT_ENEMY_FINISHED INTERFACES:Unit(enemy),Enemy(enemy)
 
+/**
+ * This AI event replaces the individual unit-damaged events for AIs that
+ * declare batched-events support in their AIInfo.lua. It carries all damage
+ * dealt to the AIs units since the previous update event in identically
+ * indexed arrays, and is sent at most once per simulation frame, right
+ * before the update event. The semantics of each entry are the same as
+ * those of the unit-damaged event.
+ */
+struct SUnitsDamagedEvent {
+	int numUnits;
+	const int* units;
+	/**
+	 * may contain -1, which means no attacker was directly involveld,
+	 * or the attacker is not visible and cheat events are off
+	 */
+	const int* attackers;
+	const float* damages;
+	const float* dirs_AposF3;
+	const int* weaponDefIds;
+	/// if true, then damage is paralyzation damage, otherwise it is real damage
+	const bool* paralyzers;
+}; //$ EVENT_UNITS_DAMAGED
+
 #ifdef	__cplusplus
 } // extern "C"
 #endif
@@ -2387,6 +2387,24 @@ struct SSkirmishAICallback {
 
 	bool              (CALLING_CONV *Debug_GraphDrawer_isEnabled)(int skirmishAIId);
 
+	/**
+	 * Epoch of the packed unit snapshot (currently the simulation frame).
+	 * The snapshot content can only change when this value changes, so an
+	 * AI that cached the previous epoch may skip re-reading it entirely.
+	 */
+	int               (CALLING_CONV *Unit_getSnapshotEpoch)(int skirmishAIId);
+
+	/**
+	 * Fills identically indexed packed arrays with the state of all units
+	 * currently known to this AI: own allied units plus enemies in LOS or
+	 * radar (all units when cheat events are enabled). The snapshot is
+	 * built at most once per epoch and served from an engine-side cache
+	 * afterwards, which is much cheaper than issuing one scalar query per
+	 * unit and attribute. Any of the output arrays may be NULL, in which
+	 * case the respective attribute is skipped.
+	 */ //$ FETCHER:MULTI:IDs:Unit:unitIds
+	int               (CALLING_CONV *Unit_getSnapshot)(int skirmishAIId, int* unitIds, int* unitDefIds, float* pos_AposF3, float* vel_AposF3, float* health, int units_sizeMax);
+
 };
 
 #if	defined(__cplusplus)
@@ -56,6 +56,14 @@ extern "C" {
 /** [bool: "yes" | "no"] */
 #define SKIRMISH_AI_PROPERTY_LOAD_SUPPORTED          "loadSupported"
 
+/**
+ * [bool: "yes" | "no"]
+ * If "yes", the engine sends this AI batched event types
+ * (eg. EVENT_UNITS_DAMAGED, see AISEvents.h) instead of the
+ * equivalent per-unit events.
+ */
+#define SKIRMISH_AI_PROPERTY_BATCHED_EVENTS          "batchedEvents"
+
 /**
  * [int]
  * The engine version number the AI was compiled for,
@@ -58,6 +58,23 @@ static std::map<int, bool> skirmishAIId_cheatingEnabled;
 static std::map<int, bool> skirmishAIId_usesCheats;
 static std::map<int, int>  skirmishAIId_teamId;
 
+/**
+ * Packed per-frame unit state, built lazily (at most once per epoch) and
+ * shared by all reads of the same epoch.
+ * @see skirmishAiCallback_Unit_getSnapshot
+ */
+struct SUnitSnapshot {
+	int epoch = -1;
+
+	std::vector<int> unitIds;
+	std::vector<int> unitDefIds;
+	std::vector<float> positions;  ///< xyz per unit
+	std::vector<float> velocities; ///< xyz per unit
+	std::vector<float> healths;
+};
+
+static std::map<int, SUnitSnapshot> skirmishAIId_unitSnapshot;
+
 static const size_t MARKERS_MAX_SIZE = 16384;
 static std::vector<PointMarker> tmpPointMarkerArr[MAX_SKIRMISH_AIS];
 static std::vector<LineMarker> tmpLineMarkerArr[MAX_SKIRMISH_AIS];
@@ -4077,6 +4094,85 @@ EXPORT(int) skirmishAiCallback_getFriendlyUnitsIn(int skirmishAIId, float* pos_p
 	return skirmishAIId_callback[skirmishAIId]->GetFriendlyUnits(unitIds, pos_posF3, radius, unitIdsMaxSize);
 }
 
+static const SUnitSnapshot& getUnitSnapshot(int skirmishAIId) {
+	SUnitSnapshot& snapshot = skirmishAIId_unitSnapshot[skirmishAIId];
+
+	const int epoch = skirmishAiCallback_Game_getCurrentFrame(skirmishAIId);
+
+	if (snapshot.epoch == epoch)
+		return snapshot;
+
+	std::vector<int>& unitIds = snapshot.unitIds;
+	unitIds.resize(unitHandler->MaxUnits());
+
+	// with cheats on, getEnemyUnitsInRadarAndLos acts like global-LOS, so
+	// the two fetches together cover every unit the AI may query
+	int numUnits = skirmishAiCallback_getFriendlyUnits(skirmishAIId, &unitIds[0], unitIds.size());
+	numUnits += skirmishAiCallback_getEnemyUnitsInRadarAndLos(skirmishAIId, &unitIds[numUnits], unitIds.size() - numUnits);
+	unitIds.resize(numUnits);
+
+	snapshot.unitDefIds.resize(numUnits);
+	snapshot.positions.resize(numUnits * 3);
+	snapshot.velocities.resize(numUnits * 3);
+	snapshot.healths.resize(numUnits);
+
+	for (int i = 0; i < numUnits; i++) {
+		const int unitId = unitIds[i];
+
+		snapshot.unitDefIds[i] = skirmishAiCallback_Unit_getDef(skirmishAIId, unitId);
+		snapshot.healths[i] = skirmishAiCallback_Unit_getHealth(skirmishAIId, unitId);
+
+		skirmishAiCallback_Unit_getPos(skirmishAIId, unitId, &snapshot.positions[i * 3]);
+		skirmishAiCallback_Unit_getVel(skirmishAIId, unitId, &snapshot.velocities[i * 3]);
+	}
+
+	snapshot.epoch = epoch;
+	return snapshot;
+}
+
+EXPORT(int) skirmishAiCallback_Unit_getSnapshotEpoch(int skirmishAIId) {
+	return skirmishAiCallback_Game_getCurrentFrame(skirmishAIId);
+}
+
+EXPORT(int) skirmishAiCallback_Unit_getSnapshot(
+	int skirmishAIId,
+	int* unitIds,
+	int* unitDefIds,
+	float* pos_AposF3,
+	float* vel_AposF3,
+	float* health,
+	int units_sizeMax
+) {
+	const SUnitSnapshot& snapshot = getUnitSnapshot(skirmishAIId);
+
+	int numUnits = snapshot.unitIds.size();
+
+	if (units_sizeMax >= 0)
+		numUnits = std::min(numUnits, units_sizeMax);
+
+	for (int i = 0; i < numUnits; i++) {
+		if (unitIds != nullptr)
+			unitIds[i] = snapshot.unitIds[i];
+		if (unitDefIds != nullptr)
+			unitDefIds[i] = snapshot.unitDefIds[i];
+		if (health != nullptr)
+			health[i] = snapshot.healths[i];
+
+		if (pos_AposF3 != nullptr) {
+			pos_AposF3[i * 3    ] = snapshot.positions[i * 3    ];
+			pos_AposF3[i * 3 + 1] = snapshot.positions[i * 3 + 1];
+			pos_AposF3[i * 3 + 2] = snapshot.positions[i * 3 + 2];
+		}
+		if (vel_AposF3 != nullptr) {
+			vel_AposF3[i * 3    ] = snapshot.velocities[i * 3    ];
+			vel_AposF3[i * 3 + 1] = snapshot.velocities[i * 3 + 1];
+			vel_AposF3[i * 3 + 2] = snapshot.velocities[i * 3 + 2];
+		}
+	}
+
+	return numUnits;
+}
+
 EXPORT(int) skirmishAiCallback_getNeutralUnits(int skirmishAIId, int* unitIds, int unitIdsMaxSize) {
 	if (skirmishAiCallback_Cheats_isEnabled(skirmishAIId))
 		return skirmishAIId_cheatCallback[skirmishAIId]->GetNeutralUnits(unitIds, unitIdsMaxSize);
@@ -5861,6 +5957,8 @@ static void skirmishAiCallback_init(SSkirmishAICallback* callback) {
 	callback->Unit_Weapon_isShieldEnabled = &skirmishAiCallback_Unit_Weapon_isShieldEnabled;
 	callback->Unit_Weapon_getShieldPower = &skirmishAiCallback_Unit_Weapon_getShieldPower;
 	callback->Debug_GraphDrawer_isEnabled = &skirmishAiCallback_Debug_GraphDrawer_isEnabled;
+	callback->Unit_getSnapshotEpoch = &skirmishAiCallback_Unit_getSnapshotEpoch;
+	callback->Unit_getSnapshot = &skirmishAiCallback_Unit_getSnapshot;
 }
 
 SSkirmishAICallback* skirmishAiCallback_getInstanceFor(
@@ -5888,5 +5986,6 @@ void skirmishAiCallback_release(int skirmishAIId) {
 	skirmishAIId_cCallback.erase(skirmishAIId);
 
 	skirmishAIId_teamId.erase(skirmishAIId);
+	skirmishAIId_unitSnapshot.erase(skirmishAIId);
 }
 
@@ -1349,6 +1349,9 @@ EXPORT(float            ) skirmishAiCallback_Unit_Weapon_getShieldPower(int skir
 
 EXPORT(bool             ) skirmishAiCallback_Debug_GraphDrawer_isEnabled(int skirmishAIId);
 
+EXPORT(int              ) skirmishAiCallback_Unit_getSnapshotEpoch(int skirmishAIId);
+EXPORT(int              ) skirmishAiCallback_Unit_getSnapshot(int skirmishAIId, int* unitIds, int* unitDefIds, float* pos_AposF3, float* vel_AposF3, float* health, int units_sizeMax);
+
 #if	defined(__cplusplus)
 } // extern "C"
 #endif
@@ -19,6 +19,7 @@
 
 #include "Sim/Units/Unit.h"
 #include "Sim/Units/UnitHandler.h"
+#include "Sim/Misc/GlobalConstants.h"
 #include "Sim/Misc/TeamHandler.h"
 
 #include "System/FileSystem/DataDirsAccess.h"
@@ -46,6 +47,16 @@ CR_REG_METADATA(CSkirmishAIWrapper, (
 
 	CR_MEMBER(timerName),
 
+	CR_IGNORED(dmgUnitIds),
+	CR_IGNORED(dmgAttackerIds),
+	CR_IGNORED(dmgAmounts),
+	CR_IGNORED(dmgDirs),
+	CR_IGNORED(dmgWeaponDefIds),
+	CR_IGNORED(dmgParalyzers),
+
+	CR_IGNORED(frameEventTime),
+	CR_IGNORED(lastSlowWarnFrame),
+
 	CR_MEMBER(skirmishAIId),
 	CR_MEMBER(teamId),
 
@@ -53,6 +64,7 @@ CR_REG_METADATA(CSkirmishAIWrapper, (
 	CR_IGNORED(initialized),
 	CR_IGNORED(released),
 	CR_MEMBER(cheatEvents),
+	CR_IGNORED(batchedEvents),
 
 	CR_MEMBER(initOk),
 	CR_MEMBER(dieing),
@@ -66,12 +78,16 @@ CSkirmishAIWrapper::CSkirmishAIWrapper():
 	library(nullptr),
 	sCallback(nullptr),
 
+	frameEventTime(spring_notime),
+	lastSlowWarnFrame(-1),
+
 	skirmishAIId(-1),
 	teamId(-1),
 
 	initialized(false),
 	released(false),
 	cheatEvents(false),
+	batchedEvents(false),
 
 	initOk(false),
 	dieing(false)
@@ -82,12 +98,16 @@ CSkirmishAIWrapper::CSkirmishAIWrapper(const int skirmishAIId):
 	library(nullptr),
 	sCallback(nullptr),
 
+	frameEventTime(spring_notime),
+	lastSlowWarnFrame(-1),
+
 	skirmishAIId(skirmishAIId),
 	teamId(-1),
 
 	initialized(false),
 	released(false),
 	cheatEvents(false),
+	batchedEvents(false),
 
 	initOk(false),
 	dieing(false)
@@ -170,6 +190,8 @@ bool CSkirmishAIWrapper::LoadSkirmishAI(bool postLoad) {
 	const CSkirmishAILibraryInfo& infos = (libManager->GetSkirmishAIInfos().find(key))->second;
 	const bool loadSupported = (infos.GetInfo(SKIRMISH_AI_PROPERTY_LOAD_SUPPORTED) == "yes");
 
+	batchedEvents = (infos.GetInfo(SKIRMISH_AI_PROPERTY_BATCHED_EVENTS) == "yes");
+
 	libManager->ReleaseSkirmishAILibrary(key);
 
 	if (!postLoad || loadSupported)
@@ -338,6 +360,18 @@ void CSkirmishAIWrapper::UnitDamaged(
 	int weaponDefId,
 	bool paralyzer
 ) {
+	if (batchedEvents) {
+		dmgUnitIds.push_back(unitId);
+		dmgAttackerIds.push_back(attackerUnitId);
+		dmgAmounts.push_back(damage);
+		dmgDirs.push_back(dir.x);
+		dmgDirs.push_back(dir.y);
+		dmgDirs.push_back(dir.z);
+		dmgWeaponDefIds.push_back(weaponDefId);
+		dmgParalyzers.push_back(paralyzer);
+		return;
+	}
+
 	float3 cpyDir = dir;
 	const SUnitDamagedEvent evtData = {unitId, attackerUnitId, damage, &cpyDir[0], weaponDefId, paralyzer};
 
@@ -409,7 +443,33 @@ void CSkirmishAIWrapper::EnemyDamaged(
 	HandleEvent(EVENT_ENEMY_DAMAGED, &evtData);
 }
 
+void CSkirmishAIWrapper::FlushDamageEvents() {
+	if (dmgUnitIds.empty())
+		return;
+
+	const SUnitsDamagedEvent evtData = {
+		static_cast<int>(dmgUnitIds.size()),
+		&dmgUnitIds[0],
+		&dmgAttackerIds[0],
+		&dmgAmounts[0],
+		&dmgDirs[0],
+		&dmgWeaponDefIds[0],
+		reinterpret_cast<const bool*>(&dmgParalyzers[0]),
+	};
+
+	HandleEvent(EVENT_UNITS_DAMAGED, &evtData);
+
+	dmgUnitIds.clear();
+	dmgAttackerIds.clear();
+	dmgAmounts.clear();
+	dmgDirs.clear();
+	dmgWeaponDefIds.clear();
+	dmgParalyzers.clear();
+}
+
 void CSkirmishAIWrapper::Update(int frame) {
+	FlushDamageEvents();
+
 	const SUpdateEvent evtData = {frame};
 	HandleEvent(EVENT_UPDATE, &evtData);
 }
@@ -460,11 +520,35 @@ void CSkirmishAIWrapper::SeismicPing(
 }
 
 
+void CSkirmishAIWrapper::CheckEventTime(int frame, float budgetMilliSecs) {
+	const float eventMilliSecs = frameEventTime.toMilliSecsf();
+
+	frameEventTime = spring_notime;
+
+	if (budgetMilliSecs <= 0.0f || eventMilliSecs <= budgetMilliSecs)
+		return;
+	// at most one warning per AI every five seconds
+	if ((lastSlowWarnFrame >= 0) && ((frame - lastSlowWarnFrame) < (5 * GAME_SPEED)))
+		return;
+
+	lastSlowWarnFrame = frame;
+
+	LOG_L(L_WARNING,
+		"Skirmish AI \"%s\" (team %d) spent %.1fms handling events in frame %d (budget is %.0fms)",
+		key.GetShortName().c_str(), teamId, eventMilliSecs, frame, budgetMilliSecs);
+}
+
+
 int CSkirmishAIWrapper::HandleEvent(int topic, const void* data) const {
 	SCOPED_TIMER(timerName.c_str());
 
-	if (!dieing || (topic == EVENT_RELEASE))
-		return library->HandleEvent(skirmishAIId, topic, data);
+	if (!dieing || (topic == EVENT_RELEASE)) {
+		const spring_time eventStartTime = spring_gettime();
+		const int ret = library->HandleEvent(skirmishAIId, topic, data);
+
+		frameEventTime += (spring_gettime() - eventStartTime);
+		return ret;
+	}
 
 	// to prevent log error spam, signal: OK
 	return 0;
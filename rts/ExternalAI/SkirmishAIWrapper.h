@@ -5,11 +5,13 @@
 
 #include "System/Object.h"
 #include "SkirmishAIKey.h"
+#include "System/Misc/SpringTime.h"
 #include "System/Platform/SharedLib.h"
 
 #include <map>
 #include <string>
 #include <memory>
+#include <vector>
 
 class CAICallback;
 class CAICheats;
@@ -92,6 +94,14 @@ public:
 	void CommandFinished(int unitId, int commandId, int commandTopicId);
 	void SeismicPing(int allyTeam, int unitId, const float3& pos, float strength);
 
+	/**
+	 * Compares the time this AI spent inside its library since the last
+	 * call against the per-frame budget (in milliseconds) and logs a
+	 * (rate-limited) warning when it is exceeded, then resets the clock.
+	 * Called once per simulation frame from CEngineOutHandler::Update.
+	 */
+	void CheckEventTime(int frame, float budgetMilliSecs);
+
 	int GetSkirmishAIID() const { return skirmishAIId; }
 	int GetTeamId() const { return teamId; }
 	const SkirmishAIKey& GetKey() const { return key; }
@@ -102,6 +112,12 @@ public:
 private:
 	bool LoadSkirmishAI(bool postLoad);
 
+	/**
+	 * Sends all unit-damage collected since the previous flush as one
+	 * EVENT_UNITS_DAMAGED; only used for AIs with batched-events support.
+	 */
+	void FlushDamageEvents();
+
 	/**
 	 * CAUTION: takes C AI Interface events, not engine C++ ones!
 	 */
@@ -118,6 +134,18 @@ private:
 
 	std::string timerName;
 
+	/// pending damage entries for EVENT_UNITS_DAMAGED (identically indexed)
+	std::vector<int> dmgUnitIds;
+	std::vector<int> dmgAttackerIds;
+	std::vector<float> dmgAmounts;
+	std::vector<float> dmgDirs; ///< xyz per entry
+	std::vector<int> dmgWeaponDefIds;
+	std::vector<char> dmgParalyzers;
+
+	/// time spent inside the AI library since the last CheckEventTime
+	mutable spring_time frameEventTime;
+	/// frame of the last slow-AI warning, for rate-limiting
+	int lastSlowWarnFrame;
 
 	int skirmishAIId;
 	int teamId;
@@ -125,6 +153,8 @@ private:
 	bool initialized;
 	bool released;
 	bool cheatEvents;
+	/// AI opted into batched event delivery (@see SKIRMISH_AI_PROPERTY_BATCHED_EVENTS)
+	bool batchedEvents;
 
 	bool initOk;
 	bool dieing;
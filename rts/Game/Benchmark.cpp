@@ -1,18 +1,28 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
+#include <algorithm>
 #include <vector>
 #include <cstdio>
 
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
 #include "Benchmark.h"
 
 #include "Game.h"
+#include "GameVersion.h"
 #include "GlobalUnsynced.h"
 #include "UI/GuiHandler.h"
 #include "Rendering/GlobalRendering.h"
+#include "Sim/Features/FeatureHandler.h"
+#include "Sim/Features/FeatureMemPool.h"
 #include "Sim/Misc/GlobalConstants.h"
 #include "Sim/Misc/GlobalSynced.h"
+#include "Sim/Projectiles/ProjectileMemPool.h"
 #include "Sim/Units/UnitHandler.h"
-#include "Sim/Features/FeatureHandler.h"
+#include "Sim/Units/UnitMemPool.h"
+#include "Sim/Weapons/WeaponMemPool.h"
 #include "System/TimeProfiler.h"
 
 bool CBenchmark::enabled = false;
@@ -20,6 +30,44 @@ int CBenchmark::startFrame = 0;
 int CBenchmark::endFrame = 5 * 60 * GAME_SPEED;
 
 
+static size_t GetPeakRSSKB()
+{
+#ifdef _WIN32
+	// would need a psapi.lib dependency; left to external tooling
+	return 0;
+#else
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+
+	#ifdef __APPLE__
+	return (usage.ru_maxrss / 1024); // bytes, unlike Linux
+	#else
+	return (usage.ru_maxrss);
+	#endif
+#endif
+}
+
+// v must be sorted ascending; p in [0, 1]
+static float Percentile(const std::vector<float>& v, float p)
+{
+	if (v.empty())
+		return 0.0f;
+
+	return v[std::min(v.size() - 1, size_t(p * v.size()))];
+}
+
+template<typename MapT>
+static void CollectSeries(const MapT& series, std::vector<float>& vals)
+{
+	vals.clear();
+	vals.reserve(series.size());
+
+	for (const auto& pair: series) {
+		vals.push_back(pair.second);
+	}
+}
+
+
 CBenchmark::CBenchmark()
 	: CEventClient("[CBenchmark]", 271990, false)
 {
@@ -64,6 +112,8 @@ CBenchmark::~CBenchmark()
 #ifdef _WIN64
 #pragma GCC diagnostic pop
 #endif
+
+	WriteJSONReport();
 }
 
 void CBenchmark::GameFrame(int gameFrame)
@@ -90,7 +140,118 @@ void CBenchmark::GameFrame(int gameFrame)
 		luaUsage[gameFrame] = profiler.GetPercent("Lua");
 	}
 
-	gu->globalQuit |= (gameFrame == endFrame);
+	if (gameFrame == endFrame) {
+		CaptureEndOfRunStats();
+		gu->globalQuit = true;
+	}
+}
+
+
+void CBenchmark::CaptureEndOfRunStats()
+{
+	// the report itself is written at program exit, when the sim (and
+	// the object pools) no longer exists; grab everything live-only now
+	profiler.GetSpans(profileSpans);
+
+	allocCounts["unitPoolPages"]    = unitMemPool.num_total_pages();
+	allocCounts["featurePoolPages"] = featureMemPool.num_total_pages();
+	allocCounts["projPoolPages"]    = projMemPool.num_total_pages();
+	allocCounts["weaponPoolPages"]  = weaponMemPool.num_total_pages();
+
+	peakRSSKB = GetPeakRSSKB();
+}
+
+
+void CBenchmark::WriteJSONReport() const
+{
+	FILE* pFile = fopen("benchmark.json", "w");
+
+	if (pFile == nullptr)
+		return;
+
+	fprintf(pFile, "{\n");
+	fprintf(pFile, "\"engine\": \"%s\",\n", (SpringVersion::GetFull()).c_str());
+	fprintf(pFile, "\"startFrame\": %d,\n", startFrame);
+	fprintf(pFile, "\"endFrame\": %d,\n", endFrame);
+	fprintf(pFile, "\"peakRSSKB\": " _STPF_ ",\n", peakRSSKB);
+
+	{
+		fprintf(pFile, "\"allocCounts\": {");
+
+		size_t i = 0;
+
+		for (const auto& pair: allocCounts) {
+			fprintf(pFile, "%s\n  \"%s\": " _STPF_, (i++ > 0)? ",": "", pair.first.c_str(), pair.second);
+		}
+
+		fprintf(pFile, "\n},\n");
+	}
+	{
+		// low percentiles are the interesting end for rates
+		const auto writeSeries = [&](const char* name, std::vector<float>& vals, bool first) {
+			std::sort(vals.begin(), vals.end());
+
+			float mean = 0.0f;
+
+			for (const float v: vals) {
+				mean += v;
+			}
+
+			mean /= std::max(size_t(1), vals.size());
+
+			fprintf(pFile, "%s\n  \"%s\": {\"mean\": %f, \"min\": %f, \"p01\": %f, \"p50\": %f, \"max\": %f}",
+				first? "": ",", name, mean,
+				vals.empty()? 0.0f: vals.front(),
+				Percentile(vals, 0.01f),
+				Percentile(vals, 0.50f),
+				vals.empty()? 0.0f: vals.back());
+		};
+
+		std::vector<float> vals;
+
+		fprintf(pFile, "\"series\": {");
+		CollectSeries(simFPS  , vals); writeSeries("simFPS"  , vals,  true);
+		CollectSeries(drawFPS , vals); writeSeries("drawFPS" , vals, false);
+		CollectSeries(realFPS , vals); writeSeries("effFPS"  , vals, false);
+		CollectSeries(luaUsage, vals); writeSeries("luaUsage", vals, false);
+		fprintf(pFile, "\n},\n");
+	}
+	{
+		// aggregate the span-ring snapshot per subsystem timer; high
+		// percentiles are the interesting end for per-scope durations
+		std::map<std::string, std::vector<float>> spansByName;
+
+		for (const CTimeProfiler::ProfileSpan& span: profileSpans) {
+			spansByName[span.name].push_back((span.endNs - span.beginNs) * 1e-6f);
+		}
+
+		fprintf(pFile, "\"subsystems\": {");
+
+		size_t i = 0;
+
+		for (auto& pair: spansByName) {
+			std::vector<float>& durs = pair.second;
+			std::sort(durs.begin(), durs.end());
+
+			float total = 0.0f;
+
+			for (const float d: durs) {
+				total += d;
+			}
+
+			fprintf(pFile, "%s\n  \"%s\": {\"count\": " _STPF_ ", \"totalMs\": %f, \"p50Ms\": %f, \"p90Ms\": %f, \"p99Ms\": %f, \"maxMs\": %f}",
+				(i++ > 0)? ",": "", pair.first.c_str(), durs.size(), total,
+				Percentile(durs, 0.50f),
+				Percentile(durs, 0.90f),
+				Percentile(durs, 0.99f),
+				durs.back());
+		}
+
+		fprintf(pFile, "\n}\n");
+	}
+
+	fprintf(pFile, "}\n");
+	fclose(pFile);
 }
 
 void CBenchmark::DrawWorld()
@@ -4,8 +4,10 @@
 #define _ROAM_MESH_DRAWER_H_
 
 #include <map>
+#include <vector>
 
 #include "System/EventHandler.h"
+#include "System/TimeProfiler.h"
 
 
 class CBenchmark : public CEventClient
@@ -27,6 +29,10 @@ public:
 		features.clear();
 		gameSpeed.clear();
 		luaUsage.clear();
+
+		profileSpans.clear();
+		allocCounts.clear();
+		peakRSSKB = 0;
 	}
 
 	// CEventClient interface
@@ -39,6 +45,14 @@ public:
 	void GameFrame(int gameFrame);
 	void DrawWorld();
 
+private:
+	/// machine-readable companion to benchmark.data; per-subsystem timing
+	/// percentiles, allocation counts and peak RSS for regression tooling
+	void WriteJSONReport() const;
+
+	/// snapshot everything that must be read while the sim is still alive
+	void CaptureEndOfRunStats();
+
 private:
 	std::map<float, float> realFPS;
 	std::map<float, float> drawFPS;
@@ -47,6 +61,10 @@ private:
 	std::map<int, size_t>  features;
 	std::map<int, float>   gameSpeed;
 	std::map<int, float>   luaUsage;
+
+	std::vector<CTimeProfiler::ProfileSpan> profileSpans;
+	std::map<std::string, size_t> allocCounts;
+	size_t peakRSSKB = 0;
 };
 
 #endif // _ROAM_MESH_DRAWER_H_
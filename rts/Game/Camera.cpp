@@ -328,6 +328,42 @@ bool CCamera::InView(const float3& p, float radius) const
 	return (objectVector.dot(frustumPlanes[FRUSTUM_PLANE_BCK]) <= (zPlaneOffsets[1] + radius));
 }
 
+void CCamera::InViewBatched(
+	const float* xs,
+	const float* ys,
+	const float* zs,
+	const float* rs,
+	unsigned char* inView,
+	unsigned int numSpheres
+) const {
+	// same plane set InView(p, radius) tests (LRTB sides plus far);
+	// the loop body is kept free of early-outs and pointer-chasing so
+	// compilers can vectorize it across whole batches of spheres
+	const float planeOffsets[5] = {frustumScales.x, frustumScales.x, frustumScales.y, frustumScales.y, frustumScales.w};
+
+	const float3 planeNormals[5] = {
+		frustumPlanes[FRUSTUM_PLANE_LFT],
+		frustumPlanes[FRUSTUM_PLANE_RGT],
+		frustumPlanes[FRUSTUM_PLANE_TOP],
+		frustumPlanes[FRUSTUM_PLANE_BOT],
+		frustumPlanes[FRUSTUM_PLANE_BCK],
+	};
+
+	for (unsigned int i = 0; i < numSpheres; i++) {
+		const float ox = xs[i] - pos.x;
+		const float oy = ys[i] - pos.y;
+		const float oz = zs[i] - pos.z;
+
+		unsigned char b = 1;
+
+		for (unsigned int n = 0; n < 5; n++) {
+			b &= ((ox * planeNormals[n].x + oy * planeNormals[n].y + oz * planeNormals[n].z) <= (planeOffsets[n] + rs[i]));
+		}
+
+		inView[i] = b;
+	}
+}
+
 
 
 void CCamera::SetVFOV(const float angle)
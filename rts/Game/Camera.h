@@ -92,6 +92,17 @@ public:
 	bool InView(const float3& p, float radius = 0) const;
 	bool InView(const float3& mins, const float3& maxs) const;
 
+	/// batched version of InView(pos, radius); tests a structure-of-arrays
+	/// set of bounding spheres in one sweep and writes 1/0 per sphere
+	void InViewBatched(
+		const float* xs,
+		const float* ys,
+		const float* zs,
+		const float* rs,
+		unsigned char* inView,
+		unsigned int numSpheres
+	) const;
+
 	void GetFrustumSides(float miny, float maxy, float scale, bool negOnly = false);
 	void GetFrustumSide(
 		const float3& normal,
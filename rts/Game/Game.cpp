@@ -40,8 +40,10 @@
 #include "Rendering/Fonts/CFontTexture.h"
 #include "Rendering/Fonts/glFont.h"
 #include "Rendering/CommandDrawer.h"
+#include "Rendering/FarTextureHandler.h"
 #include "Rendering/LineDrawer.h"
 #include "Rendering/GlobalRendering.h"
+#include "Rendering/GL/GlobalUniforms.h"
 #include "Rendering/DebugDrawerAI.h"
 #include "Rendering/HUDDrawer.h"
 #include "Rendering/IconHandler.h"
@@ -81,6 +83,7 @@
 #include "Sim/MoveTypes/MoveDefHandler.h"
 #include "Sim/MoveTypes/MoveTypeFactory.h"
 #include "Sim/Path/IPathManager.h"
+#include "Sim/Path/PathReplayLog.h"
 #include "Sim/Projectiles/ExplosionGenerator.h"
 #include "Sim/Projectiles/Projectile.h"
 #include "Sim/Projectiles/ProjectileHandler.h"
@@ -121,12 +124,25 @@
 #include "System/Sound/ISound.h"
 #include "System/Sound/ISoundChannels.h"
 #include "System/Sync/DumpState.h"
+#include "System/Threading/ThreadPool.h"
 #include "System/TimeProfiler.h"
 
+#include <atomic>
+#include <exception>
+#include <functional>
+
+#ifndef _WIN32
+	#include <cerrno>
+	#include <cstring>
+	#include <sys/wait.h>
+	#include <unistd.h>
+#endif
+
 
 #undef CreateDirectory
 
 CONFIG(bool, GameEndOnConnectionLoss).defaultValue(true);
+CONFIG(int, AutosaveInterval).defaultValue(0).minimumValue(0).description("Minutes between snapshot autosaves to Saves/autosave.ssf, 0 disables them. On POSIX systems the save is written by a forked copy-on-write child while the game simulates on.");
 CONFIG(bool, WindowedEdgeMove).defaultValue(true).description("Sets whether moving the mouse cursor to the screen edge will move the camera across the map.");
 CONFIG(bool, FullscreenEdgeMove).defaultValue(true).description("see WindowedEdgeMove, just for fullscreen mode");
 CONFIG(bool, ShowFPS).defaultValue(false).description("Displays current framerate.");
@@ -135,6 +151,7 @@ CONFIG(bool, ShowSpeed).defaultValue(false).description("Displays current game s
 CONFIG(int, ShowPlayerInfo).defaultValue(1).headlessValue(0);
 CONFIG(float, GuiOpacity).defaultValue(0.8f).minimumValue(0.0f).maximumValue(1.0f).description("Sets the opacity of the built-in Spring UI. Generally has no effect on LuaUI widgets. Can be set in-game using shift+, to decrease and shift+. to increase.");
 CONFIG(std::string, InputTextGeo).defaultValue("");
+CONFIG(float, JobDispatcherBudget).defaultValue(2.0f).minimumValue(0.1f).description("Per-frame time budget (in milliseconds) shared by all deferred background jobs (garbage collection, far-icon creation, shading-texture refreshes, ...).");
 
 
 CGame* game = nullptr;
@@ -159,6 +176,10 @@ CR_REG_METADATA(CGame, (
 	CR_IGNORED(lastUnsyncedUpdateTime),
 	CR_IGNORED(skipLastDrawTime),
 
+	CR_IGNORED(simFrameCostHist),
+	CR_IGNORED(autosaveFrames),
+	CR_IGNORED(autosavePid),
+
 	CR_IGNORED(updateDeltaSeconds),
 	CR_MEMBER(totalGameTime),
 	CR_MEMBER(userInputPrefix),
@@ -259,6 +280,7 @@ CGame::CGame(const std::string& mapName, const std::string& modName, ILoadSaveHa
 	game = this;
 
 	memset(gameID, 0, sizeof(gameID));
+	memset(simFrameCostHist, 0, sizeof(simFrameCostHist));
 
 	// set "Headless" in config overlay (not persisted)
 	configHandler->Set("Headless", (SpringVersion::IsHeadless()) ? 1 : 0, true);
@@ -273,6 +295,9 @@ CGame::CGame(const std::string& mapName, const std::string& modName, ILoadSaveHa
 
 	speedControl = configHandler->GetInt("SpeedControl");
 
+	autosaveFrames = configHandler->GetInt("AutosaveInterval") * 60 * GAME_SPEED;
+	autosavePid = -1;
+
 	playerRoster.SetSortTypeByCode((PlayerRoster::SortType)configHandler->GetInt("ShowPlayerInfo"));
 
 	CInputReceiver::guiAlpha = configHandler->GetFloat("GuiOpacity");
@@ -338,6 +363,8 @@ CGame::~CGame()
 
 void CGame::AddTimedJobs()
 {
+	jobDispatcher.SetUpdateBudget(configHandler->GetFloat("JobDispatcherBudget"));
+
 	{
 		JobDispatcher::Job j;
 
@@ -350,6 +377,7 @@ void CGame::AddTimedJobs()
 
 		j.freq = GAME_SPEED;
 		j.time = (1000.0f / j.freq) * (1 - j.startDirect);
+		j.prio = JobDispatcher::PRIORITY_HIGH;
 		j.name = "EventHandler::CollectGarbage";
 
 		jobDispatcher.AddTimedJob(j);
@@ -365,12 +393,110 @@ void CGame::AddTimedJobs()
 
 		j.freq = 1.0f;
 		j.time = (1000.0f / j.freq) * (1 - j.startDirect);
+		j.prio = JobDispatcher::PRIORITY_LOW;
 		j.name = "Profiler::Update";
 
 		jobDispatcher.AddTimedJob(j);
 	}
+
+	{
+		JobDispatcher::Job j;
+
+		// must run before this Update's sim frames; the queued object
+		// pointers are only valid while no sim has executed since the
+		// draw pass that gathered them (see FarTextureHandler::Queue)
+		j.f = []() -> bool {
+			SCOPED_TIMER("Misc::UpdateQueuedIcons");
+			farTextureHandler->UpdateQueuedIcons();
+			return true;
+		};
+
+		j.freq = 60.0f;
+		j.time = (1000.0f / j.freq) * (1 - j.startDirect);
+		j.prio = JobDispatcher::PRIORITY_NORMAL;
+		j.name = "FarTextureHandler::UpdateQueuedIcons";
+
+		jobDispatcher.AddTimedJob(j);
+	}
+
+	{
+		JobDispatcher::Job j;
+
+		// progressive dynamic-sun refresh; no-op while no crawl is active
+		j.f = []() -> bool {
+			SCOPED_TIMER("Misc::UpdateShadingTexture");
+			readMap->UpdateShadingTexture();
+			return true;
+		};
+
+		j.freq = 60.0f;
+		j.time = (1000.0f / j.freq) * (1 - j.startDirect);
+		j.prio = JobDispatcher::PRIORITY_LOW;
+		j.name = "ReadMap::UpdateShadingTexture";
+
+		jobDispatcher.AddTimedJob(j);
+	}
+}
+
+namespace {
+	/**
+	 * One independent stage of the game-load pipeline, run on the
+	 * ThreadPool while the load thread continues with the next stage.
+	 * Join() blocks until completion and rethrows anything the stage
+	 * threw, so LoadGame's per-phase error handling still applies.
+	 */
+	class AsyncLoadStage {
+	public:
+		~AsyncLoadStage() {
+			// the pool task writes into this object; if an exception
+			// unwinds past the owning frame before Join ran, wait it
+			// out here instead of letting the task scribble on a dead
+			// stack (the stored error is dropped, the active exception
+			// already carries the failure)
+			while (!done.load()) {
+				Watchdog::ClearTimer(WDT_LOAD);
+				spring_sleep(spring_msecs(1));
+			}
+		}
+
+		void Start(const char* stageName, std::function<void()> stageFunc) {
+			assert(done.load());
+			done.store(false);
+
+			ThreadPool::Enqueue([this, stageName, stageFunc]() {
+				ScopedOnceTimer timer(stageName);
+
+				try {
+					stageFunc();
+				} catch (...) {
+					error = std::current_exception();
+				}
+
+				done.store(true);
+			});
+		}
+
+		void Join() {
+			while (!done.load()) {
+				Watchdog::ClearTimer(WDT_LOAD);
+				spring_sleep(spring_msecs(1));
+			}
+
+			if (error == nullptr)
+				return;
+
+			std::exception_ptr e = error;
+			error = nullptr;
+			std::rethrow_exception(e);
+		}
+
+	private:
+		std::exception_ptr error = nullptr;
+		std::atomic<bool> done{true};
+	};
 }
 
+
 void CGame::LoadGame(const std::string& mapName)
 {
 	// NOTE:
@@ -481,6 +607,18 @@ void CGame::LoadDefs()
 {
 	ENTER_SYNCED_CODE();
 
+	AsyncLoadStage soundDefsStage;
+
+	{
+		// independent of the defs parser (own LuaParser instance, the
+		// sound singleton serializes itself), so it runs on the pool
+		// while the gamedata definitions execute on the load thread
+		loadscreen->SetLoadMessage("Loading Sound Definitions");
+		soundDefsStage.Start("Game::LoadDefs (Sound)", []() {
+			sound->LoadSoundDefs("gamedata/sounds.lua", SPRING_VFS_MOD_BASE);
+		});
+	}
+
 	{
 		loadscreen->SetLoadMessage("Loading Radar Icons");
 		icon::iconHandler = new icon::CIconHandler();
@@ -526,10 +664,7 @@ void CGame::LoadDefs()
 	}
 
 	{
-		ScopedOnceTimer timer("Game::LoadDefs (Sound)");
-		loadscreen->SetLoadMessage("Loading Sound Definitions");
-
-		sound->LoadSoundDefs("gamedata/sounds.lua", SPRING_VFS_MOD_BASE);
+		soundDefsStage.Join();
 		chatSound = sound->GetSoundId("IncomingChat");
 	}
 
@@ -541,13 +676,22 @@ void CGame::PreLoadSimulation()
 	ENTER_SYNCED_CODE();
 
 	loadscreen->SetLoadMessage("Creating Smooth Height Mesh");
-	smoothGround = new SmoothHeightMesh(float3::maxxpos, float3::maxzpos, SQUARE_SIZE * 2, SQUARE_SIZE * 40);
+
+	AsyncLoadStage smoothMeshStage;
+
+	// only reads the (by now immutable) heightmap; none of the handlers
+	// below touch the mesh, so it smooths while they parse their defs
+	smoothMeshStage.Start("Game::PreLoadSim (SmoothMesh)", []() {
+		smoothGround = new SmoothHeightMesh(float3::maxxpos, float3::maxzpos, SQUARE_SIZE * 2, SQUARE_SIZE * 40);
+	});
 
 	loadscreen->SetLoadMessage("Creating QuadField & CEGs");
 	moveDefHandler = new MoveDefHandler(defsParser);
 	quadField = new CQuadField(int2(mapDims.mapx, mapDims.mapy), CQuadField::BASE_QUAD_SIZE);
 	damageArrayHandler = new CDamageArrayHandler(defsParser);
 	explGenHandler = new CExplosionGeneratorHandler();
+
+	smoothMeshStage.Join();
 }
 
 void CGame::PostLoadSimulation()
@@ -608,6 +752,26 @@ void CGame::PostLoadSimulation()
 	if (saveFile == nullptr)
 		featureHandler->LoadFeaturesFromMap();
 
+	{
+		ScopedOnceTimer timer("Game::PostLoadSim (PreloadModels)");
+		loadscreen->SetLoadMessage("Preloading Models");
+
+		// queue every referenced model for parsing on the pool's worker
+		// threads while the rest of loading continues; LoadModel is
+		// mutex-guarded, so whatever is not done by first render simply
+		// finishes loading there instead of parsing on demand
+		for (unsigned int i = 1; i < unitDefHandler->unitDefs.size(); i++) {
+			unitDefHandler->unitDefs[i].PreloadModel();
+		}
+
+		for (const auto& pair: featureDefHandler->GetFeatureDefs()) {
+			const FeatureDef* fd = featureDefHandler->GetFeatureDefByID(pair.second);
+
+			if (fd != nullptr)
+				fd->PreloadModel();
+		}
+	}
+
 	wind.LoadWind(mapInfo->atmosphere.minWind, mapInfo->atmosphere.maxWind);
 
 
@@ -764,6 +928,10 @@ void CGame::LoadFinalize()
 			"[" + std::string(__func__) + "] finalized PFS " +
 			"(" + IntToString(dt, "%ld") + "ms, checksum " + IntToString(cs, "%08x") + ")"
 		);
+
+		// replay-benchmark any recorded path requests against the
+		// fresh PFS (no-op unless enabled; see PathReplayLog.h)
+		PathReplayLog::Replay(pathManager);
 	}
 
 	if (CBenchmark::enabled) {
@@ -894,6 +1062,7 @@ void CGame::KillSimulation()
 	spring::SafeDelete(projectileHandler);
 
 	LOG("[Game::%s][3]", __func__);
+	PathReplayLog::Finish();
 	IPathManager::FreeInstance(pathManager);
 
 	spring::SafeDelete(readMap);
@@ -1324,6 +1493,10 @@ bool CGame::Draw() {
 
 		camera->Update();
 
+		// camera/fog fields of the shared uniform block; the shadow
+		// fields follow once CreateShadows has set up its matrices
+		globalUniforms.UpdateFrame();
+
 		if (doDrawWorld)
 			worldDrawer->Draw();
 
@@ -1588,10 +1761,15 @@ void CGame::SimFrame() {
 		}
 		helper->Update();
 		mapDamage->Update();
+		smoothGround->UpdateSmoothMesh();
 		pathManager->Update();
 		unitHandler->Update();
 		projectileHandler->Update();
 		featureHandler->Update();
+		// apply this frame's accumulated explosion damage; must run
+		// after the unit/projectile updates that generate most of it
+		helper->ApplyQueuedExplosions();
+		quadField->Update();
 		{
 			SCOPED_TIMER("Sim::Script");
 			unitScriptEngine->Tick(33);
@@ -1612,6 +1790,25 @@ void CGame::SimFrame() {
 	gu->avgSimFrameTime = mix(gu->avgSimFrameTime, (lastSimFrameTime - lastFrameTime).toMilliSecsf(), 0.05f);
 	gu->avgSimFrameTime = std::max(gu->avgSimFrameTime, 0.001f);
 
+	{
+		// bucket this frame's cost for the next NETMSG_SIMFRAME_COST report
+		const float simFrameMilliSecs = (lastSimFrameTime - lastFrameTime).toMilliSecsf();
+
+		int bucket = 0;
+		while (bucket < 7 && simFrameMilliSecs > NETMSG_SIMFRAME_COST_EDGES_MS[bucket])
+			bucket++;
+
+		if (simFrameCostHist[bucket] < 0xFF)
+			simFrameCostHist[bucket]++;
+
+		// no-op unless a dump threshold was set (/DumpProfileTrace <ms>)
+		profiler.AutoDumpSpanTrace(simFrameMilliSecs);
+	}
+
+	// periodic snapshot autosave; here the synced state is frame-consistent
+	if ((autosaveFrames > 0) && !skipping && !gameOver && ((gs->frameNum % autosaveFrames) == 0))
+		Autosave();
+
 	eventHandler.DbgTimingInfo(TIMING_SIM, lastFrameTime, lastSimFrameTime);
 
 	#ifdef HEADLESS
@@ -1687,9 +1884,12 @@ void CGame::GameEnd(const std::vector<unsigned char>& winningAllyTeams, bool tim
 	for (int i = 0; i < numPlayers; ++i) {
 		record->SetPlayerStats(i, playerHandler->Player(i)->currentStats);
 	}
+	std::vector<TeamStatistics> statHistory;
+
 	for (int i = 0; i < numTeams; ++i) {
 		const CTeam* team = teamHandler->Team(i);
-		record->SetTeamStats(i, team->statHistory);
+		team->GetStatsHistory(statHistory);
+		record->SetTeamStats(i, statHistory);
 		clientNet->Send(CBaseNetProtocol::Get().SendTeamStat(team->teamNum, team->GetCurrentStats()));
 	}
 }
@@ -1947,6 +2147,44 @@ void CGame::SaveGame(const std::string& filename, bool overwrite, bool usecreg)
 }
 
 
+void CGame::Autosave()
+{
+#ifndef _WIN32
+	if (autosavePid > 0) {
+		// reap the previous snapshot child; skip this save if it is still writing
+		if (waitpid(autosavePid, nullptr, WNOHANG) == 0) {
+			LOG_L(L_WARNING, "[Game::%s] previous autosave has not finished yet, skipping", __func__);
+			return;
+		}
+
+		autosavePid = -1;
+	}
+
+	const pid_t pid = fork();
+
+	if (pid < 0) {
+		LOG_L(L_ERROR, "[Game::%s] fork failed (%s), saving synchronously", __func__, strerror(errno));
+		SaveGame("Saves/autosave.ssf", true, true);
+		return;
+	}
+
+	if (pid == 0) {
+		// child; the address space is a copy-on-write snapshot of this exact
+		// sim frame, serialize it and exit without running any destructors
+		// (none of the other threads exist on this side of the fork)
+		SaveGame("Saves/autosave.ssf", true, true);
+		_exit(0);
+	}
+
+	// parent simulates on while the child writes the snapshot
+	autosavePid = pid;
+#else
+	// no fork() here; save synchronously at the requested interval
+	SaveGame("Saves/autosave.ssf", true, true);
+#endif
+}
+
+
 void CGame::ReloadGame()
 {
 	if (saveFile) {
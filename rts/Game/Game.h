@@ -3,6 +3,8 @@
 #ifndef _GAME_H
 #define _GAME_H
 
+#include <deque>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -20,6 +22,10 @@ class Action;
 class ChatMessage;
 class CWorldDrawer;
 
+namespace netcode {
+	class RawPacket;
+}
+
 
 class CGame : public CGameController
 {
@@ -102,6 +108,8 @@ public:
 
 	void ReloadGame();
 	void SaveGame(const std::string& filename, bool overwrite, bool usecreg);
+	/// periodic snapshot save, forked off copy-on-write on POSIX
+	void Autosave();
 
 	void ResizeEvent() override;
 
@@ -140,6 +148,9 @@ private:
 
 	void SendClientProcUsage();
 	void ClientReadNet();
+	void ProcessNetMessage(std::shared_ptr<const netcode::RawPacket>& packet);
+	void ProcessDeferredNetMessages(const spring_time msgProcEndTime);
+	static bool IsDeferrableNetMessage(unsigned char packetCode);
 	void UpdateNumQueuedSimFrames();
 	void UpdateNetMessageProcessingTimeLeft();
 	void SimFrame();
@@ -167,6 +178,14 @@ public:
 	spring_time lastUnsyncedUpdateTime;
 	spring_time skipLastDrawTime;
 
+	/// per-frame sim-time histogram since the last NETMSG_SIMFRAME_COST report
+	unsigned char simFrameCostHist[8];
+
+	/// frames between snapshot autosaves, 0 disables them
+	int autosaveFrames;
+	/// pid of a still-running autosave child, -1 otherwise (POSIX only)
+	int autosavePid;
+
 	float updateDeltaSeconds;
 	/// Time in seconds, stops at game end
 	float totalGameTime;
@@ -203,6 +222,10 @@ public:
 	float msgProcTimeLeft;  ///< How many SimFrame() calls we still may do.
 	float consumeSpeedMult; ///< How fast we should eat NETMSG_NEWFRAMEs.
 
+	/// presentation-only net messages deferred by ClientReadNet, drained
+	/// FIFO with leftover budget so bursts amortize over several frames
+	std::deque<std::shared_ptr<const netcode::RawPacket>> deferredNetPackets;
+
 	int skipStartFrame;
 	int skipEndFrame;
 	int skipTotalFrames;
@@ -12,6 +12,7 @@
 #include "Rendering/Models/3DModel.h"
 #include "Sim/Features/Feature.h"
 #include "Sim/Features/FeatureDef.h"
+#include "Sim/Features/FeatureHandler.h"
 #include "Sim/Misc/BuildingMaskMap.h"
 #include "Sim/Misc/CollisionHandler.h"
 #include "Sim/Misc/CollisionVolume.h"
@@ -51,6 +52,12 @@ void CGameHelper::Init()
 		wdVec.clear();
 		wdVec.reserve(32);
 	}
+
+	queuedExplosions.clear();
+	queuedExplosions.reserve(64);
+	accumDamages.clear();
+	accumDamages.reserve(128);
+	accumDamageIndex.clear();
 }
 
 void CGameHelper::Update()
@@ -73,6 +80,10 @@ void CGameHelper::Update()
 	}
 
 	waitingDamages[wdIdx].clear();
+
+	// catch explosions queued after last frame's flush point
+	// (script ticks, interceptors, delayed damage just above)
+	ApplyQueuedExplosions();
 }
 
 
@@ -148,8 +159,10 @@ void CGameHelper::DoExplosionDamage(
 	DamageArray expDamages = damages * expDistanceMod;
 
 	if (expDist < (expSpeed * DIRECT_EXPLOSION_DAMAGE_SPEED_SCALE)) {
-		// damage directly
-		unit->DoDamage(expDamages, expImpulse, owner, weaponDefID, projectileID);
+		// damage this frame; accumulated so the target takes a single
+		// DoDamage no matter how many explosions hit it, then applied
+		// by FlushAccumulatedDamages
+		AccumulateExplosionDamage(unit->id, false, ((owner != nullptr)? owner->id: -1), weaponDefID, projectileID, expDamages, expImpulse);
 	} else {
 		// damage later
 		waitingDamages[(gs->frameNum + int(expDist / expSpeed) - 3) & (waitingDamages.size() - 1)].emplace_back(std::move(expDamages), expImpulse, ((owner != nullptr)? owner->id: -1), unit->id, weaponDefID, projectileID);
@@ -188,43 +201,186 @@ void CGameHelper::DoExplosionDamage(
 	const float3 impulseDir = (volPos - expPos).SafeNormalize();
 	const float3 expImpulse = impulseDir * modImpulseScale;
 
-	feature->DoDamage(damages * expDistanceMod, expImpulse, owner, weaponDefID, projectileID);
+	AccumulateExplosionDamage(feature->id, true, ((owner != nullptr)? owner->id: -1), weaponDefID, projectileID, damages * expDistanceMod, expImpulse);
 }
 
 
 
-void CGameHelper::DamageObjectsInExplosionRadius(
-	const CExplosionParams& params,
-	const float expRad,
-	const int weaponDefID
+void CGameHelper::AccumulateExplosionDamage(
+	int targetID,
+	bool targetIsFeature,
+	int attackerID,
+	int weaponDefID,
+	int projectileID,
+	const DamageArray& damage,
+	const float3& impulse
 ) {
+	// aggregate per (target, attacker, weaponDef) so kill credit and
+	// experience attribution survive the merge; id's comfortably fit
+	// in 21 bits each
+	const std::uint64_t key =
+		(std::uint64_t(targetIsFeature) << 63) |
+		((std::uint64_t(std::uint32_t(targetID)) & 0x1FFFFF) << 42) |
+		((std::uint64_t(std::uint32_t(attackerID)) & 0x1FFFFF) << 21) |
+		((std::uint64_t(std::uint32_t(weaponDefID)) & 0x1FFFFF));
+
+	const auto it = accumDamageIndex.find(key);
+
+	if (it != accumDamageIndex.end()) {
+		AccumulatedDamage& ad = accumDamages[it->second];
+
+		// paralyzeDamageTime etc. are weaponDef properties, identical
+		// for every entry mapping to this key; projectileID keeps the
+		// first hit's value
+		for (int i = 0, n = ad.damage.GetNumTypes(); i < n; i++)
+			ad.damage.Set(i, ad.damage.Get(i) + damage.Get(i));
+
+		ad.impulse += impulse;
+		return;
+	}
+
+	accumDamageIndex[key] = accumDamages.size();
+	accumDamages.emplace_back();
+
+	AccumulatedDamage& ad = accumDamages.back();
+	ad.targetID = targetID;
+	ad.attackerID = attackerID;
+	ad.weaponDefID = weaponDefID;
+	ad.projectileID = projectileID;
+	ad.targetIsFeature = targetIsFeature;
+	ad.damage = damage;
+	ad.impulse = impulse;
+}
+
+void CGameHelper::FlushAccumulatedDamages()
+{
+	static std::vector<AccumulatedDamage> batch;
+
+	// applying a batch can accumulate new damages (impact-only hits
+	// from death explosions); swap those into a fresh batch and keep
+	// draining until no more arrive
+	while (!accumDamages.empty()) {
+		batch.clear();
+		batch.swap(accumDamages);
+		accumDamageIndex.clear();
+
+		for (const AccumulatedDamage& ad: batch) {
+			CUnit* attacker = unitHandler->GetUnit(ad.attackerID); // null if -1
+
+			if (ad.targetIsFeature) {
+				CFeature* target = featureHandler->GetFeature(ad.targetID);
+
+				if (target != nullptr)
+					target->DoDamage(ad.damage, ad.impulse, attacker, ad.weaponDefID, ad.projectileID);
+			} else {
+				CUnit* target = unitHandler->GetUnit(ad.targetID);
+
+				if (target != nullptr)
+					target->DoDamage(ad.damage, ad.impulse, attacker, ad.weaponDefID, ad.projectileID);
+			}
+		}
+	}
+
+	batch.clear();
+}
+
+void CGameHelper::ProcessExplosionWave(size_t head, size_t tail)
+{
+	static std::vector<unsigned int> clusterIdxs;
 	static std::vector<CUnit*> unitCache;
 	static std::vector<CFeature*> featureCache;
 
-	const unsigned int oldNumUnits = unitCache.size();
-	const unsigned int oldNumFeatures = featureCache.size();
+	for (size_t i = head; i < tail; i++) {
+		if (queuedExplosions[i].clustered)
+			continue;
+
+		// greedily absorb later explosions whose damage sphere fits
+		// inside twice the seed radius around this one; barrages land
+		// on top of each other and collapse into a single query here
+		const float3 clusterPos = queuedExplosions[i].pos;
+		const float maxClusterRad = queuedExplosions[i].radius * 2.0f;
+
+		float clusterRad = queuedExplosions[i].radius;
+
+		clusterIdxs.clear();
+		clusterIdxs.push_back(i);
+		queuedExplosions[i].clustered = true;
+
+		for (size_t j = i + 1; j < tail; j++) {
+			QueuedExplosion& qe = queuedExplosions[j];
 
-	quadField->GetUnitsAndFeaturesColVol(params.pos, expRad, unitCache, featureCache);
+			if (qe.clustered)
+				continue;
+
+			const float expDist = clusterPos.distance(qe.pos);
+
+			if ((expDist + qe.radius) > maxClusterRad)
+				continue;
+
+			clusterRad = std::max(clusterRad, expDist + qe.radius);
+			clusterIdxs.push_back(j);
+			qe.clustered = true;
+		}
+
+		// NOTE:
+		//   the object caches no longer need recursion end-markers;
+		//   damage is only accumulated here, the DoDamage calls that
+		//   can recursively trigger ::Explosion() run later in
+		//   FlushAccumulatedDamages
+		unitCache.clear();
+		featureCache.clear();
 
-	const unsigned int newNumUnits = unitCache.size();
-	const unsigned int newNumFeatures = featureCache.size();
+		quadField->GetUnitsAndFeaturesColVol(clusterPos, clusterRad, unitCache, featureCache);
 
-	// damage all units within the explosion radius
-	// NOTE:
-	//   this can recursively trigger ::Explosion() again
-	//   which would overwrite our object cache if we did
-	//   not keep track of end-markers --> certain objects
-	//   would not be damaged AT ALL (!)
-	for (unsigned int n = oldNumUnits; n < newNumUnits; n++)
-		DoExplosionDamage(unitCache[n], params.owner, params.pos, expRad, params.explosionSpeed, params.edgeEffectiveness, params.ignoreOwner, params.damages, weaponDefID, params.projectileID);
+		for (const unsigned int ei: clusterIdxs) {
+			const QueuedExplosion& qe = queuedExplosions[ei];
+
+			CUnit* owner = unitHandler->GetUnit(qe.ownerID); // null if -1
+
+			// the shared query can return objects well outside this
+			// explosion's own radius; repeat the quadfield bounding
+			// test against it before the (far more expensive)
+			// collision-volume surface distance runs
+			for (CUnit* u: unitCache) {
+				const float totRad = qe.radius + u->collisionVolume.GetBoundingRadius();
+
+				if (qe.pos.SqDistance(u->collisionVolume.GetWorldSpacePos(u)) >= (totRad * totRad))
+					continue;
+
+				DoExplosionDamage(u, owner, qe.pos, qe.radius, qe.expSpeed, qe.edgeEffect, qe.ignoreOwner, qe.damages, qe.weaponDefID, qe.projectileID);
+			}
 
-	unitCache.resize(oldNumUnits);
+			for (CFeature* f: featureCache) {
+				const float totRad = qe.radius + f->collisionVolume.GetBoundingRadius();
+
+				if (qe.pos.SqDistance(f->collisionVolume.GetWorldSpacePos(f)) >= (totRad * totRad))
+					continue;
+
+				DoExplosionDamage(f, owner, qe.pos, qe.radius, qe.edgeEffect, qe.damages, qe.weaponDefID, qe.projectileID);
+			}
+		}
+	}
+}
+
+void CGameHelper::ApplyQueuedExplosions()
+{
+	// flushing a wave can queue new explosions (unit deaths, exploding
+	// ammo storage, ...); these are appended and drained here in the
+	// same call so intra-frame chain reactions still resolve this frame
+	for (size_t head = 0; head < queuedExplosions.size(); ) {
+		const size_t tail = queuedExplosions.size();
+
+		ProcessExplosionWave(head, tail);
+		FlushAccumulatedDamages();
+
+		head = tail;
+	}
 
-	// damage all features within the explosion radius
-	for (unsigned int n = oldNumFeatures; n < newNumFeatures; n++)
-		DoExplosionDamage(featureCache[n], params.owner, params.pos, expRad, params.edgeEffectiveness, params.damages, weaponDefID, params.projectileID);
+	queuedExplosions.clear();
 
-	featureCache.resize(oldNumFeatures);
+	// impact-only hits accumulate without entering the queue; make
+	// sure they are applied even when no area explosion was waiting
+	FlushAccumulatedDamages();
 }
 
 void CGameHelper::Explosion(const CExplosionParams& params) {
@@ -279,7 +435,22 @@ void CGameHelper::Explosion(const CExplosionParams& params) {
 			);
 		}
 	} else {
-		DamageObjectsInExplosionRadius(params, damageAOE, weaponDefID);
+		// queue for ApplyQueuedExplosions; damage application is
+		// batched per frame so overlapping explosions can share
+		// one quadfield query and one DoDamage per target
+		queuedExplosions.emplace_back();
+
+		QueuedExplosion& qe = queuedExplosions.back();
+		qe.pos = params.pos;
+		qe.radius = damageAOE;
+		qe.edgeEffect = params.edgeEffectiveness;
+		qe.expSpeed = params.explosionSpeed;
+		qe.ownerID = (params.owner != nullptr)? params.owner->id: -1;
+		qe.weaponDefID = weaponDefID;
+		qe.projectileID = params.projectileID;
+		qe.ignoreOwner = params.ignoreOwner;
+		qe.clustered = false;
+		qe.damages = damages;
 
 		// deform the map if the explosion was above-ground
 		// (but had large enough radius to touch the ground)
@@ -629,6 +800,78 @@ namespace {
 } // end of namespace
 
 
+namespace {
+	// frame-scoped cache of enemy candidate lists; clustered weapons
+	// whose (allyteam, position, radius) fall into the same buckets
+	// share one QuadField query, per-weapon filtering and priority
+	// scoring still run on top of the shared list
+	struct TargetCandidateList {
+		int allyTeam;
+		int xBucket;
+		int zBucket;
+		int rBucket;
+		std::vector<CUnit*> units;
+	};
+
+	static const float TARGET_CAND_BUCKET_SIZE = 256.0f;
+
+	static int targetCandCacheFrame = -1;
+	static std::vector<TargetCandidateList> targetCandCache;
+
+	const std::vector<CUnit*>& GetEnemyTargetCandidates(int allyTeam, const float3& pos, float searchRadius)
+	{
+		if (targetCandCacheFrame != gs->frameNum) {
+			targetCandCacheFrame = gs->frameNum;
+			targetCandCache.clear();
+		}
+
+		const int xBucket = int(pos.x / TARGET_CAND_BUCKET_SIZE);
+		const int zBucket = int(pos.z / TARGET_CAND_BUCKET_SIZE);
+		const int rBucket = int(searchRadius / TARGET_CAND_BUCKET_SIZE) + 1;
+
+		for (const TargetCandidateList& tcl: targetCandCache) {
+			if (tcl.allyTeam == allyTeam && tcl.xBucket == xBucket && tcl.zBucket == zBucket && tcl.rBucket == rBucket)
+				return tcl.units;
+		}
+
+		targetCandCache.emplace_back();
+		TargetCandidateList& tcl = targetCandCache.back();
+
+		tcl.allyTeam = allyTeam;
+		tcl.xBucket = xBucket;
+		tcl.zBucket = zBucket;
+		tcl.rBucket = rBucket;
+
+		// query from the bucket center with enough padding to cover every
+		// position and radius mapping into this bucket, so the shared list
+		// is a superset of each sharing weapon's own query (out-of-range
+		// extras fail the per-weapon range test)
+		const float3 bucketPos((xBucket + 0.5f) * TARGET_CAND_BUCKET_SIZE, 0.0f, (zBucket + 0.5f) * TARGET_CAND_BUCKET_SIZE);
+		const float bucketRadius = (rBucket + 1) * TARGET_CAND_BUCKET_SIZE;
+
+		const std::vector<int>& quads = quadField->GetQuads(bucketPos, bucketRadius);
+		const int tempNum = gs->GetTempNum();
+
+		for (int t = 0; t < teamHandler->ActiveAllyTeams(); ++t) {
+			if (teamHandler->Ally(allyTeam, t))
+				continue;
+
+			for (const int qi: quads) {
+				for (CUnit* u: quadField->GetQuad(qi).teamUnits[t]) {
+					if (u->tempNum == tempNum)
+						continue;
+
+					u->tempNum = tempNum;
+					tcl.units.push_back(u);
+				}
+			}
+		}
+
+		return tcl.units;
+	}
+} // end of namespace
+
+
 void CGameHelper::GenerateWeaponTargets(const CWeapon* weapon, const CUnit* avoidUnit, std::vector<std::pair<float, CUnit*>>& targets)
 {
 	const CUnit* owner    = weapon->owner;
@@ -644,90 +887,76 @@ void CGameHelper::GenerateWeaponTargets(const CWeapon* weapon, const CUnit* avoi
 	const float secDamage = weapon->damages->GetDefault() * weapon->salvoSize / weapon->reloadTime * GAME_SPEED;
 	const bool paralyzer  = (weapon->damages->paralyzeDamageTime != 0);
 
-	// copy on purpose since the below calls lua
-	const std::vector<int> quads = quadField->GetQuads(pos, radius + (aHeight - std::max(0.0f, readMap->GetInitMinHeight())) * heightMod);
-	const int tempNum = gs->GetTempNum();
+	const float searchRadius = radius + (aHeight - std::max(0.0f, readMap->GetInitMinHeight())) * heightMod;
 
-	for (int t = 0; t < teamHandler->ActiveAllyTeams(); ++t) {
-		if (teamHandler->Ally(owner->allyteam, t))
-			continue;
+	// copy on purpose since the below calls lua, which can retrigger
+	// a cache refill and relocate the shared list in mid-iteration
+	const std::vector<CUnit*> enemyUnits = GetEnemyTargetCandidates(owner->allyteam, pos, searchRadius);
 
-		for (const int qi: quads) {
-			const std::vector<CUnit*>& allyTeamUnits = quadField->GetQuad(qi).teamUnits[t];
+	for (CUnit* targetUnit: enemyUnits) {
+		float targetPriority = 1.0f;
 
-			for (CUnit* targetUnit: allyTeamUnits) {
-				if (targetUnit->tempNum == tempNum)
-					continue;
-
-				targetUnit->tempNum = tempNum;
-
-				float targetPriority = 1.0f;
-
-				if (!weapon->TestTarget(float3(), SWeaponTarget(targetUnit)))
-					continue;
+		if (!weapon->TestTarget(float3(), SWeaponTarget(targetUnit)))
+			continue;
 
-				if (targetUnit == avoidUnit)
-					targetPriority *= 10.0f;
+		if (targetUnit == avoidUnit)
+			targetPriority *= 10.0f;
 
-				float3 targPos;
-				const unsigned short targetLOSState = targetUnit->losStatus[owner->allyteam];
+		float3 targPos;
+		const unsigned short targetLOSState = targetUnit->losStatus[owner->allyteam];
 
-				if (targetLOSState & LOS_INLOS) {
-					targPos = targetUnit->aimPos;
-				} else if (targetLOSState & LOS_INRADAR) {
-					targPos = weapon->GetUnitPositionWithError(targetUnit);
-					targetPriority *= 10.0f;
-				} else {
-					continue;
-				}
+		if (targetLOSState & LOS_INLOS) {
+			targPos = targetUnit->aimPos;
+		} else if (targetLOSState & LOS_INRADAR) {
+			targPos = weapon->GetUnitPositionWithError(targetUnit);
+			targetPriority *= 10.0f;
+		} else {
+			continue;
+		}
 
-				const float modRange = radius + (aHeight - targPos.y) * heightMod;
+		const float modRange = radius + (aHeight - targPos.y) * heightMod;
 
-				if (pos.SqDistance2D(targPos) > modRange * modRange)
-					continue;
+		if (pos.SqDistance2D(targPos) > modRange * modRange)
+			continue;
 
-				const float dist2D = (pos - targPos).Length2D();
-				const float rangeMul = (dist2D * weaponDef->proximityPriority + modRange * 0.4f + 100.0f);
-				const float damageMul = weapon->damages->Get(targetUnit->armorType) * targetUnit->curArmorMultiple;
+		const float dist2D = (pos - targPos).Length2D();
+		const float rangeMul = (dist2D * weaponDef->proximityPriority + modRange * 0.4f + 100.0f);
+		const float damageMul = weapon->damages->Get(targetUnit->armorType) * targetUnit->curArmorMultiple;
 
-				targetPriority *= rangeMul;
+		targetPriority *= rangeMul;
 
-				if (targetLOSState & LOS_INLOS) {
-					targetPriority *= (secDamage + targetUnit->health);
+		if (targetLOSState & LOS_INLOS) {
+			targetPriority *= (secDamage + targetUnit->health);
 
-					if (paralyzer && targetUnit->paralyzeDamage > (modInfo.paralyzeOnMaxHealth? targetUnit->maxHealth: targetUnit->health))
-						targetPriority *= 4.0f;
+			if (paralyzer && targetUnit->paralyzeDamage > (modInfo.paralyzeOnMaxHealth? targetUnit->maxHealth: targetUnit->health))
+				targetPriority *= 4.0f;
 
-					if (weapon->hasTargetWeight)
-						targetPriority *= weapon->TargetWeight(targetUnit);
+			if (weapon->hasTargetWeight)
+				targetPriority *= weapon->TargetWeight(targetUnit);
 
-				} else {
-					targetPriority *= (secDamage + 10000.0f);
-				}
+		} else {
+			targetPriority *= (secDamage + 10000.0f);
+		}
 
-				if (targetLOSState & LOS_PREVLOS) {
-					targetPriority /= (damageMul * targetUnit->power * (0.7f + gsRNG.NextFloat() * 0.6f));
+		if (targetLOSState & LOS_PREVLOS) {
+			targetPriority /= (damageMul * targetUnit->power * (0.7f + gsRNG.NextFloat() * 0.6f));
 
-					if (targetUnit->category & weapon->badTargetCategory)
-						targetPriority *= 100.0f;
+			if (targetUnit->category & weapon->badTargetCategory)
+				targetPriority *= 100.0f;
 
-					if (targetUnit->IsCrashing())
-						targetPriority *= 1000.0f;
+			if (targetUnit->IsCrashing())
+				targetPriority *= 1000.0f;
 
-					if (targetUnit == lastAttacker)
-						targetPriority *= 0.5f;
-				}
+			if (targetUnit == lastAttacker)
+				targetPriority *= 0.5f;
+		}
 
-				const bool allow = eventHandler.AllowWeaponTarget(owner->id, targetUnit->id, weapon->weaponNum, weaponDef->id, &targetPriority);
-				//Lua call may have changed tempNum, so needs to be set again.
-				targetUnit->tempNum = tempNum;
+		const bool allow = eventHandler.AllowWeaponTarget(owner->id, targetUnit->id, weapon->weaponNum, weaponDef->id, &targetPriority);
 
-				if (!allow)
-					continue;
+		if (!allow)
+			continue;
 
-				targets.push_back(std::pair<float, CUnit*>(targetPriority, targetUnit));
-			}
-		}
+		targets.push_back(std::pair<float, CUnit*>(targetPriority, targetUnit));
 	}
 	std::stable_sort(targets.begin(), targets.end(), [](const std::pair<float, CUnit*>& a, const std::pair<float, CUnit*>& b) { return (a.first < b.first); });
 
@@ -8,8 +8,10 @@
 #include "Sim/Units/CommandAI/Command.h"
 #include "System/float3.h"
 #include "System/type2.h"
+#include "System/UnorderedMap.hpp"
 
 #include <array>
+#include <cstdint>
 #include <vector>
 
 
@@ -151,10 +153,29 @@ public:
 		const int projectileID
 	);
 
-	void DamageObjectsInExplosionRadius(const CExplosionParams& params, const float expRad, const int weaponDefID);
 	void Explosion(const CExplosionParams& params);
 
+	/**
+	 * Applies all area explosions queued by Explosion() since the last
+	 * call. Overlapping explosions share a single quadfield query and
+	 * damage against each target is summed per (attacker, weaponDef)
+	 * before one DoDamage (and hence one Lua UnitDamaged event) runs,
+	 * which flattens the sim spikes caused by dense barrages.
+	 */
+	void ApplyQueuedExplosions();
+
 private:
+	void ProcessExplosionWave(size_t head, size_t tail);
+	void AccumulateExplosionDamage(
+		int targetID,
+		bool targetIsFeature,
+		int attackerID,
+		int weaponDefID,
+		int projectileID,
+		const DamageArray& damage,
+		const float3& impulse
+	);
+	void FlushAccumulatedDamages();
 	struct WaitingDamage {
 		WaitingDamage(const DamageArray& _damage, const float3& _impulse, int _attackerID, int _targetID, int _weaponID, int _projectileID)
 		: attackerID(_attackerID)
@@ -174,8 +195,46 @@ private:
 		float3 impulse;
 	};
 
+	struct QueuedExplosion {
+		float3 pos;
+
+		float radius;
+		float edgeEffect;
+		float expSpeed;
+
+		int ownerID;
+		int weaponDefID;
+		int projectileID;
+
+		bool ignoreOwner;
+		bool clustered;
+
+		DamageArray damages;
+	};
+
+	struct AccumulatedDamage {
+		int targetID;
+		int attackerID;
+		int weaponDefID;
+		int projectileID;
+
+		bool targetIsFeature;
+
+		DamageArray damage;
+		float3 impulse;
+	};
+
 	// note: size must be a power of two
 	std::array<std::vector<WaitingDamage>, 128> waitingDamages;
+
+	// area explosions queued this frame, drained by ApplyQueuedExplosions
+	std::vector<QueuedExplosion> queuedExplosions;
+
+	// per-target damage sums for the wave currently being applied; the
+	// map indexes into the vector so application order stays insertion
+	// order (synced code, order must match on all clients)
+	std::vector<AccumulatedDamage> accumDamages;
+	spring::unordered_map<std::uint64_t, unsigned int> accumDamageIndex;
 };
 
 extern CGameHelper* helper;
@@ -10,15 +10,27 @@
 
 class JobDispatcher {
 public:
+	// all deferred background work (garbage collection, far-icon
+	// creation, shading-texture refreshes, stats flushes) shares one
+	// per-frame budget; higher classes are served first when it runs out
+	enum Priority {
+		PRIORITY_HIGH   = 0,
+		PRIORITY_NORMAL = 1,
+		PRIORITY_LOW    = 2,
+		NUM_PRIORITIES  = 3,
+	};
+
 	struct Job {
 	public:
 		Job(const spring_time t = spring_notime)
 		: time(t.toMilliSecsf())
 		, freq(0.0f)
+		, cost(0.0f)
 
 		, startDirect(true)
 		, catchUp(false)
 
+		, prio(PRIORITY_NORMAL)
 		, name("")
 		{}
 
@@ -32,37 +44,66 @@ public:
 
 		float time;
 		float freq;
+		float cost; // EWMA of execution time in msecs, fed back by Update
 
 		bool startDirect;
 		bool catchUp;
 
+		Priority prio;
 		const char* name;
 	};
 
 public:
-	void AddTimedJob(const Job& j) { jobs.push(j); }
+	void SetUpdateBudget(float msecs) { updateBudget = msecs; }
+
+	void AddTimedJob(const Job& j) { jobs[j.prio].push(j); }
 	void Update() {
-		const spring_time now = spring_gettime();
+		const spring_time t0 = spring_gettime();
+
+		bool ranJob = false;
+
+		// serve higher priority classes first; within a class jobs run in
+		// due-time order and a class stops being served once the next job
+		// no longer looks like it fits the remaining budget, leaving it
+		// due for the next Update
+		for (auto& queue: jobs) {
+			while (!queue.empty()) {
+				Job j = queue.top();
 
-		while (!jobs.empty()) {
-			Job j = jobs.top();
+				const spring_time now = spring_gettime();
 
-			if (j.time > now.toMilliSecsf())
-				break;
+				if (j.time > now.toMilliSecsf())
+					break;
 
-			jobs.pop();
+				// expected-cost gate; always run at least one due job per
+				// Update so a single over-budget job can not starve itself
+				if (ranJob && ((now - t0).toMilliSecsf() + j.cost) > updateBudget)
+					break;
 
-			if (!j.f())
-				continue;
+				queue.pop();
 
-			j.UpdateTime(now.toMilliSecsf());
-			AddTimedJob(j);
+				const spring_time runStart = spring_gettime();
+				const bool keepJob = j.f();
+
+				// cost feedback, biased toward recent runs
+				j.cost = j.cost * 0.7f + (spring_gettime() - runStart).toMilliSecsf() * 0.3f;
+
+				ranJob = true;
+
+				if (!keepJob)
+					continue;
+
+				j.UpdateTime(now.toMilliSecsf());
+				AddTimedJob(j);
+			}
 		}
 	}
 
 private:
-	// job with smallest next-to-execute time goes at the top
-	std::priority_queue<Job, std::vector<Job>, std::greater<Job>> jobs;
+	// per class; job with smallest next-to-execute time goes at the top
+	std::priority_queue<Job, std::vector<Job>, std::greater<Job>> jobs[NUM_PRIORITIES];
+
+	float updateBudget = 2.0f; // msecs
 };
 
 #endif
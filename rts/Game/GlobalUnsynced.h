@@ -161,6 +161,16 @@ public:
 	 */
 	bool fpsMode;
 
+	/**
+	 * @brief sim catching up
+	 *
+	 * if true, the client is fast-forwarding through a backlog of queued
+	 * sim frames (e.g. after a mid-game rejoin); unsynced per-frame work
+	 * (draw call-ins, sound, visual projectiles) is skipped to maximize
+	 * the frame consumption rate
+	 */
+	bool simCatchingUp;
+
 	/**
 	* @brief global quit
 	*
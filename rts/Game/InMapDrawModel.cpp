@@ -27,6 +27,7 @@ CInMapDrawModel::CInMapDrawModel()
 	, drawAllMarks(false)
 	, numPoints(0)
 	, numLines(0)
+	, changeCounter(0)
 {
 	drawQuads.resize(drawQuadsX * drawQuadsY);
 
@@ -96,6 +97,7 @@ bool CInMapDrawModel::AddPoint(const float3& constPos, const std::string& label,
 	drawQuads[quad].points.push_back(point);
 
 	numPoints++;
+	changeCounter++;
 
 	return true;
 }
@@ -128,6 +130,7 @@ bool CInMapDrawModel::AddLine(const float3& constPos1, const float3& constPos2,
 	drawQuads[quad].lines.push_back(line);
 
 	numLines++;
+	changeCounter++;
 
 	return true;
 }
@@ -149,6 +152,8 @@ void CInMapDrawModel::EraseNear(const float3& constPos, int playerID)
 	}
 
 
+	const size_t numPrimitives = numPoints + numLines;
+
 	const float radius = 100.0f;
 	const int maxY = drawQuadsY - 1;
 	const int maxX = drawQuadsX - 1;
@@ -183,6 +188,10 @@ void CInMapDrawModel::EraseNear(const float3& constPos, int playerID)
 			}
 		}
 	}
+
+	if ((numPoints + numLines) != numPrimitives) {
+		changeCounter++;
+	}
 }
 
 
@@ -194,6 +203,7 @@ void CInMapDrawModel::EraseAll()
 	}
 	numPoints = 0;
 	numLines = 0;
+	changeCounter++;
 
 	// TODO check if this is needed
 	//visibleLabels.clear();
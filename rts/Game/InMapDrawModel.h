@@ -39,6 +39,12 @@ public:
 	size_t GetNumPoints() const { return numPoints; }
 	size_t GetNumLines() const { return numLines; }
 
+	/**
+	 * Bumped whenever the stored points or lines change;
+	 * lets the renderer detect when its cached geometry went stale.
+	 */
+	unsigned int GetChangeCounter() const { return changeCounter; }
+
 
 	struct MapDrawPrimitive {
 	public:
@@ -139,6 +145,9 @@ private:
 	size_t numPoints;
 	/// total number of lines
 	size_t numLines;
+
+	/// @see #GetChangeCounter
+	unsigned int changeCounter;
 };
 
 extern CInMapDrawModel* inMapDrawerModel;
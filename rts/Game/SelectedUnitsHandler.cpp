@@ -41,6 +41,7 @@
 
 #include <SDL_mouse.h>
 #include <SDL_keycode.h>
+#include <algorithm>
 #include <map>
 
 
@@ -71,6 +72,7 @@ void CSelectedUnitsHandler::Init(unsigned numPlayers)
 	autoAddBuiltUnitsToFactoryGroup = configHandler->GetBool("AutoAddBuiltUnitsToFactoryGroup");
 	autoAddBuiltUnitsToSelectedGroup = configHandler->GetBool("AutoAddBuiltUnitsToSelectedGroup");
 	netSelected.resize(numPlayers);
+	netSelectionBase.resize(numPlayers);
 }
 
 
@@ -609,28 +611,19 @@ void CSelectedUnitsHandler::Draw()
 					(guihandler->inCommand < int(guihandler->commands.size())) &&
 					(guihandler->commands[guihandler->inCommand].id < 0)))) {
 
-			bool myColor = true;
-			glColor4fv(cmdColors.buildBox);
-
 			for (const auto bi: unitHandler->GetBuilderCAIs()) {
 				const CBuilderCAI* builderCAI = bi.second;
 				const CUnit* builder = builderCAI->owner;
 
 				if (builder->team == gu->myTeam) {
-					if (!myColor) {
-						glColor4fv(cmdColors.buildBox);
-						myColor = true;
-					}
-					commandDrawer->DrawQuedBuildingSquares(builderCAI);
+					commandDrawer->DrawQuedBuildingSquares(builderCAI, cmdColors.buildBox);
 				}
 				else if (teamHandler->AlliedTeams(builder->team, gu->myTeam)) {
-					if (myColor) {
-						glColor4fv(cmdColors.allyBuildBox);
-						myColor = false;
-					}
-					commandDrawer->DrawQuedBuildingSquares(builderCAI);
+					commandDrawer->DrawQuedBuildingSquares(builderCAI, cmdColors.allyBuildBox);
 				}
 			}
+
+			commandDrawer->FlushQuedBuildingSquares();
 		}
 	}
 
@@ -654,7 +647,50 @@ void CSelectedUnitsHandler::DependentDied(CObject *o)
 void CSelectedUnitsHandler::NetSelect(std::vector<int>& s, int playerId)
 {
 	assert(unsigned(playerId) < netSelected.size());
-	netSelected[playerId] = s;
+
+	// a full selection replaces the delta base wholesale; sort so that
+	// later NETMSG_SELECT_DELTA packets and their base agree on order
+	std::sort(s.begin(), s.end());
+	netSelectionBase[playerId] = s;
+
+	FilterNetSelection(playerId);
+}
+
+void CSelectedUnitsHandler::NetSelectDelta(const std::vector<int>& removedIDs, const std::vector<int>& addedIDs, int playerId)
+{
+	assert(unsigned(playerId) < netSelected.size());
+
+	std::vector<int>& base = netSelectionBase[playerId];
+	std::vector<int> keptIDs;
+	keptIDs.reserve(base.size() + addedIDs.size());
+
+	std::set_difference(base.begin(), base.end(), removedIDs.begin(), removedIDs.end(), std::back_inserter(keptIDs));
+	base.clear();
+	std::set_union(keptIDs.begin(), keptIDs.end(), addedIDs.begin(), addedIDs.end(), std::back_inserter(base));
+
+	FilterNetSelection(playerId);
+}
+
+void CSelectedUnitsHandler::FilterNetSelection(int playerId)
+{
+	// the unfiltered base is kept around so that sender and receivers
+	// delta against identical sets even when some IDs get filtered
+	std::vector<int>& selection = netSelected[playerId];
+	selection.clear();
+
+	for (const int unitID: netSelectionBase[playerId]) {
+		const CUnit* unit = unitHandler->GetUnit(unitID);
+
+		// unit was destroyed in simulation (without its ID being recycled)
+		// after sending a command but before receiving it back, more likely
+		// to happen in high-latency situations
+		if (unit == nullptr)
+			continue;
+
+		// if in godMode, this is always true for any player
+		if (playerHandler->Player(playerId)->CanControlTeam(unit->team))
+			selection.push_back(unitID);
+	}
 }
 
 
@@ -671,6 +707,7 @@ void CSelectedUnitsHandler::NetOrder(Command& c, int playerId)
 void CSelectedUnitsHandler::ClearNetSelect(int playerId)
 {
 	netSelected[playerId].clear();
+	netSelectionBase[playerId].clear();
 }
 
 void CSelectedUnitsHandler::AiOrder(int unitid, const Command &c, int playerId)
@@ -936,21 +973,32 @@ void CSelectedUnitsHandler::SetCommandPage(int page)
 void CSelectedUnitsHandler::SendCommand(const Command& c)
 {
 	if (selectionChanged) {
-		// send new selection
-
-		// first, convert CUnit* to unit IDs.
-		std::vector<short> selectedUnitIDs(selectedUnits.size());
-		std::vector<short>::iterator i = selectedUnitIDs.begin();
-
-		for (auto ui = selectedUnits.begin(); ui != selectedUnits.end(); ++i, ++ui) {
-			*i = *ui;
+		// send new selection, delta-encoded against the previous one
+		// when that is cheaper than broadcasting the full ID list
+		std::vector<int> sortedSelection(selectedUnits.begin(), selectedUnits.end());
+		std::sort(sortedSelection.begin(), sortedSelection.end());
+
+		std::vector<int> removedIDs;
+		std::vector<int> addedIDs;
+
+		std::set_difference(lastSelectionSent.begin(), lastSelectionSent.end(), sortedSelection.begin(), sortedSelection.end(), std::back_inserter(removedIDs));
+		std::set_difference(sortedSelection.begin(), sortedSelection.end(), lastSelectionSent.begin(), lastSelectionSent.end(), std::back_inserter(addedIDs));
+
+		// the full list costs two bytes per ID, the delta one byte per
+		// changed ID in the common (consecutive-run) case; fall back to
+		// NETMSG_SELECT when the selection changed wholesale
+		if ((removedIDs.size() + addedIDs.size()) < sortedSelection.size()) {
+			clientNet->Send(CBaseNetProtocol::Get().SendSelectDelta(gu->myPlayerNum, removedIDs, addedIDs));
+		} else {
+			std::vector<short> selectedUnitIDs(sortedSelection.begin(), sortedSelection.end());
+			clientNet->Send(CBaseNetProtocol::Get().SendSelect(gu->myPlayerNum, selectedUnitIDs));
 		}
 
-		clientNet->Send(CBaseNetProtocol::Get().SendSelect(gu->myPlayerNum, selectedUnitIDs));
+		lastSelectionSent.swap(sortedSelection);
 		selectionChanged = false;
 	}
 
-	clientNet->Send(CBaseNetProtocol::Get().SendCommand(gu->myPlayerNum, c.GetID(), c.options, c.params));
+	clientNet->Send(CBaseNetProtocol::Get().SendCommand(gu->myPlayerNum, c.GetID(), c.options, std::vector<float>(c.params.begin(), c.params.end())));
 }
 
 
@@ -1024,7 +1072,9 @@ void CSelectedUnitsHandler::SendCommandsToUnits(const std::vector<int>& unitIDs,
 			*packet << cmd.options;
 		if (sameCmdParamSize == 0xFFFF)
 			*packet << static_cast<unsigned short>(cmd.params.size());
-		*packet << cmd.params;
+		for (unsigned int p = 0; p < cmd.params.size(); p++) {
+			*packet << cmd.params[p];
+		}
 	}
 
 	clientNet->Send(std::shared_ptr<netcode::RawPacket>(packet));
@@ -27,6 +27,7 @@ public:
 	bool CommandsChanged();
 	void NetOrder(Command& c, int playerId);
 	void NetSelect(std::vector<int>& s, int playerId);
+	void NetSelectDelta(const std::vector<int>& removedIDs, const std::vector<int>& addedIDs, int playerId);
 	void ClearNetSelect(int playerId);
 	void DependentDied(CObject* o);
 	void Draw();
@@ -73,6 +74,15 @@ public:
 	std::vector< std::vector<int> > netSelected;
 
 private:
+	/// rebuilds netSelected[playerId] from the (unfiltered) delta base
+	void FilterNetSelection(int playerId);
+
+	/// per-player selections as sent on the wire, without validity or
+	/// ownership filtering; NETMSG_SELECT_DELTA packets apply to these
+	std::vector< std::vector<int> > netSelectionBase;
+	/// sorted copy of the selection we last broadcast, the delta base
+	std::vector<int> lastSelectionSent;
+
 	int selectedGroup;
 	int soundMultiselID;
 
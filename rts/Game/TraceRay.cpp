@@ -10,6 +10,7 @@
 #include "Sim/Misc/CollisionHandler.h"
 #include "Sim/Misc/CollisionVolume.h"
 #include "Sim/Misc/GeometricObjects.h"
+#include "Sim/Misc/FeatureBVH.h"
 #include "Sim/Misc/LosHandler.h"
 #include "Sim/Misc/QuadField.h"
 #include "Sim/Misc/TeamHandler.h"
@@ -202,43 +203,55 @@ float TraceRay(
 	if (scanForFeatures || scanForAnyUnits) {
 		CollisionQuery cq;
 
-		const auto& quads = quadField->GetQuadsOnRay(pos, dir, traceLength);
+		static thread_local std::vector<int> quads;
+
+		if (scanForAnyUnits)
+			quadField->GetQuadsOnRay(pos, dir, traceLength, quads);
 
 		// locally point somewhere non-NULL; we cannot pass hitColQuery
 		// to DetectHit directly because each call resets it internally
 		if (hitColQuery == nullptr)
 			hitColQuery = &cq;
 
-		// feature intersection
+		static thread_local std::vector<CSolidObject*> batch;
+
+		// feature intersection; features are near-static so candidates
+		// come from the BVH instead of the quads crossed by the ray
 		if (scanForFeatures) {
-			for (const int quadIdx: quads) {
-				const CQuadField::Quad& quad = quadField->GetQuad(quadIdx);
+			batch.clear();
 
-				for (CFeature* f: quad.features) {
-					// NOTE:
-					//   if f is non-blocking, ProjectileHandler will not test
-					//   for collisions with projectiles so we can skip it here
-					if (!f->HasCollidableStateBit(CSolidObject::CSTATE_BIT_QUADMAPRAYS))
-						continue;
+			static thread_local std::vector<CFeature*> rayFeatures;
+			featureBVH.GetFeaturesOnRay(pos, dir, traceLength, rayFeatures);
 
-					if (CCollisionHandler::DetectHit(f, f->GetTransformMatrix(true), pos, pos + dir * traceLength, &cq, true)) {
-						const float len = cq.GetHitPosDist(pos, dir);
+			for (CFeature* f: rayFeatures) {
+				// NOTE:
+				//   if f is non-blocking, ProjectileHandler will not test
+				//   for collisions with projectiles so we can skip it here
+				if (!f->HasCollidableStateBit(CSolidObject::CSTATE_BIT_QUADMAPRAYS))
+					continue;
+
+				batch.push_back(f);
+			}
 
-						// we want the closest feature (intersection point) on the ray
-						if (len >= traceLength)
-							continue;
+			// we want the closest feature (intersection point) on the ray
+			CSolidObject* o = CCollisionHandler::DetectHitBatch(batch, pos, pos + dir * traceLength, &cq, true);
 
-						traceLength = len;
+			if (o != nullptr) {
+				const float len = cq.GetHitPosDist(pos, dir);
 
-						hitFeature = f;
-						*hitColQuery = cq;
-					}
+				if (len < traceLength) {
+					traceLength = len;
+
+					hitFeature = static_cast<CFeature*>(o);
+					*hitColQuery = cq;
 				}
 			}
 		}
 
 		// unit intersection
 		if (scanForAnyUnits) {
+			batch.clear();
+
 			for (const int quadIdx: quads) {
 				const CQuadField::Quad& quad = quadField->GetQuad(quadIdx);
 
@@ -259,18 +272,21 @@ float TraceRay(
 					if (!doHitTest)
 						continue;
 
-					if (CCollisionHandler::DetectHit(u, u->GetTransformMatrix(true), pos, pos + dir * traceLength, &cq, true)) {
-						const float len = cq.GetHitPosDist(pos, dir);
+					batch.push_back(u);
+				}
+			}
+
+			// we want the closest unit (intersection point) on the ray
+			CSolidObject* o = CCollisionHandler::DetectHitBatch(batch, pos, pos + dir * traceLength, &cq, true);
 
-						// we want the closest unit (intersection point) on the ray
-						if (len >= traceLength)
-							continue;
+			if (o != nullptr) {
+				const float len = cq.GetHitPosDist(pos, dir);
 
-						traceLength = len;
+				if (len < traceLength) {
+					traceLength = len;
 
-						hitUnit = u;
-						*hitColQuery = cq;
-					}
+					hitUnit = static_cast<CUnit*>(o);
+					*hitColQuery = cq;
 				}
 			}
 
@@ -306,7 +322,8 @@ void TraceRayShields(
 ) {
 	CollisionQuery cq;
 
-	const auto& quads = quadField->GetQuadsOnRay(start, dir, length);
+	static thread_local std::vector<int> quads;
+	quadField->GetQuadsOnRay(start, dir, length, quads);
 
 	for (const int quadIdx: quads) {
 		const CQuadField::Quad& quad = quadField->GetQuad(quadIdx);
@@ -371,7 +388,8 @@ float GuiTraceRay(
 
 	CollisionQuery cq;
 
-	const auto& quads = quadField->GetQuadsOnRay(start, dir, length);
+	static thread_local std::vector<int> quads;
+	quadField->GetQuadsOnRay(start, dir, length, quads);
 
 	for (const int quadIdx: quads) {
 		const CQuadField::Quad& quad = quadField->GetQuad(quadIdx);
@@ -422,34 +440,38 @@ float GuiTraceRay(
 				}
 			}
 		}
+	}
 
-		// Feature Intersection
-		for (const CFeature* f: quad.features) {
-			if (!gu->spectatingFullView && !f->IsInLosForAllyTeam(gu->myAllyTeam))
-				continue;
-			// test this bit only in synced traces, rely on noSelect here
-			if (false && !f->HasCollidableStateBit(CSolidObject::CSTATE_BIT_QUADMAPRAYS))
-				continue;
-			if (f->noSelect)
-				continue;
+	// Feature Intersection; near-static features come from the BVH
+	// rather than the quads crossed by the ray
+	static thread_local std::vector<CFeature*> rayFeatures;
+	featureBVH.GetFeaturesOnRay(start, dir, length, rayFeatures);
 
-			const CollisionVolume& cv = f->selectionVolume;
+	for (const CFeature* f: rayFeatures) {
+		if (!gu->spectatingFullView && !f->IsInLosForAllyTeam(gu->myAllyTeam))
+			continue;
+		// test this bit only in synced traces, rely on noSelect here
+		if (false && !f->HasCollidableStateBit(CSolidObject::CSTATE_BIT_QUADMAPRAYS))
+			continue;
+		if (f->noSelect)
+			continue;
 
-			if (CCollisionHandler::MouseHit(f, f->GetTransformMatrix(false), start, start + dir * guiRayLength, &cv, &cq)) {
-				const float hitDist = cq.GetHitPosDist(start, dir);
+		const CollisionVolume& cv = f->selectionVolume;
 
-				const bool factoryHitBeforeUnit = ( hitFactory && hitDist <  minEgressDist);
-				const bool unitHitInsideFactory = (!hitFactory && hitDist < minIngressDist);
+		if (CCollisionHandler::MouseHit(f, f->GetTransformMatrix(false), start, start + dir * guiRayLength, &cv, &cq)) {
+			const float hitDist = cq.GetHitPosDist(start, dir);
 
-				// we want the closest feature (intersection point) on the ray
-				// give features in a factory (?) higher priority than the factory itself
-				if (hitUnit == nullptr || factoryHitBeforeUnit || unitHitInsideFactory) {
-					hitFactory = false;
-					minIngressDist = hitDist;
+			const bool factoryHitBeforeUnit = ( hitFactory && hitDist <  minEgressDist);
+			const bool unitHitInsideFactory = (!hitFactory && hitDist < minIngressDist);
 
-					hitFeature = f;
-					hitUnit = nullptr;
-				}
+			// we want the closest feature (intersection point) on the ray
+			// give features in a factory (?) higher priority than the factory itself
+			if (hitUnit == nullptr || factoryHitBeforeUnit || unitHitInsideFactory) {
+				hitFactory = false;
+				minIngressDist = hitDist;
+
+				hitFeature = f;
+				hitUnit = nullptr;
 			}
 		}
 	}
@@ -474,7 +496,8 @@ bool TestCone(
 	int traceFlags,
 	CUnit* owner
 ) {
-	const auto& quads = quadField->GetQuadsOnRay(from, dir, length);
+	static thread_local std::vector<int> quads;
+	quadField->GetQuadsOnRay(from, dir, length, quads);
 
 	if (quads.empty())
 		return true;
@@ -539,7 +562,8 @@ bool TestTrajectoryCone(
 	int traceFlags,
 	CUnit* owner
 ) {
-	const auto& quads = quadField->GetQuadsOnRay(from, dir, length);
+	static thread_local std::vector<int> quads;
+	quadField->GetQuadsOnRay(from, dir, length, quads);
 
 	if (quads.empty())
 		return true;
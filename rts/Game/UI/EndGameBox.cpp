@@ -503,6 +503,8 @@ void CEndGameBox::FillTeamStats()
 	stats.push_back(Stat("Damage Dealt"));
 	stats.push_back(Stat("Damage Received"));
 
+	std::vector<TeamStatistics> statHistory;
+
 	for (int team = 0; team < teamHandler->ActiveTeams(); team++) {
 		const CTeam* pteam = teamHandler->Team(team);
 
@@ -510,7 +512,11 @@ void CEndGameBox::FillTeamStats()
 			continue;
 		}
 
-		for (auto si = pteam->statHistory.cbegin(); si != pteam->statHistory.cend(); ++si) {
+		// materializes entries already compressed out of the ring;
+		// fine here, the game is over
+		pteam->GetStatsHistory(statHistory);
+
+		for (auto si = statHistory.cbegin(); si != statHistory.cend(); ++si) {
 			stats[0].AddStat(team, 0);
 
 			stats[1].AddStat(team, si->metalUsed);
@@ -82,6 +82,8 @@ CGuiHandler::CGuiHandler():
 	curIconCommand(-1),
 	actionOffset(0),
 	drawSelectionInfo(true),
+	staticButtonsList(0),
+	staticButtonsPage(-1),
 	gatherMode(false)
 {
 	icons.resize(16);
@@ -105,6 +107,13 @@ CGuiHandler::CGuiHandler():
 	failedSound = sound->GetSoundId("FailedCommand");
 }
 
+CGuiHandler::~CGuiHandler()
+{
+	if (staticButtonsList != 0) {
+		glDeleteLists(staticButtonsList, 1);
+	}
+}
+
 
 
 bool CGuiHandler::GetQueueKeystate() const
@@ -599,6 +608,9 @@ void CGuiHandler::LayoutIcons(bool useSelectionPage)
 		defaultCmdMemory = -1;
 		forceLayoutUpdate = false;
 
+		// the cached button list shows the old command set
+		staticButtonsPage = -1;
+
 		commands.clear();
 	}
 
@@ -2952,6 +2964,64 @@ void CGuiHandler::DrawHilightQuad(const IconInfo& icon)
 }
 
 
+void CGuiHandler::DrawStaticButtonParts() // Only called by DrawButtons
+{
+	if ((staticButtonsList == 0) || (staticButtonsPage != activePage)) {
+		if (staticButtonsList == 0)
+			staticButtonsList = glGenLists(1);
+
+		const int buttonStart = Clamp( activePage * iconsPerPage, 0, iconsCount); // activePage can be -1
+		const int buttonEnd   = Clamp(buttonStart + iconsPerPage, 0, iconsCount);
+
+		glNewList(staticButtonsList, GL_COMPILE);
+
+		for (int ii = buttonStart; ii < buttonEnd; ii++) {
+			IconInfo& icon = icons.at(ii);
+
+			icon.usedTexture = false;
+			icon.onlyTexture = false;
+
+			if (icon.commandsID < 0)
+				continue; // inactive icon
+			if (icon.commandsID >= commands.size())
+				continue;
+
+			const SCommandDescription& cmdDesc = commands[icon.commandsID];
+
+			// custom buttons are drawn entirely by DrawCustomButton
+			if ((cmdDesc.id == CMD_INTERNAL) && (cmdDesc.type == CMDTYPE_CUSTOM))
+				continue;
+
+			icon.onlyTexture = cmdDesc.onlyTexture;
+
+			// specified texture
+			if (DrawTexture(icon, cmdDesc.iconname))
+				icon.usedTexture = true;
+
+			// unit buildpic
+			if (!icon.usedTexture && (cmdDesc.id < 0)) {
+				if (unitDefHandler->GetUnitDefByID(-cmdDesc.id) != NULL) {
+					DrawUnitBuildIcon(icon, -cmdDesc.id);
+					icon.usedTexture = true;
+					icon.onlyTexture = true;
+				}
+			}
+
+			// no texture, no page arrow, ... draw a frame
+			if (!icon.usedTexture && (cmdDesc.type != CMDTYPE_PREV) && (cmdDesc.type != CMDTYPE_NEXT)) {
+				glColor4f(1.0f, 1.0f, 1.0f, 0.1f);
+				DrawIconFrame(icon);
+			}
+		}
+
+		glEndList();
+		staticButtonsPage = activePage;
+	}
+
+	glCallList(staticButtonsList);
+}
+
+
 void CGuiHandler::DrawButtons() // Only called by Draw
 {
 	glLineWidth(1.0f);
@@ -2969,6 +3039,9 @@ void CGuiHandler::DrawButtons() // Only called by Draw
 		glEnd();
 	}
 
+	// icon textures, build-pics and untextured frames (cached in a display list)
+	DrawStaticButtonParts();
+
 	const int mouseIcon   = IconAtPos(mouse->lastx, mouse->lasty);
 	const int buttonStart = Clamp( activePage * iconsPerPage, 0, iconsCount); // activePage can be -1
 	const int buttonEnd   = Clamp(buttonStart + iconsPerPage, 0, iconsCount);
@@ -2989,26 +3062,11 @@ void CGuiHandler::DrawButtons() // Only called by Draw
 		if (customCommand) {
 			DrawCustomButton(icon, highlight);
 		} else {
-			bool usedTexture = false;
-			bool onlyTexture = cmdDesc.onlyTexture;
+			// texture, buildpic or frame were already drawn by DrawStaticButtonParts
+			const bool usedTexture = icon.usedTexture;
+			const bool onlyTexture = icon.onlyTexture;
 			const bool useLEDs = useOptionLEDs && (cmdDesc.type == CMDTYPE_ICON_MODE);
 
-			// specified texture
-			if (DrawTexture(icon, cmdDesc.iconname))
-				usedTexture = true;
-
-			// unit buildpic
-			if (!usedTexture) {
-				if (cmdDesc.id < 0) {
-					const UnitDef* ud = unitDefHandler->GetUnitDefByID(-cmdDesc.id);
-					if (ud != NULL) {
-						DrawUnitBuildIcon(icon, -cmdDesc.id);
-						usedTexture = true;
-						onlyTexture = true;
-					}
-				}
-			}
-
 			// highlight background before text is applied
 			if (highlight) {
 				DrawHilightQuad(icon);
@@ -3038,12 +3096,6 @@ void CGuiHandler::DrawButtons() // Only called by Draw
 						DrawNextArrow(icon);
 					}
 				}
-				else if (!usedTexture) {
-					// no texture, no arrow, ... draw a frame
-					glColor4f(1.0f, 1.0f, 1.0f, 0.1f);
-					DrawIconFrame(icon);
-				}
-
 				// draw the text
 				// command name (or parameter)
 				std::string toPrint = cmdDesc.name;
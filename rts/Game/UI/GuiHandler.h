@@ -25,6 +25,7 @@ struct SCommandDescription;
 class CGuiHandler : public CInputReceiver {
 public:
 	CGuiHandler();
+	~CGuiHandler();
 
 	void Update();
 
@@ -134,6 +135,7 @@ private:
 	struct IconInfo;
 
 	void DrawButtons();
+	void DrawStaticButtonParts();
 	void DrawCustomButton(const IconInfo& icon, bool highlight);
 	bool DrawUnitBuildIcon(const IconInfo& icon, int unitDefID);
 	bool DrawTexture(const IconInfo& icon, const std::string& texName);
@@ -224,6 +226,12 @@ private:
 	float xIconStep, yIconStep;
 	float xBpos, yBpos; // center of the buildIconsFirst indicator
 
+	// static part of the button panel (icon textures, build-pics and
+	// untextured frames), compiled into a display list and replayed
+	// until the layout or the active page changes
+	unsigned int staticButtonsList;
+	int staticButtonsPage; // activePage the list was compiled for, -1 forces a rebuild
+
 	struct Box {
 		GLfloat x1;
 		GLfloat y1;
@@ -236,6 +244,10 @@ private:
 		int commandsID; // index into commands list (or -1)
 		Box visual;
 		Box selection;
+		// recorded when the static button list is compiled, so the
+		// dynamic pass of DrawButtons knows what was already drawn
+		bool usedTexture = false;
+		bool onlyTexture = false;
 	};
 	std::vector<IconInfo> icons;
 	// number of slots taken up in <icons>
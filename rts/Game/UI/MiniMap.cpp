@@ -1032,8 +1032,9 @@ void CMiniMap::DrawForReal(bool useGeom, bool updateTex)
 
 	glActiveTexture(GL_TEXTURE0);
 
-	if ((!updateTex) && RenderCachedTexture(useGeom))
-		return;
+	// only the background layers live in the cached texture; unit icons,
+	// world stuff and the frustum are drawn fresh on top of it each frame
+	const bool cachedBackground = (!updateTex) && renderToTexture;
 
 	glPushAttrib(GL_DEPTH_BUFFER_BIT);
 	glEnable(GL_BLEND);
@@ -1068,15 +1069,22 @@ void CMiniMap::DrawForReal(bool useGeom, bool updateTex)
 	glEnable(GL_CLIP_PLANE2);
 	glEnable(GL_CLIP_PLANE3);
 
-	DrawBackground();
+	if (cachedBackground) {
+		DrawCachedBackground();
+	} else {
+		DrawBackground();
 
-	// allow Lua scripts to overdraw the background image
-	SetClipPlanes(true);
-	eventHandler.DrawInMiniMapBackground();
-	SetClipPlanes(false);
+		// allow Lua scripts to overdraw the background image
+		// (baked into the cached texture when one is in use)
+		SetClipPlanes(true);
+		eventHandler.DrawInMiniMapBackground();
+		SetClipPlanes(false);
+	}
 
-	DrawUnitIcons();
-	DrawWorldStuff();
+	if (!updateTex) {
+		DrawUnitIcons();
+		DrawWorldStuff();
+	}
 
 	if (useGeom)
 		glPopMatrix();
@@ -1085,8 +1093,10 @@ void CMiniMap::DrawForReal(bool useGeom, bool updateTex)
 	glEnable(GL_TEXTURE_2D);
 
 	// allow Lua scripts to draw into the minimap
-	SetClipPlanes(true);
-	eventHandler.DrawInMiniMap();
+	if (!updateTex) {
+		SetClipPlanes(true);
+		eventHandler.DrawInMiniMap();
+	}
 
 	if (!updateTex) {
 		glPushMatrix();
@@ -1414,22 +1424,13 @@ void CMiniMap::DrawNotes()
 
 
 
-bool CMiniMap::RenderCachedTexture(bool useGeom)
+void CMiniMap::DrawCachedBackground() const
 {
-	if (!renderToTexture)
-		return false;
-
 	glPushAttrib(GL_COLOR_BUFFER_BIT);
 	glBindTexture(GL_TEXTURE_2D, minimapTex);
 	glEnable(GL_TEXTURE_2D);
 	glDisable(GL_BLEND);
 
-	if (useGeom) {
-		glPushMatrix();
-		glTranslatef(curPos.x * globalRendering->pixelX, curPos.y * globalRendering->pixelY, 0.0f);
-		glScalef(curDim.x * globalRendering->pixelX, curDim.y * globalRendering->pixelY, 1.0f);
-	}
-
 	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
 	glBegin(GL_QUADS);
 		glTexCoord2f(0.0, 0.0); glVertex2f(0.0f, 0.0f);
@@ -1441,15 +1442,9 @@ bool CMiniMap::RenderCachedTexture(bool useGeom)
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-	DrawCameraFrustumAndMouseSelection();
-
-	if (useGeom)
-		glPopMatrix();
-
 	glDisable(GL_TEXTURE_2D);
 	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
 	glPopAttrib();
-	return true;
 }
 
 
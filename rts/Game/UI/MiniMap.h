@@ -80,7 +80,7 @@ protected:
 	void ProxyMousePress(int x, int y, int button);
 	void ProxyMouseRelease(int x, int y, int button);
 
-	bool RenderCachedTexture(bool useGeom);
+	void DrawCachedBackground() const;
 	void DrawBackground() const;
 	void DrawUnitIcons() const;
 	void DrawUnitRanges() const;
@@ -10,6 +10,7 @@
 #include "Rendering/Fonts/glFont.h"
 #include "Rendering/GlobalRendering.h"
 #include "Rendering/GlobalRenderingInfo.h"
+#include "Rendering/GL/StateCache.h"
 #include "Rendering/GL/VertexArray.h"
 #include "Sim/Features/FeatureMemPool.h"
 #include "Sim/Misc/GlobalConstants.h" // for GAME_SPEED
@@ -20,6 +21,9 @@
 #include "Sim/Projectiles/ProjectileMemPool.h"
 #include "Sim/Weapons/WeaponMemPool.h"
 #include "System/EventHandler.h"
+#include "System/Net/TrafficStats.h"
+#include "System/Platform/Threading.h"
+#include "System/Threading/ThreadPool.h"
 #include "System/TimeProfiler.h"
 #include "System/SafeUtil.h"
 #include "lib/lua/include/LuaUser.h"
@@ -372,7 +376,7 @@ static void DrawInfoText()
 	const char* avgFmtStr = "[3] {Update,Draw,Sim}FrameTime={%s%2.1f, %s%2.1f, %s%2.1f}ms";
 	const char* spdFmtStr = "[4] {Current,Wanted}SimSpeedMul={%2.2f, %2.2f}x";
 	const char* sfxFmtStr = "[5] {Synced,Unsynced}Projectiles={%u,%u} Particles=%u Saturation=%.1f";
-	const char* pfsFmtStr = "[6] (%s)PFS-updates queued: {%i, %i}";
+	const char* pfsFmtStr = "[6] (%s)PFS-updates queued: {%i, %i} reqs=%u srch={%u, %uq} hits=%u live=%u time=%.0fms";
 	const char* luaFmtStr = "[7] Lua-allocated memory: %.1fMB (%.5uK allocs : %.5u usecs : %.1u states)";
 	const char* gpuFmtStr = "[8] GPU-allocated memory: %.1fMB / %.1fMB";
 	const char* sopFmtStr = "[9] SOP-allocated memory: {U,F,P,W}={%.1f/%.1f, %.1f/%.1f, %.1f/%.1f, %.1f/%.1f}KB";
@@ -395,13 +399,14 @@ static void DrawInfoText()
 
 	{
 		const int2 pfsUpdates = pm->GetNumQueuedUpdates();
+		const IPathManager::PathStats pfsStats = pm->GetPathStats();
 
 		switch (pm->GetPathFinderType()) {
 			case PFS_TYPE_DEFAULT: {
-				font->glFormat(0.01f, 0.12f, 0.5f, DBG_FONT_FLAGS, pfsFmtStr, "DEF", pfsUpdates.x, pfsUpdates.y);
+				font->glFormat(0.01f, 0.12f, 0.5f, DBG_FONT_FLAGS, pfsFmtStr, "DEF", pfsUpdates.x, pfsUpdates.y, pfsStats.numPathRequests, pfsStats.numExecutedSearches, pfsStats.numQueuedSearches, pfsStats.numCacheHits, pfsStats.numLivePaths, pfsStats.searchTimeMilliSecs);
 			} break;
 			case PFS_TYPE_QTPFS: {
-				font->glFormat(0.01f, 0.12f, 0.5f, DBG_FONT_FLAGS, pfsFmtStr, "QT", pfsUpdates.x, pfsUpdates.y);
+				font->glFormat(0.01f, 0.12f, 0.5f, DBG_FONT_FLAGS, pfsFmtStr, "QT", pfsUpdates.x, pfsUpdates.y, pfsStats.numPathRequests, pfsStats.numExecutedSearches, pfsStats.numQueuedSearches, pfsStats.numCacheHits, pfsStats.numLivePaths, pfsStats.searchTimeMilliSecs);
 			} break;
 		}
 	}
@@ -435,6 +440,72 @@ static void DrawInfoText()
 		weaponMemPool.alloc_size() / 1024.0f,
 		weaponMemPool.freed_size() / 1024.0f
 	);
+
+	const char* glsFmtStr = "[10] GL-state changes: {issued,filtered}={%u, %u}";
+
+	font->glFormat(0.01f, 0.20f, 0.5f, DBG_FONT_FLAGS, glsFmtStr, GL::GetNumStateChangesIssued(), GL::GetNumStateChangesFiltered());
+
+	{
+		// per-NETMSG traffic rates; single out the heaviest type in
+		// each direction so bandwidth hogs show up at a glance
+		const char* netFmtStr = "[11] NetMsg traffic: recv=%uB/s (top: id %u, %uB/s) sent=%uB/s (top: id %u, %uB/s)";
+
+		uint32_t recvRate = 0, sentRate = 0;
+		uint32_t topRecvID = 0, topSentID = 0;
+
+		for (unsigned int msgID = 0; msgID < 256; msgID++) {
+			const netcode::TrafficStats::TypeStats& ts = netcode::TrafficStats::GetStats(msgID);
+
+			recvRate += ts.recvBytesPerSec;
+			sentRate += ts.sentBytesPerSec;
+
+			if (ts.recvBytesPerSec > netcode::TrafficStats::GetStats(topRecvID).recvBytesPerSec)
+				topRecvID = msgID;
+			if (ts.sentBytesPerSec > netcode::TrafficStats::GetStats(topSentID).sentBytesPerSec)
+				topSentID = msgID;
+		}
+
+		font->glFormat(0.01f, 0.22f, 0.5f, DBG_FONT_FLAGS, netFmtStr,
+			recvRate, topRecvID, netcode::TrafficStats::GetStats(topRecvID).recvBytesPerSec,
+			sentRate, topSentID, netcode::TrafficStats::GetStats(topSentID).sentBytesPerSec
+		);
+	}
+
+	{
+		// cumulative since pool creation; a high steal count means uneven
+		// task costs, a high idle count means workers starving for tasks
+		const char* wssFmtStr = "[12] ThreadPool: tasks stolen=%lu, idle waits=%lu";
+
+		font->glFormat(0.01f, 0.24f, 0.5f, DBG_FONT_FLAGS, wssFmtStr,
+			(unsigned long)ThreadPool::GetNumTasksStolen(),
+			(unsigned long)ThreadPool::GetNumIdleWaits()
+		);
+	}
+
+	{
+		// cpu masks the pin policy actually applied (all zero when disabled)
+		const char* pinFmtStr = "[13] thread placement (policy %d): main=0x%x load=0x%x workers=0x%x";
+
+		font->glFormat(0.01f, 0.26f, 0.5f, DBG_FONT_FLAGS, pinFmtStr,
+			Threading::GetPinPolicy(),
+			Threading::GetAppliedPinMask(Threading::PIN_ROLE_MAIN),
+			Threading::GetAppliedPinMask(Threading::PIN_ROLE_LOAD),
+			Threading::GetAppliedPinMask(Threading::PIN_ROLE_WORKER)
+		);
+	}
+
+	{
+		// pool occupancy; a high fragmentation ratio means live objects
+		// sit thinly spread over many pages and iteration locality is poor
+		const char* sofFmtStr = "[14] SOP-pages live/total(frag): U=%u/%u(%.2f) F=%u/%u(%.2f) P=%u/%u(%.2f) W=%u/%u(%.2f)";
+
+		font->glFormat(0.01f, 0.28f, 0.5f, DBG_FONT_FLAGS, sofFmtStr,
+			unsigned(unitMemPool.num_live_pages()), unsigned(unitMemPool.num_total_pages()), unitMemPool.frag_ratio(),
+			unsigned(featureMemPool.num_live_pages()), unsigned(featureMemPool.num_total_pages()), featureMemPool.frag_ratio(),
+			unsigned(projMemPool.num_live_pages()), unsigned(projMemPool.num_total_pages()), projMemPool.frag_ratio(),
+			unsigned(weaponMemPool.num_live_pages()), unsigned(weaponMemPool.num_total_pages()), weaponMemPool.frag_ratio()
+		);
+	}
 }
 
 
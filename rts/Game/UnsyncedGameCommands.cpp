@@ -2808,7 +2808,32 @@ public:
 		switch (args.size()) {
 			case 2: { DumpState(atoi(args[0].c_str()), atoi(args[1].c_str()),                     1); } break;
 			case 3: { DumpState(atoi(args[0].c_str()), atoi(args[1].c_str()), atoi(args[2].c_str())); } break;
-			default: { LOG_L(L_WARNING, "/DumpState: wrong syntax");  } break;
+			case 4: { DumpState(atoi(args[0].c_str()), atoi(args[1].c_str()), atoi(args[2].c_str()), strtol(args[3].c_str(), nullptr, 0)); } break;
+			default: { LOG_L(L_WARNING, "/DumpState: wrong syntax, expects <minFrame> <maxFrame> [<period> [<subsystemMask>]]");  } break;
+		}
+
+		return true;
+	}
+};
+
+
+
+class DumpProfileTraceActionExecutor: public IUnsyncedActionExecutor {
+public:
+	DumpProfileTraceActionExecutor(): IUnsyncedActionExecutor(
+		"DumpProfileTrace",
+		"without argument, dump recent profiler spans as Chrome trace-event JSON;"
+		" with one, set the sim-frame time (in ms, 0 disables) above which a dump is made automatically"
+	) {}
+
+	bool Execute(const UnsyncedAction& action) const {
+		const std::string& args = action.GetArgs();
+
+		if (args.empty()) {
+			profiler.DumpSpanTrace();
+		} else {
+			profiler.SetSpanDumpThreshold(atof(args.c_str()));
+			LOG("profile-trace dump threshold set to %.1fms", profiler.GetSpanDumpThreshold());
 		}
 
 		return true;
@@ -3223,6 +3248,7 @@ void UnsyncedGameCommands::AddDefaultActionExecutors() {
 	AddActionExecutor(new SendActionExecutor());
 	AddActionExecutor(new SaveGameActionExecutor());
 	AddActionExecutor(new DumpStateActionExecutor());
+	AddActionExecutor(new DumpProfileTraceActionExecutor());
 	AddActionExecutor(new SaveActionExecutor(true));
 	AddActionExecutor(new SaveActionExecutor(false));
 	AddActionExecutor(new ReloadGameActionExecutor());
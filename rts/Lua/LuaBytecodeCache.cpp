@@ -0,0 +1,92 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "LuaBytecodeCache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+#include "LuaInclude.h"
+
+#include "System/CRC.h"
+#include "System/Config/ConfigHandler.h"
+#include "System/FileSystem/FileSystem.h"
+
+CONFIG(bool, LuaBytecodeCache)
+	.defaultValue(true)
+	.description("Cache compiled Lua chunks in the writable data-directory; speeds up game starts and LuaUI reloads.");
+
+
+// buffers below this size compile faster than a cache probe costs
+static constexpr size_t MIN_CACHED_SIZE = 4096;
+
+
+static int DumpWriter(lua_State* L, const void* data, size_t size, void* ud)
+{
+	static_cast<std::string*>(ud)->append(static_cast<const char*>(data), size);
+	return 0;
+}
+
+
+static const std::string& GetBytecodeCacheDir()
+{
+	static std::string dir;
+
+	if (dir.empty()) {
+		dir = FileSystem::EnsurePathSepAtEnd(FileSystem::GetCacheDir()) + "luac";
+		FileSystem::CreateDirectory(dir);
+		dir = FileSystem::EnsurePathSepAtEnd(dir);
+	}
+
+	return dir;
+}
+
+static std::string GetCachePath(const std::string& code)
+{
+	char buf[64];
+	snprintf(buf, sizeof(buf), "%d-%08x-%u.luac", LUA_VERSION_NUM, CRC::GetCRC(code.data(), code.size()), unsigned(code.size()));
+	return (GetBytecodeCacheDir() + buf);
+}
+
+
+int LuaBytecodeCache::LoadBuffer(lua_State* L, const std::string& code, const char* chunkname)
+{
+	static const bool enabled = configHandler->GetBool("LuaBytecodeCache");
+
+	if (!enabled || code.size() < MIN_CACHED_SIZE)
+		return luaL_loadbuffer(L, code.c_str(), code.size(), chunkname);
+
+	const std::string cachePath = GetCachePath(code);
+
+	{
+		std::ifstream file(cachePath.c_str(), std::ios::in | std::ios::binary);
+
+		if (file.good()) {
+			const std::string dump((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+			if (!dump.empty()) {
+				if (luaL_loadbuffer(L, dump.data(), dump.size(), chunkname) == 0)
+					return 0;
+
+				// truncated or foreign-build dump, recompile below
+				lua_pop(L, 1);
+			}
+		}
+	}
+
+	const int error = luaL_loadbuffer(L, code.c_str(), code.size(), chunkname);
+
+	if (error != 0)
+		return error;
+
+	// write-through; the compiled chunk sits at the top of the stack
+	std::string dump;
+	lua_dump(L, DumpWriter, &dump);
+
+	if (!dump.empty()) {
+		std::ofstream file(cachePath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		file.write(dump.data(), dump.size());
+	}
+
+	return 0;
+}
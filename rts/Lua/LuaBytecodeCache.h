@@ -0,0 +1,26 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef LUA_BYTECODE_CACHE_H
+#define LUA_BYTECODE_CACHE_H
+
+#include <string>
+
+struct lua_State;
+
+/**
+ * On-disk cache of precompiled Lua chunks in the writable
+ * data-directory, keyed by source checksum (plus size) and engine
+ * Lua version. Compiling a large gadget or widget pack dominates
+ * game-start and /luaui reload times; reloading the dumped bytecode
+ * skips the parser entirely. Dumps from a different build (word
+ * size, endianness, number format) fail lua_load's header check and
+ * fall through to a normal compile which refreshes the cache entry.
+ */
+namespace LuaBytecodeCache {
+	/// drop-in replacement for luaL_loadbuffer; on success the
+	/// compiled chunk is at the top of the stack, on error the
+	/// message is (identical return-value conventions)
+	int LoadBuffer(lua_State* L, const std::string& code, const char* chunkname);
+}
+
+#endif // LUA_BYTECODE_CACHE_H
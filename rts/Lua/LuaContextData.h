@@ -9,6 +9,7 @@
 #include "LuaTextures.h"
 #include "LuaFBOs.h"
 #include "LuaRBOs.h"
+#include "LuaVBOs.h"
 #include "LuaDisplayLists.h"
 #endif
 #include "System/EventClient.h"
@@ -65,6 +66,7 @@ public:
 		textures.Clear();
 		fbos.Clear();
 		rbos.Clear();
+		vbos.Clear();
 		displayLists.Clear();
 		#endif
 	}
@@ -102,6 +104,7 @@ public:
 	LuaTextures textures;
 	LuaFBOs fbos;
 	LuaRBOs rbos;
+	LuaVBOs vbos;
 	CLuaDisplayLists displayLists;
 
 	GLMatrixStateTracker glMatrixTracker;
@@ -6,6 +6,7 @@
 #include "LuaRules.h"
 #include "LuaUI.h"
 
+#include "LuaBytecodeCache.h"
 #include "LuaCallInCheck.h"
 #include "LuaConfig.h"
 #include "LuaHashString.h"
@@ -425,7 +426,7 @@ bool CLuaHandle::LoadCode(lua_State* L, const string& code, const string& debug)
 
 	const LuaUtils::ScopedDebugTraceBack traceBack(L);
 
-	const int error = luaL_loadbuffer(L, code.c_str(), code.size(), debug.c_str());
+	const int error = LuaBytecodeCache::LoadBuffer(L, code, debug.c_str());
 
 	if (error != 0) {
 		LOG_L(L_ERROR, "[%s::%s] error=%i (%s) debug=%s msg=%s", name.c_str(), __func__, error, LuaErrorString(error), debug.c_str(), lua_tostring(L, -1));
@@ -536,6 +537,30 @@ bool CLuaHandle::UpdateCallIn(lua_State* L, const string& name)
 }
 
 
+bool CLuaHandle::SetCallInBatched(const string& ciName, bool batch)
+{
+	int batchID = -1;
+
+	if (ciName ==      "UnitDamaged") { batchID = BATCH_UNIT_DAMAGED;       }
+	if (ciName ==   "UnitEnteredLos") { batchID = BATCH_UNIT_ENTERED_LOS;   }
+	if (ciName ==      "UnitLeftLos") { batchID = BATCH_UNIT_LEFT_LOS;      }
+	if (ciName == "UnitEnteredRadar") { batchID = BATCH_UNIT_ENTERED_RADAR; }
+	if (ciName ==    "UnitLeftRadar") { batchID = BATCH_UNIT_LEFT_RADAR;    }
+
+	if (batchID < 0)
+		return false;
+
+	batchedCallIns[batchID] = batch;
+
+	// queued events are flushed from GameFrame, make sure we receive
+	// it even if the script defines no handler for it
+	if (batch)
+		eventHandler.InsertEvent(this, "GameFrame");
+
+	return true;
+}
+
+
 void CLuaHandle::GamePreload()
 {
 	LUA_CALL_IN_CHECK(L);
@@ -617,6 +642,8 @@ void CLuaHandle::GameFrame(int frameNum)
 		return;
 	}
 
+	FlushBatchedCallIns();
+
 	LUA_CALL_IN_CHECK(L);
 	luaL_checkstack(L, 4, __func__);
 
@@ -950,6 +977,30 @@ void CLuaHandle::UnitDamaged(
 	int projectileID,
 	bool paralyzer)
 {
+	if (batchedCallIns[BATCH_UNIT_DAMAGED]) {
+		BatchedDamageEvent e;
+		e.unitID = unit->id;
+		e.unitDefID = unit->unitDef->id;
+		e.unitTeam = unit->team;
+		e.damage = damage;
+		e.weaponDefID = weaponDefID;
+		e.projectileID = projectileID;
+		e.paralyzer = paralyzer;
+
+		if (attacker != nullptr && GetHandleFullRead(L)) {
+			e.attackerID = attacker->id;
+			e.attackerDefID = attacker->unitDef->id;
+			e.attackerTeam = attacker->team;
+		} else {
+			e.attackerID = -1;
+			e.attackerDefID = -1;
+			e.attackerTeam = -1;
+		}
+
+		damageEventBatch.push_back(e);
+		return;
+	}
+
 	LUA_CALL_IN_CHECK(L);
 	luaL_checkstack(L, 11, __func__);
 
@@ -1085,8 +1136,118 @@ void CLuaHandle::LosCallIn(const LuaHashString& hs,
 }
 
 
+void CLuaHandle::QueueLosEvent(int batchID, const CUnit* unit, int allyTeam)
+{
+	BatchedLosEvent e;
+	e.unitID = unit->id;
+	e.unitTeam = unit->team;
+
+	// capture the access rights at event time, cf LosCallIn
+	if (GetHandleFullRead(L)) {
+		e.allyTeam = allyTeam;
+		e.unitDefID = unit->unitDef->id;
+	} else {
+		e.allyTeam = -1;
+		e.unitDefID = -1;
+	}
+
+	losEventBatches[batchID - BATCH_UNIT_ENTERED_LOS].push_back(e);
+}
+
+
+// delivers all events queued by batched call-ins (in queueing order
+// within each batch, batches in enum order) as one call each, right
+// before the GameFrame call-in; a batch is cleared even if its
+// <name>Batch handler is undefined
+void CLuaHandle::FlushBatchedCallIns()
+{
+	if (!damageEventBatch.empty()) {
+		LUA_CALL_IN_CHECK(L);
+		luaL_checkstack(L, 8, __func__);
+
+		static const LuaHashString cmdStr("UnitDamagedBatch");
+		const LuaUtils::ScopedDebugTraceBack traceBack(L);
+
+		if (cmdStr.GetGlobalFunc(L)) {
+			lua_createtable(L, damageEventBatch.size(), 0);
+
+			for (size_t i = 0; i < damageEventBatch.size(); i++) {
+				const BatchedDamageEvent& e = damageEventBatch[i];
+
+				// positional fields, same order as plain UnitDamaged
+				lua_createtable(L, 10, 0);
+				lua_pushnumber(L, e.unitID);        lua_rawseti(L, -2,  1);
+				lua_pushnumber(L, e.unitDefID);     lua_rawseti(L, -2,  2);
+				lua_pushnumber(L, e.unitTeam);      lua_rawseti(L, -2,  3);
+				lua_pushnumber(L, e.damage);        lua_rawseti(L, -2,  4);
+				lua_pushboolean(L, e.paralyzer);    lua_rawseti(L, -2,  5);
+				lua_pushnumber(L, e.weaponDefID);   lua_rawseti(L, -2,  6);
+				lua_pushnumber(L, e.projectileID);  lua_rawseti(L, -2,  7);
+
+				if (e.attackerID >= 0) {
+					lua_pushnumber(L, e.attackerID);    lua_rawseti(L, -2,  8);
+					lua_pushnumber(L, e.attackerDefID); lua_rawseti(L, -2,  9);
+					lua_pushnumber(L, e.attackerTeam);  lua_rawseti(L, -2, 10);
+				}
+
+				lua_rawseti(L, -2, i + 1);
+			}
+
+			RunCallInTraceback(L, cmdStr, 1, 0, traceBack.GetErrFuncIdx(), false);
+		}
+
+		damageEventBatch.clear();
+	}
+
+	static const LuaHashString losCmdStrs[] = {
+		LuaHashString("UnitEnteredLosBatch"),
+		LuaHashString("UnitLeftLosBatch"),
+		LuaHashString("UnitEnteredRadarBatch"),
+		LuaHashString("UnitLeftRadarBatch"),
+	};
+
+	for (int b = 0; b < (NUM_BATCHED_CALLINS - BATCH_UNIT_ENTERED_LOS); b++) {
+		std::vector<BatchedLosEvent>& batch = losEventBatches[b];
+
+		if (batch.empty())
+			continue;
+
+		LUA_CALL_IN_CHECK(L);
+		luaL_checkstack(L, 6, __func__);
+
+		if (losCmdStrs[b].GetGlobalFunc(L)) {
+			lua_createtable(L, batch.size(), 0);
+
+			for (size_t i = 0; i < batch.size(); i++) {
+				const BatchedLosEvent& e = batch[i];
+
+				lua_createtable(L, 4, 0);
+				lua_pushnumber(L, e.unitID);   lua_rawseti(L, -2, 1);
+				lua_pushnumber(L, e.unitTeam); lua_rawseti(L, -2, 2);
+
+				if (e.unitDefID >= 0) {
+					lua_pushnumber(L, e.allyTeam);  lua_rawseti(L, -2, 3);
+					lua_pushnumber(L, e.unitDefID); lua_rawseti(L, -2, 4);
+				}
+
+				lua_rawseti(L, -2, i + 1);
+			}
+
+			RunCallIn(L, losCmdStrs[b], 1, 0);
+		}
+
+		batch.clear();
+	}
+}
+
+
 void CLuaHandle::UnitEnteredRadar(const CUnit* unit, int allyTeam)
 {
+	if (batchedCallIns[BATCH_UNIT_ENTERED_RADAR]) {
+		QueueLosEvent(BATCH_UNIT_ENTERED_RADAR, unit, allyTeam);
+		return;
+	}
+
 	static const LuaHashString hs("UnitEnteredRadar");
 	LosCallIn(hs, unit, allyTeam);
 }
@@ -1094,6 +1255,11 @@ void CLuaHandle::UnitEnteredRadar(const CUnit* unit, int allyTeam)
 
 void CLuaHandle::UnitEnteredLos(const CUnit* unit, int allyTeam)
 {
+	if (batchedCallIns[BATCH_UNIT_ENTERED_LOS]) {
+		QueueLosEvent(BATCH_UNIT_ENTERED_LOS, unit, allyTeam);
+		return;
+	}
+
 	static const LuaHashString hs("UnitEnteredLos");
 	LosCallIn(hs, unit, allyTeam);
 }
@@ -1101,6 +1267,11 @@ void CLuaHandle::UnitEnteredLos(const CUnit* unit, int allyTeam)
 
 void CLuaHandle::UnitLeftRadar(const CUnit* unit, int allyTeam)
 {
+	if (batchedCallIns[BATCH_UNIT_LEFT_RADAR]) {
+		QueueLosEvent(BATCH_UNIT_LEFT_RADAR, unit, allyTeam);
+		return;
+	}
+
 	static const LuaHashString hs("UnitLeftRadar");
 	LosCallIn(hs, unit, allyTeam);
 }
@@ -1108,6 +1279,11 @@ void CLuaHandle::UnitLeftRadar(const CUnit* unit, int allyTeam)
 
 void CLuaHandle::UnitLeftLos(const CUnit* unit, int allyTeam)
 {
+	if (batchedCallIns[BATCH_UNIT_LEFT_LOS]) {
+		QueueLosEvent(BATCH_UNIT_LEFT_LOS, unit, allyTeam);
+		return;
+	}
+
 	static const LuaHashString hs("UnitLeftLos");
 	LosCallIn(hs, unit, allyTeam);
 }
@@ -2470,6 +2646,7 @@ bool CLuaHandle::AddBasicCalls(lua_State* L)
 	lua_newtable(L); {
 		HSTR_PUSH_CFUNC(L, "Kill",            KillActiveHandle);
 		HSTR_PUSH_CFUNC(L, "UpdateCallIn",    CallOutUpdateCallIn);
+		HSTR_PUSH_CFUNC(L, "SetCallInBatched", CallOutSetCallInBatched);
 		HSTR_PUSH_CFUNC(L, "GetName",         CallOutGetName);
 		HSTR_PUSH_CFUNC(L, "GetSynced",       CallOutGetSynced);
 		HSTR_PUSH_CFUNC(L, "GetFullCtrl",     CallOutGetFullCtrl);
@@ -2633,6 +2810,15 @@ int CLuaHandle::CallOutUpdateCallIn(lua_State* L)
 }
 
 
+int CLuaHandle::CallOutSetCallInBatched(lua_State* L)
+{
+	const string name = luaL_checkstring(L, 1);
+	CLuaHandle* lh = GetHandle(L);
+	lua_pushboolean(L, lh->SetCallInBatched(name, luaL_checkboolean(L, 2)));
+	return 1;
+}
+
+
 /******************************************************************************/
 /******************************************************************************/
 
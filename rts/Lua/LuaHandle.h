@@ -39,6 +39,7 @@ struct LuaHashString;
 struct lua_State;
 class LuaRBOs;
 class LuaFBOs;
+class LuaVBOs;
 class LuaTextures;
 class LuaShaders;
 class CLuaDisplayLists;
@@ -98,6 +99,7 @@ class CLuaHandle : public CEventClient
 		LuaTextures& GetTextures(const lua_State* L = NULL) { return GetLuaContextData(L)->textures; }
 		LuaFBOs& GetFBOs(const lua_State* L = NULL) { return GetLuaContextData(L)->fbos; }
 		LuaRBOs& GetRBOs(const lua_State* L = NULL) { return GetLuaContextData(L)->rbos; }
+		LuaVBOs& GetVBOs(const lua_State* L = NULL) { return GetLuaContextData(L)->vbos; }
 		CLuaDisplayLists& GetDisplayLists(const lua_State* L = NULL) { return GetLuaContextData(L)->displayLists; }
 #endif
 
@@ -105,6 +107,7 @@ class CLuaHandle : public CEventClient
 		bool WantsEvent(const string& name) override { return HasCallIn(L, name); }
 		virtual bool HasCallIn(lua_State* L, const string& name);
 		virtual bool UpdateCallIn(lua_State* L, const string& name);
+		bool SetCallInBatched(const string& ciName, bool batch);
 
 		void Load(IArchive* archive) override;
 
@@ -287,8 +290,41 @@ class CLuaHandle : public CEventClient
 		void LosCallIn(const LuaHashString& hs, const CUnit* unit, int allyTeam);
 		void UnitCallIn(const LuaHashString& hs, const CUnit* unit);
 
+		void QueueLosEvent(int batchID, const CUnit* unit, int allyTeam);
+		void FlushBatchedCallIns();
+
 		void RunDrawCallIn(const LuaHashString& hs);
 
+	protected:
+		// opt-in per-frame batching of high-frequency unit call-ins
+		// (Script.SetCallInBatched); queued events are delivered as a
+		// single packed array through <name>Batch right before the
+		// GameFrame call-in
+		enum {
+			BATCH_UNIT_DAMAGED       = 0,
+			BATCH_UNIT_ENTERED_LOS   = 1,
+			BATCH_UNIT_LEFT_LOS      = 2,
+			BATCH_UNIT_ENTERED_RADAR = 3,
+			BATCH_UNIT_LEFT_RADAR    = 4,
+			NUM_BATCHED_CALLINS      = 5,
+		};
+
+		struct BatchedDamageEvent {
+			int unitID, unitDefID, unitTeam;
+			float damage;
+			int weaponDefID, projectileID;
+			int attackerID, attackerDefID, attackerTeam;
+			bool paralyzer;
+		};
+		struct BatchedLosEvent {
+			int unitID, unitTeam, allyTeam, unitDefID;
+		};
+
+		bool batchedCallIns[NUM_BATCHED_CALLINS] = {false, false, false, false, false};
+
+		std::vector<BatchedDamageEvent> damageEventBatch;
+		std::vector<BatchedLosEvent> losEventBatches[NUM_BATCHED_CALLINS - BATCH_UNIT_ENTERED_LOS];
+
 	protected:
 		bool userMode;
 		bool killMe; // set for handles that fail to RunCallIn
@@ -319,6 +355,7 @@ class CLuaHandle : public CEventClient
 		static int CallOutGetRegistry(lua_State* L);
 		static int CallOutGetCallInList(lua_State* L);
 		static int CallOutUpdateCallIn(lua_State* L);
+		static int CallOutSetCallInBatched(lua_State* L);
 		static int CallOutIsEngineMinVersion(lua_State* L);
 
 	public: // static
@@ -327,6 +364,7 @@ class CLuaHandle : public CEventClient
 		static inline LuaTextures& GetActiveTextures(lua_State* L) { return GetLuaContextData(L)->textures; }
 		static inline LuaFBOs& GetActiveFBOs(lua_State* L) { return GetLuaContextData(L)->fbos; }
 		static inline LuaRBOs& GetActiveRBOs(lua_State* L) { return GetLuaContextData(L)->rbos; }
+		static inline LuaVBOs& GetActiveVBOs(lua_State* L) { return GetLuaContextData(L)->vbos; }
 		static inline CLuaDisplayLists& GetActiveDisplayLists(lua_State* L) { return GetLuaContextData(L)->displayLists; }
 #endif
 
@@ -16,6 +16,7 @@
 #include "Sim/Misc/GlobalSynced.h" // simFrame
 #include "System/Log/ILog.h"
 #include "System/StringUtil.h"
+#include "System/myMath.h"
 
 struct ActiveUniform {
 	GLint size = 0;
@@ -314,6 +315,29 @@ void LuaMaterial::Finalize()
 			texCount = t + 1;
 		}
 	}
+
+	sortKey = CalcSortKey();
+}
+
+
+std::uint64_t LuaMaterial::CalcSortKey() const
+{
+	const LuaMatShader& fwdShader = shaders[LuaMatShader::LUASHADER_PASS_FWD];
+	const LuaMatShader& dfrShader = shaders[LuaMatShader::LUASHADER_PASS_DFR];
+
+	// pack the states in the same (GL switching-cost) order that Compare
+	// checks them in, most expensive state in the most significant bits
+	std::uint64_t key = 0;
+
+	key |= (std::uint64_t(std::uint8_t(Clamp(order, -128, 127) + 128)) << 56);
+	key |= (std::uint64_t(fwdShader.type & 0x7                       ) << 53);
+	key |= (std::uint64_t(std::min(fwdShader.openglID, GLuint(0xFFFF))) << 37);
+	key |= (std::uint64_t(dfrShader.type & 0x7                       ) << 34);
+	key |= (std::uint64_t(std::min(dfrShader.openglID, GLuint(0xFFFF))) << 18);
+	key |= (std::uint64_t(cullingMode & 0xFFFF                       ) <<  2);
+	key |= (std::uint64_t(!useCamera));
+
+	return key;
 }
 
 
@@ -325,7 +349,7 @@ void LuaMaterial::Execute(const LuaMaterial& prev, bool deferredPass) const
 		glCallList(preList);
 
 	shaders[deferredPass].Execute(prev.shaders[deferredPass], deferredPass);
-	uniforms[deferredPass].Execute();
+	uniforms[deferredPass].Execute(shaders[deferredPass].IsCustomType()? shaders[deferredPass].openglID: 0);
 
 	for (int t = 0; t < std::max(texCount, prev.texCount); ++t) {
 		if (prev.textures[t] != textures[t]) {
@@ -368,6 +392,13 @@ int LuaMaterial::Compare(const LuaMaterial& a, const LuaMaterial& b)
 
 	if (a.type != b.type)
 		return ((a.type > b.type) * 2 - 1);  // should not happen
+
+	// fast path for bin lookups and insertions; the packed keys only tie
+	// (clamped fields aside) when the expensive states match, everything
+	// the key does not cover is compared below
+	if (a.sortKey != b.sortKey)
+		return ((a.sortKey > b.sortKey) * 2 - 1);
+
 	if (a.order != b.order)
 		return ((a.order > b.order) * 2 - 1);
 
@@ -701,26 +732,53 @@ void LuaMatUniforms::Parse(lua_State* L, const int tableIdx)
 	}
 }
 
-void LuaMatUniforms::Execute() const
+// maps program ID's to the stamp generation their engine-global uniforms
+// were last uploaded in; uniform values live in the program object so two
+// materials that share a program (e.g. differing only in textures) do not
+// both need to re-upload them
+static spring::unsynced_map<GLuint, unsigned int> programUniformStamps;
+static unsigned int uniformPassStamp = 0;
+
+void LuaMatUniforms::BeginPass()
 {
-	viewMatrix.Execute(camera->GetViewMatrix());
-	projMatrix.Execute(camera->GetProjectionMatrix());
-	viprMatrix.Execute(camera->GetViewProjectionMatrix());
+	uniformPassStamp += 1;
+}
 
-	viewMatrixInv.Execute(camera->GetViewMatrixInverse());
-	projMatrixInv.Execute(camera->GetProjectionMatrixInverse());
-	viprMatrixInv.Execute(camera->GetViewProjectionMatrixInverse());
+void LuaMatUniforms::Execute(GLuint programID) const
+{
+	bool uploadGlobals = true;
 
-	shadowMatrix.Execute(shadowHandler->GetShadowMatrix());
-	shadowParams.Execute(shadowHandler->GetShadowParams());
+	// engine-type shaders (programID = 0) bind their programs through the
+	// setup state-funcs which we can not see, so always upload for those
+	if (programID != 0) {
+		unsigned int& stamp = programUniformStamps[programID];
 
-	camPos.Execute(camera->GetPos());
-	camDir.Execute(camera->GetDir());
-	sunDir.Execute(sky->GetLight()->GetLightDir());
-	rndVec.Execute(guRNG.NextVector());
+		uploadGlobals = (stamp != uniformPassStamp);
+		stamp = uniformPassStamp;
+	}
+
+	if (uploadGlobals) {
+		viewMatrix.Execute(camera->GetViewMatrix());
+		projMatrix.Execute(camera->GetProjectionMatrix());
+		viprMatrix.Execute(camera->GetViewProjectionMatrix());
+
+		viewMatrixInv.Execute(camera->GetViewMatrixInverse());
+		projMatrixInv.Execute(camera->GetProjectionMatrixInverse());
+		viprMatrixInv.Execute(camera->GetViewProjectionMatrixInverse());
+
+		shadowMatrix.Execute(shadowHandler->GetShadowMatrix());
+		shadowParams.Execute(shadowHandler->GetShadowParams());
 
-	simFrame.Execute(gs->frameNum);
-	visFrame.Execute(globalRendering->drawFrame);
+		camPos.Execute(camera->GetPos());
+		camDir.Execute(camera->GetDir());
+		sunDir.Execute(sky->GetLight()->GetLightDir());
+
+		simFrame.Execute(gs->frameNum);
+		visFrame.Execute(globalRendering->drawFrame);
+	}
+
+	// deliberately never cached, materials expect a fresh value each time
+	rndVec.Execute(guRNG.NextVector());
 }
 
 void LuaMatUniforms::ExecuteInstance(const CSolidObject* o, const float2 alpha) const
@@ -3,6 +3,7 @@
 #ifndef LUA_MATERIAL_H
 #define LUA_MATERIAL_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -109,11 +110,18 @@ public:
 	void AutoLink(LuaMatShader* s);
 	void Validate(LuaMatShader* s);
 
-	void Execute() const;
+	void Execute(GLuint programID) const;
 	void ExecuteInstance(const CSolidObject* o, const float2 alpha) const;
 
 	static int Compare(const LuaMatUniforms& a, const LuaMatUniforms& b);
 
+	// invalidates the per-program upload stamps; the engine-global uniforms
+	// (camera, shadow, sun, ...) are constant while one set of bins is drawn
+	// so programs shared by several materials need them uploaded only once
+	// per pass, but any caller that changes the active camera (a new bin
+	// pass, a single-object draw) must start a new stamp generation first
+	static void BeginPass();
+
 public:
 	struct IUniform {
 		static_assert(GL_INVALID_INDEX == -1, "glGetUniformLocation is defined to return -1 (GL_INVALID_INDEX) for invalid names");
@@ -207,6 +215,7 @@ class LuaMaterial {
 		LuaMaterial(LuaMatType matType = LuaMatType(-1)):
 		  type(matType), // default invalid
 		  order(0),
+		  sortKey(0),
 		  texCount(0),
 		  cullingMode(0),
 
@@ -230,6 +239,8 @@ class LuaMaterial {
 
 		static int Compare(const LuaMaterial& a, const LuaMaterial& b);
 
+		std::uint64_t CalcSortKey() const;
+
 		bool operator<(const LuaMaterial& m) const { return (Compare(*this, m) < 0); }
 		bool operator==(const LuaMaterial& m) const { return (Compare(*this, m) == 0); }
 
@@ -239,6 +250,11 @@ class LuaMaterial {
 		LuaMatType type;
 
 		int order; // for manually adjusting rendering order
+
+		// expensive-to-switch GL state (order, shaders, culling) packed
+		// into one value by Finalize; primary bin sorting/lookup criterium
+		std::uint64_t sortKey;
+
 		int texCount;
 
 		// [0] := standard, [1] := deferred
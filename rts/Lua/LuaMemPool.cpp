@@ -10,15 +10,6 @@
 #include "System/Log/ILog.h"
 #include "System/Threading/SpringThreading.h"
 
-// if 1, places an upper limit on pool allocation size
-// needed most when free chunks are stored in an array
-// rather than a hmap since the former would be highly
-// sparse; it also prevents the larger (ie more rarely
-// requested, so not often recycled either) allocations
-// from accumulating
-#define CHECK_MAX_ALLOC_SIZE 1
-
-
 // global, affects all pool instances
 bool LuaMemPool::enabled = false;
 
@@ -32,9 +23,22 @@ static spring::mutex gMutex;
 // Lua code tends to perform many smaller *short-lived* allocations
 // this frees us from having to handle all possible sizes, just the
 // most common
-static bool AllocInternal(size_t size) { return ((size * CHECK_MAX_ALLOC_SIZE) <= LuaMemPool::MAX_ALLOC_SIZE); }
+static bool AllocInternal(size_t size) { return (size <= LuaMemPool::MAX_ALLOC_SIZE); }
 static bool AllocExternal(size_t size) { return (!LuaMemPool::enabled || !AllocInternal(size)); }
 
+// index of the smallest power-of-two class (8B, 16B, .., 512B) that
+// fits <size>; only called for pool-internal (<= 512B) allocations
+static size_t AllocSizeClass(size_t size)
+{
+	size_t cls = 0;
+
+	for (size_t clsSize = LuaMemPool::MIN_ALLOC_SIZE; clsSize < size; clsSize <<= 1) {
+		cls += 1;
+	}
+
+	return cls;
+}
+
 
 LuaMemPool* LuaMemPool::AcquirePtr(bool shared)
 {
@@ -67,6 +71,11 @@ void LuaMemPool::ReleasePtr(LuaMemPool* p)
 		return;
 	}
 
+	// non-shared pools belong to exactly one handle; give the slabs
+	// back to the system in bulk when that handle gets torn down, no
+	// per-chunk walk required
+	p->DeleteBlocks();
+
 	gMutex.lock();
 	gIndcs.push_back(p->GetGlobalIndex());
 	gMutex.unlock();
@@ -89,15 +98,15 @@ LuaMemPool* LuaMemPool::GetSharedPoolPtr() { return &gSharedPool; }
 
 LuaMemPool::LuaMemPool(size_t lmpIndex): globalIndex(lmpIndex)
 {
+	for (size_t cls = 0; cls < NUM_SIZE_CLASSES; cls++) {
+		freeChunks[cls] = nullptr;
+		nextSlabChunks[cls] = 16;
+	}
+
 	if (!LuaMemPool::enabled)
 		return;
 
-	freeChunksTable.reserve(16384);
-	chunkCountTable.reserve(16384);
-
-	#if 1
 	allocBlocks.reserve(1024);
-	#endif
 }
 
 LuaMemPool::~LuaMemPool()
@@ -109,17 +118,17 @@ LuaMemPool::~LuaMemPool()
 void LuaMemPool::LogStats(const char* handle, const char* lctype) const
 {
 	LOG(
-		"[LuaMemPool::%s][handle=%s (%s)] index=%lu {blocks,sizes}={%lu,%lu} {int,ext,rec}Allocs={%lu,%lu,%lu} {chunk,block}Bytes={%lu,%lu}",
+		"[LuaMemPool::%s][handle=%s (%s)] index=%lu blocks=%lu {int,ext,rec}Allocs={%lu,%lu,%lu} {chunk,peak,block}Bytes={%lu,%lu,%lu}",
 		__func__,
 		handle,
 		lctype,
 		(unsigned long) globalIndex,
 		(unsigned long) allocBlocks.size(),
-		(unsigned long) chunkCountTable.size(),
 		(unsigned long) allocStats[STAT_NIA],
 		(unsigned long) allocStats[STAT_NEA],
 		(unsigned long) allocStats[STAT_NRA],
 		(unsigned long) allocStats[STAT_NCB],
+		(unsigned long) allocStats[STAT_PCB],
 		(unsigned long) allocStats[STAT_NBB]
 	);
 }
@@ -127,11 +136,16 @@ void LuaMemPool::LogStats(const char* handle, const char* lctype) const
 
 void LuaMemPool::DeleteBlocks()
 {
-	#if 1
 	for (void* p: allocBlocks) {
 		::operator delete(p);
 	}
-	#endif
+
+	allocBlocks.clear();
+
+	for (size_t cls = 0; cls < NUM_SIZE_CLASSES; cls++) {
+		freeChunks[cls] = nullptr;
+		nextSlabChunks[cls] = 16;
+	}
 
 	ClearStats(true);
 }
@@ -143,48 +157,40 @@ void* LuaMemPool::Alloc(size_t size)
 		return ::operator new(size);
 	}
 
-	allocStats[STAT_NIA] += 1;
-	allocStats[STAT_NCB] += (size = std::max(size, size_t(MIN_ALLOC_SIZE)));
-
-	auto freeChunksTablePair = std::make_pair(freeChunksTable.find(size), false);
+	const size_t cls = AllocSizeClass(size = std::max(size, size_t(MIN_ALLOC_SIZE)));
+	const size_t clsSize = MIN_ALLOC_SIZE << cls;
 
-	if (freeChunksTablePair.first == freeChunksTable.end())
-		freeChunksTablePair = freeChunksTable.insert(size, nullptr);
+	allocStats[STAT_NIA] += 1;
+	allocStats[STAT_NCB] += clsSize;
+	allocStats[STAT_PCB] = std::max(allocStats[STAT_PCB], allocStats[STAT_NCB]);
 
-	void* ptr = (freeChunksTablePair.first)->second;
+	void* ptr = freeChunks[cls];
 
 	if (ptr != nullptr) {
-		(freeChunksTablePair.first)->second = (*(void**) ptr);
+		freeChunks[cls] = (*(void**) ptr);
 
 		allocStats[STAT_NRA] += 1;
 		return ptr;
 	}
 
-	auto chunkCountTablePair = std::make_pair(chunkCountTable.find(size), false);
-
-	if (chunkCountTablePair.first == chunkCountTable.end())
-		chunkCountTablePair = chunkCountTable.insert(size, 8);
-
-	const size_t numChunks = (chunkCountTablePair.first)->second;
-	const size_t numBytes = size * numChunks;
+	// class exhausted; carve a new slab into a chain of chunks (every
+	// class size is at least MIN_ALLOC_SIZE so the links always fit)
+	const size_t numChunks = nextSlabChunks[cls];
+	const size_t numBytes = clsSize * numChunks;
 
 	void* newBlock = ::operator new(numBytes);
 	uint8_t* newBytes = reinterpret_cast<uint8_t*>(newBlock);
 
-	#if 1
 	allocBlocks.push_back(newBlock);
-	#endif
 
-	// new allocation; construct chain of chunks within the memory block
-	// (this requires the block size to be at least MIN_ALLOC_SIZE bytes)
 	for (size_t i = 0; i < (numChunks - 1); ++i) {
-		*(void**) &newBytes[i * size] = (void*) &newBytes[(i + 1) * size];
+		*(void**) &newBytes[i * clsSize] = (void*) &newBytes[(i + 1) * clsSize];
 	}
 
-	*(void**) &newBytes[(numChunks - 1) * size] = nullptr;
+	*(void**) &newBytes[(numChunks - 1) * clsSize] = nullptr;
 
-	freeChunksTable[size] = (*(void**) newBlock);
-	chunkCountTable[size] *= 2; // geometric increase
+	freeChunks[cls] = (*(void**) newBlock);
+	nextSlabChunks[cls] = std::min(numChunks * 2, size_t(4096)); // geometric increase
 
 	allocStats[STAT_NBB] += numBytes;
 	return newBlock;
@@ -214,9 +220,11 @@ void LuaMemPool::Free(void* ptr, size_t size)
 		return;
 	}
 
-	allocStats[STAT_NCB] -= (size = std::max(size, size_t(MIN_ALLOC_SIZE)));
+	const size_t cls = AllocSizeClass(size = std::max(size, size_t(MIN_ALLOC_SIZE)));
+
+	allocStats[STAT_NCB] -= (MIN_ALLOC_SIZE << cls);
 
-	*(void**) ptr = freeChunksTable[size];
-	freeChunksTable[size] = ptr;
+	*(void**) ptr = freeChunks[cls];
+	freeChunks[cls] = ptr;
 }
 
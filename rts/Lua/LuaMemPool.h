@@ -6,8 +6,6 @@
 #include <cstddef>
 #include <vector>
 
-#include "System/UnorderedMap.hpp"
-
 class LuaMemPool {
 public:
 	LuaMemPool(size_t lmpIndex);
@@ -41,6 +39,7 @@ public:
 		allocStats[STAT_NEA] *= (1 - b);
 		allocStats[STAT_NRA] *= (1 - b);
 		allocStats[STAT_NCB] *= (1 - b);
+		allocStats[STAT_PCB] *= (1 - b);
 		allocStats[STAT_NBB] *= (1 - b);
 	}
 
@@ -48,15 +47,32 @@ public:
 	size_t  GetSharedCount() const { return sharedCount; }
 	size_t& GetSharedCount()       { return sharedCount; }
 
+	size_t GetLiveAllocBytes() const { return allocStats[STAT_NCB]; }
+	size_t GetPeakAllocBytes() const { return allocStats[STAT_PCB]; }
+	size_t GetSlabAllocBytes() const { return allocStats[STAT_NBB]; }
+	size_t GetNumIntAllocs() const { return allocStats[STAT_NIA]; }
+	size_t GetNumExtAllocs() const { return allocStats[STAT_NEA]; }
+	size_t GetNumRecAllocs() const { return allocStats[STAT_NRA]; }
+
 public:
-	static constexpr size_t MIN_ALLOC_SIZE = sizeof(void*);
-	static constexpr size_t MAX_ALLOC_SIZE = (1024 * 1024) - 1;
+	// fixed at 8 (not sizeof(void*)) so the class progression is the
+	// same on 32- and 64-bit builds; the chain links still fit either way
+	static constexpr size_t MIN_ALLOC_SIZE = 8;
+	// largest pooled (power-of-two) size class, anything above
+	// goes straight to the system allocator
+	static constexpr size_t MAX_ALLOC_SIZE = 512;
+	static constexpr size_t NUM_SIZE_CLASSES = 7; // 8B .. 512B
+
+	static_assert(MIN_ALLOC_SIZE >= sizeof(void*), "free chunks store their chain link inline");
+	static_assert((MIN_ALLOC_SIZE << (NUM_SIZE_CLASSES - 1)) == MAX_ALLOC_SIZE, "every size up to MAX_ALLOC_SIZE must map to a valid class index");
 
 	static bool enabled;
 
 private:
-	spring::unsynced_map<size_t, void*> freeChunksTable;
-	spring::unsynced_map<size_t, size_t> chunkCountTable;
+	// head of the free-chunk chain per size class
+	void* freeChunks[NUM_SIZE_CLASSES];
+	// number of chunks carved out of the next slab per class, doubles per slab
+	size_t nextSlabChunks[NUM_SIZE_CLASSES];
 
 	std::vector<void*> allocBlocks;
 
@@ -65,13 +81,13 @@ private:
 		STAT_NEA = 1, // number of external allocs
 		STAT_NRA = 2, // number of recycled allocs
 		STAT_NCB = 3, // number of chunk bytes currently in use
-		STAT_NBB = 4, // number of block bytes alloced in total
+		STAT_PCB = 4, // peak number of chunk bytes in use
+		STAT_NBB = 5, // number of block bytes alloced in total
 	};
 
-	size_t allocStats[5] = {0, 0, 0, 0, 0};
+	size_t allocStats[6] = {0, 0, 0, 0, 0, 0};
 	size_t globalIndex = 0;
 	size_t sharedCount = 0;
 };
 
 #endif
-
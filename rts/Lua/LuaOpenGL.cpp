@@ -25,6 +25,7 @@
 #include "LuaIO.h"
 #include "LuaOpenGLUtils.h"
 #include "LuaRBOs.h"
+#include "LuaVBOs.h"
 #include "LuaShaders.h"
 #include "LuaTextures.h"
 #include "LuaUtils.h"
@@ -51,6 +52,7 @@
 #include "Rendering/Env/IWater.h"
 #include "Rendering/Env/CubeMapHandler.h"
 #include "Rendering/GL/glExtra.h"
+#include "Rendering/GL/StateCache.h"
 #include "Rendering/Models/3DModel.h"
 #include "Rendering/Shaders/Shader.h"
 #include "Rendering/Textures/Bitmap.h"
@@ -395,7 +397,8 @@ bool LuaOpenGL::PushEntries(lua_State* L)
 
 	LuaFonts::PushEntries(L);
 
-//FIXME		LuaVBOs::PushEntries(L);
+	if (GLEW_ARB_vertex_buffer_object)
+		LuaVBOs::PushEntries(L);
 
 	return true;
 }
@@ -516,6 +519,7 @@ void LuaOpenGL::EnableCommon(DrawMode mode)
 	if (safeMode) {
 		glPushAttrib(AttribBits);
 		glCallList(resetStateList);
+		GL::InvalidateStateCache();
 	}
 	// FIXME  --  not needed by shadow or minimap   (use a WorldCommon ? )
 	//glEnable(GL_NORMALIZE);
@@ -531,6 +535,7 @@ void LuaOpenGL::DisableCommon(DrawMode mode)
 	drawMode = DRAW_NONE;
 	if (safeMode) {
 		glPopAttrib();
+		GL::InvalidateStateCache();
 	}
 	if (IS_GL_FUNCTION_AVAILABLE(glUseProgram)) {
 		glUseProgram(0);
@@ -567,6 +572,7 @@ void LuaOpenGL::ResetDrawGenesis()
 	if (safeMode) {
 		ResetGenesisMatrices();
 		glCallList(resetStateList);
+		GL::InvalidateStateCache();
 	}
 }
 
@@ -597,6 +603,7 @@ void LuaOpenGL::ResetDrawWorld()
 	if (safeMode) {
 		ResetWorldMatrices();
 		glCallList(resetStateList);
+		GL::InvalidateStateCache();
 	}
 }
 
@@ -627,6 +634,7 @@ void LuaOpenGL::ResetDrawWorldPreUnit()
 	if (safeMode) {
 		ResetWorldMatrices();
 		glCallList(resetStateList);
+		GL::InvalidateStateCache();
 	}
 }
 
@@ -667,6 +675,7 @@ void LuaOpenGL::ResetDrawWorldShadow()
 	if (safeMode) {
 		ResetWorldShadowMatrices();
 		glCallList(resetStateList);
+		GL::InvalidateStateCache();
 		glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
 		glPolygonOffset(1.0f, 1.0f);
 		glEnable(GL_POLYGON_OFFSET_FILL);
@@ -700,6 +709,7 @@ void LuaOpenGL::ResetDrawWorldReflection()
 	if (safeMode) {
 		ResetWorldMatrices();
 		glCallList(resetStateList);
+		GL::InvalidateStateCache();
 	}
 }
 
@@ -730,6 +740,7 @@ void LuaOpenGL::ResetDrawWorldRefraction()
 	if (safeMode) {
 		ResetWorldMatrices();
 		glCallList(resetStateList);
+		GL::InvalidateStateCache();
 	}
 }
 
@@ -746,6 +757,7 @@ void LuaOpenGL::EnableDrawScreenCommon()
 	SetupScreenMatrices();
 	SetupScreenLighting();
 	glCallList(resetStateList);
+	GL::InvalidateStateCache();
 	//glEnable(GL_NORMALIZE);
 }
 
@@ -763,6 +775,7 @@ void LuaOpenGL::ResetDrawScreenCommon()
 	if (safeMode) {
 		ResetScreenMatrices();
 		glCallList(resetStateList);
+		GL::InvalidateStateCache();
 	}
 }
 
@@ -796,6 +809,7 @@ void LuaOpenGL::DisableDrawInMiniMap()
 			glPopAttrib();
 		} else {
 			glCallList(resetStateList);
+			GL::InvalidateStateCache();
 		}
 		resetMatrixFunc = ResetScreenMatrices;
 		ResetScreenMatrices();
@@ -814,6 +828,7 @@ void LuaOpenGL::ResetDrawInMiniMap()
 	if (safeMode) {
 		ResetMiniMapMatrices();
 		glCallList(resetStateList);
+		GL::InvalidateStateCache();
 	}
 }
 
@@ -848,6 +863,7 @@ void LuaOpenGL::DisableDrawInMiniMapBackground()
 			glPopAttrib();
 		} else {
 			glCallList(resetStateList);
+			GL::InvalidateStateCache();
 		}
 		resetMatrixFunc = ResetScreenMatrices;
 		ResetScreenMatrices();
@@ -866,6 +882,7 @@ void LuaOpenGL::ResetDrawInMiniMapBackground()
 	if (safeMode) {
 		ResetMiniMapMatrices();
 		glCallList(resetStateList);
+		GL::InvalidateStateCache();
 	}
 }
 
@@ -1405,6 +1422,7 @@ int LuaOpenGL::UnitCommon(lua_State* L, bool applyTransform, bool callDrawUnit)
 	}
 
 	glPopAttrib();
+	GL::InvalidateStateCache();
 	return 0;
 }
 
@@ -1509,6 +1527,7 @@ int LuaOpenGL::FeatureCommon(lua_State* L, bool applyTransform, bool callDrawFea
 	}
 
 	glPopAttrib();
+	GL::InvalidateStateCache();
 	return 0;
 }
 
@@ -2396,6 +2415,7 @@ int LuaOpenGL::ResetState(lua_State* L)
 {
 	CheckDrawingEnabled(L, __FUNCTION__);
 	glCallList(resetStateList);
+	GL::InvalidateStateCache();
 	return 0;
 }
 
@@ -2508,9 +2528,9 @@ int LuaOpenGL::DepthMask(lua_State* L)
 {
 	CheckDrawingEnabled(L, __FUNCTION__);
 	if (luaL_checkboolean(L, 1)) {
-		glDepthMask(GL_TRUE);
+		GL::DepthMask(GL_TRUE);
 	} else {
-		glDepthMask(GL_FALSE);
+		GL::DepthMask(GL_FALSE);
 	}
 	return 0;
 }
@@ -2527,14 +2547,14 @@ int LuaOpenGL::DepthTest(lua_State* L)
 
 	if (lua_isboolean(L, 1)) {
 		if (lua_toboolean(L, 1)) {
-			glEnable(GL_DEPTH_TEST);
+			GL::Enable(GL_DEPTH_TEST);
 		} else {
-			glDisable(GL_DEPTH_TEST);
+			GL::Disable(GL_DEPTH_TEST);
 		}
 	}
 	else if (lua_isnumber(L, 1)) {
-		glEnable(GL_DEPTH_TEST);
-		glDepthFunc((GLenum)lua_tonumber(L, 1));
+		GL::Enable(GL_DEPTH_TEST);
+		GL::DepthFunc((GLenum)lua_tonumber(L, 1));
 	}
 	else {
 		luaL_error(L, "Incorrect arguments to gl.DepthTest()");
@@ -2548,9 +2568,9 @@ int LuaOpenGL::DepthClamp(lua_State* L)
 	CheckDrawingEnabled(L, __FUNCTION__);
 	luaL_checktype(L, 1, LUA_TBOOLEAN);
 	if (lua_toboolean(L, 1)) {
-		glEnable(GL_DEPTH_CLAMP_NV);
+		GL::Enable(GL_DEPTH_CLAMP_NV);
 	} else {
-		glDisable(GL_DEPTH_CLAMP_NV);
+		GL::Disable(GL_DEPTH_CLAMP_NV);
 	}
 	return 0;
 }
@@ -2567,13 +2587,13 @@ int LuaOpenGL::Culling(lua_State* L)
 
 	if (lua_isboolean(L, 1)) {
 		if (lua_toboolean(L, 1)) {
-			glEnable(GL_CULL_FACE);
+			GL::Enable(GL_CULL_FACE);
 		} else {
-			glDisable(GL_CULL_FACE);
+			GL::Disable(GL_CULL_FACE);
 		}
 	}
 	else if (lua_isnumber(L, 1)) {
-		glEnable(GL_CULL_FACE);
+		GL::Enable(GL_CULL_FACE);
 		glCullFace((GLenum)lua_tonumber(L, 1));
 	}
 	else {
@@ -2594,13 +2614,13 @@ int LuaOpenGL::LogicOp(lua_State* L)
 
 	if (lua_isboolean(L, 1)) {
 		if (lua_toboolean(L, 1)) {
-			glEnable(GL_COLOR_LOGIC_OP);
+			GL::Enable(GL_COLOR_LOGIC_OP);
 		} else {
-			glDisable(GL_COLOR_LOGIC_OP);
+			GL::Disable(GL_COLOR_LOGIC_OP);
 		}
 	}
 	else if (lua_isnumber(L, 1)) {
-		glEnable(GL_COLOR_LOGIC_OP);
+		GL::Enable(GL_COLOR_LOGIC_OP);
 		glLogicOp((GLenum)lua_tonumber(L, 1));
 	}
 	else {
@@ -2615,9 +2635,9 @@ int LuaOpenGL::Fog(lua_State* L)
 	CheckDrawingEnabled(L, __FUNCTION__);
 
 	if (luaL_checkboolean(L, 1)) {
-		glEnable(GL_FOG);
+		GL::Enable(GL_FOG);
 	} else {
-		glDisable(GL_FOG);
+		GL::Disable(GL_FOG);
 	}
 	return 0;
 }
@@ -2631,37 +2651,37 @@ int LuaOpenGL::Blending(lua_State* L)
 	if (args == 1) {
 		if (lua_isboolean(L, 1)) {
 			if (lua_toboolean(L, 1)) {
-				glEnable(GL_BLEND);
+				GL::Enable(GL_BLEND);
 			} else {
-				glDisable(GL_BLEND);
+				GL::Disable(GL_BLEND);
 			}
 		}
 		else if (lua_israwstring(L, 1)) {
 			const string mode = lua_tostring(L, 1);
 			if (mode == "add") {
-				glBlendFunc(GL_ONE, GL_ONE);
-				glEnable(GL_BLEND);
+				GL::BlendFunc(GL_ONE, GL_ONE);
+				GL::Enable(GL_BLEND);
 			}
 			else if (mode == "alpha_add") {
-				glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-				glEnable(GL_BLEND);
+				GL::BlendFunc(GL_SRC_ALPHA, GL_ONE);
+				GL::Enable(GL_BLEND);
 			}
 			else if ((mode == "alpha") ||
 			         (mode == "reset")) {
-				glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-				glEnable(GL_BLEND);
+				GL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+				GL::Enable(GL_BLEND);
 			}
 			else if (mode == "color") {
-				glBlendFunc(GL_SRC_COLOR, GL_ONE_MINUS_SRC_COLOR);
-				glEnable(GL_BLEND);
+				GL::BlendFunc(GL_SRC_COLOR, GL_ONE_MINUS_SRC_COLOR);
+				GL::Enable(GL_BLEND);
 			}
 			else if (mode == "modulate") {
-				glBlendFunc(GL_DST_COLOR, GL_ZERO);
-				glEnable(GL_BLEND);
+				GL::BlendFunc(GL_DST_COLOR, GL_ZERO);
+				GL::Enable(GL_BLEND);
 			}
 			else if (mode == "disable") {
-				glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-				glDisable(GL_BLEND);
+				GL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+				GL::Disable(GL_BLEND);
 			}
 		}
 		else {
@@ -2671,8 +2691,8 @@ int LuaOpenGL::Blending(lua_State* L)
 	else if (args == 2) {
 		const GLenum src = (GLenum)luaL_checkint(L, 1);
 		const GLenum dst = (GLenum)luaL_checkint(L, 2);
-		glBlendFunc(src, dst);
-		glEnable(GL_BLEND);
+		GL::BlendFunc(src, dst);
+		GL::Enable(GL_BLEND);
 	}
 	else {
 		luaL_error(L, "Incorrect arguments to gl.Blending()");
@@ -2695,7 +2715,7 @@ int LuaOpenGL::BlendFunc(lua_State* L)
 	CheckDrawingEnabled(L, __FUNCTION__);
 	const GLenum src = (GLenum)luaL_checkint(L, 1);
 	const GLenum dst = (GLenum)luaL_checkint(L, 2);
-	glBlendFunc(src, dst);
+	GL::BlendFunc(src, dst);
 	return 0;
 }
 
@@ -2717,7 +2737,7 @@ int LuaOpenGL::BlendFuncSeparate(lua_State* L)
 	const GLenum dstRGB   = (GLenum)luaL_checkint(L, 2);
 	const GLenum srcAlpha = (GLenum)luaL_checkint(L, 3);
 	const GLenum dstAlpha = (GLenum)luaL_checkint(L, 4);
-	glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+	GL::BlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
 	return 0;
 }
 
@@ -2730,14 +2750,14 @@ int LuaOpenGL::AlphaTest(lua_State* L)
 	const int args = lua_gettop(L); // number of arguments
 	if (args == 1) {
 		if (luaL_checkboolean(L, 1)) {
-			glEnable(GL_ALPHA_TEST);
+			GL::Enable(GL_ALPHA_TEST);
 		} else {
-			glDisable(GL_ALPHA_TEST);
+			GL::Disable(GL_ALPHA_TEST);
 		}
 	}
 	else if (args == 2) {
-		glEnable(GL_ALPHA_TEST);
-		glAlphaFunc((GLenum)luaL_checkint(L, 1), (GLfloat)luaL_checkint(L, 2));
+		GL::Enable(GL_ALPHA_TEST);
+		GL::AlphaFunc((GLenum)luaL_checkint(L, 1), (GLfloat)luaL_checkint(L, 2));
 	}
 	else {
 		luaL_error(L, "Incorrect arguments to gl.AlphaTest()");
@@ -3910,6 +3930,7 @@ int LuaOpenGL::PopAttrib(lua_State* L)
 {
 	CheckDrawingEnabled(L, __FUNCTION__);
 	glPopAttrib();
+	GL::InvalidateStateCache();
 	return 0;
 }
 
@@ -3928,9 +3949,9 @@ int LuaOpenGL::UnsafeState(lua_State* L)
 		luaL_error(L, "expecting a function");
 	}
 
-	reverse ? glDisable(state) : glEnable(state);
+	reverse ? GL::Disable(state) : GL::Enable(state);
 	const int error = lua_pcall(L, lua_gettop(L) - funcLoc, 0, 0);
-	reverse ? glEnable(state) : glDisable(state);
+	reverse ? GL::Enable(state) : GL::Disable(state);
 
 	if (error != 0) {
 		LOG_L(L_ERROR, "gl.UnsafeState: error(%i) = %s",
@@ -3962,13 +3983,17 @@ int LuaOpenGL::CreateList(lua_State* L)
 	const bool origDrawingEnabled = IsDrawingEnabled(L);
 	SetDrawingEnabled(L, true);
 
-	// build the list with the specified lua call/args
+	// build the list with the specified lua call/args; state calls are
+	// compiled rather than executed here, so they must pass through the
+	// state-cache unfiltered (and without updating its shadow copies)
+	GL::EnableStateCache(false);
 	glNewList(list, GL_COMPILE);
 	SMatrixStateData prevMSD = GetLuaContextData(L)->glMatrixTracker.PushMatrixState(true);
 	const int error = lua_pcall(L, (args - 1), 0, 0);
 	SMatrixStateData matData = GetLuaContextData(L)->glMatrixTracker.GetMatrixState();
 	GetLuaContextData(L)->glMatrixTracker.PopMatrixState(prevMSD, false);
 	glEndList();
+	GL::EnableStateCache(true);
 
 	if (error != 0) {
 		glDeleteLists(list, 1);
@@ -4000,6 +4025,7 @@ int LuaOpenGL::CallList(lua_State* L)
 		int error = GetLuaContextData(L)->glMatrixTracker.ApplyMatrixState(matrixStateData);
 		if (error == 0) {
 			glCallList(dlist);
+			GL::InvalidateStateCache();
 			return 0;
 		}
 		luaL_error(L, "Matrix stack %sflow in gl.CallList", (error > 0) ? "over" : "under");
@@ -24,6 +24,7 @@
 #include "System/ContainerUtil.h"
 #include "System/ScopedFPUSettings.h"
 #include "System/StringUtil.h"
+#include "System/Threading/ThreadPool.h"
 
 
 LuaParser* GetLuaParser(lua_State* L) {
@@ -156,6 +157,7 @@ void LuaParser::SetupEnv(bool synced)
 	AddFunc("Include",    Include);
 	AddFunc("LoadFile",   LoadFile);
 	AddFunc("FileExists", FileExists);
+	AddFunc("ParseFiles", ParseFiles);
 	EndTable();
 
 	GetTable("LOG");
@@ -637,6 +639,156 @@ int LuaParser::FileExists(lua_State* L)
 }
 
 
+// executes one def-file chunk in a private lua_State and serializes its
+// return table; runs on a ThreadPool worker so it must not touch the
+// VFS or any other shared engine state
+static bool ParseFileChunk(
+	const string& filename,
+	const string& code,
+	bool lowerKeys,
+	LuaUtils::DataMarshalBuffer& buf,
+	string& error
+) {
+	luaContextData lcd(false);
+	lcd.synced = true;
+
+	lua_State* L = LUA_OPEN(&lcd);
+
+	if (L == nullptr) {
+		error = "could not initialize LUA library";
+		return false;
+	}
+
+	LUA_OPEN_LIB(L, luaopen_base);
+	LUA_OPEN_LIB(L, luaopen_math);
+	LUA_OPEN_LIB(L, luaopen_table);
+	LUA_OPEN_LIB(L, luaopen_string);
+
+	// delete some dangerous/unsynced functions; cf SetupEnv
+	lua_pushnil(L); lua_setglobal(L, "dofile");
+	lua_pushnil(L); lua_setglobal(L, "loadfile");
+	lua_pushnil(L); lua_setglobal(L, "loadlib");
+	lua_pushnil(L); lua_setglobal(L, "require");
+	lua_pushnil(L); lua_setglobal(L, "gcinfo");
+	lua_pushnil(L); lua_setglobal(L, "collectgarbage");
+	lua_pushnil(L); lua_setglobal(L, "newproxy");
+
+	bool parsed = false;
+
+	do {
+		if (luaL_loadbuffer(L, code.c_str(), code.size(), filename.c_str()) != 0) {
+			error = lua_tostring(L, -1);
+			break;
+		}
+
+		// do not signal floating point exceptions in user Lua code
+		ScopedDisableFpuExceptions fe;
+
+		if (lua_pcall(L, 0, 1, 0) != 0) {
+			error = lua_tostring(L, -1);
+			break;
+		}
+
+		if (!lua_istable(L, 1)) {
+			error = "missing return table";
+			break;
+		}
+
+		if (lowerKeys)
+			LuaUtils::LowerKeys(L, 1);
+
+		LuaUtils::CheckTableForNaNs(L, 1, filename);
+
+		// detached copy, the state dies before deserialization
+		LuaUtils::SerializeData(L, 1, buf, true);
+		parsed = true;
+	} while (false);
+
+	LUA_CLOSE(&L);
+	return parsed;
+}
+
+
+/**
+ * Parses a batch of independent Lua files on the ThreadPool, i.e. a
+ * parallel bulk VFS.Include; the files are read through the VFS up
+ * front, each chunk then executes in its own sandboxed lua_State (no
+ * call-outs, no shared globals) and only its return table survives.
+ * Returns {fileName = table, ...}, {fileName = errorMessage, ...}
+ */
+int LuaParser::ParseFiles(lua_State* L)
+{
+	const LuaParser* currentParser = GetLuaParser(L);
+
+	if (!lua_istable(L, 1))
+		luaL_error(L, "Incorrect arguments to VFS.ParseFiles({fileNames})");
+
+	const std::string& modes = CFileHandler::AllowModes(luaL_optstring(L, 2, currentParser->accessModes.c_str()), currentParser->accessModes);
+
+	std::vector<string> fileNames;
+
+	for (int i = 1; lua_rawgeti(L, 1, i), !lua_isnil(L, -1); lua_pop(L, 1), i++) {
+		if (lua_israwstring(L, -1)) {
+			fileNames.push_back(lua_tostring(L, -1));
+		}
+	}
+
+	lua_pop(L, 1);
+
+	std::vector<string> fileData(fileNames.size());
+	std::vector<string> errors(fileNames.size());
+
+	// read the file contents up front, the VFS has to stay on the
+	// calling thread
+	for (size_t i = 0; i < fileNames.size(); i++) {
+		if (!LuaIO::IsSimplePath(fileNames[i])) {
+			errors[i] = "bad pathname";
+			continue;
+		}
+
+		CFileHandler fh(fileNames[i], modes);
+
+		if (!fh.FileExists()) {
+			errors[i] = "missing file";
+			continue;
+		}
+		if (!fh.LoadStringData(fileData[i])) {
+			errors[i] = "could not load data";
+		}
+	}
+
+	std::vector<LuaUtils::DataMarshalBuffer> bufs(fileNames.size());
+	std::vector<char> parsed(fileNames.size(), 0);
+
+	const bool lowerKeys = currentParser->lowerKeys;
+
+	for_mt(0, (int)fileNames.size(), [&](const int i) {
+		if (!errors[i].empty())
+			return;
+
+		parsed[i] = ParseFileChunk(fileNames[i], fileData[i], lowerKeys, bufs[i], errors[i]);
+	});
+
+	lua_checkstack(L, 4);
+	lua_newtable(L); // parsed tables
+	lua_newtable(L); // error messages
+
+	for (size_t i = 0; i < fileNames.size(); i++) {
+		if (parsed[i]) {
+			lua_pushsstring(L, fileNames[i]);
+			LuaUtils::DeserializeData(L, bufs[i]);
+			lua_rawset(L, -4);
+		} else {
+			lua_pushsstring(L, fileNames[i]);
+			lua_pushsstring(L, errors[i]);
+			lua_rawset(L, -3);
+		}
+	}
+
+	return 2;
+}
+
+
 int LuaParser::DontMessWithMyCase(lua_State* L)
 {
 	LuaParser* currentParser = GetLuaParser(L);
@@ -202,6 +202,7 @@ private:
 	static int Include(lua_State* L);
 	static int LoadFile(lua_State* L);
 	static int FileExists(lua_State* L);
+	static int ParseFiles(lua_State* L);
 };
 
 
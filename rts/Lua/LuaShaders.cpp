@@ -11,6 +11,7 @@
 #include "LuaUtils.h"
 
 #include "Game/Camera.h"
+#include "Rendering/GL/GlobalUniforms.h"
 #include "System/Log/ILog.h"
 #include "System/StringUtil.h"
 
@@ -573,6 +574,9 @@ int LuaShaders::CreateShader(lua_State* L)
 		return 0;
 	}
 
+	// attach the shared per-frame uniform block (if declared)
+	CGlobalUniforms::BindUniformBlock(prog);
+
 	// note: index, not raw ID
 	lua_pushnumber(L, shaders.AddProgram(p));
 	return 1;
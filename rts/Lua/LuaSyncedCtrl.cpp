@@ -37,6 +37,7 @@
 #include "Sim/Misc/CollisionVolume.h"
 #include "Sim/Misc/DamageArray.h"
 #include "Sim/Misc/DamageArrayHandler.h"
+#include "Sim/Misc/GroundBlockingObjectMap.h"
 #include "Sim/Misc/LosHandler.h"
 #include "Sim/Misc/ModInfo.h"
 #include "Sim/Misc/SmoothHeightMesh.h"
@@ -156,6 +157,7 @@ bool LuaSyncedCtrl::PushEntries(lua_State* L)
 	REGISTER_LUA_CFUNC(SetFeatureRulesParam);
 
 	REGISTER_LUA_CFUNC(CreateUnit);
+	REGISTER_LUA_CFUNC(CreateUnits);
 	REGISTER_LUA_CFUNC(DestroyUnit);
 	REGISTER_LUA_CFUNC(TransferUnit);
 
@@ -512,6 +514,11 @@ static int SetSolidObjectBlocking(lua_State* L, CSolidObject* o)
 	o->blockEnemyPushing = luaL_optboolean(L, 7, o->blockEnemyPushing);
 	o->blockHeightChanges = luaL_optboolean(L, 8, o->blockHeightChanges);
 
+	// crushability and solid-collidability feed the cached per-MoveDef
+	// structure bits; re-derive them if the object is still on the map
+	if (o->immobile && o->IsBlocking())
+		groundBlockingObjectMap->UpdateStructureBlockBits(o);
+
 	lua_pushboolean(L, o->IsBlocking());
 	return 1;
 }
@@ -1267,6 +1274,137 @@ int LuaSyncedCtrl::CreateUnit(lua_State* L)
 }
 
 
+// Spring.CreateUnits({{name = "..." | defID = n, pos = {x, y, z}
+//   [, facing = f][, team = t][, beingBuilt = b][, flattenGround = b]
+//   [, unitID = n]}, ...}) -> {unitID, ...}
+//
+// batch variant of CreateUnit for mass spawns (scenario setups); one
+// call replaces N Lua->engine transitions and spawns the whole set via
+// CUnitLoader::LoadUnits, entries over a unit limit are skipped
+int LuaSyncedCtrl::CreateUnits(lua_State* L)
+{
+	CheckAllowGameChanges(L);
+
+	if (inCreateUnit) {
+		luaL_error(L, "[%s()]: recursion is not permitted", __func__);
+		return 0;
+	}
+
+	if (!lua_istable(L, 1)) {
+		luaL_error(L, "[%s()] argument 1 must be an array of unit-spec tables", __func__);
+		return 0;
+	}
+
+	const int ctrlTeam = CtrlTeam(L);
+	const bool fullCtrl = FullCtrl(L);
+
+	std::vector<UnitLoadParams> batchParams;
+	std::vector<CUnit*> batchUnits;
+
+	batchParams.reserve(lua_objlen(L, 1));
+
+	for (int i = 1, n = lua_objlen(L, 1); i <= n; i++) {
+		lua_rawgeti(L, 1, i);
+
+		if (!lua_istable(L, -1)) {
+			luaL_error(L, "[%s()] entry %d is not a table", __func__, i);
+			return 0;
+		}
+
+		const int tblIdx = lua_gettop(L);
+
+		UnitLoadParams params;
+		params.unitDef = nullptr;
+		params.builder = nullptr;
+		params.pos     = ZeroVector;
+		params.speed   = ZeroVector;
+		params.unitID  = -1;
+		params.teamID  = ctrlTeam;
+		params.facing  = FACING_SOUTH;
+		params.beingBuilt = false;
+		params.flattenGround = true;
+
+		for (lua_pushnil(L); lua_next(L, tblIdx) != 0; lua_pop(L, 1)) {
+			if (!lua_israwstring(L, -2))
+				continue;
+
+			const std::string& key = lua_tostring(L, -2);
+
+			if (key == "name") {
+				params.unitDef = unitDefHandler->GetUnitDefByName(lua_tostring(L, -1));
+				continue;
+			}
+			if (key == "defID") {
+				params.unitDef = unitDefHandler->GetUnitDefByID(lua_toint(L, -1));
+				continue;
+			}
+			if (key == "pos") {
+				float array[3] = {0.0f, 0.0f, 0.0f};
+
+				// CUnit::PreInit will clamp the position
+				if (LuaUtils::ParseFloatArray(L, -1, array, 3) == 3)
+					params.pos = array;
+
+				continue;
+			}
+			if (key == "facing") {
+				params.facing = LuaUtils::ParseFacing(L, __func__, lua_gettop(L));
+				continue;
+			}
+			if (key == "team") {
+				params.teamID = lua_toint(L, -1);
+				continue;
+			}
+			if (key == "beingBuilt") {
+				params.beingBuilt = lua_toboolean(L, -1);
+				continue;
+			}
+			if (key == "flattenGround") {
+				params.flattenGround = lua_toboolean(L, -1);
+				continue;
+			}
+			if (key == "unitID") {
+				params.unitID = lua_toint(L, -1);
+				continue;
+			}
+		}
+
+		lua_pop(L, 1); // entry table
+
+		if (params.unitDef == nullptr) {
+			luaL_error(L, "[%s()]: entry %d has no valid unitDef name or ID", __func__, i);
+			return 0;
+		}
+		if (!teamHandler->IsValidTeam(params.teamID)) {
+			luaL_error(L, "[%s()]: entry %d has an invalid team number (%d)", __func__, i, params.teamID);
+			return 0;
+		}
+		if (!fullCtrl && (ctrlTeam != params.teamID)) {
+			luaL_error(L, "[%s()]: entry %d targets a non-controllable team (%d)", __func__, i, params.teamID);
+			return 0;
+		}
+
+		ASSERT_SYNCED(params.pos);
+		ASSERT_SYNCED(params.facing);
+
+		batchParams.push_back(params);
+	}
+
+	inCreateUnit = true;
+	unitLoader->LoadUnits(batchParams, batchUnits);
+	inCreateUnit = false;
+
+	lua_createtable(L, batchUnits.size(), 0);
+
+	for (size_t i = 0; i < batchUnits.size(); i++) {
+		lua_pushnumber(L, batchUnits[i]->id);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
+
 int LuaSyncedCtrl::DestroyUnit(lua_State* L)
 {
 	CheckAllowGameChanges(L); // FIXME -- recursion protection
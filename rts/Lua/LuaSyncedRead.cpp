@@ -70,6 +70,7 @@
 #include "System/FileSystem/FileSystem.h"
 #include "System/StringUtil.h"
 
+#include <deque>
 #include <map>
 #include <cctype>
 
@@ -680,6 +681,79 @@ static inline CUnit* ParseTypedUnit(lua_State* L, const char* caller, int index)
 }
 
 
+// frame-scoped memo for the hottest per-unit read calls; the fields
+// are snapshotted once per sim frame on first access so repeated
+// same-frame reads (40 widgets asking about the same units) do not
+// touch CUnit again; restricted to unsynced handles reading allied
+// units, synced code can mutate units mid-frame and spoofable fields
+// (decoys, hidden damage, position errors) only exist for non-allies
+struct UnitReadMemo {
+	int epoch = -1;    // gs->frameNum the snapshot was taken in
+	int allyTeam = -3; // readAllyTeam the snapshot is valid for
+	int defID = 0;
+	float health = 0.0f;
+	float maxHealth = 0.0f;
+	float paralyzeDamage = 0.0f;
+	float captureProgress = 0.0f;
+	float buildProgress = 0.0f;
+	float3 pos;
+	float3 midPos;
+	float3 aimPos;
+};
+
+static std::vector<UnitReadMemo> unitReadMemos;
+
+
+static inline const UnitReadMemo* GetUnitReadMemo(lua_State* L, int index)
+{
+	if (CLuaHandle::GetHandleSynced(L))
+		return nullptr;
+	if (!lua_isnumber(L, index))
+		return nullptr;
+
+	const unsigned int unitID = lua_toint(L, index);
+
+	if (unitID >= unitReadMemos.size())
+		return nullptr;
+
+	const UnitReadMemo& memo = unitReadMemos[unitID];
+
+	// a hit implies the snapshotting access already passed the
+	// allied-visibility check for this readAllyTeam
+	if (memo.epoch != gs->frameNum)
+		return nullptr;
+	if (memo.allyTeam != CLuaHandle::GetHandleReadAllyTeam(L))
+		return nullptr;
+
+	return &memo;
+}
+
+static inline void FillUnitReadMemo(lua_State* L, const CUnit* unit)
+{
+	if (CLuaHandle::GetHandleSynced(L))
+		return;
+	if (!IsAllyUnit(L, unit))
+		return;
+
+	if (unitReadMemos.size() < unitHandler->MaxUnits())
+		unitReadMemos.resize(unitHandler->MaxUnits());
+
+	UnitReadMemo& memo = unitReadMemos[unit->id];
+
+	memo.epoch = gs->frameNum;
+	memo.allyTeam = CLuaHandle::GetHandleReadAllyTeam(L);
+	memo.defID = unit->unitDef->id;
+	memo.health = unit->health;
+	memo.maxHealth = unit->maxHealth;
+	memo.paralyzeDamage = unit->paralyzeDamage;
+	memo.captureProgress = unit->captureProgress;
+	memo.buildProgress = unit->buildProgress;
+	memo.pos = unit->pos;
+	memo.midPos = unit->midPos;
+	memo.aimPos = unit->aimPos;
+}
+
+
 static CFeature* ParseFeature(lua_State* L, const char* caller, int index)
 {
 	if (!lua_isnumber(L, index)) {
@@ -1312,13 +1386,11 @@ int LuaSyncedRead::GetTeamStatsHistory(lua_State* L)
 	const int args = lua_gettop(L);
 
 	if (args == 1) {
-		lua_pushnumber(L, team->statHistory.size());
+		lua_pushnumber(L, team->GetNumStatsEntries());
 		return 1;
 	}
 
-	const auto& teamStats = team->statHistory;
-	auto it = teamStats.cbegin();
-	const int statCount = teamStats.size();
+	const int statCount = team->GetNumStatsEntries();
 
 	int start = 0;
 	if ((args >= 2) && lua_isnumber(L, 2)) {
@@ -1332,15 +1404,17 @@ int LuaSyncedRead::GetTeamStatsHistory(lua_State* L)
 		end = max(0, min(statCount - 1, end));
 	}
 
-	std::advance(it, start);
+	// entries older than the ring window have been compressed away
+	// (they are still written to the demo); serve what is available
+	start = max(start, team->GetFirstStatsEntry());
 
 	lua_newtable(L);
 	if (statCount > 0) {
 		int count = 1;
-		for (int i = start; i <= end; ++i, ++it) {
-			const TeamStatistics& stats = *it;
+		for (int i = start; i <= end; ++i) {
+			const TeamStatistics& stats = team->GetStatsEntry(i);
 			lua_newtable(L); {
-				if (i+1 == teamStats.size()) {
+				if (i + 1 == statCount) {
 					// the `stats.frame` var indicates the frame when a new entry needs to get added,
 					// for the most recent stats entry this lies obviously in the future,
 					// so we just output the current frame here
@@ -1573,26 +1647,137 @@ int LuaSyncedRead::ArePlayersAllied(lua_State* L)
 //  Grouped Unit Queries
 //
 
+// Optional zero-allocation output modes for the bulk unit queries:
+// passing a table in the first unused argument slot fills it (and
+// truncates leftovers from a previous use) in place, passing a
+// function invokes it once per unit ID without materializing any
+// result table; both return the ID count instead of a new table.
+enum UnitQueryOutputMode {
+	UNIT_QUERY_NEW_TABLE  = 0,
+	UNIT_QUERY_FILL_TABLE = 1,
+	UNIT_QUERY_CALLBACK   = 2,
+};
+
+static UnitQueryOutputMode ParseUnitQueryOutput(lua_State* L, int& argIdx)
+{
+	// the output argument may also take the place of an
+	// omitted (optional, numeric) allegiance argument
+	if (!lua_istable(L, argIdx) && !lua_isfunction(L, argIdx))
+		argIdx += 1;
+
+	if (lua_istable(L, argIdx))
+		return UNIT_QUERY_FILL_TABLE;
+	if (lua_isfunction(L, argIdx))
+		return UNIT_QUERY_CALLBACK;
+
+	return UNIT_QUERY_NEW_TABLE;
+}
+
+static inline void BeginUnitQueryOutput(lua_State* L, UnitQueryOutputMode mode, int argIdx, int sizeHint)
+{
+	switch (mode) {
+		case UNIT_QUERY_NEW_TABLE : { lua_createtable(L, sizeHint, 0); } break;
+		case UNIT_QUERY_FILL_TABLE: { lua_pushvalue(L, argIdx);        } break;
+		case UNIT_QUERY_CALLBACK  : {                                  } break;
+	}
+}
+
+static inline void PushUnitQueryResult(lua_State* L, UnitQueryOutputMode mode, int argIdx, int unitID, unsigned int count)
+{
+	if (mode == UNIT_QUERY_CALLBACK) {
+		lua_pushvalue(L, argIdx);
+		lua_pushnumber(L, unitID);
+		lua_call(L, 1, 0);
+		return;
+	}
+
+	lua_pushnumber(L, unitID);
+	lua_rawseti(L, -2, count);
+}
+
+static void EndUnitQueryOutput(lua_State* L, UnitQueryOutputMode mode, unsigned int count)
+{
+	// always leaves exactly one return value on the stack
+	if (mode == UNIT_QUERY_NEW_TABLE)
+		return;
+
+	if (mode == UNIT_QUERY_FILL_TABLE) {
+		// nil out entries surviving from a previous (larger) result
+		for (size_t i = lua_objlen(L, -1); i > count; i--) {
+			lua_pushnil(L);
+			lua_rawseti(L, -2, i);
+		}
+
+		lua_pop(L, 1);
+	}
+
+	lua_pushnumber(L, count);
+}
+
+
+// scratch buffers for the bulk unit queries, indexed by re-entrancy
+// depth: a callback-mode query can issue another query from inside
+// its callback, and neither may clobber the snapshot or QuadField
+// temps the other is iterating; steady-state calls never allocate
+struct UnitQueryBuffer {
+	std::vector<int> quads;
+	std::vector<CUnit*> units;
+};
+
+static std::deque<UnitQueryBuffer> unitQueryBuffers;
+static unsigned int unitQueryDepth = 0;
+
+struct ScopedUnitQueryBuffer {
+	ScopedUnitQueryBuffer() {
+		if (unitQueryDepth >= unitQueryBuffers.size())
+			unitQueryBuffers.emplace_back();
+
+		bufIdx = unitQueryDepth++;
+	}
+	~ScopedUnitQueryBuffer() { unitQueryDepth -= 1; }
+
+	UnitQueryBuffer& Get() const { return unitQueryBuffers[bufIdx]; }
+
+	unsigned int bufIdx;
+};
+
+
 int LuaSyncedRead::GetAllUnits(lua_State* L)
 {
-	lua_createtable(L, (unitHandler->GetActiveUnits()).size(), 0);
+	int outArgIdx = 1;
+	const UnitQueryOutputMode outMode = ParseUnitQueryOutput(L, outArgIdx);
+
+	unsigned int count = 0;
+
+	// snapshot the live set before pushing anything; a callback can
+	// create units, which inserts into activeUnits mid-iteration and
+	// would invalidate a live iterator
+	ScopedUnitQueryBuffer qb;
+	std::vector<CUnit*>& units = qb.Get().units;
+
+	units.clear();
+	units.reserve((unitHandler->GetActiveUnits()).size());
+
+	for (CUnit* unit: unitHandler->GetActiveUnits()) {
+		units.push_back(unit);
+	}
+
+	BeginUnitQueryOutput(L, outMode, outArgIdx, units.size());
 
-	int count = 1;
 	if (CLuaHandle::GetHandleFullRead(L)) {
-		for (const CUnit* unit: unitHandler->GetActiveUnits()) {
-			lua_pushnumber(L, unit->id);
-			lua_rawseti(L, -2, count++);
+		for (const CUnit* unit: units) {
+			PushUnitQueryResult(L, outMode, outArgIdx, unit->id, ++count);
 		}
 	} else {
-		for (const CUnit* unit: unitHandler->GetActiveUnits()) {
+		for (const CUnit* unit: units) {
 			if (!IsUnitVisible(L, unit))
 				continue;
 
-			lua_pushnumber(L, unit->id);
-			lua_rawseti(L, -2, count++);
+			PushUnitQueryResult(L, outMode, outArgIdx, unit->id, ++count);
 		}
 	}
 
+	EndUnitQueryOutput(L, outMode, count);
 	return 1;
 }
 
@@ -2001,14 +2186,14 @@ int LuaSyncedRead::GetTeamUnitCount(lua_State* L)
 //
 
 // Macro Requirements:
-//   L, units
+//   L, units, outMode, outArgIdx
 
 #define LOOP_UNIT_CONTAINER(ALLEGIANCE_TEST, CUSTOM_TEST, NEWTABLE) \
 	{                                                               \
 		unsigned int count = 0;                                     \
                                                                     \
 		if (NEWTABLE) {                                             \
-			lua_createtable(L, units.size(), 0);                    \
+			BeginUnitQueryOutput(L, outMode, outArgIdx, units.size()); \
 		}                                                           \
                                                                     \
 		for (auto it = units.cbegin(); it != units.cend(); ++it) {  \
@@ -2017,8 +2202,16 @@ int LuaSyncedRead::GetTeamUnitCount(lua_State* L)
 			ALLEGIANCE_TEST;                                        \
 			CUSTOM_TEST;                                            \
                                                                     \
-			lua_pushnumber(L, unit->id);                            \
-			lua_rawseti(L, -2, ++count);                            \
+			if (NEWTABLE) {                                         \
+				PushUnitQueryResult(L, outMode, outArgIdx, unit->id, ++count); \
+			} else {                                                \
+				lua_pushnumber(L, unit->id);                        \
+				lua_rawseti(L, -2, ++count);                        \
+			}                                                       \
+		}                                                           \
+                                                                    \
+		if (NEWTABLE) {                                             \
+			EndUnitQueryOutput(L, outMode, count);                  \
 		}                                                           \
 	}
 
@@ -2081,9 +2274,14 @@ int LuaSyncedRead::GetUnitsInRectangle(lua_State* L)
 
 	const int allegiance = ParseAllegiance(L, __func__, 5);
 
+	int outArgIdx = 5;
+	const UnitQueryOutputMode outMode = ParseUnitQueryOutput(L, outArgIdx);
+
 #define RECTANGLE_TEST ; // no test, GetUnitsExact is sufficient
 
-	const vector<CUnit*>& units = quadField->GetUnitsExact(mins, maxs);
+	ScopedUnitQueryBuffer qb;
+	quadField->GetUnitsExact(mins, maxs, qb.Get().quads, qb.Get().units);
+	const vector<CUnit*>& units = qb.Get().units;
 
 	if (allegiance >= 0) {
 		if (IsAlliedTeam(L, allegiance)) {
@@ -2124,13 +2322,18 @@ int LuaSyncedRead::GetUnitsInBox(lua_State* L)
 
 	const int allegiance = ParseAllegiance(L, __func__, 7);
 
+	int outArgIdx = 7;
+	const UnitQueryOutputMode outMode = ParseUnitQueryOutput(L, outArgIdx);
+
 #define BOX_TEST                  \
 	const float y = unit->midPos.y; \
 	if ((y < ymin) || (y > ymax)) { \
 		continue;                     \
 	}
 
-	const vector<CUnit*>& units = quadField->GetUnitsExact(mins, maxs);
+	ScopedUnitQueryBuffer qb;
+	quadField->GetUnitsExact(mins, maxs, qb.Get().quads, qb.Get().units);
+	const vector<CUnit*>& units = qb.Get().units;
 
 	if (allegiance >= 0) {
 		if (IsAlliedTeam(L, allegiance)) {
@@ -2169,6 +2372,9 @@ int LuaSyncedRead::GetUnitsInCylinder(lua_State* L)
 
 	const int allegiance = ParseAllegiance(L, __func__, 4);
 
+	int outArgIdx = 4;
+	const UnitQueryOutputMode outMode = ParseUnitQueryOutput(L, outArgIdx);
+
 #define CYLINDER_TEST                         \
 	const float3& p = unit->midPos;             \
 	const float dx = (p.x - x);                 \
@@ -2178,7 +2384,9 @@ int LuaSyncedRead::GetUnitsInCylinder(lua_State* L)
 		continue;                                 \
 	}                                           \
 
-	const vector<CUnit*>& units = quadField->GetUnitsExact(mins, maxs);
+	ScopedUnitQueryBuffer qb;
+	quadField->GetUnitsExact(mins, maxs, qb.Get().quads, qb.Get().units);
+	const vector<CUnit*>& units = qb.Get().units;
 
 	if (allegiance >= 0) {
 		if (IsAlliedTeam(L, allegiance)) {
@@ -2219,6 +2427,9 @@ int LuaSyncedRead::GetUnitsInSphere(lua_State* L)
 
 	const int allegiance = ParseAllegiance(L, __func__, 5);
 
+	int outArgIdx = 5;
+	const UnitQueryOutputMode outMode = ParseUnitQueryOutput(L, outArgIdx);
+
 #define SPHERE_TEST                           \
 	const float3& p = unit->midPos;             \
 	const float dx = (p.x - x);                 \
@@ -2230,7 +2441,9 @@ int LuaSyncedRead::GetUnitsInSphere(lua_State* L)
 		continue;                                 \
 	}                                           \
 
-	const vector<CUnit*>& units = quadField->GetUnitsExact(mins, maxs);
+	ScopedUnitQueryBuffer qb;
+	quadField->GetUnitsExact(mins, maxs, qb.Get().quads, qb.Get().units);
+	const vector<CUnit*>& units = qb.Get().units;
 
 	if (allegiance >= 0) {
 		if (IsAlliedTeam(L, allegiance)) {
@@ -2320,6 +2533,13 @@ int LuaSyncedRead::GetUnitsInPlanes(lua_State* L)
 
 	const int readTeam = CLuaHandle::GetHandleReadTeam(L);
 
+	// combines multiple team lists into one table, the
+	// reuse/callback output modes do not apply in here
+	constexpr UnitQueryOutputMode outMode = UNIT_QUERY_NEW_TABLE;
+	constexpr int outArgIdx = 0;
+	(void) outMode;
+	(void) outArgIdx;
+
 	lua_newtable(L);
 
 	for (int team = startTeam; team <= endTeam; team++) {
@@ -2737,10 +2957,19 @@ int LuaSyncedRead::GetUnitTooltip(lua_State* L)
 
 int LuaSyncedRead::GetUnitDefID(lua_State* L)
 {
+	const UnitReadMemo* memo = GetUnitReadMemo(L, 1);
+
+	if (memo != nullptr) {
+		lua_pushnumber(L, memo->defID);
+		return 1;
+	}
+
 	CUnit* unit = ParseUnit(L, __func__, 1);
 	if (unit == nullptr)
 		return 0;
 
+	FillUnitReadMemo(L, unit);
+
 	if (IsAllyUnit(L, unit)) {
 		lua_pushnumber(L, unit->unitDef->id);
 	} else {
@@ -2788,10 +3017,24 @@ int LuaSyncedRead::GetUnitNeutral(lua_State* L)
 
 int LuaSyncedRead::GetUnitHealth(lua_State* L)
 {
+	const UnitReadMemo* memo = GetUnitReadMemo(L, 1);
+
+	if (memo != nullptr) {
+		// a memoized unit is allied, i.e. never hides its damage
+		lua_pushnumber(L, memo->health);
+		lua_pushnumber(L, memo->maxHealth);
+		lua_pushnumber(L, memo->paralyzeDamage);
+		lua_pushnumber(L, memo->captureProgress);
+		lua_pushnumber(L, memo->buildProgress);
+		return 5;
+	}
+
 	CUnit* unit = ParseInLosUnit(L, __func__, 1);
 	if (unit == nullptr)
 		return 0;
 
+	FillUnitReadMemo(L, unit);
+
 	const UnitDef* ud = unit->unitDef;
 	const bool enemyUnit = IsEnemyUnit(L, unit);
 
@@ -2907,7 +3150,37 @@ int LuaSyncedRead::GetUnitMass(lua_State* L)
 
 int LuaSyncedRead::GetUnitPosition(lua_State* L)
 {
-	return (GetSolidObjectPosition(L, ParseUnit(L, __func__, 1), false));
+	const UnitReadMemo* memo = GetUnitReadMemo(L, 1);
+
+	if (memo != nullptr) {
+		// a memoized unit is allied, i.e. has no position error
+		const bool returnMidPos = luaL_optboolean(L, 2, false);
+		const bool returnAimPos = luaL_optboolean(L, 3, false);
+
+		lua_pushnumber(L, memo->pos.x);
+		lua_pushnumber(L, memo->pos.y);
+		lua_pushnumber(L, memo->pos.z);
+
+		if (returnMidPos) {
+			lua_pushnumber(L, memo->midPos.x);
+			lua_pushnumber(L, memo->midPos.y);
+			lua_pushnumber(L, memo->midPos.z);
+		}
+		if (returnAimPos) {
+			lua_pushnumber(L, memo->aimPos.x);
+			lua_pushnumber(L, memo->aimPos.y);
+			lua_pushnumber(L, memo->aimPos.z);
+		}
+
+		return (3 + (3 * returnMidPos) + (3 * returnAimPos));
+	}
+
+	CUnit* unit = ParseUnit(L, __func__, 1);
+
+	if (unit != nullptr)
+		FillUnitReadMemo(L, unit);
+
+	return (GetSolidObjectPosition(L, unit, false));
 }
 
 int LuaSyncedRead::GetUnitBasePosition(lua_State* L)
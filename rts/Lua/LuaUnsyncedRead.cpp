@@ -4,6 +4,7 @@
 
 #include "LuaInclude.h"
 #include "LuaHandle.h"
+#include "LuaContextData.h"
 #include "LuaHashString.h"
 #include "LuaUtils.h"
 #include "Game/Camera.h"
@@ -46,6 +47,7 @@
 #include "Sim/Misc/ModInfo.h"
 #include "Sim/Misc/TeamHandler.h"
 #include "Sim/Misc/QuadField.h"
+#include "Sim/Path/IPathManager.h"
 #include "Sim/Projectiles/Projectile.h"
 #include "Sim/Units/Unit.h"
 #include "Sim/Units/UnitHandler.h"
@@ -55,10 +57,12 @@
 #include "Game/UI/Groups/GroupHandler.h"
 #include "Net/Protocol/NetProtocol.h"
 #include "System/Config/ConfigVariable.h"
+#include "System/EventHandler.h"
 #include "System/Input/KeyInput.h"
 #include "System/LoadSave/demofile.h"
 #include "System/LoadSave/DemoReader.h"
 #include "System/Log/DefaultFilter.h"
+#include "System/Net/TrafficStats.h"
 #include "System/Platform/SDL1_keysym.h"
 #include "System/Sound/ISoundChannels.h"
 #include "System/Misc/SpringTime.h"
@@ -172,6 +176,9 @@ bool LuaUnsyncedRead::PushEntries(lua_State* L)
 
 	REGISTER_LUA_CFUNC(GetFPS);
 	REGISTER_LUA_CFUNC(GetGameSpeed);
+	REGISTER_LUA_CFUNC(GetLuaMemPoolStats);
+	REGISTER_LUA_CFUNC(GetCallInStats);
+	REGISTER_LUA_CFUNC(GetPathStats);
 
 	REGISTER_LUA_CFUNC(GetActiveCommand);
 	REGISTER_LUA_CFUNC(GetDefaultCommand);
@@ -213,6 +220,7 @@ bool LuaUnsyncedRead::PushEntries(lua_State* L)
 
 	REGISTER_LUA_CFUNC(GetPlayerRoster);
 	REGISTER_LUA_CFUNC(GetPlayerTraffic);
+	REGISTER_LUA_CFUNC(GetNetMsgTraffic);
 	REGISTER_LUA_CFUNC(GetPlayerStatistics);
 
 	REGISTER_LUA_CFUNC(GetDrawSelectionInfo);
@@ -810,11 +818,53 @@ int LuaUnsyncedRead::GetVisibleUnits(lua_State* L)
 	float testRadius = 0.0f;
 
 	// arg 2 - use fixed test-value or add unit radii to it
-	if (lua_israwnumber(L, 2)) {
+	const bool customRadius = lua_israwnumber(L, 2);
+
+	if (customRadius) {
 		radiusMult = float((testRadius = lua_tofloat(L, 2)) >= 0.0f);
 		testRadius = std::max(testRadius, -testRadius);
 	}
 
+	// with default radius semantics the per-unit frustum test equals
+	// what the drawer's batched cull sweep already computed this frame,
+	// so serve from its snapshot and only apply the cheap filters; a
+	// custom radius can widen the test sphere beyond the sweep's and
+	// has to re-derive visibility below
+	const std::vector<int>* visUnitIDs = (!customRadius)? unitDrawer->GetPlayerVisUnitIDs(): nullptr;
+
+	if (visUnitIDs != nullptr) {
+		lua_createtable(L, visUnitIDs->size(), 0);
+
+		unsigned int count = 0;
+		for (const int visUnitID: *visUnitIDs) {
+			const CUnit* u = unitHandler->GetUnit(visUnitID);
+
+			if (u == nullptr || u->noDraw)
+				continue;
+
+			if (allyTeamID >= 0 && !(u->losStatus[allyTeamID] & LOS_INLOS))
+				continue;
+
+			if (noIcons && u->isIcon)
+				continue;
+
+			if ((teamID == AllyUnits)  && (allyTeamID != u->allyteam))
+				continue;
+
+			if ((teamID == EnemyUnits) && (allyTeamID == u->allyteam))
+				continue;
+
+			if ((teamID >= 0) && (teamID != u->team))
+				continue;
+
+			count++;
+			lua_pushnumber(L, u->id);
+			lua_rawseti(L, -2, count);
+		}
+
+		return 1;
+	}
+
 	static CVisUnitQuadDrawer unitQuadIter;
 
 	unitQuadIter.ResetState();
@@ -1737,6 +1787,74 @@ int LuaUnsyncedRead::GetGameSpeed(lua_State* L)
 }
 
 
+int LuaUnsyncedRead::GetLuaMemPoolStats(lua_State* L)
+{
+	// per-handle allocator statistics (shared-pool numbers when the
+	// handle does not own a private pool); bytes count pooled chunks
+	// only, allocations larger than LuaMemPool::MAX_ALLOC_SIZE go to
+	// the system allocator and show up in the external-alloc count
+	const LuaMemPool* pool = GetLuaContextData(L)->memPool;
+
+	lua_pushnumber(L, pool->GetLiveAllocBytes());
+	lua_pushnumber(L, pool->GetPeakAllocBytes());
+	lua_pushnumber(L, pool->GetSlabAllocBytes());
+	lua_pushnumber(L, pool->GetNumIntAllocs());
+	lua_pushnumber(L, pool->GetNumExtAllocs());
+	lua_pushnumber(L, pool->GetNumRecAllocs());
+	return 6;
+}
+
+
+int LuaUnsyncedRead::GetCallInStats(lua_State* L)
+{
+	// per call-in dispatch counters gathered by the eventHandler,
+	// keyed by event name; {dispatches, client call-ins iterated,
+	// milliseconds spent inside non-empty dispatches}
+	const size_t numEvents = eventHandler.GetNumEvents();
+
+	lua_createtable(L, 0, numEvents);
+
+	for (size_t evtID = 0; evtID < numEvents; evtID++) {
+		const CEventHandler::EventTiming& et = eventHandler.GetEventTiming(evtID);
+
+		if (et.numCalls == 0)
+			continue;
+
+		lua_pushsstring(L, eventHandler.GetEventName(evtID));
+		lua_createtable(L, 3, 0);
+		lua_pushnumber(L, et.numCalls);
+		lua_rawseti(L, -2, 1);
+		lua_pushnumber(L, et.numExecs);
+		lua_rawseti(L, -2, 2);
+		lua_pushnumber(L, et.execTime.toMilliSecsf());
+		lua_rawseti(L, -2, 3);
+		lua_rawset(L, -3);
+	}
+
+	return 1;
+}
+
+
+int LuaUnsyncedRead::GetPathStats(lua_State* L)
+{
+	if (pathManager == nullptr)
+		return 0;
+
+	// counters are cumulative since game start; widgets that want
+	// per-frame rates should difference across successive queries
+	const IPathManager::PathStats stats = pathManager->GetPathStats();
+
+	lua_pushnumber(L, stats.numPathRequests);
+	lua_pushnumber(L, stats.numQueuedSearches);
+	lua_pushnumber(L, stats.numExecutedSearches);
+	lua_pushnumber(L, stats.numLivePaths);
+	lua_pushnumber(L, stats.numCacheHits);
+	lua_pushnumber(L, stats.numCacheMisses);
+	lua_pushnumber(L, stats.searchTimeMilliSecs);
+	return 7;
+}
+
+
 /******************************************************************************/
 
 int LuaUnsyncedRead::GetActiveCommand(lua_State* L)
@@ -2363,6 +2481,27 @@ int LuaUnsyncedRead::GetPlayerTraffic(lua_State* L)
 	return 1;
 }
 
+int LuaUnsyncedRead::GetNetMsgTraffic(lua_State* L)
+{
+	// own-client aggregates, no per-player information leaks here
+	const int msgID = luaL_checkint(L, 1);
+
+	if ((msgID < 0) || (msgID > 255)) {
+		luaL_error(L, "Bad NETMSG id: %d", msgID);
+		return 0;
+	}
+
+	const netcode::TrafficStats::TypeStats& ts = netcode::TrafficStats::GetStats(msgID);
+
+	lua_pushnumber(L, ts.sentPackets);
+	lua_pushnumber(L, ts.sentBytes);
+	lua_pushnumber(L, ts.sentBytesPerSec);
+	lua_pushnumber(L, ts.recvPackets);
+	lua_pushnumber(L, ts.recvBytes);
+	lua_pushnumber(L, ts.recvBytesPerSec);
+	return 6;
+}
+
 int LuaUnsyncedRead::GetPlayerStatistics(lua_State* L)
 {
 	const int playerID = luaL_checkint(L, 1);
@@ -98,6 +98,9 @@ class LuaUnsyncedRead {
 
 		static int GetFPS(lua_State* L);
 		static int GetGameSpeed(lua_State* L);
+		static int GetLuaMemPoolStats(lua_State* L);
+		static int GetCallInStats(lua_State* L);
+		static int GetPathStats(lua_State* L);
 
 		static int GetMouseState(lua_State* L);
 		static int GetMouseCursor(lua_State* L);
@@ -145,6 +148,7 @@ class LuaUnsyncedRead {
 
 		static int GetPlayerRoster(lua_State* L);
 		static int GetPlayerTraffic(lua_State* L);
+		static int GetNetMsgTraffic(lua_State* L);
 		static int GetPlayerStatistics(lua_State* L);
 
 		static int GetDrawSelectionInfo(lua_State* L);
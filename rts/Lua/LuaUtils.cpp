@@ -3,6 +3,7 @@
 //#include "System/Platform/Win/win32.h"
 
 #include <cstring>
+#include <deque>
 
 #include "LuaUtils.h"
 #include "LuaConfig.h"
@@ -32,10 +33,6 @@ int LuaUtils::exportedDataSize = 0;
 /******************************************************************************/
 
 
-static bool CopyPushData(lua_State* dst, lua_State* src, int index, int depth, spring::unsynced_map<const void*, int>& alreadyCopied);
-static bool CopyPushTable(lua_State* dst, lua_State* src, int index, int depth, spring::unsynced_map<const void*, int>& alreadyCopied);
-
-
 static inline int PosAbsLuaIndex(lua_State* src, int index)
 {
 	if (index > 0)
@@ -45,122 +42,257 @@ static inline int PosAbsLuaIndex(lua_State* src, int index)
 }
 
 
-static bool CopyPushData(lua_State* dst, lua_State* src, int index, int depth, spring::unsynced_map<const void*, int>& alreadyCopied)
+// binary tags for the cross-state marshal buffer
+enum {
+	MARSHAL_NIL        = 0,
+	MARSHAL_FALSE      = 1,
+	MARSHAL_TRUE       = 2,
+	MARSHAL_NUMBER     = 3, // lua_Number payload
+	MARSHAL_STRING     = 4, // u32 length plus bytes, interned on read
+	MARSHAL_STRING_PTR = 5, // const char* plus u32 length, interned on read
+	MARSHAL_OBJ_REF    = 6, // u32 intern index of a repeated string or table
+	MARSHAL_TABLE      = 7, // u32 array-size hint, key/value pairs follow
+	MARSHAL_TABLE_END  = 8,
+};
+
+template<typename T> static inline void MarshalWrite(std::vector<std::uint8_t>& bytes, const T& val)
 {
-	const int type = lua_type(src, index);
-	switch (type) {
+	const std::uint8_t* p = reinterpret_cast<const std::uint8_t*>(&val);
+	bytes.insert(bytes.end(), p, p + sizeof(T));
+}
+
+template<typename T> static inline T MarshalRead(const std::uint8_t*& p)
+{
+	T val;
+	memcpy(&val, p, sizeof(T));
+	p += sizeof(T);
+	return val;
+}
+
+
+static bool SerializeValue(
+	lua_State* src,
+	int index,
+	int depth,
+	LuaUtils::DataMarshalBuffer& buf,
+	bool copyStrings,
+	spring::unsynced_map<const void*, unsigned int>& internedObjs
+) {
+	switch (lua_type(src, index)) {
 		case LUA_TBOOLEAN: {
-			lua_pushboolean(dst, lua_toboolean(src, index));
-			break;
-		}
+			buf.bytes.push_back(lua_toboolean(src, index)? MARSHAL_TRUE: MARSHAL_FALSE);
+		} break;
 		case LUA_TNUMBER: {
-			lua_pushnumber(dst, lua_tonumber(src, index));
-			break;
-		}
+			buf.bytes.push_back(MARSHAL_NUMBER);
+			MarshalWrite(buf.bytes, lua_tonumber(src, index));
+		} break;
 		case LUA_TSTRING: {
-			// get string (pointer)
-			size_t len;
+			size_t len = 0;
 			const char* data = lua_tolstring(src, index, &len);
 
-			// check cache
-			auto it = alreadyCopied.find(data);
-			if (it != alreadyCopied.end()) {
-				lua_rawgeti(dst, LUA_REGISTRYINDEX, it->second);
+			// Lua interns strings, repeats share their pointer
+			const auto it = internedObjs.find(data);
+
+			if (it != internedObjs.end()) {
+				buf.bytes.push_back(MARSHAL_OBJ_REF);
+				MarshalWrite(buf.bytes, it->second);
 				break;
 			}
 
-			// copy string
-			lua_pushlstring(dst, data, len);
-
-			// cache it
-			lua_pushvalue(dst, -1);
-			const int dstRef = luaL_ref(dst, LUA_REGISTRYINDEX);
-			alreadyCopied[data] = dstRef;
-			break;
-		}
+			const unsigned int objID = internedObjs.size();
+			internedObjs[data] = objID;
+
+			if (copyStrings) {
+				buf.bytes.push_back(MARSHAL_STRING);
+				MarshalWrite(buf.bytes, std::uint32_t(len));
+				buf.bytes.insert(buf.bytes.end(), data, data + len);
+			} else {
+				buf.bytes.push_back(MARSHAL_STRING_PTR);
+				MarshalWrite(buf.bytes, data);
+				MarshalWrite(buf.bytes, std::uint32_t(len));
+			}
+		} break;
 		case LUA_TTABLE: {
-			CopyPushTable(dst, src, index, depth, alreadyCopied);
-			break;
-		}
+			const int table = PosAbsLuaIndex(src, index);
+			const void* ptr = lua_topointer(src, table);
+
+			// needed for recursive tables, i.e. "local t = {}; t[t] = t"
+			const auto it = internedObjs.find(ptr);
+
+			if (it != internedObjs.end()) {
+				buf.bytes.push_back(MARSHAL_OBJ_REF);
+				MarshalWrite(buf.bytes, it->second);
+				break;
+			}
+
+			if (depth++ > maxDepth) {
+				LOG("SerializeValue: reached max table depth '%i'", depth);
+				buf.bytes.push_back(MARSHAL_NIL); // push something
+				return false;
+			}
+
+			const unsigned int objID = internedObjs.size();
+			internedObjs[ptr] = objID;
+
+			buf.bytes.push_back(MARSHAL_TABLE);
+			MarshalWrite(buf.bytes, std::uint32_t(lua_objlen(src, table)));
+
+			for (lua_pushnil(src); lua_next(src, table) != 0; lua_pop(src, 1)) {
+				SerializeValue(src, -2, depth, buf, copyStrings, internedObjs); // the key
+				SerializeValue(src, -1, depth, buf, copyStrings, internedObjs); // the value
+			}
+
+			buf.bytes.push_back(MARSHAL_TABLE_END);
+		} break;
 		default: {
-			lua_pushnil(dst); // unhandled type
+			buf.bytes.push_back(MARSHAL_NIL); // unhandled type
 			return false;
 		}
 	}
+
 	return true;
 }
 
 
-static bool CopyPushTable(lua_State* dst, lua_State* src, int index, int depth, spring::unsynced_map<const void*, int>& alreadyCopied)
+static void DeserializeValue(lua_State* dst, const std::uint8_t*& p, int scratchIdx, unsigned int& numInterned)
 {
-	const int table = PosAbsLuaIndex(src, index);
+	switch (*(p++)) {
+		case MARSHAL_NIL: {
+			lua_pushnil(dst);
+		} break;
+		case MARSHAL_FALSE: {
+			lua_pushboolean(dst, false);
+		} break;
+		case MARSHAL_TRUE: {
+			lua_pushboolean(dst, true);
+		} break;
+		case MARSHAL_NUMBER: {
+			lua_pushnumber(dst, MarshalRead<lua_Number>(p));
+		} break;
+		case MARSHAL_STRING: {
+			const std::uint32_t len = MarshalRead<std::uint32_t>(p);
+
+			lua_pushlstring(dst, reinterpret_cast<const char*>(p), len);
+			p += len;
 
-	// check cache
-	const void* p = lua_topointer(src, table);
-	auto it = alreadyCopied.find(p);
-	if (it != alreadyCopied.end()) {
-		lua_rawgeti(dst, LUA_REGISTRYINDEX, it->second);
-		return true;
+			lua_pushvalue(dst, -1);
+			lua_rawseti(dst, scratchIdx, ++numInterned);
+		} break;
+		case MARSHAL_STRING_PTR: {
+			const char* data = MarshalRead<const char*>(p);
+			const std::uint32_t len = MarshalRead<std::uint32_t>(p);
+
+			lua_pushlstring(dst, data, len);
+
+			lua_pushvalue(dst, -1);
+			lua_rawseti(dst, scratchIdx, ++numInterned);
+		} break;
+		case MARSHAL_OBJ_REF: {
+			// serializer ids start at 0, scratch-table slots at 1
+			lua_rawgeti(dst, scratchIdx, MarshalRead<std::uint32_t>(p) + 1);
+		} break;
+		case MARSHAL_TABLE: {
+			lua_createtable(dst, MarshalRead<std::uint32_t>(p), 5);
+
+			lua_pushvalue(dst, -1);
+			lua_rawseti(dst, scratchIdx, ++numInterned);
+
+			while (*p != MARSHAL_TABLE_END) {
+				DeserializeValue(dst, p, scratchIdx, numInterned); // the key
+				DeserializeValue(dst, p, scratchIdx, numInterned); // the value
+				lua_rawset(dst, -3);
+			}
+
+			p += 1; // MARSHAL_TABLE_END
+		} break;
+		default: {
+			assert(false);
+			lua_pushnil(dst);
+		} break;
 	}
+}
 
-	// check table depth
-	if (depth++ > maxDepth) {
-		LOG("CopyTable: reached max table depth '%i'", depth);
-		lua_pushnil(dst); // push something
-		return false;
+
+int LuaUtils::SerializeData(lua_State* src, int count, DataMarshalBuffer& buf, bool copyStrings)
+{
+	buf.Clear();
+
+	const int srcTop = lua_gettop(src);
+
+	if (srcTop < count) {
+		LOG_L(L_ERROR, "LuaUtils::SerializeData: tried to copy more data than there is");
+		return 0;
 	}
 
-	// create new table
-	const auto array_len = lua_objlen(src, table);
-	lua_createtable(dst, array_len, 5);
+	// the order of traversal doesn't matter so we can use an unsynced map
+	spring::unsynced_map<const void*, unsigned int> internedObjs;
 
-	// cache it
-	lua_pushvalue(dst, -1);
-	const int dstRef = luaL_ref(dst, LUA_REGISTRYINDEX);
-	alreadyCopied[p] = dstRef;
+	for (int i = srcTop - count + 1; i <= srcTop; i++) {
+		SerializeValue(src, i, 0, buf, copyStrings, internedObjs);
+		buf.numValues += 1;
+	}
 
-	// copy table entries
-	for (lua_pushnil(src); lua_next(src, table) != 0; lua_pop(src, 1)) {
-		CopyPushData(dst, src, -2, depth, alreadyCopied); // copy the key
-		CopyPushData(dst, src, -1, depth, alreadyCopied); // copy the value
-		lua_rawset(dst, -3);
+	return count;
+}
+
+
+int LuaUtils::DeserializeData(lua_State* dst, const DataMarshalBuffer& buf)
+{
+	// values plus up to three working slots per nesting level
+	lua_checkstack(dst, buf.numValues + 3 * maxDepth);
+
+	// scratch table holding the interned strings and tables by index
+	lua_newtable(dst);
+	const int scratchIdx = lua_gettop(dst);
+
+	const std::uint8_t* p = buf.bytes.data();
+	unsigned int numInterned = 0;
+
+	for (unsigned int i = 0; i < buf.numValues; i++) {
+		DeserializeValue(dst, p, scratchIdx, numInterned);
 	}
 
-	return true;
+	assert(p == (buf.bytes.data() + buf.bytes.size()));
+
+	lua_remove(dst, scratchIdx);
+	return buf.numValues;
 }
 
 
+// reusable marshal buffers, indexed by re-entrancy depth (a __gc
+// metamethod triggered while deserializing can invoke CopyData
+// again); steady-state calls never reallocate the buffer itself
+static std::deque<LuaUtils::DataMarshalBuffer> marshalBuffers;
+static unsigned int marshalDepth = 0;
+
+
 int LuaUtils::CopyData(lua_State* dst, lua_State* src, int count)
 {
 	SCOPED_TIMER("Lua::CopyData");
 
 	const int srcTop = lua_gettop(src);
 	const int dstTop = lua_gettop(dst);
+
 	if (srcTop < count) {
 		LOG_L(L_ERROR, "LuaUtils::CopyData: tried to copy more data than there is");
 		return 0;
 	}
-	lua_checkstack(dst, count + 3); // +3 needed for table copying
+
 	lua_lock(src); // we need to be sure tables aren't changed while we iterate them
 
-	// hold a map of all already copied tables in the lua's registry table
-	// needed for recursive tables, i.e. "local t = {}; t[t] = t"
-	// the order of traversal doesn't matter so we can use an unsynced map
-	spring::unsynced_map<const void*, int> alreadyCopied;
+	if (marshalDepth >= marshalBuffers.size())
+		marshalBuffers.emplace_back();
 
-	const int startIndex = (srcTop - count + 1);
-	const int endIndex   = srcTop;
-	for (int i = startIndex; i <= endIndex; i++) {
-		CopyPushData(dst, src, i, 0, alreadyCopied);
-	}
+	DataMarshalBuffer& buf = marshalBuffers[marshalDepth++];
 
-	// clear map
-	for (auto& pair: alreadyCopied) {
-		luaL_unref(dst, LUA_REGISTRYINDEX, pair.second);
-	}
+	// string payloads are recorded by pointer (zero-copy): src is
+	// locked and keeps them alive until deserialization completes
+	SerializeData(src, count, buf, false);
+	DeserializeData(dst, buf);
+
+	marshalDepth -= 1;
 
-	const int curSrcTop = lua_gettop(src);
-	assert(srcTop == curSrcTop);
+	assert(srcTop == lua_gettop(src));
 	lua_settop(dst, dstTop + count);
 	lua_unlock(src);
 	return count;
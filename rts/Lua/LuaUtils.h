@@ -3,6 +3,7 @@
 #ifndef LUA_UTILS_H
 #define LUA_UTILS_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 using std::string;
@@ -74,6 +75,27 @@ class LuaUtils {
 		static int Backup(std::vector<DataDump> &backup, lua_State* src, int count);
 		static int Restore(const std::vector<DataDump> &backup, lua_State* dst);
 
+		// flat binary image of a stack slice; reused across calls so
+		// steady-state marshalling does not allocate, repeated strings
+		// and tables are interned as indices into the value stream
+		struct DataMarshalBuffer {
+			std::vector<std::uint8_t> bytes;
+			unsigned int numValues = 0;
+
+			void Clear() {
+				bytes.clear();
+				numValues = 0;
+			}
+		};
+
+		// Serializes the topmost <count> stack values of src into buf;
+		// with copyStrings=false string payloads are recorded by pointer
+		// (zero-copy), only valid while src stays untouched, i.e. for
+		// immediate deserialization as done by CopyData
+		static int SerializeData(lua_State* src, int count, DataMarshalBuffer& buf, bool copyStrings);
+		// rebuilds the serialized values on dst's stack in a single pass
+		static int DeserializeData(lua_State* dst, const DataMarshalBuffer& buf);
+
 		// Copies lua data between 2 lua_States
 		static int CopyData(lua_State* dst, lua_State* src, int count);
 
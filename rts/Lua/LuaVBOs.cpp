@@ -0,0 +1,442 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+
+#include "LuaVBOs.h"
+
+#include "LuaInclude.h"
+
+#include "LuaHandle.h"
+#include "LuaHashString.h"
+#include "LuaOpenGL.h"
+#include "LuaUtils.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+LuaVBOs::~LuaVBOs()
+{
+	for (const LuaVBO* vbo: vbos) {
+		glDeleteBuffers(1, &vbo->id);
+	}
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+bool LuaVBOs::PushEntries(lua_State* L)
+{
+	CreateMetatable(L);
+
+	REGISTER_LUA_CFUNC(CreateVertexBuffer);
+	REGISTER_LUA_CFUNC(DeleteVertexBuffer);
+	REGISTER_LUA_CFUNC(UploadVertexBuffer);
+	REGISTER_LUA_CFUNC(DrawVertexBuffer);
+
+	return true;
+}
+
+
+bool LuaVBOs::CreateMetatable(lua_State* L)
+{
+	luaL_newmetatable(L, "VBO");
+	HSTR_PUSH_CFUNC(L, "__gc",        meta_gc);
+	HSTR_PUSH_CFUNC(L, "__index",     meta_index);
+	HSTR_PUSH_CFUNC(L, "__newindex",  meta_newindex);
+	lua_pop(L, 1);
+	return true;
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+const LuaVBOs::LuaVBO* LuaVBOs::GetLuaVBO(lua_State* L, int index)
+{
+	return static_cast<LuaVBO*>(LuaUtils::GetUserData(L, index, "VBO"));
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+static inline void CheckDrawingEnabled(lua_State* L, const char* caller)
+{
+	if (!LuaOpenGL::IsDrawingEnabled(L)) {
+		luaL_error(L, "%s(): OpenGL calls can only be used in Draw() "
+		              "call-ins, or while creating display lists", caller);
+	}
+}
+
+
+static GLuint AttribTypeSize(GLenum type)
+{
+	switch (type) {
+		case GL_FLOAT:         return sizeof(GLfloat);
+		case GL_UNSIGNED_BYTE: return sizeof(GLubyte);
+		default:               return 0;
+	}
+}
+
+
+static int ParseAttribSemantic(const std::string& name)
+{
+	if (name ==   "vertex") { return LuaVBOs::ATTR_VERTEX;   }
+	if (name ==   "normal") { return LuaVBOs::ATTR_NORMAL;   }
+	if (name ==    "color") { return LuaVBOs::ATTR_COLOR;    }
+	if (name == "texcoord") { return LuaVBOs::ATTR_TEXCOORD; }
+
+	return -1;
+}
+
+
+// layout = { {size = 3, semantic = "vertex"}, {size = 4, id = 7, divisor = 1}, ... }
+static void ParseAttribLayout(lua_State* L, int table, LuaVBOs::LuaVBO& vbo)
+{
+	GLuint offset = 0;
+
+	for (int i = 1; lua_rawgeti(L, table, i), !lua_isnil(L, -1); lua_pop(L, 1), i++) {
+		if (!lua_istable(L, -1))
+			luaL_error(L, "Incorrect arguments to gl.CreateVertexBuffer()");
+		if (vbo.numAttribs >= LuaVBOs::maxAttribs)
+			luaL_error(L, "gl.CreateVertexBuffer: too many attributes");
+
+		LuaVBOs::Attrib& attr = vbo.attribs[vbo.numAttribs++];
+		attr.semantic = LuaVBOs::ATTR_GENERIC;
+		attr.attrId = 0;
+		attr.size = 0;
+		attr.type = GL_FLOAT;
+		attr.divisor = 0;
+		attr.normalized = false;
+
+		const int attrTable = lua_gettop(L);
+		for (lua_pushnil(L); lua_next(L, attrTable) != 0; lua_pop(L, 1)) {
+			if (!lua_israwstring(L, -2))
+				continue;
+
+			const std::string key = lua_tostring(L, -2);
+
+			if (key == "size") {
+				attr.size = (GLint)luaL_checknumber(L, -1);
+			} else if (key == "semantic") {
+				attr.semantic = ParseAttribSemantic(luaL_checkstring(L, -1));
+			} else if (key == "id") {
+				attr.attrId = (GLuint)luaL_checknumber(L, -1);
+			} else if (key == "type") {
+				attr.type = (GLenum)luaL_checknumber(L, -1);
+			} else if (key == "normalized") {
+				attr.normalized = lua_toboolean(L, -1);
+			} else if (key == "divisor") {
+				attr.divisor = (GLuint)luaL_checknumber(L, -1);
+			}
+		}
+
+		if (attr.size < 1 || attr.size > 4)
+			luaL_error(L, "gl.CreateVertexBuffer: attribute size must be 1 to 4");
+		if (attr.semantic < 0)
+			luaL_error(L, "gl.CreateVertexBuffer: unknown attribute semantic");
+		if (AttribTypeSize(attr.type) == 0)
+			luaL_error(L, "gl.CreateVertexBuffer: unsupported attribute type");
+		if (attr.divisor != 0 && attr.semantic != LuaVBOs::ATTR_GENERIC)
+			luaL_error(L, "gl.CreateVertexBuffer: divisors require generic attributes");
+
+		// keep float attributes 4-byte aligned within the vertex
+		if (attr.type == GL_FLOAT)
+			offset = (offset + 3) & ~3u;
+
+		attr.offset = offset;
+		offset += attr.size * AttribTypeSize(attr.type);
+	}
+
+	vbo.stride = (offset + 3) & ~3u;
+
+	if (vbo.numAttribs == 0)
+		luaL_error(L, "gl.CreateVertexBuffer: empty attribute layout");
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+void LuaVBOs::LuaVBO::Init()
+{
+	index       = -1u;
+	id          = 0;
+	numVertices = 0;
+	stride      = 0;
+	usage       = GL_STATIC_DRAW;
+	numAttribs  = 0;
+}
+
+
+void LuaVBOs::LuaVBO::Free(lua_State* L)
+{
+	if (id == 0)
+		return;
+
+	glDeleteBuffers(1, &id);
+	id = 0;
+
+	{
+		// get rid of the userdatum
+		LuaVBOs& activeVBOs = CLuaHandle::GetActiveVBOs(L);
+		auto& vbos = activeVBOs.vbos;
+
+		assert(index < vbos.size());
+		assert(vbos[index] == this);
+
+		vbos[index] = vbos.back();
+		vbos[index]->index = index;
+		vbos.pop_back();
+	}
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+int LuaVBOs::meta_gc(lua_State* L)
+{
+	LuaVBO* vbo = static_cast<LuaVBO*>(luaL_checkudata(L, 1, "VBO"));
+	vbo->Free(L);
+	return 0;
+}
+
+
+int LuaVBOs::meta_index(lua_State* L)
+{
+	const LuaVBO* vbo = static_cast<LuaVBO*>(luaL_checkudata(L, 1, "VBO"));
+	const std::string& key = luaL_checkstring(L, 2);
+
+	if (key ==       "valid") { lua_pushboolean(L, glIsBuffer(vbo->id)); return 1; }
+	if (key == "numVertices") { lua_pushnumber(L, vbo->numVertices); return 1; }
+	if (key ==      "stride") { lua_pushnumber(L, vbo->stride); return 1; }
+	if (key ==       "usage") { lua_pushnumber(L, vbo->usage); return 1; }
+
+	return 0;
+}
+
+
+int LuaVBOs::meta_newindex(lua_State* L)
+{
+	return 0;
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+int LuaVBOs::CreateVertexBuffer(lua_State* L)
+{
+	LuaVBO vbo;
+	vbo.Init();
+
+	vbo.numVertices = (GLsizei)luaL_checknumber(L, 1);
+
+	if (vbo.numVertices <= 0)
+		luaL_error(L, "gl.CreateVertexBuffer: vertex count must be positive");
+	if (!lua_istable(L, 2))
+		luaL_error(L, "Incorrect arguments to gl.CreateVertexBuffer()");
+
+	ParseAttribLayout(L, 2, vbo);
+
+	vbo.usage = (GLenum)luaL_optnumber(L, 3, GL_STATIC_DRAW);
+
+	glGenBuffers(1, &vbo.id);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo.id);
+
+	// allocate the memory
+	glBufferData(GL_ARRAY_BUFFER, vbo.numVertices * vbo.stride, nullptr, vbo.usage);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	LuaVBO* vboPtr = static_cast<LuaVBO*>(lua_newuserdata(L, sizeof(LuaVBO)));
+	*vboPtr = vbo;
+
+	luaL_getmetatable(L, "VBO");
+	lua_setmetatable(L, -2);
+
+	if (vboPtr->id != 0) {
+		LuaVBOs& activeVBOs = CLuaHandle::GetActiveVBOs(L);
+		auto& vbos = activeVBOs.vbos;
+
+		vbos.push_back(vboPtr);
+		vboPtr->index = vbos.size() - 1;
+	}
+
+	return 1;
+}
+
+
+int LuaVBOs::DeleteVertexBuffer(lua_State* L)
+{
+	if (lua_isnil(L, 1)) {
+		return 0;
+	}
+	LuaVBO* vbo = static_cast<LuaVBO*>(luaL_checkudata(L, 1, "VBO"));
+	vbo->Free(L);
+	return 0;
+}
+
+
+// gl.UploadVertexBuffer(vbo, data[, firstVertex]); data is a flat array of
+// numbers in attribute-declaration order, firstVertex counts from 0 so
+// sub-ranges can be rewritten without touching the rest of the buffer
+int LuaVBOs::UploadVertexBuffer(lua_State* L)
+{
+	const LuaVBO* vbo = static_cast<LuaVBO*>(luaL_checkudata(L, 1, "VBO"));
+
+	if (vbo->id == 0)
+		luaL_error(L, "gl.UploadVertexBuffer: invalid buffer");
+	if (!lua_istable(L, 2))
+		luaL_error(L, "Incorrect arguments to gl.UploadVertexBuffer()");
+
+	const GLsizei firstVertex = (GLsizei)luaL_optnumber(L, 3, 0);
+
+	int numsPerVertex = 0;
+	for (int a = 0; a < vbo->numAttribs; a++) {
+		numsPerVertex += vbo->attribs[a].size;
+	}
+
+	const GLsizei numVerts = lua_objlen(L, 2) / numsPerVertex;
+
+	if (firstVertex < 0 || (firstVertex + numVerts) > vbo->numVertices)
+		luaL_error(L, "gl.UploadVertexBuffer: vertex range exceeds buffer size");
+	if (numVerts == 0)
+		return 0;
+
+	// pack the flat number array into the interleaved vertex format
+	std::vector<GLubyte> data(numVerts * vbo->stride, 0);
+
+	int dataIdx = 1;
+	for (GLsizei v = 0; v < numVerts; v++) {
+		GLubyte* vertex = &data[v * vbo->stride];
+
+		for (int a = 0; a < vbo->numAttribs; a++) {
+			const Attrib& attr = vbo->attribs[a];
+
+			for (GLint c = 0; c < attr.size; c++) {
+				lua_rawgeti(L, 2, dataIdx++);
+				const float value = lua_tonumber(L, -1);
+				lua_pop(L, 1);
+
+				if (attr.type == GL_FLOAT) {
+					memcpy(vertex + attr.offset + c * sizeof(GLfloat), &value, sizeof(GLfloat));
+				} else {
+					const float scale = attr.normalized? 255.0f: 1.0f;
+					vertex[attr.offset + c] = (GLubyte)std::max(0.0f, std::min(255.0f, value * scale));
+				}
+			}
+		}
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, vbo->id);
+	glBufferSubData(GL_ARRAY_BUFFER, firstVertex * vbo->stride, data.size(), &data[0]);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	return 0;
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
+
+static void EnableAttribArrays(const LuaVBOs::LuaVBO* vbo)
+{
+	const GLubyte* base = nullptr;
+
+	for (int a = 0; a < vbo->numAttribs; a++) {
+		const LuaVBOs::Attrib& attr = vbo->attribs[a];
+		const GLvoid* ptr = base + attr.offset;
+
+		switch (attr.semantic) {
+			case LuaVBOs::ATTR_VERTEX: {
+				glVertexPointer(attr.size, attr.type, vbo->stride, ptr);
+				glEnableClientState(GL_VERTEX_ARRAY);
+			} break;
+			case LuaVBOs::ATTR_NORMAL: {
+				glNormalPointer(attr.type, vbo->stride, ptr);
+				glEnableClientState(GL_NORMAL_ARRAY);
+			} break;
+			case LuaVBOs::ATTR_COLOR: {
+				glColorPointer(attr.size, attr.type, vbo->stride, ptr);
+				glEnableClientState(GL_COLOR_ARRAY);
+			} break;
+			case LuaVBOs::ATTR_TEXCOORD: {
+				glTexCoordPointer(attr.size, attr.type, vbo->stride, ptr);
+				glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+			} break;
+			case LuaVBOs::ATTR_GENERIC: {
+				glVertexAttribPointer(attr.attrId, attr.size, attr.type, attr.normalized, vbo->stride, ptr);
+				glEnableVertexAttribArray(attr.attrId);
+				if (attr.divisor != 0 && GLEW_ARB_instanced_arrays)
+					glVertexAttribDivisorARB(attr.attrId, attr.divisor);
+			} break;
+		}
+	}
+}
+
+
+static void DisableAttribArrays(const LuaVBOs::LuaVBO* vbo)
+{
+	for (int a = 0; a < vbo->numAttribs; a++) {
+		const LuaVBOs::Attrib& attr = vbo->attribs[a];
+
+		switch (attr.semantic) {
+			case LuaVBOs::ATTR_VERTEX:   { glDisableClientState(GL_VERTEX_ARRAY);        } break;
+			case LuaVBOs::ATTR_NORMAL:   { glDisableClientState(GL_NORMAL_ARRAY);        } break;
+			case LuaVBOs::ATTR_COLOR:    { glDisableClientState(GL_COLOR_ARRAY);         } break;
+			case LuaVBOs::ATTR_TEXCOORD: { glDisableClientState(GL_TEXTURE_COORD_ARRAY); } break;
+			case LuaVBOs::ATTR_GENERIC:  {
+				glDisableVertexAttribArray(attr.attrId);
+				if (attr.divisor != 0 && GLEW_ARB_instanced_arrays)
+					glVertexAttribDivisorARB(attr.attrId, 0);
+			} break;
+		}
+	}
+}
+
+
+// gl.DrawVertexBuffer(vbo, primType[, firstVertex, vertexCount[, instanceCount]])
+int LuaVBOs::DrawVertexBuffer(lua_State* L)
+{
+	CheckDrawingEnabled(L, __FUNCTION__);
+
+	const LuaVBO* vbo = static_cast<LuaVBO*>(luaL_checkudata(L, 1, "VBO"));
+
+	if (vbo->id == 0)
+		luaL_error(L, "gl.DrawVertexBuffer: invalid buffer");
+
+	const GLenum mode = (GLenum)luaL_checknumber(L, 2);
+	const GLint first = (GLint)luaL_optnumber(L, 3, 0);
+	const GLsizei count = (GLsizei)luaL_optnumber(L, 4, vbo->numVertices - first);
+	const GLsizei instances = (GLsizei)luaL_optnumber(L, 5, 0);
+
+	if (first < 0 || count < 0 || (first + count) > vbo->numVertices)
+		luaL_error(L, "gl.DrawVertexBuffer: vertex range exceeds buffer size");
+	if (instances != 0 && !GLEW_ARB_draw_instanced)
+		luaL_error(L, "gl.DrawVertexBuffer: instancing is not supported");
+
+	glBindBuffer(GL_ARRAY_BUFFER, vbo->id);
+	EnableAttribArrays(vbo);
+
+	if (instances != 0) {
+		glDrawArraysInstancedARB(mode, first, count, instances);
+	} else {
+		glDrawArrays(mode, first, count);
+	}
+
+	DisableAttribArrays(vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	return 0;
+}
+
+
+/******************************************************************************/
+/******************************************************************************/
@@ -0,0 +1,82 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef LUA_VBOS_H
+#define LUA_VBOS_H
+
+#include <vector>
+
+#include "Rendering/GL/myGL.h"
+
+
+struct lua_State;
+
+
+class LuaVBOs {
+	public:
+		LuaVBOs() { vbos.reserve(8); }
+		~LuaVBOs();
+
+		void Clear() { vbos.clear(); }
+
+		static bool PushEntries(lua_State* L);
+
+		struct LuaVBO;
+		static const LuaVBO* GetLuaVBO(lua_State* L, int index);
+
+	public:
+		static const int maxAttribs = 8;
+
+		// fixed-function semantics; ATTR_GENERIC uses glVertexAttribPointer
+		enum AttribSemantic {
+			ATTR_GENERIC  = 0,
+			ATTR_VERTEX   = 1,
+			ATTR_NORMAL   = 2,
+			ATTR_COLOR    = 3,
+			ATTR_TEXCOORD = 4,
+		};
+
+		struct Attrib {
+			int semantic;
+			GLuint attrId;  // generic attribute index (ATTR_GENERIC only)
+			GLint size;     // number of components, 1 to 4
+			GLenum type;    // GL_FLOAT or GL_UNSIGNED_BYTE
+			GLuint offset;  // byte offset within a vertex
+			GLuint divisor; // instancing divisor (ATTR_GENERIC only)
+			bool normalized;
+		};
+
+		struct LuaVBO {
+			LuaVBO() : index(-1u), id(0), numVertices(0), stride(0), usage(0), numAttribs(0) {}
+
+			void Init();
+			void Free(lua_State* L);
+
+			GLuint index; // into LuaVBOs::vbos
+			GLuint id;
+			GLsizei numVertices;
+			GLsizei stride;
+			GLenum usage;
+			int numAttribs;
+			Attrib attribs[maxAttribs];
+		};
+
+	private:
+		std::vector<LuaVBO*> vbos;
+
+	private: // helpers
+		static bool CreateMetatable(lua_State* L);
+
+	private: // metatable methods
+		static int meta_gc(lua_State* L);
+		static int meta_index(lua_State* L);
+		static int meta_newindex(lua_State* L);
+
+	private:
+		static int CreateVertexBuffer(lua_State* L);
+		static int DeleteVertexBuffer(lua_State* L);
+		static int UploadVertexBuffer(lua_State* L);
+		static int DrawVertexBuffer(lua_State* L);
+};
+
+
+#endif /* LUA_VBOS_H */
@@ -1,10 +1,13 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
 
+#include <atomic>
 #include <cmath>
+#include <memory>
 
 #include "LuaVFS.h"
 #include "LuaInclude.h"
+#include "LuaBytecodeCache.h"
 #include "LuaHandle.h"
 #include "LuaHashString.h"
 #include "LuaIO.h"
@@ -15,6 +18,8 @@
 #include "System/FileSystem/VFSHandler.h"
 #include "System/FileSystem/FileSystem.h"
 #include "System/StringUtil.h"
+#include "System/Threading/ThreadPool.h"
+#include "System/UnorderedMap.hpp"
 #include "../tools/pr-downloader/src/pr-downloader.h"
 
 
@@ -76,6 +81,9 @@ bool LuaVFS::PushUnsynced(lua_State* L)
 
 	HSTR_PUSH_CFUNC(L, "Include",        UnsyncInclude);
 	HSTR_PUSH_CFUNC(L, "LoadFile",       UnsyncLoadFile);
+	HSTR_PUSH_CFUNC(L, "LoadFileAsync",  LoadFileAsync);
+	HSTR_PUSH_CFUNC(L, "GetLoadedFile",  GetLoadedFile);
+	HSTR_PUSH_CFUNC(L, "LoadFiles",      LoadFiles);
 	HSTR_PUSH_CFUNC(L, "FileExists",     UnsyncFileExists);
 	HSTR_PUSH_CFUNC(L, "DirList",        UnsyncDirList);
 	HSTR_PUSH_CFUNC(L, "SubDirs",        UnsyncSubDirs);
@@ -155,7 +163,7 @@ int LuaVFS::Include(lua_State* L, bool synced)
  		lua_error(L);
 	}
 
-	int error = luaL_loadbuffer(L, code.c_str(), code.size(), filename.c_str());
+	int error = LuaBytecodeCache::LoadBuffer(L, code, filename.c_str());
 	if (error != 0) {
 		char buf[1024];
 		SNPRINTF(buf, sizeof(buf), "error = %i, %s, %s", error, filename.c_str(), lua_tostring(L, -1));
@@ -233,6 +241,127 @@ int LuaVFS::UnsyncLoadFile(lua_State* L)
 }
 
 
+/******************************************************************************/
+
+// pending VFS.LoadFileAsync requests; the worker task only touches its
+// own request struct (archive access is serialized internally by
+// BufferedArchive), results are handed out on the calling thread
+struct AsyncFileRequest {
+	string fileName;
+	string modes;
+	string data;
+	bool success = false;
+	std::atomic<bool> done{false};
+};
+
+static spring::unordered_map<int, std::shared_ptr<AsyncFileRequest>> asyncFileRequests;
+static int nextAsyncRequestID = 1;
+
+
+// VFS.LoadFileAsync(fileName[, vfsModes]) -> requestID; the read and
+// decompression run on a ThreadPool worker, poll the id on a later
+// frame with VFS.GetLoadedFile (unsynced only)
+int LuaVFS::LoadFileAsync(lua_State* L)
+{
+	const string filename = luaL_checkstring(L, 1);
+
+	if (!LuaIO::IsSimplePath(filename)) {
+		// the path may point to a file or dir outside of any data-dir
+//FIXME		return 0;
+	}
+
+	auto req = std::make_shared<AsyncFileRequest>();
+	req->fileName = filename;
+	req->modes = GetModes(L, 2, false);
+
+	const int requestID = nextAsyncRequestID++;
+	asyncFileRequests[requestID] = req;
+
+	ThreadPool::Enqueue([req]() {
+		req->success = LoadFileWithModes(req->fileName, req->data, req->modes);
+		req->done.store(true, std::memory_order_release);
+	});
+
+	lua_pushnumber(L, requestID);
+	return 1;
+}
+
+
+// VFS.GetLoadedFile(requestID) -> data string once finished, false if
+// the file could not be read, nil while the request is still pending;
+// finished requests are forgotten after the first successful poll
+int LuaVFS::GetLoadedFile(lua_State* L)
+{
+	const int requestID = luaL_checkint(L, 1);
+
+	const auto it = asyncFileRequests.find(requestID);
+
+	if (it == asyncFileRequests.end())
+		return 0;
+
+	const std::shared_ptr<AsyncFileRequest>& req = it->second;
+
+	if (!req->done.load(std::memory_order_acquire))
+		return 0;
+
+	if (req->success) {
+		lua_pushsstring(L, req->data);
+	} else {
+		lua_pushboolean(L, false);
+	}
+
+	asyncFileRequests.erase(it);
+	return 1;
+}
+
+
+// VFS.LoadFiles({fileNames}[, vfsModes]) -> {fileName = data},
+// {fileName = errorMessage}; the reads are sharded across ThreadPool
+// workers in one pass (unsynced only)
+int LuaVFS::LoadFiles(lua_State* L)
+{
+	if (!lua_istable(L, 1))
+		luaL_error(L, "Incorrect arguments to VFS.LoadFiles({fileNames})");
+
+	const string modes = GetModes(L, 2, false);
+
+	std::vector<string> fileNames;
+
+	for (int i = 1; lua_rawgeti(L, 1, i), !lua_isnil(L, -1); lua_pop(L, 1), i++) {
+		if (lua_israwstring(L, -1)) {
+			fileNames.push_back(lua_tostring(L, -1));
+		}
+	}
+
+	lua_pop(L, 1);
+
+	std::vector<string> fileData(fileNames.size());
+	std::vector<char> loaded(fileNames.size(), 0);
+
+	for_mt(0, (int)fileNames.size(), [&](const int i) {
+		loaded[i] = LoadFileWithModes(fileNames[i], fileData[i], modes);
+	});
+
+	lua_checkstack(L, 4);
+	lua_newtable(L); // file contents
+	lua_newtable(L); // error messages
+
+	for (size_t i = 0; i < fileNames.size(); i++) {
+		if (loaded[i]) {
+			lua_pushsstring(L, fileNames[i]);
+			lua_pushsstring(L, fileData[i]);
+			lua_rawset(L, -4);
+		} else {
+			lua_pushsstring(L, fileNames[i]);
+			lua_pushliteral(L, "could not load data");
+			lua_rawset(L, -3);
+		}
+	}
+
+	return 2;
+}
+
+
 /******************************************************************************/
 
 int LuaVFS::FileExists(lua_State* L, bool synced)
@@ -33,6 +33,9 @@ class LuaVFS {
 
 		static int UnsyncInclude(lua_State* L);
 		static int UnsyncLoadFile(lua_State* L);
+		static int LoadFileAsync(lua_State* L);
+		static int GetLoadedFile(lua_State* L);
+		static int LoadFiles(lua_State* L);
 		static int UnsyncFileExists(lua_State* L);
 		static int UnsyncDirList(lua_State* L);
 		static int UnsyncSubDirs(lua_State* L);
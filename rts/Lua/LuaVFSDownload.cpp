@@ -7,6 +7,7 @@
 #include "System/EventHandler.h"
 #include "System/Platform/Threading.h" // Is{Main,GameLoad}Thread
 #include "System/Threading/SpringThreading.h"
+#include "System/Threading/ThreadPool.h"
 #include "System/FileSystem/ArchiveScanner.h"
 #include "System/FileSystem/DataDirLocater.h"
 
@@ -65,10 +66,14 @@ public:
 	bool Remove(int id);
 
 	void Join();
+	void WaitForScan();
 private:
 	std::deque<DownloadItem> queue;
 	spring::mutex mutex;
 	spring::thread* thread;
+	// pending post-download rescan, runs on a pool worker so the
+	// next queued download is not stalled behind it (see Pump)
+	std::shared_ptr<std::future<void>> scanTask;
 	bool breakLoop;
 } downloadQueue;
 
@@ -146,9 +151,6 @@ int Download(int id, const std::string& filename, DownloadEnum::Category cat)
 		LOG_L(L_DEBUG, "Download finished %s", filename.c_str());
 		QueueDownloadStarted(id);
 		result = DownloadStart();
-		// TODO: This works but there are errors spammed as it's trying to clear timers in the main thread, which this is not:
-		// Error: [Watchdog::ClearTimer(id)] Invalid thread 4 (_threadId=(nil))
-		archiveScanner->ScanAllDirs();
 	}
 
 	return result;
@@ -163,9 +165,19 @@ void DownloadQueue::Join()
 		thread->join();
 		spring::SafeDelete(thread);
 	}
+	WaitForScan();
 	breakLoop = false;
 }
 
+void DownloadQueue::WaitForScan()
+{
+	if (scanTask == nullptr)
+		return;
+
+	scanTask->wait();
+	scanTask = nullptr;
+}
+
 __FORCE_ALIGN_STACK__
 void DownloadQueue::Pump()
 {
@@ -184,7 +196,18 @@ void DownloadQueue::Pump()
 			LOG_L(L_DEBUG, "DOWNLOADING: %s", filename.c_str());
 			const int result = Download(id, filename, cat);
 			if (result == 0) {
-				QueueDownloadFinished(id);
+				// rescan on a pool worker so the next queued download
+				// starts while the fresh archive is being indexed; the
+				// finished-event only fires once the scanner sees it
+				// (chained via WaitForScan to keep events in order)
+				//
+				// TODO: This works but there are errors spammed as it's trying to clear timers in the main thread, which this is not:
+				// Error: [Watchdog::ClearTimer(id)] Invalid thread 4 (_threadId=(nil))
+				WaitForScan();
+				scanTask = ThreadPool::Enqueue([id]() {
+					archiveScanner->ScanAllDirs();
+					QueueDownloadFinished(id);
+				});
 			} else {
 				QueueDownloadFailed(id, result);
 			}
@@ -7,6 +7,7 @@
 #include "Rendering/Env/GrassDrawer.h"
 #include "Sim/Misc/GroundBlockingObjectMap.h"
 #include "Sim/Misc/LosHandler.h"
+#include "Sim/Misc/SmoothHeightMesh.h"
 #include "Sim/Misc/QuadField.h"
 #include "Sim/Units/Unit.h"
 #include "Sim/Units/UnitHandler.h"
@@ -178,8 +179,11 @@ void CBasicMapDamage::Explosion(const float3& pos, float strength, float radius)
 
 void CBasicMapDamage::RecalcArea(int x1, int x2, int y1, int y2)
 {
+	terrainChangeEpoch += 1;
+
 	readMap->UpdateHeightMapSynced(SRectangle(x1, y1, x2, y2));
 	featureHandler->TerrainChanged(x1, y1, x2, y2);
+	smoothGround->MapChanged(x1, y1, x2, y2);
 	{
 		SCOPED_TIMER("Sim::BasicMapDamage::Los");
 		losHandler->UpdateHeightMapSynced(SRectangle(x1, y1, x2, y2));
@@ -191,10 +195,38 @@ void CBasicMapDamage::RecalcArea(int x1, int x2, int y1, int y2)
 }
 
 
+static void MergeRecalcRect(std::vector<SRectangle>& rects, SRectangle rect)
+{
+	// grow <rect> by every rectangle it touches and keep only the
+	// union; overlapping impact clusters collapse to a single region
+	for (size_t i = 0; i < rects.size(); ) {
+		if (!rects[i].CheckOverlap(rect)) {
+			++i;
+			continue;
+		}
+
+		rect.x1 = std::min(rect.x1, rects[i].x1);
+		rect.z1 = std::min(rect.z1, rects[i].z1);
+		rect.x2 = std::max(rect.x2, rects[i].x2);
+		rect.z2 = std::max(rect.z2, rects[i].z2);
+
+		rects[i] = rects.back();
+		rects.pop_back();
+
+		// the enlarged union can now touch earlier entries
+		i = 0;
+	}
+
+	rects.push_back(rect);
+}
+
+
 void CBasicMapDamage::Update()
 {
 	SCOPED_TIMER("Sim::BasicMapDamage");
 
+	recalcRects.clear();
+
 	for (Explo& e: explosions) {
 		if (e.ttl <= 0)
 			continue;
@@ -226,10 +258,15 @@ void CBasicMapDamage::Update()
 		}
 
 		if (e.ttl == 0) {
-			RecalcArea(e.x1 - 1, e.x2 + 1, e.y1 - 1, e.y2 + 1);
+			MergeRecalcRect(recalcRects, SRectangle(e.x1 - 1, e.y1 - 1, e.x2 + 1, e.y2 + 1));
 		}
 	}
 
+	// one downstream recomputation per merged rectangle
+	for (const SRectangle& rect: recalcRects) {
+		RecalcArea(rect.x1, rect.x2, rect.z1, rect.z2);
+	}
+
 	while (!explosions.empty()) {
 		const Explo& explosion = explosions.front();
 
@@ -4,6 +4,7 @@
 #define _BASIC_MAP_DAMAGE_H
 
 #include "MapDamage.h"
+#include "System/Rectangle.h"
 
 #include <deque>
 #include <vector>
@@ -46,6 +47,11 @@ private:
 
 	std::deque<Explo> explosions;
 
+	/// dirty rectangles of all craters finishing in the current Update,
+	/// merged where they overlap so barrages trigger one RecalcArea per
+	/// impact cluster instead of one per explosion
+	std::vector<SRectangle> recalcRects;
+
 	static const unsigned int CRATER_TABLE_SIZE = 200;
 	static const unsigned int EXPLOSION_LIFETIME = 10;
 
@@ -10,6 +10,7 @@
 #include "System/Exceptions.h"
 #include "System/StringUtil.h"
 #include "System/FileSystem/VFSHandler.h"
+#include "System/Threading/ThreadPool.h"
 
 #include <cstring> // strcpy,memset
 #include <sstream>
@@ -129,9 +130,11 @@ void CMapGenerator::GenerateSMF(CVirtualArchive* archive)
 	const float heightMax = smfHeader.maxHeight;
 	const float heightMul = 65535.0f / (smfHeader.maxHeight - smfHeader.minHeight);
 
-	for (int x = 0; x < heightmapDimensions; x++) {
+	// every element is quantized independently; worker count and
+	// iteration order can not change the result
+	for_mt(0, heightmapDimensions, [&](const int x) {
 		heightmapPtr[x] = int16_t(Clamp(heightMap[x], heightMin, heightMax) - heightMin) * heightMul;
-	}
+	});
 
 	std::memset(typemapPtr.data(), 0, typemapSize);
 
@@ -24,6 +24,19 @@ protected:
 	std::vector<float>& GetHeightMap()
 	{ return heightMap; }
 
+	/**
+	 * Deterministic per-tile seed for parallel generation stages; depends
+	 * only on the global map seed and the tile coordinates, never on the
+	 * worker count or the order tiles are processed in, so the same seed
+	 * always yields the same map (and generated maps stay in sync).
+	 */
+	unsigned int GetTileSeed(int tx, int ty) const {
+		unsigned int h = static_cast<unsigned int>(setup->mapSeed);
+		h ^= static_cast<unsigned int>(tx) + 0x9e3779b9u + (h << 6) + (h >> 2);
+		h ^= static_cast<unsigned int>(ty) + 0x9e3779b9u + (h << 6) + (h >> 2);
+		return h;
+	}
+
 	virtual int2 GetGridSize() const
 	{ return int2(GetMapSize().x * CSMFReadMap::bigSquareSize, GetMapSize().y * CSMFReadMap::bigSquareSize); }
 
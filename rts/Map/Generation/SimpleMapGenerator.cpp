@@ -1,6 +1,7 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
 #include "SimpleMapGenerator.h"
+#include "System/Threading/ThreadPool.h"
 
 CSimpleMapGenerator::CSimpleMapGenerator(const CGameSetup* setup) : CMapGenerator(setup)
 {
@@ -26,11 +27,12 @@ void CSimpleMapGenerator::GenerateMap()
 
 	int2 gs = GetGridSize();
 	std::vector<float>& map = GetHeightMap();
-	for(int x = 0; x < gs.x; x++)
-	{
-		for(int y = 0; y < gs.y; y++)
-		{
+
+	// rows are independent; any stage that adds randomness must seed it
+	// from GetTileSeed so the output stays worker-count independent
+	for_mt(0, gs.y, [&](const int y) {
+		for (int x = 0; x < gs.x; x++) {
 			map[y * gs.x + x] = 50.0f;
 		}
-	}
+	});
 }
@@ -11,7 +11,12 @@
 #undef far // avoid collision with windef.h
 #undef near
 
-static inline float InterpolateHeight(float x, float z, const float* heightmap)
+#if (defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)))
+#define GROUND_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+static inline float InterpolateHeightSample(int isx, int isz, float dx, float dz, const float* heightmap)
 {
 	// NOTE:
 	// This isn't a bilinear interpolation. Instead it interpolates
@@ -29,13 +34,6 @@ static inline float InterpolateHeight(float x, float z, const float* heightmap)
 	//    |/        |
 	// BL ---------- BR
 
-	x = Clamp(x, 0.0f, float3::maxxpos) / SQUARE_SIZE;
-	z = Clamp(z, 0.0f, float3::maxzpos) / SQUARE_SIZE;
-
-	const int isx = x;
-	const int isz = z;
-	const float dx = x - isx;
-	const float dz = z - isz;
 	const int hs = isx + isz * mapDims.mapxp1;
 
 	float h = 0.0f;
@@ -63,6 +61,17 @@ static inline float InterpolateHeight(float x, float z, const float* heightmap)
 	return h;
 }
 
+static inline float InterpolateHeight(float x, float z, const float* heightmap)
+{
+	x = Clamp(x, 0.0f, float3::maxxpos) / SQUARE_SIZE;
+	z = Clamp(z, 0.0f, float3::maxzpos) / SQUARE_SIZE;
+
+	const int isx = x;
+	const int isz = z;
+
+	return (InterpolateHeightSample(isx, isz, x - isx, z - isz, heightmap));
+}
+
 
 static inline float LineGroundSquareCol(
 	const float* heightmap,
@@ -455,6 +464,83 @@ float CGround::GetOrigHeight(float x, float z)
 }
 
 
+void CGround::GetHeightsReal(const float3* positions, float* heights, size_t count, bool synced)
+{
+	const float* heightMap = readMap->GetSharedCornerHeightMap(synced);
+
+	size_t i = 0;
+
+#ifdef GROUND_USE_SSE2
+	// the interpolation gathers four scattered heightmap cells per
+	// sample which SSE2 cannot express, but the coordinate setup is
+	// done four samples at a time; every lane performs the same ops
+	// in the same order as InterpolateHeight so batched results are
+	// bit-identical to the per-position path (synced callers depend
+	// on this)
+	const __m128 minPos = _mm_setzero_ps();
+	const __m128 maxPosX = _mm_set1_ps(float3::maxxpos);
+	const __m128 maxPosZ = _mm_set1_ps(float3::maxzpos);
+	const __m128 sqSize = _mm_set1_ps(SQUARE_SIZE);
+
+	alignas(16) int isxs[4];
+	alignas(16) int iszs[4];
+	alignas(16) float dxs[4];
+	alignas(16) float dzs[4];
+
+	for (; (i + 4) <= count; i += 4) {
+		__m128 x = _mm_setr_ps(positions[i].x, positions[i + 1].x, positions[i + 2].x, positions[i + 3].x);
+		__m128 z = _mm_setr_ps(positions[i].z, positions[i + 1].z, positions[i + 2].z, positions[i + 3].z);
+
+		x = _mm_div_ps(_mm_min_ps(_mm_max_ps(x, minPos), maxPosX), sqSize);
+		z = _mm_div_ps(_mm_min_ps(_mm_max_ps(z, minPos), maxPosZ), sqSize);
+
+		const __m128i isx = _mm_cvttps_epi32(x);
+		const __m128i isz = _mm_cvttps_epi32(z);
+
+		_mm_store_si128(reinterpret_cast<__m128i*>(isxs), isx);
+		_mm_store_si128(reinterpret_cast<__m128i*>(iszs), isz);
+		_mm_store_ps(dxs, _mm_sub_ps(x, _mm_cvtepi32_ps(isx)));
+		_mm_store_ps(dzs, _mm_sub_ps(z, _mm_cvtepi32_ps(isz)));
+
+		for (int j = 0; j < 4; j++) {
+			heights[i + j] = InterpolateHeightSample(isxs[j], iszs[j], dxs[j], dzs[j], heightMap);
+		}
+	}
+#endif
+
+	for (; i < count; i++) {
+		heights[i] = InterpolateHeight(positions[i].x, positions[i].z, heightMap);
+	}
+}
+
+void CGround::GetNormals(const float3* positions, float3* normals, size_t count, bool synced)
+{
+	const float3* normalMap = readMap->GetSharedCenterNormals(synced);
+
+	// nearest-filtered lookups; the integer divisions truncate toward
+	// zero which plain shifts do not match for negative coordinates,
+	// so these stay scalar (hoisting the map pointer is the main win)
+	for (size_t i = 0; i < count; i++) {
+		const int xsquare = Clamp(int(positions[i].x) / SQUARE_SIZE, 0, mapDims.mapxm1);
+		const int zsquare = Clamp(int(positions[i].z) / SQUARE_SIZE, 0, mapDims.mapym1);
+
+		normals[i] = normalMap[xsquare + zsquare * mapDims.mapx];
+	}
+}
+
+void CGround::GetSlopes(const float3* positions, float* slopes, size_t count, bool synced)
+{
+	const float* slopeMap = readMap->GetSharedSlopeMap(synced);
+
+	for (size_t i = 0; i < count; i++) {
+		const int xhsquare = Clamp(int(positions[i].x) / (2 * SQUARE_SIZE), 0, mapDims.hmapx - 1);
+		const int zhsquare = Clamp(int(positions[i].z) / (2 * SQUARE_SIZE), 0, mapDims.hmapy - 1);
+
+		slopes[i] = slopeMap[xhsquare + zhsquare * mapDims.hmapx];
+	}
+}
+
+
 const float3& CGround::GetNormal(float x, float z, bool synced)
 {
 	const int xsquare = Clamp(int(x) / SQUARE_SIZE, 0, mapDims.mapxm1);
@@ -35,6 +35,14 @@ public:
 	static float3 GetSmoothNormal(const float3& p, bool synced = true) { return (GetSmoothNormal(p.x, p.z, synced)); }
 
 
+	// batch variants; sample <count> positions in one call and fill the
+	// output arrays in input order (hot loops pay the heightmap lookup
+	// and coordinate setup once per call instead of once per sample)
+	static void GetHeightsReal(const float3* positions, float* heights, size_t count, bool synced = true);
+	static void GetNormals(const float3* positions, float3* normals, size_t count, bool synced = true);
+	static void GetSlopes(const float3* positions, float* slopes, size_t count, bool synced = true);
+
+
 	static float LineGroundCol(float3 from, float3 to, bool synced = true);
 	static float LineGroundCol(const float3 pos, const float3 dir, float len, bool synced = true);
 	static float LinePlaneCol(const float3 pos, const float3 dir, float len, float hgt);
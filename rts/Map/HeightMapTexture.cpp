@@ -87,21 +87,32 @@ void HeightMapTexture::UnsyncedHeightMapUpdate(const SRectangle& rect)
 	const int sizeX = rect.x2 - rect.x1 + 1;
 	const int sizeZ = rect.z2 - rect.z1 + 1;
 
-	pbo.Bind();
-	pbo.New(sizeX * sizeZ * sizeof(float));
+	const auto copyRows = [&](unsigned char* mappedBuf) {
+		float* buf = (float*) mappedBuf;
 
-	{
-		float* buf = (float*) pbo.MapBuffer();
 		for (int z = 0; z < sizeZ; z++) {
 			const void* src = heightMap + rect.x1 + (z + rect.z1) * xSize;
 			      void* dst = buf + z * sizeX;
 
 			memcpy(dst, src, sizeX * sizeof(float));
 		}
+	};
+
+	// fenced upload out of a PBO ring; the driver pulls the pixels
+	// behind the frame instead of stalling the render thread here
+	glBindTexture(GL_TEXTURE_2D, texID);
+
+	if (pixelUpload.Upload(rect.x1, rect.z1, sizeX, sizeZ, GL_LUMINANCE, GL_FLOAT, sizeof(float), copyRows))
+		return;
+
+	pbo.Bind();
+	pbo.New(sizeX * sizeZ * sizeof(float));
+
+	{
+		copyRows(pbo.MapBuffer());
 		pbo.UnmapBuffer();
 	}
 
-	glBindTexture(GL_TEXTURE_2D, texID);
 	glTexSubImage2D(GL_TEXTURE_2D, 0,
 		rect.x1, rect.z1, sizeX, sizeZ,
 		GL_LUMINANCE, GL_FLOAT, pbo.GetPtr());
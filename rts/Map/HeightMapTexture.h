@@ -5,6 +5,7 @@
 
 #include "Rendering/GL/myGL.h"
 #include "Rendering/GL/PBO.h"
+#include "Rendering/GL/PixelUpload.h"
 #include "System/EventClient.h"
 
 class HeightMapTexture : public CEventClient
@@ -35,6 +36,9 @@ class HeightMapTexture : public CEventClient
 		GLuint texID;
 		int xSize;
 		int ySize;
+
+		// fenced async uploads; pbo is the synchronous fallback
+		CPixelUpload pixelUpload;
 		PBO pbo;
 };
 
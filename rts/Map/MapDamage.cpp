@@ -11,7 +11,8 @@ IMapDamage* mapDamage = nullptr;
 
 IMapDamage::IMapDamage():
 	disabled(true),
-	mapHardness(0.0f)
+	mapHardness(0.0f),
+	terrainChangeEpoch(0)
 {
 }
 
@@ -20,6 +20,11 @@ public:
 
 	bool disabled;
 	float mapHardness;
+
+	/// bumped on every synced heightmap recalculation, lets cached
+	/// terrain-dependent results (e.g. line-of-fire verdicts) detect
+	/// deformation without tracking the affected rectangles
+	unsigned int terrainChangeEpoch;
 };
 
 extern IMapDamage* mapDamage;
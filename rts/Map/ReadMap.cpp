@@ -30,6 +30,11 @@
 #include "Sim/Misc/LosHandler.h"
 #endif
 
+#if (defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)))
+	#define READMAP_USE_SSE2 1
+	#include <emmintrin.h>
+#endif
+
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
@@ -522,12 +527,72 @@ void CReadMap::UpdateHeightMapSynced(SRectangle hmRect, bool initialize)
 }
 
 
+#ifdef READMAP_USE_SSE2
+// lane-wise fastmath::isqrt2_nosse (i.e. math::isqrt); the arithmetic is
+// replicated operation for operation so the vectorized kernels below stay
+// bit-identical to the scalar float3 path they shadow
+static inline __m128 mm_isqrt2_ps(__m128 x)
+{
+	const __m128 xh = _mm_mul_ps(_mm_set1_ps(0.5f), x);
+
+	__m128 y = _mm_castsi128_ps(_mm_sub_epi32(_mm_set1_epi32(0x5f375a86), _mm_srli_epi32(_mm_castps_si128(x), 1)));
+	y = _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(xh, _mm_mul_ps(y, y))));
+	y = _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(xh, _mm_mul_ps(y, y))));
+	return y;
+}
+
+// float3::SafeNormalize on four vectors in SoA form; below-epsilon
+// lanes are multiplied by 1.0f which leaves them bitwise untouched
+static inline void mm_safe_normalize_ps(__m128& x, __m128& y, __m128& z)
+{
+	const __m128 sql = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+	const __m128 msk = _mm_cmpgt_ps(sql, _mm_set1_ps(float3::nrm_eps()));
+	const __m128 mul = _mm_or_ps(_mm_and_ps(msk, mm_isqrt2_ps(sql)), _mm_andnot_ps(msk, _mm_set1_ps(1.0f)));
+
+	x = _mm_mul_ps(x, mul);
+	y = _mm_mul_ps(y, mul);
+	z = _mm_mul_ps(z, mul);
+}
+
+static inline void mm_store_float3s(__m128 x, __m128 y, __m128 z, float3* dst, int stride)
+{
+	alignas(16) float xs[4];
+	alignas(16) float ys[4];
+	alignas(16) float zs[4];
+
+	_mm_store_ps(xs, x);
+	_mm_store_ps(ys, y);
+	_mm_store_ps(zs, z);
+
+	for (int i = 0; i < 4; i++) {
+		dst[i * stride] = float3(xs[i], ys[i], zs[i]);
+	}
+}
+#endif
+
+
 void CReadMap::UpdateCenterHeightmap(const SRectangle& rect, bool initialize)
 {
 	const float* heightmapSynced = GetCornerHeightMapSynced();
 
 	for (int y = rect.z1; y <= rect.z2; y++) {
-		for (int x = rect.x1; x <= rect.x2; x++) {
+		int x = rect.x1;
+
+		#ifdef READMAP_USE_SSE2
+		for (; x + 3 <= rect.x2; x += 4) {
+			const int idxTL = (y    ) * mapDims.mapxp1 + x;
+			const int idxBL = (y + 1) * mapDims.mapxp1 + x;
+
+			__m128 sum = _mm_loadu_ps(&heightmapSynced[idxTL]);
+			sum = _mm_add_ps(sum, _mm_loadu_ps(&heightmapSynced[idxTL + 1]));
+			sum = _mm_add_ps(sum, _mm_loadu_ps(&heightmapSynced[idxBL]));
+			sum = _mm_add_ps(sum, _mm_loadu_ps(&heightmapSynced[idxBL + 1]));
+
+			_mm_storeu_ps(&centerHeightMap[y * mapDims.mapx + x], _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+		}
+		#endif
+
+		for (; x <= rect.x2; x++) {
 			const int idxTL = (y    ) * mapDims.mapxp1 + x;
 			const int idxTR = (y    ) * mapDims.mapxp1 + x + 1;
 			const int idxBL = (y + 1) * mapDims.mapxp1 + x;
@@ -583,7 +648,68 @@ void CReadMap::UpdateFaceNormals(const SRectangle& rect, bool initialize)
 		float3 fnTL;
 		float3 fnBR;
 
-		for (int x = x1; x <= x2; x++) {
+		int x = x1;
+
+		#ifdef READMAP_USE_SSE2
+		// four squares at a time; every operation matches the scalar tail
+		// below bit for bit, so the synced results do not depend on how a
+		// given update rectangle gets chopped up
+		for (; x + 3 <= x2; x += 4) {
+			const int idxTL = (y    ) * mapDims.mapxp1 + x;
+			const int idxBL = (y + 1) * mapDims.mapxp1 + x;
+			const int sqIdx = y * mapDims.mapx + x;
+
+			const __m128 hTL = _mm_loadu_ps(&heightmapSynced[idxTL    ]);
+			const __m128 hTR = _mm_loadu_ps(&heightmapSynced[idxTL + 1]);
+			const __m128 hBL = _mm_loadu_ps(&heightmapSynced[idxBL    ]);
+			const __m128 hBR = _mm_loadu_ps(&heightmapSynced[idxBL + 1]);
+
+			const __m128 sqSz = _mm_set1_ps(SQUARE_SIZE);
+			const __m128 sign = _mm_set1_ps(-0.0f);
+
+			// -(hTR - hTL) and -(hBL - hTL), as exact sign-flips
+			__m128 tlx = _mm_xor_ps(_mm_sub_ps(hTR, hTL), sign);
+			__m128 tly = sqSz;
+			__m128 tlz = _mm_xor_ps(_mm_sub_ps(hBL, hTL), sign);
+
+			__m128 brx = _mm_sub_ps(hBL, hBR);
+			__m128 bry = sqSz;
+			__m128 brz = _mm_sub_ps(hTR, hBR);
+
+			mm_safe_normalize_ps(tlx, tly, tlz);
+			mm_safe_normalize_ps(brx, bry, brz);
+
+			__m128 cx = _mm_add_ps(tlx, brx);
+			__m128 cy = _mm_add_ps(tly, bry);
+			__m128 cz = _mm_add_ps(tlz, brz);
+
+			// Normalize2D() re-sums the already normalized faces and
+			// zeroes y, so the unnormalized sum can be reused for it
+			__m128 c2x = cx;
+			__m128 c2y = _mm_setzero_ps();
+			__m128 c2z = cz;
+
+			mm_safe_normalize_ps(cx, cy, cz);
+			mm_safe_normalize_ps(c2x, c2y, c2z);
+
+			mm_store_float3s(tlx, tly, tlz, &faceNormalsSynced[sqIdx * 2    ], 2);
+			mm_store_float3s(brx, bry, brz, &faceNormalsSynced[sqIdx * 2 + 1], 2);
+			mm_store_float3s( cx,  cy,  cz, &centerNormalsSynced[sqIdx], 1);
+			mm_store_float3s(c2x, c2y, c2z, &centerNormals2D[sqIdx], 1);
+
+			#ifdef USE_UNSYNCED_HEIGHTMAP
+			if (initialize) {
+				for (int i = 0; i < 4; i++) {
+					faceNormalsUnsynced[(sqIdx + i) * 2    ] = faceNormalsSynced[(sqIdx + i) * 2    ];
+					faceNormalsUnsynced[(sqIdx + i) * 2 + 1] = faceNormalsSynced[(sqIdx + i) * 2 + 1];
+					centerNormalsUnsynced[sqIdx + i] = centerNormalsSynced[sqIdx + i];
+				}
+			}
+			#endif
+		}
+		#endif
+
+		for (; x <= x2; x++) {
 			const int idxTL = (y    ) * mapDims.mapxp1 + x; // TL
 			const int idxBL = (y + 1) * mapDims.mapxp1 + x; // BL
 
@@ -35,12 +35,21 @@ LOG_REGISTER_SECTION_GLOBAL(LOG_SECTION_ROAM)
 
 bool CRoamMeshDrawer::forceTessellate[2] = {false, false};
 
+// number of 3x3 interference sub-blocks a retessellation is split into
+// (see Tessellate) and how many of them may run per frame; the latter
+// spreads the cost of a full retessellation (eg. after a camera jump)
+// over ceil(9/3)=3 frames while the previously uploaded mesh keeps
+// being drawn
+static constexpr int NUM_TESS_BLOCKS = 9;
+static constexpr int TESS_BLOCKS_PER_FRAME = 3;
+
 
 
 CRoamMeshDrawer::CRoamMeshDrawer(CSMFGroundDrawer* gd)
 	: CEventClient("[CRoamMeshDrawer]", 271989, false)
 	, smfGroundDrawer(gd)
 	, lastGroundDetail{0, 0}
+	, pendingTessBlock{-1, -1}
 {
 	eventHandler.AddClient(this);
 
@@ -167,14 +176,44 @@ void CRoamMeshDrawer::Update()
 #endif
 	retessellate |= (lastGroundDetail[shadowPass] != smfGroundDrawer->GetGroundDetail());
 
-	if (!retessellate)
+	if (retessellate) {
+		if (pendingTessBlock[shadowPass] < 0) {
+			// start an incremental retessellation round; the mesh uploaded
+			// by the previous round keeps being drawn until it completes
+			Reset(shadowPass);
+			pendingTessBlock[shadowPass] = 0;
+			forceTessellate[shadowPass] = false;
+		} else {
+			// a round is already in flight; queue a follow-up instead of
+			// restarting, otherwise a continuously panning camera would
+			// never let one finish
+			forceTessellate[shadowPass] = true;
+		}
+	}
+
+	if (pendingTessBlock[shadowPass] < 0)
 		return;
 
 	{
 		//SCOPED_TIMER("ROAM::Tessellate");
 
-		Reset(shadowPass);
-		forceTessellate[shadowPass] = Tessellate(patchMeshGrid[shadowPass], cam, smfGroundDrawer->GetGroundDetail(), shadowPass);
+		// the very first round (nothing uploaded yet) can not amortize,
+		// drawing would show holes until it completes
+		const int blockBeg = pendingTessBlock[shadowPass];
+		const int blockEnd = (lastGroundDetail[shadowPass] == 0)? NUM_TESS_BLOCKS: std::min(blockBeg + TESS_BLOCKS_PER_FRAME, NUM_TESS_BLOCKS);
+
+		if (Tessellate(patchMeshGrid[shadowPass], cam, smfGroundDrawer->GetGroundDetail(), shadowPass, blockBeg, blockEnd)) {
+			// a node pool ran out; upload the partial result below and
+			// retry next frame (ResetAll will have grown the pools)
+			forceTessellate[shadowPass] = true;
+			pendingTessBlock[shadowPass] = -1;
+		} else {
+			// budget spent, draw the previous mesh for another frame
+			if ((pendingTessBlock[shadowPass] = blockEnd) < NUM_TESS_BLOCKS)
+				return;
+
+			pendingTessBlock[shadowPass] = -1;
+		}
 	}
 
 	{
@@ -310,7 +349,7 @@ void CRoamMeshDrawer::Reset(bool shadowPass)
 
 
 
-bool CRoamMeshDrawer::Tessellate(std::vector<Patch>& patches, const CCamera* cam, int viewRadius, bool shadowPass)
+bool CRoamMeshDrawer::Tessellate(std::vector<Patch>& patches, const CCamera* cam, int viewRadius, bool shadowPass, int blockBeg, int blockEnd)
 {
 	// create an approximate tessellated mesh of the landscape
 	// hint: threading just helps a little with huge cpu usage in retessellation, still better than nothing
@@ -327,7 +366,7 @@ bool CRoamMeshDrawer::Tessellate(std::vector<Patch>& patches, const CCamera* cam
 	// area (which is 2 patches), so they don't conflict with each other.
 	bool forceTess = false;
 
-	for (int idx = 0; idx < 9; ++idx) {
+	for (int idx = blockBeg; idx < blockEnd; ++idx) {
 		for_mt(0, patches.size(), [&](const int i) {
 			Patch* p = &patches[i];
 
@@ -60,7 +60,7 @@ public:
 
 private:
 	void Reset(bool shadowPass);
-	bool Tessellate(std::vector<Patch>& patches, const CCamera* cam, int viewRadius, bool shadowPass);
+	bool Tessellate(std::vector<Patch>& patches, const CCamera* cam, int viewRadius, bool shadowPass, int blockBeg, int blockEnd);
 
 private:
 	CSMFGroundDrawer* smfGroundDrawer;
@@ -69,6 +69,10 @@ private:
 	int numPatchesY;
 	int lastGroundDetail[MESH_COUNT];
 
+	//< next 3x3 sub-block of an in-flight incremental retessellation
+	//< round (see Tessellate), or -1 when no round is in progress
+	int pendingTessBlock[MESH_COUNT];
+
 	float3 lastCamPos[MESH_COUNT];
 
 	// [1] is used for the shadow pass, [0] is used for all other passes
@@ -506,6 +506,9 @@ void CSMFGroundDrawer::Update()
 	if (readMap->HasOnlyVoidWater())
 		return;
 
+	// the heightmap texture has the frame's deformations by now
+	smfMap->FlushShadingTexDirtyRects();
+
 	groundTextures->DrawUpdate();
 	// done by DrawMesh; needs to know the actual draw-pass
 	// meshDrawer->Update();
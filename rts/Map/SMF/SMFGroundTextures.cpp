@@ -1,6 +1,7 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <cstdio>
@@ -19,12 +20,17 @@
 #include "Game/Game.h"
 #include "Game/GameSetup.h"
 #include "Game/LoadScreen.h"
+#include "System/CRC.h"
 #include "System/Exceptions.h"
 #include "System/FastMath.h"
 #include "System/Log/ILog.h"
+#include "System/StringUtil.h"
 #include "System/TimeProfiler.h"
+#include "System/FileSystem/DataDirsAccess.h"
 #include "System/FileSystem/FileHandler.h"
+#include "System/FileSystem/FileQueryFlags.h"
 #include "System/FileSystem/FileSystem.h"
+#include "System/FileSystem/MappedFile.h"
 #include "System/Platform/Watchdog.h"
 #include "System/Threading/ThreadPool.h" // for_mt
 
@@ -46,6 +52,10 @@ std::vector<CSMFGroundTextures::GroundSquare> CSMFGroundTextures::squares;
 std::vector<int> CSMFGroundTextures::tileMap;
 std::vector<char> CSMFGroundTextures::tiles;
 
+MappedFile CSMFGroundTextures::tilesMap;
+char* CSMFGroundTextures::tileData = nullptr;
+size_t CSMFGroundTextures::tileDataSize = 0;
+
 std::vector<float> CSMFGroundTextures::heightMaxima;
 std::vector<float> CSMFGroundTextures::heightMinima;
 std::vector<float> CSMFGroundTextures::stretchFactors;
@@ -62,7 +72,10 @@ CSMFGroundTextures::GroundSquare::~GroundSquare()
 
 
 
-CSMFGroundTextures::CSMFGroundTextures(CSMFReadMap* rm): smfMap(rm)
+CSMFGroundTextures::CSMFGroundTextures(CSMFReadMap* rm)
+	: smfMap(rm)
+	, currPBO(0)
+	, lastCamPos(ZeroVector)
 {
 	LoadTiles(smfMap->GetFile());
 	LoadSquareTextures(3);
@@ -89,10 +102,16 @@ void CSMFGroundTextures::LoadTiles(CSMFMapFile& file)
 		throw content_error("Error loading map: count of tiles is 0.");
 	}
 
+	const size_t tilesSize = tileHeader.numTiles * size_t(SMALL_TILE_SIZE);
+
 	tileMap.clear();
 	tileMap.resize(smfMap->tileCount);
+	// only allocated if some payload actually has to be copied
 	tiles.clear();
-	tiles.resize(tileHeader.numTiles * SMALL_TILE_SIZE);
+
+	tilesMap.Close();
+	tileData = nullptr;
+	tileDataSize = 0;
 	squares.clear();
 	squares.resize(smfMap->numBigTexX * smfMap->numBigTexY);
 
@@ -141,6 +160,9 @@ void CSMFGroundTextures::LoadTiles(CSMFMapFile& file)
 				"(ALL %d MISSING TILES WILL BE MADE RED)",
 				smtFilePath.c_str(), numSmallTiles);
 
+			if (tiles.empty())
+				tiles.resize(tilesSize);
+
 			memset(&tiles[curTile * SMALL_TILE_SIZE], 0xaa, numSmallTiles * SMALL_TILE_SIZE);
 			curTile += numSmallTiles;
 			continue;
@@ -155,12 +177,38 @@ void CSMFGroundTextures::LoadTiles(CSMFMapFile& file)
 			throw content_error(t);
 		}
 
-		for (int b = 0; b < numSmallTiles; ++b) {
-			tileFile.Read(&tiles[curTile * SMALL_TILE_SIZE], SMALL_TILE_SIZE);
-			curTile++;
+		if (tileHeader.numTileFiles == 1) {
+			// single tile-file covering every tile; reference its payload
+			// through a copy-on-write mapping instead of copying it, so
+			// the clean pages are shared between every engine process on
+			// the host (ETC1 recompression faults in private copies on
+			// write and never dirties the file)
+			const size_t payloadSize = numSmallTiles * size_t(SMALL_TILE_SIZE);
+
+			if (tilesMap.Open(dataDirsAccess.LocateFile(smtFilePath), true) && tilesMap.GetSize() >= (sizeof(TileFileHeader) + payloadSize)) {
+				curTile += numSmallTiles;
+				continue;
+			}
+
+			// mapping failed (eg. archived .smt), fall through and copy
+			tilesMap.Close();
 		}
+
+		if (tiles.empty())
+			tiles.resize(tilesSize);
+
+		tileFile.Read(&tiles[curTile * SMALL_TILE_SIZE], numSmallTiles * SMALL_TILE_SIZE);
+		curTile += numSmallTiles;
 	}
 
+	if (tilesMap.IsOpen()) {
+		tileData = reinterpret_cast<char*>(tilesMap.GetData()) + sizeof(TileFileHeader);
+	} else {
+		tileData = tiles.data();
+	}
+
+	tileDataSize = tilesSize;
+
 	ifs->Read(&tileMap[0], smfMap->tileCount * sizeof(int));
 
 	for (int i = 0; i < smfMap->tileCount; i++) {
@@ -259,6 +307,9 @@ void CSMFGroundTextures::ConvolveHeightMap(const int mapWidth, const int mipLeve
 }
 
 #if defined(USE_LIBSQUISH) && !defined(HEADLESS) && defined(GLEW_ARB_ES3_compatibility)
+// bump whenever the encoder or pack parameters change
+static const unsigned int ETC1CACHE_VERSION = 1;
+
 // Not all FOSS drivers support S3TC, use ETC1 for those if possible
 bool CSMFGroundTextures::RecompressTilesIfNeeded()
 {
@@ -274,6 +325,29 @@ bool CSMFGroundTextures::RecompressTilesIfNeeded()
 	// note 2: Nvidia supports ETC but preprocesses the texture (on the CPU) each upload = slow -> makes no sense to add it as another map compression format
 	// note 3: for both DXT1 & ETC1/2 blocksize is 8 bytes per 4x4 pixel block -> perfect for us :)
 
+	// recompressed tiles are cached on disk, keyed by a checksum over
+	// the DXT1 input so edited maps self-invalidate; the name embeds
+	// the hash and ETC1 output is same-size as input, so an existing
+	// file of matching size needs no further validation
+	CRC crc;
+	crc.Update(ETC1CACHE_VERSION);
+	crc.Update(tileData, tileDataSize);
+
+	const std::string hashHexString = IntToString(crc.GetDigest(), "%x");
+	const std::string cacheFileName = FileSystem::GetCacheDir() + "/maps/" + FileSystem::GetBasename(gameSetup->MapFile()) + ".etc1-" + hashHexString + ".bin";
+
+	if (FileSystem::FileExists(cacheFileName)) {
+		MappedFile cacheFileMap;
+
+		if (cacheFileMap.Open(dataDirsAccess.LocateFile(cacheFileName), false) && cacheFileMap.GetSize() == tileDataSize) {
+			loadscreen->SetLoadMessage("Loading Recompressed Map Tiles");
+			memcpy(tileData, cacheFileMap.GetData(), tileDataSize);
+			return true;
+		}
+
+		FileSystem::Remove(cacheFileName);
+	}
+
 	loadscreen->SetLoadMessage("Recompressing Map Tiles with ETC1");
 	Watchdog::ClearTimer(WDT_MAIN);
 
@@ -281,12 +355,21 @@ bool CSMFGroundTextures::RecompressTilesIfNeeded()
 	rg_etc1::etc1_pack_params pack_params;
 	pack_params.m_quality = rg_etc1::cLowQuality; // must be low, all others take _ages_ to process
 
-	for_mt(0, tiles.size() / 8, [&](const int i) {
+	for_mt(0, tileDataSize / 8, [&](const int i) {
 		squish::u8 rgba[64]; // 4x4 pixels * 4 * 1byte channels = 64byte
-		squish::Decompress(rgba, &tiles[i * 8], squish::kDxt1);
-		rg_etc1::pack_etc1_block(&tiles[i * 8], (const unsigned int*)rgba, pack_params);
+		squish::Decompress(rgba, &tileData[i * 8], squish::kDxt1);
+		rg_etc1::pack_etc1_block(&tileData[i * 8], (const unsigned int*)rgba, pack_params);
 	});
 
+	if (FileSystem::CreateDirectory(FileSystem::GetCacheDir() + "/maps/")) {
+		FILE* file = fopen(dataDirsAccess.LocateFile(cacheFileName, FileQueryFlags::WRITE).c_str(), "wb");
+
+		if (file != nullptr) {
+			fwrite(tileData, 1, tileDataSize, file);
+			fclose(file);
+		}
+	}
+
 	return true;
 }
 #endif
@@ -313,13 +396,37 @@ void CSMFGroundTextures::DrawUpdate()
 {
 	const CCamera* cam = CCamera::GetActiveCamera();
 
+	// spreading texture swaps over frames keeps scrolling smooth on maps
+	// with many big-tex squares; deferred squares simply keep drawing the
+	// texture of their previous mip-level and get re-examined next frame
+	static const unsigned int MAX_SQUARE_LOADS_PER_FRAME = 4;
+	// priority offsets; closest upgrades first, then detail reductions,
+	// then evictions of long-invisible squares
+	static const float PRIORITY_DOWNGRADE = 1.0f * 1024 * 1024;
+	static const float PRIORITY_UNLOAD    = 2.0f * 1024 * 1024;
+
+	struct SquareLoadRequest {
+		float priority;
+		int x, y, level;
+	};
+	static std::vector<SquareLoadRequest> loadRequests;
+
+	loadRequests.clear();
+
+	// select mip-levels against a position extrapolated a few frames along
+	// the camera's movement, so squares being scrolled towards reach their
+	// wanted detail just before they dominate the view (read-ahead)
+	const float3 camPos = cam->GetPos();
+	const float3 selPos = camPos + (camPos - lastCamPos) * 15.0f;
+	lastCamPos = camPos;
+
 	// screen-diagonal number of pixels
 	const float vsxSq = globalRendering->viewSizeX * globalRendering->viewSizeX;
 	const float vsySq = globalRendering->viewSizeY * globalRendering->viewSizeY;
 	const float vdiag = fastmath::apxsqrt(vsxSq + vsySq);
 
 	for (int y = 0; y < smfMap->numBigTexY; ++y) {
-		float dz = cam->GetPos().z - (y * smfMap->bigSquareSize * SQUARE_SIZE);
+		float dz = selPos.z - (y * smfMap->bigSquareSize * SQUARE_SIZE);
 		dz -= (SQUARE_SIZE << 6);
 		dz = std::max(0.0f, float(math::fabs(dz) - (SQUARE_SIZE << 6)));
 
@@ -335,19 +442,19 @@ void CSMFGroundTextures::DrawUpdate()
 				if ((square->GetMipLevel() < 3) && ((globalRendering->drawFrame - square->GetDrawFrame()) > 120)) {
 					// `unload` texture (load lowest mip-map) if
 					// the square wasn't visible for 120 vframes
-					LoadSquareTexture(x, y, 3);
+					loadRequests.push_back({PRIORITY_UNLOAD, x, y, 3});
 				}
 				continue;
 			}
 
-			float dx = cam->GetPos().x - (x * smfMap->bigSquareSize * SQUARE_SIZE);
+			float dx = selPos.x - (x * smfMap->bigSquareSize * SQUARE_SIZE);
 			dx -= (SQUARE_SIZE << 6);
 			dx = std::max(0.0f, float(math::fabs(dx) - (SQUARE_SIZE << 6)));
 
 			const float hAvg =
 				(heightMaxima[y * smfMap->numBigTexX + x] +
 				 heightMinima[y * smfMap->numBigTexX + x]) / 2.0f;
-			const float dy = std::max(cam->GetPos().y - hAvg, 0.0f);
+			const float dy = std::max(selPos.y - hAvg, 0.0f);
 			const float dist = fastmath::apxsqrt(dx * dx + dy * dy + dz * dz);
 
 			// we work under the following assumptions:
@@ -391,10 +498,20 @@ void CSMFGroundTextures::DrawUpdate()
 				wantedLevel--;
 
 			if (square->GetMipLevel() != wantedLevel) {
-				LoadSquareTexture(x, y, wantedLevel);
+				const float penalty = (wantedLevel > int(square->GetMipLevel()))? PRIORITY_DOWNGRADE: 0.0f;
+				loadRequests.push_back({dist + penalty, x, y, wantedLevel});
 			}
 		}
 	}
+
+	std::sort(loadRequests.begin(), loadRequests.end(), [](const SquareLoadRequest& a, const SquareLoadRequest& b) {
+		return (a.priority < b.priority);
+	});
+
+	for (unsigned int i = 0, n = std::min(loadRequests.size(), size_t(MAX_SQUARE_LOADS_PER_FRAME)); i < n; i++) {
+		const SquareLoadRequest& req = loadRequests[i];
+		LoadSquareTexture(req.x, req.y, req.level);
+	}
 }
 
 
@@ -429,6 +546,8 @@ bool CSMFGroundTextures::GetSquareLuaTexture(int texSquareX, int texSquareY, int
 	const int mipSqSize = smfMap->bigTexSize >> texMipLevel;
 	const int numSqBytes = (mipSqSize * mipSqSize) / 2;
 
+	PBO& pbo = pbos[currPBO = (currPBO + 1) % 2];
+
 	pbo.Bind();
 	pbo.New(numSqBytes);
 	ExtractSquareTiles(texSquareX, texSquareY, texMipLevel, (GLint*) pbo.MapBuffer());
@@ -461,13 +580,15 @@ void CSMFGroundTextures::ExtractSquareTiles(
 
 	// extract all 32x32 sub-blocks (tiles) in the 128x128 square
 	// (each 32x32 tile covers a (bigSquareSize = 32 * tileScale) x
-	// (bigSquareSize = 32 * tileScale) heightmap chunk)
-	for (int y1 = 0; y1 < BLOCK_SIZE; y1++) {
+	// (bigSquareSize = 32 * tileScale) heightmap chunk); the rows
+	// write disjoint regions of the mapped PBO, so they can be
+	// gathered in parallel
+	for_mt(0, BLOCK_SIZE, [&](const int y1) {
 		for (int x1 = 0; x1 < BLOCK_SIZE; x1++) {
 			const int tileX = tileOffsetX + x1;
 			const int tileY = tileOffsetY + y1;
 			const int tileIdx = tileMap[tileY * smfMap->tileMapSizeX + tileX];
-			const GLint* tile = (GLint*) &tiles[tileIdx * SMALL_TILE_SIZE + mipOffset];
+			const GLint* tile = (GLint*) &tileData[tileIdx * SMALL_TILE_SIZE + mipOffset];
 
 			const int doff = (x1 * numBlocks) + (y1 * numBlocks * numBlocks) * BLOCK_SIZE;
 
@@ -479,7 +600,7 @@ void CSMFGroundTextures::ExtractSquareTiles(
 				memcpy(dbuf, sbuf, numBlocks * 2 * sizeof(GLint));
 			}
 		}
-	}
+	});
 }
 
 void CSMFGroundTextures::LoadSquareTexture(int x, int y, int level)
@@ -493,6 +614,8 @@ void CSMFGroundTextures::LoadSquareTexture(int x, int y, int level)
 	square->SetMipLevel(level);
 	assert(!square->HasLuaTexture());
 
+	PBO& pbo = pbos[currPBO = (currPBO + 1) % 2];
+
 	pbo.Bind();
 	pbo.New(numSqBytes);
 	ExtractSquareTiles(x, y, level, (GLint*) pbo.MapBuffer());
@@ -7,6 +7,8 @@
 
 #include "Map/BaseGroundTextures.h"
 #include "Rendering/GL/PBO.h"
+#include "System/float3.h"
+#include "System/FileSystem/MappedFile.h"
 
 class CSMFMapFile;
 class CSMFReadMap;
@@ -67,13 +69,26 @@ private:
 	static std::vector<int> tileMap;
 	static std::vector<char> tiles;
 
+	// DXT1 tile payload; points into <tilesMap> when the (single)
+	// tile-file could be mapped copy-on-write, into <tiles> when it
+	// had to be copied out of an archive or several files (LoadTiles)
+	static MappedFile tilesMap;
+	static char* tileData;
+	static size_t tileDataSize;
+
 	// FIXME? these are not updated at runtime
 	static std::vector<float> heightMaxima;
 	static std::vector<float> heightMinima;
 	static std::vector<float> stretchFactors;
 
-	// use Pixel Buffer Objects for async. uploading (DMA)
-	PBO pbo;
+	// use Pixel Buffer Objects for async. uploading (DMA); double-buffered
+	// so tile extraction into one PBO overlaps the still in-flight upload
+	// from the other
+	PBO pbos[2];
+	unsigned int currPBO;
+
+	// previous-frame camera position, used to predict scrolling direction
+	float3 lastCamPos;
 
 	int tileTexFormat;
 };
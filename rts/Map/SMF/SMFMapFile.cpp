@@ -74,19 +74,26 @@ void CSMFMapFile::ReadHeightmap(float* sHeightMap, float* uHeightMap, float base
 {
 	const int hmx = header.mapx + 1;
 	const int hmy = header.mapy + 1;
-	unsigned short* temphm = new unsigned short[hmx * hmy];
 
-	ifs.Seek(header.heightmapPtr);
-	ifs.Read(temphm, hmx * hmy * 2);
+	// parse straight out of the file view (the mapping for on-disk
+	// maps, the VFS buffer for archived ones), no intermediate copy
+	size_t viewSize = 0;
+	const std::uint8_t* view = ifs.GetView(viewSize);
+
+	if (view == nullptr || viewSize < (header.heightmapPtr + hmx * hmy * sizeof(unsigned short)))
+		throw content_error("Couldn't read heightmap from map file");
+
+	const std::uint8_t* hmData = view + header.heightmapPtr;
 
 	for (int y = 0; y < hmx * hmy; ++y) {
-		const float h = base + swabWord(temphm[y]) * mod;
+		unsigned short rawHeight;
+		memcpy(&rawHeight, hmData + y * sizeof(rawHeight), sizeof(rawHeight));
+
+		const float h = base + swabWord(rawHeight) * mod;
 
 		if (sHeightMap != NULL) { sHeightMap[y] = h; }
 		if (uHeightMap != NULL) { uHeightMap[y] = h; }
 	}
-
-	delete[] temphm;
 }
 
 
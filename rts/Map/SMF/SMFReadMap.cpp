@@ -6,6 +6,7 @@
 #include "SMFGroundTextures.h"
 #include "SMFGroundDrawer.h"
 #include "SMFFormat.h"
+#include "Map/HeightMapTexture.h"
 #include "Map/MapInfo.h"
 #include "Game/Camera.h"
 #include "Game/LoadScreen.h"
@@ -15,12 +16,15 @@
 #include "Rendering/Env/WaterRendering.h"
 #include "Rendering/GL/myGL.h"
 #include "Rendering/Map/InfoTexture/IInfoTextureHandler.h"
+#include "Rendering/Shaders/ShaderHandler.h"
+#include "Rendering/Shaders/Shader.h"
 #include "Rendering/Textures/Bitmap.h"
 #include "System/bitops.h"
 #include "System/Config/ConfigHandler.h"
 #include "System/EventHandler.h"
 #include "System/Exceptions.h"
 #include "System/FileSystem/FileHandler.h"
+#include "System/Log/ILog.h"
 #include "System/Threading/ThreadPool.h"
 #include "System/myMath.h"
 #include "System/SafeUtil.h"
@@ -47,6 +51,8 @@ CSMFReadMap::CSMFReadMap(std::string mapname)
 	: CEventClient("[CSMFReadMap]", 271950, false)
 	, file(mapname)
 	, groundDrawer(NULL)
+	, shadingTexShader(nullptr)
+	, waterColorsTex(0)
 {
 	loadscreen->SetLoadMessage("Loading SMF");
 	eventHandler.AddClient(this);
@@ -84,6 +90,17 @@ CSMFReadMap::CSMFReadMap(std::string mapname)
 }
 
 
+CSMFReadMap::~CSMFReadMap()
+{
+	if (shadingTexShader != nullptr) {
+		shaderHandler->ReleaseProgramObjects("[SMFReadMap]");
+		shadingTexShader = nullptr;
+	}
+
+	glDeleteTextures(1, &waterColorsTex);
+}
+
+
 
 void CSMFReadMap::ParseHeader()
 {
@@ -323,6 +340,51 @@ void CSMFReadMap::CreateShadingTex()
 	shadingTexBuffer.resize(mapDims.mapx * mapDims.mapy * 4, 0);
 	shadingTexUpdateNeeded   = false;
 	shadingTexUpdateProgress = -1;
+
+	CreateShadingTexShader();
+}
+
+
+void CSMFReadMap::CreateShadingTexShader()
+{
+	if (!globalRendering->haveGLSL || !FBO::IsSupported())
+		return;
+
+	shadingTexShader = shaderHandler->CreateProgramObject("[SMFReadMap]", "ShadingTexShader", false);
+	shadingTexShader->AttachShaderObject(shaderHandler->CreateShaderObject("GLSL/SMFShadingTexFragProg.glsl", "", GL_FRAGMENT_SHADER));
+	shadingTexShader->Link();
+
+	if (!shadingTexShader->IsValid()) {
+		LOG_L(L_WARNING, "[SMFReadMap] shading-texture shader errors:\n%s", (shadingTexShader->GetLog()).c_str());
+		shaderHandler->ReleaseProgramObjects("[SMFReadMap]");
+		shadingTexShader = nullptr;
+		return;
+	}
+
+	shadingTexShader->SetUniformLocation("heightMapTex");       // idx 0
+	shadingTexShader->SetUniformLocation("waterColorsTex");     // idx 1
+	shadingTexShader->SetUniformLocation("mapSize");            // idx 2
+	shadingTexShader->SetUniformLocation("heightMapSizeInv");   // idx 3
+	shadingTexShader->SetUniformLocation("lightDir");           // idx 4
+	shadingTexShader->SetUniformLocation("groundAmbientColor"); // idx 5
+	shadingTexShader->SetUniformLocation("groundDiffuseColor"); // idx 6
+
+	shadingTexShader->Enable();
+	shadingTexShader->SetUniform1i(0, 0);
+	shadingTexShader->SetUniform1i(1, 1);
+	shadingTexShader->SetUniform2f(2, mapDims.mapx * 1.0f, mapDims.mapy * 1.0f);
+	shadingTexShader->SetUniform2f(3, 1.0f / mapDims.mapxp1, 1.0f / mapDims.mapyp1);
+	shadingTexShader->Disable();
+
+	// the water absorption table is constant per map, keep it resident
+	glGenTextures(1, &waterColorsTex);
+	glBindTexture(GL_TEXTURE_2D, waterColorsTex);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1024, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, &waterHeightColors[0]);
+	glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 
@@ -383,6 +445,11 @@ void CSMFReadMap::UpdateVertexNormalsUnsynced(const SRectangle& update)
 	const int maxz = std::min(update.y2 + 1, H - 1);
 
 	for_mt(minz, maxz+1, [&](const int z) {
+		// propagate the synced heights for this row-segment of the
+		// delta in one block copy instead of a store per vertex (the
+		// normal kernel below reads the synced map only)
+		memcpy(&uhm[z * W + minx], &shm[z * W + minx], ((maxx - minx) + 1) * sizeof(float));
+
 		for (int x = minx; x <= maxx; x++) {
 			const int vIdxTL = (z    ) * W + x;
 
@@ -435,10 +502,12 @@ void CSMFReadMap::UpdateVertexNormalsUnsynced(const SRectangle& update)
 			vn += vbl.cross(vbm) * (zOffB        ); assert(vbl.cross(vbm).y >= 0.0f);
 			vn += vml.cross(vbl) * (zOffB & xOffL); assert(vml.cross(vbl).y >= 0.0f);
 
-			// update the visible vertex/face height/normal
-			uhm[vIdxTL] = shm[vIdxTL];
-			vvn[vIdxTL] = vn.ANormalize();
+			// update the visible vertex normal
+			vvn[vIdxTL] = vn;
 		}
+
+		// normalize the whole row segment in one batch
+		fastmath::norm3_batch(&vvn[z * W + minx].x, (maxx - minx) + 1);
 	});
 	#endif
 }
@@ -534,6 +603,15 @@ void CSMFReadMap::UpdateNormalTexture(const SRectangle& update)
 
 void CSMFReadMap::UpdateShadingTexture(const SRectangle& update)
 {
+	if (shadingTexShader != nullptr) {
+		// regenerated on the GPU; the heightmap texture only picks this
+		// region up later in the frame (UpdateHeightMapUnsynced runs
+		// before the event reaches HeightMapTexture), so defer the FBO
+		// pass until CSMFGroundDrawer::Update
+		shadingTexDirtyRects.push_back(update);
+		return;
+	}
+
 	// update the shading texture (even if the map has specular
 	// lighting, we still need it to modulate the minimap image)
 	// this can be done for diffuse lighting only
@@ -571,13 +649,124 @@ void CSMFReadMap::UpdateShadingTexture(const SRectangle& update)
 			}
 		}
 
-		// redefine the texture subregion
+		// redefine the texture subregion; staged through a fenced PBO
+		// ring when possible so heavy terraform does not stall here
 		glBindTexture(GL_TEXTURE_2D, shadingTex.GetID());
-		glTexSubImage2D(GL_TEXTURE_2D, 0, x1, y1, xsize, ysize, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+
+		const auto copyPixels = [&](unsigned char* dst) {
+			memcpy(dst, &pixels[0], pixels.size());
+		};
+
+		if (!shadingTexUpload.Upload(x1, y1, xsize, ysize, GL_RGBA, GL_UNSIGNED_BYTE, 4, copyPixels))
+			glTexSubImage2D(GL_TEXTURE_2D, 0, x1, y1, xsize, ysize, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
 	}
 }
 
 
+void CSMFReadMap::FlushShadingTexDirtyRects()
+{
+	if (shadingTexShader == nullptr || shadingTexDirtyRects.empty())
+		return;
+
+	shadingTexDirtyRects.Optimize();
+
+	while (!shadingTexDirtyRects.empty()) {
+		const SRectangle rect = shadingTexDirtyRects.front();
+		shadingTexDirtyRects.pop_front();
+
+		if (!UpdateShadingTextureGPU(rect)) {
+			// pass failed (no heightmap texture or bad FBO, in which
+			// case the shader was dropped); redo this rect on the CPU
+			UpdateShadingTexture(rect);
+		}
+	}
+}
+
+
+bool CSMFReadMap::UpdateShadingTextureGPU(const SRectangle& update)
+{
+	if (shadingTexShader == nullptr)
+		return false;
+	// requires the resident heightmap texture (can be disabled or
+	// unsupported), in which case the CPU path stays responsible
+	if (heightMapTexture == nullptr || heightMapTexture->GetTextureID() == 0)
+		return false;
+
+	// same enlarged and clamped texel rect as the CPU path
+	const int x1 = std::max(update.x1 - 1,          0);
+	const int y1 = std::max(update.y1 - 1,          0);
+	const int x2 = std::min(update.x2 + 1, mapDims.mapxm1);
+	const int y2 = std::min(update.y2 + 1, mapDims.mapym1);
+
+	const int xsize = (x2 - x1) + 1;
+	const int ysize = (y2 - y1) + 1;
+
+	shadingTexFBO.Bind();
+	shadingTexFBO.AttachTexture(shadingTex.GetID(), GL_TEXTURE_2D, GL_COLOR_ATTACHMENT0_EXT);
+
+	if (!shadingTexFBO.CheckStatus("SMF-SHADINGTEX")) {
+		// drop the GPU path for good, callers fall back to the CPU loops
+		FBO::Unbind();
+		shaderHandler->ReleaseProgramObjects("[SMFReadMap]");
+		shadingTexShader = nullptr;
+		return false;
+	}
+
+	glPushAttrib(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT | GL_ENABLE_BIT | GL_VIEWPORT_BIT);
+	glDisable(GL_BLEND);
+	glDisable(GL_DEPTH_TEST);
+	glDepthMask(GL_FALSE);
+
+	const float3& lightDir = sky->GetLight()->GetLightDir();
+	const float intensityMult = CGlobalRendering::SMF_INTENSITY_MULT;
+
+	shadingTexShader->Enable();
+	shadingTexShader->SetUniform3f(4, lightDir.x, lightDir.y, lightDir.z);
+	shadingTexShader->SetUniform3f(5,
+		sunLighting->groundAmbientColor.x * intensityMult,
+		sunLighting->groundAmbientColor.y * intensityMult,
+		sunLighting->groundAmbientColor.z * intensityMult);
+	shadingTexShader->SetUniform3f(6,
+		sunLighting->groundDiffuseColor.x * intensityMult,
+		sunLighting->groundDiffuseColor.y * intensityMult,
+		sunLighting->groundDiffuseColor.z * intensityMult);
+
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, waterColorsTex);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, heightMapTexture->GetTextureID());
+
+	glMatrixMode(GL_MODELVIEW);
+		glPushMatrix();
+		glLoadIdentity();
+	glMatrixMode(GL_PROJECTION);
+		glPushMatrix();
+		glLoadIdentity();
+		glOrtho(0, 1, 0, 1, -1, 1);
+
+	// viewport spans just the updated texels; texcoords are ground-
+	// square coordinates, the shader floors them to pick its square
+	glViewport(x1, y1, xsize, ysize);
+
+	glBegin(GL_QUADS);
+		glTexCoord2f(x1 * 1.0f,        y1 * 1.0f       ); glVertex2f(0.0f, 0.0f);
+		glTexCoord2f(x1 * 1.0f,        (y2 + 1) * 1.0f ); glVertex2f(0.0f, 1.0f);
+		glTexCoord2f((x2 + 1) * 1.0f,  (y2 + 1) * 1.0f ); glVertex2f(1.0f, 1.0f);
+		glTexCoord2f((x2 + 1) * 1.0f,  y1 * 1.0f       ); glVertex2f(1.0f, 0.0f);
+	glEnd();
+
+	glMatrixMode(GL_PROJECTION);
+		glPopMatrix();
+	glMatrixMode(GL_MODELVIEW);
+		glPopMatrix();
+
+	shadingTexShader->Disable();
+	glPopAttrib();
+	FBO::Unbind();
+	return true;
+}
+
+
 const float CSMFReadMap::GetCenterHeightUnsynced(const int x, const int y) const
 {
 	const float* hm = GetCornerHeightMapUnsynced();
@@ -681,6 +870,14 @@ void CSMFReadMap::UpdateShadingTexture()
 		return;
 	}
 
+	// one FBO pass replaces the whole progressive refresh, so dynamic
+	// sunlight is never stale while the CPU loop crawls over the map
+	if (shadingTexShader != nullptr && UpdateShadingTextureGPU(SRectangle(0, 0, mapDims.mapx, mapDims.mapy))) {
+		shadingTexUpdateProgress = -1;
+		shadingTexUpdateNeeded   = false;
+		return;
+	}
+
 	if (shadingTexUpdateProgress >= pixels) {
 		if (shadingTexUpdateNeeded) {
 			shadingTexUpdateProgress = 0;
@@ -691,7 +888,13 @@ void CSMFReadMap::UpdateShadingTexture()
 
 		//FIXME use FBO and blend slowly new and old? (this way update rate could reduced even more -> saves CPU time)
 		glBindTexture(GL_TEXTURE_2D, shadingTex.GetID());
-		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, xsize, ysize, GL_RGBA, GL_UNSIGNED_BYTE, &shadingTexBuffer[0]);
+
+		const auto copyPixels = [&](unsigned char* dst) {
+			memcpy(dst, &shadingTexBuffer[0], shadingTexBuffer.size());
+		};
+
+		if (!shadingTexUpload.Upload(0, 0, xsize, ysize, GL_RGBA, GL_UNSIGNED_BYTE, 4, copyPixels))
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, xsize, ysize, GL_RGBA, GL_UNSIGNED_BYTE, &shadingTexBuffer[0]);
 		return;
 	}
 
@@ -5,9 +5,15 @@
 
 #include "SMFMapFile.h"
 #include "Map/ReadMap.h"
+#include "Rendering/GL/FBO.h"
+#include "Rendering/GL/PixelUpload.h"
 #include "System/EventClient.h"
 #include "System/type2.h"
 
+namespace Shader {
+	struct IProgramObject;
+}
+
 
 class CSMFGroundDrawer;
 
@@ -26,11 +32,16 @@ public:
 
 	CSMFReadMap(std::string mapname);
 	// note: textures are auto-deleted
-	~CSMFReadMap() {}
+	~CSMFReadMap();
 
 	void UpdateShadingTexture() override;
 	void UpdateHeightMapUnsynced(const SRectangle&) override;
 
+	// runs the deferred GPU shading-texture passes; called once per
+	// draw-frame by CSMFGroundDrawer::Update, after the heightmap
+	// texture has picked up the frame's terrain deformations
+	void FlushShadingTexDirtyRects();
+
 public:
 	bool SetLuaTexture(const MapTextureData& td) override;
 
@@ -153,12 +164,14 @@ private:
 	void CreateGrassTex();
 	void CreateDetailTex();
 	void CreateShadingTex();
+	void CreateShadingTexShader();
 	void CreateNormalTex();
 
 	void UpdateVertexNormalsUnsynced(const SRectangle& update);
 	void UpdateFaceNormalsUnsynced(const SRectangle& update);
 	void UpdateNormalTexture(const SRectangle& update);
 	void UpdateShadingTexture(const SRectangle& update);
+	bool UpdateShadingTextureGPU(const SRectangle& update);
 
 	inline void UpdateShadingTexPart(int idx1, int idx2, unsigned char* dst) const;
 	inline const float GetCenterHeightUnsynced(const int x, const int y) const;
@@ -220,6 +233,20 @@ private:
 	MapTexture parallaxHeightTex;
 
 private:
+	// fenced async shadingTex uploads (terraform rects and the
+	// amortized dynamic-sun refresh); synchronous without support
+	CPixelUpload shadingTexUpload;
+
+	// GPU shading-texture generation; one FBO pass over the resident
+	// heightmap texture replaces the CPU loops above when supported
+	FBO shadingTexFBO;
+	Shader::IProgramObject* shadingTexShader;
+	GLuint waterColorsTex;
+
+	// terrain deformations waiting for their GPU pass; the heightmap
+	// texture only sees them after UpdateHeightMapUnsynced has run
+	CRectangleOptimizer shadingTexDirtyRects;
+
 	int shadingTexUpdateProgress;
 
 	float texAnisotropyLevels[2];
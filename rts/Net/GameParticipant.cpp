@@ -2,6 +2,8 @@
 
 #include "GameParticipant.h"
 
+#include <cstring>
+
 #include "Net/Protocol/BaseNetProtocol.h"
 #include "Sim/Misc/GlobalConstants.h"
 #include "System/Net/Connection.h"
@@ -16,6 +18,8 @@ GameParticipant::GameParticipant()
 , isReconn(false)
 , isMidgameJoin(false)
 {
+	memset(simFrameCostHist, 0, sizeof(simFrameCostHist));
+
 	linkData[MAX_AIS] = PlayerLinkData(false);
 }
 
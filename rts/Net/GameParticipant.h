@@ -44,6 +44,10 @@ public:
 	bool isLocal;
 	bool isReconn;
 	bool isMidgameJoin;
+
+	/// most recent NETMSG_SIMFRAME_COST report, all-zero before the first one
+	unsigned char simFrameCostHist[8];
+
 	std::shared_ptr<netcode::CConnection> link;
 	PlayerStatistics lastStats;
 
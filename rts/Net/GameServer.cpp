@@ -885,6 +885,29 @@ void CGameServer::Update()
 
 
 
+/// 95th-percentile sim-frame cost in milliseconds, or 0 if no frames were reported
+static float GetP95SimFrameCost(const unsigned char* hist)
+{
+	unsigned int numFrames = 0;
+
+	for (int b = 0; b < 8; b++)
+		numFrames += hist[b];
+
+	if (numFrames == 0)
+		return 0.0f;
+
+	unsigned int cumFrames = 0;
+
+	for (int b = 0; b < 8; b++) {
+		cumFrames += hist[b];
+
+		if ((cumFrames * 20) >= (numFrames * 19))
+			return NETMSG_SIMFRAME_COST_EDGES_MS[b];
+	}
+
+	return NETMSG_SIMFRAME_COST_EDGES_MS[7];
+}
+
 void CGameServer::LagProtection()
 {
 	std::vector<float> cpu;
@@ -894,6 +917,10 @@ void CGameServer::LagProtection()
 
 	// detect reference cpu usage ( highest )
 	float refCpuUsage = 0.0f;
+	// highest sim speed every reporting client could still sustain, from their
+	// frame-cost histograms; spectators never constrain this (a caster's weak
+	// laptop should not slow the match, reconnecting players are watched below)
+	float minSustainableSpeed = 0.0f;
 	for (GameParticipant& player: players) {
 		if (player.myState == GameParticipant::INGAME) {
 			// send info about the players
@@ -912,6 +939,17 @@ void CGameServer::LagProtection()
 				cpu.push_back(correctedCpu);
 				ping.push_back(curPing);
 			}
+
+			if (!player.isReconn && !(demoReader ? player.isFromDemo : player.spectator)) {
+				const float p95FrameCost = GetP95SimFrameCost(player.simFrameCostHist);
+
+				if (p95FrameCost > 0.0f) {
+					const float sustainableSpeed = (1000.0f / p95FrameCost) / GAME_SPEED;
+
+					if (minSustainableSpeed <= 0.0f || sustainableSpeed < minSustainableSpeed)
+						minSustainableSpeed = sustainableSpeed;
+				}
+			}
 		}
 	}
 
@@ -949,6 +987,11 @@ void CGameServer::LagProtection()
 		newSpeed = Clamp(newSpeed, 0.1f, userSpeedFactor);
 		//average to smooth the speed change over time to reduce the impact of cpu spikes in the players
 		newSpeed = (newSpeed + internalSpeed) * 0.5f;
+
+		// predictive trim: never aim above ~90% of the speed the slowest reporting
+		// player can sustain, so the speed drops before that client starts lagging
+		if (minSustainableSpeed > 0.0f)
+			newSpeed = Clamp(newSpeed, 0.1f, minSustainableSpeed * 0.9f);
 #ifndef DEDICATED
 		// in non-dedicated hosting, we'll add an additional safeguard to make sure the host can keep up with the game's speed
 		// adjust game speed to localclient's (:= host) maximum SimFrame rate
@@ -1056,6 +1099,11 @@ void CGameServer::ProcessPacket(const unsigned playerNum, std::shared_ptr<const
 			players[a].cpuUsage = *((float*)&inbuf[1]);
 			break;
 
+		case NETMSG_SIMFRAME_COST:
+			// consumed by LagProtection, not relayed
+			memcpy(players[a].simFrameCostHist, &inbuf[1], sizeof(players[a].simFrameCostHist));
+			break;
+
 		case NETMSG_QUIT: {
 			Message(spring::format(PlayerLeft, players[a].GetType(), players[a].name.c_str(), " normal quit"));
 			Broadcast(CBaseNetProtocol::Get().SendPlayerLeft(a, 1));
@@ -1203,6 +1251,27 @@ void CGameServer::ProcessPacket(const unsigned playerNum, std::shared_ptr<const
 			}
 			break;
 
+		case NETMSG_SELECT_DELTA:
+			try {
+				netcode::UnpackPacket pckt(packet, 3);
+				unsigned char playerNum;
+				pckt >> playerNum;
+				if (playerNum != a) {
+					Message(spring::format(WrongPlayer, msgCode, a, (unsigned)playerNum));
+					break;
+				}
+
+				#ifndef ALLOW_DEMO_GODMODE
+				if (demoReader == NULL)
+				#endif
+				{
+					Broadcast(packet); //forward data
+				}
+			} catch (const netcode::UnpackPacketException& ex) {
+				Message(spring::format("Player %s sent invalid SelectDelta: %s", players[a].name.c_str(), ex.what()));
+			}
+			break;
+
 		case NETMSG_AICOMMAND: {
 			try {
 				netcode::UnpackPacket pckt(packet, 3);
@@ -1,6 +1,7 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
 #include <cinttypes>
+#include <cstring>
 
 #include "Game/Game.h"
 #include "GameServer.h"
@@ -34,6 +35,7 @@
 #include "Net/Protocol/NetProtocol.h"
 #include "System/TimeProfiler.h"
 #include "System/LoadSave/DemoRecorder.h"
+#include "System/Net/TrafficStats.h"
 #include "System/Net/UnpackPacket.h"
 #include "System/Sound/ISound.h"
 
@@ -44,9 +46,15 @@ LOG_REGISTER_SECTION_GLOBAL(LOG_SECTION_NET)
 
 static spring::unordered_map<int, unsigned int> localSyncChecksums;
 
+// latest server frame known from NETMSG_GAME_FRAME_PROGRESS; only
+// meaningful while fast-forwarding to the current point of the game
+static int lastGameFrameProgress = 0;
+
 
 void CGame::AddTraffic(int playerID, int packetCode, int length)
 {
+	netcode::TrafficStats::RecordRecv(packetCode, length);
+
 	auto it = playerTraffic.find(playerID);
 	if (it == playerTraffic.end()) {
 		playerTraffic[playerID] = PlayerTrafficInfo();
@@ -78,6 +86,9 @@ void CGame::SendClientProcUsage()
 
 			// take the minimum drawframes into account, too
 			clientNet->Send(CBaseNetProtocol::Get().SendCPUUsage(totalProcUsage));
+			clientNet->Send(CBaseNetProtocol::Get().SendSimFrameCost(simFrameCostHist));
+
+			memset(simFrameCostHist, 0, sizeof(simFrameCostHist));
 		} else {
 			// the CPU-load percentage is undefined prior to SimFrame()
 			clientNet->Send(CBaseNetProtocol::Get().SendCPUUsage(0.0f));
@@ -104,7 +115,8 @@ unsigned int CGame::GetNumQueuedSimFrameMessages(unsigned int maxFrames) const
 				// progress of the game from the client's point of view
 				//
 				// send the event to lua call-in
-				eventHandler.GameProgress(*(int*)(packet->data + 1));
+				lastGameFrameProgress = *(int*)(packet->data + 1);
+				eventHandler.GameProgress(lastGameFrameProgress);
 				// pop it out of the net buffer
 				clientNet->DeleteBufferPacketAt(packetPeekIndex);
 			} break;
@@ -164,6 +176,22 @@ void CGame::UpdateNumQueuedSimFrames()
 		consumeSpeedMult = GAME_SPEED * gs->speedFactor + (numQueuedFrames/2) - 1;
 	}
 
+	// consider the sim to be catching up (mid-game rejoin, heavy lag
+	// spike) when several seconds of frames are queued; only leave the
+	// mode again well below the entry threshold so it does not flicker
+	// on network jitter
+	if (!gu->simCatchingUp) {
+		gu->simCatchingUp = (numQueuedFrames > (GAME_SPEED * 5.0f * gs->speedFactor));
+	} else {
+		gu->simCatchingUp = (numQueuedFrames > (GAME_SPEED * 0.5f));
+
+		if (lastGameFrameProgress > gs->frameNum) {
+			LOG("[Game::%s] catching up: frame %d/%d (%.0f%%)",
+					__func__, gs->frameNum, lastGameFrameProgress,
+					(100.0f * gs->frameNum) / lastGameFrameProgress);
+		}
+	}
+
 	// await one sim frame if queue is dry
 	if (numQueuedFrames == 0)
 		msgProcTimeLeft = -1000.0f * gs->speedFactor;
@@ -213,6 +241,29 @@ float CGame::GetNetMessageProcessingTimeLimit() const
 	return Clamp(simDrawRatio * gu->avgSimFrameTime, 5.0f, 1000.0f / gu->minFPS);
 }
 
+// presentation-only messages whose execution can slip a few frames;
+// ClientReadNet queues these to a deferral lane so message bursts spend
+// the processing budget on sim-critical frames and commands first (FIFO
+// order within the lane is kept, only ordering across lanes changes)
+bool CGame::IsDeferrableNetMessage(unsigned char packetCode)
+{
+	switch (packetCode) {
+		case NETMSG_CHAT:
+		case NETMSG_SYSTEMMSG:
+		case NETMSG_MAPDRAW:
+		case NETMSG_PLAYERSTAT:
+		case NETMSG_PLAYERINFO:
+		case NETMSG_CPU_USAGE:
+		case NETMSG_LOGMSG: {
+			return true;
+		} break;
+		default: {
+		} break;
+	}
+
+	return false;
+}
+
 void CGame::ClientReadNet()
 {
 	// look ahead so we can adapt consumeSpeedMult to network fluctuations
@@ -240,680 +291,618 @@ void CGame::ClientReadNet()
 
 		lastReceivedNetPacketTime = spring_gettime();
 
-		const unsigned char* inbuf = packet->data;
-		const unsigned dataLength = packet->length;
-		const unsigned char packetCode = inbuf[0];
+		if (IsDeferrableNetMessage(packet->data[0])) {
+			deferredNetPackets.push_back(packet);
+			continue;
+		}
 
-		switch (packetCode) {
-			case NETMSG_QUIT: {
-				try {
-					netcode::UnpackPacket pckt(packet, 3);
-					std::string message;
+		ProcessNetMessage(packet);
+	}
 
-					pckt >> message;
+	ProcessDeferredNetMessages(msgProcEndTime);
+}
 
-					LOG("%s", message.c_str());
+void CGame::ProcessDeferredNetMessages(const spring_time msgProcEndTime)
+{
+	// always make some progress so a continuous burst can not starve the
+	// lane entirely, then keep draining while wall-budget remains
+	constexpr unsigned int minDeferredMsgs = 8;
 
-					GameEnd({});
-					AddTraffic(-1, packetCode, dataLength);
-					clientNet->Close(true);
-				} catch (const netcode::UnpackPacketException& ex) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_QUIT] exception \"%s\"", __func__, ex.what());
-				}
-				break;
-			}
+	for (unsigned int n = 0; !deferredNetPackets.empty(); n++) {
+		if (n >= minDeferredMsgs && spring_gettime() > msgProcEndTime)
+			break;
 
-			case NETMSG_PLAYERLEFT: {
-				const unsigned char player = inbuf[1];
-				if (!playerHandler->IsValidPlayer(player)) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_PLAYERLEFT] invalid player-number %i", __func__, player);
-					break;
-				}
-				playerHandler->PlayerLeft(player, inbuf[2]);
-				eventHandler.PlayerRemoved(player, (int) inbuf[2]);
+		std::shared_ptr<const netcode::RawPacket> packet = std::move(deferredNetPackets.front());
+		deferredNetPackets.pop_front();
 
-				AddTraffic(player, packetCode, dataLength);
-				break;
-			}
+		ProcessNetMessage(packet);
+	}
+}
 
-			case NETMSG_STARTPLAYING: {
-				unsigned timeToStart = *(unsigned*)(inbuf+1);
-				if (timeToStart > 0) {
-					GameSetupDrawer::StartCountdown(timeToStart);
-				} else {
-					StartPlaying();
-				}
-				AddTraffic(-1, packetCode, dataLength);
-				break;
-			}
+void CGame::ProcessNetMessage(std::shared_ptr<const netcode::RawPacket>& packet)
+{
+	const unsigned char* inbuf = packet->data;
+	const unsigned dataLength = packet->length;
+	const unsigned char packetCode = inbuf[0];
 
-			case NETMSG_PLAYERSTAT: {
-				const unsigned char playerNum = inbuf[1];
-				if (!playerHandler->IsValidPlayer(playerNum)) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_PLAYERSTAT] invalid player-number %i", __func__, playerNum);
-					break;
-				}
+	switch (packetCode) {
+		case NETMSG_QUIT: {
+			try {
+				netcode::UnpackPacket pckt(packet, 3);
+				std::string message;
 
-				CPlayer* player = playerHandler->Player(playerNum);
-				player->currentStats = *reinterpret_cast<const PlayerStatistics*>(&inbuf[2]);
+				pckt >> message;
 
-				CDemoRecorder* record = clientNet->GetDemoRecorder();
-				if (record != NULL) {
-					record->SetPlayerStats(playerNum, player->currentStats);
-				}
-				AddTraffic(playerNum, packetCode, dataLength);
-				break;
-			}
+				LOG("%s", message.c_str());
 
-			case NETMSG_PAUSE: {
-				const unsigned char player = inbuf[1];
-				if (!playerHandler->IsValidPlayer(player)) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_PAUSE] invalid player-number %i", __func__, player);
-					break;
-				}
-				gs->paused = !!inbuf[2];
-				LOG("%s %s the game",
-						playerHandler->Player(player)->name.c_str(),
-						(gs->paused ? "paused" : "unpaused"));
-				eventHandler.GamePaused(player, gs->paused);
-				lastReadNetTime = spring_gettime();
-				AddTraffic(player, packetCode, dataLength);
-				break;
+				GameEnd({});
+				AddTraffic(-1, packetCode, dataLength);
+				clientNet->Close(true);
+			} catch (const netcode::UnpackPacketException& ex) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_QUIT] exception \"%s\"", __func__, ex.what());
 			}
+			break;
+		}
 
-			case NETMSG_INTERNAL_SPEED: {
-				gs->speedFactor = *((float*) &inbuf[1]);
-				sound->PitchAdjust(math::sqrt(gs->speedFactor));
-				//LOG_L(L_DEBUG, "Internal speed set to %.2f", gs->speedFactor);
-				AddTraffic(-1, packetCode, dataLength);
+		case NETMSG_PLAYERLEFT: {
+			const unsigned char player = inbuf[1];
+			if (!playerHandler->IsValidPlayer(player)) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_PLAYERLEFT] invalid player-number %i", __func__, player);
 				break;
 			}
+			playerHandler->PlayerLeft(player, inbuf[2]);
+			eventHandler.PlayerRemoved(player, (int) inbuf[2]);
 
-			case NETMSG_USER_SPEED: {
-				const unsigned char player = inbuf[1];
-				if (!playerHandler->IsValidPlayer(player) && player != SERVER_PLAYER) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_USER_SPEED] invalid player-number %i", __func__, player);
-					break;
-				}
-				const char* pName = (player == SERVER_PLAYER)? "server": playerHandler->Player(player)->name.c_str();
+			AddTraffic(player, packetCode, dataLength);
+			break;
+		}
 
-				gs->wantedSpeedFactor = *((float*) &inbuf[2]);
-				LOG("Speed set to %.1f [%s]", gs->wantedSpeedFactor, pName);
-				AddTraffic(player, packetCode, dataLength);
-				break;
+		case NETMSG_STARTPLAYING: {
+			unsigned timeToStart = *(unsigned*)(inbuf+1);
+			if (timeToStart > 0) {
+				GameSetupDrawer::StartCountdown(timeToStart);
+			} else {
+				StartPlaying();
 			}
+			AddTraffic(-1, packetCode, dataLength);
+			break;
+		}
 
-			case NETMSG_CPU_USAGE: {
-				LOG_L(L_WARNING, "Game clients shouldn't get cpu usage msgs?");
-				AddTraffic(-1, packetCode, dataLength);
+		case NETMSG_PLAYERSTAT: {
+			const unsigned char playerNum = inbuf[1];
+			if (!playerHandler->IsValidPlayer(playerNum)) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_PLAYERSTAT] invalid player-number %i", __func__, playerNum);
 				break;
 			}
 
-			case NETMSG_PLAYERINFO: {
-				const unsigned char playerId = inbuf[1];
-				if (!playerHandler->IsValidPlayer(playerId)) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_PLAYERINFO] invalid player-number %i", __func__, playerId);
-					break;
-				}
-				CPlayer* p  = playerHandler->Player(playerId);
-				p->cpuUsage =           *(float*) &inbuf[2];
-				p->ping     = *(std::uint32_t*) &inbuf[6];
+			CPlayer* player = playerHandler->Player(playerNum);
+			player->currentStats = *reinterpret_cast<const PlayerStatistics*>(&inbuf[2]);
 
-				AddTraffic(playerId, packetCode, dataLength);
-				break;
+			CDemoRecorder* record = clientNet->GetDemoRecorder();
+			if (record != NULL) {
+				record->SetPlayerStats(playerNum, player->currentStats);
 			}
+			AddTraffic(playerNum, packetCode, dataLength);
+			break;
+		}
 
-			case NETMSG_PLAYERNAME: {
-				try {
-					netcode::UnpackPacket pckt(packet, 2);
-					unsigned char playerID;
-					pckt >> playerID;
-					if (!playerHandler->IsValidPlayer(playerID))
-						throw netcode::UnpackPacketException("Invalid player number");
-
-					CPlayer* player = playerHandler->Player(playerID);
-					pckt >> player->name;
-					player->SetReadyToStart(gameSetup->startPosType != CGameSetup::StartPos_ChooseInGame);
-					player->active = true;
-					wordCompletion->AddWord(player->name, false, false, false); // required?
-					AddTraffic(playerID, packetCode, dataLength);
-				} catch (const netcode::UnpackPacketException& ex) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_PLAYERNAME] exception \"%s\"", __func__, ex.what());
-				}
+		case NETMSG_PAUSE: {
+			const unsigned char player = inbuf[1];
+			if (!playerHandler->IsValidPlayer(player)) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_PAUSE] invalid player-number %i", __func__, player);
 				break;
 			}
+			gs->paused = !!inbuf[2];
+			LOG("%s %s the game",
+					playerHandler->Player(player)->name.c_str(),
+					(gs->paused ? "paused" : "unpaused"));
+			eventHandler.GamePaused(player, gs->paused);
+			lastReadNetTime = spring_gettime();
+			AddTraffic(player, packetCode, dataLength);
+			break;
+		}
 
-			case NETMSG_CHAT: {
-				try {
-					ChatMessage msg(packet);
+		case NETMSG_INTERNAL_SPEED: {
+			gs->speedFactor = *((float*) &inbuf[1]);
+			sound->PitchAdjust(math::sqrt(gs->speedFactor));
+			//LOG_L(L_DEBUG, "Internal speed set to %.2f", gs->speedFactor);
+			AddTraffic(-1, packetCode, dataLength);
+			break;
+		}
 
-					HandleChatMsg(msg);
-					AddTraffic(msg.fromPlayer, packetCode, dataLength);
-				} catch (const netcode::UnpackPacketException& ex) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_CHAT] exception \"%s\"", __func__, ex.what());
-				}
+		case NETMSG_USER_SPEED: {
+			const unsigned char player = inbuf[1];
+			if (!playerHandler->IsValidPlayer(player) && player != SERVER_PLAYER) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_USER_SPEED] invalid player-number %i", __func__, player);
 				break;
 			}
+			const char* pName = (player == SERVER_PLAYER)? "server": playerHandler->Player(player)->name.c_str();
 
-			case NETMSG_SYSTEMMSG: {
-				try {
-					netcode::UnpackPacket pckt(packet, 4);
-					std::string sysMsg;
-					pckt >> sysMsg;
-					LOG("%s", sysMsg.c_str());
-					AddTraffic(-1, packetCode, dataLength);
-				} catch (const netcode::UnpackPacketException& ex) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_SYSTEMMSG] exception \"%s\"", __func__, ex.what());
-				}
+			gs->wantedSpeedFactor = *((float*) &inbuf[2]);
+			LOG("Speed set to %.1f [%s]", gs->wantedSpeedFactor, pName);
+			AddTraffic(player, packetCode, dataLength);
+			break;
+		}
+
+		case NETMSG_CPU_USAGE: {
+			LOG_L(L_WARNING, "Game clients shouldn't get cpu usage msgs?");
+			AddTraffic(-1, packetCode, dataLength);
+			break;
+		}
+
+		case NETMSG_PLAYERINFO: {
+			const unsigned char playerId = inbuf[1];
+			if (!playerHandler->IsValidPlayer(playerId)) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_PLAYERINFO] invalid player-number %i", __func__, playerId);
 				break;
 			}
+			CPlayer* p  = playerHandler->Player(playerId);
+			p->cpuUsage =           *(float*) &inbuf[2];
+			p->ping     = *(std::uint32_t*) &inbuf[6];
 
-			case NETMSG_STARTPOS: {
-				const unsigned char playerID = inbuf[1];
-				const unsigned int teamID = inbuf[2];
+			AddTraffic(playerId, packetCode, dataLength);
+			break;
+		}
 
-				if (!playerHandler->IsValidPlayer(playerID) && playerID != SERVER_PLAYER) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_STARTPOS] invalid player-number %i", __func__, playerID);
-					break;
-				}
-				if (!teamHandler->IsValidTeam(teamID)) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_STARTPOS] invalid team-number %i", __func__, teamID);
-					break;
-				}
+		case NETMSG_PLAYERNAME: {
+			try {
+				netcode::UnpackPacket pckt(packet, 2);
+				unsigned char playerID;
+				pckt >> playerID;
+				if (!playerHandler->IsValidPlayer(playerID))
+					throw netcode::UnpackPacketException("Invalid player number");
+
+				CPlayer* player = playerHandler->Player(playerID);
+				pckt >> player->name;
+				player->SetReadyToStart(gameSetup->startPosType != CGameSetup::StartPos_ChooseInGame);
+				player->active = true;
+				wordCompletion->AddWord(player->name, false, false, false); // required?
+				AddTraffic(playerID, packetCode, dataLength);
+			} catch (const netcode::UnpackPacketException& ex) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_PLAYERNAME] exception \"%s\"", __func__, ex.what());
+			}
+			break;
+		}
 
-				const unsigned char rdyState = inbuf[3];
-				float3 rawPickPos(*(float*) &inbuf[4], *(float*) &inbuf[8], *(float*) &inbuf[12]);
-				float3 clampedPos(rawPickPos);
+		case NETMSG_CHAT: {
+			try {
+				ChatMessage msg(packet);
 
-				CTeam* team = teamHandler->Team(teamID);
-				team->ClampStartPosInStartBox(&clampedPos);
+				HandleChatMsg(msg);
+				AddTraffic(msg.fromPlayer, packetCode, dataLength);
+			} catch (const netcode::UnpackPacketException& ex) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_CHAT] exception \"%s\"", __func__, ex.what());
+			}
+			break;
+		}
 
-				if (eventHandler.AllowStartPosition(playerID, teamID, rdyState, clampedPos, rawPickPos)) {
-					team->SetStartPos(clampedPos);
+		case NETMSG_SYSTEMMSG: {
+			try {
+				netcode::UnpackPacket pckt(packet, 4);
+				std::string sysMsg;
+				pckt >> sysMsg;
+				LOG("%s", sysMsg.c_str());
+				AddTraffic(-1, packetCode, dataLength);
+			} catch (const netcode::UnpackPacketException& ex) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_SYSTEMMSG] exception \"%s\"", __func__, ex.what());
+			}
+			break;
+		}
 
-					if (playerID != SERVER_PLAYER) {
-						playerHandler->Player(playerID)->SetReadyToStart(rdyState != CPlayer::PLAYER_RDYSTATE_UPDATED);
-					}
-				}
+		case NETMSG_STARTPOS: {
+			const unsigned char playerID = inbuf[1];
+			const unsigned int teamID = inbuf[2];
 
-				AddTraffic(playerID, packetCode, dataLength);
+			if (!playerHandler->IsValidPlayer(playerID) && playerID != SERVER_PLAYER) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_STARTPOS] invalid player-number %i", __func__, playerID);
 				break;
 			}
-
-			case NETMSG_RANDSEED: {
-				gsRNG.SetSeed(*((unsigned int*)&inbuf[1]), true);
-				AddTraffic(-1, packetCode, dataLength);
+			if (!teamHandler->IsValidTeam(teamID)) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_STARTPOS] invalid team-number %i", __func__, teamID);
 				break;
 			}
 
-			case NETMSG_GAMEID: {
-				const unsigned char* p = &inbuf[1];
-				CDemoRecorder* record = clientNet->GetDemoRecorder();
-				if (record != NULL) {
-					record->SetGameID(p);
+			const unsigned char rdyState = inbuf[3];
+			float3 rawPickPos(*(float*) &inbuf[4], *(float*) &inbuf[8], *(float*) &inbuf[12]);
+			float3 clampedPos(rawPickPos);
+
+			CTeam* team = teamHandler->Team(teamID);
+			team->ClampStartPosInStartBox(&clampedPos);
+
+			if (eventHandler.AllowStartPosition(playerID, teamID, rdyState, clampedPos, rawPickPos)) {
+				team->SetStartPos(clampedPos);
+
+				if (playerID != SERVER_PLAYER) {
+					playerHandler->Player(playerID)->SetReadyToStart(rdyState != CPlayer::PLAYER_RDYSTATE_UPDATED);
 				}
-				memcpy(gameID, p, sizeof(gameID));
-				LOG("GameID: "
-						"%02x%02x%02x%02x%02x%02x%02x%02x"
-						"%02x%02x%02x%02x%02x%02x%02x%02x",
-						p[ 0], p[ 1], p[ 2], p[ 3], p[ 4], p[ 5], p[ 6], p[ 7],
-						p[ 8], p[ 9], p[10], p[11], p[12], p[13], p[14], p[15]);
-				AddTraffic(-1, packetCode, dataLength);
-				eventHandler.GameID(gameID, sizeof(gameID));
-				break;
 			}
 
-			case NETMSG_PATH_CHECKSUM: {
-				const unsigned char playerNum = inbuf[1];
-				if (!playerHandler->IsValidPlayer(playerNum)) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_PATH_CHECKSUM] invalid player-number %i", __func__, playerNum);
-					break;
-				}
+			AddTraffic(playerID, packetCode, dataLength);
+			break;
+		}
 
-				const std::uint32_t playerCheckSum = *(std::uint32_t*) &inbuf[2];
-				const std::uint32_t localCheckSum = pathManager->GetPathCheckSum();
+		case NETMSG_RANDSEED: {
+			gsRNG.SetSeed(*((unsigned int*)&inbuf[1]), true);
+			AddTraffic(-1, packetCode, dataLength);
+			break;
+		}
 
-				const CPlayer* player = playerHandler->Player(playerNum);
+		case NETMSG_GAMEID: {
+			const unsigned char* p = &inbuf[1];
+			CDemoRecorder* record = clientNet->GetDemoRecorder();
+			if (record != NULL) {
+				record->SetGameID(p);
+			}
+			memcpy(gameID, p, sizeof(gameID));
+			LOG("GameID: "
+					"%02x%02x%02x%02x%02x%02x%02x%02x"
+					"%02x%02x%02x%02x%02x%02x%02x%02x",
+					p[ 0], p[ 1], p[ 2], p[ 3], p[ 4], p[ 5], p[ 6], p[ 7],
+					p[ 8], p[ 9], p[10], p[11], p[12], p[13], p[14], p[15]);
+			AddTraffic(-1, packetCode, dataLength);
+			eventHandler.GameID(gameID, sizeof(gameID));
+			break;
+		}
 
-				const char* pName = player->name.c_str();
-				const char* pType = player->IsSpectator()? "spectator": "player";
-				const char* fmtStrs[2] = {
-					"[DESYNC WARNING] path-checksum for %s %d (%s) is 0; non-writable PathEstimator-cache?",
-					"[DESYNC WARNING] path-checksum %08x for %s %d (%s) does not match local checksum %08x; stale PathEstimator-cache?",
-				};
-
-				// XXX maybe use a "Desync" section here?
-				if (playerCheckSum == 0) {
-					LOG_L(L_WARNING, fmtStrs[0], pType, playerNum, pName);
-				} else {
-					if (playerCheckSum != localCheckSum) {
-						LOG_L(L_WARNING, fmtStrs[1], playerCheckSum, pType, playerNum, pName, localCheckSum);
-					}
-				}
-			} break;
+		case NETMSG_PATH_CHECKSUM: {
+			const unsigned char playerNum = inbuf[1];
+			if (!playerHandler->IsValidPlayer(playerNum)) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_PATH_CHECKSUM] invalid player-number %i", __func__, playerNum);
+				break;
+			}
 
-			case NETMSG_KEYFRAME: {
-				const int serverFrameNum = *(int*)(inbuf + 1);
+			const std::uint32_t playerCheckSum = *(std::uint32_t*) &inbuf[2];
+			const std::uint32_t localCheckSum = pathManager->GetPathCheckSum();
 
-				if (gs->frameNum != (serverFrameNum - 1)) {
-					LOG_L(L_ERROR, "[Game::%s] keyframe difference: %i (client: %d, server: %d)", __func__, gs->frameNum - (serverFrameNum - 1), gs->frameNum, serverFrameNum);
-					break;
+			const CPlayer* player = playerHandler->Player(playerNum);
+
+			const char* pName = player->name.c_str();
+			const char* pType = player->IsSpectator()? "spectator": "player";
+			const char* fmtStrs[2] = {
+				"[DESYNC WARNING] path-checksum for %s %d (%s) is 0; non-writable PathEstimator-cache?",
+				"[DESYNC WARNING] path-checksum %08x for %s %d (%s) does not match local checksum %08x; stale PathEstimator-cache?",
+			};
+
+			// XXX maybe use a "Desync" section here?
+			if (playerCheckSum == 0) {
+				LOG_L(L_WARNING, fmtStrs[0], pType, playerNum, pName);
+			} else {
+				if (playerCheckSum != localCheckSum) {
+					LOG_L(L_WARNING, fmtStrs[1], playerCheckSum, pType, playerNum, pName, localCheckSum);
 				}
+			}
+		} break;
+
+		case NETMSG_KEYFRAME: {
+			const int serverFrameNum = *(int*)(inbuf + 1);
 
-				// fall-through and run SimFrame() iff this message really came from the server
-				clientNet->Send(CBaseNetProtocol::Get().SendKeyFrame(serverFrameNum));
+			if (gs->frameNum != (serverFrameNum - 1)) {
+				LOG_L(L_ERROR, "[Game::%s] keyframe difference: %i (client: %d, server: %d)", __func__, gs->frameNum - (serverFrameNum - 1), gs->frameNum, serverFrameNum);
+				break;
 			}
-			case NETMSG_NEWFRAME: {
-				msgProcTimeLeft -= 1000.0f;
-				lastSimFrameNetPacketTime = spring_gettime();
 
-				SimFrame();
+			// fall-through and run SimFrame() iff this message really came from the server
+			clientNet->Send(CBaseNetProtocol::Get().SendKeyFrame(serverFrameNum));
+		}
+		case NETMSG_NEWFRAME: {
+			msgProcTimeLeft -= 1000.0f;
+			lastSimFrameNetPacketTime = spring_gettime();
+
+			SimFrame();
 
 #ifdef SYNCCHECK
-				// both NETMSG_SYNCRESPONSE and NETMSG_NEWFRAME are used for ping calculation by server
-				ASSERT_SYNCED(gs->frameNum);
-				ASSERT_SYNCED(CSyncChecker::GetChecksum());
-				clientNet->Send(CBaseNetProtocol::Get().SendSyncResponse(gu->myPlayerNum, gs->frameNum, CSyncChecker::GetChecksum()));
-
-				if (gameServer != NULL && gameServer->GetDemoReader() != NULL) {
-					// buffer all checksums, so we can check sync later between demo & local
-					localSyncChecksums[gs->frameNum] = CSyncChecker::GetChecksum();
-				}
+			// both NETMSG_SYNCRESPONSE and NETMSG_NEWFRAME are used for ping calculation by server
+			ASSERT_SYNCED(gs->frameNum);
+			ASSERT_SYNCED(CSyncChecker::GetChecksum());
+			clientNet->Send(CBaseNetProtocol::Get().SendSyncResponse(gu->myPlayerNum, gs->frameNum, CSyncChecker::GetChecksum()));
+
+			if (gameServer != NULL && gameServer->GetDemoReader() != NULL) {
+				// buffer all checksums, so we can check sync later between demo & local
+				localSyncChecksums[gs->frameNum] = CSyncChecker::GetChecksum();
+			}
 
-				if ((gs->frameNum & 4095) == 0) {
-					// reset checksum every 4096 frames =~ 2.5 minutes
-					CSyncChecker::NewFrame();
-				}
+			if ((gs->frameNum & 4095) == 0) {
+				// reset checksum every 4096 frames =~ 2.5 minutes
+				CSyncChecker::NewFrame();
+			}
 #endif
-				AddTraffic(-1, packetCode, dataLength);
+			AddTraffic(-1, packetCode, dataLength);
 
-			} break;
+		} break;
 
-			case NETMSG_SYNCRESPONSE: {
+		case NETMSG_SYNCRESPONSE: {
 #if (defined(SYNCCHECK))
-				if (gameServer != nullptr && gameServer->GetDemoReader() != nullptr) {
-					// NOTE:
-					//   this packet is also sent during live games,
-					//   during which we should just ignore it (the
-					//   server does sync-checking for us)
-					netcode::UnpackPacket pckt(packet, 1);
-
-					unsigned char playerNum; pckt >> playerNum;
-					          int  frameNum; pckt >> frameNum;
-					unsigned  int  checkSum; pckt >> checkSum;
-
-					const unsigned int ourCheckSum = localSyncChecksums[frameNum];
-					const CPlayer* player = playerHandler->Player(playerNum);
-
-					// check if our checksum for this frame matches what
-					// player <playerNum> sent to the server at the same
-					// frame in the original game (in case of a demo)
-					if (playerNum == gu->myPlayerNum) { break; }
-					if (checkSum == ourCheckSum) { break; }
-
-					const char* pName = player->name.c_str();
-					const char* pType = player->IsSpectator()? "spectator": "player";
-					const char* fmtStr = "[DESYNC WARNING] checksum %x from demo %s %d (%s) does not match our checksum %x for frame-number %d";
-
-					LOG_L(L_ERROR, fmtStr, checkSum, pType, playerNum, pName, ourCheckSum, frameNum);
-				}
-#endif
-			} break;
-
-
-			case NETMSG_COMMAND: {
-				try {
-					netcode::UnpackPacket pckt(packet, 1);
-
-					unsigned short packetSize; pckt >> packetSize;
-					unsigned char playerNum; pckt >> playerNum;
-					const unsigned int numParams = (packetSize - 9) / sizeof(float);
-
-					if (!playerHandler->IsValidPlayer(playerNum))
-						throw netcode::UnpackPacketException("Invalid player number");
+			if (gameServer != nullptr && gameServer->GetDemoReader() != nullptr) {
+				// NOTE:
+				//   this packet is also sent during live games,
+				//   during which we should just ignore it (the
+				//   server does sync-checking for us)
+				netcode::UnpackPacket pckt(packet, 1);
 
-					int cmdID;
-					unsigned char cmdOpt;
-					pckt >> cmdID;
-					pckt >> cmdOpt;
+				unsigned char playerNum; pckt >> playerNum;
+				          int  frameNum; pckt >> frameNum;
+				unsigned  int  checkSum; pckt >> checkSum;
 
-					Command c(cmdID, cmdOpt);
-					c.params.reserve(numParams);
+				const unsigned int ourCheckSum = localSyncChecksums[frameNum];
+				const CPlayer* player = playerHandler->Player(playerNum);
 
-					for (int a = 0; a < numParams; ++a) {
-						float param; pckt >> param;
-						c.PushParam(param);
-					}
+				// check if our checksum for this frame matches what
+				// player <playerNum> sent to the server at the same
+				// frame in the original game (in case of a demo)
+				if (playerNum == gu->myPlayerNum) { break; }
+				if (checkSum == ourCheckSum) { break; }
 
-					selectedUnitsHandler.NetOrder(c, playerNum);
-					AddTraffic(playerNum, packetCode, dataLength);
-				} catch (const netcode::UnpackPacketException& ex) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_COMMAND] exception \"%s\"", __func__, ex.what());
-				}
+				const char* pName = player->name.c_str();
+				const char* pType = player->IsSpectator()? "spectator": "player";
+				const char* fmtStr = "[DESYNC WARNING] checksum %x from demo %s %d (%s) does not match our checksum %x for frame-number %d";
 
-				break;
+				LOG_L(L_ERROR, fmtStr, checkSum, pType, playerNum, pName, ourCheckSum, frameNum);
 			}
+#endif
+		} break;
 
-			case NETMSG_SELECT: {
-				try {
-					netcode::UnpackPacket pckt(packet, 1);
 
-					unsigned short packetSize; pckt >> packetSize;
-					unsigned char playerNum; pckt >> playerNum;
-					const unsigned int numUnitIDs = (packetSize - 4) / sizeof(short int);
+		case NETMSG_COMMAND: {
+			try {
+				netcode::UnpackPacket pckt(packet, 1);
 
-					if (!playerHandler->IsValidPlayer(playerNum))
-						throw netcode::UnpackPacketException("Invalid player number");
+				unsigned short packetSize; pckt >> packetSize;
+				unsigned char playerNum; pckt >> playerNum;
+				const unsigned int numParams = (packetSize - 9) / sizeof(float);
 
-					std::vector<int> selectedUnitIDs;
-					selectedUnitIDs.reserve(numUnitIDs);
+				if (!playerHandler->IsValidPlayer(playerNum))
+					throw netcode::UnpackPacketException("Invalid player number");
 
-					for (int a = 0; a < numUnitIDs; ++a) {
-						short int unitID; pckt >> unitID;
-						const CUnit* unit = unitHandler->GetUnit(unitID);
+				int cmdID;
+				unsigned char cmdOpt;
+				pckt >> cmdID;
+				pckt >> cmdOpt;
 
-						if (unit == NULL) {
-							// unit was destroyed in simulation (without its ID being recycled)
-							// after sending a command but before receiving it back, more likely
-							// to happen in high-latency situations
-							// LOG_L(L_WARNING, "[NETMSG_SELECT] invalid unitID (%i) from player %i", unitID, playerNum);
-							continue;
-						}
-
-						// if in godMode, this is always true for any player
-						if (playerHandler->Player(playerNum)->CanControlTeam(unit->team)) {
-							selectedUnitIDs.push_back(unitID);
-						}
-					}
+				Command c(cmdID, cmdOpt);
+				c.params.reserve(numParams);
 
-					selectedUnitsHandler.NetSelect(selectedUnitIDs, playerNum);
-					AddTraffic(playerNum, packetCode, dataLength);
-				} catch (const netcode::UnpackPacketException& ex) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_SELECT] exception \"%s\"", __func__, ex.what());
+				for (int a = 0; a < numParams; ++a) {
+					float param; pckt >> param;
+					c.PushParam(param);
 				}
 
-				break;
+				selectedUnitsHandler.NetOrder(c, playerNum);
+				AddTraffic(playerNum, packetCode, dataLength);
+			} catch (const netcode::UnpackPacketException& ex) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_COMMAND] exception \"%s\"", __func__, ex.what());
 			}
 
-			case NETMSG_AICOMMAND:
-			case NETMSG_AICOMMAND_TRACKED: {
-				try {
-					netcode::UnpackPacket pckt(packet, 1);
-					short int psize;
-					pckt >> psize;
-					unsigned char player;
-					pckt >> player;
-					unsigned char aiID;
-					pckt >> aiID;
-
-					if (!playerHandler->IsValidPlayer(player))
-						throw netcode::UnpackPacketException("Invalid player number");
-
-					short int unitid;
-					pckt >> unitid;
-					if (unitid < 0 || static_cast<size_t>(unitid) >= unitHandler->MaxUnits())
-						throw netcode::UnpackPacketException("Invalid unit ID");
+			break;
+		}
 
-					int cmd_id;
-					unsigned char cmd_opt;
-					pckt >> cmd_id;
-					pckt >> cmd_opt;
+		case NETMSG_SELECT: {
+			try {
+				netcode::UnpackPacket pckt(packet, 1);
 
-					Command c(cmd_id, cmd_opt);
-					if (packetCode == NETMSG_AICOMMAND_TRACKED) {
-						pckt >> c.aiCommandId;
-					}
+				unsigned short packetSize; pckt >> packetSize;
+				unsigned char playerNum; pckt >> playerNum;
+				const unsigned int numUnitIDs = (packetSize - 4) / sizeof(short int);
 
-					// insert the command parameters
-					for (int a = 0; a < ((psize - 11) / 4); ++a) {
-						float param;
-						pckt >> param;
-						c.PushParam(param);
-					}
+				if (!playerHandler->IsValidPlayer(playerNum))
+					throw netcode::UnpackPacketException("Invalid player number");
 
-					selectedUnitsHandler.AiOrder(unitid, c, player);
-					AddTraffic(player, packetCode, dataLength);
-				} catch (const netcode::UnpackPacketException& ex) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_AICOMMAND*] exception \"%s\"", __func__, ex.what());
-				}
-				break;
-			}
+				// validity and ownership filtering happens in NetSelect
+				std::vector<int> selectedUnitIDs;
+				selectedUnitIDs.reserve(numUnitIDs);
 
-			case NETMSG_AICOMMANDS: {
-				try {
-					netcode::UnpackPacket pckt(packet, 3);
-					unsigned char player;
-					pckt >> player;
-
-					if (!playerHandler->IsValidPlayer(player))
-						throw netcode::UnpackPacketException("Invalid player number");
-
-					unsigned char aiID;
-					unsigned char pairwise;
-					unsigned int sameCmdID;
-					unsigned char sameCmdOpt;
-					unsigned short sameCmdParamSize;
-
-					pckt >> aiID;
-					pckt >> pairwise;
-					pckt >> sameCmdID;
-					pckt >> sameCmdOpt;
-					pckt >> sameCmdParamSize;
-					// parse the unit list
-					vector<int> unitIDs;
-					short int unitCount;
-					pckt >> unitCount;
-					for (int u = 0; u < unitCount; u++) {
-						short int unitID;
-						pckt >> unitID;
-						unitIDs.push_back(unitID);
-					}
-					// parse the command list
-					vector<Command> commands;
-					short int commandCount;
-					pckt >> commandCount;
-					for (int c = 0; c < commandCount; c++) {
-						int cmd_id;
-						unsigned char cmd_opt;
-						if (sameCmdID == 0)
-							pckt >> cmd_id;
-						else
-							cmd_id = sameCmdID;
-						if (sameCmdOpt == 0xFF)
-							pckt >> cmd_opt;
-						else
-							cmd_opt = sameCmdOpt;
-
-						Command cmd(cmd_id, cmd_opt);
-						short int paramCount;
-						if (sameCmdParamSize == 0xFFFF)
-							pckt >> paramCount;
-						else
-							paramCount = sameCmdParamSize;
-						for (int p = 0; p < paramCount; p++) {
-							float param;
-							pckt >> param;
-							cmd.PushParam(param);
-						}
-						commands.push_back(cmd);
-					}
-					// apply the commands
-					if (pairwise) {
-						for (int x = 0; x < std::min(unitCount, commandCount); ++x) {
-							selectedUnitsHandler.AiOrder(unitIDs[x], commands[x], player);
-						}
-					}
-					else {
-						for (int c = 0; c < commandCount; c++) {
-							for (int u = 0; u < unitCount; u++) {
-								selectedUnitsHandler.AiOrder(unitIDs[u], commands[c], player);
-							}
-						}
-					}
-					AddTraffic(player, packetCode, dataLength);
-				} catch (const netcode::UnpackPacketException& ex) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_AICOMMANDS] exception \"%s\"", __func__, ex.what());
+				for (int a = 0; a < numUnitIDs; ++a) {
+					short int unitID; pckt >> unitID;
+					selectedUnitIDs.push_back(unitID);
 				}
-				break;
+
+				selectedUnitsHandler.NetSelect(selectedUnitIDs, playerNum);
+				AddTraffic(playerNum, packetCode, dataLength);
+			} catch (const netcode::UnpackPacketException& ex) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_SELECT] exception \"%s\"", __func__, ex.what());
 			}
 
-			case NETMSG_AISHARE: {
-				try {
-					netcode::UnpackPacket pckt(packet, 1);
-
-					short int numBytes;
-					unsigned char player;
-					unsigned char aiID;
-					unsigned char srcTeamID;
-					unsigned char dstTeamID;
-					float metalShare;
-					float energyShare;
-
-					pckt >> numBytes;
-					pckt >> player;
-					if (!playerHandler->IsValidPlayer(player))
-						throw netcode::UnpackPacketException("Invalid player number");
-
-					pckt >> aiID;
-
-					// total message length
-					const int fixedLen = (1 + sizeof(short) + 3 + (2 * sizeof(float)));
-					const int variableLen = numBytes - fixedLen;
-					const int numUnitIDs = variableLen / sizeof(short); // each unitID is two bytes
-
-					pckt >> srcTeamID;
-					pckt >> dstTeamID;
-					pckt >> metalShare;
-					pckt >> energyShare;
-
-					CTeam* srcTeam = teamHandler->Team(srcTeamID);
-					CTeam* dstTeam = teamHandler->Team(dstTeamID);
-
-					if (metalShare > 0.0f) {
-						if (eventHandler.AllowResourceTransfer(srcTeamID, dstTeamID, "m", metalShare)) {
-							srcTeam->res.metal                       -= metalShare;
-							srcTeam->resSent.metal                   += metalShare;
-							srcTeam->GetCurrentStats().metalSent     += metalShare;
-							dstTeam->res.metal                       += metalShare;
-							dstTeam->resReceived.metal               += metalShare;
-							dstTeam->GetCurrentStats().metalReceived += metalShare;
-						}
-					}
-					if (energyShare > 0.0f) {
-						if (eventHandler.AllowResourceTransfer(srcTeamID, dstTeamID, "e", energyShare)) {
-							srcTeam->res.energy                       -= energyShare;
-							srcTeam->resSent.energy                   += energyShare;
-							srcTeam->GetCurrentStats().energySent     += energyShare;
-							dstTeam->res.energy                       += energyShare;
-							dstTeam->resReceived.energy               += energyShare;
-							dstTeam->GetCurrentStats().energyReceived += energyShare;
-						}
-					}
+			break;
+		}
+
+		case NETMSG_SELECT_DELTA: {
+			try {
+				netcode::UnpackPacket pckt(packet, 1);
 
-					for (int i = 0, j = fixedLen; i < numUnitIDs; i++, j += sizeof(short)) {
-						short int unitID;
-						pckt >> unitID;
+				unsigned short packetSize; pckt >> packetSize;
+				unsigned char playerNum; pckt >> playerNum;
 
-						CUnit* u = unitHandler->GetUnit(unitID);
+				if (!playerHandler->IsValidPlayer(playerNum))
+					throw netcode::UnpackPacketException("Invalid player number");
 
-						if (u == nullptr)
-							throw netcode::UnpackPacketException("Invalid unit ID");
+				// both lists arrive as varint gaps between sorted IDs;
+				// each entry takes at least one byte, so any claimed
+				// count beyond the packet size is garbage
+				const unsigned int numRemoved = pckt.UnpackUVarint();
 
-						// ChangeTeam() handles the AllowUnitTransfer() LuaRule
-						if (u->team == srcTeamID && !u->beingBuilt) {
-							u->ChangeTeam(dstTeamID, CUnit::ChangeGiven);
-						}
-					}
-				} catch (const netcode::UnpackPacketException& ex) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_AISHARE] exception \"%s\"", __func__, ex.what());
-				}
-				break;
-			}
+				if (numRemoved > packetSize)
+					throw netcode::UnpackPacketException("Unpack failure (removed-ID count)");
 
+				std::vector<int> removedIDs(numRemoved);
+				int prevID = 0;
 
-			case NETMSG_LOGMSG: {
-				try {
-					netcode::UnpackPacket unpack(packet, sizeof(uint8_t));
+				for (int& unitID: removedIDs) {
+					unitID = (prevID += pckt.UnpackUVarint());
+				}
 
-					std::uint16_t packetSize;
-					std::uint8_t playerNum;
-					std::uint8_t logLevel;
-					std::string logString;
+				const unsigned int numAdded = pckt.UnpackUVarint();
 
-					unpack >> packetSize;
-					if (packetSize != packet->length)
-						throw netcode::UnpackPacketException("invalid size");
+				if (numAdded > packetSize)
+					throw netcode::UnpackPacketException("Unpack failure (added-ID count)");
 
-					unpack >> playerNum;
-					if (!playerHandler->IsValidPlayer(playerNum))
-						throw netcode::UnpackPacketException("invalid player number");
+				std::vector<int> addedIDs(numAdded);
+				prevID = 0;
 
-					unpack >> logLevel;
-					unpack >> logString;
+				for (int& unitID: addedIDs) {
+					unitID = (prevID += pckt.UnpackUVarint());
+				}
 
-					const CPlayer* player = playerHandler->Player(playerNum);
+				selectedUnitsHandler.NetSelectDelta(removedIDs, addedIDs, playerNum);
+				AddTraffic(playerNum, packetCode, dataLength);
+			} catch (const netcode::UnpackPacketException& ex) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_SELECT_DELTA] exception \"%s\"", __func__, ex.what());
+			}
 
-					const char* fmtStr = "[Game::%s][LOGMSG] sender=\"%s\" string=\"%s\"";
-					const char* logStr = logString.c_str();
+			break;
+		}
 
-					switch (logLevel) {
-						case LOG_LEVEL_INFO   : { LOG_L(L_INFO   , fmtStr, __func__, player->name.c_str(), logStr); } break;
-						case LOG_LEVEL_DEBUG  : { LOG_L(L_DEBUG  , fmtStr, __func__, player->name.c_str(), logStr); } break;
-						case LOG_LEVEL_ERROR  : { LOG_L(L_ERROR  , fmtStr, __func__, player->name.c_str(), logStr); } break;
-						case LOG_LEVEL_FATAL  : { LOG_L(L_FATAL  , fmtStr, __func__, player->name.c_str(), logStr); } break;
-						case LOG_LEVEL_NOTICE : { LOG_L(L_NOTICE , fmtStr, __func__, player->name.c_str(), logStr); } break;
-						case LOG_LEVEL_WARNING: { LOG_L(L_WARNING, fmtStr, __func__, player->name.c_str(), logStr); } break;
-					}
-				} catch (const netcode::UnpackPacketException& ex) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_LOGMSG] exception \"%s\"", __func__, ex.what());
+		case NETMSG_AICOMMAND:
+		case NETMSG_AICOMMAND_TRACKED: {
+			try {
+				netcode::UnpackPacket pckt(packet, 1);
+				short int psize;
+				pckt >> psize;
+				unsigned char player;
+				pckt >> player;
+				unsigned char aiID;
+				pckt >> aiID;
+
+				if (!playerHandler->IsValidPlayer(player))
+					throw netcode::UnpackPacketException("Invalid player number");
+
+				short int unitid;
+				pckt >> unitid;
+				if (unitid < 0 || static_cast<size_t>(unitid) >= unitHandler->MaxUnits())
+					throw netcode::UnpackPacketException("Invalid unit ID");
+
+				int cmd_id;
+				unsigned char cmd_opt;
+				pckt >> cmd_id;
+				pckt >> cmd_opt;
+
+				Command c(cmd_id, cmd_opt);
+				if (packetCode == NETMSG_AICOMMAND_TRACKED) {
+					pckt >> c.aiCommandId;
+				}
+
+				// insert the command parameters
+				for (int a = 0; a < ((psize - 11) / 4); ++a) {
+					float param;
+					pckt >> param;
+					c.PushParam(param);
 				}
-			} break;
 
-			case NETMSG_LUAMSG: {
-				try {
-					netcode::UnpackPacket unpack(packet, sizeof(uint8_t));
+				selectedUnitsHandler.AiOrder(unitid, c, player);
+				AddTraffic(player, packetCode, dataLength);
+			} catch (const netcode::UnpackPacketException& ex) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_AICOMMAND*] exception \"%s\"", __func__, ex.what());
+			}
+			break;
+		}
 
-					std::uint16_t packetSize;
-					std::uint8_t playerNum;
-					std::uint16_t script;
-					std::uint8_t mode;
-					std::vector<std::uint8_t> data;
+		case NETMSG_AICOMMANDS: {
+			try {
+				netcode::UnpackPacket pckt(packet, 3);
+				unsigned char player;
+				pckt >> player;
+
+				if (!playerHandler->IsValidPlayer(player))
+					throw netcode::UnpackPacketException("Invalid player number");
+
+				unsigned char aiID;
+				unsigned char pairwise;
+				unsigned int sameCmdID;
+				unsigned char sameCmdOpt;
+				unsigned short sameCmdParamSize;
+
+				pckt >> aiID;
+				pckt >> pairwise;
+				pckt >> sameCmdID;
+				pckt >> sameCmdOpt;
+				pckt >> sameCmdParamSize;
+				// parse the unit list
+				vector<int> unitIDs;
+				short int unitCount;
+				pckt >> unitCount;
+				for (int u = 0; u < unitCount; u++) {
+					short int unitID;
+					pckt >> unitID;
+					unitIDs.push_back(unitID);
+				}
+				// parse the command list
+				vector<Command> commands;
+				short int commandCount;
+				pckt >> commandCount;
+				for (int c = 0; c < commandCount; c++) {
+					int cmd_id;
+					unsigned char cmd_opt;
+					if (sameCmdID == 0)
+						pckt >> cmd_id;
+					else
+						cmd_id = sameCmdID;
+					if (sameCmdOpt == 0xFF)
+						pckt >> cmd_opt;
+					else
+						cmd_opt = sameCmdOpt;
+
+					Command cmd(cmd_id, cmd_opt);
+					short int paramCount;
+					if (sameCmdParamSize == 0xFFFF)
+						pckt >> paramCount;
+					else
+						paramCount = sameCmdParamSize;
+					for (int p = 0; p < paramCount; p++) {
+						float param;
+						pckt >> param;
+						cmd.PushParam(param);
+					}
+					commands.push_back(cmd);
+				}
+				// apply the commands
+				if (pairwise) {
+					for (int x = 0; x < std::min(unitCount, commandCount); ++x) {
+						selectedUnitsHandler.AiOrder(unitIDs[x], commands[x], player);
+					}
+				}
+				else {
+					for (int c = 0; c < commandCount; c++) {
+						for (int u = 0; u < unitCount; u++) {
+							selectedUnitsHandler.AiOrder(unitIDs[u], commands[c], player);
+						}
+					}
+				}
+				AddTraffic(player, packetCode, dataLength);
+			} catch (const netcode::UnpackPacketException& ex) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_AICOMMANDS] exception \"%s\"", __func__, ex.what());
+			}
+			break;
+		}
 
-					unpack >> packetSize;
-					if (packetSize != packet->length)
-						throw netcode::UnpackPacketException("invalid packet-size");
+		case NETMSG_AISHARE: {
+			try {
+				netcode::UnpackPacket pckt(packet, 1);
 
-					unpack >> playerNum;
-					if (!playerHandler->IsValidPlayer(playerNum))
-						throw netcode::UnpackPacketException("invalid player number");
+				short int numBytes;
+				unsigned char player;
+				unsigned char aiID;
+				unsigned char srcTeamID;
+				unsigned char dstTeamID;
+				float metalShare;
+				float energyShare;
 
-					data.resize(packetSize - (1 + sizeof(packetSize) + sizeof(playerNum) + sizeof(script) + sizeof(mode)));
+				pckt >> numBytes;
+				pckt >> player;
+				if (!playerHandler->IsValidPlayer(player))
+					throw netcode::UnpackPacketException("Invalid player number");
 
-					unpack >> script;
-					unpack >> mode;
-					unpack >> data;
+				pckt >> aiID;
 
-					CLuaHandle::HandleLuaMsg(playerNum, script, mode, data);
-					AddTraffic(playerNum, packetCode, dataLength);
-				} catch (const netcode::UnpackPacketException& ex) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_LUAMSG] exception \"%s\"", __func__, ex.what());
-				}
-			} break;
+				// total message length
+				const int fixedLen = (1 + sizeof(short) + 3 + (2 * sizeof(float)));
+				const int variableLen = numBytes - fixedLen;
+				const int numUnitIDs = variableLen / sizeof(short); // each unitID is two bytes
 
+				pckt >> srcTeamID;
+				pckt >> dstTeamID;
+				pckt >> metalShare;
+				pckt >> energyShare;
 
-			case NETMSG_SHARE: {
-				const unsigned char player = inbuf[1];
-				if (!playerHandler->IsValidPlayer(player)) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_SHARE] invalid player-number %i", __func__, player);
-					break;
-				}
-				const int srcTeamID = playerHandler->Player(player)->team;
-				const int dstTeamID = inbuf[2];
-				const bool shareUnits = !!inbuf[3];
 				CTeam* srcTeam = teamHandler->Team(srcTeamID);
 				CTeam* dstTeam = teamHandler->Team(dstTeamID);
-				const float metalShare  = Clamp(*(float*)&inbuf[4], 0.0f, (float)srcTeam->res.metal);
-				const float energyShare = Clamp(*(float*)&inbuf[8], 0.0f, (float)srcTeam->res.energy);
 
 				if (metalShare > 0.0f) {
 					if (eventHandler.AllowResourceTransfer(srcTeamID, dstTeamID, "m", metalShare)) {
@@ -936,477 +925,602 @@ void CGame::ClientReadNet()
 					}
 				}
 
-				if (shareUnits) {
-					vector<int>& netSelUnits = selectedUnitsHandler.netSelected[player];
-					vector<int>::const_iterator ui;
+				for (int i = 0, j = fixedLen; i < numUnitIDs; i++, j += sizeof(short)) {
+					short int unitID;
+					pckt >> unitID;
 
-					for (ui = netSelUnits.begin(); ui != netSelUnits.end(); ++ui) {
-						CUnit* unit = unitHandler->GetUnit(*ui);
+					CUnit* u = unitHandler->GetUnit(unitID);
 
-						if (unit == nullptr)
-							continue;
-						if (unit->UnderFirstPersonControl())
-							continue;
-						// in godmode we can have units selected that are not ours
-						if (unit->team != srcTeamID)
-							continue;
-
-						if (unit->isDead)
-							continue;
-						if (unit->IsCrashing())
-							continue;
+					if (u == nullptr)
+						throw netcode::UnpackPacketException("Invalid unit ID");
 
-						unit->ChangeTeam(dstTeamID, CUnit::ChangeGiven);
+					// ChangeTeam() handles the AllowUnitTransfer() LuaRule
+					if (u->team == srcTeamID && !u->beingBuilt) {
+						u->ChangeTeam(dstTeamID, CUnit::ChangeGiven);
 					}
+				}
+			} catch (const netcode::UnpackPacketException& ex) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_AISHARE] exception \"%s\"", __func__, ex.what());
+			}
+			break;
+		}
+
 
-					netSelUnits.clear();
+		case NETMSG_LOGMSG: {
+			try {
+				netcode::UnpackPacket unpack(packet, sizeof(uint8_t));
+
+				std::uint16_t packetSize;
+				std::uint8_t playerNum;
+				std::uint8_t logLevel;
+				std::string logString;
+
+				unpack >> packetSize;
+				if (packetSize != packet->length)
+					throw netcode::UnpackPacketException("invalid size");
+
+				unpack >> playerNum;
+				if (!playerHandler->IsValidPlayer(playerNum))
+					throw netcode::UnpackPacketException("invalid player number");
+
+				unpack >> logLevel;
+				unpack >> logString;
+
+				const CPlayer* player = playerHandler->Player(playerNum);
+
+				const char* fmtStr = "[Game::%s][LOGMSG] sender=\"%s\" string=\"%s\"";
+				const char* logStr = logString.c_str();
+
+				switch (logLevel) {
+					case LOG_LEVEL_INFO   : { LOG_L(L_INFO   , fmtStr, __func__, player->name.c_str(), logStr); } break;
+					case LOG_LEVEL_DEBUG  : { LOG_L(L_DEBUG  , fmtStr, __func__, player->name.c_str(), logStr); } break;
+					case LOG_LEVEL_ERROR  : { LOG_L(L_ERROR  , fmtStr, __func__, player->name.c_str(), logStr); } break;
+					case LOG_LEVEL_FATAL  : { LOG_L(L_FATAL  , fmtStr, __func__, player->name.c_str(), logStr); } break;
+					case LOG_LEVEL_NOTICE : { LOG_L(L_NOTICE , fmtStr, __func__, player->name.c_str(), logStr); } break;
+					case LOG_LEVEL_WARNING: { LOG_L(L_WARNING, fmtStr, __func__, player->name.c_str(), logStr); } break;
 				}
-				AddTraffic(player, packetCode, dataLength);
-				break;
+			} catch (const netcode::UnpackPacketException& ex) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_LOGMSG] exception \"%s\"", __func__, ex.what());
 			}
+		} break;
 
-			case NETMSG_SETSHARE: {
-				const unsigned char player = inbuf[1];
-				if (!playerHandler->IsValidPlayer(player)) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_SETSHARE] invalid player-number %i", __func__, player);
-					break;
+		case NETMSG_LUAMSG: {
+			try {
+				netcode::UnpackPacket unpack(packet, sizeof(uint8_t));
+
+				std::uint16_t packetSize;
+				std::uint8_t playerNum;
+				std::uint16_t script;
+				std::uint8_t mode;
+				std::vector<std::uint8_t> data;
+
+				unpack >> packetSize;
+				if (packetSize != packet->length)
+					throw netcode::UnpackPacketException("invalid packet-size");
+
+				unpack >> playerNum;
+				if (!playerHandler->IsValidPlayer(playerNum))
+					throw netcode::UnpackPacketException("invalid player number");
+
+				data.resize(packetSize - (1 + sizeof(packetSize) + sizeof(playerNum) + sizeof(script) + sizeof(mode)));
+
+				unpack >> script;
+				unpack >> mode;
+				unpack >> data;
+
+				CLuaHandle::HandleLuaMsg(playerNum, script, mode, data);
+				AddTraffic(playerNum, packetCode, dataLength);
+			} catch (const netcode::UnpackPacketException& ex) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_LUAMSG] exception \"%s\"", __func__, ex.what());
+			}
+		} break;
+
+
+		case NETMSG_SHARE: {
+			const unsigned char player = inbuf[1];
+			if (!playerHandler->IsValidPlayer(player)) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_SHARE] invalid player-number %i", __func__, player);
+				break;
+			}
+			const int srcTeamID = playerHandler->Player(player)->team;
+			const int dstTeamID = inbuf[2];
+			const bool shareUnits = !!inbuf[3];
+			CTeam* srcTeam = teamHandler->Team(srcTeamID);
+			CTeam* dstTeam = teamHandler->Team(dstTeamID);
+			const float metalShare  = Clamp(*(float*)&inbuf[4], 0.0f, (float)srcTeam->res.metal);
+			const float energyShare = Clamp(*(float*)&inbuf[8], 0.0f, (float)srcTeam->res.energy);
+
+			if (metalShare > 0.0f) {
+				if (eventHandler.AllowResourceTransfer(srcTeamID, dstTeamID, "m", metalShare)) {
+					srcTeam->res.metal                       -= metalShare;
+					srcTeam->resSent.metal                   += metalShare;
+					srcTeam->GetCurrentStats().metalSent     += metalShare;
+					dstTeam->res.metal                       += metalShare;
+					dstTeam->resReceived.metal               += metalShare;
+					dstTeam->GetCurrentStats().metalReceived += metalShare;
 				}
-				const unsigned char team = inbuf[2];
-				if (!teamHandler->IsValidTeam(team)) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_SETSHARE] invalid team-number %i", __func__, team);
-					break;
+			}
+			if (energyShare > 0.0f) {
+				if (eventHandler.AllowResourceTransfer(srcTeamID, dstTeamID, "e", energyShare)) {
+					srcTeam->res.energy                       -= energyShare;
+					srcTeam->resSent.energy                   += energyShare;
+					srcTeam->GetCurrentStats().energySent     += energyShare;
+					dstTeam->res.energy                       += energyShare;
+					dstTeam->resReceived.energy               += energyShare;
+					dstTeam->GetCurrentStats().energyReceived += energyShare;
 				}
+			}
 
-				const float metalShare = *(float*)&inbuf[3];
-				const float energyShare = *(float*)&inbuf[7];
+			if (shareUnits) {
+				vector<int>& netSelUnits = selectedUnitsHandler.netSelected[player];
+				vector<int>::const_iterator ui;
 
-				if (eventHandler.AllowResourceLevel(team, "m", metalShare))
-					teamHandler->Team(team)->resShare.metal = metalShare;
+				for (ui = netSelUnits.begin(); ui != netSelUnits.end(); ++ui) {
+					CUnit* unit = unitHandler->GetUnit(*ui);
 
-				if (eventHandler.AllowResourceLevel(team, "e", energyShare))
-					teamHandler->Team(team)->resShare.energy = energyShare;
+					if (unit == nullptr)
+						continue;
+					if (unit->UnderFirstPersonControl())
+						continue;
+					// in godmode we can have units selected that are not ours
+					if (unit->team != srcTeamID)
+						continue;
 
-				AddTraffic(player, packetCode, dataLength);
+					if (unit->isDead)
+						continue;
+					if (unit->IsCrashing())
+						continue;
+
+					unit->ChangeTeam(dstTeamID, CUnit::ChangeGiven);
+				}
+
+				netSelUnits.clear();
+			}
+			AddTraffic(player, packetCode, dataLength);
+			break;
+		}
+
+		case NETMSG_SETSHARE: {
+			const unsigned char player = inbuf[1];
+			if (!playerHandler->IsValidPlayer(player)) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_SETSHARE] invalid player-number %i", __func__, player);
 				break;
 			}
-			case NETMSG_MAPDRAW: {
-				int player = inMapDrawer->GotNetMsg(packet);
-				if (player >= 0)
-					AddTraffic(player, packetCode, dataLength);
+			const unsigned char team = inbuf[2];
+			if (!teamHandler->IsValidTeam(team)) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_SETSHARE] invalid team-number %i", __func__, team);
 				break;
 			}
-			case NETMSG_TEAM: {
-				const unsigned char player = inbuf[1];
-				if (!playerHandler->IsValidPlayer(player)) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_TEAM] invalid player-number %i", __func__, player);
-					break;
-				}
 
-				const unsigned char action = inbuf[2];
-				const int fromTeam = playerHandler->Player(player)->team;
+			const float metalShare = *(float*)&inbuf[3];
+			const float energyShare = *(float*)&inbuf[7];
 
-				switch (action) {
-					case TEAMMSG_GIVEAWAY: {
-						const unsigned char toTeam = inbuf[3];
-						const unsigned char giverTeam = inbuf[4];
-
-						if (!teamHandler->IsValidTeam(toTeam) || !teamHandler->IsValidTeam(giverTeam)) {
-							LOG_L(L_ERROR, "[Game::%s][TEAMMSG_GIVEWAY] invalid team-numbers {%i,%i}", __func__, toTeam, giverTeam);
-							break;
-						}
+			if (eventHandler.AllowResourceLevel(team, "m", metalShare))
+				teamHandler->Team(team)->resShare.metal = metalShare;
 
-						const int numPlayersInGiverTeam        = playerHandler->ActivePlayersInTeam(giverTeam).size();
-						const size_t numTotAIsInGiverTeam      = skirmishAIHandler.GetSkirmishAIsInTeam(giverTeam).size();
-						const size_t numControllersInGiverTeam = numPlayersInGiverTeam + numTotAIsInGiverTeam;
+			if (eventHandler.AllowResourceLevel(team, "e", energyShare))
+				teamHandler->Team(team)->resShare.energy = energyShare;
 
-						bool giveAwayOk = false;
+			AddTraffic(player, packetCode, dataLength);
+			break;
+		}
+		case NETMSG_MAPDRAW: {
+			int player = inMapDrawer->GotNetMsg(packet);
+			if (player >= 0)
+				AddTraffic(player, packetCode, dataLength);
+			break;
+		}
+		case NETMSG_TEAM: {
+			const unsigned char player = inbuf[1];
+			if (!playerHandler->IsValidPlayer(player)) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_TEAM] invalid player-number %i", __func__, player);
+				break;
+			}
 
-						if (giverTeam == fromTeam) {
-							// player is giving stuff from his own team
-							giveAwayOk = true;
+			const unsigned char action = inbuf[2];
+			const int fromTeam = playerHandler->Player(player)->team;
 
-							if (numPlayersInGiverTeam == 1) {
-								teamHandler->Team(giverTeam)->GiveEverythingTo(toTeam);
-							} else {
-								playerHandler->Player(player)->StartSpectating();
-							}
+			switch (action) {
+				case TEAMMSG_GIVEAWAY: {
+					const unsigned char toTeam = inbuf[3];
+					const unsigned char giverTeam = inbuf[4];
 
-							selectedUnitsHandler.ClearNetSelect(player);
-						} else {
-							// player is giving stuff from one of his AI teams
-							if (numPlayersInGiverTeam == 0) {
-								giveAwayOk = true;
-							}
-						}
-						if (giveAwayOk && (numControllersInGiverTeam == 1)) {
-							// team has no controller left now
-							teamHandler->Team(giverTeam)->GiveEverythingTo(toTeam);
-							teamHandler->Team(giverTeam)->SetLeader(-1);
-						}
-						CPlayer::UpdateControlledTeams();
+					if (!teamHandler->IsValidTeam(toTeam) || !teamHandler->IsValidTeam(giverTeam)) {
+						LOG_L(L_ERROR, "[Game::%s][TEAMMSG_GIVEWAY] invalid team-numbers {%i,%i}", __func__, toTeam, giverTeam);
 						break;
 					}
-					case TEAMMSG_RESIGN: {
-						if (!playing)
-							break;
-
-						playerHandler->Player(player)->StartSpectating();
-
-						// update all teams of which the player is leader
-						for (size_t t = 0; t < teamHandler->ActiveTeams(); ++t) {
-							CTeam* team = teamHandler->Team(t);
-
-							if (team->GetLeader() != player)
-								continue;
-
-							const std::vector<int> &teamPlayers = playerHandler->ActivePlayersInTeam(t);
-							const std::vector<unsigned char> &teamAIs  = skirmishAIHandler.GetSkirmishAIsInTeam(t);
-
-							if ((teamPlayers.size() + teamAIs.size()) == 0) {
-								// no controllers left in team
-								//team.active = false;
-								team->SetLeader(-1);
-							} else if (teamPlayers.empty()) {
-								// no human player left in team
-								team->SetLeader(skirmishAIHandler.GetSkirmishAI(teamAIs[0])->hostPlayer);
-							} else {
-								// still human controllers left in team
-								team->SetLeader(teamPlayers[0]);
-							}
+
+					const int numPlayersInGiverTeam        = playerHandler->ActivePlayersInTeam(giverTeam).size();
+					const size_t numTotAIsInGiverTeam      = skirmishAIHandler.GetSkirmishAIsInTeam(giverTeam).size();
+					const size_t numControllersInGiverTeam = numPlayersInGiverTeam + numTotAIsInGiverTeam;
+
+					bool giveAwayOk = false;
+
+					if (giverTeam == fromTeam) {
+						// player is giving stuff from his own team
+						giveAwayOk = true;
+
+						if (numPlayersInGiverTeam == 1) {
+							teamHandler->Team(giverTeam)->GiveEverythingTo(toTeam);
+						} else {
+							playerHandler->Player(player)->StartSpectating();
 						}
-						LOG_L(L_DEBUG, "Player %i (%s) resigned and is now spectating!",
-								player,
-								playerHandler->Player(player)->name.c_str());
+
 						selectedUnitsHandler.ClearNetSelect(player);
-						CPlayer::UpdateControlledTeams();
-						break;
-					}
-					case TEAMMSG_JOIN_TEAM: {
-						const unsigned char newTeam = inbuf[3];
-						if (!teamHandler->IsValidTeam(newTeam)) {
-							LOG_L(L_ERROR, "[Game::%s][TEAMMSG_JOIN_TEAM] invalid team-number %i", __func__, newTeam);
-							break;
+					} else {
+						// player is giving stuff from one of his AI teams
+						if (numPlayersInGiverTeam == 0) {
+							giveAwayOk = true;
 						}
-
-						teamHandler->Team(newTeam)->AddPlayer(player);
-						break;
-					}
-					case TEAMMSG_TEAM_DIED: {
-						// silently drop since we can calculate this ourself, altho it's useful info to store in replays
-						break;
 					}
-					default: {
-						LOG_L(L_ERROR, "[Game::%s][NETMSG_TEAM] unknown action %i from player %i", __func__, action, player);
+					if (giveAwayOk && (numControllersInGiverTeam == 1)) {
+						// team has no controller left now
+						teamHandler->Team(giverTeam)->GiveEverythingTo(toTeam);
+						teamHandler->Team(giverTeam)->SetLeader(-1);
 					}
+					CPlayer::UpdateControlledTeams();
+					break;
 				}
-				AddTraffic(player, packetCode, dataLength);
-				break;
-			}
-			case NETMSG_GAMEOVER: {
-				const unsigned char player = inbuf[1];
-				// silently drop since we can calculate this ourself, altho it's useful info to store in replays
-				AddTraffic(player, packetCode, dataLength);
-				break;
-			}
-			case NETMSG_TEAMSTAT: { /* LadderBot (dedicated client) only */ } break;
-			case NETMSG_REQUEST_TEAMSTAT: { /* LadderBot (dedicated client) only */ } break;
-
-			case NETMSG_AI_CREATED: {
-				try {
-					netcode::UnpackPacket pckt(packet, 2);
-					unsigned char playerId;
-					pckt >> playerId;
-					unsigned char skirmishAIId;
-					pckt >> skirmishAIId;
-					unsigned char aiTeamId;
-					pckt >> aiTeamId;
-					std::string aiName;
-					pckt >> aiName;
-					CTeam* tai = teamHandler->Team(aiTeamId);
-					const unsigned isLocal = (playerId == gu->myPlayerNum);
+				case TEAMMSG_RESIGN: {
+					if (!playing)
+						break;
 
-					if (isLocal) {
-						const SkirmishAIData& aiData = *(skirmishAIHandler.GetLocalSkirmishAIInCreation(aiTeamId));
-						if (skirmishAIHandler.IsActiveSkirmishAI(skirmishAIId)) {
-							#ifdef DEBUG
-								// we will end up here for AIs defined in the start script
-								const SkirmishAIData* curAIData = skirmishAIHandler.GetSkirmishAI(skirmishAIId);
-								assert((aiData.team == curAIData->team) && (aiData.name == curAIData->name) && (aiData.hostPlayer == curAIData->hostPlayer));
-							#endif
+					playerHandler->Player(player)->StartSpectating();
+
+					// update all teams of which the player is leader
+					for (size_t t = 0; t < teamHandler->ActiveTeams(); ++t) {
+						CTeam* team = teamHandler->Team(t);
+
+						if (team->GetLeader() != player)
+							continue;
+
+						const std::vector<int> &teamPlayers = playerHandler->ActivePlayersInTeam(t);
+						const std::vector<unsigned char> &teamAIs  = skirmishAIHandler.GetSkirmishAIsInTeam(t);
+
+						if ((teamPlayers.size() + teamAIs.size()) == 0) {
+							// no controllers left in team
+							//team.active = false;
+							team->SetLeader(-1);
+						} else if (teamPlayers.empty()) {
+							// no human player left in team
+							team->SetLeader(skirmishAIHandler.GetSkirmishAI(teamAIs[0])->hostPlayer);
 						} else {
-							// we will end up here for local AIs defined mid-game,
-							// eg. with /aicontrol
-							const std::string aiName = aiData.name + " "; // aiData would be invalid after the next line
-							skirmishAIHandler.AddSkirmishAI(aiData, skirmishAIId);
-							wordCompletion->AddWord(aiName, false, false, false);
+							// still human controllers left in team
+							team->SetLeader(teamPlayers[0]);
 						}
-					} else {
-						SkirmishAIData aiData;
-						aiData.team       = aiTeamId;
-						aiData.name       = aiName;
-						aiData.hostPlayer = playerId;
-						skirmishAIHandler.AddSkirmishAI(aiData, skirmishAIId);
-						wordCompletion->AddWord(aiData.name + " ", false, false, false);
-					}
-
-					if (!tai->HasLeader()) {
-						tai->SetLeader(playerId);
 					}
+					LOG_L(L_DEBUG, "Player %i (%s) resigned and is now spectating!",
+							player,
+							playerHandler->Player(player)->name.c_str());
+					selectedUnitsHandler.ClearNetSelect(player);
 					CPlayer::UpdateControlledTeams();
-					eventHandler.PlayerChanged(playerId);
-					if (isLocal) {
-						LOG("Skirmish AI being created for team %i ...", aiTeamId);
-						eoh->CreateSkirmishAI(skirmishAIId);
+					break;
+				}
+				case TEAMMSG_JOIN_TEAM: {
+					const unsigned char newTeam = inbuf[3];
+					if (!teamHandler->IsValidTeam(newTeam)) {
+						LOG_L(L_ERROR, "[Game::%s][TEAMMSG_JOIN_TEAM] invalid team-number %i", __func__, newTeam);
+						break;
 					}
-				} catch (const netcode::UnpackPacketException& ex) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_AI_CREATED] exception \"%s\"", __func__, ex.what());
+
+					teamHandler->Team(newTeam)->AddPlayer(player);
+					break;
 				}
-				break;
-			}
-			case NETMSG_AI_STATE_CHANGED: {
-				const unsigned char playerId     = inbuf[1];
-				if (!playerHandler->IsValidPlayer(playerId)) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_AI_STATE_CHANGED] invalid player-number %i", __func__, playerId);
+				case TEAMMSG_TEAM_DIED: {
+					// silently drop since we can calculate this ourself, altho it's useful info to store in replays
 					break;
 				}
-
-				const unsigned char skirmishAIId  = inbuf[2];
-				const ESkirmishAIStatus newState = (ESkirmishAIStatus) inbuf[3];
-				SkirmishAIData* aiData           = skirmishAIHandler.GetSkirmishAI(skirmishAIId);
-				const ESkirmishAIStatus oldState = aiData->status;
-				const unsigned aiTeamId          = aiData->team;
-				const bool isLuaAI               = aiData->isLuaAI;
-				const unsigned isLocal           = (aiData->hostPlayer == gu->myPlayerNum);
-				const size_t numPlayersInAITeam  = playerHandler->ActivePlayersInTeam(aiTeamId).size();
-				const size_t numAIsInAITeam      = skirmishAIHandler.GetSkirmishAIsInTeam(aiTeamId).size();
-				CTeam* tai                       = teamHandler->Team(aiTeamId);
-
-				aiData->status = newState;
-
-				if (isLocal && !isLuaAI && ((newState == SKIRMAISTATE_DIEING) || (newState == SKIRMAISTATE_RELOADING))) {
-					eoh->DestroySkirmishAI(skirmishAIId);
-				} else if (newState == SKIRMAISTATE_DEAD) {
-					if (oldState == SKIRMAISTATE_RELOADING) {
-						if (isLocal) {
-							LOG("Skirmish AI \"%s\" being reloaded for team %i ...",
-									aiData->name.c_str(), aiTeamId);
-							eoh->CreateSkirmishAI(skirmishAIId);
-						}
-					} else {
-						const std::string aiInstanceName = aiData->name;
-						wordCompletion->RemoveWord(aiData->name + " ");
-						skirmishAIHandler.RemoveSkirmishAI(skirmishAIId);
-						aiData = NULL; // not valid anymore after RemoveSkirmishAI()
-						// this could be done in the above function as well
-						if ((numPlayersInAITeam + numAIsInAITeam) == 1) {
-							// team has no controller left now
-							tai->SetLeader(-1);
-						}
-						CPlayer::UpdateControlledTeams();
-						eventHandler.PlayerChanged(playerId);
-						LOG("Skirmish AI \"%s\" (ID:%i), which controlled team %i is now dead",
-								aiInstanceName.c_str(), skirmishAIId, aiTeamId);
-					}
-				} else if (newState == SKIRMAISTATE_ALIVE) {
-					if (isLocal) {
-						// short-name and version of the AI is unsynced data
-						// -> only available on the AI host
-						LOG("Skirmish AI \"%s\" (ID:%i, Short-Name:\"%s\", "
-								"Version:\"%s\") took over control of team %i",
-								aiData->name.c_str(), skirmishAIId,
-								aiData->shortName.c_str(),
-								aiData->version.c_str(), aiTeamId);
+				default: {
+					LOG_L(L_ERROR, "[Game::%s][NETMSG_TEAM] unknown action %i from player %i", __func__, action, player);
+				}
+			}
+			AddTraffic(player, packetCode, dataLength);
+			break;
+		}
+		case NETMSG_GAMEOVER: {
+			const unsigned char player = inbuf[1];
+			// silently drop since we can calculate this ourself, altho it's useful info to store in replays
+			AddTraffic(player, packetCode, dataLength);
+			break;
+		}
+		case NETMSG_TEAMSTAT: { /* LadderBot (dedicated client) only */ } break;
+		case NETMSG_REQUEST_TEAMSTAT: { /* LadderBot (dedicated client) only */ } break;
+
+		case NETMSG_AI_CREATED: {
+			try {
+				netcode::UnpackPacket pckt(packet, 2);
+				unsigned char playerId;
+				pckt >> playerId;
+				unsigned char skirmishAIId;
+				pckt >> skirmishAIId;
+				unsigned char aiTeamId;
+				pckt >> aiTeamId;
+				std::string aiName;
+				pckt >> aiName;
+				CTeam* tai = teamHandler->Team(aiTeamId);
+				const unsigned isLocal = (playerId == gu->myPlayerNum);
+
+				if (isLocal) {
+					const SkirmishAIData& aiData = *(skirmishAIHandler.GetLocalSkirmishAIInCreation(aiTeamId));
+					if (skirmishAIHandler.IsActiveSkirmishAI(skirmishAIId)) {
+						#ifdef DEBUG
+							// we will end up here for AIs defined in the start script
+							const SkirmishAIData* curAIData = skirmishAIHandler.GetSkirmishAI(skirmishAIId);
+							assert((aiData.team == curAIData->team) && (aiData.name == curAIData->name) && (aiData.hostPlayer == curAIData->hostPlayer));
+						#endif
 					} else {
-						LOG("Skirmish AI \"%s\" (ID:%i) took over control of team %i",
-								aiData->name.c_str(), skirmishAIId, aiTeamId);
+						// we will end up here for local AIs defined mid-game,
+						// eg. with /aicontrol
+						const std::string aiName = aiData.name + " "; // aiData would be invalid after the next line
+						skirmishAIHandler.AddSkirmishAI(aiData, skirmishAIId);
+						wordCompletion->AddWord(aiName, false, false, false);
 					}
+				} else {
+					SkirmishAIData aiData;
+					aiData.team       = aiTeamId;
+					aiData.name       = aiName;
+					aiData.hostPlayer = playerId;
+					skirmishAIHandler.AddSkirmishAI(aiData, skirmishAIId);
+					wordCompletion->AddWord(aiData.name + " ", false, false, false);
 				}
-				break;
-			}
-			case NETMSG_ALLIANCE: {
-				const unsigned char player = inbuf[1];
 
-				if (!playerHandler->IsValidPlayer(player)) {
-					LOG_L(L_ERROR, "[Game::%s] invalid player number %i in NETMSG_ALLIANCE", __func__, player);
-					break;
+				if (!tai->HasLeader()) {
+					tai->SetLeader(playerId);
+				}
+				CPlayer::UpdateControlledTeams();
+				eventHandler.PlayerChanged(playerId);
+				if (isLocal) {
+					LOG("Skirmish AI being created for team %i ...", aiTeamId);
+					eoh->CreateSkirmishAI(skirmishAIId);
 				}
+			} catch (const netcode::UnpackPacketException& ex) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_AI_CREATED] exception \"%s\"", __func__, ex.what());
+			}
+			break;
+		}
+		case NETMSG_AI_STATE_CHANGED: {
+			const unsigned char playerId     = inbuf[1];
+			if (!playerHandler->IsValidPlayer(playerId)) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_AI_STATE_CHANGED] invalid player-number %i", __func__, playerId);
+				break;
+			}
 
-				const bool allied = static_cast<bool>(inbuf[3]);
-				const unsigned char whichAllyTeam = inbuf[2];
-				const unsigned char fromAllyTeam = teamHandler->AllyTeam(playerHandler->Player(player)->team);
-
-				if (teamHandler->IsValidAllyTeam(whichAllyTeam) && fromAllyTeam != whichAllyTeam) {
-					// FIXME NETMSG_ALLIANCE need to reset unit allyTeams
-					// FIXME NETMSG_ALLIANCE need a call-in for AIs
-					teamHandler->SetAlly(fromAllyTeam, whichAllyTeam, allied);
-
-					// inform the players
-					std::ostringstream msg;
-					if (fromAllyTeam == gu->myAllyTeam) {
-						msg << "Alliance: you have " << (allied ? "allied" : "unallied")
-							<< " allyteam " << whichAllyTeam << ".";
-					} else if (whichAllyTeam == gu->myAllyTeam) {
-						msg << "Alliance: allyteam " << whichAllyTeam << " has "
-							<< (allied ? "allied" : "unallied") <<  " with you.";
-					} else {
-						msg << "Alliance: allyteam " << whichAllyTeam << " has "
-							<< (allied ? "allied" : "unallied")
-							<<  " with allyteam " << fromAllyTeam << ".";
+			const unsigned char skirmishAIId  = inbuf[2];
+			const ESkirmishAIStatus newState = (ESkirmishAIStatus) inbuf[3];
+			SkirmishAIData* aiData           = skirmishAIHandler.GetSkirmishAI(skirmishAIId);
+			const ESkirmishAIStatus oldState = aiData->status;
+			const unsigned aiTeamId          = aiData->team;
+			const bool isLuaAI               = aiData->isLuaAI;
+			const unsigned isLocal           = (aiData->hostPlayer == gu->myPlayerNum);
+			const size_t numPlayersInAITeam  = playerHandler->ActivePlayersInTeam(aiTeamId).size();
+			const size_t numAIsInAITeam      = skirmishAIHandler.GetSkirmishAIsInTeam(aiTeamId).size();
+			CTeam* tai                       = teamHandler->Team(aiTeamId);
+
+			aiData->status = newState;
+
+			if (isLocal && !isLuaAI && ((newState == SKIRMAISTATE_DIEING) || (newState == SKIRMAISTATE_RELOADING))) {
+				eoh->DestroySkirmishAI(skirmishAIId);
+			} else if (newState == SKIRMAISTATE_DEAD) {
+				if (oldState == SKIRMAISTATE_RELOADING) {
+					if (isLocal) {
+						LOG("Skirmish AI \"%s\" being reloaded for team %i ...",
+								aiData->name.c_str(), aiTeamId);
+						eoh->CreateSkirmishAI(skirmishAIId);
 					}
-					LOG("%s", msg.str().c_str());
-
-					// stop attacks against former foe
-					if (allied) {
-						for (CUnit* u: unitHandler->GetActiveUnits()) {
-							if (teamHandler->Ally(u->allyteam, whichAllyTeam)) {
-								u->StopAttackingAllyTeam(whichAllyTeam);
-							}
-						}
+				} else {
+					const std::string aiInstanceName = aiData->name;
+					wordCompletion->RemoveWord(aiData->name + " ");
+					skirmishAIHandler.RemoveSkirmishAI(skirmishAIId);
+					aiData = NULL; // not valid anymore after RemoveSkirmishAI()
+					// this could be done in the above function as well
+					if ((numPlayersInAITeam + numAIsInAITeam) == 1) {
+						// team has no controller left now
+						tai->SetLeader(-1);
 					}
-					eventHandler.TeamChanged(playerHandler->Player(player)->team);
+					CPlayer::UpdateControlledTeams();
+					eventHandler.PlayerChanged(playerId);
+					LOG("Skirmish AI \"%s\" (ID:%i), which controlled team %i is now dead",
+							aiInstanceName.c_str(), skirmishAIId, aiTeamId);
+				}
+			} else if (newState == SKIRMAISTATE_ALIVE) {
+				if (isLocal) {
+					// short-name and version of the AI is unsynced data
+					// -> only available on the AI host
+					LOG("Skirmish AI \"%s\" (ID:%i, Short-Name:\"%s\", "
+							"Version:\"%s\") took over control of team %i",
+							aiData->name.c_str(), skirmishAIId,
+							aiData->shortName.c_str(),
+							aiData->version.c_str(), aiTeamId);
 				} else {
-					LOG_L(L_WARNING, "Alliance: Player %i sent out wrong allyTeam index in alliance message", player);
+					LOG("Skirmish AI \"%s\" (ID:%i) took over control of team %i",
+							aiData->name.c_str(), skirmishAIId, aiTeamId);
 				}
-				break;
 			}
-			case NETMSG_CCOMMAND: {
-				try {
-					CommandMessage msg(packet);
+			break;
+		}
+		case NETMSG_ALLIANCE: {
+			const unsigned char player = inbuf[1];
 
-					ActionReceived(msg.GetAction(), msg.GetPlayerID());
-				} catch (const netcode::UnpackPacketException& ex) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_CCOMMAND] exception \"%s\"", __func__, ex.what());
-				}
+			if (!playerHandler->IsValidPlayer(player)) {
+				LOG_L(L_ERROR, "[Game::%s] invalid player number %i in NETMSG_ALLIANCE", __func__, player);
 				break;
 			}
 
-			case NETMSG_DIRECT_CONTROL: {
-				const unsigned char player = inbuf[1];
-
-				if (!playerHandler->IsValidPlayer(player)) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_DIRECT_CONTROL] invalid player-number %i", __func__, player);
-					break;
+			const bool allied = static_cast<bool>(inbuf[3]);
+			const unsigned char whichAllyTeam = inbuf[2];
+			const unsigned char fromAllyTeam = teamHandler->AllyTeam(playerHandler->Player(player)->team);
+
+			if (teamHandler->IsValidAllyTeam(whichAllyTeam) && fromAllyTeam != whichAllyTeam) {
+				// FIXME NETMSG_ALLIANCE need to reset unit allyTeams
+				// FIXME NETMSG_ALLIANCE need a call-in for AIs
+				teamHandler->SetAlly(fromAllyTeam, whichAllyTeam, allied);
+
+				// inform the players
+				std::ostringstream msg;
+				if (fromAllyTeam == gu->myAllyTeam) {
+					msg << "Alliance: you have " << (allied ? "allied" : "unallied")
+						<< " allyteam " << whichAllyTeam << ".";
+				} else if (whichAllyTeam == gu->myAllyTeam) {
+					msg << "Alliance: allyteam " << whichAllyTeam << " has "
+						<< (allied ? "allied" : "unallied") <<  " with you.";
+				} else {
+					msg << "Alliance: allyteam " << whichAllyTeam << " has "
+						<< (allied ? "allied" : "unallied")
+						<<  " with allyteam " << fromAllyTeam << ".";
 				}
+				LOG("%s", msg.str().c_str());
 
-				CPlayer* sender = playerHandler->Player(player);
-				if (sender->spectator || !sender->active) {
-					break;
+				// stop attacks against former foe
+				if (allied) {
+					for (CUnit* u: unitHandler->GetActiveUnits()) {
+						if (teamHandler->Ally(u->allyteam, whichAllyTeam)) {
+							u->StopAttackingAllyTeam(whichAllyTeam);
+						}
+					}
 				}
-
-				sender->StartControllingUnit();
-
-				AddTraffic(player, packetCode, dataLength);
-				break;
+				eventHandler.TeamChanged(playerHandler->Player(player)->team);
+			} else {
+				LOG_L(L_WARNING, "Alliance: Player %i sent out wrong allyTeam index in alliance message", player);
 			}
+			break;
+		}
+		case NETMSG_CCOMMAND: {
+			try {
+				CommandMessage msg(packet);
 
-			case NETMSG_DC_UPDATE: {
-				const unsigned char player = inbuf[1];
-				if (!playerHandler->IsValidPlayer(player)) {
-					LOG_L(L_ERROR, "Invalid player number (%i) in NETMSG_DC_UPDATE", player);
-					break;
-				}
+				ActionReceived(msg.GetAction(), msg.GetPlayerID());
+			} catch (const netcode::UnpackPacketException& ex) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_CCOMMAND] exception \"%s\"", __func__, ex.what());
+			}
+			break;
+		}
 
-				CPlayer* sender = playerHandler->Player(player);
-				sender->fpsController.RecvStateUpdate(inbuf);
+		case NETMSG_DIRECT_CONTROL: {
+			const unsigned char player = inbuf[1];
 
-				AddTraffic(player, packetCode, dataLength);
+			if (!playerHandler->IsValidPlayer(player)) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_DIRECT_CONTROL] invalid player-number %i", __func__, player);
 				break;
 			}
-			case NETMSG_SETPLAYERNUM:
-			case NETMSG_ATTEMPTCONNECT: {
-				AddTraffic(-1, packetCode, dataLength);
+
+			CPlayer* sender = playerHandler->Player(player);
+			if (sender->spectator || !sender->active) {
 				break;
 			}
-			case NETMSG_CREATE_NEWPLAYER: { // server sends this second to let us know about new clients that join midgame
-				try {
-					netcode::UnpackPacket pckt(packet, 3);
-					unsigned char spectator, team, playerNum;
-					std::string name;
-
-					// since the >> operator uses dest size to extract data from the packet, we need to use temp variables
-					// of the same size of the packet, then convert to dest variable
-					pckt >> playerNum;
-					pckt >> spectator;
-					pckt >> team;
-					pckt >> name;
-
-					CPlayer player;
-					player.name = name;
-					player.spectator = spectator;
-					player.team = team;
-					player.playerNum = playerNum;
-
-					// add the new player
-					playerHandler->AddPlayer(player);
-					eventHandler.PlayerAdded(player.playerNum);
-
-					LOG("[Game::%s] added new player %s with number %d to team %d", __func__, name.c_str(), player.playerNum, player.team);
-
-					if (!player.spectator)
-						eventHandler.TeamChanged(player.team);
-
-					CDemoRecorder* record = clientNet->GetDemoRecorder();
-					if (record != nullptr)
-						record->AddNewPlayer(player.name, playerNum);
-
-					AddTraffic(-1, packetCode, dataLength);
-				} catch (const netcode::UnpackPacketException& ex) {
-					LOG_L(L_ERROR, "[Game::%s][NETMSG_CREATE_NEWPLAYER] exception \"%s\"", __func__, ex.what());
-				}
+
+			sender->StartControllingUnit();
+
+			AddTraffic(player, packetCode, dataLength);
+			break;
+		}
+
+		case NETMSG_DC_UPDATE: {
+			const unsigned char player = inbuf[1];
+			if (!playerHandler->IsValidPlayer(player)) {
+				LOG_L(L_ERROR, "Invalid player number (%i) in NETMSG_DC_UPDATE", player);
 				break;
 			}
 
-			case NETMSG_CLIENTDATA: {
-				if (!configHandler->GetBool("LogClientData"))
-					break;
+			CPlayer* sender = playerHandler->Player(player);
+			sender->fpsController.RecvStateUpdate(inbuf);
 
-				const unsigned char fixedSize = sizeof(unsigned char) + sizeof(unsigned short) + sizeof(unsigned char);
-
-				netcode::UnpackPacket pckt(packet, 1);
-				unsigned short totalSize;
-				unsigned char playerNum;
-				pckt >> totalSize;
+			AddTraffic(player, packetCode, dataLength);
+			break;
+		}
+		case NETMSG_SETPLAYERNUM:
+		case NETMSG_ATTEMPTCONNECT: {
+			AddTraffic(-1, packetCode, dataLength);
+			break;
+		}
+		case NETMSG_CREATE_NEWPLAYER: { // server sends this second to let us know about new clients that join midgame
+			try {
+				netcode::UnpackPacket pckt(packet, 3);
+				unsigned char spectator, team, playerNum;
+				std::string name;
+
+				// since the >> operator uses dest size to extract data from the packet, we need to use temp variables
+				// of the same size of the packet, then convert to dest variable
 				pckt >> playerNum;
+				pckt >> spectator;
+				pckt >> team;
+				pckt >> name;
 
-				if (!playerHandler->IsValidPlayer(playerNum)) {
-					LOG_L(L_ERROR, "Invalid player number (%i) in NETMSG_CLIENTDATA", playerNum);
-					break;
-				}
+				CPlayer player;
+				player.name = name;
+				player.spectator = spectator;
+				player.team = team;
+				player.playerNum = playerNum;
 
-				std::vector<std::uint8_t> buf(totalSize - fixedSize);
-				pckt >> buf;
-				std::string clientData = ClientData::GetUncompressed(buf);
+				// add the new player
+				playerHandler->AddPlayer(player);
+				eventHandler.PlayerAdded(player.playerNum);
 
-				if (clientData.empty()) {
-					LOG_L(L_ERROR, "Corrupt Client Data received from player %d", playerNum);
-					break;
-				}
+				LOG("[Game::%s] added new player %s with number %d to team %d", __func__, name.c_str(), player.playerNum, player.team);
 
-				CPlayer* sender = playerHandler->Player(playerNum);
-				LOG("[Game::%s] Client Data for player %d (%s): \n%s", __func__, playerNum, sender->name.c_str(), clientData.c_str());
+				if (!player.spectator)
+					eventHandler.TeamChanged(player.team);
+
+				CDemoRecorder* record = clientNet->GetDemoRecorder();
+				if (record != nullptr)
+					record->AddNewPlayer(player.name, playerNum);
 
 				AddTraffic(-1, packetCode, dataLength);
+			} catch (const netcode::UnpackPacketException& ex) {
+				LOG_L(L_ERROR, "[Game::%s][NETMSG_CREATE_NEWPLAYER] exception \"%s\"", __func__, ex.what());
+			}
+			break;
+		}
+
+		case NETMSG_CLIENTDATA: {
+			if (!configHandler->GetBool("LogClientData"))
+				break;
+
+			const unsigned char fixedSize = sizeof(unsigned char) + sizeof(unsigned short) + sizeof(unsigned char);
+
+			netcode::UnpackPacket pckt(packet, 1);
+			unsigned short totalSize;
+			unsigned char playerNum;
+			pckt >> totalSize;
+			pckt >> playerNum;
+
+			if (!playerHandler->IsValidPlayer(playerNum)) {
+				LOG_L(L_ERROR, "Invalid player number (%i) in NETMSG_CLIENTDATA", playerNum);
 				break;
 			}
 
-			// if we received this packet here we are the host player
-			// (meaning the message was not processed), so discard it
-			case NETMSG_GAME_FRAME_PROGRESS: {
+			std::vector<std::uint8_t> buf(totalSize - fixedSize);
+			pckt >> buf;
+			std::string clientData = ClientData::GetUncompressed(buf);
+
+			if (clientData.empty()) {
+				LOG_L(L_ERROR, "Corrupt Client Data received from player %d", playerNum);
 				break;
 			}
-			default: {
+
+			CPlayer* sender = playerHandler->Player(playerNum);
+			LOG("[Game::%s] Client Data for player %d (%s): \n%s", __func__, playerNum, sender->name.c_str(), clientData.c_str());
+
+			AddTraffic(-1, packetCode, dataLength);
+			break;
+		}
+
+		// if we received this packet here we are the host player
+		// (meaning the message was not processed), so discard it
+		case NETMSG_GAME_FRAME_PROGRESS: {
+			break;
+		}
+		default: {
 #ifdef SYNCDEBUG
-				if (!CSyncDebugger::GetInstance()->ClientReceived(inbuf))
+			if (!CSyncDebugger::GetInstance()->ClientReceived(inbuf))
 #endif
-				{
-					LOG_L(L_ERROR, "Unknown net msg received, packet code is %d."
-							" A likely cause of this is network instability,"
-							" which may happen in a WLAN, for example.",
-							packetCode);
-				}
-				AddTraffic(-1, packetCode, dataLength);
-				break;
+			{
+				LOG_L(L_ERROR, "Unknown net msg received, packet code is %d."
+						" A likely cause of this is network instability,"
+						" which may happen in a WLAN, for example.",
+						packetCode);
 			}
+			AddTraffic(-1, packetCode, dataLength);
+			break;
 		}
 	}
 }
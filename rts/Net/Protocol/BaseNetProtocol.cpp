@@ -117,6 +117,46 @@ PacketType CBaseNetProtocol::SendSelect(uint8_t myPlayerNum, const std::vector<i
 	return PacketType(packet);
 }
 
+PacketType CBaseNetProtocol::SendSelectDelta(uint8_t myPlayerNum, const std::vector<int>& removedIDs, const std::vector<int>& addedIDs)
+{
+	const uint32_t headerSize = sizeof(uint8_t) + sizeof(uint16_t) + sizeof(myPlayerNum);
+
+	// sorted ID lists are sent as varint gaps, so runs of consecutive
+	// IDs (the common case for mass selections) cost one byte per unit
+	uint32_t payloadSize = PackPacket::UVarintSize(removedIDs.size()) + PackPacket::UVarintSize(addedIDs.size());
+
+	int prevID = 0;
+	for (const int unitID: removedIDs) {
+		payloadSize += PackPacket::UVarintSize(unitID - prevID);
+		prevID = unitID;
+	}
+	prevID = 0;
+	for (const int unitID: addedIDs) {
+		payloadSize += PackPacket::UVarintSize(unitID - prevID);
+		prevID = unitID;
+	}
+
+	const uint32_t packetSize = headerSize + payloadSize;
+
+	PackPacket* packet = new PackPacket(packetSize, NETMSG_SELECT_DELTA);
+	*packet << static_cast<uint16_t>(packetSize) << myPlayerNum;
+
+	packet->PackUVarint(removedIDs.size());
+	prevID = 0;
+	for (const int unitID: removedIDs) {
+		packet->PackUVarint(unitID - prevID);
+		prevID = unitID;
+	}
+	packet->PackUVarint(addedIDs.size());
+	prevID = 0;
+	for (const int unitID: addedIDs) {
+		packet->PackUVarint(unitID - prevID);
+		prevID = unitID;
+	}
+
+	return PacketType(packet);
+}
+
 
 PacketType CBaseNetProtocol::SendPause(uint8_t myPlayerNum, uint8_t bPaused)
 {
@@ -194,6 +234,17 @@ PacketType CBaseNetProtocol::SendCPUUsage(float cpuUsage)
 	return PacketType(packet);
 }
 
+PacketType CBaseNetProtocol::SendSimFrameCost(const uint8_t* histogram)
+{
+	PackPacket* packet = new PackPacket(sizeof(uint8_t) + 8 * sizeof(uint8_t), NETMSG_SIMFRAME_COST);
+
+	for (int b = 0; b < 8; b++) {
+		*packet << histogram[b];
+	}
+
+	return PacketType(packet);
+}
+
 PacketType CBaseNetProtocol::SendDirectControl(uint8_t myPlayerNum)
 {
 	PackPacket* packet = new PackPacket(sizeof(uint8_t) + sizeof(myPlayerNum), NETMSG_DIRECT_CONTROL);
@@ -576,6 +627,7 @@ CBaseNetProtocol::CBaseNetProtocol()
 	proto->AddType(NETMSG_USER_SPEED, 6);
 	proto->AddType(NETMSG_INTERNAL_SPEED, 5);
 	proto->AddType(NETMSG_CPU_USAGE, 5);
+	proto->AddType(NETMSG_SIMFRAME_COST, 9);
 	proto->AddType(NETMSG_DIRECT_CONTROL, 2);
 	proto->AddType(NETMSG_DC_UPDATE, 7);
 	proto->AddType(NETMSG_ATTEMPTCONNECT, -2);
@@ -606,6 +658,7 @@ CBaseNetProtocol::CBaseNetProtocol()
 	proto->AddType(NETMSG_AI_CREATED, -1);
 	proto->AddType(NETMSG_AI_STATE_CHANGED, 4);
 	proto->AddType(NETMSG_GAME_FRAME_PROGRESS,5);
+	proto->AddType(NETMSG_SELECT_DELTA, -2);
 
 #ifdef SYNCDEBUG
 	proto->AddType(NETMSG_SD_CHKREQUEST, 5);
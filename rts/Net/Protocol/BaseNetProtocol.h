@@ -116,11 +116,21 @@ enum NETMSG {
 
 	NETMSG_GAME_FRAME_PROGRESS= 77, // int32_t frameNum # this special packet skips queue & cache entirely, indicates current game progress for clients fast-forwarding to current point the game #
 
+	NETMSG_SELECT_DELTA     = 78, // /* uint16_t messageSize */, uint8_t myPlayerNum;
+	                              // uvarint numRemoved; numRemoved * uvarint(delta to previous ID, sorted ascending, first is absolute)
+	                              // uvarint numAdded;   numAdded   * uvarint(delta to previous ID, sorted ascending, first is absolute)
+
+	NETMSG_SIMFRAME_COST    = 79, // uint8_t histogram[8]; # per-frame sim-time histogram since the last report, bucket edges NETMSG_SIMFRAME_COST_EDGES_MS #
 
 	NETMSG_LAST //max types of netmessages, internal only
 };
 
 
+/// upper bucket edges (in milliseconds) for the NETMSG_SIMFRAME_COST histogram,
+/// the last bucket also counts every frame above its edge
+static const float NETMSG_SIMFRAME_COST_EDGES_MS[8] = {10.0f, 15.0f, 20.0f, 25.0f, 33.0f, 50.0f, 75.0f, 100.0f};
+
+
 /// sub-action-types of NETMSG_TEAM
 enum TEAMMSG {
 //	TEAMMSG_NAME            = number    parameter1, ...
@@ -163,6 +173,8 @@ public:
 	PacketType SendPathCheckSum(uint8_t myPlayerNum, uint32_t checksum);
 	PacketType SendCommand(uint8_t myPlayerNum, int32_t id, uint8_t options, const std::vector<float>& params);
 	PacketType SendSelect(uint8_t myPlayerNum, const std::vector<int16_t>& selectedUnitIDs);
+	/// removedIDs and addedIDs must be sorted ascending
+	PacketType SendSelectDelta(uint8_t myPlayerNum, const std::vector<int>& removedIDs, const std::vector<int>& addedIDs);
 	PacketType SendPause(uint8_t myPlayerNum, uint8_t bPaused);
 
 	PacketType SendAICommand(uint8_t myPlayerNum, uint8_t aiID, int16_t unitID, int32_t commandID, int32_t aiCommandID, uint8_t options, const std::vector<float>& params);
@@ -171,6 +183,8 @@ public:
 	PacketType SendUserSpeed(uint8_t myPlayerNum, float userSpeed);
 	PacketType SendInternalSpeed(float internalSpeed);
 	PacketType SendCPUUsage(float cpuUsage);
+	/// histogram contains 8 bucket counts, see NETMSG_SIMFRAME_COST_EDGES_MS
+	PacketType SendSimFrameCost(const uint8_t* histogram);
 	PacketType SendCustomData(uint8_t myPlayerNum, uint8_t dataType, int32_t dataValue);
 	PacketType SendLuaDrawTime(uint8_t myPlayerNum, int32_t mSec);
 	PacketType SendDirectControl(uint8_t myPlayerNum);
@@ -11,6 +11,7 @@
 
 #include "Game/GlobalUnsynced.h"
 #include "Sim/Misc/GlobalConstants.h"
+#include "System/Net/TrafficStats.h"
 #include "System/Net/UnpackPacket.h"
 #include "System/LoadSave/DemoRecorder.h"
 #include "System/Platform/Threading.h"
@@ -128,6 +129,9 @@ std::shared_ptr<const netcode::RawPacket> CNetProtocol::GetData(int frameNum)
 
 void CNetProtocol::Send(std::shared_ptr<const netcode::RawPacket> pkt)
 {
+	if (pkt->length > 0)
+		netcode::TrafficStats::RecordSent(pkt->data[0], pkt->length);
+
 	serverConn->SendData(pkt);
 }
 
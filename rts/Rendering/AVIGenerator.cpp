@@ -15,6 +15,7 @@
 
 #include <functional>
 #include <cassert>
+#include <cstring>
 
 #if defined(_WIN32) && !defined(__MINGW32__)
 #pragma message("Adding library: vfw32.lib")
@@ -113,6 +114,12 @@ CAVIGenerator::CAVIGenerator(const std::string& fileName, int videoSizeX, int vi
 
 CAVIGenerator::~CAVIGenerator()
 {
+	// flush readbacks still in flight so the tail frames are not lost
+	using namespace std::placeholders;
+
+	while (pboReadback.ConsumeRead(true, std::bind(&CAVIGenerator::QueueReadFrame, this, _1, _2, _3))) {
+	}
+
 	if (AVIThread) {
 		{
 			std::lock_guard<spring::mutex> lock(AVIMutex);
@@ -363,8 +370,58 @@ HRESULT CAVIGenerator::AddFrame(unsigned char* pixelData)
 }
 
 
+void CAVIGenerator::QueueReadFrame(const unsigned char* data, int sizeX, int sizeY)
+{
+	unsigned char* buf = nullptr;
+
+	{
+		std::unique_lock<spring::mutex> lock(AVIMutex);
+
+		while (freeImageBuffers.empty()) {
+			if (quitAVIgen)
+				return;
+
+			AVICondition.wait(lock);
+		}
+
+		buf = freeImageBuffers.front();
+		freeImageBuffers.pop_front();
+	}
+
+	// copy outside the lock; the PBO must be unmapped before the
+	// next submit so the mapping cannot be handed over directly
+	memcpy(buf, data, sizeX * sizeY * 3);
+
+	{
+		std::lock_guard<spring::mutex> lock(AVIMutex);
+		imageBuffers.push_back(buf);
+		AVICondition.notify_all();
+	}
+}
+
+
 bool CAVIGenerator::readOpenglPixelDataThreaded()
 {
+	{
+		std::lock_guard<spring::mutex> lock(AVIMutex);
+
+		if (quitAVIgen)
+			return false;
+	}
+
+	// asynchronous path: collect the oldest finished readback (the
+	// previous frame, normally) and start the next one without ever
+	// stalling on the GPU unless the whole ring is still in flight
+	if (pboReadback.Supported()) {
+		using namespace std::placeholders;
+		const bool ringFull = (pboReadback.NumPending() >= CPixelReadback::NUM_BUFFERS - 1);
+
+		pboReadback.ConsumeRead(ringFull, std::bind(&CAVIGenerator::QueueReadFrame, this, _1, _2, _3));
+
+		if (pboReadback.SubmitRead(0, 0, bitmapInfo.biWidth, bitmapInfo.biHeight, GL_BGR_EXT))
+			return true;
+	}
+
 	while (true) {
 		std::unique_lock<spring::mutex> lock(AVIMutex);
 
@@ -5,6 +5,7 @@
 
 #ifdef WIN32
 
+#include "Rendering/GL/PixelReadback.h"
 #include "System/Threading/SpringThreading.h"
 #include "System/Misc/NonCopyable.h"
 
@@ -66,6 +67,14 @@ private:
 
 	unsigned char* readBuf;
 
+	/// asynchronous glReadPixels ring; frames reach the encoder
+	/// thread one frame late but without stalling the GL thread
+	CPixelReadback pboReadback;
+
+	/// moves a completed PBO readback into a free image buffer and
+	/// queues it for the encoder thread
+	void QueueReadFrame(const unsigned char* data, int sizeX, int sizeY);
+
 
 	/// frame counter
 	long m_lFrame;
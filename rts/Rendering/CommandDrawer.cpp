@@ -34,6 +34,14 @@ static const CUnit* GetTrackableUnit(const CUnit* caiOwner, const CUnit* cmdUnit
 	return cmdUnit;
 }
 
+// accumulators for DrawQuedBuildingSquares, flushed across all builders in
+// one batch by FlushQuedBuildingSquares; kept alive to reuse their storage
+static std::vector<GLfloat> buildQuadVerts;
+static std::vector<GLfloat> buildQuadColors;
+static std::vector<GLfloat> buildUWQuadVerts;
+static std::vector<GLfloat> buildUWLineVerts;
+static std::vector<GLfloat> buildUWLineColors;
+
 CommandDrawer* CommandDrawer::GetInstance() {
 	// luaQueuedUnitSet gets cleared each frame, so this is fine wrt. reloading
 	static CommandDrawer drawer;
@@ -42,14 +50,63 @@ CommandDrawer* CommandDrawer::GetInstance() {
 
 
 
-void CommandDrawer::Draw(const CCommandAI* cai) const {
+void CommandDrawer::Draw(const CCommandAI* cai) {
+	const CUnit* owner = cai->owner;
+	const CFactoryCAI* fcai = dynamic_cast<const CFactoryCAI*>(cai);
+
+	const unsigned int cmdQueCounter = cai->commandQue.GetModCounter();
+	const unsigned int nextQueCounter = (fcai != nullptr)? fcai->newUnitCommands.GetModCounter(): 0;
+	const bool selfDIcon = (owner->selfDCountdown != 0);
+
+	QueueCache& qc = queueCache[owner->id];
+
+	// note: in-place command mutations that bypass the queue counters
+	// (PushOrUpdateReturnFight, etc.) only happen to units in motion,
+	// which the anchor test catches
+	if (qc.cacheable &&
+	    qc.cmdQueCounter == cmdQueCounter &&
+	    qc.nextQueCounter == nextQueCounter &&
+	    qc.selfDIcon == selfDIcon &&
+	    qc.anchorPos == owner->GetObjDrawMidPos()) {
+		lineDrawer.AppendActiveRange(qc.verts, qc.colors);
+
+		for (const auto& icon: qc.cmdIcons) {
+			cursorIcons.AddIcon(icon.first, icon.second);
+		}
+		for (const CachedBuildIcon& icon: qc.buildIcons) {
+			cursorIcons.AddBuildIcon(icon.cmdID, icon.pos, icon.team, icon.facing);
+		}
+
+		return;
+	}
+
+	qc.cmdQueCounter = cmdQueCounter;
+	qc.nextQueCounter = nextQueCounter;
+	qc.selfDIcon = selfDIcon;
+	qc.cacheable = true;
+	qc.anchorPos = owner->GetObjDrawMidPos();
+	qc.verts.clear();
+	qc.colors.clear();
+	qc.cmdIcons.clear();
+	qc.buildIcons.clear();
+
+	curQueueCache = &qc;
+
+	const size_t firstVert = lineDrawer.GetActiveVertexCount();
+
 	// note: {Air,Builder}CAI inherit from MobileCAI, so test that last
-	if ((dynamic_cast<const     CAirCAI*>(cai)) != nullptr) {     DrawAirCAICommands(static_cast<const     CAirCAI*>(cai)); return; }
-	if ((dynamic_cast<const CBuilderCAI*>(cai)) != nullptr) { DrawBuilderCAICommands(static_cast<const CBuilderCAI*>(cai)); return; }
-	if ((dynamic_cast<const CFactoryCAI*>(cai)) != nullptr) { DrawFactoryCAICommands(static_cast<const CFactoryCAI*>(cai)); return; }
-	if ((dynamic_cast<const  CMobileCAI*>(cai)) != nullptr) {  DrawMobileCAICommands(static_cast<const  CMobileCAI*>(cai)); return; }
+	     if ((dynamic_cast<const     CAirCAI*>(cai)) != nullptr) {     DrawAirCAICommands(static_cast<const     CAirCAI*>(cai)); }
+	else if ((dynamic_cast<const CBuilderCAI*>(cai)) != nullptr) { DrawBuilderCAICommands(static_cast<const CBuilderCAI*>(cai)); }
+	else if (fcai != nullptr                                   ) { DrawFactoryCAICommands(fcai                               ); }
+	else if ((dynamic_cast<const  CMobileCAI*>(cai)) != nullptr) {  DrawMobileCAICommands(static_cast<const  CMobileCAI*>(cai)); }
+	else {
+		DrawCommands(cai);
+	}
 
-	DrawCommands(cai);
+	if (qc.cacheable)
+		lineDrawer.CopyActiveRange(firstVert, qc.verts, qc.colors);
+
+	curQueueCache = nullptr;
 }
 
 
@@ -59,7 +116,7 @@ void CommandDrawer::AddLuaQueuedUnit(const CUnit* unit) {
 	luaQueuedUnitSet.insert(unit->id);
 }
 
-void CommandDrawer::DrawLuaQueuedUnitSetCommands() const
+void CommandDrawer::DrawLuaQueuedUnitSetCommands()
 {
 	if (luaQueuedUnitSet.empty())
 		return;
@@ -92,7 +149,7 @@ void CommandDrawer::DrawLuaQueuedUnitSetCommands() const
 	glEnable(GL_DEPTH_TEST);
 }
 
-void CommandDrawer::DrawCommands(const CCommandAI* cai) const
+void CommandDrawer::DrawCommands(const CCommandAI* cai)
 {
 	const CUnit* owner = cai->owner;
 	const CCommandQueue& commandQue = cai->commandQue;
@@ -100,7 +157,7 @@ void CommandDrawer::DrawCommands(const CCommandAI* cai) const
 	lineDrawer.StartPath(owner->GetObjDrawMidPos(), cmdColors.start);
 
 	if (owner->selfDCountdown != 0) {
-		lineDrawer.DrawIconAtLastPos(CMD_SELFD);
+		DrawIconAtLastPos(CMD_SELFD);
 	}
 
 	for (auto ci = commandQue.begin(); ci != commandQue.end(); ++ci) {
@@ -110,10 +167,11 @@ void CommandDrawer::DrawCommands(const CCommandAI* cai) const
 			case CMD_ATTACK:
 			case CMD_MANUALFIRE: {
 				if (ci->params.size() == 1) {
+					DisableQueueCache();
 					const CUnit* unit = GetTrackableUnit(owner, unitHandler->GetUnit(ci->params[0]));
 
 					if (unit != nullptr) {
-						lineDrawer.DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), cmdColors.attack);
+						DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), cmdColors.attack);
 					}
 				} else {
 					assert(ci->params.size() >= 3);
@@ -122,7 +180,7 @@ void CommandDrawer::DrawCommands(const CCommandAI* cai) const
 					const float z = ci->params[2];
 					const float y = CGround::GetHeightReal(x, z, false) + 3.0f;
 
-					lineDrawer.DrawLineAndIcon(cmdID, float3(x, y, z), cmdColors.attack);
+					DrawLineAndIcon(cmdID, float3(x, y, z), cmdColors.attack);
 				}
 				break;
 			}
@@ -131,7 +189,7 @@ void CommandDrawer::DrawCommands(const CCommandAI* cai) const
 				break;
 			}
 			case CMD_SELFD: {
-				lineDrawer.DrawIconAtLastPos(cmdID);
+				DrawIconAtLastPos(cmdID);
 				break;
 			}
 			default: {
@@ -146,7 +204,7 @@ void CommandDrawer::DrawCommands(const CCommandAI* cai) const
 
 
 
-void CommandDrawer::DrawAirCAICommands(const CAirCAI* cai) const
+void CommandDrawer::DrawAirCAICommands(const CAirCAI* cai)
 {
 	const CUnit* owner = cai->owner;
 	const CCommandQueue& commandQue = cai->commandQue;
@@ -154,7 +212,7 @@ void CommandDrawer::DrawAirCAICommands(const CAirCAI* cai) const
 	lineDrawer.StartPath(owner->GetObjDrawMidPos(), cmdColors.start);
 
 	if (owner->selfDCountdown != 0) {
-		lineDrawer.DrawIconAtLastPos(CMD_SELFD);
+		DrawIconAtLastPos(CMD_SELFD);
 	}
 
 	for (auto ci = commandQue.begin(); ci != commandQue.end(); ++ci) {
@@ -162,23 +220,24 @@ void CommandDrawer::DrawAirCAICommands(const CAirCAI* cai) const
 
 		switch (cmdID) {
 			case CMD_MOVE: {
-				lineDrawer.DrawLineAndIcon(cmdID, ci->GetPos(0), cmdColors.move);
+				DrawLineAndIcon(cmdID, ci->GetPos(0), cmdColors.move);
 				break;
 			}
 			case CMD_FIGHT: {
-				lineDrawer.DrawLineAndIcon(cmdID, ci->GetPos(0), cmdColors.fight);
+				DrawLineAndIcon(cmdID, ci->GetPos(0), cmdColors.fight);
 				break;
 			}
 			case CMD_PATROL: {
-				lineDrawer.DrawLineAndIcon(cmdID, ci->GetPos(0), cmdColors.patrol);
+				DrawLineAndIcon(cmdID, ci->GetPos(0), cmdColors.patrol);
 				break;
 			}
 			case CMD_ATTACK: {
 				if (ci->params.size() == 1) {
+					DisableQueueCache();
 					const CUnit* unit = GetTrackableUnit(owner, unitHandler->GetUnit(ci->params[0]));
 
 					if (unit != nullptr) {
-						lineDrawer.DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), cmdColors.attack);
+						DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), cmdColors.attack);
 					}
 				} else {
 					assert(ci->params.size() >= 3);
@@ -187,7 +246,7 @@ void CommandDrawer::DrawAirCAICommands(const CAirCAI* cai) const
 					const float z = ci->params[2];
 					const float y = CGround::GetHeightReal(x, z, false) + 3.0f;
 
-					lineDrawer.DrawLineAndIcon(cmdID, float3(x, y, z), cmdColors.attack);
+					DrawLineAndIcon(cmdID, float3(x, y, z), cmdColors.attack);
 				}
 
 				break;
@@ -195,18 +254,20 @@ void CommandDrawer::DrawAirCAICommands(const CAirCAI* cai) const
 			case CMD_AREA_ATTACK: {
 				const float3& endPos = ci->GetPos(0);
 
-				lineDrawer.DrawLineAndIcon(cmdID, endPos, cmdColors.attack);
+				DrawLineAndIcon(cmdID, endPos, cmdColors.attack);
 				lineDrawer.Break(endPos, cmdColors.attack);
 				glColor4fv(cmdColors.attack);
+				DisableQueueCache();
 				glSurfaceCircle(endPos, ci->params[3], 20.0f);
 				lineDrawer.RestartWithColor(cmdColors.attack);
 				break;
 			}
 			case CMD_GUARD: {
+				DisableQueueCache();
 				const CUnit* unit = GetTrackableUnit(owner, unitHandler->GetUnit(ci->params[0]));
 
 				if (unit != nullptr) {
-					lineDrawer.DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), cmdColors.guard);
+					DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), cmdColors.guard);
 				}
 				break;
 			}
@@ -215,7 +276,7 @@ void CommandDrawer::DrawAirCAICommands(const CAirCAI* cai) const
 				break;
 			}
 			case CMD_SELFD: {
-				lineDrawer.DrawIconAtLastPos(cmdID);
+				DrawIconAtLastPos(cmdID);
 				break;
 			}
 			default: {
@@ -230,7 +291,7 @@ void CommandDrawer::DrawAirCAICommands(const CAirCAI* cai) const
 
 
 
-void CommandDrawer::DrawBuilderCAICommands(const CBuilderCAI* cai) const
+void CommandDrawer::DrawBuilderCAICommands(const CBuilderCAI* cai)
 {
 	const CUnit* owner = cai->owner;
 	const CCommandQueue& commandQue = cai->commandQue;
@@ -238,7 +299,7 @@ void CommandDrawer::DrawBuilderCAICommands(const CBuilderCAI* cai) const
 	lineDrawer.StartPath(owner->GetObjDrawMidPos(), cmdColors.start);
 
 	if (owner->selfDCountdown != 0) {
-		lineDrawer.DrawIconAtLastPos(CMD_SELFD);
+		DrawIconAtLastPos(CMD_SELFD);
 	}
 
 	for (auto ci = commandQue.begin(); ci != commandQue.end(); ++ci) {
@@ -256,13 +317,14 @@ void CommandDrawer::DrawBuilderCAICommands(const CBuilderCAI* cai) const
 				bi.pos = float3(ci->params[0], ci->params[1], ci->params[2]);
 				bi.pos = CGameHelper::Pos2BuildPos(bi, false);
 
-				cursorIcons.AddBuildIcon(cmdID, bi.pos, owner->team, bi.buildFacing);
+				AddBuildIcon(cmdID, bi.pos, owner->team, bi.buildFacing);
 				lineDrawer.DrawLine(bi.pos, cmdColors.build);
 
 				// draw metal extraction range
 				if (bi.def->extractRange > 0) {
 					lineDrawer.Break(bi.pos, cmdColors.build);
 					glColor4fv(cmdColors.rangeExtract);
+					DisableQueueCache();
 					glSurfaceCircle(bi.pos, bi.def->extractRange, 40.0f);
 					lineDrawer.Restart();
 				}
@@ -272,31 +334,33 @@ void CommandDrawer::DrawBuilderCAICommands(const CBuilderCAI* cai) const
 
 		switch (cmdID) {
 			case CMD_MOVE: {
-				lineDrawer.DrawLineAndIcon(cmdID, ci->GetPos(0), cmdColors.move);
+				DrawLineAndIcon(cmdID, ci->GetPos(0), cmdColors.move);
 				break;
 			}
 			case CMD_FIGHT:{
-				lineDrawer.DrawLineAndIcon(cmdID, ci->GetPos(0), cmdColors.fight);
+				DrawLineAndIcon(cmdID, ci->GetPos(0), cmdColors.fight);
 				break;
 			}
 			case CMD_PATROL: {
-				lineDrawer.DrawLineAndIcon(cmdID, ci->GetPos(0), cmdColors.patrol);
+				DrawLineAndIcon(cmdID, ci->GetPos(0), cmdColors.patrol);
 				break;
 			}
 			case CMD_GUARD: {
+				DisableQueueCache();
 				const CUnit* unit = GetTrackableUnit(owner, unitHandler->GetUnit(ci->params[0]));
 
 				if (unit != nullptr) {
-					lineDrawer.DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), cmdColors.guard);
+					DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), cmdColors.guard);
 				}
 				break;
 			}
 			case CMD_RESTORE: {
 				const float3& endPos = ci->GetPos(0);
 
-				lineDrawer.DrawLineAndIcon(cmdID, endPos, cmdColors.restore);
+				DrawLineAndIcon(cmdID, endPos, cmdColors.restore);
 				lineDrawer.Break(endPos, cmdColors.restore);
 				glColor4fv(cmdColors.restore);
+				DisableQueueCache();
 				glSurfaceCircle(endPos, ci->params[3], 20.0f);
 				lineDrawer.RestartWithColor(cmdColors.restore);
 				break;
@@ -304,10 +368,11 @@ void CommandDrawer::DrawBuilderCAICommands(const CBuilderCAI* cai) const
 			case CMD_ATTACK:
 			case CMD_MANUALFIRE: {
 				if (ci->params.size() == 1) {
+					DisableQueueCache();
 					const CUnit* unit = GetTrackableUnit(owner, unitHandler->GetUnit(ci->params[0]));
 
 					if (unit != nullptr) {
-						lineDrawer.DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), cmdColors.attack);
+						DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), cmdColors.attack);
 					}
 				} else {
 					assert(ci->params.size() >= 3);
@@ -316,7 +381,7 @@ void CommandDrawer::DrawBuilderCAICommands(const CBuilderCAI* cai) const
 					const float z = ci->params[2];
 					const float y = CGround::GetHeightReal(x, z, false) + 3.0f;
 
-					lineDrawer.DrawLineAndIcon(cmdID, float3(x, y, z), cmdColors.attack);
+					DrawLineAndIcon(cmdID, float3(x, y, z), cmdColors.attack);
 				}
 
 				break;
@@ -328,27 +393,30 @@ void CommandDrawer::DrawBuilderCAICommands(const CBuilderCAI* cai) const
 				if (ci->params.size() == 4) {
 					const float3& endPos = ci->GetPos(0);
 
-					lineDrawer.DrawLineAndIcon(cmdID, endPos, color);
+					DrawLineAndIcon(cmdID, endPos, color);
 					lineDrawer.Break(endPos, color);
 					glColor4fv(color);
+					DisableQueueCache();
 					glSurfaceCircle(endPos, ci->params[3], 20.0f);
 					lineDrawer.RestartWithColor(color);
 				} else {
 					assert(ci->params[0] >= 0.0f);
 
+					DisableQueueCache();
 					const unsigned int id = std::max(0.0f, ci->params[0]);
 
 					if (id >= unitHandler->MaxUnits()) {
 						const CFeature* feature = featureHandler->GetFeature(id - unitHandler->MaxUnits());
 
 						if (feature != nullptr) {
-							lineDrawer.DrawLineAndIcon(cmdID, feature->GetObjDrawMidPos(), color);
+							DrawLineAndIcon(cmdID, feature->GetObjDrawMidPos(), color);
 						}
 					} else {
+						DisableQueueCache();
 						const CUnit* unit = GetTrackableUnit(owner, unitHandler->GetUnit(ci->params[0]));
 
 						if (unit != nullptr && unit != owner) {
-							lineDrawer.DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), color);
+							DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), color);
 						}
 					}
 				}
@@ -360,25 +428,28 @@ void CommandDrawer::DrawBuilderCAICommands(const CBuilderCAI* cai) const
 				if (ci->params.size() == 4) {
 					const float3& endPos = ci->GetPos(0);
 
-					lineDrawer.DrawLineAndIcon(cmdID, endPos, color);
+					DrawLineAndIcon(cmdID, endPos, color);
 					lineDrawer.Break(endPos, color);
 					glColor4fv(color);
+					DisableQueueCache();
 					glSurfaceCircle(endPos, ci->params[3], 20.0f);
 					lineDrawer.RestartWithColor(color);
 				} else {
 					if (ci->params.size() >= 1) {
+						DisableQueueCache();
 						const CUnit* unit = GetTrackableUnit(owner, unitHandler->GetUnit(ci->params[0]));
 
 						if (unit != nullptr) {
-							lineDrawer.DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), color);
+							DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), color);
 						}
 					}
 				}
 				break;
 			}
 			case CMD_LOAD_ONTO: {
+				DisableQueueCache();
 				const CUnit* unit = unitHandler->GetUnitUnsafe(ci->params[0]);
-				lineDrawer.DrawLineAndIcon(cmdID, unit->pos, cmdColors.load);
+				DrawLineAndIcon(cmdID, unit->pos, cmdColors.load);
 				break;
 			}
 			case CMD_WAIT: {
@@ -386,7 +457,7 @@ void CommandDrawer::DrawBuilderCAICommands(const CBuilderCAI* cai) const
 				break;
 			}
 			case CMD_SELFD: {
-				lineDrawer.DrawIconAtLastPos(ci->GetID());
+				DrawIconAtLastPos(ci->GetID());
 				break;
 			}
 			default: {
@@ -401,7 +472,7 @@ void CommandDrawer::DrawBuilderCAICommands(const CBuilderCAI* cai) const
 
 
 
-void CommandDrawer::DrawFactoryCAICommands(const CFactoryCAI* cai) const
+void CommandDrawer::DrawFactoryCAICommands(const CFactoryCAI* cai)
 {
 	const CUnit* owner = cai->owner;
 	const CCommandQueue& commandQue = cai->commandQue;
@@ -410,7 +481,7 @@ void CommandDrawer::DrawFactoryCAICommands(const CFactoryCAI* cai) const
 	lineDrawer.StartPath(owner->GetObjDrawMidPos(), cmdColors.start);
 
 	if (owner->selfDCountdown != 0) {
-		lineDrawer.DrawIconAtLastPos(CMD_SELFD);
+		DrawIconAtLastPos(CMD_SELFD);
 	}
 
 	if (!commandQue.empty() && (commandQue.front().GetID() == CMD_WAIT)) {
@@ -422,23 +493,24 @@ void CommandDrawer::DrawFactoryCAICommands(const CFactoryCAI* cai) const
 
 		switch (cmdID) {
 			case CMD_MOVE: {
-				lineDrawer.DrawLineAndIcon(cmdID, ci->GetPos(0) + UpVector * 3.0f, cmdColors.move);
+				DrawLineAndIcon(cmdID, ci->GetPos(0) + UpVector * 3.0f, cmdColors.move);
 				break;
 			}
 			case CMD_FIGHT: {
-				lineDrawer.DrawLineAndIcon(cmdID, ci->GetPos(0) + UpVector * 3.0f, cmdColors.fight);
+				DrawLineAndIcon(cmdID, ci->GetPos(0) + UpVector * 3.0f, cmdColors.fight);
 				break;
 			}
 			case CMD_PATROL: {
-				lineDrawer.DrawLineAndIcon(cmdID, ci->GetPos(0) + UpVector * 3.0f, cmdColors.patrol);
+				DrawLineAndIcon(cmdID, ci->GetPos(0) + UpVector * 3.0f, cmdColors.patrol);
 				break;
 			}
 			case CMD_ATTACK: {
 				if (ci->params.size() == 1) {
+					DisableQueueCache();
 					const CUnit* unit = GetTrackableUnit(owner, unitHandler->GetUnit(ci->params[0]));
 
 					if (unit != nullptr) {
-						lineDrawer.DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), cmdColors.attack);
+						DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), cmdColors.attack);
 					}
 				} else {
 					assert(ci->params.size() >= 3);
@@ -447,16 +519,17 @@ void CommandDrawer::DrawFactoryCAICommands(const CFactoryCAI* cai) const
 					const float z = ci->params[2];
 					const float y = CGround::GetHeightReal(x, z, false) + 3.0f;
 
-					lineDrawer.DrawLineAndIcon(cmdID, float3(x, y, z), cmdColors.attack);
+					DrawLineAndIcon(cmdID, float3(x, y, z), cmdColors.attack);
 				}
 
 				break;
 			}
 			case CMD_GUARD: {
+				DisableQueueCache();
 				const CUnit* unit = GetTrackableUnit(owner, unitHandler->GetUnit(ci->params[0]));
 
 				if (unit != nullptr) {
-					lineDrawer.DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), cmdColors.guard);
+					DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), cmdColors.guard);
 				}
 				break;
 			}
@@ -465,7 +538,7 @@ void CommandDrawer::DrawFactoryCAICommands(const CFactoryCAI* cai) const
 				break;
 			}
 			case CMD_SELFD: {
-				lineDrawer.DrawIconAtLastPos(cmdID);
+				DrawIconAtLastPos(cmdID);
 				break;
 			}
 			default: {
@@ -484,13 +557,14 @@ void CommandDrawer::DrawFactoryCAICommands(const CFactoryCAI* cai) const
 			bi.pos = ci->GetPos(0);
 			bi.pos = CGameHelper::Pos2BuildPos(bi, false);
 
-			cursorIcons.AddBuildIcon(cmdID, bi.pos, owner->team, bi.buildFacing);
+			AddBuildIcon(cmdID, bi.pos, owner->team, bi.buildFacing);
 			lineDrawer.DrawLine(bi.pos, cmdColors.build);
 
 			// draw metal extraction range
 			if (bi.def->extractRange > 0) {
 				lineDrawer.Break(bi.pos, cmdColors.build);
 				glColor4fv(cmdColors.rangeExtract);
+				DisableQueueCache();
 				glSurfaceCircle(bi.pos, bi.def->extractRange, 40.0f);
 				lineDrawer.Restart();
 			}
@@ -502,7 +576,7 @@ void CommandDrawer::DrawFactoryCAICommands(const CFactoryCAI* cai) const
 
 
 
-void CommandDrawer::DrawMobileCAICommands(const CMobileCAI* cai) const
+void CommandDrawer::DrawMobileCAICommands(const CMobileCAI* cai)
 {
 	const CUnit* owner = cai->owner;
 	const CCommandQueue& commandQue = cai->commandQue;
@@ -510,7 +584,7 @@ void CommandDrawer::DrawMobileCAICommands(const CMobileCAI* cai) const
 	lineDrawer.StartPath(owner->GetObjDrawMidPos(), cmdColors.start);
 
 	if (owner->selfDCountdown != 0) {
-		lineDrawer.DrawIconAtLastPos(CMD_SELFD);
+		DrawIconAtLastPos(CMD_SELFD);
 	}
 
 	for (auto ci = commandQue.begin(); ci != commandQue.end(); ++ci) {
@@ -518,26 +592,27 @@ void CommandDrawer::DrawMobileCAICommands(const CMobileCAI* cai) const
 
 		switch (cmdID) {
 			case CMD_MOVE: {
-				lineDrawer.DrawLineAndIcon(cmdID, ci->GetPos(0), cmdColors.move);
+				DrawLineAndIcon(cmdID, ci->GetPos(0), cmdColors.move);
 				break;
 			}
 			case CMD_PATROL: {
-				lineDrawer.DrawLineAndIcon(cmdID, ci->GetPos(0), cmdColors.patrol);
+				DrawLineAndIcon(cmdID, ci->GetPos(0), cmdColors.patrol);
 				break;
 			}
 			case CMD_FIGHT: {
 				if (ci->params.size() >= 3) {
-					lineDrawer.DrawLineAndIcon(cmdID, ci->GetPos(0), cmdColors.fight);
+					DrawLineAndIcon(cmdID, ci->GetPos(0), cmdColors.fight);
 				}
 				break;
 			}
 			case CMD_ATTACK:
 			case CMD_MANUALFIRE: {
 				if (ci->params.size() == 1) {
+					DisableQueueCache();
 					const CUnit* unit = GetTrackableUnit(owner, unitHandler->GetUnit(ci->params[0]));
 
 					if (unit != nullptr) {
-						lineDrawer.DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), cmdColors.attack);
+						DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), cmdColors.attack);
 					}
 				}
 
@@ -546,38 +621,42 @@ void CommandDrawer::DrawMobileCAICommands(const CMobileCAI* cai) const
 					const float z = ci->params[2];
 					const float y = CGround::GetHeightReal(x, z, false) + 3.0f;
 
-					lineDrawer.DrawLineAndIcon(cmdID, float3(x, y, z), cmdColors.attack);
+					DrawLineAndIcon(cmdID, float3(x, y, z), cmdColors.attack);
 				}
 
 				break;
 			}
 			case CMD_GUARD: {
+				DisableQueueCache();
 				const CUnit* unit = GetTrackableUnit(owner, unitHandler->GetUnit(ci->params[0]));
 
 				if (unit != nullptr) {
-					lineDrawer.DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), cmdColors.guard);
+					DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), cmdColors.guard);
 				}
 				break;
 			}
 			case CMD_LOAD_ONTO: {
+				DisableQueueCache();
 				const CUnit* unit = unitHandler->GetUnitUnsafe(ci->params[0]);
-				lineDrawer.DrawLineAndIcon(cmdID, unit->pos, cmdColors.load);
+				DrawLineAndIcon(cmdID, unit->pos, cmdColors.load);
 				break;
 			}
 			case CMD_LOAD_UNITS: {
 				if (ci->params.size() == 4) {
 					const float3& endPos = ci->GetPos(0);
 
-					lineDrawer.DrawLineAndIcon(cmdID, endPos, cmdColors.load);
+					DrawLineAndIcon(cmdID, endPos, cmdColors.load);
 					lineDrawer.Break(endPos, cmdColors.load);
 					glColor4fv(cmdColors.load);
+					DisableQueueCache();
 					glSurfaceCircle(endPos, ci->params[3], 20.0f);
 					lineDrawer.RestartWithColor(cmdColors.load);
 				} else {
+					DisableQueueCache();
 					const CUnit* unit = GetTrackableUnit(owner, unitHandler->GetUnit(ci->params[0]));
 
 					if (unit != nullptr) {
-						lineDrawer.DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), cmdColors.load);
+						DrawLineAndIcon(cmdID, unit->GetObjDrawErrorPos(owner->allyteam), cmdColors.load);
 					}
 				}
 				break;
@@ -586,16 +665,17 @@ void CommandDrawer::DrawMobileCAICommands(const CMobileCAI* cai) const
 				if (ci->params.size() == 5) {
 					const float3& endPos = ci->GetPos(0);
 
-					lineDrawer.DrawLineAndIcon(cmdID, endPos, cmdColors.unload);
+					DrawLineAndIcon(cmdID, endPos, cmdColors.unload);
 					lineDrawer.Break(endPos, cmdColors.unload);
 					glColor4fv(cmdColors.unload);
+					DisableQueueCache();
 					glSurfaceCircle(endPos, ci->params[3], 20.0f);
 					lineDrawer.RestartWithColor(cmdColors.unload);
 				}
 				break;
 			}
 			case CMD_UNLOAD_UNIT: {
-				lineDrawer.DrawLineAndIcon(cmdID, ci->GetPos(0), cmdColors.unload);
+				DrawLineAndIcon(cmdID, ci->GetPos(0), cmdColors.unload);
 				break;
 			}
 			case CMD_WAIT: {
@@ -603,7 +683,7 @@ void CommandDrawer::DrawMobileCAICommands(const CMobileCAI* cai) const
 				break;
 			}
 			case CMD_SELFD: {
-				lineDrawer.DrawIconAtLastPos(cmdID);
+				DrawIconAtLastPos(cmdID);
 				break;
 			}
 			default: {
@@ -617,12 +697,51 @@ void CommandDrawer::DrawMobileCAICommands(const CMobileCAI* cai) const
 }
 
 
-void CommandDrawer::DrawWaitIcon(const Command& cmd) const
+void CommandDrawer::DrawWaitIcon(const Command& cmd)
 {
+	// wait icons are managed (and animated) by WaitCommandsAI
+	DisableQueueCache();
 	waitCommandsAI.AddIcon(cmd, lineDrawer.GetLastPos());
 }
 
-void CommandDrawer::DrawDefaultCommand(const Command& c, const CUnit* owner) const
+
+void CommandDrawer::DrawLineAndIcon(int cmdID, const float3& endPos, const float* color)
+{
+	if (curQueueCache != nullptr)
+		curQueueCache->cmdIcons.emplace_back(cmdID, endPos);
+
+	lineDrawer.DrawLineAndIcon(cmdID, endPos, color);
+}
+
+void CommandDrawer::DrawIconAtLastPos(int cmdID)
+{
+	if (curQueueCache != nullptr)
+		curQueueCache->cmdIcons.emplace_back(cmdID, lineDrawer.GetLastPos());
+
+	lineDrawer.DrawIconAtLastPos(cmdID);
+}
+
+void CommandDrawer::AddBuildIcon(int cmdID, const float3& pos, int team, int facing)
+{
+	if (curQueueCache != nullptr)
+		curQueueCache->buildIcons.push_back({cmdID, team, facing, pos});
+
+	cursorIcons.AddBuildIcon(cmdID, pos, team, facing);
+}
+
+void CommandDrawer::DisableQueueCache()
+{
+	// geometry being compiled depends on more state than the queue
+	// itself (moving targets, immediate-mode circles, ...), so the
+	// captured range would go stale without the counters noticing
+	if (curQueueCache == nullptr)
+		return;
+
+	curQueueCache->cacheable = false;
+	curQueueCache = nullptr;
+}
+
+void CommandDrawer::DrawDefaultCommand(const Command& c, const CUnit* owner)
 {
 	// TODO add Lua callin perhaps, for more elaborate needs?
 	const CCommandColors::DrawData* dd = cmdColors.GetCustomCmdData(c.GetID());
@@ -636,10 +755,11 @@ void CommandDrawer::DrawDefaultCommand(const Command& c, const CUnit* owner) con
 		const float3 endPos = c.GetPos(0) + UpVector * 3.0f;
 
 		if (!dd->showArea || (paramsCount < 4)) {
-			lineDrawer.DrawLineAndIcon(dd->cmdIconID, endPos, dd->color);
+			DrawLineAndIcon(dd->cmdIconID, endPos, dd->color);
 		} else {
-			lineDrawer.DrawLineAndIcon(dd->cmdIconID, endPos, dd->color);
+			DrawLineAndIcon(dd->cmdIconID, endPos, dd->color);
 			lineDrawer.Break(endPos, dd->color);
+			DisableQueueCache();
 			glSurfaceCircle(endPos, c.params[3], 20.0f);
 			lineDrawer.RestartWithColor(dd->color);
 		}
@@ -649,45 +769,20 @@ void CommandDrawer::DrawDefaultCommand(const Command& c, const CUnit* owner) con
 
 	if (paramsCount >= 1) {
 		// allow a second param (ignored here) for custom commands
+		DisableQueueCache();
 		const CUnit* unit = GetTrackableUnit(owner, unitHandler->GetUnit(c.params[0]));
 
 		if (unit != nullptr) {
-			lineDrawer.DrawLineAndIcon(dd->cmdIconID, unit->GetObjDrawErrorPos(owner->allyteam), dd->color);
+			DrawLineAndIcon(dd->cmdIconID, unit->GetObjDrawErrorPos(owner->allyteam), dd->color);
 		}
 	}
 }
 
-void CommandDrawer::DrawQuedBuildingSquares(const CBuilderCAI* cai) const
+void CommandDrawer::DrawQuedBuildingSquares(const CBuilderCAI* cai, const float* color) const
 {
 	const CCommandQueue& commandQue = cai->commandQue;
 	const auto& buildOptions = cai->buildOptions;
 
-	unsigned int  buildCommands = 0;
-	unsigned int uwaterCommands = 0;
-
-	for (const Command& c: commandQue) {
-		if (buildOptions.find(c.GetID()) == buildOptions.end())
-			continue;
-
-		BuildInfo bi(c);
-		bi.pos = CGameHelper::Pos2BuildPos(bi, false);
-
-		buildCommands += 1;
-		uwaterCommands += (bi.pos.y < 0.0f);
-	}
-
-	// worst case - 2 squares per building (when underwater) - 8 vertices * 3 floats
-	std::vector<GLfloat>   quadVerts(buildCommands * 12);
-	std::vector<GLfloat> uwquadVerts(buildCommands * 12); // underwater
-	// 4 vertical lines
-	std::vector<GLfloat> lineVerts(uwaterCommands * 24);
-	// colors for lines
-	std::vector<GLfloat> lineColors(uwaterCommands * 48);
-
-	unsigned int   quadcounter = 0;
-	unsigned int uwquadcounter = 0;
-	unsigned int   linecounter = 0;
-
 	for (const Command& c: commandQue) {
 		if (buildOptions.find(c.GetID()) == buildOptions.end())
 			continue;
@@ -704,94 +799,87 @@ void CommandDrawer::DrawQuedBuildingSquares(const CBuilderCAI* cai) const
 		const float x2 = bi.pos.x + xsize;
 		const float z2 = bi.pos.z + zsize;
 
-		quadVerts[quadcounter++] = x1;
-		quadVerts[quadcounter++] = h + 1;
-		quadVerts[quadcounter++] = z1;
-		quadVerts[quadcounter++] = x1;
-		quadVerts[quadcounter++] = h + 1;
-		quadVerts[quadcounter++] = z2;
-		quadVerts[quadcounter++] = x2;
-		quadVerts[quadcounter++] = h + 1;
-		quadVerts[quadcounter++] = z2;
-		quadVerts[quadcounter++] = x2;
-		quadVerts[quadcounter++] = h + 1;
-		quadVerts[quadcounter++] = z1;
+		const GLfloat quad[12] = {
+			x1, h + 1, z1,
+			x1, h + 1, z2,
+			x2, h + 1, z2,
+			x2, h + 1, z1,
+		};
+
+		buildQuadVerts.insert(buildQuadVerts.end(), quad, quad + 12);
+
+		for (int i = 0; i < 4; ++i) {
+			buildQuadColors.insert(buildQuadColors.end(), color, color + 4);
+		}
 
 		if (bi.pos.y >= 0.0f)
 			continue;
 
-		const float col[8] = {
+		// second square at the water surface
+		const GLfloat uwQuad[12] = {
+			x1, 0.0f, z1,
+			x1, 0.0f, z2,
+			x2, 0.0f, z2,
+			x2, 0.0f, z1,
+		};
+
+		buildUWQuadVerts.insert(buildUWQuadVerts.end(), uwQuad, uwQuad + 12);
+
+		const GLfloat col[8] = {
 			0.0f, 0.0f, 1.0f, 0.5f, // start color
 			0.0f, 0.5f, 1.0f, 1.0f, // end color
 		};
 
-		uwquadVerts[uwquadcounter++] = x1;
-		uwquadVerts[uwquadcounter++] = 0.0f;
-		uwquadVerts[uwquadcounter++] = z1;
-		uwquadVerts[uwquadcounter++] = x1;
-		uwquadVerts[uwquadcounter++] = 0.0f;
-		uwquadVerts[uwquadcounter++] = z2;
-		uwquadVerts[uwquadcounter++] = x2;
-		uwquadVerts[uwquadcounter++] = 0.0f;
-		uwquadVerts[uwquadcounter++] = z2;
-		uwquadVerts[uwquadcounter++] = x2;
-		uwquadVerts[uwquadcounter++] = 0.0f;
-		uwquadVerts[uwquadcounter++] = z1;
+		// 4 vertical lines connecting both squares
+		const GLfloat uwLines[24] = {
+			x1, h, z1,  x1, 0.0f, z1,
+			x2, h, z1,  x2, 0.0f, z1,
+			x2, h, z2,  x2, 0.0f, z2,
+			x1, h, z2,  x1, 0.0f, z2,
+		};
+
+		buildUWLineVerts.insert(buildUWLineVerts.end(), uwLines, uwLines + 24);
 
 		for (int i = 0; i < 4; ++i) {
-			std::copy(col, col + 8, lineColors.begin() + linecounter * 2 + i * 8);
+			buildUWLineColors.insert(buildUWLineColors.end(), col, col + 8);
 		}
-
-		lineVerts[linecounter++] = x1;
-		lineVerts[linecounter++] = h;
-		lineVerts[linecounter++] = z1;
-		lineVerts[linecounter++] = x1;
-		lineVerts[linecounter++] = 0.0f;
-		lineVerts[linecounter++] = z1;
-
-		lineVerts[linecounter++] = x2;
-		lineVerts[linecounter++] = h;
-		lineVerts[linecounter++] = z1;
-		lineVerts[linecounter++] = x2;
-		lineVerts[linecounter++] = 0.0f;
-		lineVerts[linecounter++] = z1;
-
-		lineVerts[linecounter++] = x2;
-		lineVerts[linecounter++] = h;
-		lineVerts[linecounter++] = z2;
-		lineVerts[linecounter++] = x2;
-		lineVerts[linecounter++] = 0.0f;
-		lineVerts[linecounter++] = z2;
-
-		lineVerts[linecounter++] = x1;
-		lineVerts[linecounter++] = h;
-		lineVerts[linecounter++] = z2;
-		lineVerts[linecounter++] = x1;
-		lineVerts[linecounter++] = 0.0f;
-		lineVerts[linecounter++] = z2;
 	}
+}
 
-	if (quadcounter > 0) {
-		glEnableClientState(GL_VERTEX_ARRAY);
-		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-		glVertexPointer(3, GL_FLOAT, 0, &quadVerts[0]);
-		glDrawArrays(GL_QUADS, 0, quadcounter / 3);
-
-		if (linecounter > 0) {
-			glPushAttrib(GL_CURRENT_BIT);
-			glColor4f(0.0f, 0.5f, 1.0f, 1.0f); // same as end color of lines
-			glVertexPointer(3, GL_FLOAT, 0, &uwquadVerts[0]);
-			glDrawArrays(GL_QUADS, 0, uwquadcounter / 3);
-			glPopAttrib();
-
-			glEnableClientState(GL_COLOR_ARRAY);
-			glColorPointer(4, GL_FLOAT, 0, &lineColors[0]);
-			glVertexPointer(3, GL_FLOAT, 0, &lineVerts[0]);
-			glDrawArrays(GL_LINES, 0, linecounter / 3);
-			glDisableClientState(GL_COLOR_ARRAY);
-		}
+void CommandDrawer::FlushQuedBuildingSquares() const
+{
+	if (buildQuadVerts.empty())
+		return;
 
-		glDisableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+
+	glEnableClientState(GL_COLOR_ARRAY);
+	glColorPointer(4, GL_FLOAT, 0, &buildQuadColors[0]);
+	glVertexPointer(3, GL_FLOAT, 0, &buildQuadVerts[0]);
+	glDrawArrays(GL_QUADS, 0, buildQuadVerts.size() / 3);
+	glDisableClientState(GL_COLOR_ARRAY);
+
+	if (!buildUWQuadVerts.empty()) {
+		glPushAttrib(GL_CURRENT_BIT);
+		glColor4f(0.0f, 0.5f, 1.0f, 1.0f); // same as end color of lines
+		glVertexPointer(3, GL_FLOAT, 0, &buildUWQuadVerts[0]);
+		glDrawArrays(GL_QUADS, 0, buildUWQuadVerts.size() / 3);
+		glPopAttrib();
+
+		glEnableClientState(GL_COLOR_ARRAY);
+		glColorPointer(4, GL_FLOAT, 0, &buildUWLineColors[0]);
+		glVertexPointer(3, GL_FLOAT, 0, &buildUWLineVerts[0]);
+		glDrawArrays(GL_LINES, 0, buildUWLineVerts.size() / 3);
+		glDisableClientState(GL_COLOR_ARRAY);
 	}
-}
 
+	glDisableClientState(GL_VERTEX_ARRAY);
+
+	// keep the allocations, the buffers fill up again next frame
+	buildQuadVerts.clear();
+	buildQuadColors.clear();
+	buildUWQuadVerts.clear();
+	buildUWLineVerts.clear();
+	buildUWLineColors.clear();
+}
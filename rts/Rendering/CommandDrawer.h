@@ -3,6 +3,11 @@
 #ifndef COMMAND_DRAWER_H
 #define COMMAND_DRAWER_H
 
+#include <vector>
+
+#include "Rendering/GL/myGL.h"
+#include "System/float3.h"
+#include "System/UnorderedMap.hpp"
 #include "System/UnorderedSet.hpp"
 
 struct Command;
@@ -20,23 +25,61 @@ public:
 	// clear the set after WorldDrawer and MiniMap have both used it
 	void Update() { luaQueuedUnitSet.clear(); }
 
-	void Draw(const CCommandAI*) const;
-	void DrawLuaQueuedUnitSetCommands() const;
-	void DrawQuedBuildingSquares(const CBuilderCAI*) const;
+	void Draw(const CCommandAI*);
+	void DrawLuaQueuedUnitSetCommands();
+	// accumulates into a shared batch, drawn by FlushQuedBuildingSquares
+	void DrawQuedBuildingSquares(const CBuilderCAI*, const float* color) const;
+	void FlushQuedBuildingSquares() const;
 
 	void AddLuaQueuedUnit(const CUnit* unit);
 
 private:
-	void DrawCommands(const CCommandAI*) const;
-	void DrawAirCAICommands(const CAirCAI*) const;
-	void DrawBuilderCAICommands(const CBuilderCAI*) const;
-	void DrawFactoryCAICommands(const CFactoryCAI*) const;
-	void DrawMobileCAICommands(const CMobileCAI*) const;
+	void DrawCommands(const CCommandAI*);
+	void DrawAirCAICommands(const CAirCAI*);
+	void DrawBuilderCAICommands(const CBuilderCAI*);
+	void DrawFactoryCAICommands(const CFactoryCAI*);
+	void DrawMobileCAICommands(const CMobileCAI*);
+
+	void DrawWaitIcon(const Command&);
+	void DrawDefaultCommand(const Command&, const CUnit*);
 
-	void DrawWaitIcon(const Command&) const;
-	void DrawDefaultCommand(const Command&, const CUnit*) const;
+	// wrappers that also record their icons in the active queue-cache
+	// entry, so cache replays can re-register them with cursorIcons
+	void DrawLineAndIcon(int cmdID, const float3& endPos, const float* color);
+	void DrawIconAtLastPos(int cmdID);
+	void AddBuildIcon(int cmdID, const float3& pos, int team, int facing);
+
+	// geometry of the current queue depends on more state than the queue
+	// itself (moving targets, immediate-mode circles, ...), do not retain
+	void DisableQueueCache();
 
 private:
+	struct CachedBuildIcon {
+		int cmdID;
+		int team;
+		int facing;
+		float3 pos;
+	};
+
+	// per-unit retained copy of the line geometry and icons compiled from
+	// its command queue, replayed as-is while the queue does not change;
+	// entries are recycled when unit ids are
+	struct QueueCache {
+		unsigned int cmdQueCounter = -1u;
+		unsigned int nextQueCounter = -1u;
+		bool selfDIcon = false;
+		bool cacheable = false;
+		float3 anchorPos;
+
+		std::vector<GLfloat> verts;
+		std::vector<GLfloat> colors;
+		std::vector<std::pair<int, float3> > cmdIcons;
+		std::vector<CachedBuildIcon> buildIcons;
+	};
+
+	spring::unordered_map<int, QueueCache> queueCache;
+	QueueCache* curQueueCache = nullptr;
+
 	spring::unordered_set<int> luaQueuedUnitSet;
 };
 
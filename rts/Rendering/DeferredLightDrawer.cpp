@@ -0,0 +1,323 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "DeferredLightDrawer.h"
+
+#include <algorithm>
+
+#include "Game/Camera.h"
+#include "Game/GlobalUnsynced.h"
+#include "Map/BaseGroundDrawer.h"
+#include "Map/ReadMap.h"
+#include "Rendering/GlobalRendering.h"
+#include "Rendering/UnitDrawer.h"
+#include "Rendering/GL/myGL.h"
+#include "Rendering/GL/GeometryBuffer.h"
+#include "Rendering/GL/LightHandler.h"
+#include "Rendering/GL/VertexArray.h"
+#include "Rendering/Shaders/ShaderHandler.h"
+#include "Rendering/Shaders/Shader.h"
+#include "Sim/Misc/LosHandler.h"
+#include "System/Config/ConfigHandler.h"
+#include "System/Matrix44f.h"
+#include "System/myMath.h"
+#include "System/StringUtil.h"
+
+CONFIG(bool, TiledDeferredLights).defaultValue(false).safemodeValue(false).description("Apply dynamic map- and model-lights in a tiled deferred pass; requires AllowDeferredMapRendering and/or AllowDeferredModelRendering.");
+CONFIG(int, MaxTiledDeferredLights).defaultValue(128).minimumValue(8).description("Size of each dynamic light pool when TiledDeferredLights is enabled.");
+
+CDeferredLightDrawer* deferredLightDrawer = nullptr;
+
+// screen pixels per tile
+static const int TILE_PIXELS = 64;
+// light slots per tile; surplus lights in a tile are dropped
+static const int MAX_TILE_LIGHTS = 32;
+
+
+CDeferredLightDrawer::CDeferredLightDrawer()
+	: lightShader(nullptr)
+	, tileTex(0)
+	, tilesX(0)
+	, tilesY(0)
+	, tileTexSizeX(0)
+	, enabled(false)
+{
+	if (!globalRendering->haveGLSL || !GLEW_ARB_texture_float)
+		return;
+	if (!configHandler->GetBool("TiledDeferredLights"))
+		return;
+
+	const GL::GeometryBuffer* mapBuf = (readMap->GetGroundDrawer())->GetGeometryBuffer();
+	const GL::GeometryBuffer* mdlBuf = unitDrawer->GetGeometryBuffer();
+
+	// need at least one source of normals and depth
+	if ((mapBuf == nullptr || !mapBuf->Valid()) && (mdlBuf == nullptr || !mdlBuf->Valid()))
+		return;
+
+	const std::string defines = "#define MAX_TILE_LIGHTS " + IntToString(MAX_TILE_LIGHTS) + "\n";
+
+	lightShader = shaderHandler->CreateProgramObject("[DeferredLightDrawer]", "DeferredLightsGLSL", false);
+	lightShader->AttachShaderObject(shaderHandler->CreateShaderObject("GLSL/DeferredLightsVertProg.glsl", defines, GL_VERTEX_SHADER));
+	lightShader->AttachShaderObject(shaderHandler->CreateShaderObject("GLSL/DeferredLightsFragProg.glsl", defines, GL_FRAGMENT_SHADER));
+	lightShader->Link();
+
+	lightShader->Enable();
+	lightShader->SetUniform("normTex", 0);
+	lightShader->SetUniform("diffTex", 1);
+	lightShader->SetUniform("depthTex", 2);
+	lightShader->SetUniform("otherDepthTex", 3);
+	lightShader->SetUniform("tileTex", 4);
+	lightShader->Disable();
+	lightShader->Validate();
+
+	if (!lightShader->IsValid())
+		return;
+
+	// the tile pass takes over all light application; enlarge the pools
+	// beyond the FFP slot count and keep the forward path dark
+	const unsigned int poolSize = configHandler->GetInt("MaxTiledDeferredLights");
+
+	GL::LightHandler* mapLightHandler = (readMap->GetGroundDrawer())->GetLightHandler();
+	GL::LightHandler* mdlLightHandler = unitDrawer->GetLightHandler();
+
+	if (mapLightHandler != nullptr) {
+		mapLightHandler->SetPoolSize(poolSize);
+		mapLightHandler->SetDeferredOnly(true);
+	}
+	if (mdlLightHandler != nullptr) {
+		mdlLightHandler->SetPoolSize(poolSize);
+		mdlLightHandler->SetDeferredOnly(true);
+	}
+
+	enabled = true;
+}
+
+CDeferredLightDrawer::~CDeferredLightDrawer()
+{
+	if (tileTex != 0)
+		glDeleteTextures(1, &tileTex);
+
+	shaderHandler->ReleaseProgramObjects("[DeferredLightDrawer]");
+}
+
+
+void CDeferredLightDrawer::UpdateTileGrid()
+{
+	const int newTilesX = (globalRendering->viewSizeX + TILE_PIXELS - 1) / TILE_PIXELS;
+	const int newTilesY = (globalRendering->viewSizeY + TILE_PIXELS - 1) / TILE_PIXELS;
+
+	if (newTilesX == tilesX && newTilesY == tilesY)
+		return;
+
+	tilesX = newTilesX;
+	tilesY = newTilesY;
+	tileTexSizeX = tilesX * MAX_TILE_LIGHTS * 2;
+
+	tileTexData.resize(tileTexSizeX * tilesY * 4);
+	tileFillCounts.resize(tilesX * tilesY);
+
+	if (tileTex != 0)
+		glDeleteTextures(1, &tileTex);
+
+	glGenTextures(1, &tileTex);
+	glBindTexture(GL_TEXTURE_2D, tileTex);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F_ARB, tileTexSizeX, tilesY, 0, GL_RGBA, GL_FLOAT, nullptr);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+
+void CDeferredLightDrawer::CollectLights(const GL::LightHandler* lightHandler)
+{
+	if (lightHandler == nullptr)
+		return;
+
+	for (const GL::Light& light: lightHandler->GetLights()) {
+		if (light.GetTTL() == 0 || light.GetRadius() <= 0.0f)
+			continue;
+
+		const float3* trackPos = light.GetTrackPosition();
+		const float3 lightPos = (trackPos != nullptr)? *trackPos: float3(light.GetPosition());
+
+		// same LOS policy as the forward path
+		if (!gu->spectatingFullView && !light.GetIgnoreLOS() && !losHandler->InLos(lightPos, gu->myAllyTeam))
+			continue;
+
+		const float4& diffuseCol = light.GetDiffuseColor();
+
+		if ((diffuseCol.r * diffuseCol.r + diffuseCol.g * diffuseCol.g + diffuseCol.b * diffuseCol.b) <= 0.0001f)
+			continue;
+
+		DeferredLight dl;
+		dl.pos = lightPos;
+		dl.radius = light.GetRadius();
+		dl.color = diffuseCol;
+
+		lightData.push_back(dl);
+	}
+}
+
+
+void CDeferredLightDrawer::BinLights()
+{
+	std::fill(tileTexData.begin(), tileTexData.end(), 0.0f);
+	std::fill(tileFillCounts.begin(), tileFillCounts.end(), 0);
+
+	const CCamera* cam = CCamera::GetCamera(CCamera::CAMTYPE_PLAYER);
+	const float3& camPos = cam->GetPos();
+	const float3& camDir = cam->GetDir();
+
+	for (const DeferredLight& dl: lightData) {
+		// conservative screen-rect of the light's bounding sphere; if
+		// any corner projects from behind the camera fall back to the
+		// whole grid
+		int tx0 = 0, tx1 = tilesX - 1;
+		int ty0 = 0, ty1 = tilesY - 1;
+
+		float2 mins = {1e9f, 1e9f};
+		float2 maxs = {-1e9f, -1e9f};
+
+		bool projectable = true;
+
+		for (int c = 0; c < 8 && projectable; c++) {
+			const float3 corner = dl.pos + float3(
+				((c & 1) != 0)? dl.radius: -dl.radius,
+				((c & 2) != 0)? dl.radius: -dl.radius,
+				((c & 4) != 0)? dl.radius: -dl.radius
+			);
+
+			projectable = (camDir.dot(corner - camPos) > 1.0f);
+
+			const float3 winPos = cam->CalcWindowCoordinates(corner);
+
+			mins.x = std::min(mins.x, winPos.x); maxs.x = std::max(maxs.x, winPos.x);
+			mins.y = std::min(mins.y, winPos.y); maxs.y = std::max(maxs.y, winPos.y);
+		}
+
+		if (projectable) {
+			tx0 = Clamp(int((mins.x - globalRendering->viewPosX) / TILE_PIXELS), 0, tilesX - 1);
+			tx1 = Clamp(int((maxs.x - globalRendering->viewPosX) / TILE_PIXELS), 0, tilesX - 1);
+			ty0 = Clamp(int((mins.y - globalRendering->viewPosY) / TILE_PIXELS), 0, tilesY - 1);
+			ty1 = Clamp(int((maxs.y - globalRendering->viewPosY) / TILE_PIXELS), 0, tilesY - 1);
+		}
+
+		for (int ty = ty0; ty <= ty1; ty++) {
+			for (int tx = tx0; tx <= tx1; tx++) {
+				int& fillCount = tileFillCounts[ty * tilesX + tx];
+
+				if (fillCount >= MAX_TILE_LIGHTS)
+					continue;
+
+				float* slot = &tileTexData[(ty * tileTexSizeX + (tx * MAX_TILE_LIGHTS + fillCount) * 2) * 4];
+
+				slot[0] = dl.pos.x;
+				slot[1] = dl.pos.y;
+				slot[2] = dl.pos.z;
+				slot[3] = dl.radius;
+				slot[4] = dl.color.x;
+				slot[5] = dl.color.y;
+				slot[6] = dl.color.z;
+				slot[7] = 0.0f;
+
+				fillCount += 1;
+			}
+		}
+	}
+
+	glBindTexture(GL_TEXTURE_2D, tileTex);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, tileTexSizeX, tilesY, GL_RGBA, GL_FLOAT, &tileTexData[0]);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+
+void CDeferredLightDrawer::DrawPass(const GL::GeometryBuffer* gb, const GL::GeometryBuffer* other)
+{
+	glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_2D, gb->GetBufferTexture(GL::GeometryBuffer::ATTACHMENT_NORMTEX));
+	glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_2D, gb->GetBufferTexture(GL::GeometryBuffer::ATTACHMENT_DIFFTEX));
+	glActiveTexture(GL_TEXTURE2); glBindTexture(GL_TEXTURE_2D, gb->GetBufferTexture(GL::GeometryBuffer::ATTACHMENT_ZVALTEX));
+	glActiveTexture(GL_TEXTURE3); glBindTexture(GL_TEXTURE_2D, (other != nullptr)? other->GetBufferTexture(GL::GeometryBuffer::ATTACHMENT_ZVALTEX): 0);
+	glActiveTexture(GL_TEXTURE0);
+
+	lightShader->SetUniform("haveOtherDepth", (other != nullptr)? 1.0f: 0.0f);
+
+	CVertexArray* va = GetVertexArray();
+	va->Initialize();
+	va->EnlargeArrays(4, 0, VA_SIZE_0);
+	va->AddVertexQ0(-1.0f, -1.0f, 0.0f);
+	va->AddVertexQ0( 1.0f, -1.0f, 0.0f);
+	va->AddVertexQ0( 1.0f,  1.0f, 0.0f);
+	va->AddVertexQ0(-1.0f,  1.0f, 0.0f);
+	va->DrawArray0(GL_QUADS);
+}
+
+
+void CDeferredLightDrawer::Draw()
+{
+	if (!enabled)
+		return;
+
+	const CBaseGroundDrawer* gd = readMap->GetGroundDrawer();
+
+	const GL::GeometryBuffer* mapBuf = gd->GetGeometryBuffer();
+	const GL::GeometryBuffer* mdlBuf = unitDrawer->GetGeometryBuffer();
+
+	const bool haveMapBuf = (mapBuf != nullptr && mapBuf->Valid() && gd->DrawDeferred());
+	const bool haveMdlBuf = (mdlBuf != nullptr && mdlBuf->Valid() && unitDrawer->DrawDeferred());
+
+	if (!haveMapBuf && !haveMdlBuf)
+		return;
+
+	lightData.clear();
+	CollectLights(gd->GetLightHandler());
+	CollectLights(unitDrawer->GetLightHandler());
+
+	if (lightData.empty())
+		return;
+
+	UpdateTileGrid();
+	BinLights();
+
+	glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	glDisable(GL_DEPTH_TEST);
+	glDepthMask(GL_FALSE);
+	glDisable(GL_ALPHA_TEST);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_ONE, GL_ONE);
+
+	const CCamera* cam = CCamera::GetCamera(CCamera::CAMTYPE_PLAYER);
+
+	// bias from [0,1]^3 window-space into [-1,1]^3 NDC (same transform
+	// DecalsDrawerGL4 uses for its world-position reconstruction)
+	CMatrix44f vpi = cam->GetViewProjectionMatrixInverse();
+	vpi.Translate(-OnesVector);
+	vpi.Scale(OnesVector * 2.0f);
+
+	lightShader->Enable();
+	lightShader->SetUniformMatrix4x4("viewProjMatrixInv", false, vpi.m);
+	lightShader->SetUniform("invScreenSize", 1.0f / globalRendering->viewSizeX, 1.0f / globalRendering->viewSizeY);
+	lightShader->SetUniform("invTileTexSize", 1.0f / tileTexSizeX, 1.0f / tilesY);
+	lightShader->SetUniform("viewPos", float(globalRendering->viewPosX), float(globalRendering->viewPosY));
+	lightShader->SetUniform("tilePixels", float(TILE_PIXELS));
+
+	glActiveTexture(GL_TEXTURE4);
+	glBindTexture(GL_TEXTURE_2D, tileTex);
+	glActiveTexture(GL_TEXTURE0);
+
+	// each pass lights only the fragments its own buffer is nearest
+	// for, so overlaps between terrain and models resolve correctly
+	if (haveMapBuf)
+		DrawPass(mapBuf, haveMdlBuf? mdlBuf: nullptr);
+	if (haveMdlBuf)
+		DrawPass(mdlBuf, haveMapBuf? mapBuf: nullptr);
+
+	lightShader->Disable();
+
+	for (int u = 4; u >= 0; u--) {
+		glActiveTexture(GL_TEXTURE0 + u);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	glPopAttrib();
+}
@@ -0,0 +1,74 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef DEFERRED_LIGHT_DRAWER_H
+#define DEFERRED_LIGHT_DRAWER_H
+
+#include <vector>
+
+#include "System/float3.h"
+
+namespace GL {
+	struct LightHandler;
+	struct GeometryBuffer;
+}
+namespace Shader {
+	struct IProgramObject;
+}
+
+/**
+ * Tiled deferred application of dynamic lights.
+ *
+ * Collects the lights of both LightHandlers (map and model, the ones
+ * LuaUnsyncedCtrl::Add{Map,Model}Light feed into), bins them per screen
+ * tile on the CPU and applies each tile's list in a single additive
+ * fragment pass over the geometry-buffer attachments that the deferred
+ * map and model passes already produce. This lifts the FFP limit of a
+ * handful of forward lights to hundreds; when active, both handlers are
+ * switched to deferred-only mode so nothing is lit twice.
+ *
+ * Requires AllowDeferred{Map,Model}Rendering (at least one) and is
+ * enabled with the TiledDeferredLights config-flag.
+ */
+class CDeferredLightDrawer {
+public:
+	CDeferredLightDrawer();
+	~CDeferredLightDrawer();
+
+	/// apply the binned lights to the opaque scene; call after the
+	/// opaque model pass so both geometry-buffers are complete
+	void Draw();
+
+	bool Enabled() const { return enabled; }
+
+private:
+	void UpdateTileGrid();
+	void CollectLights(const GL::LightHandler* lightHandler);
+	void BinLights();
+	void DrawPass(const GL::GeometryBuffer* gb, const GL::GeometryBuffer* other);
+
+	struct DeferredLight {
+		float3 pos;
+		float radius;
+		float3 color;
+	};
+
+	std::vector<DeferredLight> lightData;
+
+	/// MAX_TILE_LIGHTS slots of two RGBA32F texels per tile, row-major
+	std::vector<float> tileTexData;
+	std::vector<int> tileFillCounts;
+
+	Shader::IProgramObject* lightShader;
+
+	unsigned int tileTex;
+
+	int tilesX;
+	int tilesY;
+	int tileTexSizeX;
+
+	bool enabled;
+};
+
+extern CDeferredLightDrawer* deferredLightDrawer;
+
+#endif // DEFERRED_LIGHT_DRAWER_H
@@ -8,6 +8,8 @@
 #include "Map/MapInfo.h"
 #include "Rendering/GlobalRendering.h"
 #include "Rendering/GL/VertexArray.h"
+#include "Rendering/Shaders/Shader.h"
+#include "Rendering/Shaders/ShaderHandler.h"
 #include "Sim/Misc/GlobalSynced.h"
 #include "System/Config/ConfigHandler.h"
 #include "System/Exceptions.h"
@@ -26,9 +28,10 @@ CAdvSky::CAdvSky()
 	: skydir1(ZeroVector)
 	, skydir2(ZeroVector)
 	, cdtex(0)
+	, randTex(0)
 	, cloudFP(0)
+	, cloudsShader(nullptr)
 	, drawFlare(false)
-	, cloudTexMem(NULL)
 	, skyTex(0)
 	, skyDot3Tex(0)
 	, cloudDot3Tex(0)
@@ -43,25 +46,19 @@ CAdvSky::CAdvSky()
 	, sunTexCoordX(0.0f)
 	, sunTexCoordY(0.0f)
 	, randMatrix(NULL)
-	, rawClouds(NULL)
-	, blendMatrix(NULL)
-	, cloudThickness(NULL)
 	, oldCoverBaseX(-5)
 	, oldCoverBaseY(0)
-	, updatecounter(0)
 {
 	skytexpart = new unsigned char[512][4];
 
-	if (!(FBO::IsSupported() && GLEW_ARB_fragment_program && ProgramStringIsNative(GL_FRAGMENT_PROGRAM_ARB, "ARB/clouds.fp"))) {
+	if (!(FBO::IsSupported() && globalRendering->haveGLSL && GLEW_ARB_fragment_program && ProgramStringIsNative(GL_FRAGMENT_PROGRAM_ARB, "ARB/clouds.fp"))) {
 		throw content_error("ADVSKY: missing OpenGL features!");
 	}
 
 	randMatrix = newmat3<int>(16, 32, 32);
-	rawClouds = newmat2<int>(CLOUD_SIZE, CLOUD_SIZE);
-	blendMatrix = newmat3<int>(CLOUD_DETAIL, 32, 32);
 
 	memset(alphaTransform, 0, 1024);
-	memset(thicknessTransform, 0, 1024);
+	memset(octaveFades, 0, sizeof(octaveFades));
 	memset(covers, 0, 4 * 32 * sizeof(float));
 
 	domeheight = std::cos(math::PI / 16) * 1.01f;
@@ -170,20 +167,18 @@ CAdvSky::~CAdvSky()
 	glDeleteTextures(1, &skyTex);
 	glDeleteTextures(1, &skyDot3Tex);
 	glDeleteTextures(1, &cloudDot3Tex);
+	glDeleteTextures(1, &randTex);
 	glDeleteLists(skyDomeList, 1);
 
 	glDeleteTextures(1, &sunTex);
 	glDeleteTextures(1, &sunFlareTex);
 	glDeleteLists(sunFlareList,1);
 
-	delete[] cloudThickness;
-	delete[] cloudTexMem;
-
 	glSafeDeleteProgram( cloudFP );
 
+	shaderHandler->ReleaseProgramObjects("[AdvSky]");
+
 	delmat3<int>(randMatrix);
-	delmat2<int>(rawClouds);
-	delmat3<int>(blendMatrix);
 
 	delete[] skytexpart;
 }
@@ -248,9 +243,6 @@ float3 CAdvSky::GetCoord(int x, int y)
 
 void CAdvSky::CreateClouds()
 {
-	cloudThickness=new unsigned char[CLOUD_SIZE*CLOUD_SIZE+1];
-	cloudTexMem=new unsigned char[CLOUD_SIZE*CLOUD_SIZE*4];
-
 	glGenTextures(1, &skyTex);
 	glGenTextures(1, &skyDot3Tex);
 	glGenTextures(1, &cloudDot3Tex);
@@ -312,6 +304,19 @@ void CAdvSky::CreateClouds()
 		CreateRandMatrix(randMatrix[a+8],1-a*0.03f);
 	}
 
+	// the octave slices the cloud-gen shader samples; both slices of
+	// each octave stay resident, re-uploaded only when re-randomized
+	glGenTextures(1, &randTex);
+	glBindTexture(GL_TEXTURE_2D, randTex);
+	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_NEAREST);
+	glTexImage2D(GL_TEXTURE_2D,0,GL_LUMINANCE, 32, 32*12,0,GL_LUMINANCE, GL_UNSIGNED_BYTE, NULL);
+
+	for(int a=0;a<CLOUD_DETAIL;a++){
+		UpdateRandTexSlice(a, randMatrix[a]);
+		UpdateRandTexSlice(a+CLOUD_DETAIL, randMatrix[a+8]);
+	}
+
 	glBindTexture(GL_TEXTURE_2D, cloudDot3Tex);
 	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_LINEAR);
@@ -326,44 +331,60 @@ void CAdvSky::CreateClouds()
 		throw content_error("ADVSKY: FBO is unavailable");
 	}
 
+	cloudsFBO.reloadOnAltTab = true;
+	cloudsFBO.Bind();
+	cloudsFBO.AttachTexture(cloudDot3Tex);
+	status = cloudsFBO.CheckStatus("ADVSKY-CLOUDS");
+	FBO::Unbind();
+	if (!status) {
+		throw content_error("ADVSKY: cloud FBO is unavailable");
+	}
+
+	CreateCloudsShader();
 	CreateTransformVectors();
-	for(int i=0; i<CLOUD_DETAIL+7; ++i)
-		Update();
+	Update();
 }
 
-inline void CAdvSky::UpdatePart(int ast, int aed, int a3cstart, int a4cstart) {
-	int* rc = *rawClouds + ast;
-	unsigned char* ct = cloudTexMem + 4 * ast;
-
-	int yam2 = ydif[(ast - 2) & CLOUD_MASK];
-	int yam1 = ydif[(ast - 1) & CLOUD_MASK];
-	int yaa  = ydif[(ast)     & CLOUD_MASK];
-	int ap1  = (ast + 1) & CLOUD_MASK;
-
-	int a3c  = ast + a3cstart;
-	int a4c  = ast + a4cstart;
-
-	for (int a = ast; a < aed; ++rc, ++ct) {
-		int yap1 = ydif[ap1] += (int) cloudThickness[++a3c] - cloudThickness[++a] * 2 + cloudThickness[++a4c];
-
-		ap1++;
-		ap1 = (ap1 & CLOUD_MASK);
-		int dif =
-			(yam2 >> 2) +
-			(yam1 >> 1) +
-			(yaa) +
-			(yap1 >> 1) +
-			(ydif[ap1] >> 2);
-		dif >>= 4;
-
-		yam2 = yam1;
-		yam1 = yaa;
-		yaa  = yap1;
-
-		*ct++ = 128 + dif;
-		*ct++ = thicknessTransform[(*rc) >> 7];
-		*ct++ = 255;
+void CAdvSky::CreateCloudsShader()
+{
+	cloudsShader = shaderHandler->CreateProgramObject("[AdvSky]", "CloudsShader", false);
+	cloudsShader->AttachShaderObject(shaderHandler->CreateShaderObject("GLSL/AdvSkyCloudsFragProg.glsl", "", GL_FRAGMENT_SHADER));
+	cloudsShader->Link();
+
+	if (!cloudsShader->IsValid()) {
+		const std::string log = cloudsShader->GetLog();
+		shaderHandler->ReleaseProgramObjects("[AdvSky]");
+		cloudsShader = nullptr;
+		throw content_error("ADVSKY: cloud-gen shader errors: " + log);
 	}
+
+	cloudsShader->SetUniformLocation("randTex");         // idx 0
+	cloudsShader->SetUniformLocation("cloudDensity");    // idx 1
+	cloudsShader->SetUniformLocation("octaveFades[0]");  // idx 2
+	cloudsShader->SetUniformLocation("octaveFades[1]");  // idx 3
+	cloudsShader->SetUniformLocation("octaveFades[2]");  // idx 4
+	cloudsShader->SetUniformLocation("octaveFades[3]");  // idx 5
+	cloudsShader->SetUniformLocation("octaveFades[4]");  // idx 6
+	cloudsShader->SetUniformLocation("octaveFades[5]");  // idx 7
+
+	cloudsShader->Enable();
+	cloudsShader->SetUniform1i(0, 0);
+	cloudsShader->SetUniform1f(1, cloudDensity);
+	cloudsShader->Disable();
+}
+
+void CAdvSky::UpdateRandTexSlice(int slice, int** matrix)
+{
+	unsigned char buf[32 * 32];
+
+	for (int y = 0; y < 32; y++) {
+		for (int x = 0; x < 32; x++) {
+			buf[y * 32 + x] = matrix[y][x];
+		}
+	}
+
+	glBindTexture(GL_TEXTURE_2D, randTex);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, slice * 32, 32, 32, GL_LUMINANCE, GL_UNSIGNED_BYTE, buf);
 }
 
 void CAdvSky::Update()
@@ -375,140 +396,71 @@ void CAdvSky::Update()
 
 	CreateDetailTex();
 
-	static int kernel[CLOUD_SIZE/4*CLOUD_SIZE/4];
-
-	int updatepart = updatecounter++ % (CLOUD_DETAIL + 7);
-
-	switch(updatepart) { // smoothen out the workload across draw frames
-	case 0: {
-		for(int a=0; a<CLOUD_DETAIL; a++) {
-			float fade = gs->frameNum / (70.0f * (2<<(CLOUD_DETAIL-1-a)));
-			fade -= std::floor(fade/2)*2;
-			if(fade>1) {
-				fade = 2 - fade;
-				if(!cloudDown[a]) {
-					cloudDown[a]=true;
-					CreateRandMatrix(randMatrix[a+8],1-a*0.03f);
-				}
-			} else {
-				if(cloudDown[a]) {
-					cloudDown[a]=false;
-					CreateRandMatrix(randMatrix[a],1-a*0.03f);
-				}
+	// advance the octave cross-fades; a slice is re-randomized (and
+	// re-uploaded) only when its fade direction flips, all remaining
+	// per-frame work happens in the cloud-gen fragment shader
+	for(int a=0; a<CLOUD_DETAIL; a++) {
+		float fade = gs->frameNum / (70.0f * (2<<(CLOUD_DETAIL-1-a)));
+		fade -= std::floor(fade/2)*2;
+		if(fade>1) {
+			fade = 2 - fade;
+			if(!cloudDown[a]) {
+				cloudDown[a]=true;
+				CreateRandMatrix(randMatrix[a+8],1-a*0.03f);
+				UpdateRandTexSlice(a+CLOUD_DETAIL, randMatrix[a+8]);
 			}
-			int ifade=(int)(fade*fade*(3-2*fade)*256);
-			int ifade2=256-ifade;
-
-			for(int y=0;y<32;y++){
-				for(int x=0;x<32;x++)
-					blendMatrix[a][y][x]=(randMatrix[a][y][x]*ifade+randMatrix[a+8][y][x]*ifade2)>>8;
+		} else {
+			if(cloudDown[a]) {
+				cloudDown[a]=false;
+				CreateRandMatrix(randMatrix[a],1-a*0.03f);
+				UpdateRandTexSlice(a, randMatrix[a]);
 			}
 		}
 
-		for(int a=0;a<CLOUD_SIZE*CLOUD_SIZE;a++)
-			rawClouds[0][a]=0;
-		break;
+		octaveFades[a] = fade*fade*(3-2*fade);
 	}
-	default: { // 0<updatepart<=CLOUD_DETAIL
-		int a=updatepart-1;
-		int cs4a=(CLOUD_SIZE/4)>>a;
-		int cs8a=(CLOUD_SIZE/8)>>a;
-		int cmcs8a=CLOUD_SIZE-cs8a;
-		int qcda=(4<<CLOUD_DETAIL)>>a;
-		int *pkernel=kernel;
-		for(int y=0; y<cs4a; ++y, pkernel+=CLOUD_SIZE/4) {
-			float ydist=std::fabs(1.0f+y-cs8a)/cs8a;
-			ydist=ydist*ydist*(3-2*ydist);
-			int *pkrn=pkernel;
-			for(int x=0; x<cs4a; ++x) {
-				float xdist=std::fabs(1.0f+x-cs8a)/cs8a;
-				xdist=xdist*xdist*(3-2*xdist);
-
-				float contrib=(1-xdist)*(1-ydist);
-				(*pkrn++)=(int)(contrib*qcda);
-			}
-		}
-		--cs4a; //!
-		int **bm=blendMatrix[a];
-		for(int y=0, by=0, bx=0, **prc=rawClouds; y<cmcs8a; y+=cs8a, ++by, prc+=cs8a) {
-			for(int x=0; x<cmcs8a; x+=cs8a, ++bx) {
-				int blend=bm[by&31][bx&31], **prcy=prc, *pkernel=kernel;
-				for(int y2=0; y2<cs4a; ++y2, ++prcy, pkernel+=CLOUD_SIZE/4) {
-					int *prcx=(*prcy)+x, *pkrn=pkernel; // pkrn = kernel[y2*CLOUD_SIZE/4+x2];
-					for(int x2=0; x2<cs4a; ++x2)
-						(*prcx++)+=blend*(*pkrn++); // prcx = rawClouds[y2+y][x2+x]
-				}
-			}
-		}
-		for(int y=0, by=0, **prc=rawClouds; y<cmcs8a; y+=cs8a, ++by, prc+=cs8a) {
-			int blend=bm[by&31][31&31], **prcy=prc, *pkernel=kernel;
-			for(int y2=0; y2<cs4a; ++y2, ++prcy, pkernel+=CLOUD_SIZE/4) {
-				int *prcx=(*prcy)+cmcs8a, *pkrn=pkernel;
-				for(int x2=cmcs8a; x2 < std::min(CLOUD_SIZE, cs4a+cmcs8a); ++x2)
-					(*prcx++)+=blend*(*pkrn++); // prcx = rawClouds[y2+y][x2+cmcs8a], x2<CLOUD_SIZE
-				prcx-=CLOUD_SIZE;
-				for(int x2=std::max(CLOUD_SIZE,cmcs8a); x2<cs4a+cmcs8a; ++x2)
-					(*prcx++)+=blend*(*pkrn++); // prcx = rawClouds[y2+y][x2-cs8a], x2>=CLOUD_SIZE
-			}
-		}
-		for(int x=0, bx=0, **prc=rawClouds+cmcs8a; x<cmcs8a; x+=cs8a, ++bx) {
-			int blend=bm[31&31][bx&31], **prcy=prc, *pkernel=kernel;
-			for(int y2=cmcs8a; y2<cs4a+cmcs8a; ++y2, ++prcy, pkernel+=CLOUD_SIZE/4) {
-				int *prcx=(y2<CLOUD_SIZE) ? (*prcy)+x : (*(prcy-CLOUD_SIZE))+x, *pkrn=pkernel;
-				for(int x2=0; x2<cs4a; ++x2) // prcx = rawClouds[y2+cmcs8a][x2+x], y2<CLOUD_SIZE
-					(*prcx++)+=blend*(*pkrn++); // prcx =  rawClouds[y2-cs8a][x2+x], y2>=CLOUD_SIZE
-			}
-		}
-		break;
-	}
-	case CLOUD_DETAIL+1: {
-		for(int a=0;a<CLOUD_SIZE*CLOUD_SIZE;a++)
-			cloudThickness[a]=alphaTransform[rawClouds[0][a]>>7];
-
-		// this one is read in one place, so to avoid reading uninitialized mem ...
-		cloudThickness[CLOUD_SIZE*CLOUD_SIZE] = cloudThickness[CLOUD_SIZE*CLOUD_SIZE-1];
-
-		// create the cloud shading
-		for (int a = 0; a < CLOUD_SIZE; ++a) {
-			ydif[a] =
-				(int)cloudThickness[(a+3*CLOUD_SIZE)]
-				+    cloudThickness[(a+2*CLOUD_SIZE)]
-				+    cloudThickness[(a+1*CLOUD_SIZE)]
-				+    cloudThickness[(a+0*CLOUD_SIZE)]
-				-    cloudThickness[(a+CLOUD_SIZE*(CLOUD_SIZE-1))]
-				-    cloudThickness[(a+CLOUD_SIZE*(CLOUD_SIZE-2))]
-				-    cloudThickness[(a+CLOUD_SIZE*(CLOUD_SIZE-3))];
-		}
 
-		ydif[0] += cloudThickness[0+CLOUD_SIZE*(CLOUD_SIZE-3)] - cloudThickness[0]*2 + cloudThickness[0+4*CLOUD_SIZE];
-		break;
-	}
-	case CLOUD_DETAIL+2: {
-		UpdatePart(0, CLOUD_SIZE*3-1, CLOUD_SIZE*(CLOUD_SIZE-3), 4*CLOUD_SIZE);
-		break;
-	}
-	case CLOUD_DETAIL+3: {
-		UpdatePart(CLOUD_SIZE*3-1, CLOUD_SIZE*(CLOUD_SIZE-4)-1, -3*CLOUD_SIZE, 4*CLOUD_SIZE);
-		break;
-	}
-	case CLOUD_DETAIL+4: {
-		UpdatePart(CLOUD_SIZE*(CLOUD_SIZE-4)-1, CLOUD_SIZE*CLOUD_SIZE, -3*CLOUD_SIZE, CLOUD_SIZE*(4-CLOUD_SIZE));
-		break;
-	}
-	case CLOUD_DETAIL+5: {
-		const int modDensity = (int) ((1-cloudDensity)*256);
-		for (int a = 0; a < CLOUD_SIZE*CLOUD_SIZE; ++a) {
-			const int f = (rawClouds[0][a]>>8)-modDensity;
-			cloudTexMem[a*4+3]=std::max(0, std::min(255, f));
-		}
-		break;
-	}
-	case CLOUD_DETAIL+6: {
-		glBindTexture(GL_TEXTURE_2D, cloudDot3Tex);
-		glTexSubImage2D(GL_TEXTURE_2D,0, 0,0,CLOUD_SIZE, CLOUD_SIZE,GL_RGBA, GL_UNSIGNED_BYTE, cloudTexMem);
-		break;
-	}
+	UpdateCloudTexture();
+}
+
+void CAdvSky::UpdateCloudTexture()
+{
+	cloudsFBO.Bind(); //! render to cloudDot3Tex
+
+	glViewport(0,0,CLOUD_SIZE,CLOUD_SIZE);
+	glLoadIdentity();
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+	glOrtho(0,1,0,1,-1,1);
+	glMatrixMode(GL_MODELVIEW);
+	glDisable(GL_FOG);
+	glDisable(GL_LIGHTING);
+	glDisable(GL_BLEND);
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_TEXTURE_2D);
+
+	cloudsShader->Enable();
+	for (int a = 0; a < CLOUD_DETAIL; a++) {
+		cloudsShader->SetUniform1f(2 + a, octaveFades[a]);
 	}
+
+	glBindTexture(GL_TEXTURE_2D, randTex);
+
+	CVertexArray* va = GetVertexArray();
+	va->Initialize();
+	va->CheckInitSize(4*VA_SIZE_T);
+	va->AddVertexQT(ZeroVector, 0, 0);
+	va->AddVertexQT(RgtVector,  1, 0);
+	va->AddVertexQT(XYVector,   1, 1);
+	va->AddVertexQT(UpVector,   0, 1);
+	va->DrawArrayT(GL_QUADS);
+
+	cloudsShader->Disable();
+
+	glViewport(globalRendering->viewPosX,0,globalRendering->viewSizeX,globalRendering->viewSizeY);
+	cloudsFBO.Unbind();
+
+	glEnable(GL_DEPTH_TEST);
 }
 
 void CAdvSky::CreateRandMatrix(int** matrix, float /*mod*/)
@@ -527,18 +479,54 @@ void CAdvSky::CreateRandDetailMatrix(unsigned char* matrix, int size)
 
 void CAdvSky::CreateTransformVectors()
 {
+	// only the alpha table is still needed on the CPU, for the small
+	// cloud-cover samples around the sun; the shader evaluates the
+	// same function (and the thickness transform) analytically
 	unsigned char *at=alphaTransform;
-	unsigned char *tt=thicknessTransform;
 	for(int a=0;a<1024;++a){
 		float f=(1023.0f-(a+cloudDensity*1024-512))/1023.0f;
 		float alpha=std::pow(f*2,3);
 		if(alpha>1)
 			alpha=1;
-		*at=(int) (alpha*255);
+		*at++=(int) (alpha*255);
+	}
+}
+
+unsigned char CAdvSky::GetCloudThickness(int x, int y) const
+{
+	// CPU-side mirror of the cloud-gen shader's field evaluation; only
+	// used for the handful of texels CreateCover samples around the sun
+	float raw = 0.0f;
+
+	for (int a = 0; a < CLOUD_DETAIL; a++) {
+		const int cs8a = (CLOUD_SIZE/8) >> a;
+		const int qcda = (4<<CLOUD_DETAIL) >> a;
+		const float fade = octaveFades[a];
+
+		// grid point b of octave a sits at texel b*cs8a + (cs8a-1)
+		const float cx = (x - (cs8a - 1)) / float(cs8a);
+		const float cy = (y - (cs8a - 1)) / float(cs8a);
+
+		const int bx = (int)std::floor(cx);
+		const int by = (int)std::floor(cy);
+
+		float wx = cx - bx; wx = wx*wx*(3-2*wx);
+		float wy = cy - by; wy = wy*wy*(3-2*wy);
+
+		float v[2][2];
+		for (int j = 0; j < 2; j++) {
+			for (int i = 0; i < 2; i++) {
+				const int gx = (bx + i) & 31;
+				const int gy = (by + j) & 31;
+				v[j][i] = randMatrix[a+8][gy][gx] + (randMatrix[a][gy][gx] - randMatrix[a+8][gy][gx]) * fade;
+			}
+		}
 
-		const float d = std::min(1.0f, f * 2.0f);
-		*tt++=(unsigned char) (128+d*64+(*at++)*255/(4*255));
+		raw += mix(mix(v[0][0], v[0][1], wx), mix(v[1][0], v[1][1], wx), wy) * qcda;
 	}
+
+	const int idx = Clamp(((int)raw) >> 7, 0, 1023);
+	return alphaTransform[idx];
 }
 
 void CAdvSky::DrawSun()
@@ -726,15 +714,15 @@ void CAdvSky::CreateCover(int baseX, int baseY, float *buf) const
 		for(int x=0;x<num;++x){
 			int dx=*pline++;
 			int dy=*pline++;
-			int incy = ((baseY+dy) & CLOUD_MASK) * CLOUD_SIZE;
-			int decy = ((baseY-dy) & CLOUD_MASK) * CLOUD_SIZE;
+			int incy = (baseY+dy) & CLOUD_MASK;
+			int decy = (baseY-dy) & CLOUD_MASK;
 			int incx = (baseX+dx) & CLOUD_MASK;
 			int decx = (baseX-dx) & CLOUD_MASK;
 
-			cover1+=255-cloudThickness[incy+decx];//*(num-x);
-			cover2+=255-cloudThickness[decy+decx];//*(num-x);
-			cover3+=255-cloudThickness[decy+incx];//*(num-x);
-			cover4+=255-cloudThickness[incy+incx];//*(num-x);
+			cover1+=255-GetCloudThickness(decx,incy);//*(num-x);
+			cover2+=255-GetCloudThickness(decx,decy);//*(num-x);
+			cover3+=255-GetCloudThickness(incx,decy);//*(num-x);
+			cover4+=255-GetCloudThickness(incx,incy);//*(num-x);
 			total+=1;//(num-x);
 		}
 
@@ -7,6 +7,10 @@
 #include "Rendering/GL/FBO.h"
 #include "ISky.h"
 
+namespace Shader {
+	struct IProgramObject;
+}
+
 class CAdvSky : public ISky
 {
 public:
@@ -29,7 +33,10 @@ private:
 	void CreateRandMatrix(int** matrix, float mod);
 	void CreateRandDetailMatrix(unsigned char* matrix,int size);
 	void CreateClouds();
-	void UpdatePart(int ast, int aed, int a3cstart, int a4cstart);
+	void CreateCloudsShader();
+	void UpdateRandTexSlice(int slice, int** matrix);
+	void UpdateCloudTexture();
+	unsigned char GetCloudThickness(int x, int y) const;
 	void UpdateTexPartDot3(int x, int y, unsigned char (*texp)[4]);
 	void UpdateTexPart(int x, int y, unsigned char (*texp)[4]);
 	void UpdateSkyDir();
@@ -40,21 +47,22 @@ private:
 
 protected:
 	FBO fbo;
+	FBO cloudsFBO;
 
 	float3 skydir1; // right
 	float3 skydir2; // up
 
 	GLuint cdtex;
+	GLuint randTex;
 
 	unsigned int cloudFP;
+	Shader::IProgramObject* cloudsShader;
 
 	bool drawFlare;
 
 	GLuint detailTextures[12];
 	bool cloudDetailDown[5];
 
-	unsigned char* cloudTexMem;
-
 	unsigned int skyTex;
 	unsigned int skyDot3Tex;
 	unsigned int cloudDot3Tex;
@@ -76,21 +84,14 @@ protected:
 	float sunTexCoordY;
 
 	int*** randMatrix;
-	int** rawClouds;
-	int*** blendMatrix;
-
-	unsigned char* cloudThickness;
+	float octaveFades[8]; // CLOUD_DETAIL entries used
 
 	float covers[4][32];
 	int oldCoverBaseX;
 	int oldCoverBaseY;
 
 	unsigned char alphaTransform[1024];
-	unsigned char thicknessTransform[1024];
 	bool cloudDown[10];
-
-	int ydif[CLOUD_SIZE];
-	int updatecounter;
 };
 
 #endif // ADV_SKY_H
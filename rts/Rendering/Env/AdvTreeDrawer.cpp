@@ -70,6 +70,9 @@ CAdvTreeDrawer::~CAdvTreeDrawer()
 		if (tss.farDispList) {
 			glDeleteLists(tss.farDispList, 1);
 		}
+		if (tss.nearDispList) {
+			glDeleteLists(tss.nearDispList, 1);
+		}
 	}
 
 	shaderHandler->ReleaseProgramObjects("[TreeDrawer]");
@@ -228,6 +231,53 @@ static inline void SetArrayQ(CVertexArray* va, float t1, float t2, const float3&
 	va->AddVertexQT(v, t1, t2);
 }
 
+
+// near-square classification for one frame of the detailed pass; the
+// 5x5 block around the camera is LOD'ed per square (not per tree) so
+// each class can be drawn with a handful of batched calls
+struct NearTreeSquare {
+	ITreeDrawer::TreeSquareStruct* tss;
+	float camDist;
+};
+
+
+void CAdvTreeDrawer::BuildNearDispList(TreeSquareStruct* tss)
+{
+	// bake the full-detail geometry of every tree within this square
+	// into a single batched list; positions are baked into the vertices
+	// themselves so the treeOffset uniform stays zero for these
+	tss->nearDispList = glGenLists(1);
+
+	unsigned int numVerts = 0;
+
+	for (auto ti = tss->trees.cbegin(); ti != tss->trees.cend(); ++ti) {
+		numVerts += treeGen.nearTris[ti->type].size();
+	}
+
+	CVertexArray* va = GetVertexArray();
+	va->Initialize();
+	va->EnlargeArrays(numVerts, 0, VA_SIZE_TN); //!alloc room for all tree vertexes
+
+	for (auto ti = tss->trees.cbegin(); ti != tss->trees.cend(); ++ti) {
+		const ITreeDrawer::TreeStruct* ts = &(*ti);
+		const CFeature* f = featureHandler->GetFeature(ts->id);
+
+		if (f == NULL)
+			continue;
+		// note: will cause some trees to be invisible if list is not refreshed
+		if (!f->IsInLosForAllyTeam(gu->myAllyTeam))
+			continue;
+
+		for (const VA_TYPE_TN& v: treeGen.nearTris[ts->type]) {
+			va->AddVertexQTN(v.p + ts->pos, v.s, v.t, v.n);
+		}
+	}
+
+	glNewList(tss->nearDispList, GL_COMPILE);
+	va->DrawArrayTN(GL_TRIANGLES);
+	glEndList();
+}
+
 void CAdvTreeDrawer::DrawTreeVertexA(CVertexArray* va, float3& ftpos, float dx, float dy) {
 	SetArrayQ(va, TEX_LEAF_START_X1 + dx, TEX_LEAF_START_Y1 + dy, ftpos); ftpos.y += MAX_TREE_HEIGHT;
 	SetArrayQ(va, TEX_LEAF_START_X1 + dx, TEX_LEAF_END_Y1   + dy, ftpos); ftpos.x -= MAX_TREE_HEIGHT;
@@ -559,19 +609,69 @@ void CAdvTreeDrawer::Draw(float treeDistance)
 		glDisable(GL_BLEND);
 		glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
 
-		CVertexArray* va = GetVertexArray();
-		va->Initialize();
-
 
 		static std::vector<FadeTree> fadeTrees;
+		static std::vector<NearTreeSquare> nearSquares;
 
 		fadeTrees.clear();
 		fadeTrees.reserve(3000);
+		nearSquares.clear();
 
-		for (TreeSquareStruct* pTSS = &treeSquares[ystart * treesX]; pTSS <= &treeSquares[yend * treesX]; pTSS += treesX) {
-			for (TreeSquareStruct* tss = pTSS + xstart; tss <= (pTSS + xend); ++tss) {
+		// classify the block of squares around the camera per square;
+		// missing batched lists are built up-front since building them
+		// shares the pool of vertex-arrays with the far-tree pass below
+		const float sqWorldSize = SQUARE_SIZE * TREE_SQUARE_SIZE;
+		const float sqRadius = sqWorldSize * 0.71f + MAX_TREE_HEIGHT;
+
+		for (int y = ystart; y <= yend; y++) {
+			for (int x = xstart; x <= xend; x++) {
+				TreeSquareStruct* tss = &treeSquares[y * treesX + x];
 				tss->lastSeen = gs->frameNum;
-				va->EnlargeArrays(12 * tss->trees.size(), 0, VA_SIZE_T); //!alloc room for all tree vertexes
+
+				if (tss->trees.empty())
+					continue;
+
+				float3 sqPos;
+					sqPos.x = (x + 0.5f) * sqWorldSize;
+					sqPos.z = (y + 0.5f) * sqWorldSize;
+					sqPos.y = CGround::GetHeightReal(sqPos.x, sqPos.z, false);
+
+				if (!cam->InView(sqPos + (UpVector * (MAX_TREE_HEIGHT * 0.5f)), sqRadius))
+					continue;
+
+				const float camDist = sqPos.distance(cam->GetPos());
+
+				if ((camDist < (SQUARE_SIZE * 125.0f)) && (tss->nearDispList == 0))
+					BuildNearDispList(tss);
+
+				nearSquares.push_back({tss, camDist});
+			}
+		}
+
+		CVertexArray* va = GetVertexArray();
+		va->Initialize();
+
+		// world-offset is baked into the batched square lists
+		treeShader->SetUniform3f(((globalRendering->haveGLSL)? 2: 10), 0.0f, 0.0f, 0.0f);
+
+		for (const NearTreeSquare& nts: nearSquares) {
+			TreeSquareStruct* tss = nts.tss;
+
+			if (nts.camDist < (SQUARE_SIZE * 110.0f)) {
+				// draw detailed near-distance square (same as mid-distance squares without alpha)
+				glCallList(tss->nearDispList);
+				continue;
+			}
+
+			if (nts.camDist < (SQUARE_SIZE * 125.0f)) {
+				// draw mid-distance square; the detailed geometry fades
+				// out per square while its billboards (drawn in the far
+				// pass below) fade in per tree
+				const float sqRelDist = Clamp((nts.camDist - SQUARE_SIZE * 110.0f) / (SQUARE_SIZE * 15.0f), 0.0f, 1.0f);
+
+				glAlphaFunc(GL_GREATER, 0.8f + sqRelDist * 0.2f);
+				glCallList(tss->nearDispList);
+				glAlphaFunc(GL_GREATER, 0.5f);
 
 				for (auto ti = tss->trees.cbegin(); ti != tss->trees.cend(); ++ti) {
 					const TreeStruct* ts = &(*ti);
@@ -584,56 +684,43 @@ void CAdvTreeDrawer::Draw(float treeDistance)
 					if (!cam->InView(ts->pos + (UpVector * (MAX_TREE_HEIGHT / 2.0f)), MAX_TREE_HEIGHT / 2.0f))
 						continue;
 
-					const float camDist = (ts->pos - cam->GetPos()).SqLength();
-					int type = ts->type;
-					float dy = 0.0f;
-					unsigned int dispList;
-
-					if (type < 8) {
-						dy = 0.5f;
-						dispList = treeGen.pineDL + type;
-					} else {
-						type -= 8;
-						dy = 0.0f;
-						dispList = treeGen.leafDL + type;
-					}
-
-					if (camDist < (SQUARE_SIZE * SQUARE_SIZE * 110 * 110)) {
-						// draw detailed near-distance tree (same as mid-distance trees without alpha)
-						treeShader->SetUniform3f(((globalRendering->haveGLSL)? 2: 10), ts->pos.x, ts->pos.y, ts->pos.z);
-						glCallList(dispList);
-					} else if (camDist < (SQUARE_SIZE * SQUARE_SIZE * 125 * 125)) {
-						// draw mid-distance tree
-						const float relDist = (ts->pos.distance(cam->GetPos()) - SQUARE_SIZE * 110) / (SQUARE_SIZE * 15);
-
-						treeShader->SetUniform3f(((globalRendering->haveGLSL)? 2: 10), ts->pos.x, ts->pos.y, ts->pos.z);
-
-						glAlphaFunc(GL_GREATER, 0.8f + relDist * 0.2f);
-						glCallList(dispList);
-						glAlphaFunc(GL_GREATER, 0.5f);
-
-						// save for second pass
-						fadeTrees.emplace_back();
-						FadeTree& ft = fadeTrees.back();
-
-						ft.id = f->id;
-						ft.type = type;
-
-						ft.pos = ts->pos;
-
-						ft.relDist = relDist;
-						ft.deltaY = dy;
-					} else {
-						// draw far-distance tree
-						CAdvTreeDrawer::DrawTreeVertex(va, ts->pos, type * 0.125f, dy, false);
-					}
+					// save for second pass
+					fadeTrees.emplace_back();
+					FadeTree& ft = fadeTrees.back();
+
+					ft.id = f->id;
+					ft.type = (ts->type < 8)? ts->type: (ts->type - 8);
+
+					ft.pos = ts->pos;
+
+					ft.relDist = Clamp((ts->pos.distance(cam->GetPos()) - SQUARE_SIZE * 110) / (SQUARE_SIZE * 15), 0.0f, 1.0f);
+					ft.deltaY = (ts->type < 8)? 0.5f: 0.0f;
 				}
+
+				continue;
 			}
-		}
 
+			// draw far-distance square
+			va->EnlargeArrays(12 * tss->trees.size(), 0, VA_SIZE_T); //!alloc room for all tree vertexes
 
-		// reset the world-offset
-		treeShader->SetUniform3f(((globalRendering->haveGLSL)? 2: 10), 0.0f, 0.0f, 0.0f);
+			for (auto ti = tss->trees.cbegin(); ti != tss->trees.cend(); ++ti) {
+				const TreeStruct* ts = &(*ti);
+				const CFeature* f = featureHandler->GetFeature(ts->id);
+
+				if (f == NULL)
+					continue;
+				if (!f->IsInLosForAllyTeam(gu->myAllyTeam))
+					continue;
+				if (!cam->InView(ts->pos + (UpVector * (MAX_TREE_HEIGHT / 2.0f)), MAX_TREE_HEIGHT / 2.0f))
+					continue;
+
+				if (ts->type < 8) {
+					CAdvTreeDrawer::DrawTreeVertex(va, ts->pos, (ts->type    ) * 0.125f, 0.5f, false);
+				} else {
+					CAdvTreeDrawer::DrawTreeVertex(va, ts->pos, (ts->type - 8) * 0.125f, 0.0f, false);
+				}
+			}
+		}
 
 		// draw trees that have been marked as falling
 		for (auto fti = fallingTrees.cbegin(); fti != fallingTrees.cend(); ++fti) {
@@ -742,6 +829,10 @@ void CAdvTreeDrawer::Draw(float treeDistance)
 				glDeleteLists(pTSS->dispList, 1);
 				pTSS->dispList = 0;
 			}
+			if ((pTSS->lastSeen < frameNum - 50) && pTSS->nearDispList) {
+				glDeleteLists(pTSS->nearDispList, 1);
+				pTSS->nearDispList = 0;
+			}
 			if ((pTSS->lastSeenFar < (frameNum - 50)) && pTSS->farDispList) {
 				glDeleteLists(pTSS->farDispList, 1);
 				pTSS->farDispList = 0;
@@ -754,6 +845,10 @@ void CAdvTreeDrawer::Draw(float treeDistance)
 				glDeleteLists(pTSS->dispList, 1);
 				pTSS->dispList = 0;
 			}
+			if ((pTSS->lastSeen < (frameNum - 50)) && pTSS->nearDispList) {
+				glDeleteLists(pTSS->nearDispList, 1);
+				pTSS->nearDispList = 0;
+			}
 			if ((pTSS->lastSeenFar < (frameNum - 50)) && pTSS->farDispList) {
 				glDeleteLists(pTSS->farDispList, 1);
 				pTSS->farDispList = 0;
@@ -767,6 +862,10 @@ void CAdvTreeDrawer::Draw(float treeDistance)
 				glDeleteLists(pTSS->dispList, 1);
 				pTSS->dispList = 0;
 			}
+			if ((pTSS->lastSeen < (frameNum - 50)) && pTSS->nearDispList) {
+				glDeleteLists(pTSS->nearDispList, 1);
+				pTSS->nearDispList = 0;
+			}
 			if ((pTSS->lastSeenFar < (frameNum - 50)) && pTSS->farDispList) {
 				glDeleteLists(pTSS->farDispList, 1);
 				pTSS->farDispList = 0;
@@ -962,19 +1061,63 @@ void CAdvTreeDrawer::DrawShadowPass()
 		glEnable(GL_ALPHA_TEST);
 		glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
 
-		CVertexArray* va = GetVertexArray();
-		va->Initialize();
-
 
 		static std::vector<FadeTree> fadeTrees;
+		static std::vector<NearTreeSquare> nearSquares;
 
 		fadeTrees.clear();
 		fadeTrees.reserve(3000);
+		nearSquares.clear();
+
+		// classify per square, as in the normal pass
+		const float sqWorldSize = SQUARE_SIZE * TREE_SQUARE_SIZE;
+		const float sqRadius = sqWorldSize * 0.71f + MAX_TREE_HEIGHT;
 
-		for (TreeSquareStruct* pTSS = &treeSquares[ystart * treesX]; pTSS <= &treeSquares[yend * treesX]; pTSS += treesX) {
-			for (TreeSquareStruct* tss = pTSS + xstart; tss <= pTSS + xend; ++tss) {
+		for (int y = ystart; y <= yend; y++) {
+			for (int x = xstart; x <= xend; x++) {
+				TreeSquareStruct* tss = &treeSquares[y * treesX + x];
 				tss->lastSeen = gs->frameNum;
-				va->EnlargeArrays(12 * tss->trees.size(), 0, VA_SIZE_T); //!alloc room for all tree vertexes
+
+				if (tss->trees.empty())
+					continue;
+
+				float3 sqPos;
+					sqPos.x = (x + 0.5f) * sqWorldSize;
+					sqPos.z = (y + 0.5f) * sqWorldSize;
+					sqPos.y = CGround::GetHeightReal(sqPos.x, sqPos.z, false);
+
+				if (!cam->InView(sqPos + (UpVector * (MAX_TREE_HEIGHT * 0.5f)), sqRadius + 150.0f))
+					continue;
+
+				const float camDist = sqPos.distance(cam->GetPos());
+
+				if ((camDist < (SQUARE_SIZE * 125.0f)) && (tss->nearDispList == 0))
+					BuildNearDispList(tss);
+
+				nearSquares.push_back({tss, camDist});
+			}
+		}
+
+		CVertexArray* va = GetVertexArray();
+		va->Initialize();
+
+		// world-offset is baked into the batched square lists
+		po->SetUniform3f((globalRendering->haveGLSL? 3: 10), 0.0f, 0.0f, 0.0f);
+
+		for (const NearTreeSquare& nts: nearSquares) {
+			TreeSquareStruct* tss = nts.tss;
+
+			if (nts.camDist < (SQUARE_SIZE * 110.0f)) {
+				glCallList(tss->nearDispList);
+				continue;
+			}
+
+			if (nts.camDist < (SQUARE_SIZE * 125.0f)) {
+				const float sqRelDist = Clamp((nts.camDist - SQUARE_SIZE * 110.0f) / (SQUARE_SIZE * 15.0f), 0.0f, 1.0f);
+
+				glAlphaFunc(GL_GREATER, 0.8f + sqRelDist * 0.2f);
+				glCallList(tss->nearDispList);
+				glAlphaFunc(GL_GREATER, 0.5f);
 
 				for (auto ti = tss->trees.cbegin(); ti != tss->trees.cend(); ++ti) {
 					const TreeStruct* ts = &(*ti);
@@ -987,51 +1130,42 @@ void CAdvTreeDrawer::DrawShadowPass()
 					if (!cam->InView(ts->pos + float3(0, MAX_TREE_HEIGHT / 2, 0), MAX_TREE_HEIGHT / 2 + 150))
 						continue;
 
-					const float camDist = (ts->pos - cam->GetPos()).SqLength();
-					int type = ts->type;
-					float dy = 0.0f;
-					unsigned int dispList;
-
-					if (type < 8) {
-						dy = 0.5f;
-						dispList = treeGen.pineDL + type;
-					} else {
-						type -= 8;
-						dy = 0;
-						dispList = treeGen.leafDL + type;
-					}
-
-					if (camDist < SQUARE_SIZE * SQUARE_SIZE * 110 * 110) {
-						po->SetUniform3f((globalRendering->haveGLSL? 3: 10), ts->pos.x, ts->pos.y, ts->pos.z);
-						glCallList(dispList);
-					} else if (camDist < SQUARE_SIZE * SQUARE_SIZE * 125 * 125) {
-						const float relDist = (ts->pos.distance(cam->GetPos()) - SQUARE_SIZE * 110) / (SQUARE_SIZE * 15);
-
-						glAlphaFunc(GL_GREATER, 0.8f + relDist * 0.2f);
-						po->SetUniform3f((globalRendering->haveGLSL? 3: 10), ts->pos.x, ts->pos.y, ts->pos.z);
-						glCallList(dispList);
-						glAlphaFunc(GL_GREATER, 0.5f);
-
-						// save for second pass
-						fadeTrees.emplace_back();
-						FadeTree& ft = fadeTrees.back();
-
-						ft.id = f->id;
-						ft.type = type;
-
-						ft.pos = ts->pos;
-
-						ft.relDist = relDist;
-						ft.deltaY = dy;
-					} else {
-						CAdvTreeDrawer::DrawTreeVertex(va, ts->pos, type * 0.125f, dy, false);
-					}
+					// save for second pass
+					fadeTrees.emplace_back();
+					FadeTree& ft = fadeTrees.back();
+
+					ft.id = f->id;
+					ft.type = (ts->type < 8)? ts->type: (ts->type - 8);
+
+					ft.pos = ts->pos;
+
+					ft.relDist = Clamp((ts->pos.distance(cam->GetPos()) - SQUARE_SIZE * 110) / (SQUARE_SIZE * 15), 0.0f, 1.0f);
+					ft.deltaY = (ts->type < 8)? 0.5f: 0.0f;
 				}
+
+				continue;
 			}
-		}
 
+			va->EnlargeArrays(12 * tss->trees.size(), 0, VA_SIZE_T); //!alloc room for all tree vertexes
 
-		po->SetUniform3f((globalRendering->haveGLSL? 3: 10), 0.0f, 0.0f, 0.0f);
+			for (auto ti = tss->trees.cbegin(); ti != tss->trees.cend(); ++ti) {
+				const TreeStruct* ts = &(*ti);
+				const CFeature* f = featureHandler->GetFeature(ts->id);
+
+				if (f == NULL)
+					continue;
+				if (!f->IsInLosForAllyTeam(gu->myAllyTeam))
+					continue;
+				if (!cam->InView(ts->pos + float3(0, MAX_TREE_HEIGHT / 2, 0), MAX_TREE_HEIGHT / 2 + 150))
+					continue;
+
+				if (ts->type < 8) {
+					CAdvTreeDrawer::DrawTreeVertex(va, ts->pos, (ts->type    ) * 0.125f, 0.5f, false);
+				} else {
+					CAdvTreeDrawer::DrawTreeVertex(va, ts->pos, (ts->type - 8) * 0.125f, 0.0f, false);
+				}
+			}
+		}
 
 		for (auto fti = fallingTrees.cbegin(); fti != fallingTrees.cend(); ++fti) {
 			// const CFeature* f = featureHandler->GetFeature(fti->id);
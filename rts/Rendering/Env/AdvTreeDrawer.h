@@ -19,6 +19,7 @@ public:
 	~CAdvTreeDrawer();
 
 	void LoadTreeShaders();
+	void BuildNearDispList(TreeSquareStruct* tss);
 	void Draw(float treeDistance);
 	void Update();
 	void AddFallingTree(int treeID, int treeType, const float3& pos, const float3& dir);
@@ -123,6 +123,9 @@ void CAdvTreeGenerator::Init()
 			va->DrawArrayTN(GL_QUADS);
 			barkva->DrawArrayTN(GL_TRIANGLE_STRIP);
 		glEndList();
+
+		AppendNearTris(va, GL_QUADS, nearTris[8 + a]);
+		AppendNearTris(barkva, GL_TRIANGLE_STRIP, nearTris[8 + a]);
 	}
 
 	pineDL = glGenLists(8);
@@ -136,6 +139,59 @@ void CAdvTreeGenerator::Init()
 			PineTree((int)(20 + 10 * guRNG.NextFloat()), MAX_TREE_HEIGHT * size);
 			va->DrawArrayTN(GL_TRIANGLES);
 		glEndList();
+
+		AppendNearTris(va, GL_TRIANGLES, nearTris[a]);
+	}
+}
+
+
+void CAdvTreeGenerator::AppendNearTris(const CVertexArray* tva, GLenum mode, std::vector<VA_TYPE_TN>& tris)
+{
+	// de-stripify the generated geometry so all of it can later be
+	// concatenated into a single GL_TRIANGLES array per tree-square
+	const VA_TYPE_TN* verts = reinterpret_cast<const VA_TYPE_TN*>(tva->GetDrawArray());
+
+	unsigned int begIdx = 0;
+
+	for (unsigned int s = 0; s < tva->GetNumStrips(); s++) {
+		const unsigned int endIdx = tva->GetStripArray()[s] / sizeof(VA_TYPE_TN);
+
+		switch (mode) {
+			case GL_TRIANGLES: {
+				for (unsigned int i = begIdx; (i + 3) <= endIdx; i += 3) {
+					tris.push_back(verts[i    ]);
+					tris.push_back(verts[i + 1]);
+					tris.push_back(verts[i + 2]);
+				}
+			} break;
+			case GL_QUADS: {
+				for (unsigned int i = begIdx; (i + 4) <= endIdx; i += 4) {
+					tris.push_back(verts[i    ]);
+					tris.push_back(verts[i + 1]);
+					tris.push_back(verts[i + 2]);
+					tris.push_back(verts[i    ]);
+					tris.push_back(verts[i + 2]);
+					tris.push_back(verts[i + 3]);
+				}
+			} break;
+			case GL_TRIANGLE_STRIP: {
+				for (unsigned int i = begIdx + 2; i < endIdx; i++) {
+					// keep the winding consistent for odd triangles
+					if (((i - begIdx) & 1) == 0) {
+						tris.push_back(verts[i - 2]);
+						tris.push_back(verts[i - 1]);
+					} else {
+						tris.push_back(verts[i - 1]);
+						tris.push_back(verts[i - 2]);
+					}
+					tris.push_back(verts[i]);
+				}
+			} break;
+			default: {
+			} break;
+		}
+
+		begIdx = endIdx;
 	}
 }
 
@@ -3,13 +3,14 @@
 #ifndef _ADV_TREE_GENERATOR_H
 #define _ADV_TREE_GENERATOR_H
 
+#include <vector>
+
 #include "Rendering/GL/myGL.h"
+#include "Rendering/GL/VertexArray.h"
 
 // XXX This has a duplicate in BasicTreeDrawer.h
 #define MAX_TREE_HEIGHT 60
 
-class CVertexArray;
-
 namespace Shader {
 	struct IProgramObject;
 }
@@ -27,6 +28,11 @@ public:
 	unsigned int leafDL;
 	unsigned int pineDL;
 
+	// full-detail geometry per tree type as origin-centered triangle
+	// soup ([0, 7] := pine, [8, 15] := leaf), used by CAdvTreeDrawer
+	// to bake batched per-square display lists
+	std::vector<VA_TYPE_TN> nearTris[16];
+
 	CVertexArray* va;
 	CVertexArray* barkva;
 
@@ -35,6 +41,7 @@ public:
 	void CreateFarView(unsigned char* mem, int dx, int dy, unsigned int displist);
 
 private:
+	void AppendNearTris(const CVertexArray* tva, GLenum mode, std::vector<VA_TYPE_TN>& tris);
 	void CreateLeaves(const float3& start, const float3& dir, float length, float3& orto1, float3& orto2);
 	void TrunkIterator(const float3& start, const float3& dir, float length, float size, int depth);
 	void DrawTrunk(const float3& start, const float3& end, const float3& orto1, const float3& orto2, float size);
@@ -309,28 +309,33 @@ void CAdvWater::UpdateWater(CGame* game)
 	}
 
 
-	reflectFBO.Bind();
-	glClearColor(sky->fogColor[0], sky->fogColor[1], sky->fogColor[2], 1.0f);
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	if (ShouldUpdateReflections()) {
+		reflectFBO.Bind();
+		glClearColor(sky->fogColor[0], sky->fogColor[1], sky->fogColor[2], 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	const double clipPlaneEqs[2 * 4] = {
-		0.0, 1.0, 0.0, 0.0,
-		0.0, 1.0, 0.0, 0.0,
-	};
+		const double clipPlaneEqs[2 * 4] = {
+			0.0, 1.0, 0.0, 0.0,
+			0.0, 1.0, 0.0, 0.0,
+		};
 
-	CCamera* prvCam = CCamera::GetSetActiveCamera(CCamera::CAMTYPE_UWREFL);
-	CCamera* curCam = CCamera::GetActiveCamera();
+		CCamera* prvCam = CCamera::GetSetActiveCamera(CCamera::CAMTYPE_UWREFL);
+		CCamera* curCam = CCamera::GetActiveCamera();
 
-	{
-		curCam->CopyStateReflect(prvCam);
-		curCam->UpdateLoadViewPort(0, 0, 512, 512);
+		{
+			curCam->CopyStateReflect(prvCam);
+			curCam->UpdateLoadViewPort(0, 0, 512, 512);
 
-		DrawReflections(&clipPlaneEqs[0], true, true);
-	}
+			DrawReflections(&clipPlaneEqs[0], true, true);
+		}
 
-	CCamera::SetActiveCamera(prvCam->GetCamType());
-	prvCam->Update();
-	prvCam->LoadViewPort();
+		CCamera::SetActiveCamera(prvCam->GetCamType());
+		prvCam->Update();
+		prvCam->LoadViewPort();
+	} else {
+		// restore the main viewport changed by the bump pass above
+		camera->LoadViewPort();
+	}
 
 	FBO::Unbind();
 
@@ -713,6 +713,9 @@ void CBumpWater::UpdateWater(CGame* game)
 	}
 #endif
 
+	if (!ShouldUpdateReflections())
+		return;
+
 	glPushAttrib(GL_FOG_BIT);
 	if (refraction > 1) DrawRefraction(game);
 	if (reflection > 0) DrawReflection(game);
@@ -2,6 +2,7 @@
 
 #include "Game/Camera.h"
 #include "Game/Game.h"
+#include "Game/GlobalUnsynced.h"
 #include "Map/BaseGroundDrawer.h"
 #include "Map/Ground.h"
 #include "Map/ReadMap.h"
@@ -14,27 +15,47 @@
 #include "Rendering/Env/CubeMapHandler.h"
 #include "System/Config/ConfigHandler.h"
 
+#include <cstring>
+
 CONFIG(int, CubeTexSizeSpecular).defaultValue(128).minimumValue(1);
 CONFIG(int, CubeTexSizeReflection).defaultValue(128).minimumValue(1);
+CONFIG(bool, CubeTexScaleReflections).defaultValue(true).description("If the reflection cubemap resolution should be halved while the smoothed draw-frame time indicates render overload, and restored when it recovers.");
 
 CubeMapHandler* cubeMapHandler = NULL;
 
+static const float3 reflFaceDirs[6] = {
+	 RgtVector, -RgtVector,
+	  UpVector,  -UpVector,
+	 FwdVector, -FwdVector,
+};
+static const unsigned int reflFaceTypes[6] = {
+	GL_TEXTURE_CUBE_MAP_POSITIVE_X_ARB, GL_TEXTURE_CUBE_MAP_NEGATIVE_X_ARB,
+	GL_TEXTURE_CUBE_MAP_POSITIVE_Y_ARB, GL_TEXTURE_CUBE_MAP_NEGATIVE_Y_ARB,
+	GL_TEXTURE_CUBE_MAP_POSITIVE_Z_ARB, GL_TEXTURE_CUBE_MAP_NEGATIVE_Z_ARB,
+};
+
 CubeMapHandler::CubeMapHandler() {
 	envReflectionTexID = 0;
 	skyReflectionTexID = 0;
 	specularTexID = 0;
 
 	reflTexSize = 0;
+	baseReflTexSize = 0;
 	specTexSize = 0;
 
 	currReflectionFace = 0;
 	specularTexIter = 0;
+	reflTexRescaleFrame = 0;
+	memset(faceUpdateFrames, 0, sizeof(faceUpdateFrames));
 	mapSkyReflections = false;
+	scaleReflTexSize = false;
 }
 
 bool CubeMapHandler::Init() {
 	specTexSize = configHandler->GetInt("CubeTexSizeSpecular");
 	reflTexSize = configHandler->GetInt("CubeTexSizeReflection");
+	baseReflTexSize = reflTexSize;
+	scaleReflTexSize = configHandler->GetBool("CubeTexScaleReflections");
 	specTexBuf.resize(specTexSize * 4, 0);
 
 	mapSkyReflections = !(mapInfo->smf.skyReflectModTexName.empty());
@@ -119,41 +140,101 @@ void CubeMapHandler::Free() {
 
 
 
+unsigned int CubeMapHandler::GetNextReflectionFace(bool skyOnly) const
+{
+	if (skyOnly) {
+		// sky-only faces are cheap, plain round-robin suffices
+		return (currReflectionFace % 6);
+	}
+
+	// pick the stalest env face, biased toward the one most aligned
+	// with the main camera so what the player actually sees reflected
+	// refreshes first (the bias is worth a few frames of staleness,
+	// back-facing faces still cycle through eventually)
+	const float3& camDir = camera->GetDir();
+
+	unsigned int bestFace = 0;
+	float bestScore = -1e9f;
+
+	for (unsigned int face = 0; face < 6; face++) {
+		const float staleness = (globalRendering->drawFrame - faceUpdateFrames[face]) * 1.0f;
+		const float score = staleness + camDir.dot(reflFaceDirs[face]) * 4.0f;
+
+		if (score > bestScore) {
+			bestScore = score;
+			bestFace = face;
+		}
+	}
+
+	return bestFace;
+}
+
+void CubeMapHandler::UpdateReflectionTexSize()
+{
+	if (!scaleReflTexSize)
+		return;
+	// rescale at most once every 120 draw-frames; halve the cubemap
+	// while the smoothed frame time says we are render-bound, double
+	// it back toward the configured size once load has recovered
+	if ((globalRendering->drawFrame - reflTexRescaleFrame) < 120)
+		return;
+
+	unsigned int wantedSize = reflTexSize;
+
+	if (gu->avgFrameTime > 40.0f)
+		wantedSize = std::max(baseReflTexSize / 4, reflTexSize >> 1);
+	else if (gu->avgFrameTime < 25.0f)
+		wantedSize = std::min(baseReflTexSize, reflTexSize << 1);
+
+	if (wantedSize == reflTexSize)
+		return;
+
+	reflTexSize = wantedSize;
+	reflTexRescaleFrame = globalRendering->drawFrame;
+
+	for (unsigned int face = 0; face < 6; face++) {
+		glBindTexture(GL_TEXTURE_CUBE_MAP_ARB, envReflectionTexID);
+		glTexImage2D(reflFaceTypes[face], 0, GL_RGBA8, reflTexSize, reflTexSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+
+		if (mapSkyReflections) {
+			glBindTexture(GL_TEXTURE_CUBE_MAP_ARB, skyReflectionTexID);
+			glTexImage2D(reflFaceTypes[face], 0, GL_RGBA8, reflTexSize, reflTexSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+		}
+	}
+
+	reflectionCubeFBO.Bind();
+	reflectionCubeFBO.Detach(GL_DEPTH_ATTACHMENT_EXT);
+	reflectionCubeFBO.CreateRenderBuffer(GL_DEPTH_ATTACHMENT_EXT, GL_DEPTH_COMPONENT, reflTexSize, reflTexSize);
+	reflectionCubeFBO.Unbind();
+}
+
 void CubeMapHandler::UpdateReflectionTexture()
 {
 	if (!unitDrawer->UseAdvShading())
 		return;
 
+	UpdateReflectionTexSize();
+
 	// NOTE:
 	//   we unbind later in WorldDrawer::GenerateIBLTextures() to save render
 	//   context switches (which are one of the slowest OpenGL operations!)
 	//   together with VP restoration
 	reflectionCubeFBO.Bind();
 
-	switch (currReflectionFace) {
-		case 0: { CreateReflectionFace(GL_TEXTURE_CUBE_MAP_POSITIVE_X_ARB,  RgtVector, false); } break;
-		case 1: { CreateReflectionFace(GL_TEXTURE_CUBE_MAP_NEGATIVE_X_ARB, -RgtVector, false); } break;
-		case 2: { CreateReflectionFace(GL_TEXTURE_CUBE_MAP_POSITIVE_Y_ARB,  UpVector,  false); } break;
-		case 3: { CreateReflectionFace(GL_TEXTURE_CUBE_MAP_NEGATIVE_Y_ARB, -UpVector,  false); } break;
-		case 4: { CreateReflectionFace(GL_TEXTURE_CUBE_MAP_POSITIVE_Z_ARB,  FwdVector, false); } break;
-		case 5: { CreateReflectionFace(GL_TEXTURE_CUBE_MAP_NEGATIVE_Z_ARB, -FwdVector, false); } break;
-		default: {} break;
-	}
+	// the face passes draw only sky and terrain; with sky reflections
+	// enabled (SSMF), env and sky-only faces refresh on alternate frames
+	// (at most one scene pass per frame either way)
+	const bool skyOnly = (mapSkyReflections && (currReflectionFace & 1));
+	const unsigned int face = GetNextReflectionFace(skyOnly);
+
+	CreateReflectionFace(reflFaceTypes[face], reflFaceDirs[face], skyOnly);
+
+	if (!skyOnly)
+		faceUpdateFrames[face] = globalRendering->drawFrame;
 
 	if (mapSkyReflections) {
-		// draw only the sky (into its own cubemap) for SSMF
 		// by reusing data from previous frame we could also
 		// make terrain reflect itself, not just the sky
-		switch (currReflectionFace) {
-			case  6: { CreateReflectionFace(GL_TEXTURE_CUBE_MAP_POSITIVE_X_ARB,  RgtVector, true); } break;
-			case  7: { CreateReflectionFace(GL_TEXTURE_CUBE_MAP_NEGATIVE_X_ARB, -RgtVector, true); } break;
-			case  8: { CreateReflectionFace(GL_TEXTURE_CUBE_MAP_POSITIVE_Y_ARB,  UpVector,  true); } break;
-			case  9: { CreateReflectionFace(GL_TEXTURE_CUBE_MAP_NEGATIVE_Y_ARB, -UpVector,  true); } break;
-			case 10: { CreateReflectionFace(GL_TEXTURE_CUBE_MAP_POSITIVE_Z_ARB,  FwdVector, true); } break;
-			case 11: { CreateReflectionFace(GL_TEXTURE_CUBE_MAP_NEGATIVE_Z_ARB, -FwdVector, true); } break;
-			default: {} break;
-		}
-
 		currReflectionFace +=  1;
 		currReflectionFace %= 12;
 	} else {
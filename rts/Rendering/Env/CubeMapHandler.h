@@ -22,6 +22,8 @@ public:
 	unsigned int GetSpecularTextureSize() const { return specTexSize; }
 
 private:
+	unsigned int GetNextReflectionFace(bool skyOnly) const;
+	void UpdateReflectionTexSize();
 	void CreateReflectionFace(unsigned int, const float3&, bool);
 	inline void CreateSpecularFacePart(unsigned int, unsigned int, const float3&, const float3&, const float3&, unsigned int, unsigned char*);
 	void CreateSpecularFace(unsigned int, unsigned int, const float3&, const float3&, const float3&);
@@ -32,11 +34,15 @@ private:
 	unsigned int specularTexID;
 
 	unsigned int reflTexSize;
+	unsigned int baseReflTexSize;
 	unsigned int specTexSize;
 
 	unsigned int currReflectionFace;
 	unsigned int specularTexIter;
+	unsigned int reflTexRescaleFrame;
+	unsigned int faceUpdateFrames[6]; // drawFrame of each env face's last refresh
 	bool mapSkyReflections;
+	bool scaleReflTexSize;
 
 	std::vector<unsigned char> specTexBuf;
 
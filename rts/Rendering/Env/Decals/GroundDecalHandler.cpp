@@ -198,10 +198,38 @@ void CGroundDecalHandler::SunChanged() {
 	}
 }
 
-static inline void AddQuadVertices(CVertexArray* va, int x, float* yv, int z, const float* uv, unsigned char* color)
+void CGroundDecalHandler::UnsyncedHeightMapUpdate(const SRectangle& rect) {
+	// decal vertices bake in terrain heights, only refresh the
+	// ones whose footprint overlaps the updated region
+	for (SolidObjectDecalType& decalType: objectDecalTypes) {
+		for (SolidObjectGroundDecal* decal: decalType.objectDecals) {
+			if (decal->posx > rect.x2 || (decal->posx + decal->xsize) < rect.x1)
+				continue;
+			if (decal->posy > rect.z2 || (decal->posy + decal->ysize) < rect.z1)
+				continue;
+
+			decal->heightsDirty = true;
+		}
+	}
+
+	// scar extents are in half-resolution heightmap coords
+	for (const int id: usedScarIDs) {
+		Scar& scar = scars[id];
+
+		if ((scar.x1 * 2) > rect.x2 || (scar.x2 * 2) < rect.x1)
+			continue;
+		if ((scar.y1 * 2) > rect.z2 || (scar.y2 * 2) < rect.z1)
+			continue;
+
+		// force a re-bake on the next draw
+		scar.lastDraw = -1;
+	}
+}
+
+static inline void AddQuadVertices(CVertexArray* va, int x, float* yv, int z, const float* uv, unsigned char* color, const float3& offset)
 {
 	#define HEIGHT2WORLD(x) ((x) << 3)
-	#define VERTEX(x, y, z) float3(HEIGHT2WORLD((x)), (y), HEIGHT2WORLD((z)))
+	#define VERTEX(x, y, z) float3(HEIGHT2WORLD((x)) + offset.x, (y), HEIGHT2WORLD((z)) + offset.z)
 	va->AddVertexTC( VERTEX(x    , yv[0], z    ),   uv[0], uv[1],   color);
 	va->AddVertexTC( VERTEX(x + 1, yv[1], z    ),   uv[2], uv[3],   color);
 	va->AddVertexTC( VERTEX(x + 1, yv[2], z + 1),   uv[4], uv[5],   color);
@@ -211,7 +239,7 @@ static inline void AddQuadVertices(CVertexArray* va, int x, float* yv, int z, co
 }
 
 
-inline void CGroundDecalHandler::DrawObjectDecal(SolidObjectGroundDecal* decal)
+inline void CGroundDecalHandler::DrawObjectDecal(SolidObjectGroundDecal* decal, CVertexArray* batchVA)
 {
 	const float* hm = readMap->GetCornerHeightMapUnsynced();
 
@@ -233,6 +261,13 @@ inline void CGroundDecalHandler::DrawObjectDecal(SolidObjectGroundDecal* decal)
 		// NOTE: this really needs CLOD'ing
 		va.Initialize();
 
+		// pos{x,y} are multiples of SQUARE_SIZE, but pos might not be;
+		// bake the sub-square shift into the vertices so the decal is
+		// aligned with the object on top of it (the shift stays below
+		// SQUARE_SIZE, so the height-index reconstruction below is not
+		// affected by it)
+		const float3 offset(int(decal->pos.x) % SQUARE_SIZE, 0.0f, int(decal->pos.z) % SQUARE_SIZE);
+
 		const int
 			dxsize = decal->xsize,
 			dzsize = decal->ysize,
@@ -292,10 +327,13 @@ inline void CGroundDecalHandler::DrawObjectDecal(SolidObjectGroundDecal* decal)
 					} break;
 				}
 
-				AddQuadVertices(&va, px, yv, pz, uv, color);
+				AddQuadVertices(&va, px, yv, pz, uv, color, offset);
 			}
 		}
-	} else {
+
+		decal->heightsDirty = false;
+		decal->vaColor = color;
+	} else if (decal->heightsDirty || decal->vaColor.i != color.i) {
 		const int numVerts = va.drawIndex() / VA_SIZE_TC;
 
 		va.ResetPos();
@@ -310,20 +348,21 @@ inline void CGroundDecalHandler::DrawObjectDecal(SolidObjectGroundDecal* decal)
 			mem[i].c   = color;
 		}
 
-		// pos{x,y} are multiples of SQUARE_SIZE, but pos might not be
-		// shift the decal visually in the latter case so it is aligned
-		// with the object on top of it
-		glPushMatrix();
-		glTranslatef(int(decal->pos.x) % SQUARE_SIZE, 0.0f, int(decal->pos.z) % SQUARE_SIZE);
-		va.DrawArrayTC(GL_QUADS);
-		glPopMatrix();
+		decal->heightsDirty = false;
+		decal->vaColor = color;
 	}
 
+	// append the baked quads to the per-type batch
+	const int numVerts = va.drawIndex() / VA_SIZE_TC;
+
+	VA_TYPE_TC* mem = batchVA->GetTypedVertexArray<VA_TYPE_TC>(numVerts);
+	memcpy(mem, va.GetDrawArray(), numVerts * sizeof(VA_TYPE_TC));
+
 	#undef HEIGHT
 }
 
 
-inline void CGroundDecalHandler::DrawGroundScar(CGroundDecalHandler::Scar& scar)
+inline void CGroundDecalHandler::DrawGroundScar(CGroundDecalHandler::Scar& scar, CVertexArray* batchVA)
 {
 	// TODO: do we want LOS-checks for decals?
 	if (!camera->InView(scar.pos, scar.radius + TEX_QUAD_SIZE))
@@ -332,6 +371,14 @@ inline void CGroundDecalHandler::DrawGroundScar(CGroundDecalHandler::Scar& scar)
 	SColor color(255, 255, 255, 255);
 	CVertexArray& va = scar.va;
 
+	if (groundScarAlphaFade) {
+		if ((scar.creationTime + 10) > gs->frameNum) {
+			color[3] = (int) (scar.startAlpha * (gs->frameNum - scar.creationTime) * 0.1f);
+		} else {
+			color[3] = (int) (scar.startAlpha - (gs->frameNum - scar.creationTime) * scar.alphaDecay);
+		}
+	}
+
 	// do not test for drawIndex == 0 here because the VA might have been recycled
 	if (scar.lastDraw == -1) {
 		va.Initialize();
@@ -348,9 +395,38 @@ inline void CGroundDecalHandler::DrawGroundScar(CGroundDecalHandler::Scar& scar)
 		const int sz = (int) std::max(                    0.0f, (pos.z - radius) * 0.0625f);
 		const int ez = (int) std::min(float(mapDims.hmapy - 1), (pos.z + radius) * 0.0625f);
 
-		// create the scar texture-quads
+		// create the scar texture-quads; sample all four corner heights
+		// of every quad through one batched terrain call
+		static std::vector<float3> quadPositions;
+		static std::vector<float> quadHeights;
+
+		quadPositions.clear();
+
 		float px1 = sx * TEX_QUAD_SIZE;
 
+		for (int x = sx; x <= ex; ++x) {
+			const float px2 = px1 + TEX_QUAD_SIZE;
+			      float pz1 = sz * TEX_QUAD_SIZE;
+
+			for (int z = sz; z <= ez; ++z) {
+				const float pz2 = pz1 + TEX_QUAD_SIZE;
+
+				quadPositions.emplace_back(px1, 0.0f, pz1);
+				quadPositions.emplace_back(px2, 0.0f, pz1);
+				quadPositions.emplace_back(px2, 0.0f, pz2);
+				quadPositions.emplace_back(px1, 0.0f, pz2);
+				pz1 = pz2;
+			}
+
+			px1 = px2;
+		}
+
+		quadHeights.resize(quadPositions.size());
+		CGround::GetHeightsReal(quadPositions.data(), quadHeights.data(), quadPositions.size(), false);
+
+		size_t n = 0;
+		px1 = sx * TEX_QUAD_SIZE;
+
 		for (int x = sx; x <= ex; ++x) {
 			const float px2 = px1 + TEX_QUAD_SIZE;
 			      float pz1 = sz * TEX_QUAD_SIZE;
@@ -362,49 +438,42 @@ inline void CGroundDecalHandler::DrawGroundScar(CGroundDecalHandler::Scar& scar)
 				const float tz1 = std::min(0.5f, (pos.z - pz1) / radius4 + 0.25f);
 				const float tz2 = std::max(0.0f, (pos.z - pz2) / radius4 + 0.25f);
 
-				const float h1 = CGround::GetHeightReal(px1, pz1, false);
-				const float h2 = CGround::GetHeightReal(px2, pz1, false);
-				const float h3 = CGround::GetHeightReal(px2, pz2, false);
-				const float h4 = CGround::GetHeightReal(px1, pz2, false);
+				va.AddVertexTC(float3(px1, quadHeights[n + 0], pz1), tx1 + tx, tz1 + ty, color);
+				va.AddVertexTC(float3(px2, quadHeights[n + 1], pz1), tx2 + tx, tz1 + ty, color);
+				va.AddVertexTC(float3(px2, quadHeights[n + 2], pz2), tx2 + tx, tz2 + ty, color);
+				va.AddVertexTC(float3(px1, quadHeights[n + 3], pz2), tx1 + tx, tz2 + ty, color);
 
-				va.AddVertexTC(float3(px1, h1, pz1), tx1 + tx, tz1 + ty, color);
-				va.AddVertexTC(float3(px2, h2, pz1), tx2 + tx, tz1 + ty, color);
-				va.AddVertexTC(float3(px2, h3, pz2), tx2 + tx, tz2 + ty, color);
-				va.AddVertexTC(float3(px1, h4, pz2), tx1 + tx, tz2 + ty, color);
+				n += 4;
 				pz1 = pz2;
 			}
 
 			px1 = px2;
 		}
-	} else {
-		if (groundScarAlphaFade) {
-			if ((scar.creationTime + 10) > gs->frameNum) {
-				color[3] = (int) (scar.startAlpha * (gs->frameNum - scar.creationTime) * 0.1f);
-			} else {
-				color[3] = (int) (scar.startAlpha - (gs->frameNum - scar.creationTime) * scar.alphaDecay);
-			}
-
-			const float* hm = readMap->GetCornerHeightMapUnsynced();
+	} else if (groundScarAlphaFade) {
+		const float* hm = readMap->GetCornerHeightMapUnsynced();
 
-			const int gsmx1 = mapDims.mapx + 1;
-			const int num = va.drawIndex() / VA_SIZE_TC;
+		const int gsmx1 = mapDims.mapx + 1;
+		const int num = va.drawIndex() / VA_SIZE_TC;
 
-			va.ResetPos();
-			VA_TYPE_TC* mem = va.GetTypedVertexArray<VA_TYPE_TC>(num);
+		va.ResetPos();
+		VA_TYPE_TC* mem = va.GetTypedVertexArray<VA_TYPE_TC>(num);
 
-			for (int i = 0; i < num; ++i) {
-				const int x = int(mem[i].p.x) >> 3;
-				const int z = int(mem[i].p.z) >> 3;
+		for (int i = 0; i < num; ++i) {
+			const int x = int(mem[i].p.x) >> 3;
+			const int z = int(mem[i].p.z) >> 3;
 
-				// update the height and alpha
-				mem[i].p.y = hm[z * gsmx1 + x];
-				mem[i].c   = color;
-			}
+			// update the height and alpha
+			mem[i].p.y = hm[z * gsmx1 + x];
+			mem[i].c   = color;
 		}
-
-		va.DrawArrayTC(GL_QUADS);
 	}
 
+	// append the baked quads to the shared scar batch
+	const int numVerts = va.drawIndex() / VA_SIZE_TC;
+
+	VA_TYPE_TC* mem = batchVA->GetTypedVertexArray<VA_TYPE_TC>(numVerts);
+	memcpy(mem, va.GetDrawArray(), numVerts * sizeof(VA_TYPE_TC));
+
 	scar.lastDraw = globalRendering->drawFrame;
 }
 
@@ -486,9 +555,16 @@ void CGroundDecalHandler::DrawObjectDecals() {
 		if (!decalsToDraw.empty()) {
 			glBindTexture(GL_TEXTURE_2D, decalType.texture);
 
+			// gather the (retained) quads of all visible decals
+			// sharing this texture and draw them in a single call
+			CVertexArray* va = GetVertexArray();
+			va->Initialize();
+
 			for (SolidObjectGroundDecal* decal: decalsToDraw) {
-				DrawObjectDecal(decal);
+				DrawObjectDecal(decal, va);
 			}
+
+			va->DrawArrayTC(GL_QUADS);
 		}
 
 		// glBindTexture(GL_TEXTURE_2D, 0);
@@ -524,7 +600,11 @@ void CGroundDecalHandler::AddScars()
 }
 
 void CGroundDecalHandler::DrawScars() {
-	// create and draw the 16x16 quads for each ground scar
+	// all scars sample from the same atlas, batch them into one call
+	CVertexArray* va = GetVertexArray();
+	va->Initialize();
+
+	// create and append the 16x16 quads for each ground scar
 	for (size_t i = 0; i < usedScarIDs.size(); ) {
 		Scar& scar = scars[ usedScarIDs[i] ];
 
@@ -535,9 +615,11 @@ void CGroundDecalHandler::DrawScars() {
 			continue;
 		}
 
-		DrawGroundScar(scar);
+		DrawGroundScar(scar, va);
 		i++;
 	}
+
+	va->DrawArrayTC(GL_QUADS);
 }
 
 
@@ -9,6 +9,7 @@
 #include "Rendering/Env/IGroundDecalDrawer.h"
 #include "Rendering/Env/Decals/LegacyTrackHandler.h"
 #include "Rendering/GL/VertexArray.h"
+#include "System/Color.h"
 #include "System/float3.h"
 #include "System/EventClient.h"
 #include "Sim/Projectiles/ExplosionListener.h"
@@ -39,6 +40,8 @@ public:
 		, radius(0.0f)
 		, alpha(1.0f)
 		, alphaFalloff(1.0f)
+		, vaColor(255, 255, 255, 255)
+		, heightsDirty(false)
 	{}
 	SolidObjectGroundDecal(const SolidObjectGroundDecal& d) = delete;
 	SolidObjectGroundDecal(SolidObjectGroundDecal&& d) { *this = std::move(d); }
@@ -61,6 +64,9 @@ public:
 		radius       = d.radius;
 		alpha        = d.alpha;
 		alphaFalloff = d.alphaFalloff;
+
+		vaColor      = d.vaColor;
+		heightsDirty = d.heightsDirty;
 		return *this;
 	}
 
@@ -81,6 +87,11 @@ public:
 	float radius;
 	float alpha;
 	float alphaFalloff;
+
+	// color last baked into <va>; the vertices are only rewritten when
+	// this changes or the terrain below the decal does (heightsDirty)
+	SColor vaColor;
+	bool heightsDirty;
 };
 
 
@@ -118,6 +129,7 @@ public:
 	bool WantsEvent(const std::string& eventName) {
 		return
 			(eventName == "SunChanged") ||
+			(eventName == "UnsyncedHeightMapUpdate") ||
 			(eventName == "RenderUnitCreated") ||
 			(eventName == "RenderUnitDestroyed") ||
 			(eventName == "UnitMoved") ||
@@ -131,6 +143,7 @@ public:
 	int GetReadAllyTeam() const { return AllAccessTeam; }
 
 	void SunChanged();
+	void UnsyncedHeightMapUpdate(const SRectangle& rect);
 	void RenderUnitCreated(const CUnit*, int cloaked);
 	void RenderUnitDestroyed(const CUnit*);
 	void RenderFeatureCreated(const CFeature* feature);
@@ -248,8 +261,8 @@ private:
 	void GatherDecalsForType(SolidObjectDecalType& decalType);
 	void AddDecal(CUnit* unit, const float3& newPos);
 
-	void DrawObjectDecal(SolidObjectGroundDecal* decal);
-	void DrawGroundScar(Scar& scar);
+	void DrawObjectDecal(SolidObjectGroundDecal* decal, CVertexArray* batchVA);
+	void DrawGroundScar(Scar& scar, CVertexArray* batchVA);
 
 	int GetScarID() const;
 	int ScarOverlapSize(const Scar& s1, const Scar& s2);
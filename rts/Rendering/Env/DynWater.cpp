@@ -404,8 +404,10 @@ void CDynWater::UpdateWater(CGame* game)
 	glEnable(GL_DEPTH_TEST);
 	glDepthMask(1);
 
-	DrawRefraction(game);
-	DrawReflection(game);
+	if (ShouldUpdateReflections()) {
+		DrawRefraction(game);
+		DrawReflection(game);
+	}
 	FBO::Unbind();
 	glPopAttrib();
 }
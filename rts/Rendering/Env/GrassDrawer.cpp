@@ -368,6 +368,7 @@ void CGrassDrawer::EnableShader(const GrassShaderProgram type) {
 	grassShader->Enable();
 
 	grassShader->SetUniform("frame", gs->frameNum + globalRendering->timeOffset);
+	grassShader->SetUniform("grassFadeDists", maxDetailedDist, maxGrassDist);
 	grassShader->SetUniform3v("windSpeed", &windSpeed.x);
 	grassShader->SetUniform3v("camPos",    &camera->GetPos().x);
 	grassShader->SetUniform3v("camDir",    &camera->GetDir().x);
@@ -402,6 +403,11 @@ static float3 GetTurfParams(GrassRNG& rng, const int x, const int y)
 
 void CGrassDrawer::DrawNear(const std::vector<InviewNearGrass>& inviewGrass)
 {
+	std::vector<float3> turfParams(numTurfs);
+	std::vector<float3> turfPositions(numTurfs);
+	std::vector<float> turfHeights(numTurfs);
+	std::vector<float> turfSlopes(numTurfs);
+
 	for (const InviewNearGrass& g: inviewGrass) {
 		grng.Seed(g.y * mapDims.mapx / grassSquareSize + g.x);
 
@@ -409,11 +415,21 @@ void CGrassDrawer::DrawNear(const std::vector<InviewNearGrass>& inviewGrass)
 		const float rdist  = 1.0f + grng.NextFloat() * 0.5f;
 		const float alpha  = linearstep(maxDetailedDist, maxDetailedDist + 128.0f * rdist, g.dist);
 
+		// sample terrain for all turfs of the block in one batched call
+		// (params are (x, z, rotation) triples, not world positions)
 		for (int a = 0; a < numTurfs; a++) {
-			const float3& p = GetTurfParams(grng, g.x, g.y);
-			float3 pos(p.x, CGround::GetHeightReal(p.x, p.y, false), p.y);
+			turfParams[a] = GetTurfParams(grng, g.x, g.y);
+			turfPositions[a] = float3(turfParams[a].x, 0.0f, turfParams[a].y);
+		}
 
-			pos.y -= CGround::GetSlope(p.x, p.y, false) * 30.0f;
+		CGround::GetHeightsReal(turfPositions.data(), turfHeights.data(), numTurfs, false);
+		CGround::GetSlopes(turfPositions.data(), turfSlopes.data(), numTurfs, false);
+
+		for (int a = 0; a < numTurfs; a++) {
+			const float3& p = turfParams[a];
+			float3 pos(p.x, turfHeights[a], p.y);
+
+			pos.y -= turfSlopes[a] * 30.0f;
 			pos.y -= 2.0f * mapInfo->grass.bladeHeight * alpha;
 
 			glPushMatrix();
@@ -426,24 +442,38 @@ void CGrassDrawer::DrawNear(const std::vector<InviewNearGrass>& inviewGrass)
 }
 
 
-void CGrassDrawer::DrawBillboard(const int x, const int y, const float dist, VA_TYPE_TN* va_tn)
+void CGrassDrawer::DrawBillboard(const int x, const int y, VA_TYPE_TN* va_tn)
 {
 	GrassRNG trng; // need our own, cause this function may run threaded
 	trng.Seed(y * mapDims.mapx / grassSquareSize + x);
 
+	// per-square random spread of the fade-in distance; the actual
+	// distance fade is computed in the vertex shader (DISTANCE_FAR),
+	// which keeps these arrays valid while the camera moves
 	const float rDist = 1.0f + trng.NextFloat() * 0.5f;
-	const float gStep = linearstep(maxGrassDist,  maxGrassDist + 127.0f, dist + 128.0f);
-	const float dStep = linearstep(maxDetailedDist, maxDetailedDist + 128.0f * rDist, dist);
-	const float alpha = std::min(1.0f - gStep, dStep);
+
+	// local buffers, see above (threaded)
+	std::vector<float3> turfParams(numTurfs);
+	std::vector<float3> turfPositions(numTurfs);
+	std::vector<float> turfHeights(numTurfs);
+	std::vector<float> turfSlopes(numTurfs);
+
+	for (int a = 0; a < numTurfs; a++) {
+		turfParams[a] = GetTurfParams(trng, x, y);
+		turfPositions[a] = float3(turfParams[a].x, 0.0f, turfParams[a].y);
+	}
+
+	CGround::GetHeightsReal(turfPositions.data(), turfHeights.data(), numTurfs, false);
+	CGround::GetSlopes(turfPositions.data(), turfSlopes.data(), numTurfs, false);
 
 	for (int a = 0; a < numTurfs; a++) {
-		const float3& p = GetTurfParams(trng, x, y);
-		const float3 pos(p.x, CGround::GetHeightReal(p.x, p.y, false) - CGround::GetSlope(p.x, p.y, false) * 30.0f, p.y);
+		const float3& p = turfParams[a];
+		const float3 pos(p.x, turfHeights[a] - turfSlopes[a] * 30.0f, p.y);
 
-		va_tn[a * 4 + 0] = { pos,         0.0f, 1.0f, float3(-partTurfSize, -partTurfSize, alpha) };
-		va_tn[a * 4 + 1] = { pos, 1.0f / 16.0f, 1.0f, float3( partTurfSize, -partTurfSize, alpha) };
-		va_tn[a * 4 + 2] = { pos, 1.0f / 16.0f, 0.0f, float3( partTurfSize,  partTurfSize, alpha) };
-		va_tn[a * 4 + 3] = { pos,         0.0f, 0.0f, float3(-partTurfSize,  partTurfSize, alpha) };
+		va_tn[a * 4 + 0] = { pos,         0.0f, 1.0f, float3(-partTurfSize, -partTurfSize, rDist) };
+		va_tn[a * 4 + 1] = { pos, 1.0f / 16.0f, 1.0f, float3( partTurfSize, -partTurfSize, rDist) };
+		va_tn[a * 4 + 2] = { pos, 1.0f / 16.0f, 0.0f, float3( partTurfSize,  partTurfSize, rDist) };
+		va_tn[a * 4 + 3] = { pos,         0.0f, 0.0f, float3(-partTurfSize,  partTurfSize, rDist) };
 	}
 }
 
@@ -456,25 +486,15 @@ void CGrassDrawer::DrawFarBillboards(const std::vector<GrassStruct*>& inviewFarG
 
 		for_mt(0, inviewFarGrass.size(), [&](const int i){
 			GrassStruct& g = *inviewFarGrass[i];
-			if (!g.va) {
-				//TODO vertex arrays need to be send each frame to the gpu, that's slow. switch to VBOs.
-				CVertexArray* va = new CVertexArray;
-				g.va = va;
-				g.lastDist = -1; // force a recreate
-			}
 
-			const float distSq = GetCamDistOfGrassBlock((g.posX + 0.5f) * grassBlockSize, (g.posZ + 0.5f) * grassBlockSize, true);
-			if (distSq == g.lastDist)
+			// block arrays are camera-independent (the distance fade runs
+			// in the vertex shader), so only blocks without one need to be
+			// generated: first time in view, garbage-collected, or reset
+			// after terrain/grass-map changes
+			if (g.va != nullptr)
 				return;
 
-			bool inAlphaRange1 = (    distSq < Square(maxDetailedDist + 128.f * 1.5f)) || (    distSq > Square(maxGrassDist - 128.f));
-			bool inAlphaRange2 = (g.lastDist < Square(maxDetailedDist + 128.f * 1.5f)) || (g.lastDist > Square(maxGrassDist - 128.f));
-			if (!inAlphaRange1 && (inAlphaRange1 == inAlphaRange2)) {
-				return;
-			}
-
-			g.lastDist = distSq;
-			CVertexArray* va = g.va;
+			CVertexArray* va = (g.va = new CVertexArray);
 			va->Initialize();
 
 			for (int y2 = g.posZ * grassBlockSize; y2 < (g.posZ + 1) * grassBlockSize; ++y2) {
@@ -483,9 +503,8 @@ void CGrassDrawer::DrawFarBillboards(const std::vector<GrassStruct*>& inviewFarG
 						continue;
 					}
 
-					const float dist = GetCamDistOfGrassBlock(x2, y2);
 					auto* va_tn = va->GetTypedVertexArray<VA_TYPE_TN>(numTurfs * 4);
-					DrawBillboard(x2, y2, dist, va_tn);
+					DrawBillboard(x2, y2, va_tn);
 				}
 			}
 		});
@@ -504,7 +523,7 @@ void CGrassDrawer::DrawNearBillboards(const std::vector<InviewNearGrass>& inview
 		auto* va_tn = farnearVA->GetTypedVertexArray<VA_TYPE_TN>(inviewNearGrass.size() * numTurfs * 4);
 		for_mt(0, inviewNearGrass.size(), [&](const int i){
 			const InviewNearGrass& gi = inviewNearGrass[i];
-			DrawBillboard(gi.x, gi.y, gi.dist, &va_tn[i * numTurfs * 4]);
+			DrawBillboard(gi.x, gi.y, &va_tn[i * numTurfs * 4]);
 		});
 	}
 
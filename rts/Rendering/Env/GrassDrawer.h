@@ -49,14 +49,12 @@ public:
 			, posZ(0)
 			, va(nullptr)
 			, lastSeen(0)
-			, lastDist(0.f)
 		{}
 		~GrassStruct();
 
 		int posX, posZ;
 		CVertexArray* va;
 		int lastSeen;
-		float lastDist;
 	};
 
 	enum GrassShaderProgram {
@@ -80,7 +78,7 @@ protected:
 	void DrawNear(const std::vector<InviewNearGrass>& inviewGrass);
 	void DrawFarBillboards(const std::vector<GrassStruct*>& inviewGrass);
 	void DrawNearBillboards(const std::vector<InviewNearGrass>& inviewNearGrass);
-	void DrawBillboard(const int x, const int y, const float dist, VA_TYPE_TN* va_tn);
+	void DrawBillboard(const int x, const int y, VA_TYPE_TN* va_tn);
 
 	void ResetPos(const int grassBlockX, const int grassBlockZ);
 
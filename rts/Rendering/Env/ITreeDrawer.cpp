@@ -103,6 +103,10 @@ void ITreeDrawer::ResetPos(const float3& pos)
 		delDispLists.push_back(tss.farDispList);
 		tss.farDispList = 0;
 	}
+	if (tss.nearDispList != 0) {
+		delDispLists.push_back(tss.nearDispList);
+		tss.nearDispList = 0;
+	}
 }
 
 
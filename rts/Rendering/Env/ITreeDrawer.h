@@ -70,6 +70,7 @@ public:
 		TreeSquareStruct()
 			: dispList(0)
 			, farDispList(0)
+			, nearDispList(0)
 			, lastSeen(0)
 			, lastSeenFar(0)
 			, viewVector(UpVector)
@@ -77,6 +78,9 @@ public:
 
 		unsigned int dispList;
 		unsigned int farDispList;
+		// full-detail geometry of all trees in this square with their
+		// positions baked in (only used by CAdvTreeDrawer)
+		unsigned int nearDispList;
 
 		int lastSeen;
 		int lastSeenFar;
@@ -7,10 +7,12 @@
 #include "BumpWater.h"
 #include "DynWater.h"
 #include "RefractWater.h"
+#include "Game/Camera.h"
 #include "Game/Game.h"
 #include "Game/GameHelper.h"
 #include "Map/ReadMap.h"
 #include "Map/BaseGroundDrawer.h"
+#include "Rendering/GlobalRendering.h"
 #include "Rendering/FeatureDrawer.h"
 #include "Rendering/UnitDrawer.h"
 #include "Rendering/Env/Particles/ProjectileDrawer.h"
@@ -19,6 +21,7 @@
 #include "System/EventHandler.h"
 #include "System/Exceptions.h"
 #include "System/Log/ILog.h"
+#include "System/myMath.h"
 
 CONFIG(int, Water)
 .defaultValue(IWater::WATER_RENDERER_REFLECTIVE)
@@ -28,6 +31,11 @@ CONFIG(int, Water)
 .maximumValue(IWater::NUM_WATER_RENDERERS - 1)
 .description("Defines the type of water rendering. Can be set in game. Options are: 0 = Basic water, 1 = Reflective water, 2 = Reflective and Refractive water, 3 = Dynamic water, 4 = Bumpmapped water");
 
+CONFIG(int, WaterReflectionRate)
+.defaultValue(1)
+.minimumValue(1)
+.description("Renders the water reflection and refraction passes every Nth draw-frame (1 = every frame); a larger camera movement forces an update regardless.");
+
 IWater* water = nullptr;
 static std::vector<int> waterModes;
 
@@ -36,11 +44,36 @@ IWater::IWater()
 	: drawReflection(false)
 	, drawRefraction(false)
 	, wireFrameMode(false)
+	, reflUpdateRate(configHandler->GetInt("WaterReflectionRate"))
+	, reflUpdateFrame(0)
+	, reflUpdateCamPos(ZeroVector)
+	, reflUpdateCamDir(FwdVector)
 {
 	CExplosionCreator::AddExplosionListener(this);
 }
 
 
+bool IWater::ShouldUpdateReflections()
+{
+	if (reflUpdateRate <= 1)
+		return true;
+
+	// a stale reflection lags visibly behind once the camera moves,
+	// so only frames with a (nearly) stationary camera are skipped
+	const bool camMoved =
+		(camera->GetPos().SqDistance(reflUpdateCamPos) > Square(SQUARE_SIZE * 2.0f)) ||
+		(camera->GetDir().dot(reflUpdateCamDir) < 0.999f);
+
+	if (!camMoved && ((globalRendering->drawFrame - reflUpdateFrame) < unsigned(reflUpdateRate)))
+		return false;
+
+	reflUpdateFrame = globalRendering->drawFrame;
+	reflUpdateCamPos = camera->GetPos();
+	reflUpdateCamDir = camera->GetDir();
+	return true;
+}
+
+
 void IWater::PushWaterMode(int nxtRendererMode)
 {
 	waterModes.push_back(nxtRendererMode);
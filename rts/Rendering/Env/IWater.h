@@ -48,10 +48,19 @@ protected:
 	void DrawReflections(const double* clipPlaneEqs, bool drawGround, bool drawSky);
 	void DrawRefractions(const double* clipPlaneEqs, bool drawGround, bool drawSky);
 
+	/// whether the reflection (and refraction) passes are due this
+	/// draw-frame; renderers reuse their last FBO contents otherwise
+	bool ShouldUpdateReflections();
+
 protected:
 	bool drawReflection;
 	bool drawRefraction;
 	bool wireFrameMode;
+
+	int reflUpdateRate;
+	unsigned int reflUpdateFrame;
+	float3 reflUpdateCamPos;
+	float3 reflUpdateCamDir;
 };
 
 extern IWater* water;
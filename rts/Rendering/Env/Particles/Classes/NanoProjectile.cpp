@@ -26,6 +26,7 @@ CR_REG_METADATA(CNanoProjectile,
 
 CNanoProjectile::CNanoProjectile(): CProjectile()
 {
+	linearMotion = true;
 	deathFrame = 0;
 	color[0] = color[1] = color[2] = color[3] = 255;
 
@@ -35,9 +36,11 @@ CNanoProjectile::CNanoProjectile(): CProjectile()
 
 CNanoProjectile::CNanoProjectile(float3 pos, float3 speed, int lifeTime, SColor c)
 	: CProjectile(pos, speed, NULL, false, false, false)
-	, deathFrame(gs->frameNum + lifeTime)
 	, color(c)
 {
+	linearMotion = true;
+	deathFrame = gs->frameNum + lifeTime;
+
 	checkCol = false;
 	drawSorted = false;
 	drawRadius = 3;
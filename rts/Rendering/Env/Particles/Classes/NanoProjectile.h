@@ -24,7 +24,6 @@ public:
 	static bool GetMemberInfo(SExpGenSpawnableMemberInfo& memberInfo);
 
 private:
-	int deathFrame;
 	SColor color;
 };
 
@@ -14,6 +14,7 @@
 #include "Rendering/UnitDrawer.h"
 #include "Rendering/Env/ISky.h"
 #include "Rendering/GL/FBO.h"
+#include "Rendering/GL/StateCache.h"
 #include "Rendering/GL/VertexArray.h"
 #include "Rendering/Shaders/Shader.h"
 #include "Rendering/Textures/Bitmap.h"
@@ -535,7 +536,7 @@ void CProjectileDrawer::DrawFlyingPieces(int modelType)
 		return;
 
 	glPushAttrib(GL_POLYGON_BIT);
-	glDisable(GL_CULL_FACE);
+	GL::Disable(GL_CULL_FACE);
 
 	const FlyingPiece* last = nullptr;
 
@@ -557,14 +558,17 @@ void CProjectileDrawer::DrawFlyingPieces(int modelType)
 		last->EndDraw();
 
 	glPopAttrib();
+	GL::InvalidateStateCache();
 }
 
 
 void CProjectileDrawer::Draw(bool drawReflection, bool drawRefraction) {
 	glPushAttrib(GL_ENABLE_BIT | GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT | GL_CURRENT_BIT);
-	glDisable(GL_BLEND);
-	glEnable(GL_TEXTURE_2D);
-	glDepthMask(GL_TRUE);
+	// untracked code has run since the last pass; start from a clean shadow
+	GL::InvalidateStateCache();
+	GL::Disable(GL_BLEND);
+	GL::Enable(GL_TEXTURE_2D);
+	GL::DepthMask(GL_TRUE);
 
 	sky->SetupFog();
 
@@ -600,17 +604,17 @@ void CProjectileDrawer::Draw(bool drawReflection, bool drawRefraction) {
 		}
 	}
 
-	glEnable(GL_BLEND);
-	glDisable(GL_FOG);
+	GL::Enable(GL_BLEND);
+	GL::Disable(GL_FOG);
 
 	if (fxVA->drawIndex() > 0) {
-		glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
-		glEnable(GL_TEXTURE_2D);
+		GL::BlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+		GL::Enable(GL_TEXTURE_2D);
 
 		glColor4f(1.0f, 1.0f, 1.0f, 0.2f);
-		glAlphaFunc(GL_GREATER, 0.0f);
-		glEnable(GL_ALPHA_TEST);
-		glDepthMask(GL_FALSE);
+		GL::AlphaFunc(GL_GREATER, 0.0f);
+		GL::Enable(GL_ALPHA_TEST);
+		GL::DepthMask(GL_FALSE);
 
 		// send event after the default state has been set, allows overriding
 		// it for specific cases such as proper blending with depth-aware fog
@@ -624,6 +628,7 @@ void CProjectileDrawer::Draw(bool drawReflection, bool drawRefraction) {
 	}
 
 	glPopAttrib();
+	GL::InvalidateStateCache();
 }
 
 void CProjectileDrawer::DrawShadowPass()
@@ -631,7 +636,8 @@ void CProjectileDrawer::DrawShadowPass()
 	Shader::IProgramObject* po =
 		shadowHandler->GetShadowGenProg(CShadowHandler::SHADOWGEN_PROGRAM_PROJECTILE);
 
-	glDisable(GL_TEXTURE_2D);
+	GL::InvalidateStateCache();
+	GL::Disable(GL_TEXTURE_2D);
 	po->Enable();
 
 	fxVA = GetVertexArray();
@@ -647,10 +653,10 @@ void CProjectileDrawer::DrawShadowPass()
 	}
 
 	if (fxVA->drawIndex() > 0) {
-		glEnable(GL_TEXTURE_2D);
+		GL::Enable(GL_TEXTURE_2D);
 		glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
-		glAlphaFunc(GL_GREATER, 0.3f);
-		glEnable(GL_ALPHA_TEST);
+		GL::AlphaFunc(GL_GREATER, 0.3f);
+		GL::Enable(GL_ALPHA_TEST);
 		glShadeModel(GL_SMOOTH);
 
 		textureAtlas->BindTexture();
@@ -659,8 +665,8 @@ void CProjectileDrawer::DrawShadowPass()
 
 	po->Disable();
 	glShadeModel(GL_FLAT);
-	glDisable(GL_ALPHA_TEST);
-	glDisable(GL_TEXTURE_2D);
+	GL::Disable(GL_ALPHA_TEST);
+	GL::Disable(GL_TEXTURE_2D);
 }
 
 
@@ -714,14 +720,15 @@ void CProjectileDrawer::DrawGroundFlashes()
 
 	static constexpr GLfloat black[] = {0.0f, 0.0f, 0.0f, 0.0f};
 
-	glDepthMask(GL_FALSE);
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-	glActiveTexture(GL_TEXTURE0);
+	GL::InvalidateStateCache();
+	GL::DepthMask(GL_FALSE);
+	GL::Enable(GL_BLEND);
+	GL::BlendFunc(GL_SRC_ALPHA, GL_ONE);
+	GL::ActiveTexture(GL_TEXTURE0);
 	groundFXAtlas->BindTexture();
-	glEnable(GL_TEXTURE_2D);
-	glEnable(GL_ALPHA_TEST);
-	glAlphaFunc(GL_GREATER, 0.01f);
+	GL::Enable(GL_TEXTURE_2D);
+	GL::Enable(GL_ALPHA_TEST);
+	GL::AlphaFunc(GL_GREATER, 0.01f);
 	glPolygonOffset(-20, -1000);
 	glEnable(GL_POLYGON_OFFSET_FILL);
 	glFogfv(GL_FOG_COLOR, black);
@@ -731,8 +738,8 @@ void CProjectileDrawer::DrawGroundFlashes()
 	gfVA->EnlargeArrays(8 * gfc.size(), 0, VA_SIZE_TC);
 
 
-	bool depthTest = true;
-	bool depthMask = false;
+	static std::vector<CGroundFlash*> visibleFlashes;
+	visibleFlashes.clear();
 
 	for (CGroundFlash* gf: gfc) {
 		const bool inLos = gf->alwaysVisible || gu->spectatingFullView || losHandler->InAirLos(gf, gu->myAllyTeam);
@@ -742,14 +749,28 @@ void CProjectileDrawer::DrawGroundFlashes()
 		if (!camera->InView(gf->pos, gf->size))
 			continue;
 
+		visibleFlashes.push_back(gf);
+	}
+
+	// the additive blending makes draw order irrelevant, so group the
+	// flashes by their depth state up front; the quad stream below then
+	// breaks at most three times instead of on every state difference
+	std::stable_sort(visibleFlashes.begin(), visibleFlashes.end(), [](const CGroundFlash* a, const CGroundFlash* b) {
+		return ((a->depthTest * 2 + a->depthMask) < (b->depthTest * 2 + b->depthMask));
+	});
+
+	bool depthTest = true;
+	bool depthMask = false;
+
+	for (CGroundFlash* gf: visibleFlashes) {
 		if (depthTest != gf->depthTest) {
 			gfVA->DrawArrayTC(GL_QUADS);
 			gfVA->Initialize();
 
 			if ((depthTest = gf->depthTest)) {
-				glEnable(GL_DEPTH_TEST);
+				GL::Enable(GL_DEPTH_TEST);
 			} else {
-				glDisable(GL_DEPTH_TEST);
+				GL::Disable(GL_DEPTH_TEST);
 			}
 		}
 		if (depthMask != gf->depthMask) {
@@ -757,9 +778,9 @@ void CProjectileDrawer::DrawGroundFlashes()
 			gfVA->Initialize();
 
 			if ((depthMask = gf->depthMask)) {
-				glDepthMask(GL_TRUE);
+				GL::DepthMask(GL_TRUE);
 			} else {
-				glDepthMask(GL_FALSE);
+				GL::DepthMask(GL_FALSE);
 			}
 		}
 
@@ -769,12 +790,12 @@ void CProjectileDrawer::DrawGroundFlashes()
 	gfVA->DrawArrayTC(GL_QUADS);
 
 	glFogfv(GL_FOG_COLOR, sky->fogColor);
-	glDisable(GL_POLYGON_OFFSET_FILL);
-	glDisable(GL_ALPHA_TEST);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glDisable(GL_BLEND);
-	glEnable(GL_DEPTH_TEST);
-	glDepthMask(GL_TRUE);
+	GL::Disable(GL_POLYGON_OFFSET_FILL);
+	GL::Disable(GL_ALPHA_TEST);
+	GL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	GL::Disable(GL_BLEND);
+	GL::Enable(GL_DEPTH_TEST);
+	GL::DepthMask(GL_TRUE);
 }
 
 
@@ -796,13 +817,14 @@ void CProjectileDrawer::UpdatePerlin() {
 	glPushMatrix();
 	glLoadIdentity();
 
-	glDisable(GL_DEPTH_TEST);
-	glDepthMask(GL_FALSE);
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_ONE, GL_ONE);
-	glEnable(GL_TEXTURE_2D);
-	glDisable(GL_ALPHA_TEST);
-	glDisable(GL_FOG);
+	GL::InvalidateStateCache();
+	GL::Disable(GL_DEPTH_TEST);
+	GL::DepthMask(GL_FALSE);
+	GL::Enable(GL_BLEND);
+	GL::BlendFunc(GL_ONE, GL_ONE);
+	GL::Enable(GL_TEXTURE_2D);
+	GL::Disable(GL_ALPHA_TEST);
+	GL::Disable(GL_FOG);
 
 	unsigned char col[4];
 	float time = globalRendering->lastFrameTime * gs->speedFactor * 0.003f;
@@ -826,12 +848,12 @@ void CProjectileDrawer::UpdatePerlin() {
 		float tsize = 8.0f / size;
 
 		if (a == 0)
-			glDisable(GL_BLEND);
+			GL::Disable(GL_BLEND);
 
 		for (int b = 0; b < 4; ++b)
 			col[b] = int((1.0f - perlinBlend[a]) * 16 * size);
 
-		glBindTexture(GL_TEXTURE_2D, perlinBlendTex[a * 2]);
+		GL::BindTexture(GL_TEXTURE_2D, perlinBlendTex[a * 2]);
 		va->Initialize();
 		va->AddVertexQTC(ZeroVector, 0,         0, col);
 		va->AddVertexQTC(  UpVector, 0,     tsize, col);
@@ -840,12 +862,12 @@ void CProjectileDrawer::UpdatePerlin() {
 		va->DrawArrayTC(GL_QUADS);
 
 		if (a == 0)
-			glEnable(GL_BLEND);
+			GL::Enable(GL_BLEND);
 
 		for (int b = 0; b < 4; ++b)
 			col[b] = int(perlinBlend[a] * 16 * size);
 
-		glBindTexture(GL_TEXTURE_2D, perlinBlendTex[a * 2 + 1]);
+		GL::BindTexture(GL_TEXTURE_2D, perlinBlendTex[a * 2 + 1]);
 		va->Initialize();
 		va->AddVertexQTC(ZeroVector,     0,     0, col);
 		va->AddVertexQTC(  UpVector,     0, tsize, col);
@@ -860,9 +882,9 @@ void CProjectileDrawer::UpdatePerlin() {
 	perlinFB.Unbind();
 	glViewport(globalRendering->viewPosX, 0, globalRendering->viewSizeX, globalRendering->viewSizeY);
 
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glEnable(GL_DEPTH_TEST);
-	glDepthMask(GL_TRUE);
+	GL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	GL::Enable(GL_DEPTH_TEST);
+	GL::DepthMask(GL_TRUE);
 
 	glPopMatrix();
 	glMatrixMode(GL_PROJECTION);
@@ -883,7 +905,7 @@ void CProjectileDrawer::GenerateNoiseTex(unsigned int tex)
 		mem[a * 4 + 3] = rnd;
 	}
 
-	glBindTexture(GL_TEXTURE_2D, tex);
+	GL::BindTexture(GL_TEXTURE_2D, tex);
 	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, perlinBlendTexSize, perlinBlendTexSize, GL_RGBA, GL_UNSIGNED_BYTE, &mem[0]);
 }
 
@@ -3,13 +3,19 @@
 
 #include "FarTextureHandler.h"
 
+#include <algorithm>
+
 #include "Game/Camera.h"
 #include "Rendering/UnitDrawer.h"
 #include "Rendering/GlobalRendering.h"
 #include "Rendering/Env/ISky.h"
 #include "Rendering/GL/VertexArray.h"
 #include "Rendering/Models/3DModel.h"
+#include "Sim/Features/Feature.h"
+#include "Sim/Features/FeatureHandler.h"
 #include "Sim/Objects/SolidObject.h"
+#include "Sim/Units/Unit.h"
+#include "Sim/Units/UnitHandler.h"
 #include "System/myMath.h"
 #include "System/Log/ILog.h"
 
@@ -23,7 +29,11 @@ LOG_REGISTER_SECTION_GLOBAL(LOG_SECTION_FAR_TEXTURE_HANDLER)
 #define LOG_SECTION_CURRENT LOG_SECTION_FAR_TEXTURE_HANDLER
 
 #define NUM_ICON_ORIENTATIONS 8
-#define MAX_CREATE_QUEUE_SIZE 8
+// icon creations RTT the model from all orientations and are the only
+// expensive part of this path; budget them so a spectator jump into a
+// large battle spreads the burst over frames (objects whose icon has
+// not come up yet are simply not drawn until it has)
+#define MAX_CREATES_PER_FRAME 2
 
 
 CFarTextureHandler* farTextureHandler = nullptr;
@@ -45,7 +55,7 @@ CFarTextureHandler::CFarTextureHandler()
 	texSize.x = globalRendering->maxTextureSize;
 	texSize.y = iconSize.y;
 
-	createQueue.reserve(MAX_CREATE_QUEUE_SIZE);
+	createQueue.reserve(32);
 	renderQueue.reserve(128);
 
 #ifndef HEADLESS
@@ -250,26 +260,81 @@ void CFarTextureHandler::Queue(const CSolidObject* obj)
 	if (!fbo.IsValid())
 		return;
 
+	// leftovers mean UpdateQueuedIcons was budget-deferred last frame;
+	// drop them and regather this pass, the accumulated priorities no
+	// longer reflect what is on screen
+	if (createQueueFrame != globalRendering->drawFrame) {
+		createQueueFrame = globalRendering->drawFrame;
+		createQueue.clear();
+	}
+
 	if (HaveFarIcon(obj)) {
 		renderQueue.push_back(obj);
 		return;
 	}
 
-	// limit the number of objects batch-processed this frame
-	if (createQueue.size() == MAX_CREATE_QUEUE_SIZE)
-		return;
+	// screen-space error estimate: projected size of the object, so the
+	// icons whose absence is most visible get created first
+	const float distSq = std::max(1.0f, (obj->drawPos - camera->GetPos()).SqLength());
+	const float ssError = Square(obj->GetDrawRadius()) / distSq;
+
+	// aggregate requests for the same (team, model) icon; thousands of
+	// identical units must count as one creation, not fill up a queue
+	for (CreateRequest& req: createQueue) {
+		if (req.teamID == obj->team && req.modelID == obj->model->id) {
+			req.priority += ssError;
+			renderQueue.push_back(obj);
+			return;
+		}
+	}
 
-	createQueue.push_back(obj);
+	createQueue.push_back({obj->GetBlockingMapID(), obj->team, obj->model->id, ssError});
 	renderQueue.push_back(obj);
 }
 
 
-void CFarTextureHandler::Draw()
+void CFarTextureHandler::UpdateQueuedIcons()
 {
-	for (const CSolidObject* obj: createQueue) {
+	// runs as a (timed, so possibly deferred) dispatcher job; requests
+	// are re-resolved by ID since sim frames may have executed between
+	// the draw pass that gathered them and this call
+	if (createQueue.empty())
+		return;
+
+	// create the most sorely missed icons first; the rest of the queue
+	// is dropped and re-requested by next frame's Queue calls, their
+	// objects stay invisible (or keep a stale icon slot) until served
+	std::sort(createQueue.begin(), createQueue.end(), [](const CreateRequest& a, const CreateRequest& b) {
+		return (a.priority > b.priority);
+	});
+
+	const int maxUnits = unitHandler->MaxUnits();
+
+	for (unsigned int i = 0, n = std::min(createQueue.size(), size_t(MAX_CREATES_PER_FRAME)); i < n; i++) {
+		const CreateRequest& req = createQueue[i];
+
+		const CSolidObject* obj = nullptr;
+
+		if (req.objID < maxUnits) {
+			obj = unitHandler->GetUnit(req.objID);
+		} else {
+			obj = featureHandler->GetFeature(req.objID - maxUnits);
+		}
+
+		// deleted while queued; requesters died with it or will
+		// re-request on the next draw pass
+		if (obj == nullptr)
+			continue;
+
 		CreateFarTexture(obj);
 	}
 
+	createQueue.clear();
+}
+
+
+void CFarTextureHandler::Draw()
+{
 	// render currently queued far-icons
 	if (!renderQueue.empty()) {
 		const float3 camNorm = ((camera->GetDir() * XZVector) - (UpVector * 0.1f)).ANormalize();
@@ -297,7 +362,6 @@ void CFarTextureHandler::Draw()
 	}
 
 	renderQueue.clear();
-	createQueue.clear();
 }
 
 
@@ -21,6 +21,7 @@ public:
 	~CFarTextureHandler();
 
 	void Queue(const CSolidObject* obj);
+	void UpdateQueuedIcons();
 	void Draw();
 
 private:
@@ -44,8 +45,22 @@ private:
 		float3 texOffset;
 	};
 
+	/// pending icon creation; deduplicated per (team, model) and ordered
+	/// by accumulated screen-space error of the objects requesting it.
+	/// objects are held by blocking-map ID and re-resolved when served
+	/// since sim frames can delete them while a request sits queued
+	struct CreateRequest {
+		int objID;
+		int teamID;
+		int modelID;
+		float priority;
+	};
+
 	std::vector<const CSolidObject*> renderQueue;
-	std::vector<const CSolidObject*> createQueue;
+	std::vector<CreateRequest> createQueue;
+	/// drawFrame that filled createQueue; requests left over from an
+	/// earlier pass are dropped and regathered with fresh priorities
+	unsigned int createQueueFrame = 0;
 	std::vector< std::vector<CachedIcon> > iconCache;
 
 	FBO fbo;
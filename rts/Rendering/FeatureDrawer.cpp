@@ -17,6 +17,7 @@
 #include "Rendering/GL/myGL.h"
 #include "Rendering/GL/VertexArray.h"
 #include "Rendering/LuaObjectDrawer.h"
+#include "Rendering/OcclusionCuller.h"
 #include "Rendering/ShadowHandler.h"
 #include "Rendering/Shaders/Shader.h"
 #include "Rendering/Textures/S3OTextureHandler.h"
@@ -29,6 +30,7 @@
 #include "System/Config/ConfigHandler.h"
 #include "System/EventHandler.h"
 #include "System/myMath.h"
+#include "System/Threading/ThreadPool.h"
 
 #define DRAW_QUAD_SIZE 32
 
@@ -45,6 +47,10 @@ CONFIG(float, FeatureFadeDistance)
 .description("Distance at which features will begin to fade from view.");
 
 
+// features faded below this alpha never reach a draw pass; the
+// alpha-test would reject almost all of their fragments anyway
+static constexpr float FEATURE_MIN_DRAW_ALPHA = 0.1f;
+
 
 static bool SetFeatureDrawAlpha(
 	CFeature* f,
@@ -148,6 +154,8 @@ CFeatureDrawer::CFeatureDrawer(): CEventClient("[CFeatureDrawer]", 313373, false
 
 	modelRenderers.resize(drawQuadsX * drawQuadsY);
 	camVisDrawFrames.fill(0);
+	camFlagDrawFrames.fill(0);
+	camFlagPassStates.fill(0);
 
 	for (unsigned int n = 0; n < camVisibleQuads.size(); n++) {
 		camVisibleQuads[n].reserve(256);
@@ -236,10 +244,13 @@ void CFeatureDrawer::UpdateDrawQuad(CFeature* feature)
 
 void CFeatureDrawer::Update()
 {
-	for (CFeature* f: unsortedFeatures) {
+	// independent per feature
+	for_mt(0, unsortedFeatures.size(), [this](const int i) {
+		CFeature* f = unsortedFeatures[i];
+
 		UpdateDrawPos(f);
 		SetFeatureDrawAlpha(f, nullptr);
-	}
+	});
 }
 
 
@@ -271,7 +282,7 @@ void CFeatureDrawer::Draw()
 		DrawOpaquePass(false, water->DrawReflectionPass(), water->DrawRefractionPass());
 	}
 
-	farTextureHandler->Draw();
+	DrawFarFeatures();
 
 	glDisable(GL_TEXTURE_2D);
 	glDisable(GL_FOG);
@@ -311,11 +322,12 @@ void CFeatureDrawer::DrawOpaqueFeatures(int modelType)
 			CUnitDrawer::BindModelTypeTexture(modelType, binElem.first);
 
 			for (CFeature* f: binElem.second) {
-				// fartex, opaque, shadow are allowed here
+				// opaque and shadow are allowed here; fartex-flagged
+				// features are queued in one sweep by DrawFarFeatures
 				switch (f->drawFlag) {
-					case CFeature::FD_NODRAW_FLAG: {                              continue; } break;
-					case CFeature::FD_ALPHAF_FLAG: {                              continue; } break;
-					case CFeature::FD_FARTEX_FLAG: { farTextureHandler->Queue(f); continue; } break;
+					case CFeature::FD_NODRAW_FLAG: { continue; } break;
+					case CFeature::FD_ALPHAF_FLAG: { continue; } break;
+					case CFeature::FD_FARTEX_FLAG: { continue; } break;
 					default: {} break;
 				}
 
@@ -336,6 +348,38 @@ void CFeatureDrawer::DrawOpaqueFeatures(int modelType)
 	}
 }
 
+void CFeatureDrawer::DrawFarFeatures()
+{
+	// queue impostors for all fartex-flagged features in one sweep, so
+	// neither opaque bin loop (forward or deferred) does any per-feature
+	// far work and each icon is requested exactly once per frame; these
+	// all end up in a single atlas-textured vertex array
+	const auto& quads = camVisibleQuads[(CCamera::GetActiveCamera())->GetCamType()];
+
+	for (int quad: quads) {
+		const auto& mdlRenderProxy = modelRenderers[quad];
+
+		if (mdlRenderProxy.GetLastDrawFrame() < globalRendering->drawFrame)
+			continue;
+
+		for (int modelType = MODELTYPE_3DO; modelType < MODELTYPE_OTHER; modelType++) {
+			const auto mdlRenderer = mdlRenderProxy.GetRenderer(modelType);
+			const auto& featureBin = mdlRenderer->GetFeatureBin();
+
+			for (const auto& binElem: featureBin) {
+				for (CFeature* f: binElem.second) {
+					if (f->drawFlag != CFeature::FD_FARTEX_FLAG)
+						continue;
+
+					farTextureHandler->Queue(f);
+				}
+			}
+		}
+	}
+
+	farTextureHandler->Draw();
+}
+
 bool CFeatureDrawer::CanDrawFeature(const CFeature* feature) const
 {
 	if (feature->noDraw)
@@ -346,7 +390,7 @@ bool CFeatureDrawer::CanDrawFeature(const CFeature* feature) const
 		return false;
 
 	// same cutoff as AT; set during SP too
-	if (feature->drawAlpha <= 0.1f)
+	if (feature->drawAlpha <= FEATURE_MIN_DRAW_ALPHA)
 		return false;
 
 	// either PLAYER or SHADOW or UWREFL
@@ -608,9 +652,19 @@ void CFeatureDrawer::FlagVisibleFeatures(
 
 	const CCamera* playerCam = CCamera::GetCamera(CCamera::CAMTYPE_PLAYER);
 
-	for (unsigned int n = 0; n < quads.size(); n++) {
+	// the occlusion queries are only valid for the view they were
+	// issued from (the quad indices of both systems map 1:1)
+	const bool testOcclusion =
+		(cam->GetCamType() == CCamera::CAMTYPE_PLAYER) &&
+		(occlusionCuller != nullptr && occlusionCuller->Enabled());
+
+	// every feature lives in exactly one quad and flagging only writes
+	// per-feature state, so the quads can be flagged concurrently
+	for_mt(0, quads.size(), [&](const int n) {
 		auto& mdlRenderProxy = featureDrawer->modelRenderers[ quads[n] ];
 
+		const bool quadOccluded = (testOcclusion && !occlusionCuller->QuadVisible(quads[n]));
+
 		for (int i = 0; i < MODELTYPE_OTHER; ++i) {
 			auto mdlRenderer = mdlRenderProxy.GetRenderer(i);
 			auto& featureBin = mdlRenderer->GetFeatureBinMutable();
@@ -632,10 +686,15 @@ void CFeatureDrawer::FlagVisibleFeatures(
 					if (!gu->spectatingFullView && !f->IsInLosForAllyTeam(gu->myAllyTeam))
 						continue;
 
+					// terrain-occluded last frame; the sphere test lets
+					// features poking above the quad's query box through
+					if (quadOccluded && !occlusionCuller->SphereVisible(f->drawMidPos, f->GetDrawRadius()))
+						continue;
+
 
 					if (drawShadowPass) {
-						if (SetFeatureDrawAlpha(f, playerCam, sqFadeDistBegin, sqFadeDistEnd)) {
-							// no shadows for fully alpha-faded features from player's POV
+						// no shadows for (almost) fully alpha-faded features from player's POV
+						if (SetFeatureDrawAlpha(f, playerCam, sqFadeDistBegin, sqFadeDistEnd) && f->drawAlpha > FEATURE_MIN_DRAW_ALPHA) {
 							f->UpdateTransform(f->drawPos, false);
 							f->drawFlag = CFeature::FD_SHADOW_FLAG;
 						}
@@ -650,6 +709,11 @@ void CFeatureDrawer::FlagVisibleFeatures(
 
 
 					if (SetFeatureDrawAlpha(f, cam, sqFadeDistBegin, sqFadeDistEnd)) {
+						// leave (almost) fully-faded features marked FD_NODRAW so
+						// the alpha pass never visits them
+						if (f->drawAlpha <= FEATURE_MIN_DRAW_ALPHA)
+							continue;
+
 						f->UpdateTransform(f->drawPos, false);
 						f->drawFlag += (CFeature::FD_OPAQUE_FLAG * (f->drawAlpha == 1.0f));
 						f->drawFlag += (CFeature::FD_ALPHAF_FLAG * (f->drawAlpha <  1.0f));
@@ -663,7 +727,7 @@ void CFeatureDrawer::FlagVisibleFeatures(
 				}
 			}
 		}
-	}
+	});
 }
 
 void CFeatureDrawer::GetVisibleFeatures(CCamera* cam, int extraSize, bool drawFar)
@@ -671,6 +735,15 @@ void CFeatureDrawer::GetVisibleFeatures(CCamera* cam, int extraSize, bool drawFa
 	// should only ever be called for the first three types
 	assert(cam->GetCamType() < camVisDrawFrames.size());
 
+	const bool drawReflection = water->DrawReflectionPass();
+	const bool drawRefraction = water->DrawRefractionPass();
+
+	const unsigned int passStateBits =
+		(1u * inShadowPass  ) +
+		(2u * drawReflection) +
+		(4u * drawRefraction) +
+		(8u * drawFar       );
+
 	// check if we already did a pass for this camera-type
 	// (e.g. water refraction and the standard opaque pass
 	// use CAMTYPE_PLAYER with equal state)
@@ -678,11 +751,22 @@ void CFeatureDrawer::GetVisibleFeatures(CCamera* cam, int extraSize, bool drawFa
 	// refraction pass needs to skip features that are not
 	// in water, etc.
 	if (camVisDrawFrames[cam->GetCamType()] >= globalRendering->drawFrame) {
-		FlagVisibleFeatures(cam, inShadowPass, water->DrawReflectionPass(), water->DrawRefractionPass(), drawFar);
+		// if the flagging state is also unchanged (opaque, deferred and
+		// alpha all flag identically) the markers are still valid, skip
+		// even the re-flag
+		if (camFlagDrawFrames[cam->GetCamType()] >= globalRendering->drawFrame && camFlagPassStates[cam->GetCamType()] == passStateBits)
+			return;
+
+		camFlagDrawFrames[cam->GetCamType()] = globalRendering->drawFrame;
+		camFlagPassStates[cam->GetCamType()] = passStateBits;
+
+		FlagVisibleFeatures(cam, inShadowPass, drawReflection, drawRefraction, drawFar);
 		return;
 	}
 
 	camVisDrawFrames[cam->GetCamType()] = globalRendering->drawFrame;
+	camFlagDrawFrames[cam->GetCamType()] = globalRendering->drawFrame;
+	camFlagPassStates[cam->GetCamType()] = passStateBits;
 
 	camVisibleQuads[cam->GetCamType()].clear();
 	camVisibleQuads[cam->GetCamType()].reserve(256);
@@ -700,5 +784,5 @@ void CFeatureDrawer::GetVisibleFeatures(CCamera* cam, int extraSize, bool drawFa
 		(drawer.GetRdrProxies()).swap(featureDrawer->modelRenderers);
 	}
 
-	FlagVisibleFeatures(cam, inShadowPass, water->DrawReflectionPass(), water->DrawRefractionPass(), drawFar);
+	FlagVisibleFeatures(cam, inShadowPass, drawReflection, drawRefraction, drawFar);
 }
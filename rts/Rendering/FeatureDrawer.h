@@ -132,6 +132,10 @@ private:
 	std::vector<RdrContProxy> modelRenderers;
 	std::array< std::vector<int>, CCamera::CAMTYPE_ENVMAP> camVisibleQuads;
 	std::array<unsigned int, CCamera::CAMTYPE_ENVMAP> camVisDrawFrames;
+	// drawFrame and pass-state bits of the last FlagVisibleFeatures call
+	// per camera-type; lets the alpha pass reuse the opaque pass markers
+	std::array<unsigned int, CCamera::CAMTYPE_ENVMAP> camFlagDrawFrames;
+	std::array<unsigned int, CCamera::CAMTYPE_ENVMAP> camFlagPassStates;
 	std::vector<CFeature*> unsortedFeatures;
 
 	GL::GeometryBuffer* geomBuffer;
@@ -90,6 +90,9 @@ public:
 	float GetLineHeight() const { return lineHeight; }
 	float GetDescender() const { return fontDescender; }
 	int GetTexture() const { return texture; }
+	//< bumped whenever glyphs are added to the atlas, i.e. whenever
+	//< texture size and/or glyph texcoords may have changed
+	int GetTextureUpdateNum() const { return curTextureUpdate; }
 	const std::string& GetFamily()   const { return fontFamily; }
 	const std::string& GetStyle()    const { return fontStyle; }
 
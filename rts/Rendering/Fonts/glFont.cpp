@@ -41,6 +41,7 @@ static const float darkLuminosity = 0.05 +
 CglFont::CglFont(const std::string& fontfile, int size, int _outlinewidth, float _outlineweight)
 : CTextWrap(fontfile,size,_outlinewidth,_outlineweight)
 , fontPath(fontfile)
+, layoutCacheUpdateNum(-1)
 , inBeginEnd(false)
 , autoOutlineColor(true)
 , setColor(false)
@@ -542,126 +543,128 @@ void CglFont::End()
 /*******************************************************************************/
 /*******************************************************************************/
 
-void CglFont::RenderString(float x, float y, const float& scaleX, const float& scaleY, const std::string& str)
+/**
+ * like SkipColorCodesAndNewLines, but reports the *kind* of the last
+ * color event instead of resolving it against the current base color,
+ * so cached layouts can re-apply colors under any later base color
+ */
+template <typename T>
+static inline bool ScanColorCodesAndNewLines(const std::u8string& text, T* pos, float4* rgb, int* colorEvent, int* skippedLines)
 {
-	/**
-	 * NOTE:
-	 * Font rendering does not use display lists, but VAs. It's actually faster
-	 * (450% faster with a 7600GT!) for these reasons:
-	 *
-	 * 1. When using DLs, we can not group multiple glyphs into one glBegin/End pair
-	 *    because glTranslatef can not go between such a pair.
-	 * 2. We can now eliminate all glPushMatrix/PopMatrix pairs related to font rendering
-	 *    because the transformations are calculated on the fly. These are just a couple of
-	 *    floating point multiplications and shouldn't be too expensive.
-	 */
-
-	const std::u8string& ustr = toustring(str);
-
-	const float startx = x;
-	const float lineHeight_ = scaleY * GetLineHeight();
-	const size_t length = str.length();
-
-	va.EnlargeArrays(length * 4, 0, VA_SIZE_2DT);
-
-	int i = 0;
-	int skippedLines = 0;
-	bool colorChanged = false;
-
-	// NOTE:
-	//   we need to keep track of the current and previous *characters*
-	//   rather than glyph *pointers*, because the previous-pointer can
-	//   become dangling as a result of GetGlyph calls
-	char32_t cc = 0;
-	char32_t pc = 0;
+	const size_t length = text.length();
+	(*colorEvent) = CglFont::COLOR_EVENT_NONE;
+	(*skippedLines) = 0;
+	while (*pos < length) {
+		const char8_t& chr = text[*pos];
+		switch(chr) {
+			case CglFont::ColorCodeIndicator:
+				*pos += 4;
+				if ((*pos) < length) {
+					(*rgb)[0] = text[(*pos) - 3] / 255.0f;
+					(*rgb)[1] = text[(*pos) - 2] / 255.0f;
+					(*rgb)[2] = text[(*pos) - 1] / 255.0f;
+					*colorEvent = CglFont::COLOR_EVENT_CODE;
+				}
+				break;
 
-	float4 newColor = textColor;
+			case CglFont::ColorResetIndicator:
+				(*pos)++;
+				*colorEvent = CglFont::COLOR_EVENT_RESET;
+				break;
 
-	do {
-		// check for end-of-string
-		if (SkipColorCodesAndNewLines(ustr, &i, &newColor, &colorChanged, &skippedLines, &baseTextColor))
-			return;
+			case 0x0d: // CR
+				(*skippedLines)++;
+				(*pos)++;
+				if (*pos < length && text[*pos] == 0x0a) { // CR+LF
+					(*pos)++;
+				}
+				break;
 
-		cc = utf8::GetNextChar(str, i);
+			case 0x0a: // LF
+				(*skippedLines)++;
+				(*pos)++;
+				break;
 
-		if (colorChanged) {
-			if (autoOutlineColor) {
-				SetColors(&newColor, nullptr);
-			} else {
-				SetTextColor(&newColor);
-			}
+			default:
+				return false;
 		}
+	}
+	return true;
+}
 
 
-		const GlyphInfo* cg = &GetGlyph(cc);
-		const GlyphInfo* pg = nullptr;
-
-		if (skippedLines > 0) {
-			x  = startx;
-			y -= (skippedLines * lineHeight_);
-		} else if (pc != 0) {
-			pg = &GetGlyph(pc);
-			x += (scaleX * GetKerning(*pg, *cg));
-		}
+const CglFont::CachedLayout& CglFont::GetCachedLayout(const std::string& str, float scaleX, float scaleY, int type)
+{
+	// glyph texcoords are absolute texels and can move whenever the
+	// atlas picks up new glyphs, so any atlas change invalidates all
+	// cached layouts; also just start over when the cache fills up
+	// (one screen of text repopulates it within a frame)
+	if (layoutCacheUpdateNum != GetTextureUpdateNum() || layoutCache.size() >= 2048) {
+		layoutCacheUpdateNum = GetTextureUpdateNum();
+		layoutCache.clear();
+	}
 
-		pg = cg;
-		pc = cc;
+	LayoutCacheKey key;
+	key.text = str;
+	key.scaleX = scaleX;
+	key.scaleY = scaleY;
+	key.type = type;
 
+	CachedLayout& layout = layoutCache[key];
 
-		const auto&  tc = pg->texCord;
-		const float dx0 = (scaleX * pg->size.x0()) + x, dy0 = (scaleY * pg->size.y0()) + y;
-		const float dx1 = (scaleX * pg->size.x1()) + x, dy1 = (scaleY * pg->size.y1()) + y;
+	// BuildLayout always records at least one run
+	if (layout.runs.empty())
+		BuildLayout(layout, scaleX, scaleY, type, str);
 
-		va.AddVertexQ2dT(dx0, dy1, tc.x0(), tc.y1());
-		va.AddVertexQ2dT(dx0, dy0, tc.x0(), tc.y0());
-		va.AddVertexQ2dT(dx1, dy0, tc.x1(), tc.y0());
-		va.AddVertexQ2dT(dx1, dy1, tc.x1(), tc.y1());
-	} while (true);
+	return layout;
 }
 
 
-void CglFont::RenderStringShadow(float x, float y, const float& scaleX, const float& scaleY, const std::string& str)
+void CglFont::BuildLayout(CachedLayout& layout, float scaleX, float scaleY, int type, const std::string& str)
 {
-	#if 0
-	RenderString(x, y, scaleX, scaleY, str);
-	return;
-	#endif
-
 	const std::u8string& ustr = toustring(str);
 
-	const float startx = x;
-	const float shiftX = scaleX * 0.1;
-	const float shiftY = scaleY * 0.1;
 	const float ssX = (scaleX / fontSize) * GetOutlineWidth();
 	const float ssY = (scaleY / fontSize) * GetOutlineWidth();
+	const float shadowShiftX = scaleX * 0.1f;
+	const float shadowShiftY = scaleY * 0.1f;
 	const float lineHeight_ = scaleY * GetLineHeight();
-	const size_t length = str.length();
 
-	va.EnlargeArrays(length * 4, 0, VA_SIZE_2DT);
-	va2.EnlargeArrays(length * 4, 0, VA_SIZE_2DT);
+	float x = 0.0f;
+	float y = 0.0f;
 
 	int i = 0;
 	int skippedLines = 0;
-	bool colorChanged = false;
 
+	// NOTE:
+	//   we need to keep track of the current and previous *characters*
+	//   rather than glyph *pointers*, because the previous-pointer can
+	//   become dangling as a result of GetGlyph calls
 	char32_t cc = 0;
 	char32_t pc = 0;
 
-	float4 newColor = textColor;
+	LayoutRun run;
+	run.colorEvent = COLOR_EVENT_NONE;
+	run.numQuads = 0;
+	run.numLayerQuads = 0;
 
 	do {
+		float4 rgb;
+		int colorEvent = COLOR_EVENT_NONE;
+
 		// check for end-of-string
-		if (SkipColorCodesAndNewLines(ustr, &i, &newColor, &colorChanged, &skippedLines, &baseTextColor))
-			return;
+		if (ScanColorCodesAndNewLines(ustr, &i, &rgb, &colorEvent, &skippedLines))
+			break;
 
 		cc = utf8::GetNextChar(str, i);
 
-		if (colorChanged) {
-			if (autoOutlineColor) {
-				SetColors(&newColor, nullptr);
-			} else {
-				SetTextColor(&newColor);
-			}
+		if (colorEvent != COLOR_EVENT_NONE) {
+			// close the current run at this quad boundary
+			layout.runs.push_back(run);
+			run.colorEvent = colorEvent;
+			run.rgb = rgb;
+			run.numQuads = 0;
+			run.numLayerQuads = 0;
 		}
 
 
@@ -669,7 +672,7 @@ void CglFont::RenderStringShadow(float x, float y, const float& scaleX, const fl
 		const GlyphInfo* pg = nullptr;
 
 		if (skippedLines > 0) {
-			x  = startx;
+			x  = 0.0f;
 			y -= (skippedLines * lineHeight_);
 		} else if (pc != 0) {
 			pg = &GetGlyph(pc);
@@ -685,55 +688,64 @@ void CglFont::RenderStringShadow(float x, float y, const float& scaleX, const fl
 		const float dx0 = (scaleX * pg->size.x0()) + x, dy0 = (scaleY * pg->size.y0()) + y;
 		const float dx1 = (scaleX * pg->size.x1()) + x, dy1 = (scaleY * pg->size.y1()) + y;
 
-		// draw shadow
-		va2.AddVertexQ2dT(dx0 + shiftX - ssX, dy1 - shiftY - ssY, stc.x0(), stc.y1());
-		va2.AddVertexQ2dT(dx0 + shiftX - ssX, dy0 - shiftY + ssY, stc.x0(), stc.y0());
-		va2.AddVertexQ2dT(dx1 + shiftX + ssX, dy0 - shiftY + ssY, stc.x1(), stc.y0());
-		va2.AddVertexQ2dT(dx1 + shiftX + ssX, dy1 - shiftY - ssY, stc.x1(), stc.y1());
-
-		// draw the actual character
-		va.AddVertexQ2dT(dx0, dy1, tc.x0(), tc.y1());
-		va.AddVertexQ2dT(dx0, dy0, tc.x0(), tc.y0());
-		va.AddVertexQ2dT(dx1, dy0, tc.x1(), tc.y0());
-		va.AddVertexQ2dT(dx1, dy1, tc.x1(), tc.y1());
-	} while (true);
-}
-
-void CglFont::RenderStringOutlined(float x, float y, const float& scaleX, const float& scaleY, const std::string& str)
-{
-	#if 0
-	RenderString(x, y, scaleX, scaleY, str);
-	return;
-	#endif
+		if (type == LAYOUT_SHADOW) {
+			layout.layerQuads.push_back({
+				dx0 + shadowShiftX - ssX, dy0 - shadowShiftY + ssY,
+				dx1 + shadowShiftX + ssX, dy1 - shadowShiftY - ssY,
+				stc.x0(), stc.y0(), stc.x1(), stc.y1()
+			});
+			run.numLayerQuads++;
+		} else if (type == LAYOUT_OUTLINED) {
+			layout.layerQuads.push_back({
+				dx0 - ssX, dy0 + ssY,
+				dx1 + ssX, dy1 - ssY,
+				stc.x0(), stc.y0(), stc.x1(), stc.y1()
+			});
+			run.numLayerQuads++;
+		}
 
-	const std::u8string& ustr = toustring(str);
+		layout.quads.push_back({
+			dx0, dy0,
+			dx1, dy1,
+			tc.x0(), tc.y0(), tc.x1(), tc.y1()
+		});
+		run.numQuads++;
+	} while (true);
 
-	const float startx = x;
-	const float shiftX = (scaleX / fontSize) * GetOutlineWidth();
-	const float shiftY = (scaleY / fontSize) * GetOutlineWidth();
-	const float lineHeight_ = scaleY * GetLineHeight();
-	const size_t length = str.length();
+	layout.runs.push_back(run);
+}
 
-	va.EnlargeArrays(length * 4, 0, VA_SIZE_2DT);
-	va2.EnlargeArrays(length * 4, 0, VA_SIZE_2DT);
 
-	int i = 0;
-	int skippedLines = 0;
-	bool colorChanged = false;
+void CglFont::AppendLayout(const CachedLayout& layout, float x, float y)
+{
+	/**
+	 * NOTE:
+	 * Font rendering does not use display lists, but VAs. It's actually faster
+	 * (450% faster with a 7600GT!) for these reasons:
+	 *
+	 * 1. When using DLs, we can not group multiple glyphs into one glBegin/End pair
+	 *    because glTranslatef can not go between such a pair.
+	 * 2. We can now eliminate all glPushMatrix/PopMatrix pairs related to font rendering
+	 *    because the transformations are calculated on the fly. These are just a couple of
+	 *    floating point multiplications and shouldn't be too expensive.
+	 */
 
-	char32_t cc = 0;
-	char32_t pc = 0;
+	va.EnlargeArrays(layout.quads.size() * 4, 0, VA_SIZE_2DT);
 
-	float4 newColor = textColor;
+	if (!layout.layerQuads.empty())
+		va2.EnlargeArrays(layout.layerQuads.size() * 4, 0, VA_SIZE_2DT);
 
-	do {
-		// check for end-of-string
-		if (SkipColorCodesAndNewLines(ustr, &i, &newColor, &colorChanged, &skippedLines, &baseTextColor))
-			return;
+	size_t qi = 0;
+	size_t li = 0;
 
-		cc = utf8::GetNextChar(str, i);
+	for (const LayoutRun& run: layout.runs) {
+		if (run.colorEvent != COLOR_EVENT_NONE) {
+			// inlined codes only ever set rgb, so the alpha channel
+			// always traces back to the base color of this glPrint
+			const float4 newColor = (run.colorEvent == COLOR_EVENT_RESET)?
+				baseTextColor:
+				float4(run.rgb[0], run.rgb[1], run.rgb[2], baseTextColor[3]);
 
-		if (colorChanged) {
 			if (autoOutlineColor) {
 				SetColors(&newColor, nullptr);
 			} else {
@@ -741,39 +753,41 @@ void CglFont::RenderStringOutlined(float x, float y, const float& scaleX, const
 			}
 		}
 
+		for (unsigned int n = 0; n < run.numLayerQuads; n++, li++) {
+			const LayoutQuad& q = layout.layerQuads[li];
 
-		const GlyphInfo* cg = &GetGlyph(cc);
-		const GlyphInfo* pg = nullptr;
+			va2.AddVertexQ2dT(x + q.x0, y + q.y1, q.s0, q.t1);
+			va2.AddVertexQ2dT(x + q.x0, y + q.y0, q.s0, q.t0);
+			va2.AddVertexQ2dT(x + q.x1, y + q.y0, q.s1, q.t0);
+			va2.AddVertexQ2dT(x + q.x1, y + q.y1, q.s1, q.t1);
+		}
 
-		if (skippedLines > 0) {
-			x  = startx;
-			y -= (skippedLines * lineHeight_);
-		} else if (pc != 0) {
-			pg = &GetGlyph(pc);
-			x += (scaleX * GetKerning(*pg, *cg));
+		for (unsigned int n = 0; n < run.numQuads; n++, qi++) {
+			const LayoutQuad& q = layout.quads[qi];
+
+			va.AddVertexQ2dT(x + q.x0, y + q.y1, q.s0, q.t1);
+			va.AddVertexQ2dT(x + q.x0, y + q.y0, q.s0, q.t0);
+			va.AddVertexQ2dT(x + q.x1, y + q.y0, q.s1, q.t0);
+			va.AddVertexQ2dT(x + q.x1, y + q.y1, q.s1, q.t1);
 		}
+	}
+}
 
-		pg = cg;
-		pc = cc;
 
+void CglFont::RenderString(float x, float y, const float& scaleX, const float& scaleY, const std::string& str)
+{
+	AppendLayout(GetCachedLayout(str, scaleX, scaleY, LAYOUT_PLAIN), x, y);
+}
 
-		const auto&  tc = pg->texCord;
-		const auto& stc = pg->shadowTexCord;
-		const float dx0 = (scaleX * pg->size.x0()) + x, dy0 = (scaleY * pg->size.y0()) + y;
-		const float dx1 = (scaleX * pg->size.x1()) + x, dy1 = (scaleY * pg->size.y1()) + y;
 
-		// draw outline
-		va2.AddVertexQ2dT(dx0 - shiftX, dy1 - shiftY, stc.x0(), stc.y1());
-		va2.AddVertexQ2dT(dx0 - shiftX, dy0 + shiftY, stc.x0(), stc.y0());
-		va2.AddVertexQ2dT(dx1 + shiftX, dy0 + shiftY, stc.x1(), stc.y0());
-		va2.AddVertexQ2dT(dx1 + shiftX, dy1 - shiftY, stc.x1(), stc.y1());
-
-		// draw the actual character
-		va.AddVertexQ2dT(dx0, dy1, tc.x0(), tc.y1());
-		va.AddVertexQ2dT(dx0, dy0, tc.x0(), tc.y0());
-		va.AddVertexQ2dT(dx1, dy0, tc.x1(), tc.y0());
-		va.AddVertexQ2dT(dx1, dy1, tc.x1(), tc.y1());
-	} while (true);
+void CglFont::RenderStringShadow(float x, float y, const float& scaleX, const float& scaleY, const std::string& str)
+{
+	AppendLayout(GetCachedLayout(str, scaleX, scaleY, LAYOUT_SHADOW), x, y);
+}
+
+void CglFont::RenderStringOutlined(float x, float y, const float& scaleX, const float& scaleY, const std::string& str)
+{
+	AppendLayout(GetCachedLayout(str, scaleX, scaleY, LAYOUT_OUTLINED), x, y);
 }
 
 
@@ -12,6 +12,7 @@
 #include "Rendering/GL/VertexArray.h"
 #include "System/float4.h"
 #include "System/Threading/SpringThreading.h"
+#include "System/UnorderedMap.hpp"
 
 #undef GetCharWidth // winapi.h
 
@@ -84,6 +85,12 @@ public:
 	static const char8_t ColorCodeIndicator  = 0xFF;
 	static const char8_t ColorResetIndicator = 0x08; //! =: '\\b'
 	static bool threadSafety;
+
+	enum {
+		COLOR_EVENT_NONE  = 0, //! run continues with the previous color
+		COLOR_EVENT_CODE  = 1, //! run starts with an inlined colorcode
+		COLOR_EVENT_RESET = 2, //! run starts with a ColorResetIndicator
+	};
 private:
 	static const float4* ChooseOutlineColor(const float4& textColor);
 
@@ -91,6 +98,59 @@ private:
 	void RenderStringShadow(float x, float y, const float& scaleX, const float& scaleY, const std::string& str);
 	void RenderStringOutlined(float x, float y, const float& scaleX, const float& scaleY, const std::string& str);
 
+private:
+	enum {
+		LAYOUT_PLAIN    = 0,
+		LAYOUT_SHADOW   = 1,
+		LAYOUT_OUTLINED = 2,
+	};
+
+	//! one glyph (or decoration) quad in baseline-origin space
+	struct LayoutQuad {
+		float x0, y0, x1, y1;
+		float s0, t0, s1, t1;
+	};
+	//! consecutive quads sharing one text color
+	struct LayoutRun {
+		float4 rgb; //! only used by COLOR_EVENT_CODE, alpha ignored
+		int colorEvent;
+		unsigned int numQuads;
+		unsigned int numLayerQuads;
+	};
+	//! layout of one string; geometry is cached relative to the
+	//! baseline origin and translated on submission, colors are
+	//! re-applied from the recorded runs so the same entry works
+	//! under any caller-set base color
+	struct CachedLayout {
+		std::vector<LayoutQuad> quads;      //! glyph quads (va)
+		std::vector<LayoutQuad> layerQuads; //! shadow/outline quads (va2)
+		std::vector<LayoutRun> runs;
+	};
+
+	struct LayoutCacheKey {
+		std::string text;
+		float scaleX;
+		float scaleY;
+		int type;
+
+		bool operator == (const LayoutCacheKey& k) const {
+			return (type == k.type) && (scaleX == k.scaleX) && (scaleY == k.scaleY) && (text == k.text);
+		}
+	};
+	struct LayoutCacheKeyHash {
+		size_t operator () (const LayoutCacheKey& k) const {
+			size_t h = std::hash<std::string>()(k.text);
+			h ^= std::hash<float>()(k.scaleX) + 0x9e3779b9 + (h << 6) + (h >> 2);
+			h ^= std::hash<float>()(k.scaleY) + 0x9e3779b9 + (h << 6) + (h >> 2);
+			h ^= std::hash<int>()(k.type) + 0x9e3779b9 + (h << 6) + (h >> 2);
+			return h;
+		}
+	};
+
+	const CachedLayout& GetCachedLayout(const std::string& str, float scaleX, float scaleY, int type);
+	void BuildLayout(CachedLayout& layout, float scaleX, float scaleY, int type, const std::string& str);
+	void AppendLayout(const CachedLayout& layout, float x, float y);
+
 private:
 	float GetTextWidth_(const std::u8string& text);
 	float GetTextHeight_(const std::u8string& text, float* descender = NULL, int* numLines = NULL);
@@ -109,6 +169,9 @@ private:
 	CVertexArray va;
 	CVertexArray va2;
 
+	spring::unsynced_map<LayoutCacheKey, CachedLayout, LayoutCacheKeyHash> layoutCache;
+	int layoutCacheUpdateNum;
+
 	spring::recursive_mutex vaMutex;
 
 	bool inBeginEnd;
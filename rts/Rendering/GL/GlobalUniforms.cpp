@@ -0,0 +1,107 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "GlobalUniforms.h"
+
+CGlobalUniforms globalUniforms;
+
+#if !defined(GL_ARB_uniform_buffer_object) || HEADLESS
+
+// compiled against GL headers without ARB_uniform_buffer_object; the
+// block never becomes valid and attaching programs to it is a no-op
+void CGlobalUniforms::Init() {}
+void CGlobalUniforms::Kill() {}
+void CGlobalUniforms::UpdateFrame() {}
+void CGlobalUniforms::UpdateShadow() {}
+void CGlobalUniforms::BindUniformBlock(unsigned int progID) {}
+
+#else
+
+#include "Game/Camera.h"
+#include "Map/MapInfo.h"
+#include "Rendering/GlobalRendering.h"
+#include "Rendering/ShadowHandler.h"
+#include "Sim/Misc/GlobalSynced.h"
+
+#include <cstddef>
+
+
+void CGlobalUniforms::Init()
+{
+	if (!GLEW_ARB_uniform_buffer_object)
+		return;
+
+	ubo.Bind(GL_UNIFORM_BUFFER);
+	ubo.New(sizeof(BlockData), GL_DYNAMIC_DRAW);
+	ubo.Unbind();
+
+	// the block contents are identical for every program, so the
+	// buffer stays attached to its binding point permanently
+	glBindBufferBase(GL_UNIFORM_BUFFER, BINDING_POINT, ubo.GetId());
+
+	valid = true;
+}
+
+void CGlobalUniforms::Kill()
+{
+	if (!valid)
+		return;
+
+	glBindBufferBase(GL_UNIFORM_BUFFER, BINDING_POINT, 0);
+
+	ubo = VBO();
+	valid = false;
+}
+
+
+void CGlobalUniforms::UpdateFrame()
+{
+	if (!valid)
+		return;
+
+	const CCamera* cam = CCamera::GetCamera(CCamera::CAMTYPE_PLAYER);
+
+	data.viewMatrix = cam->GetViewMatrix();
+	data.projMatrix = cam->GetProjectionMatrix();
+	data.viewProjMatrix = cam->GetViewProjectionMatrix();
+	data.cameraPos = float4(cam->GetPos(), gs->frameNum + globalRendering->timeOffset);
+	data.cameraDir = float4(cam->GetDir(), 0.0f);
+
+	const float fogStart = mapInfo->atmosphere.fogStart * globalRendering->viewRange;
+	const float fogEnd   = mapInfo->atmosphere.fogEnd   * globalRendering->viewRange;
+
+	data.fogColor = mapInfo->atmosphere.fogColor;
+	data.fogParams = float4(fogStart, fogEnd, 1.0f / std::max(fogEnd - fogStart, 1.0f), 0.0f);
+
+	ubo.Bind(GL_UNIFORM_BUFFER);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, offsetof(BlockData, shadowMatrix), &data);
+	ubo.Unbind();
+}
+
+void CGlobalUniforms::UpdateShadow()
+{
+	if (!valid)
+		return;
+
+	data.shadowMatrix = shadowHandler->GetShadowMatrix();
+	data.shadowParams = shadowHandler->GetShadowParams();
+
+	ubo.Bind(GL_UNIFORM_BUFFER);
+	glBufferSubData(GL_UNIFORM_BUFFER, offsetof(BlockData, shadowMatrix), sizeof(BlockData) - offsetof(BlockData, shadowMatrix), &data.shadowMatrix);
+	ubo.Unbind();
+}
+
+
+void CGlobalUniforms::BindUniformBlock(unsigned int progID)
+{
+	if (!GLEW_ARB_uniform_buffer_object)
+		return;
+
+	const GLuint blockIndex = glGetUniformBlockIndex(progID, "GlobalUniforms");
+
+	if (blockIndex == GL_INVALID_INDEX)
+		return;
+
+	glUniformBlockBinding(progID, blockIndex, BINDING_POINT);
+}
+
+#endif // !defined(GL_ARB_uniform_buffer_object) || HEADLESS
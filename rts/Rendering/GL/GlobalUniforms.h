@@ -0,0 +1,67 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef GL_GLOBAL_UNIFORMS_H
+#define GL_GLOBAL_UNIFORMS_H
+
+#include "Rendering/GL/myGL.h"
+#include "Rendering/GL/VBO.h"
+#include "System/Matrix44f.h"
+#include "System/float4.h"
+
+/**
+ * Per-frame uniform block shared by all shader programs; holds the
+ * camera, fog and shadow parameters every pass needs so they travel
+ * to the GPU once per frame instead of once per program. Any GLSL
+ * program (engine- or Lua-created) that declares
+ *
+ *   layout(std140) uniform GlobalUniforms { ... };
+ *
+ * with members matching BlockData is attached to the block
+ * automatically after linking.
+ */
+class CGlobalUniforms {
+public:
+	// uniform-block binding point reserved for this buffer (3, 4
+	// and 5 are claimed by DecalsDrawerGL4)
+	static const unsigned int BINDING_POINT = 6;
+
+	struct BlockData {
+		// std140; mat4 and vec4 members only, so no implicit padding
+		// (the shadow fields sit at the end such that the two update
+		// paths can upload disjoint halves of the buffer)
+		CMatrix44f viewMatrix;
+		CMatrix44f projMatrix;
+		CMatrix44f viewProjMatrix;
+		float4 cameraPos;    // xyz; w = frameNum + timeOffset
+		float4 cameraDir;    // xyz; w = unused
+		float4 fogColor;     // rgb; a = unused
+		float4 fogParams;    // x = start, y = end, z = 1 / (end - start), w = unused
+		CMatrix44f shadowMatrix;
+		float4 shadowParams; // shadowTexProjCenter
+	};
+
+	void Init();
+	void Kill();
+
+	/// upload the camera- and fog-dependent fields; called once per
+	/// draw frame after the player camera has been updated
+	void UpdateFrame();
+	/// upload the shadow-dependent fields; called once per shadow pass
+	void UpdateShadow();
+
+	bool IsValid() const { return valid; }
+
+	/// binds the block named "GlobalUniforms" in <progID> (if any) to
+	/// BINDING_POINT; called once after linking a program
+	static void BindUniformBlock(unsigned int progID);
+
+private:
+	VBO ubo;
+	BlockData data;
+
+	bool valid = false;
+};
+
+extern CGlobalUniforms globalUniforms;
+
+#endif // GL_GLOBAL_UNIFORMS_H
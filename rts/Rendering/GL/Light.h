@@ -42,11 +42,12 @@ namespace GL {
 		}
 
 		void ClearDeathDependencies() {
-			// modified by DeleteDeathDependence
-			const auto& listeningObjs = GetListening(DEPENDENCE_LIGHT);
+			// modified by DeleteDeathDependence; a light only
+			// ever registers DEPENDENCE_LIGHT links
+			const auto& listeningObjs = GetAllListening();
 
 			while (!listeningObjs.empty()) {
-				DeleteDeathDependence(listeningObjs.back(), DEPENDENCE_LIGHT);
+				DeleteDeathDependence(listeningObjs.back().obj, DEPENDENCE_LIGHT);
 			}
 		}
 
@@ -37,6 +37,15 @@ void GL::LightHandler::Init(unsigned int cfgBaseLight, unsigned int cfgMaxLights
 	}
 }
 
+void GL::LightHandler::SetPoolSize(unsigned int poolSize) {
+	// only ever grow; the first maxLights slots keep their FFP IDs,
+	// the extra ones stay at -1u and are skipped by the FFP upload
+	if (poolSize <= lights.size())
+		return;
+
+	lights.resize(poolSize);
+}
+
 
 unsigned int GL::LightHandler::AddLight(const GL::Light& light) {
 	if (light.GetTTL() == 0 || light.GetRadius() <= 0.0f)
@@ -121,13 +130,19 @@ void GL::LightHandler::Update(Shader::IProgramObject* shader) {
 	for (GL::Light& light: lights) {
 		const unsigned int lightID = light.GetID();
 
+		// lights without an FFP slot (pool-grown, deferred-only) and
+		// all lights in deferred-only mode are not communicated here
+		const bool uploadFFP = (lightID != -1u && !deferredOnly);
+
 		// dead light, ignore (but kill its contribution)
 		if (light.GetTTL() == 0) {
-			glEnable(lightID);
-			glLightfv(lightID, GL_AMBIENT,  &ZeroVector4.x);
-			glLightfv(lightID, GL_DIFFUSE,  &ZeroVector4.x);
-			glLightfv(lightID, GL_SPECULAR, &ZeroVector4.x);
-			glDisable(lightID);
+			if (uploadFFP) {
+				glEnable(lightID);
+				glLightfv(lightID, GL_AMBIENT,  &ZeroVector4.x);
+				glLightfv(lightID, GL_DIFFUSE,  &ZeroVector4.x);
+				glLightfv(lightID, GL_SPECULAR, &ZeroVector4.x);
+				glDisable(lightID);
+			}
 			continue;
 		}
 
@@ -156,7 +171,7 @@ void GL::LightHandler::Update(Shader::IProgramObject* shader) {
 		if (light.GetRelativeTime() > light.GetTTL()) {
 			// mark light as dead
 			light.SetTTL(0);
-		} else {
+		} else if (uploadFFP) {
 			// communicate properties via the FFP to save uniforms
 			// note: we want MV to be identity here
 			glEnable(lightID);
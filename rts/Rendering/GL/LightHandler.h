@@ -14,7 +14,7 @@ namespace Shader {
 namespace GL {
 	struct LightHandler {
 	public:
-		LightHandler(): baseLight(0), maxLights(0), numLights(0), lightHandle(0) {}
+		LightHandler(): baseLight(0), maxLights(0), numLights(0), lightHandle(0), deferredOnly(false) {}
 		~LightHandler() { Kill(); }
 
 		void Init(unsigned int, unsigned int);
@@ -29,6 +29,16 @@ namespace GL {
 		unsigned int GetBaseLight() const { return baseLight; }
 		unsigned int GetMaxLights() const { return maxLights; }
 
+		const std::vector<GL::Light>& GetLights() const { return lights; }
+
+		/// grow the pool beyond the FFP slot count; the extra lights
+		/// have no GL light-ID and are only picked up by the deferred
+		/// tile pass (CDeferredLightDrawer)
+		void SetPoolSize(unsigned int poolSize);
+		/// if set, Update() only decays lights and keeps all FFP slots
+		/// dark so the deferred pass is the sole source of their light
+		void SetDeferredOnly(bool b) { deferredOnly = b; }
+
 	private:
 		std::vector<GL::Light> lights;
 
@@ -36,6 +46,8 @@ namespace GL {
 		unsigned int maxLights;
 		unsigned int numLights;
 		unsigned int lightHandle;
+
+		bool deferredOnly;
 	};
 }
 
@@ -0,0 +1,123 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "PixelReadback.h"
+
+#include <cassert>
+
+
+static unsigned int PixelFormatSize(GLenum format)
+{
+	switch (format) {
+		case GL_RGBA: return 4;
+		case GL_BGRA: return 4;
+		case GL_RGB : return 3;
+		case GL_BGR : return 3;
+		default: {
+			assert(false);
+		} break;
+	}
+
+	return 4;
+}
+
+
+CPixelReadback::CPixelReadback()
+	: headSlot(0)
+	, tailSlot(0)
+{
+}
+
+CPixelReadback::~CPixelReadback()
+{
+#ifdef GLEW_ARB_sync
+	for (ReadSlot& slot: slots) {
+		if (slot.fence == nullptr)
+			continue;
+
+		glDeleteSync(GLsync(slot.fence));
+		slot.fence = nullptr;
+	}
+#endif
+}
+
+
+bool CPixelReadback::Supported() const
+{
+#ifdef GLEW_ARB_sync
+	return (GLEW_ARB_sync && VBO::IsPBOSupported());
+#else
+	return false;
+#endif
+}
+
+
+bool CPixelReadback::SubmitRead(int x, int y, int sizeX, int sizeY, GLenum format)
+{
+#ifdef GLEW_ARB_sync
+	if (!Supported())
+		return false;
+
+	// ring full; caller can ConsumeRead(true) or drop the frame
+	if ((headSlot - tailSlot) >= NUM_BUFFERS)
+		return false;
+
+	ReadSlot& slot = slots[headSlot % NUM_BUFFERS];
+	assert(slot.fence == nullptr);
+
+	const unsigned int numBytes = sizeX * sizeY * PixelFormatSize(format);
+
+	slot.buffer.Bind();
+
+	if (slot.buffer.GetSize() != numBytes)
+		slot.buffer.New(numBytes, GL_STREAM_READ);
+
+	glReadPixels(x, y, sizeX, sizeY, format, GL_UNSIGNED_BYTE, nullptr);
+
+	slot.buffer.Unbind();
+	slot.fence = (void*) glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	slot.sizeX = sizeX;
+	slot.sizeY = sizeY;
+	slot.numBytes = numBytes;
+
+	headSlot += 1;
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+bool CPixelReadback::ConsumeRead(bool block, const std::function<void(const unsigned char* data, int sizeX, int sizeY)>& readFunc)
+{
+#ifdef GLEW_ARB_sync
+	if (headSlot == tailSlot)
+		return false;
+
+	ReadSlot& slot = slots[tailSlot % NUM_BUFFERS];
+	assert(slot.fence != nullptr);
+
+	const GLuint64 timeoutNSecs = block? GLuint64(1000 * 1000 * 1000): 0;
+	const GLenum waitStatus = glClientWaitSync(GLsync(slot.fence), GL_SYNC_FLUSH_COMMANDS_BIT, timeoutNSecs);
+
+	if (waitStatus != GL_ALREADY_SIGNALED && waitStatus != GL_CONDITION_SATISFIED)
+		return false;
+
+	glDeleteSync(GLsync(slot.fence));
+	slot.fence = nullptr;
+
+	slot.buffer.Bind();
+
+	const unsigned char* data = slot.buffer.MapBuffer(GL_READ_ONLY);
+
+	if (data != nullptr)
+		readFunc(data, slot.sizeX, slot.sizeY);
+
+	slot.buffer.UnmapBuffer();
+	slot.buffer.Unbind();
+
+	tailSlot += 1;
+	return (data != nullptr);
+#else
+	return false;
+#endif
+}
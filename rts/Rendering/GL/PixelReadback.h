@@ -0,0 +1,59 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef GL_PIXEL_READBACK_H
+#define GL_PIXEL_READBACK_H
+
+#include <functional>
+
+#include "VBO.h"
+
+/**
+ * Asynchronous glReadPixels through a small ring of pixel-pack
+ * buffers. SubmitRead issues the readback into the next free ring
+ * slot and fences it; the GL call returns immediately since the
+ * driver transfers into the PBO behind the frame. ConsumeRead maps
+ * the oldest slot whose fence has signalled (typically one frame
+ * later) and hands the pixels to the caller, so neither end stalls
+ * the GPU as long as consumers keep up with NUM_BUFFERS-1 frames of
+ * latency.
+ *
+ * Falls back to unsupported (Supported() == false) without
+ * GL_ARB_sync or PBO's; callers must keep their synchronous path.
+ */
+class CPixelReadback {
+public:
+	static constexpr unsigned int NUM_BUFFERS = 3;
+
+	CPixelReadback();
+	~CPixelReadback();
+
+	bool Supported() const;
+
+	/// issues an asynchronous read of the current READ_BUFFER into
+	/// the next ring slot; fails (false) while all slots are in flight
+	bool SubmitRead(int x, int y, int sizeX, int sizeY, GLenum format);
+
+	/// maps the oldest completed readback, passes it to readFunc and
+	/// recycles the slot; false when none has finished yet (blocking
+	/// waits for the GPU instead, e.g. to drain during shutdown)
+	bool ConsumeRead(bool block, const std::function<void(const unsigned char* data, int sizeX, int sizeY)>& readFunc);
+
+	unsigned int NumPending() const { return (headSlot - tailSlot); }
+
+private:
+	struct ReadSlot {
+		VBO buffer{GL_PIXEL_PACK_BUFFER};
+		void* fence = nullptr;
+		int sizeX = 0;
+		int sizeY = 0;
+		unsigned int numBytes = 0;
+	};
+
+	ReadSlot slots[NUM_BUFFERS];
+
+	// monotonic submit/consume counters, slot index is (counter % NUM_BUFFERS)
+	unsigned int headSlot;
+	unsigned int tailSlot;
+};
+
+#endif
@@ -0,0 +1,80 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "PixelUpload.h"
+
+#include <cassert>
+
+
+CPixelUpload::CPixelUpload()
+	: headSlot(0)
+{
+}
+
+CPixelUpload::~CPixelUpload()
+{
+#ifdef GLEW_ARB_sync
+	for (UploadSlot& slot: slots) {
+		if (slot.fence == nullptr)
+			continue;
+
+		glDeleteSync(GLsync(slot.fence));
+		slot.fence = nullptr;
+	}
+#endif
+}
+
+
+bool CPixelUpload::Supported() const
+{
+#ifdef GLEW_ARB_sync
+	return (GLEW_ARB_sync && VBO::IsPBOSupported());
+#else
+	return false;
+#endif
+}
+
+
+bool CPixelUpload::Upload(int x, int y, int sizeX, int sizeY, GLenum format, GLenum type, unsigned int pixelSize, const std::function<void(unsigned char* dst)>& fillFunc)
+{
+#ifdef GLEW_ARB_sync
+	if (!Supported())
+		return false;
+
+	UploadSlot& slot = slots[headSlot % NUM_BUFFERS];
+
+	if (slot.fence != nullptr) {
+		// slot still in flight from NUM_BUFFERS uploads ago; only
+		// blocks when the GPU has fallen that many frames behind
+		glClientWaitSync(GLsync(slot.fence), GL_SYNC_FLUSH_COMMANDS_BIT, GLuint64(1000 * 1000 * 1000));
+		glDeleteSync(GLsync(slot.fence));
+		slot.fence = nullptr;
+	}
+
+	const unsigned int numBytes = sizeX * sizeY * pixelSize;
+
+	slot.buffer.Bind();
+
+	if (slot.buffer.GetSize() != numBytes)
+		slot.buffer.New(numBytes, GL_STREAM_DRAW);
+
+	unsigned char* dst = slot.buffer.MapBuffer();
+
+	if (dst == nullptr) {
+		slot.buffer.Unbind();
+		return false;
+	}
+
+	fillFunc(dst);
+
+	slot.buffer.UnmapBuffer();
+	glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, sizeX, sizeY, format, type, slot.buffer.GetPtr());
+
+	slot.buffer.Unbind();
+	slot.fence = (void*) glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	headSlot += 1;
+	return true;
+#else
+	return false;
+#endif
+}
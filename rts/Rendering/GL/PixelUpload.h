@@ -0,0 +1,50 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef GL_PIXEL_UPLOAD_H
+#define GL_PIXEL_UPLOAD_H
+
+#include <functional>
+
+#include "VBO.h"
+
+/**
+ * Asynchronous glTexSubImage2D through a small ring of pixel-unpack
+ * buffers, the upload-side counterpart of CPixelReadback. Upload maps
+ * the next ring slot, lets the caller fill it, then issues the texture
+ * update out of the PBO and fences the slot; the driver pulls the
+ * pixels behind the frame instead of copying them synchronously out
+ * of client memory. A slot is only reused once its fence has
+ * signalled, so with NUM_BUFFERS in the ring steady-state uploads
+ * never stall unless the GPU falls that many frames behind.
+ *
+ * Falls back to unsupported (Supported() == false) without
+ * GL_ARB_sync or PBO's; callers must keep their synchronous path.
+ */
+class CPixelUpload {
+public:
+	static constexpr unsigned int NUM_BUFFERS = 3;
+
+	CPixelUpload();
+	~CPixelUpload();
+
+	bool Supported() const;
+
+	/// fills the next ring slot through fillFunc (dst holds sizeX *
+	/// sizeY * pixelSize bytes, tightly packed rows) and issues the
+	/// sub-image update of the currently bound 2D texture from it;
+	/// false when unsupported, in which case nothing was uploaded
+	bool Upload(int x, int y, int sizeX, int sizeY, GLenum format, GLenum type, unsigned int pixelSize, const std::function<void(unsigned char* dst)>& fillFunc);
+
+private:
+	struct UploadSlot {
+		VBO buffer{GL_PIXEL_UNPACK_BUFFER};
+		void* fence = nullptr;
+	};
+
+	UploadSlot slots[NUM_BUFFERS];
+
+	// monotonic counter, slot index is (counter % NUM_BUFFERS)
+	unsigned int headSlot;
+};
+
+#endif
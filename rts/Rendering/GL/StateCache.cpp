@@ -0,0 +1,246 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "StateCache.h"
+#include "System/UnorderedMap.hpp"
+
+#include <cstdint>
+
+
+// shadowed enable bits, keyed by (texunit << 32 | cap) for per-unit
+// caps and by the bare cap for global ones; absent entries forward
+static spring::unsynced_map<std::uint64_t, bool> capStates;
+// shadowed texture bindings, keyed by (texunit << 32 | target)
+static spring::unsynced_map<std::uint64_t, GLuint> texBindings;
+
+static bool cacheEnabled = true;
+
+static bool blendFuncKnown = false;
+static GLenum blendSrcFactor = GL_ONE;
+static GLenum blendDstFactor = GL_ZERO;
+
+static bool depthFuncKnown = false;
+static GLenum depthFuncVal = GL_LESS;
+
+static bool depthMaskKnown = false;
+static GLboolean depthMaskVal = GL_TRUE;
+
+static bool alphaFuncKnown = false;
+static GLenum alphaFuncVal = GL_ALWAYS;
+static GLfloat alphaRefVal = 0.0f;
+
+// the active unit is itself shadowed state; until it is known all
+// per-unit caps and bindings pass through unfiltered
+static bool activeTexKnown = false;
+static GLenum activeTexVal = GL_TEXTURE0;
+
+// [0] := current frame, [1] := previous (completed) frame
+static unsigned int numIssued[2] = {0, 0};
+static unsigned int numFiltered[2] = {0, 0};
+
+
+static bool IsPerTexUnitCap(GLenum cap)
+{
+	switch (cap) {
+		case GL_TEXTURE_1D:
+		case GL_TEXTURE_2D:
+		case GL_TEXTURE_3D:
+		case GL_TEXTURE_CUBE_MAP:
+		case GL_TEXTURE_RECTANGLE_ARB:
+		case GL_TEXTURE_GEN_S:
+		case GL_TEXTURE_GEN_T:
+		case GL_TEXTURE_GEN_R:
+		case GL_TEXTURE_GEN_Q: {
+			return true;
+		} break;
+	}
+
+	return false;
+}
+
+
+static void SetCapState(GLenum cap, bool wantEnabled)
+{
+	if (!cacheEnabled) {
+		numIssued[0] += 1;
+
+		if (wantEnabled) {
+			glEnable(cap);
+		} else {
+			glDisable(cap);
+		}
+
+		return;
+	}
+
+	std::uint64_t key = cap;
+
+	if (IsPerTexUnitCap(cap)) {
+		if (!activeTexKnown) {
+			numIssued[0] += 1;
+
+			if (wantEnabled) {
+				glEnable(cap);
+			} else {
+				glDisable(cap);
+			}
+
+			return;
+		}
+
+		key |= (std::uint64_t(activeTexVal) << 32);
+	}
+
+	const auto it = capStates.find(key);
+
+	if (it != capStates.end() && it->second == wantEnabled) {
+		numFiltered[0] += 1;
+		return;
+	}
+
+	numIssued[0] += 1;
+	capStates[key] = wantEnabled;
+
+	if (wantEnabled) {
+		glEnable(cap);
+	} else {
+		glDisable(cap);
+	}
+}
+
+
+void GL::Enable(GLenum cap) { SetCapState(cap, true); }
+void GL::Disable(GLenum cap) { SetCapState(cap, false); }
+
+
+void GL::BlendFunc(GLenum srcFactor, GLenum dstFactor)
+{
+	if (cacheEnabled && blendFuncKnown && blendSrcFactor == srcFactor && blendDstFactor == dstFactor) {
+		numFiltered[0] += 1;
+		return;
+	}
+
+	numIssued[0] += 1;
+	blendFuncKnown = cacheEnabled;
+	blendSrcFactor = srcFactor;
+	blendDstFactor = dstFactor;
+	glBlendFunc(srcFactor, dstFactor);
+}
+
+void GL::BlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
+{
+	// not shadowed, but clobbers the combined factors
+	numIssued[0] += 1;
+	blendFuncKnown = false;
+	glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+}
+
+void GL::DepthFunc(GLenum func)
+{
+	if (cacheEnabled && depthFuncKnown && depthFuncVal == func) {
+		numFiltered[0] += 1;
+		return;
+	}
+
+	numIssued[0] += 1;
+	depthFuncKnown = cacheEnabled;
+	depthFuncVal = func;
+	glDepthFunc(func);
+}
+
+void GL::DepthMask(GLboolean flag)
+{
+	if (cacheEnabled && depthMaskKnown && depthMaskVal == flag) {
+		numFiltered[0] += 1;
+		return;
+	}
+
+	numIssued[0] += 1;
+	depthMaskKnown = cacheEnabled;
+	depthMaskVal = flag;
+	glDepthMask(flag);
+}
+
+void GL::AlphaFunc(GLenum func, GLfloat ref)
+{
+	if (cacheEnabled && alphaFuncKnown && alphaFuncVal == func && alphaRefVal == ref) {
+		numFiltered[0] += 1;
+		return;
+	}
+
+	numIssued[0] += 1;
+	alphaFuncKnown = cacheEnabled;
+	alphaFuncVal = func;
+	alphaRefVal = ref;
+	glAlphaFunc(func, ref);
+}
+
+
+void GL::ActiveTexture(GLenum texUnit)
+{
+	if (cacheEnabled && activeTexKnown && activeTexVal == texUnit) {
+		numFiltered[0] += 1;
+		return;
+	}
+
+	numIssued[0] += 1;
+	activeTexKnown = cacheEnabled;
+	activeTexVal = texUnit;
+	glActiveTexture(texUnit);
+}
+
+void GL::BindTexture(GLenum target, GLuint texID)
+{
+	if (!cacheEnabled || !activeTexKnown) {
+		numIssued[0] += 1;
+		glBindTexture(target, texID);
+		return;
+	}
+
+	const std::uint64_t key = (std::uint64_t(activeTexVal) << 32) | target;
+	const auto it = texBindings.find(key);
+
+	if (it != texBindings.end() && it->second == texID) {
+		numFiltered[0] += 1;
+		return;
+	}
+
+	numIssued[0] += 1;
+	texBindings[key] = texID;
+	glBindTexture(target, texID);
+}
+
+
+void GL::InvalidateStateCache()
+{
+	capStates.clear();
+	texBindings.clear();
+
+	blendFuncKnown = false;
+	depthFuncKnown = false;
+	depthMaskKnown = false;
+	alphaFuncKnown = false;
+	activeTexKnown = false;
+}
+
+void GL::EnableStateCache(bool enable)
+{
+	// state compiled into a display list never executed, so the
+	// shadow copies stay valid across a pass-through section
+	cacheEnabled = enable;
+}
+
+
+unsigned int GL::GetNumStateChangesIssued() { return numIssued[1]; }
+unsigned int GL::GetNumStateChangesFiltered() { return numFiltered[1]; }
+
+
+namespace GL {
+	// called from CGlobalRendering::SwapBuffers
+	void RollStateCacheCounters()
+	{
+		numIssued[1] = numIssued[0];
+		numFiltered[1] = numFiltered[0];
+		numIssued[0] = 0;
+		numFiltered[0] = 0;
+	}
+}
@@ -0,0 +1,53 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef GL_STATE_CACHE_H
+#define GL_STATE_CACHE_H
+
+#include "Rendering/GL/myGL.h"
+
+/**
+ * Thin redundant-state filter: the functions below shadow the most
+ * frequently toggled pieces of GL state (enable bits, blend / depth /
+ * alpha funcs, texture bindings) in CPU structs and only forward
+ * calls that actually change something. Unknown state always forwards
+ * ("fails open"), so correctness only requires invalidating the
+ * shadow copies whenever tracked state may have been changed behind
+ * the cache's back (raw GL calls, glPopAttrib, display lists); this
+ * happens automatically once per frame at buffer-swap time and must
+ * be done explicitly by callers executing untracked code mid-pass.
+ *
+ * Per-texture-unit state (texture enables and bindings) is keyed on
+ * the active unit and therefore only filtered between an ActiveTexture
+ * call and the next invalidation.
+ */
+namespace GL {
+	void Enable(GLenum cap);
+	void Disable(GLenum cap);
+
+	void BlendFunc(GLenum srcFactor, GLenum dstFactor);
+	void BlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha);
+	void DepthFunc(GLenum func);
+	void DepthMask(GLboolean flag);
+	void AlphaFunc(GLenum func, GLfloat ref);
+
+	void ActiveTexture(GLenum texUnit);
+	void BindTexture(GLenum target, GLuint texID);
+
+	// forget all shadowed state; called from SwapBuffers (which also
+	// rolls the per-frame counters) and after untracked state changes
+	void InvalidateStateCache();
+
+	// pass-through mode, used while compiling display lists (calls
+	// are recorded instead of executed there, so they must neither
+	// be filtered nor update the shadow copies)
+	void EnableStateCache(bool enable);
+
+	// issued vs filtered call counts over the previous frame
+	unsigned int GetNumStateChangesIssued();
+	unsigned int GetNumStateChangesFiltered();
+
+	// snapshots the per-frame counters; called from SwapBuffers
+	void RollStateCacheCounters();
+}
+
+#endif
@@ -0,0 +1,126 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "StreamBuffer.h"
+#include "Rendering/GlobalRendering.h"
+#include "System/SafeUtil.h"
+
+static CStreamBuffer* instance = nullptr;
+
+
+CStreamBuffer* CStreamBuffer::GetInstance()
+{
+	if (instance == nullptr)
+		instance = new CStreamBuffer();
+
+	return instance;
+}
+
+void CStreamBuffer::Kill()
+{
+	spring::SafeDelete(instance);
+}
+
+
+CStreamBuffer::CStreamBuffer()
+	: buffer(GL_ARRAY_BUFFER, true)
+	, mappedPtr(nullptr)
+	, curSubBuffer(0)
+	, curDrawFrame(0)
+	, subBufferPos(0)
+{
+	std::fill(subBufferFences, subBufferFences + NUM_SUB_BUFFERS, nullptr);
+
+#if defined(GLEW_ARB_buffer_storage) && defined(GLEW_ARB_sync)
+	if (!GLEW_ARB_buffer_storage || !GLEW_ARB_sync)
+		return;
+
+	buffer.Bind();
+	buffer.New(NUM_SUB_BUFFERS * SUB_BUFFER_SIZE, GL_STREAM_DRAW);
+
+	// persistent+coherent access when the storage is immutable, which
+	// VBO::New can silently fall back from (see VBO::MapBuffer)
+	if (buffer.VBOused && buffer.immutableStorage)
+		mappedPtr = buffer.MapBuffer(0, buffer.GetSize(), GL_WRITE_ONLY);
+
+	buffer.Unbind();
+#endif
+}
+
+CStreamBuffer::~CStreamBuffer()
+{
+#if defined(GLEW_ARB_buffer_storage) && defined(GLEW_ARB_sync)
+	for (void*& fence: subBufferFences) {
+		if (fence == nullptr)
+			continue;
+
+		glDeleteSync(GLsync(fence));
+		fence = nullptr;
+	}
+
+	if (mappedPtr != nullptr) {
+		buffer.Bind();
+		buffer.UnmapBuffer();
+		buffer.Unbind();
+		mappedPtr = nullptr;
+	}
+#endif
+}
+
+
+size_t CStreamBuffer::Stream(const void* data, size_t numBytes)
+{
+#if defined(GLEW_ARB_buffer_storage) && defined(GLEW_ARB_sync)
+	if (mappedPtr == nullptr || numBytes == 0)
+		return INVALID_OFFSET;
+
+	if (globalRendering->drawFrame != curDrawFrame) {
+		curDrawFrame = globalRendering->drawFrame;
+
+		// every draw reading the finished sub-buffer has been issued,
+		// fence it and move on to the oldest one; waiting on that is
+		// rare unless the GPU is more than NUM_SUB_BUFFERS-1 frames
+		// behind
+		assert(subBufferFences[curSubBuffer] == nullptr);
+		subBufferFences[curSubBuffer] = (void*) glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+		curSubBuffer = (curSubBuffer + 1) % NUM_SUB_BUFFERS;
+		subBufferPos = 0;
+
+		void*& fence = subBufferFences[curSubBuffer];
+
+		if (fence != nullptr) {
+			glClientWaitSync(GLsync(fence), GL_SYNC_FLUSH_COMMANDS_BIT, GLuint64(1000 * 1000 * 1000));
+			glDeleteSync(GLsync(fence));
+			fence = nullptr;
+		}
+	}
+
+	// keep the offsets handed to the gl*Pointer calls aligned
+	subBufferPos = (subBufferPos + 15) & ~size_t(15);
+
+	// full; let the remaining arrays of this frame use client memory
+	if ((subBufferPos + numBytes) > SUB_BUFFER_SIZE)
+		return INVALID_OFFSET;
+
+	const size_t offset = (curSubBuffer * SUB_BUFFER_SIZE) + subBufferPos;
+
+	// coherent mapping, no explicit flush needed before the draw
+	memcpy(mappedPtr + offset, data, numBytes);
+	buffer.Bind();
+
+	subBufferPos += numBytes;
+	return offset;
+#else
+	return INVALID_OFFSET;
+#endif
+}
+
+void CStreamBuffer::Unbind()
+{
+	if (buffer.bound)
+		buffer.Unbind();
+}
@@ -0,0 +1,61 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include <cstddef>
+
+#include "VBO.h"
+
+/**
+ * @brief CStreamBuffer
+ *
+ * Fenced ring of persistently mapped sub-buffers (ARB_buffer_storage)
+ * for streaming per-frame vertex data to the driver. CVertexArray
+ * submits its finished arrays through this instead of handing the
+ * driver client-memory pointers, so every draw call no longer forces
+ * a synchronous copy of the arrays inside the driver.
+ *
+ * One sub-buffer is filled per draw-frame while those of the previous
+ * frames may still be in flight; a fence guards each sub-buffer from
+ * being overwritten before the GPU has finished reading it.
+ */
+class CStreamBuffer {
+public:
+	static const size_t INVALID_OFFSET = size_t(-1);
+
+	static CStreamBuffer* GetInstance();
+	static void Kill();
+
+	/**
+	 * copies <numBytes> of vertex data into the current sub-buffer and
+	 * leaves the backing VBO bound as GL_ARRAY_BUFFER; returns the byte
+	 * offset to use in place of the client-memory base pointer, or
+	 * INVALID_OFFSET (with nothing bound) when the data has to be drawn
+	 * from client memory after all (no driver support, sub-buffer full)
+	 */
+	size_t Stream(const void* data, size_t numBytes);
+	void Unbind();
+
+	~CStreamBuffer();
+
+private:
+	CStreamBuffer();
+
+private:
+	static const size_t SUB_BUFFER_SIZE = 8 * 1024 * 1024;
+	static const unsigned int NUM_SUB_BUFFERS = 3;
+
+	VBO buffer;
+
+	/// GLsync handles, stored untyped so the class still compiles
+	/// against headers that predate ARB_sync
+	void* subBufferFences[NUM_SUB_BUFFERS];
+	GLubyte* mappedPtr;
+
+	unsigned int curSubBuffer;
+	unsigned int curDrawFrame;
+	size_t subBufferPos;
+};
+
+#endif // STREAM_BUFFER_H
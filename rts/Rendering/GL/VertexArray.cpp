@@ -3,6 +3,7 @@
 #include <cstring>
 
 #include "VertexArray.h"
+#include "StreamBuffer.h"
 
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -108,6 +109,25 @@ static inline int GetStripStartOffset(GLenum mode)
 }
 
 
+const float* CVertexArray::BindStreamed()
+{
+	const size_t numBytes = (char*)drawArrayPos - (char*)drawArray;
+	const size_t offset = CStreamBuffer::GetInstance()->Stream(drawArray, numBytes);
+
+	// no driver support (or ring exhausted), draw from client memory
+	if (offset == CStreamBuffer::INVALID_OFFSET)
+		return drawArray;
+
+	// the gl*Pointer offsets below are relative to the bound buffer
+	return (reinterpret_cast<const float*>(0) + (offset / sizeof(float)));
+}
+
+void CVertexArray::UnbindStreamed()
+{
+	CStreamBuffer::GetInstance()->Unbind();
+}
+
+
 void CVertexArray::DrawArrays(const GLenum mode, const unsigned int stride)
 {
 	unsigned int length;
@@ -204,9 +224,12 @@ void CVertexArray::DrawArray0(const int drawType, unsigned int stride)
 		return;
 
 	CheckEndStrip();
+
+	const float* bufArray = BindStreamed();
 	glEnableClientState(GL_VERTEX_ARRAY);
-	glVertexPointer(3, GL_FLOAT, stride, drawArray);
+	glVertexPointer(3, GL_FLOAT, stride, bufArray);
 	DrawArrays(drawType, stride);
+	UnbindStreamed();
 	glDisableClientState(GL_VERTEX_ARRAY);
 }
 
@@ -216,9 +239,12 @@ void CVertexArray::DrawArray2d0(const int drawType, unsigned int stride)
 		return;
 
 	CheckEndStrip();
+
+	const float* bufArray = BindStreamed();
 	glEnableClientState(GL_VERTEX_ARRAY);
-	glVertexPointer(2, GL_FLOAT, stride, drawArray);
+	glVertexPointer(2, GL_FLOAT, stride, bufArray);
 	DrawArrays(drawType, stride);
+	UnbindStreamed();
 	glDisableClientState(GL_VERTEX_ARRAY);
 }
 
@@ -228,11 +254,14 @@ void CVertexArray::DrawArrayN(const int drawType, unsigned int stride)
 		return;
 
 	CheckEndStrip();
+
+	const float* bufArray = BindStreamed();
 	glEnableClientState(GL_VERTEX_ARRAY);
 	glEnableClientState(GL_NORMAL_ARRAY);
-	glVertexPointer(3, GL_FLOAT, stride, drawArray);
-	glNormalPointer(GL_FLOAT, stride, drawArray + 3);
+	glVertexPointer(3, GL_FLOAT, stride, bufArray);
+	glNormalPointer(GL_FLOAT, stride, bufArray + 3);
 	DrawArrays(drawType, stride);
+	UnbindStreamed();
 	glDisableClientState(GL_VERTEX_ARRAY);
 	glDisableClientState(GL_NORMAL_ARRAY);
 }
@@ -244,11 +273,14 @@ void CVertexArray::DrawArrayC(const int drawType, unsigned int stride)
 		return;
 
 	CheckEndStrip();
+
+	const float* bufArray = BindStreamed();
 	glEnableClientState(GL_VERTEX_ARRAY);
 	glEnableClientState(GL_COLOR_ARRAY);
-	glVertexPointer(3, GL_FLOAT, stride, drawArray);
-	glColorPointer(4, GL_UNSIGNED_BYTE, stride, drawArray + 3);
+	glVertexPointer(3, GL_FLOAT, stride, bufArray);
+	glColorPointer(4, GL_UNSIGNED_BYTE, stride, bufArray + 3);
 	DrawArrays(drawType, stride);
+	UnbindStreamed();
 	glDisableClientState(GL_VERTEX_ARRAY);
 	glDisableClientState(GL_COLOR_ARRAY);
 }
@@ -260,11 +292,14 @@ void CVertexArray::DrawArrayT(const int drawType, unsigned int stride)
 		return;
 
 	CheckEndStrip();
+
+	const float* bufArray = BindStreamed();
 	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 	glEnableClientState(GL_VERTEX_ARRAY);
-	glVertexPointer(3, GL_FLOAT, stride, drawArray);
-	glTexCoordPointer(2, GL_FLOAT, stride, drawArray + 3);
+	glVertexPointer(3, GL_FLOAT, stride, bufArray);
+	glTexCoordPointer(2, GL_FLOAT, stride, bufArray + 3);
 	DrawArrays(drawType, stride);
+	UnbindStreamed();
 	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 	glDisableClientState(GL_VERTEX_ARRAY);
 }
@@ -276,11 +311,14 @@ void CVertexArray::DrawArray2dT(const int drawType, unsigned int stride)
 		return;
 
 	CheckEndStrip();
+
+	const float* bufArray = BindStreamed();
 	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 	glEnableClientState(GL_VERTEX_ARRAY);
-	glVertexPointer(2, GL_FLOAT, stride, drawArray);
-	glTexCoordPointer(2, GL_FLOAT, stride, drawArray + 2);
+	glVertexPointer(2, GL_FLOAT, stride, bufArray);
+	glTexCoordPointer(2, GL_FLOAT, stride, bufArray + 2);
 	DrawArrays(drawType, stride);
+	UnbindStreamed();
 	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 	glDisableClientState(GL_VERTEX_ARRAY);
 }
@@ -292,13 +330,16 @@ void CVertexArray::DrawArray2dTC(const int drawType, unsigned int stride)
 		return;
 
 	CheckEndStrip();
+
+	const float* bufArray = BindStreamed();
 	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 	glEnableClientState(GL_VERTEX_ARRAY);
 	glEnableClientState(GL_COLOR_ARRAY);
-	glVertexPointer(2, GL_FLOAT, stride, drawArray);
-	glTexCoordPointer(2, GL_FLOAT, stride, drawArray + 2);
-	glColorPointer(4, GL_UNSIGNED_BYTE, stride, drawArray + 4);
+	glVertexPointer(2, GL_FLOAT, stride, bufArray);
+	glTexCoordPointer(2, GL_FLOAT, stride, bufArray + 2);
+	glColorPointer(4, GL_UNSIGNED_BYTE, stride, bufArray + 4);
 	DrawArrays(drawType, stride);
+	UnbindStreamed();
 	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 	glDisableClientState(GL_VERTEX_ARRAY);
 	glDisableClientState(GL_COLOR_ARRAY);
@@ -311,11 +352,14 @@ void CVertexArray::DrawArray2dT(const int drawType, StripCallback callback, void
 		return;
 
 	CheckEndStrip();
+
+	const float* bufArray = BindStreamed();
 	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 	glEnableClientState(GL_VERTEX_ARRAY);
-	glVertexPointer(2, GL_FLOAT, stride, drawArray);
-	glTexCoordPointer(2, GL_FLOAT, stride, drawArray + 2);
+	glVertexPointer(2, GL_FLOAT, stride, bufArray);
+	glTexCoordPointer(2, GL_FLOAT, stride, bufArray + 2);
 	DrawArraysCallback(drawType, stride, callback, data);
+	UnbindStreamed();
 	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 	glDisableClientState(GL_VERTEX_ARRAY);
 }
@@ -327,14 +371,17 @@ void CVertexArray::DrawArrayTN(const int drawType, unsigned int stride)
 		return;
 
 	CheckEndStrip();
+
+	const float* bufArray = BindStreamed();
 	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 	glEnableClientState(GL_VERTEX_ARRAY);
 	glEnableClientState(GL_NORMAL_ARRAY);
 
-	glVertexPointer(3, GL_FLOAT, stride, drawArray);
-	glTexCoordPointer(2, GL_FLOAT, stride, drawArray + 3);
-	glNormalPointer(GL_FLOAT, stride, drawArray + 5);
+	glVertexPointer(3, GL_FLOAT, stride, bufArray);
+	glTexCoordPointer(2, GL_FLOAT, stride, bufArray + 3);
+	glNormalPointer(GL_FLOAT, stride, bufArray + 5);
 	DrawArrays(drawType, stride);
+	UnbindStreamed();
 
 	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 	glDisableClientState(GL_VERTEX_ARRAY);
@@ -348,6 +395,8 @@ void CVertexArray::DrawArrayTNT(const int drawType, unsigned int stride)
 
 	CheckEndStrip();
 
+	const float* bufArray = BindStreamed();
+
 	#define SET_ENABLE_ACTIVE_TEX(texUnit)            \
 		glClientActiveTexture(texUnit);               \
 		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
@@ -358,15 +407,16 @@ void CVertexArray::DrawArrayTNT(const int drawType, unsigned int stride)
 	glEnableClientState(GL_VERTEX_ARRAY);
 	glEnableClientState(GL_NORMAL_ARRAY);
 
-	SET_ENABLE_ACTIVE_TEX(GL_TEXTURE0); glTexCoordPointer(2, GL_FLOAT, stride, drawArray +  3);
-	SET_ENABLE_ACTIVE_TEX(GL_TEXTURE1); glTexCoordPointer(2, GL_FLOAT, stride, drawArray +  3); // FIXME? (format-specific)
-	SET_ENABLE_ACTIVE_TEX(GL_TEXTURE5); glTexCoordPointer(3, GL_FLOAT, stride, drawArray +  8);
-	SET_ENABLE_ACTIVE_TEX(GL_TEXTURE6); glTexCoordPointer(3, GL_FLOAT, stride, drawArray + 11);
+	SET_ENABLE_ACTIVE_TEX(GL_TEXTURE0); glTexCoordPointer(2, GL_FLOAT, stride, bufArray +  3);
+	SET_ENABLE_ACTIVE_TEX(GL_TEXTURE1); glTexCoordPointer(2, GL_FLOAT, stride, bufArray +  3); // FIXME? (format-specific)
+	SET_ENABLE_ACTIVE_TEX(GL_TEXTURE5); glTexCoordPointer(3, GL_FLOAT, stride, bufArray +  8);
+	SET_ENABLE_ACTIVE_TEX(GL_TEXTURE6); glTexCoordPointer(3, GL_FLOAT, stride, bufArray + 11);
 
-	glVertexPointer(3, GL_FLOAT, stride, drawArray + 0);
-	glNormalPointer(GL_FLOAT, stride, drawArray + 5);
+	glVertexPointer(3, GL_FLOAT, stride, bufArray + 0);
+	glNormalPointer(GL_FLOAT, stride, bufArray + 5);
 
 	DrawArrays(drawType, stride);
+	UnbindStreamed();
 
 	SET_DISABLE_ACTIVE_TEX(GL_TEXTURE6);
 	SET_DISABLE_ACTIVE_TEX(GL_TEXTURE5);
@@ -387,13 +437,16 @@ void CVertexArray::DrawArrayTC(const int drawType, unsigned int stride)
 		return;
 
 	CheckEndStrip();
+
+	const float* bufArray = BindStreamed();
 	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 	glEnableClientState(GL_VERTEX_ARRAY);
 	glEnableClientState(GL_COLOR_ARRAY);
-	glVertexPointer(3, GL_FLOAT, stride, drawArray);
-	glTexCoordPointer(2, GL_FLOAT, stride, drawArray + 3);
-	glColorPointer(4, GL_UNSIGNED_BYTE, stride, drawArray + 5);
+	glVertexPointer(3, GL_FLOAT, stride, bufArray);
+	glTexCoordPointer(2, GL_FLOAT, stride, bufArray + 3);
+	glColorPointer(4, GL_UNSIGNED_BYTE, stride, bufArray + 5);
 	DrawArrays(drawType, stride);
+	UnbindStreamed();
 	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 	glDisableClientState(GL_VERTEX_ARRAY);
 	glDisableClientState(GL_COLOR_ARRAY);
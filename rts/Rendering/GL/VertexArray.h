@@ -107,6 +107,13 @@ public:
 	unsigned int drawIndex() const { return drawArrayPos - drawArray; }
 	void ResetPos() { drawArrayPos = drawArray; }
 
+	// read-only access to the filled contents, e.g. for baking them
+	// elsewhere; strip entries are byte offsets marking the end of a
+	// strip (only complete after a DrawArray* call closed the last one)
+	const float* GetDrawArray() const { return drawArray; }
+	const unsigned int* GetStripArray() const { return stripArray; }
+	unsigned int GetNumStrips() const { return stripArrayPos - stripArray; }
+
 	// standard API
 	inline void AddVertex0(const float3& p);
 	inline void AddVertex0(float x, float y, float z);
@@ -165,6 +172,12 @@ public:
 	void EndStrip();
 
 protected:
+	/// streams the filled array through CStreamBuffer when supported;
+	/// returns the base address for the gl*Pointer calls (either the
+	/// client-memory array or an offset into the bound stream buffer)
+	const float* BindStreamed();
+	void UnbindStreamed();
+
 	void DrawArrays(const GLenum mode, const unsigned int stride);
 	void DrawArraysCallback(const GLenum mode, const unsigned int stride, StripCallback callback, void* data);
 	inline void CheckEnlargeDrawArray(size_t bytesNeeded);
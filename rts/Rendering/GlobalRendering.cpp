@@ -10,6 +10,8 @@
 #include "Rendering/VerticalSync.h"
 #include "Rendering/GL/myGL.h"
 #include "Rendering/GL/FBO.h"
+#include "Rendering/GL/StateCache.h"
+#include "Rendering/Screenshot.h"
 #include "System/bitops.h"
 #include "System/EventHandler.h"
 #include "System/type2.h"
@@ -513,8 +515,14 @@ void CGlobalRendering::SwapBuffers(bool allowSwapBuffers, bool clearErrors)
 
 	const spring_time pre = spring_now();
 
+	UpdateScreenshots();
+
 	SDL_GL_SwapWindow(window);
 	eventHandler.DbgTimingInfo(TIMING_SWAP, pre, spring_now());
+
+	// anything can have touched tracked state through raw GL by now
+	GL::InvalidateStateCache();
+	GL::RollStateCacheCounters();
 }
 
 
@@ -328,6 +328,15 @@ void CIconData::DrawArray(CVertexArray* va, float x0, float y0, float x1, float
 	va->AddVertex2dTC(x0, y1, 0.0f, 1.0f, c);
 }
 
+void CIconData::DrawArray(CVertexArray* va, const float3& botLeft, const float3& botRight,
+                          const float3& topLeft, const float3& topRight, const unsigned char* c) const
+{
+	va->AddVertexTC(botLeft,  0.0f, 1.0f, c);
+	va->AddVertexTC(botRight, 1.0f, 1.0f, c);
+	va->AddVertexTC(topRight, 1.0f, 0.0f, c);
+	va->AddVertexTC(topLeft,  0.0f, 0.0f, c);
+}
+
 void CIconData::Draw(float x0, float y0, float x1, float y1) const
 {
 	glBindTexture(GL_TEXTURE_2D, texID);
@@ -28,6 +28,8 @@ namespace icon {
 
 			void BindTexture() const;
 			void DrawArray(CVertexArray* va, float x0, float y0, float x1, float y1, const unsigned char* c) const;
+			void DrawArray(CVertexArray* va, const float3& botLeft, const float3& botRight,
+					const float3& topLeft, const float3& topRight, const unsigned char* c) const;
 			void Draw(float x0, float y0, float x1, float y1) const;
 			void Draw(const float3& botLeft, const float3& botRight,
 					const float3& topLeft, const float3& topRight) const;
@@ -8,6 +8,7 @@
 #include "Rendering/GlobalRendering.h"
 
 #include "Game/Camera.h"
+#include "Game/GlobalUnsynced.h"
 #include "Game/InMapDrawModel.h"
 #include "Map/ReadMap.h"
 #include "Sim/Misc/TeamHandler.h"
@@ -23,6 +24,9 @@ static inline unsigned char smoothStep(int x, int y, int a) {
 }
 
 CInMapDrawView::CInMapDrawView()
+	: lastChangeCounter(-1u) // force a refill on the first Draw()
+	, lastAllMarksVisible(false)
+	, lastSpectating(false)
 {
 	unsigned char tex[64][128][4];
 	for (int y = 0; y < 64; y++) {
@@ -196,39 +200,60 @@ void InMapDraw_QuadDrawer::DrawQuad(int x, int y)
 
 void CInMapDrawView::Draw()
 {
-	CVertexArray* pointsVa = GetVertexArray();
-	pointsVa->Initialize();
-	CVertexArray* linesVa = GetVertexArray();
-	linesVa->Initialize();
+	//! the geometry is not just a function of the model contents: point
+	//! markers are billboarded and lines are pulled towards the eye, so
+	//! the retained arrays also go stale whenever the camera moves; the
+	//! visibility filter further depends on our spectator state
+	const bool modelChanged =
+		(lastChangeCounter != inMapDrawerModel->GetChangeCounter()) ||
+		(lastAllMarksVisible != inMapDrawerModel->GetAllMarksVisible()) ||
+		(lastSpectating != gu->spectating);
+	const bool cameraMoved =
+		(lastCamPos.SqDistance(camera->GetPos()) > 0.25f) ||
+		(lastCamDir.dot(camera->GetDir()) < 0.999999f);
+
+	if (modelChanged || cameraMoved) {
+		lastChangeCounter = inMapDrawerModel->GetChangeCounter();
+		lastAllMarksVisible = inMapDrawerModel->GetAllMarksVisible();
+		lastSpectating = gu->spectating;
+		lastCamPos = camera->GetPos();
+		lastCamDir = camera->GetDir();
+
+		pointsVa.Initialize();
+		linesVa.Initialize();
+		//! holds pointers into the model quads; any mutation of those
+		//! bumps the change-counter and thereby lands us in this branch
+		visibleLabels.clear();
+
+		InMapDraw_QuadDrawer drawer;
+		drawer.linesVa = &linesVa;
+		drawer.pointsVa = &pointsVa;
+		drawer.visibleLabels = &visibleLabels;
 
-	InMapDraw_QuadDrawer drawer;
-	drawer.linesVa = linesVa;
-	drawer.pointsVa = pointsVa;
-	drawer.visibleLabels = &visibleLabels;
+		readMap->GridVisibility(nullptr, &drawer, 1e9, CInMapDrawModel::DRAW_QUAD_SIZE);
+	}
 
 	glDepthMask(0);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 	glEnable(GL_BLEND);
 	glBindTexture(GL_TEXTURE_2D, texture);
 
-	readMap->GridVisibility(nullptr, &drawer, 1e9, CInMapDrawModel::DRAW_QUAD_SIZE);
-
 	glDisable(GL_TEXTURE_2D);
 	glLineWidth(3.f);
-	linesVa->DrawArrayC(GL_LINES); //! draw lines
+	linesVa.DrawArrayC(GL_LINES); //! draw lines
 
 	// XXX hopeless drivers, retest in a year or so...
 	// width greater than 2 causes GUI flicker on ATI hardware as of driver version 9.3
 	// so redraw lines with width 1
 	if (globalRendering->atiHacks) {
 		glLineWidth(1.f);
-		linesVa->DrawArrayC(GL_LINES);
+		linesVa.DrawArrayC(GL_LINES);
 	}
 
 	// draw points
 	glLineWidth(1);
 	glEnable(GL_TEXTURE_2D);
-	pointsVa->DrawArrayTC(GL_QUADS); //! draw point markers
+	pointsVa.DrawArrayTC(GL_QUADS); //! draw point markers
 
 	if (!visibleLabels.empty()) {
 		font->SetColors(); //! default
@@ -242,8 +267,6 @@ void CInMapDrawView::Draw()
 			font->SetTextColor(color[0]/255.0f, color[1]/255.0f, color[2]/255.0f, 1.0f); //FIXME (overload!)
 			font->glWorldPrint(pos, 26.0f, (*pi)->GetLabel());
 		}
-
-		visibleLabels.clear();
 	}
 
 	glDepthMask(1);
@@ -8,6 +8,7 @@
 
 #include "System/float3.h"
 #include "Game/InMapDrawModel.h"
+#include "Rendering/GL/VertexArray.h"
 
 /**
  * The V in MVC for InMapDraw.
@@ -25,6 +26,20 @@ public:
 private:
 	unsigned int texture;
 
+	/**
+	 * Retained copies of the marker geometry; these are only refilled
+	 * when the model changed or the camera moved, since the billboarded
+	 * point quads and camera-pulled lines depend on the eye position.
+	 */
+	CVertexArray pointsVa;
+	CVertexArray linesVa;
+
+	unsigned int lastChangeCounter;
+	bool lastAllMarksVisible;
+	bool lastSpectating;
+	float3 lastCamPos;
+	float3 lastCamDir;
+
 	std::vector<const CInMapDrawModel::MapPoint*> visibleLabels;
 };
 
@@ -22,8 +22,6 @@ CLineDrawer::CLineDrawer()
 	, lastColor(NULL)
 	, stippleTimer(0.0f)
 {
-	lines.reserve(32);
-	stippled.reserve(32);
 }
 
 
@@ -51,9 +49,9 @@ void CLineDrawer::SetupLineStipple()
 
 void CLineDrawer::DrawAll()
 {
-	if (lines.empty() && stippled.empty())
+	if (lines.verts.empty() && stippled.verts.empty())
 		return;
-	
+
 	glEnableClientState(GL_VERTEX_ARRAY);
 	glEnableClientState(GL_COLOR_ARRAY);
 
@@ -62,25 +60,17 @@ void CLineDrawer::DrawAll()
 	glDisable(GL_DEPTH_TEST);
 	glDisable(GL_LINE_STIPPLE);
 
-	for (int i = 0; i<lines.size(); ++i) {
-		int size = lines[i].colors.size();
-		if(size > 0) {
-			glColorPointer(4, GL_FLOAT, 0, &lines[i].colors[0]);
-			glVertexPointer(3, GL_FLOAT, 0, &lines[i].verts[0]);
-			glDrawArrays(lines[i].type, 0, size/4);
-		}
+	if (!lines.verts.empty()) {
+		glColorPointer(4, GL_FLOAT, 0, &lines.colors[0]);
+		glVertexPointer(3, GL_FLOAT, 0, &lines.verts[0]);
+		glDrawArrays(GL_LINES, 0, lines.verts.size() / 3);
 	}
 
-	if (!stippled.empty()) {
+	if (!stippled.verts.empty()) {
 		glEnable(GL_LINE_STIPPLE);
-		for (int i = 0; i<stippled.size(); ++i) {
-			int size = stippled[i].colors.size();
-			if(size > 0) {
-				glColorPointer(4, GL_FLOAT, 0, &stippled[i].colors[0]);
-				glVertexPointer(3, GL_FLOAT, 0, &stippled[i].verts[0]);
-				glDrawArrays(stippled[i].type, 0, size/4);
-			}
-		}
+		glColorPointer(4, GL_FLOAT, 0, &stippled.colors[0]);
+		glVertexPointer(3, GL_FLOAT, 0, &stippled.verts[0]);
+		glDrawArrays(GL_LINES, 0, stippled.verts.size() / 3);
 		glDisable(GL_LINE_STIPPLE);
 	}
 
@@ -88,6 +78,9 @@ void CLineDrawer::DrawAll()
 	glDisableClientState(GL_VERTEX_ARRAY);
 	glPopAttrib();
 
-	lines.clear();
-	stippled.clear();
+	// keep the allocations, the buffers fill up again next frame
+	lines.verts.clear();
+	lines.colors.clear();
+	stippled.verts.clear();
+	stippled.colors.clear();
 }
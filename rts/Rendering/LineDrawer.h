@@ -17,7 +17,7 @@ class CLineDrawer {
 
 		void SetupLineStipple();
 		void UpdateLineStipple();
-		               
+
 		void StartPath(const float3& pos, const float* color);
 		void FinishPath() const;
 		void DrawLine(const float3& endPos, const float* color);
@@ -32,27 +32,40 @@ class CLineDrawer {
 
 		void DrawAll();
 
+		/**
+		 * Retained-path support: all queued segments live in one pair of
+		 * dynamic buffers (plain and stippled), so a caller can capture
+		 * the vertex range it just emitted and append it again verbatim
+		 * on later frames without re-walking its source data.
+		 */
+		size_t GetActiveVertexCount() const {
+			return ((lineStipple? stippled: lines).verts.size() / 3);
+		}
+		void CopyActiveRange(size_t firstVert, std::vector<GLfloat>& verts, std::vector<GLfloat>& colors) const;
+		void AppendActiveRange(const std::vector<GLfloat>& verts, const std::vector<GLfloat>& colors);
+
 	private:
 		bool lineStipple;
 		bool useColorRestarts;
 		bool useRestartColor;
 		float restartAlpha;
 		const float* restartColor;
-		
+
 		float3 lastPos;
 		const float* lastColor;
-		
+
 		float stippleTimer;
 
-		// queue all lines and draw them in one go later
-		struct LinePair {
-			GLenum type;
+		// queue all lines and draw them in one go later; every segment is
+		// emitted as a self-contained vertex pair (GL_LINES) with its own
+		// per-vertex colors, so each buffer needs only a single draw call
+		struct LineBuffer {
 			std::vector<GLfloat> verts;
 			std::vector<GLfloat> colors;
 		};
 
-		std::vector<LinePair> lines;
-		std::vector<LinePair> stippled;
+		LineBuffer lines;
+		LineBuffer stippled;
 };
 
 
@@ -89,28 +102,8 @@ inline void CLineDrawer::Break(const float3& endPos, const float* color)
 
 inline void CLineDrawer::Restart()
 {
-	LinePair *ptr;
-	if (lineStipple) {
-		stippled.push_back(LinePair());
-		ptr = &stippled.back();
-	} else {
-		lines.push_back(LinePair());
-		ptr = &lines.back();
-	}
-	LinePair& p = *ptr;
-
-	if (!useColorRestarts)	 {
-		p.type = GL_LINE_STRIP;
-		p.colors.push_back(lastColor[0]);
-		p.colors.push_back(lastColor[1]);
-		p.colors.push_back(lastColor[2]);
-		p.colors.push_back(lastColor[3]);
-		p.verts.push_back(lastPos[0]);
-		p.verts.push_back(lastPos[1]);
-		p.verts.push_back(lastPos[2]);
-	} else {
-		p.type = GL_LINES;
-	}
+	// noop, left for compatibility; every segment
+	// is self-contained so there is no path state
 }
 
 
@@ -123,8 +116,6 @@ inline void CLineDrawer::RestartWithColor(const float *color)
 
 inline void CLineDrawer::RestartSameColor()
 {
-	// the only way for this to work would be using glGet AFAIK
-	// so it's left broken
 	Restart();
 }
 
@@ -139,46 +130,41 @@ inline void CLineDrawer::StartPath(const float3& pos, const float* color)
 
 inline void CLineDrawer::DrawLine(const float3& endPos, const float* color)
 {
-	LinePair *ptr;
-	if (lineStipple) {
-		ptr = &stippled.back();
-	} else {
-		ptr = &lines.back();
-	}
-	LinePair& p = *ptr;
+	LineBuffer& lb = lineStipple? stippled: lines;
 
+	// segment start vertex; with color restarts each segment begins with
+	// the restart color (or a faded copy of its own), otherwise it takes
+	// the color the previous segment ended with
 	if (!useColorRestarts) {
-		p.colors.push_back(color[0]);
-		p.colors.push_back(color[1]);
-		p.colors.push_back(color[2]);
-		p.colors.push_back(color[3]);
-		p.verts.push_back(endPos.x);
-		p.verts.push_back(endPos.y);
-		p.verts.push_back(endPos.z);
+		lb.colors.push_back(lastColor[0]);
+		lb.colors.push_back(lastColor[1]);
+		lb.colors.push_back(lastColor[2]);
+		lb.colors.push_back(lastColor[3]);
 	} else {
 		if (useRestartColor) {
-			p.colors.push_back(restartColor[0]);
-			p.colors.push_back(restartColor[1]);
-			p.colors.push_back(restartColor[2]);
-			p.colors.push_back(restartColor[3]);
+			lb.colors.push_back(restartColor[0]);
+			lb.colors.push_back(restartColor[1]);
+			lb.colors.push_back(restartColor[2]);
+			lb.colors.push_back(restartColor[3]);
 		} else {
-			p.colors.push_back(color[0]);
-			p.colors.push_back(color[1]);
-			p.colors.push_back(color[2]);
-			p.colors.push_back(color[3] * restartAlpha);
+			lb.colors.push_back(color[0]);
+			lb.colors.push_back(color[1]);
+			lb.colors.push_back(color[2]);
+			lb.colors.push_back(color[3] * restartAlpha);
 		}
-		p.verts.push_back(lastPos.x);
-		p.verts.push_back(lastPos.y);
-		p.verts.push_back(lastPos.z);
-
-		p.colors.push_back(color[0]);
-		p.colors.push_back(color[1]);
-		p.colors.push_back(color[2]);
-		p.colors.push_back(color[3]);
-		p.verts.push_back(endPos.x);
-		p.verts.push_back(endPos.y);
-		p.verts.push_back(endPos.z);
 	}
+	lb.verts.push_back(lastPos.x);
+	lb.verts.push_back(lastPos.y);
+	lb.verts.push_back(lastPos.z);
+
+	// segment end vertex
+	lb.colors.push_back(color[0]);
+	lb.colors.push_back(color[1]);
+	lb.colors.push_back(color[2]);
+	lb.colors.push_back(color[3]);
+	lb.verts.push_back(endPos.x);
+	lb.verts.push_back(endPos.y);
+	lb.verts.push_back(endPos.z);
 
 	lastPos = endPos;
 	lastColor = color;
@@ -199,4 +185,21 @@ inline void CLineDrawer::DrawIconAtLastPos(int cmdID)
 }
 
 
+inline void CLineDrawer::CopyActiveRange(size_t firstVert, std::vector<GLfloat>& verts, std::vector<GLfloat>& colors) const
+{
+	const LineBuffer& lb = lineStipple? stippled: lines;
+
+	verts.assign(lb.verts.begin() + firstVert * 3, lb.verts.end());
+	colors.assign(lb.colors.begin() + firstVert * 4, lb.colors.end());
+}
+
+
+inline void CLineDrawer::AppendActiveRange(const std::vector<GLfloat>& verts, const std::vector<GLfloat>& colors)
+{
+	LineBuffer& lb = lineStipple? stippled: lines;
+
+	lb.verts.insert(lb.verts.end(), verts.begin(), verts.end());
+	lb.colors.insert(lb.colors.end(), colors.begin(), colors.end());
+}
+
 #endif // _LINE_DRAWER_H
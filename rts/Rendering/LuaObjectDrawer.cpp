@@ -337,6 +337,9 @@ void LuaObjectDrawer::DrawMaterialBins(LuaObjType objType, LuaMatType matType, b
 
 	const LuaMaterial* prevMat = &LuaMaterial::defMat;
 
+	// camera changed since the last pass, uniforms need fresh uploads
+	LuaMatUniforms::BeginPass();
+
 	for (auto it = bins.cbegin(); it != bins.cend(); ++it) {
 		DrawMaterialBin(*it, prevMat, objType, matType, deferredPass, inAlphaBin);
 		prevMat = *it;
@@ -549,6 +552,7 @@ bool LuaObjectDrawer::DrawSingleObjectCommon(const CSolidObject* obj, LuaObjType
 	binObjTeam = -1;
 
 	// NOTE: doesn't make sense to support deferred mode for this? (extra arg in gl.Unit, etc)
+	LuaMatUniforms::BeginPass();
 	currMat->Execute(LuaMaterial::defMat, false);
 
 	DrawBinObject(obj, objType, lodMat, currMat, false, false, applyTrans, true);
@@ -305,17 +305,25 @@ bool CLegacyInfoTextureHandler::UpdateExtraTexture(BaseGroundDrawMode texDrawMod
 				const unsigned  char* extraTexPal     = metalMap->GetTexturePalette();
 				const          float* extractDepthMap = metalMap->GetExtractionMap();
 
+				// fourth roots of the whole extraction row in one go
+				// instead of two apxsqrt calls per visible cell
+				static std::vector<float> extractRow;
+				extractRow.resize(mapDims.hmapx);
+
 				for (int y = starty; y < endy; ++y) {
 					const int y_pwr2mapx_half = y*pwr2mapx_half;
 					const int y_hmapx = y * mapDims.hmapx;
 
+					fastmath::apxsqrt_batch(&extractDepthMap[y_hmapx], &extractRow[0], mapDims.hmapx);
+					fastmath::apxsqrt_batch(&extractRow[0], &extractRow[0], mapDims.hmapx);
+
 					for (int x = 0; x < mapDims.hmapx; ++x) {
 						const int a   = (y_pwr2mapx_half + x) * 4 - offset;
 						const int alx = ((x*2) >> losHandler->los.mipLevel);
 						const int aly = ((y*2) >> losHandler->los.mipLevel);
 
 						if (myLos[alx + (aly * losHandler->los.size.x)]) {
-							infoTexMem[a + COLOR_R] = (unsigned char)std::min(255.0f, 900.0f * fastmath::apxsqrt(fastmath::apxsqrt(extractDepthMap[y_hmapx + x])));
+							infoTexMem[a + COLOR_R] = (unsigned char)std::min(255.0f, 900.0f * extractRow[x]);
 						} else {
 							infoTexMem[a + COLOR_R] = 0;
 						}
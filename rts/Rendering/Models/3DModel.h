@@ -332,6 +332,21 @@ struct LocalModelPiece
 	void UpdateChildMatricesRec(bool updateChildMatrices) const;
 	void UpdateParentMatricesRec() const;
 
+	// single step of LocalModel::UpdatePieceMatrices; caller must
+	// guarantee the parent's matrices are already up-to-date
+	void UpdateMatricesFlat() const {
+		if (!dirty)
+			return;
+
+		dirty = false;
+
+		pieceSpaceMat = CalcPieceSpaceMatrix(pos, rot, original->scales);
+		modelSpaceMat = pieceSpaceMat;
+
+		if (parent != nullptr)
+			modelSpaceMat >>= parent->modelSpaceMat;
+	}
+
 	CMatrix44f CalcPieceSpaceMatrixRaw(const float3& p, const float3& r, const float3& s) const { return (original->ComposeTransform(p, r, s)); }
 	CMatrix44f CalcPieceSpaceMatrix(const float3& p, const float3& r, const float3& s) const {
 		if (blockScriptAnims)
@@ -433,7 +448,22 @@ struct LocalModel
 	float GetDrawRadius() const { return (boundingVolume.GetBoundingRadius()); }
 
 
+	// resolves every dirty piece in one linear pass; pieces are laid
+	// out in depth-first pre-order (CreateLocalModelPieces) so parents
+	// are always final before their children read them, and SetDirty
+	// marks complete subtrees
+	void UpdatePieceMatrices() const {
+		for (const LocalModelPiece& p: pieces) {
+			p.UpdateMatricesFlat();
+		}
+	}
+
+
 	void Draw() const {
+		// all pieces are about to ask for their model-space matrices,
+		// batch-resolve them instead of lazily recursing per piece
+		UpdatePieceMatrices();
+
 		if (!luaMaterialData.Enabled()) {
 			DrawPieces();
 			return;
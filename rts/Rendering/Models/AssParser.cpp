@@ -4,6 +4,7 @@
 #include "3DModel.h"
 #include "3DModelLog.h"
 #include "AssIO.h"
+#include "ModelCache.h"
 
 #include "Lua/LuaParser.h"
 #include "Sim/Misc/CollisionVolume.h"
@@ -157,6 +158,17 @@ S3DModel CAssParser::Load(const std::string& modelFilePath)
 	if (!CFileHandler::FileExists(metaFileName, SPRING_VFS_ZIP))
 		LOG_SL(LOG_SECTION_MODEL, L_INFO, "No meta-file '%s'. Using defaults.", metaFileName.c_str());
 
+	// serve from the binary cache when a valid entry exists, skipping
+	// both the metafile and the (far more expensive) Assimp import
+	const unsigned int cacheHash = CModelCache::CalcModelHash(modelFilePath, metaFileName);
+
+	{
+		S3DModel cachedModel;
+
+		if (CModelCache::Load(&cachedModel, modelFilePath, cacheHash))
+			return cachedModel;
+	}
+
 	LuaParser metaFileParser(metaFileName, SPRING_VFS_ZIP, SPRING_VFS_ZIP);
 
 	if (!metaFileParser.Execute())
@@ -229,6 +241,8 @@ S3DModel CAssParser::Load(const std::string& modelFilePath)
 	LOG_SL(LOG_SECTION_MODEL, L_DEBUG, "model->mins: (%f,%f,%f)", model.mins[0], model.mins[1], model.mins[2]);
 	LOG_SL(LOG_SECTION_MODEL, L_DEBUG, "model->maxs: (%f,%f,%f)", model.maxs[0], model.maxs[1], model.maxs[2]);
 	LOG_SL(LOG_SECTION_MODEL, L_INFO, "Model %s Imported.", model.name.c_str());
+
+	CModelCache::Save(&model, modelFilePath, cacheHash, modelTable.GetBool("fliptextures", true), modelTable.GetBool("invertteamcolor", true));
 	return model;
 }
 
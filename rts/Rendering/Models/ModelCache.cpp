@@ -0,0 +1,360 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "ModelCache.h"
+#include "3DModel.h"
+#include "3DModelLog.h"
+#include "AssParser.h"
+#include "Rendering/Textures/S3OTextureHandler.h"
+#include "Sim/Misc/CollisionVolume.h"
+#include "System/Config/ConfigHandler.h"
+#include "System/CRC.h"
+#include "System/FileSystem/DataDirsAccess.h"
+#include "System/FileSystem/FileHandler.h"
+#include "System/FileSystem/FileQueryFlags.h"
+#include "System/FileSystem/FileSystem.h"
+#include "System/FileSystem/MappedFile.h"
+#include "System/StringUtil.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+CONFIG(bool, ModelCache)
+	.defaultValue(true)
+	.safemodeValue(false)
+	.description("Cache parsed Assimp models (Collada, 3DS, ...) in a binary format that loads much faster on subsequent starts.");
+
+
+// flat file layout: header, tex1/tex2 names, then the pieces in
+// flattened (root-first) tree order; the format version is folded
+// into the content hash so readers never see older layouts
+struct ModelCacheFileHeader {
+	std::uint32_t magic;
+	std::uint32_t hashCode;
+	std::uint32_t numPieces;
+	std::uint32_t flipTextures;
+	std::uint32_t invertTeamColor;
+
+	float radius;
+	float height;
+	float mins[3];
+	float maxs[3];
+	float relMidPos[3];
+};
+
+static const std::uint32_t MODELCACHE_MAGIC = 0x434D5053; // "SPMC"
+static const std::uint32_t MODELCACHE_VERSION = 1;
+
+// upper sanity bounds on deserialized counts; a valid entry can never
+// reach these, a corrupted one is rejected before any huge allocation
+static const std::uint32_t MODELCACHE_MAX_PIECES = 1 << 12;
+static const std::uint32_t MODELCACHE_MAX_VERTS = 1 << 24;
+
+
+static const std::string GetModelCacheDir() {
+	return (FileSystem::GetCacheDir() + "/models/");
+}
+
+static const std::string GetModelCacheFileName(const std::string& modelFilePath, unsigned int hashCode) {
+	return (GetModelCacheDir() + FileSystem::GetBasename(modelFilePath) + "-" + IntToString(hashCode, "%x") + ".bin");
+}
+
+
+namespace {
+	// bounds-checked cursor over the mapped cache file; any short or
+	// malformed read latches <ok> to false and the entry is discarded
+	struct CacheFileReader {
+		CacheFileReader(const std::uint8_t* d, size_t s): data(d), size(s) {}
+
+		bool Read(void* dst, size_t numBytes) {
+			const std::uint8_t* src = Skip(numBytes);
+
+			if (src == nullptr)
+				return false;
+
+			std::memcpy(dst, src, numBytes);
+			return true;
+		}
+
+		const std::uint8_t* Skip(size_t numBytes) {
+			if (!ok || (numBytes > (size - pos))) {
+				ok = false;
+				return nullptr;
+			}
+
+			const std::uint8_t* src = data + pos;
+			pos += numBytes;
+			return src;
+		}
+
+		std::uint32_t ReadU32() {
+			std::uint32_t v = 0;
+			Read(&v, sizeof(v));
+			return v;
+		}
+
+		bool ReadString(std::string& s) {
+			const std::uint32_t numBytes = ReadU32();
+			const std::uint8_t* src = Skip(numBytes);
+
+			if (src != nullptr)
+				s.assign(reinterpret_cast<const char*>(src), numBytes);
+
+			return ok;
+		}
+
+		const std::uint8_t* data;
+		size_t size;
+		size_t pos = 0;
+		bool ok = true;
+	};
+}
+
+
+static void WriteU32(FILE* file, std::uint32_t v) { fwrite(&v, sizeof(v), 1, file); }
+static void WriteFloat3(FILE* file, const float3& v) { fwrite(&v.x, sizeof(float), 3, file); }
+static void WriteString(FILE* file, const std::string& s) {
+	WriteU32(file, s.size());
+	fwrite(s.data(), 1, s.size(), file);
+}
+
+
+bool CModelCache::Enabled()
+{
+	return (configHandler != nullptr && configHandler->GetBool("ModelCache"));
+}
+
+
+unsigned int CModelCache::CalcModelHash(const std::string& modelFilePath, const std::string& metaFileName)
+{
+	CFileHandler modelFile(modelFilePath, SPRING_VFS_ZIP);
+	std::string fileData;
+
+	if (!modelFile.FileExists() || !modelFile.LoadStringData(fileData))
+		return 0;
+
+	CRC crc;
+	crc.Update(MODELCACHE_VERSION);
+	crc.Update(fileData.data(), fileData.size());
+
+	// the metafile shapes the parsed output (piece hierarchy, texture
+	// flags, bounds overrides) so its contents invalidate entries too
+	CFileHandler metaFile(metaFileName, SPRING_VFS_ZIP);
+	std::string metaData;
+
+	if (metaFile.FileExists() && metaFile.LoadStringData(metaData))
+		crc.Update(metaData.data(), metaData.size());
+
+	// 0 is reserved to signal "cache unusable"
+	return (std::max(crc.GetDigest(), 1u));
+}
+
+
+bool CModelCache::Load(S3DModel* model, const std::string& modelFilePath, unsigned int hashCode)
+{
+	if (!Enabled() || hashCode == 0)
+		return false;
+
+	const std::string cacheFileName = GetModelCacheFileName(modelFilePath, hashCode);
+
+	if (!FileSystem::FileExists(cacheFileName))
+		return false;
+
+	// read-only mapping, the piece data is copied out below
+	MappedFile cacheFileMap;
+
+	if (!cacheFileMap.Open(dataDirsAccess.LocateFile(cacheFileName), false)) {
+		FileSystem::Remove(cacheFileName);
+		return false;
+	}
+
+	CacheFileReader reader(cacheFileMap.GetData(), cacheFileMap.GetSize());
+	ModelCacheFileHeader fileHeader;
+
+	if (
+		!reader.Read(&fileHeader, sizeof(fileHeader))        ||
+		fileHeader.magic     != MODELCACHE_MAGIC             ||
+		fileHeader.hashCode  != hashCode                     ||
+		fileHeader.numPieces == 0                            ||
+		fileHeader.numPieces >  MODELCACHE_MAX_PIECES
+	) {
+		FileSystem::Remove(cacheFileName);
+		return false;
+	}
+
+	model->name = modelFilePath;
+	model->type = MODELTYPE_ASS;
+	model->numPieces = fileHeader.numPieces;
+	model->radius = fileHeader.radius;
+	model->height = fileHeader.height;
+	model->mins = float3(fileHeader.mins[0], fileHeader.mins[1], fileHeader.mins[2]);
+	model->maxs = float3(fileHeader.maxs[0], fileHeader.maxs[1], fileHeader.maxs[2]);
+	model->relMidPos = float3(fileHeader.relMidPos[0], fileHeader.relMidPos[1], fileHeader.relMidPos[2]);
+
+	reader.ReadString(model->texs[0]);
+	reader.ReadString(model->texs[1]);
+
+	std::vector<SAssPiece*> pieces(fileHeader.numPieces, nullptr);
+	std::vector< std::vector<std::uint32_t> > childIndices(fileHeader.numPieces);
+
+	for (std::uint32_t n = 0; n < fileHeader.numPieces && reader.ok; n++) {
+		SAssPiece* piece = (pieces[n] = new SAssPiece());
+
+		reader.ReadString(piece->name);
+
+		const std::uint32_t numChildren = reader.ReadU32();
+
+		if (numChildren > fileHeader.numPieces) {
+			reader.ok = false;
+			break;
+		}
+
+		childIndices[n].resize(numChildren);
+		reader.Read(childIndices[n].data(), numChildren * sizeof(std::uint32_t));
+
+		reader.Read(&piece->offset.x, sizeof(float) * 3);
+		reader.Read(&piece->goffset.x, sizeof(float) * 3);
+		reader.Read(&piece->scales.x, sizeof(float) * 3);
+		reader.Read(&piece->mins.x, sizeof(float) * 3);
+		reader.Read(&piece->maxs.x, sizeof(float) * 3);
+
+		CMatrix44f bakedMatrix;
+		reader.Read(bakedMatrix.m, sizeof(bakedMatrix.m));
+
+		piece->numTexCoorChannels = reader.ReadU32();
+
+		const std::uint32_t numVertices = reader.ReadU32();
+
+		if (numVertices > MODELCACHE_MAX_VERTS) {
+			reader.ok = false;
+			break;
+		}
+
+		piece->vertices.resize(numVertices);
+		reader.Read(piece->vertices.data(), numVertices * sizeof(SAssVertex));
+
+		const std::uint32_t numIndices = reader.ReadU32();
+
+		if (numIndices > MODELCACHE_MAX_VERTS) {
+			reader.ok = false;
+			break;
+		}
+
+		piece->indices.resize(numIndices);
+		reader.Read(piece->indices.data(), numIndices * sizeof(std::uint32_t));
+
+		if (!reader.ok)
+			break;
+
+		// reconstructs hasBakedMat; the matrix round-trips bit-exact
+		piece->SetBakedMatrix(bakedMatrix);
+		// piece volumes are pure functions of the bounds, recompute
+		// them exactly as CAssParser::CalculateModelDimensions does
+		piece->SetCollisionVolume(CollisionVolume('b', 'z', piece->maxs - piece->mins, (piece->maxs + piece->mins) * 0.5f));
+	}
+
+	if (!reader.ok) {
+		for (SAssPiece* piece: pieces) {
+			delete piece;
+		}
+
+		FileSystem::Remove(cacheFileName);
+		return false;
+	}
+
+	// relink the tree; child order matters for script piece numbering
+	// so it was serialized explicitly rather than derived from parents
+	for (std::uint32_t n = 0; n < fileHeader.numPieces; n++) {
+		for (const std::uint32_t childIdx: childIndices[n]) {
+			if (childIdx == 0 || childIdx >= fileHeader.numPieces)
+				continue;
+
+			pieces[n]->children.push_back(pieces[childIdx]);
+			pieces[childIdx]->parent = pieces[n];
+		}
+
+		// pieces were written in flattened order, root first
+		model->AddPiece(pieces[n]);
+	}
+
+	assert(model->GetRootPiece()->parent == nullptr);
+
+	// cached entries skip FindTextures, re-register for preloading here
+	texturehandlerS3O->PreloadTexture(model, fileHeader.flipTextures != 0, fileHeader.invertTeamColor != 0);
+
+	LOG_SL(LOG_SECTION_MODEL, L_INFO, "Loaded model %s from cache (%u pieces)", modelFilePath.c_str(), fileHeader.numPieces);
+	return true;
+}
+
+
+void CModelCache::Save(const S3DModel* model, const std::string& modelFilePath, unsigned int hashCode, bool flipTextures, bool invertTeamColor)
+{
+	if (!Enabled() || hashCode == 0)
+		return;
+
+	if (!FileSystem::CreateDirectory(GetModelCacheDir()))
+		return;
+
+	const std::string cacheFileName = GetModelCacheFileName(modelFilePath, hashCode);
+
+	FILE* file = fopen(dataDirsAccess.LocateFile(cacheFileName, FileQueryFlags::WRITE).c_str(), "wb");
+
+	if (file == nullptr)
+		return;
+
+	ModelCacheFileHeader fileHeader;
+	fileHeader.magic = MODELCACHE_MAGIC;
+	fileHeader.hashCode = hashCode;
+	fileHeader.numPieces = model->numPieces;
+	fileHeader.flipTextures = flipTextures;
+	fileHeader.invertTeamColor = invertTeamColor;
+	fileHeader.radius = model->radius;
+	fileHeader.height = model->height;
+	memcpy(fileHeader.mins, &model->mins.x, sizeof(float) * 3);
+	memcpy(fileHeader.maxs, &model->maxs.x, sizeof(float) * 3);
+	memcpy(fileHeader.relMidPos, &model->relMidPos.x, sizeof(float) * 3);
+
+	fwrite(&fileHeader, sizeof(fileHeader), 1, file);
+
+	WriteString(file, model->texs[0]);
+	WriteString(file, model->texs[1]);
+
+	// map piece pointers to their flattened-order indices
+	spring::unordered_map<const S3DModelPiece*, std::uint32_t> pieceIndices;
+
+	for (std::uint32_t n = 0; n < model->pieces.size(); n++) {
+		pieceIndices[model->pieces[n]] = n;
+	}
+
+	for (const S3DModelPiece* rawPiece: model->pieces) {
+		const SAssPiece* piece = static_cast<const SAssPiece*>(rawPiece);
+
+		WriteString(file, piece->name);
+
+		WriteU32(file, piece->children.size());
+		for (const S3DModelPiece* childPiece: piece->children) {
+			WriteU32(file, pieceIndices[childPiece]);
+		}
+
+		WriteFloat3(file, piece->offset);
+		WriteFloat3(file, piece->goffset);
+		WriteFloat3(file, piece->scales);
+		WriteFloat3(file, piece->mins);
+		WriteFloat3(file, piece->maxs);
+
+		fwrite(piece->bakedMatrix.m, sizeof(piece->bakedMatrix.m), 1, file);
+
+		WriteU32(file, piece->numTexCoorChannels);
+
+		WriteU32(file, piece->vertices.size());
+		fwrite(piece->vertices.data(), sizeof(SAssVertex), piece->vertices.size(), file);
+
+		WriteU32(file, piece->indices.size());
+		fwrite(piece->indices.data(), sizeof(std::uint32_t), piece->indices.size(), file);
+	}
+
+	fclose(file);
+
+	LOG_SL(LOG_SECTION_MODEL, L_INFO, "Cached model %s (%d pieces)", modelFilePath.c_str(), model->numPieces);
+}
@@ -0,0 +1,35 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef MODEL_CACHE_H
+#define MODEL_CACHE_H
+
+#include <string>
+
+struct S3DModel;
+
+/**
+ * Binary on-disk cache for parsed Assimp models (.dae, .3ds, .lwo,
+ * .blend). Importing these through Assimp plus the Lua metafile is by
+ * far the slowest model-loading path, so the flattened piece tree is
+ * serialized to a versioned file under the cache-dir after the first
+ * parse and deserialized on subsequent runs. Cache entries are keyed
+ * by a checksum over the model file, its metafile and the format
+ * version, so stale entries self-invalidate when either changes.
+ * The native 3DO/S3O/OBJ parsers are cheap and bypass this entirely.
+ */
+class CModelCache {
+public:
+	// checksum over the contents of the model file and its (optional)
+	// metafile; returns 0 if the model file can not be read, in which
+	// case the cache is skipped and the parser reports its own error
+	static unsigned int CalcModelHash(const std::string& modelFilePath, const std::string& metaFileName);
+
+	// fills <model> from a cache file, returns false if no valid entry
+	// exists; also re-registers the model's textures for preloading
+	static bool Load(S3DModel* model, const std::string& modelFilePath, unsigned int hashCode);
+	static void Save(const S3DModel* model, const std::string& modelFilePath, unsigned int hashCode, bool flipTextures, bool invertTeamColor);
+
+	static bool Enabled();
+};
+
+#endif
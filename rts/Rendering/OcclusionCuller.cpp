@@ -0,0 +1,256 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "OcclusionCuller.h"
+
+#include <algorithm>
+
+#include "Game/Camera.h"
+#include "Map/ReadMap.h"
+#include "Rendering/GL/myGL.h"
+#include "Rendering/GL/VertexArray.h"
+#include "System/Config/ConfigHandler.h"
+
+CONFIG(bool, ObjectOcclusionQueries).defaultValue(false).description("Use hardware occlusion queries to skip rendering units and features hidden behind terrain.");
+
+COcclusionCuller* occlusionCuller = nullptr;
+
+// heightmap squares per occlusion quad; must match the drawQuad
+// granularity of CFeatureDrawer so its quad indices map 1:1
+static const int OCC_QUAD_SIZE = 32;
+
+// horizontal slack of each query box so objects overhanging their
+// quad's footprint are still covered; spheres wider than this can
+// not be decided by a single quad and are never culled
+static const float OCC_RADIUS_MARGIN = 96.0f;
+
+// headroom above the terrain for the objects standing on it; also
+// absorbs stale height bounds after terrain is raised (see below)
+static const float OCC_HEIGHT_MARGIN = 256.0f;
+
+// quads whose terrain height bounds get refreshed per frame
+static const int OCC_QUADS_PER_REFRESH = 64;
+
+
+COcclusionCuller::COcclusionCuller()
+	: numQuadsX(mapDims.mapx / OCC_QUAD_SIZE)
+	, numQuadsY(mapDims.mapy / OCC_QUAD_SIZE)
+	, heightRefreshIdx(0)
+	, enabled(false)
+{
+	quads.resize(numQuadsX * numQuadsY);
+
+	for (OcclusionQuad& q: quads) {
+		q.queryID = 0;
+		q.queryActive = false;
+		q.visible = true;
+		q.minHeight = 0.0f;
+		q.maxHeight = 0.0f;
+	}
+
+#ifdef GLEW_ARB_occlusion_query2
+	if (GLEW_ARB_occlusion_query2 && configHandler->GetBool("ObjectOcclusionQueries")) {
+		GLint bitsSupported;
+		glGetQueryiv(GL_ANY_SAMPLES_PASSED, GL_QUERY_COUNTER_BITS, &bitsSupported);
+		enabled = (bitsSupported > 0);
+	}
+#endif
+
+	if (!enabled)
+		return;
+
+	std::vector<GLuint> queryIDs(quads.size(), 0);
+	glGenQueries(queryIDs.size(), &queryIDs[0]);
+
+	for (size_t n = 0; n < quads.size(); n++) {
+		quads[n].queryID = queryIDs[n];
+	}
+
+	UpdateHeightBounds(0, quads.size());
+}
+
+COcclusionCuller::~COcclusionCuller()
+{
+	if (!enabled)
+		return;
+
+	std::vector<GLuint> queryIDs(quads.size(), 0);
+
+	for (size_t n = 0; n < quads.size(); n++) {
+		queryIDs[n] = quads[n].queryID;
+	}
+
+	glDeleteQueries(queryIDs.size(), &queryIDs[0]);
+}
+
+
+void COcclusionCuller::UpdateHeightBounds(int startIdx, int endIdx)
+{
+	const float* hm = readMap->GetCornerHeightMapUnsynced();
+
+	for (int n = startIdx; n < endIdx; n++) {
+		OcclusionQuad& q = quads[n];
+
+		const int qx = (n % numQuadsX) * OCC_QUAD_SIZE;
+		const int qy = (n / numQuadsX) * OCC_QUAD_SIZE;
+
+		float minH = hm[qy * mapDims.mapxp1 + qx];
+		float maxH = minH;
+
+		for (int y = qy; y <= qy + OCC_QUAD_SIZE; y++) {
+			for (int x = qx; x <= qx + OCC_QUAD_SIZE; x++) {
+				const float h = hm[y * mapDims.mapxp1 + x];
+
+				minH = std::min(minH, h);
+				maxH = std::max(maxH, h);
+			}
+		}
+
+		q.minHeight = minH;
+		q.maxHeight = maxH;
+	}
+}
+
+
+void COcclusionCuller::DrawBox(const float3& mins, const float3& maxs) const
+{
+	CVertexArray* va = GetVertexArray();
+	va->Initialize();
+	va->EnlargeArrays(24, 0, VA_SIZE_0);
+
+	// bottom and top
+	va->AddVertexQ0(mins.x, mins.y, mins.z);
+	va->AddVertexQ0(maxs.x, mins.y, mins.z);
+	va->AddVertexQ0(maxs.x, mins.y, maxs.z);
+	va->AddVertexQ0(mins.x, mins.y, maxs.z);
+	va->AddVertexQ0(mins.x, maxs.y, mins.z);
+	va->AddVertexQ0(maxs.x, maxs.y, mins.z);
+	va->AddVertexQ0(maxs.x, maxs.y, maxs.z);
+	va->AddVertexQ0(mins.x, maxs.y, maxs.z);
+	// -z and +z
+	va->AddVertexQ0(mins.x, mins.y, mins.z);
+	va->AddVertexQ0(maxs.x, mins.y, mins.z);
+	va->AddVertexQ0(maxs.x, maxs.y, mins.z);
+	va->AddVertexQ0(mins.x, maxs.y, mins.z);
+	va->AddVertexQ0(mins.x, mins.y, maxs.z);
+	va->AddVertexQ0(maxs.x, mins.y, maxs.z);
+	va->AddVertexQ0(maxs.x, maxs.y, maxs.z);
+	va->AddVertexQ0(mins.x, maxs.y, maxs.z);
+	// -x and +x
+	va->AddVertexQ0(mins.x, mins.y, mins.z);
+	va->AddVertexQ0(mins.x, mins.y, maxs.z);
+	va->AddVertexQ0(mins.x, maxs.y, maxs.z);
+	va->AddVertexQ0(mins.x, maxs.y, mins.z);
+	va->AddVertexQ0(maxs.x, mins.y, mins.z);
+	va->AddVertexQ0(maxs.x, mins.y, maxs.z);
+	va->AddVertexQ0(maxs.x, maxs.y, maxs.z);
+	va->AddVertexQ0(maxs.x, maxs.y, mins.z);
+
+	va->DrawArray0(GL_QUADS);
+}
+
+
+void COcclusionCuller::RunQueries()
+{
+#ifdef GLEW_ARB_occlusion_query2
+	if (!enabled)
+		return;
+
+	// keep the cached terrain bounds in sync with deformation; a full
+	// sweep would be too expensive per frame, so refresh a few quads
+	// round-robin (the margins absorb the transient staleness)
+	UpdateHeightBounds(heightRefreshIdx, std::min(size_t(heightRefreshIdx + OCC_QUADS_PER_REFRESH), quads.size()));
+	heightRefreshIdx = (heightRefreshIdx + OCC_QUADS_PER_REFRESH) % quads.size();
+
+	const CCamera* cam = CCamera::GetActiveCamera();
+	const float3& camPos = cam->GetPos();
+
+	const float quadSize = OCC_QUAD_SIZE * SQUARE_SIZE;
+
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	glDepthMask(GL_FALSE);
+	glPushAttrib(GL_ENABLE_BIT);
+	glEnable(GL_DEPTH_TEST);
+	glDisable(GL_CULL_FACE);
+
+	for (int n = 0; n < int(quads.size()); n++) {
+		OcclusionQuad& q = quads[n];
+
+		// pick up the previous frame's result without stalling
+		if (q.queryActive) {
+			GLuint avail = 0;
+			glGetQueryObjectuiv(q.queryID, GL_QUERY_RESULT_AVAILABLE, &avail);
+
+			if (avail != 0) {
+				GLuint anySamples = 0;
+				glGetQueryObjectuiv(q.queryID, GL_QUERY_RESULT, &anySamples);
+
+				q.visible = (anySamples != 0);
+				q.queryActive = false;
+			}
+		}
+
+		const float3 mins((n % numQuadsX) * quadSize - OCC_RADIUS_MARGIN, q.minHeight, (n / numQuadsX) * quadSize - OCC_RADIUS_MARGIN);
+		const float3 maxs(mins.x + quadSize + OCC_RADIUS_MARGIN * 2.0f, q.maxHeight + OCC_HEIGHT_MARGIN, mins.z + quadSize + OCC_RADIUS_MARGIN * 2.0f);
+
+		// a camera inside the box sees its contents but none of its
+		// faces, so the query can not decide anything from there
+		if (camPos.x > mins.x && camPos.x < maxs.x && camPos.z > mins.z && camPos.z < maxs.z && camPos.y < maxs.y) {
+			q.visible = true;
+			continue;
+		}
+
+		// the drawers frustum-cull these quads anyway; count them as
+		// visible so no stale result lingers when the camera swings
+		// back over them
+		if (!cam->InView((mins + maxs) * 0.5f, (maxs - mins).Length() * 0.5f)) {
+			q.visible = true;
+			continue;
+		}
+
+		// previous query still in flight, reuse its result for now
+		if (q.queryActive)
+			continue;
+
+		glBeginQuery(GL_ANY_SAMPLES_PASSED, q.queryID);
+		DrawBox(mins, maxs);
+		glEndQuery(GL_ANY_SAMPLES_PASSED);
+
+		q.queryActive = true;
+	}
+
+	glPopAttrib();
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	glDepthMask(GL_TRUE);
+#endif
+}
+
+
+bool COcclusionCuller::QuadVisible(int quadIdx) const
+{
+	if (!enabled)
+		return true;
+
+	return quads[quadIdx].visible;
+}
+
+bool COcclusionCuller::SphereVisible(const float3& mid, float radius) const
+{
+	if (!enabled)
+		return true;
+	if (radius > OCC_RADIUS_MARGIN)
+		return true;
+
+	const float quadSize = OCC_QUAD_SIZE * SQUARE_SIZE;
+
+	const int qx = std::max(0, std::min(numQuadsX - 1, int(mid.x / quadSize)));
+	const int qy = std::max(0, std::min(numQuadsY - 1, int(mid.z / quadSize)));
+
+	const OcclusionQuad& q = quads[qy * numQuadsX + qx];
+
+	if (q.visible)
+		return true;
+
+	// objects poking above the queried box (aircraft, projectiles
+	// carrying units, ...) can not be decided by it
+	return ((mid.y + radius) > (q.maxHeight + OCC_HEIGHT_MARGIN));
+}
@@ -0,0 +1,65 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef OCCLUSION_CULLER_H
+#define OCCLUSION_CULLER_H
+
+#include <vector>
+
+#include "System/float3.h"
+
+/**
+ * Terrain-based occlusion culling for units and features.
+ *
+ * Divides the map into the same 32x32 heightmap-square quads that
+ * CFeatureDrawer buckets features into and issues one bounding-box
+ * occlusion query per in-frustum quad right after the opaque terrain
+ * pass, when the depth buffer contains only ground. Results are read
+ * back without stalling and consumed with one frame of latency; quads
+ * whose queries have not finished (or that just entered the frustum)
+ * count as visible, so culling errs on the side of drawing.
+ */
+class COcclusionCuller {
+public:
+	COcclusionCuller();
+	~COcclusionCuller();
+
+	/// issue the per-quad queries; called right after the terrain pass
+	/// of the normal draw so they have time to finish before readback
+	void RunQueries();
+
+	bool Enabled() const { return enabled; }
+
+	/// result of the last finished query for a linear quad index
+	bool QuadVisible(int quadIdx) const;
+	/// whether any part of a bounding sphere might be visible; spheres
+	/// poking out of their quad's query box can not be decided by it
+	/// and always count as visible
+	bool SphereVisible(const float3& mid, float radius) const;
+
+private:
+	void UpdateHeightBounds(int startIdx, int endIdx);
+	void DrawBox(const float3& mins, const float3& maxs) const;
+
+	struct OcclusionQuad {
+		unsigned int queryID;
+
+		bool queryActive; ///< a query was issued and not yet read back
+		bool visible;     ///< result of the last finished query
+
+		///< terrain height bounds of the quad
+		float minHeight;
+		float maxHeight;
+	};
+
+	std::vector<OcclusionQuad> quads;
+
+	int numQuadsX;
+	int numQuadsY;
+	int heightRefreshIdx; ///< round-robin cursor of UpdateHeightBounds
+
+	bool enabled;
+};
+
+extern COcclusionCuller* occlusionCuller;
+
+#endif // OCCLUSION_CULLER_H
@@ -2,9 +2,11 @@
 
 #include "Screenshot.h"
 
+#include <deque>
 #include <vector>
 
 #include "Rendering/GL/myGL.h"
+#include "Rendering/GL/PixelReadback.h"
 #include "Rendering/GlobalRendering.h"
 #include "Rendering/Textures/Bitmap.h"
 #include "System/StringUtil.h"
@@ -26,6 +28,40 @@ struct FunctionArgs
 	int y;
 };
 
+// async readbacks in flight; filenames are queued in submit order and
+// matched against completed PBO reads in UpdateScreenshots
+static CPixelReadback screenshotReadback;
+static std::deque<std::string> queuedShotFiles;
+
+static void EncodeScreenshot(FunctionArgs&& args)
+{
+	ThreadPool::Enqueue([](const FunctionArgs& args) {
+		CBitmap bmp(&args.pixelbuf[0], args.x, args.y);
+		bmp.ReverseYAxis();
+		bmp.Save(args.filename, true, true);
+	}, std::move(args));
+}
+
+void UpdateScreenshots()
+{
+	while (!queuedShotFiles.empty()) {
+		const bool consumed = screenshotReadback.ConsumeRead(false, [](const unsigned char* data, int sizeX, int sizeY) {
+			FunctionArgs args;
+			args.filename = queuedShotFiles.front();
+			args.x = sizeX;
+			args.y = sizeY;
+			args.pixelbuf.assign(data, data + (sizeX * sizeY * 4));
+
+			EncodeScreenshot(std::move(args));
+		});
+
+		if (!consumed)
+			break;
+
+		queuedShotFiles.pop_front();
+	}
+}
+
 void TakeScreenshot(std::string type)
 {
 	if (type.empty())
@@ -44,15 +80,18 @@ void TakeScreenshot(std::string type)
 	// note: we no longer increment the counter until a "file not found" occurs
 	// since that stalls the thread and might run concurrently with an IL write
 	args.filename.assign("screenshots/screen" + IntToString(shotCounter, "%05d") + "." + type);
-	args.pixelbuf.resize(args.x * args.y * 4);
 
 	configHandler->Set("ScreenshotCounter", shotCounter + 1);
 
+	// read asynchronously when possible; the pixels are collected and
+	// handed to the encoder pool from UpdateScreenshots a frame later
+	if (screenshotReadback.SubmitRead(0, 0, args.x, args.y, GL_RGBA)) {
+		queuedShotFiles.push_back(args.filename);
+		return;
+	}
+
+	args.pixelbuf.resize(args.x * args.y * 4);
 	glReadPixels(0, 0, args.x, args.y, GL_RGBA, GL_UNSIGNED_BYTE, &args.pixelbuf[0]);
 
-	ThreadPool::Enqueue([](const FunctionArgs& args) {
-		CBitmap bmp(&args.pixelbuf[0], args.x, args.y);
-		bmp.ReverseYAxis();
-		bmp.Save(args.filename, true, true);
-	}, args);
+	EncodeScreenshot(std::move(args));
 }
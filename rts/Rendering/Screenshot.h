@@ -7,4 +7,7 @@
 
 void TakeScreenshot(std::string type);
 
+/// collects finished asynchronous readbacks; called once per frame
+void UpdateScreenshots();
+
 #endif
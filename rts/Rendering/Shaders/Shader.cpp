@@ -5,20 +5,24 @@
 #include "Rendering/Shaders/LuaShaderContainer.h"
 #include "Rendering/Shaders/GLSLCopyState.h"
 #include "Rendering/GL/myGL.h"
+#include "Rendering/GL/GlobalUniforms.h"
 #include "Rendering/GlobalRendering.h"
+#include "Rendering/GlobalRenderingInfo.h"
 
 #include "System/SafeUtil.h"
 #include "System/StringUtil.h"
+#include "System/FileSystem/DataDirsAccess.h"
 #include "System/FileSystem/FileHandler.h"
+#include "System/FileSystem/FileQueryFlags.h"
+#include "System/FileSystem/FileSystem.h"
 #include "System/Sync/HsiehHash.h"
 #include "System/Log/ILog.h"
 
 #include "System/Config/ConfigHandler.h"
 
 #include <algorithm>
-#ifdef DEBUG
-	#include <string.h> // strncmp
-#endif
+#include <cstdio>
+#include <cstring>
 
 
 /*****************************************************************/
@@ -35,6 +39,7 @@ LOG_REGISTER_SECTION_GLOBAL(LOG_SECTION_SHADER)
 /*****************************************************************/
 
 CONFIG(bool, UseShaderCache).defaultValue(true).description("If already compiled shaders should be shared via a cache, reducing compiles of already compiled shaders.");
+CONFIG(bool, UseShaderDiskCache).defaultValue(true).description("If linked GLSL program binaries should be cached on disk (requires GL_ARB_get_program_binary), so reloads and first uses of shader permutations skip compilation entirely.");
 
 
 /*****************************************************************/
@@ -80,6 +85,141 @@ static std::string glslGetLog(GLuint obj)
 }
 
 
+/*****************************************************************/
+
+// on-disk cache of linked program binaries; a binary is only valid for
+// the exact driver that produced it, so entries are keyed by the full
+// source hash and carry the driver strings' hash in their header
+static const std::uint32_t SHADERCACHE_MAGIC = 0x43425053; // "SPBC"
+
+struct ProgramBinaryHeader {
+	std::uint32_t magic;
+	std::uint32_t driverHash;
+	std::uint32_t binaryFormat;
+	std::uint32_t binaryLength;
+};
+
+#ifdef GLEW_ARB_get_program_binary
+static unsigned int GetDriverHash()
+{
+	unsigned int hash = 127;
+	hash = HsiehHash(globalRenderingInfo.glVersion,  strlen(globalRenderingInfo.glVersion ), hash);
+	hash = HsiehHash(globalRenderingInfo.glVendor,   strlen(globalRenderingInfo.glVendor  ), hash);
+	hash = HsiehHash(globalRenderingInfo.glRenderer, strlen(globalRenderingInfo.glRenderer), hash);
+	return hash;
+}
+
+static std::string GetProgramBinaryCacheName(unsigned int srcHash)
+{
+	return "cache/shaders/" + IntToString(srcHash, "%x") + ".bin";
+}
+#endif
+
+// tries to restore a linked program from its on-disk binary; returns
+// true iff <objID> ends up linked (stale entries are deleted)
+static bool LoadProgramBinaryFromCache(GLuint objID, unsigned int srcHash)
+{
+#ifdef GLEW_ARB_get_program_binary
+	if (!GLEW_ARB_get_program_binary)
+		return false;
+	if (!configHandler->GetBool("UseShaderDiskCache"))
+		return false;
+
+	const std::string cacheFileName = GetProgramBinaryCacheName(srcHash);
+
+	if (!FileSystem::FileExists(cacheFileName))
+		return false;
+
+	FILE* file = fopen(dataDirsAccess.LocateFile(cacheFileName).c_str(), "rb");
+
+	if (file == nullptr)
+		return false;
+
+	ProgramBinaryHeader header;
+	std::vector<std::uint8_t> binary;
+
+	const bool headerValid =
+		(fread(&header, sizeof(header), 1, file) == 1) &&
+		(header.magic == SHADERCACHE_MAGIC) &&
+		(header.driverHash == GetDriverHash()) &&
+		(header.binaryLength > 0);
+
+	if (headerValid) {
+		binary.resize(header.binaryLength);
+		binary.resize(fread(binary.data(), 1, binary.size(), file));
+	}
+
+	fclose(file);
+
+	if (!headerValid || binary.size() != header.binaryLength) {
+		// entry from another driver or truncated payload
+		FileSystem::Remove(cacheFileName);
+		return false;
+	}
+
+	glProgramBinary(objID, header.binaryFormat, binary.data(), binary.size());
+
+	if (!glslIsValid(objID)) {
+		// same driver strings but incompatible blob (e.g. shader-compiler update)
+		FileSystem::Remove(cacheFileName);
+		return false;
+	}
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+static void SaveProgramBinaryToCache(GLuint objID, unsigned int srcHash)
+{
+#ifdef GLEW_ARB_get_program_binary
+	if (!GLEW_ARB_get_program_binary)
+		return;
+	if (!configHandler->GetBool("UseShaderDiskCache"))
+		return;
+
+	GLint binaryLength = 0;
+	glGetProgramiv(objID, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+
+	if (binaryLength <= 0)
+		return;
+
+	// we need this directory to exist
+	if (!FileSystem::CreateDirectory("cache/shaders"))
+		return;
+
+	ProgramBinaryHeader header;
+	header.magic      = SHADERCACHE_MAGIC;
+	header.driverHash = GetDriverHash();
+
+	std::vector<std::uint8_t> binary(binaryLength);
+
+	GLenum binaryFormat = 0;
+	GLsizei writtenLength = 0;
+	glGetProgramBinary(objID, binaryLength, &writtenLength, &binaryFormat, binary.data());
+
+	if (writtenLength <= 0)
+		return;
+
+	header.binaryFormat = binaryFormat;
+	header.binaryLength = writtenLength;
+
+	FILE* file = fopen(dataDirsAccess.LocateFile(GetProgramBinaryCacheName(srcHash), FileQueryFlags::WRITE).c_str(), "wb");
+
+	if (file == nullptr)
+		return;
+
+	fwrite(&header, sizeof(header), 1, file);
+	fwrite(binary.data(), 1, writtenLength, file);
+	fclose(file);
+#endif
+}
+
+
+/*****************************************************************/
+
+
 static std::string GetShaderSource(const std::string& fileName)
 {
 	if (fileName.find("void main()") != std::string::npos)
@@ -537,30 +677,43 @@ namespace Shader {
 		if (objID == 0) {
 			objID = glCreateProgram();
 
-			bool shadersValid = true;
-			for (IShaderObject*& so: shaderObjs) {
-				assert(dynamic_cast<GLSLShaderObject*>(so));
-
-				auto gso = static_cast<GLSLShaderObject*>(so);
-				auto obj = gso->CompileShaderObject();
-
-				if (obj->valid) {
-					glAttachShader(objID, obj->id);
-				} else {
-					shadersValid = false;
+			// a binary cached on disk by a previous run (or an earlier
+			// permutation switch) skips both compilation and linking
+			if ((valid = LoadProgramBinaryFromCache(objID, curSrcHash))) {
+				log += glslGetLog(objID);
+			} else {
+				bool shadersValid = true;
+				for (IShaderObject*& so: shaderObjs) {
+					assert(dynamic_cast<GLSLShaderObject*>(so));
+
+					auto gso = static_cast<GLSLShaderObject*>(so);
+					auto obj = gso->CompileShaderObject();
+
+					if (obj->valid) {
+						glAttachShader(objID, obj->id);
+					} else {
+						shadersValid = false;
+					}
 				}
-			}
 
-			if (!shadersValid)
-				return;
+				if (!shadersValid)
+					return;
+
+			#ifdef GLEW_ARB_get_program_binary
+				if (GLEW_ARB_get_program_binary)
+					glProgramParameteri(objID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+			#endif
 
-			glLinkProgram(objID);
+				glLinkProgram(objID);
 
-			valid = glslIsValid(objID);
-			log += glslGetLog(objID);
+				valid = glslIsValid(objID);
+				log += glslGetLog(objID);
 
-			if (!IsValid()) {
-				LOG_L(L_WARNING, "[GLSL-PO::%s] program-object name: %s, link-log:\n%s\n", __FUNCTION__, name.c_str(), log.c_str());
+				if (!IsValid()) {
+					LOG_L(L_WARNING, "[GLSL-PO::%s] program-object name: %s, link-log:\n%s\n", __FUNCTION__, name.c_str(), log.c_str());
+				} else {
+					SaveProgramBinaryToCache(objID, curSrcHash);
+				}
 			}
 		} else {
 			valid = true;
@@ -574,6 +727,10 @@ namespace Shader {
 		if (IsValid())
 			GLSLCopyState(objID, oldValid ? oldProgID : 0, &uniformStates);
 
+		// attach the shared per-frame uniform block (if declared)
+		if (IsValid())
+			CGlobalUniforms::BindUniformBlock(objID);
+
 		// delete old program when not further used
 		if (deleteOldShader)
 			glDeleteProgram(oldProgID);
@@ -58,6 +58,18 @@ void CShaderHandler::ReloadAll() {
 	}
 }
 
+void CShaderHandler::WarmAll() {
+	// compile or relink every program whose flag-state changed since its
+	// last link (or that was never linked at all), so the permutations
+	// reachable from the current settings are ready before the first
+	// frame instead of hitching on their first Enable() mid-game
+	for (auto it = programObjects.cbegin(); it != programObjects.cend(); ++it) {
+		for (auto jt = it->second.cbegin(); jt != it->second.cend(); ++jt) {
+			(jt->second)->RecompileIfNeeded(false);
+		}
+	}
+}
+
 bool CShaderHandler::ReleaseProgramObjects(const std::string& poClass) {
 	if (programObjects.find(poClass) == programObjects.end())
 		return false;
@@ -25,6 +25,7 @@ public:
 	static void FreeInstance(CShaderHandler*);
 
 	void ReloadAll();
+	void WarmAll();
 	bool ReleaseProgramObjects(const std::string& poClass);
 	void ReleaseProgramObjectsMap(ProgramObjMap& poMap);
 
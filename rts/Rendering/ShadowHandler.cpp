@@ -1,14 +1,17 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 #include <cfloat>
+#include <cstring>
 
 #include "ShadowHandler.h"
 #include "Game/Camera.h"
 #include "Game/GameVersion.h"
 #include "Map/BaseGroundDrawer.h"
 #include "Map/Ground.h"
+#include "Map/MapDamage.h"
 #include "Map/MapInfo.h"
 #include "Map/ReadMap.h"
 #include "Rendering/GlobalRendering.h"
+#include "Rendering/GL/GlobalUniforms.h"
 #include "Rendering/FeatureDrawer.h"
 #include "Rendering/Env/Particles/ProjectileDrawer.h"
 #include "Rendering/UnitDrawer.h"
@@ -17,6 +20,7 @@
 #include "Rendering/Env/ITreeDrawer.h"
 #include "Rendering/GL/FBO.h"
 #include "Rendering/GL/myGL.h"
+#include "Rendering/GL/StateCache.h"
 #include "Rendering/Shaders/ShaderHandler.h"
 #include "Rendering/Shaders/Shader.h"
 #include "System/Config/ConfigHandler.h"
@@ -78,6 +82,10 @@ void CShadowHandler::Init()
 	shadowTexture = 0;
 	dummyColorTexture = 0;
 
+	staticShadowTexture = 0;
+	staticCacheTerrainEpoch = 0;
+	staticCacheValid = false;
+
 	if (!tmpFirstInit && !shadowsSupported)
 		return;
 
@@ -155,8 +163,17 @@ void CShadowHandler::FreeTextures() {
 		fb.Unbind();
 	}
 
-	glDeleteTextures(1, &shadowTexture    ); shadowTexture     = 0;
-	glDeleteTextures(1, &dummyColorTexture); dummyColorTexture = 0;
+	if (staticFb.IsValid()) {
+		staticFb.Bind();
+		staticFb.DetachAll();
+		staticFb.Unbind();
+	}
+
+	glDeleteTextures(1, &shadowTexture      ); shadowTexture       = 0;
+	glDeleteTextures(1, &dummyColorTexture  ); dummyColorTexture   = 0;
+	glDeleteTextures(1, &staticShadowTexture); staticShadowTexture = 0;
+
+	staticCacheValid = false;
 }
 
 
@@ -303,11 +320,54 @@ bool CShadowHandler::InitDepthTarget()
 
 	if (!status && !useColorTexture)
 		status = WorkaroundUnsupportedFboRenderTargets();
+	else if (status && !useColorTexture)
+		InitStaticDepthTarget();
 
 	fb.Unbind();
 	return status;
 }
 
+bool CShadowHandler::InitStaticDepthTarget()
+{
+	// the cached layer is composited into <fb> with a depth-blit, which
+	// requires the blit extension and matching depth formats; skip the
+	// cache when the main target went through one of the workaround
+	// formats above (DrawCachedMapShadowPass then degrades to drawing
+	// the terrain directly every frame)
+	if (!GLEW_EXT_framebuffer_blit)
+		return false;
+
+	if (!staticFb.IsValid())
+		return false;
+
+	staticFb.Bind();
+
+	glGenTextures(1, &staticShadowTexture);
+	glBindTexture(GL_TEXTURE_2D, staticShadowTexture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	// never sampled by shaders, only blitted from
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_DEPTH_TEXTURE_MODE, GL_LUMINANCE);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32, shadowMapSize, shadowMapSize, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+
+	staticFb.AttachTexture(staticShadowTexture, GL_TEXTURE_2D, GL_DEPTH_ATTACHMENT_EXT);
+
+	glDrawBuffer(GL_NONE);
+
+	const bool status = staticFb.CheckStatus("SHADOW-STATIC");
+
+	if (!status) {
+		staticFb.Detach(GL_DEPTH_ATTACHMENT_EXT);
+		glDeleteTextures(1, &staticShadowTexture);
+		staticShadowTexture = 0;
+	}
+
+	fb.Bind();
+	return status;
+}
+
 
 bool CShadowHandler::WorkaroundUnsupportedFboRenderTargets()
 {
@@ -371,6 +431,24 @@ void CShadowHandler::DrawShadowPasses()
 		glEnable(GL_CULL_FACE);
 		glCullFace(GL_BACK);
 
+		// cull front-faces during the terrain shadow pass: sun direction
+		// can be set so oblique that geometry back-faces are visible (eg.
+		// from hills near map edges) from its POV
+		//
+		// not the best idea, causes acne when projecting the shadow-map
+		// (rasterizing back-faces writes different depth values) and is
+		// no longer required since border geometry will fully hide them
+		// (could just disable culling of terrain faces entirely, but we
+		// also want to prevent overdraw in low-angle passes)
+		// glCullFace(GL_FRONT);
+
+			// the terrain layer has to come first: compositing it is a
+			// depth-blit which replaces the buffer contents outright,
+			// while the depth-tested dynamic passes below merge into
+			// it in any order
+			if ((shadowGenBits & SHADOWGEN_BIT_MAP) != 0)
+				DrawCachedMapShadowPass();
+
 			eventHandler.DrawWorldShadow();
 
 			if ((shadowGenBits & SHADOWGEN_BIT_TREE) != 0) {
@@ -386,24 +464,49 @@ void CShadowHandler::DrawShadowPasses()
 				featureDrawer->DrawShadowPass();
 			}
 
-		// cull front-faces during the terrain shadow pass: sun direction
-		// can be set so oblique that geometry back-faces are visible (eg.
-		// from hills near map edges) from its POV
-		//
-		// not the best idea, causes acne when projecting the shadow-map
-		// (rasterizing back-faces writes different depth values) and is
-		// no longer required since border geometry will fully hide them
-		// (could just disable culling of terrain faces entirely, but we
-		// also want to prevent overdraw in low-angle passes)
-		// glCullFace(GL_FRONT);
-			if ((shadowGenBits & SHADOWGEN_BIT_MAP) != 0)
-				readMap->GetGroundDrawer()->DrawShadowPass();
-
 	glPopAttrib();
 
 	inShadowPass = false;
 }
 
+void CShadowHandler::DrawCachedMapShadowPass()
+{
+	CBaseGroundDrawer* gd = readMap->GetGroundDrawer();
+
+	// no usable static target, draw the terrain directly as before
+	if (staticShadowTexture == 0) {
+		gd->DrawShadowPass();
+		return;
+	}
+
+	const CMatrix44f& vm = viewMatrix[SHADOWMAT_TYPE_DRAWING];
+	const CMatrix44f& pm = projMatrix[SHADOWMAT_TYPE_DRAWING];
+
+	const bool lightMoved =
+		(memcmp(vm.m, staticCacheViewMatrix.m, sizeof(vm.m)) != 0) ||
+		(memcmp(pm.m, staticCacheProjMatrix.m, sizeof(pm.m)) != 0);
+
+	if (!staticCacheValid || lightMoved || staticCacheTerrainEpoch != mapDamage->terrainChangeEpoch) {
+		staticFb.Bind();
+		glClear(GL_DEPTH_BUFFER_BIT);
+		gd->DrawShadowPass();
+		fb.Bind();
+
+		staticCacheViewMatrix = vm;
+		staticCacheProjMatrix = pm;
+		staticCacheTerrainEpoch = mapDamage->terrainChangeEpoch;
+		staticCacheValid = true;
+	}
+
+	// composite the cached layer; done every frame since CreateShadows
+	// cleared the depth buffer (both targets use GL_DEPTH_COMPONENT32,
+	// see InitStaticDepthTarget, so the blit is well-defined)
+	glBindFramebufferEXT(GL_READ_FRAMEBUFFER_EXT, staticFb.fboId);
+	glBindFramebufferEXT(GL_DRAW_FRAMEBUFFER_EXT, fb.fboId);
+	glBlitFramebufferEXT(0, 0, shadowMapSize, shadowMapSize,  0, 0, shadowMapSize, shadowMapSize,  GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, fb.fboId);
+}
+
 void CShadowHandler::SetShadowMapSizeFactors()
 {
 	#if (SHADOWMATRIX_NONLINEAR == 1)
@@ -523,12 +626,12 @@ void CShadowHandler::SetShadowCamera(CCamera* shadowCam)
 
 void CShadowHandler::SetupShadowTexSampler(unsigned int texUnit, bool enable) const
 {
-	glActiveTexture(texUnit);
-	glBindTexture(GL_TEXTURE_2D, shadowTexture);
+	GL::ActiveTexture(texUnit);
+	GL::BindTexture(GL_TEXTURE_2D, shadowTexture);
 
 	// support FFP context
 	if (enable)
-		glEnable(GL_TEXTURE_2D);
+		GL::Enable(GL_TEXTURE_2D);
 
 	SetupShadowTexSamplerRaw();
 }
@@ -544,11 +647,11 @@ void CShadowHandler::SetupShadowTexSamplerRaw() const
 
 void CShadowHandler::ResetShadowTexSampler(unsigned int texUnit, bool disable) const
 {
-	glActiveTexture(texUnit);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	GL::ActiveTexture(texUnit);
+	GL::BindTexture(GL_TEXTURE_2D, 0);
 
 	if (disable)
-		glDisable(GL_TEXTURE_2D);
+		GL::Disable(GL_TEXTURE_2D);
 
 	ResetShadowTexSamplerRaw();
 }
@@ -589,6 +692,9 @@ void CShadowHandler::CreateShadows()
 	SetShadowMatrix(prvCam, curCam);
 	SetShadowCamera(curCam);
 
+	// shadow fields of the shared uniform block
+	globalUniforms.UpdateShadow();
+
 	if (globalRendering->haveARB) {
 		// set the shadow-parameter registers
 		// NOTE: so long as any part of Spring rendering still uses
@@ -84,9 +84,11 @@ private:
 	void FreeTextures();
 
 	bool InitDepthTarget();
+	bool InitStaticDepthTarget();
 	bool WorkaroundUnsupportedFboRenderTargets();
 
 	void DrawShadowPasses();
+	void DrawCachedMapShadowPass();
 	void LoadProjectionMatrix(const CCamera* shadowCam);
 	void LoadShadowGenShaders();
 
@@ -133,6 +135,16 @@ private:
 	CMatrix44f viewMatrix[2];
 
 	FBO fb;
+
+	// cached static-caster (terrain) depth layer; re-rendered only
+	// when the light-space matrices or the terrain change, otherwise
+	// blitted into the shadow map before the dynamic-caster passes
+	FBO staticFb;
+	unsigned int staticShadowTexture;
+	unsigned int staticCacheTerrainEpoch;
+	bool staticCacheValid;
+	CMatrix44f staticCacheViewMatrix;
+	CMatrix44f staticCacheProjMatrix;
 };
 
 extern CShadowHandler* shadowHandler;
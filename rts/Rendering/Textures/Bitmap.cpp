@@ -27,6 +27,11 @@
 #include "System/FileSystem/FileSystem.h"
 #include "System/Threading/SpringThreading.h"
 
+#if (defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)))
+	#define BITMAP_USE_SSE2 1
+	#include <emmintrin.h>
+#endif
+
 
 spring::mutex devilMutex; // devil functions, whilst expensive, aren't thread-save
 
@@ -233,8 +238,14 @@ bool CBitmap::Load(std::string const& filename, unsigned char defaultAlpha)
 		return false;
 	}
 
-	std::vector<unsigned char> buffer(file.FileSize() + 2);
-	file.Read(buffer.data(), file.FileSize());
+	// parse straight from the VFS buffer or the file mapping, no copy
+	size_t fileDataSize = 0;
+	const std::uint8_t* fileData = file.GetView(fileDataSize);
+
+	if (fileData == nullptr) {
+		AllocDummy();
+		return false;
+	}
 
 	std::lock_guard<spring::mutex> lck(devilMutex);
 	ilOriginFunc(IL_ORIGIN_UPPER_LEFT);
@@ -248,7 +259,7 @@ bool CBitmap::Load(std::string const& filename, unsigned char defaultAlpha)
 		// do not signal floating point exceptions in devil library
 		ScopedDisableFpuExceptions fe;
 
-		const bool success = !!ilLoadL(IL_TYPE_UNKNOWN, buffer.data(), file.FileSize());
+		const bool success = !!ilLoadL(IL_TYPE_UNKNOWN, fileData, fileDataSize);
 
 		//FPU control word has to be restored as well
 		streflop::streflop_init<streflop::Simple>();
@@ -301,8 +312,11 @@ bool CBitmap::LoadGrayscale(const std::string& filename)
 	if (!file.FileExists())
 		return false;
 
-	std::vector<unsigned char> buffer(file.FileSize() + 1);
-	file.Read(buffer.data(), file.FileSize());
+	size_t fileDataSize = 0;
+	const std::uint8_t* fileData = file.GetView(fileDataSize);
+
+	if (fileData == nullptr)
+		return false;
 
 	std::lock_guard<spring::mutex> lck(devilMutex);
 	ilOriginFunc(IL_ORIGIN_UPPER_LEFT);
@@ -312,7 +326,7 @@ bool CBitmap::LoadGrayscale(const std::string& filename)
 	ilGenImages(1, &imageID);
 	ilBindImage(imageID);
 
-	const bool success = !!ilLoadL(IL_TYPE_UNKNOWN, buffer.data(), file.FileSize());
+	const bool success = !!ilLoadL(IL_TYPE_UNKNOWN, fileData, fileDataSize);
 	ilDisable(IL_ORIGIN_SET);
 
 	if (!success)
@@ -503,10 +517,10 @@ bool CBitmap::SaveFloat(std::string const& filename) const
 
 
 #ifndef BITMAP_NO_OPENGL
-unsigned int CBitmap::CreateTexture(float aniso, bool mipmaps) const
+unsigned int CBitmap::CreateTexture(float aniso, bool mipmaps, unsigned int texID) const
 {
 	if (compressed)
-		return CreateDDSTexture(0, aniso, mipmaps);
+		return CreateDDSTexture(texID, aniso, mipmaps);
 
 	if (mem.empty())
 		return 0;
@@ -516,12 +530,14 @@ unsigned int CBitmap::CreateTexture(float aniso, bool mipmaps) const
 	// GL_ARB_texture_non_power_of_two indicates that the hardware will actually support it.
 	if (!globalRendering->supportNonPowerOfTwoTex && (xsize != next_power_of_2(xsize) || ysize != next_power_of_2(ysize))) {
 		CBitmap bm = CreateRescaled(next_power_of_2(xsize), next_power_of_2(ysize));
-		return bm.CreateTexture(aniso, mipmaps);
+		return bm.CreateTexture(aniso, mipmaps, texID);
 	}
 
-	unsigned int texture;
+	unsigned int texture = texID;
+
+	if (texture == 0)
+		glGenTextures(1, &texture);
 
-	glGenTextures(1, &texture);
 	glBindTexture(GL_TEXTURE_2D, texture);
 
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -622,7 +638,7 @@ unsigned int CBitmap::CreateDDSTexture(unsigned int texID, float aniso, bool mip
 }
 #else  // !BITMAP_NO_OPENGL
 
-unsigned int CBitmap::CreateTexture(float aniso, bool mipmaps) const {
+unsigned int CBitmap::CreateTexture(float aniso, bool mipmaps, unsigned int texID) const {
 	return 0;
 }
 
@@ -863,23 +879,16 @@ CBitmap CBitmap::CreateRescaled(int newx, int newy) const
 	const float dx = (float) xsize / newx;
 	const float dy = (float) ysize / newy;
 
-	float cy = 0;
-	for (int y=0; y < newy; ++y) {
-		const int sy = (int) cy;
-		cy += dy;
-		int ey = (int) cy;
-		if (ey == sy) {
-			ey = sy+1;
-		}
+	// the source range of a destination row only depends on its own index,
+	// so rows can be filled independently across the pool; rescaling 4K+
+	// textures to power-of-two sizes is a visible load-stage cost
+	for_mt(0, newy, [&](const int y) {
+		const int sy = std::min((int) (y * dy), ysize - 1);
+		const int ey = std::max(sy + 1, std::min((int) ((y + 1) * dy), ysize));
 
-		float cx = 0;
 		for (int x=0; x < newx; ++x) {
-			const int sx = (int) cx;
-			cx += dx;
-			int ex = (int) cx;
-			if (ex == sx) {
-				ex = sx + 1;
-			}
+			const int sx = std::min((int) (x * dx), xsize - 1);
+			const int ex = std::max(sx + 1, std::min((int) ((x + 1) * dx), xsize));
 
 			int r=0, g=0, b=0, a=0;
 			for (int y2 = sy; y2 < ey; ++y2) {
@@ -898,7 +907,7 @@ CBitmap CBitmap::CreateRescaled(int newx, int newy) const
 			bm.mem[index + 2] = b / denom;
 			bm.mem[index + 3] = a / denom;
 		}
-	}
+	});
 
 	return bm;
 }
@@ -909,14 +918,27 @@ void CBitmap::InvertColors()
 	if (compressed) {
 		return;
 	}
-	for (int y = 0; y < ysize; ++y) {
-		for (int x = 0; x < xsize; ++x) {
-			const int base = ((y * xsize) + x) * 4;
-			mem[base + 0] = 0xFF - mem[base + 0];
-			mem[base + 1] = 0xFF - mem[base + 1];
-			mem[base + 2] = 0xFF - mem[base + 2];
-			// do not invert alpha
-		}
+
+	const int numPixels = xsize * ysize;
+
+	int i = 0;
+
+	#ifdef BITMAP_USE_SSE2
+	// xor the RGB bytes of four pixels at a time (0xFF - v == v ^ 0xFF)
+	const __m128i rgbMask = _mm_set1_epi32(0x00FFFFFF);
+
+	for (; i <= (numPixels - 4); i += 4) {
+		unsigned char* p = &mem[i * 4];
+		_mm_storeu_si128((__m128i*) p, _mm_xor_si128(_mm_loadu_si128((const __m128i*) p), rgbMask));
+	}
+	#endif
+
+	for (; i < numPixels; ++i) {
+		const int base = i * 4;
+		mem[base + 0] = 0xFF - mem[base + 0];
+		mem[base + 1] = 0xFF - mem[base + 1];
+		mem[base + 2] = 0xFF - mem[base + 2];
+		// do not invert alpha
 	}
 }
 
@@ -926,11 +948,21 @@ void CBitmap::InvertAlpha()
 	if (compressed)
 		return; // Don't try to invert DDS
 
-	for (int y = 0; y < ysize; ++y) {
-		for (int x = 0; x < xsize; ++x) {
-			const int base = ((y * xsize) + x) * 4;
-			mem[base + 3] = 0xFF - mem[base + 3];
-		}
+	const int numPixels = xsize * ysize;
+
+	int i = 0;
+
+	#ifdef BITMAP_USE_SSE2
+	const __m128i alphaMask = _mm_set1_epi32(int(0xFF000000));
+
+	for (; i <= (numPixels - 4); i += 4) {
+		unsigned char* p = &mem[i * 4];
+		_mm_storeu_si128((__m128i*) p, _mm_xor_si128(_mm_loadu_si128((const __m128i*) p), alphaMask));
+	}
+	#endif
+
+	for (; i < numPixels; ++i) {
+		mem[i * 4 + 3] = 0xFF - mem[i * 4 + 3];
 	}
 }
 
@@ -940,7 +972,7 @@ void CBitmap::MakeGrayScale()
 	if (compressed)
 		return;
 
-	for (int y = 0; y < ysize; ++y) {
+	for_mt(0, ysize, [&](const int y) {
 		for (int x = 0; x < xsize; ++x) {
 			const int base = ((y * xsize) + x) * 4;
 			const float illum =
@@ -953,7 +985,7 @@ void CBitmap::MakeGrayScale()
 			mem[base + 1] = cval;
 			mem[base + 2] = cval;
 		}
-	}
+	});
 }
 
 static ILubyte TintByte(ILubyte value, float tint)
@@ -969,7 +1001,7 @@ void CBitmap::Tint(const float tint[3])
 	if (compressed) {
 		return;
 	}
-	for (int y = 0; y < ysize; y++) {
+	for_mt(0, ysize, [&](const int y) {
 		for (int x = 0; x < xsize; x++) {
 			const int base = ((y * xsize) + x) * 4;
 			mem[base + 0] = TintByte(mem[base + 0], tint[0]);
@@ -977,7 +1009,7 @@ void CBitmap::Tint(const float tint[3])
 			mem[base + 2] = TintByte(mem[base + 2], tint[2]);
 			// don't touch the alpha channel
 		}
-	}
+	});
 }
 
 
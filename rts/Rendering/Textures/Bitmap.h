@@ -38,7 +38,7 @@ public:
 	bool Save(std::string const& filename, bool opaque = true, bool logged = false) const;
 	bool SaveFloat(std::string const& filename) const;
 
-	unsigned int CreateTexture(float aniso = 0.0f, bool mipmaps = false) const;
+	unsigned int CreateTexture(float aniso = 0.0f, bool mipmaps = false, unsigned int texID = 0) const;
 	unsigned int CreateMipMapTexture(float aniso = 0.0f) const { return (CreateTexture(aniso, true)); }
 	unsigned int CreateAnisoTexture(float aniso = 0.0f) const { return (CreateTexture(aniso, false)); }
 	unsigned int CreateDDSTexture(unsigned int texID = 0, float aniso = 0.0f, bool mipmaps = false) const;
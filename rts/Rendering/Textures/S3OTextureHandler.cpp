@@ -10,6 +10,7 @@
 #include "Rendering/UnitDrawer.h"
 #include "Rendering/Models/3DModel.h"
 #include "Rendering/Textures/Bitmap.h"
+#include "Rendering/Textures/TextureUploadService.h"
 #include "System/StringUtil.h"
 #include "System/Exceptions.h"
 #include "System/Log/ILog.h"
@@ -138,13 +139,20 @@ unsigned int CS3OTextureHandler::LoadAndCacheTexture(
 	if (preloadCall)
 		return 0;
 
-	const unsigned int texID = bitmap->CreateMipMapTexture();
+	const unsigned int xsize = bitmap->xsize;
+	const unsigned int ysize = bitmap->ysize;
 
-	textureCache[textureName] = {
-		texID,
-		static_cast<unsigned int>(bitmap->xsize),
-		static_cast<unsigned int>(bitmap->ysize)
-	};
+	unsigned int texID = 0;
+
+	if (texUploadService != nullptr && texUploadService->Enabled()) {
+		// the worker publishes the name once the upload is flushed;
+		// until then the model samples an incomplete (black) texture
+		texID = texUploadService->UploadAsync(std::move(*bitmap), 0.0f, true);
+	} else {
+		texID = bitmap->CreateMipMapTexture();
+	}
+
+	textureCache[textureName] = { texID, xsize, ysize };
 
 	bitmapCache.erase(textureName);
 	return texID;
@@ -0,0 +1,139 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "lib/streflop/streflop_cond.h" //! must happen before OffscreenGLContext.h, which includes agl.h
+#include "TextureUploadService.h"
+
+#include "Rendering/GL/myGL.h"
+#include "System/Config/ConfigHandler.h"
+#include "System/Exceptions.h"
+#include "System/Log/ILog.h"
+#include "System/MainDefines.h"
+#include "System/OffscreenGLContext.h"
+#include "System/SafeUtil.h"
+#include "System/Platform/errorhandler.h"
+#include "System/Platform/Threading.h"
+
+CONFIG(bool, AsyncTextureUploads).defaultValue(true).description("If model textures loaded at runtime should be uploaded from a worker thread (sharing the main GL context) instead of stalling draw frames.");
+
+CTextureUploadService* texUploadService = nullptr;
+
+
+void CTextureUploadService::Init()
+{
+#ifndef HEADLESS
+	if (!configHandler->GetBool("AsyncTextureUploads"))
+		return;
+
+	try {
+		// shares textures with the context current on the calling thread
+		glContext = new COffscreenGLContext();
+	} catch (const opengl_error& gle) {
+		LOG_L(L_WARNING, "[%s] no offscreen GL context, texture uploads stay synchronous (%s)", __func__, gle.what());
+		return;
+	}
+
+	stopThread = false;
+	uploadThread = new spring::thread(std::bind(&CTextureUploadService::UploadLoop, this));
+#endif
+}
+
+void CTextureUploadService::Kill()
+{
+	if (uploadThread != nullptr) {
+		{
+			std::unique_lock<spring::mutex> lock(queueMutex);
+			stopThread = true;
+		}
+
+		// the worker drains any queued uploads before exiting
+		queueCondVar.notify_all();
+		uploadThread->join();
+	}
+
+	spring::SafeDelete(uploadThread);
+	spring::SafeDelete(glContext);
+}
+
+
+unsigned int CTextureUploadService::UploadAsync(CBitmap&& bitmap, float aniso, bool mipmaps)
+{
+	assert(Enabled());
+
+	unsigned int texID = 0;
+	glGenTextures(1, &texID);
+
+	{
+		std::unique_lock<spring::mutex> lock(queueMutex);
+
+		uploadQueue.emplace_back();
+		UploadRequest& req = uploadQueue.back();
+
+		req.bitmap = std::move(bitmap);
+		req.texID = texID;
+		req.aniso = aniso;
+		req.mipmaps = mipmaps;
+
+		pendingTexIDs.insert(texID);
+	}
+
+	queueCondVar.notify_all();
+	return texID;
+}
+
+
+bool CTextureUploadService::IsComplete(unsigned int texID)
+{
+	if (!Enabled())
+		return true;
+
+	std::unique_lock<spring::mutex> lock(queueMutex);
+	return (pendingTexIDs.find(texID) == pendingTexIDs.end());
+}
+
+void CTextureUploadService::WaitFor(unsigned int texID)
+{
+	if (!Enabled())
+		return;
+
+	std::unique_lock<spring::mutex> lock(queueMutex);
+	doneCondVar.wait(lock, [&]() { return (pendingTexIDs.find(texID) == pendingTexIDs.end()); });
+}
+
+
+__FORCE_ALIGN_STACK__
+void CTextureUploadService::UploadLoop()
+{
+	Threading::SetThreadName("TexUpload");
+
+	try {
+		glContext->WorkerThreadPost();
+	} CATCH_SPRING_ERRORS
+
+	// fpu exceptions are per-thread
+	streflop::streflop_init<streflop::Simple>();
+
+	for (;;) {
+		std::unique_lock<spring::mutex> lock(queueMutex);
+		queueCondVar.wait(lock, [&]() { return (stopThread || !uploadQueue.empty()); });
+
+		if (uploadQueue.empty()) {
+			assert(stopThread);
+			break;
+		}
+
+		UploadRequest req = std::move(uploadQueue.front());
+		uploadQueue.pop_front();
+		lock.unlock();
+
+		req.bitmap.CreateTexture(req.aniso, req.mipmaps, req.texID);
+		// make the finished texture object visible to the main context
+		// before publishing its name as complete
+		glFinish();
+
+		lock.lock();
+		pendingTexIDs.erase(req.texID);
+		doneCondVar.notify_all();
+	}
+
+	glContext->WorkerThreadFree();
+}
@@ -0,0 +1,65 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef TEXTURE_UPLOAD_SERVICE_H
+#define TEXTURE_UPLOAD_SERVICE_H
+
+#include <deque>
+
+#include "Bitmap.h"
+#include "System/Threading/SpringThreading.h"
+#include "System/UnorderedSet.hpp"
+
+class COffscreenGLContext;
+
+/**
+ * Performs texture uploads on a worker thread owning a GL context shared
+ * with the main one, so multi-megabyte glTexImage + mipmap-generation
+ * calls (eg. when a new unit type first appears mid-game) no longer
+ * stall draw frames. Texture names are generated in the caller's context
+ * and returned immediately; the texture object becomes complete once the
+ * worker has finished and flushed the upload. Callers that must sample
+ * a finished texture can block on WaitFor().
+ */
+class CTextureUploadService
+{
+public:
+	CTextureUploadService(): glContext(nullptr), uploadThread(nullptr), stopThread(false) {}
+	~CTextureUploadService() { Kill(); }
+
+	void Init();
+	void Kill();
+
+	bool Enabled() const { return (uploadThread != nullptr); }
+
+	/// takes ownership of the bitmap, returns the texture name at once
+	unsigned int UploadAsync(CBitmap&& bitmap, float aniso, bool mipmaps);
+
+	bool IsComplete(unsigned int texID);
+	void WaitFor(unsigned int texID);
+
+private:
+	struct UploadRequest {
+		CBitmap bitmap;
+		unsigned int texID;
+		float aniso;
+		bool mipmaps;
+	};
+
+	void UploadLoop();
+
+	std::deque<UploadRequest> uploadQueue;
+	spring::unordered_set<unsigned int> pendingTexIDs;
+
+	spring::mutex queueMutex;
+	spring::condition_variable queueCondVar; // signalled when work arrives
+	spring::condition_variable doneCondVar;  // signalled when an upload completes
+
+	COffscreenGLContext* glContext;
+	spring::thread* uploadThread;
+
+	bool stopThread;
+};
+
+extern CTextureUploadService* texUploadService;
+
+#endif /* TEXTURE_UPLOAD_SERVICE_H */
@@ -20,10 +20,12 @@
 #include "Rendering/Env/CubeMapHandler.h"
 #include "Rendering/FarTextureHandler.h"
 #include "Rendering/GL/glExtra.h"
+#include "Rendering/GL/StateCache.h"
 #include "Rendering/GL/VertexArray.h"
 #include "Rendering/Env/IGroundDecalDrawer.h"
 #include "Rendering/IconHandler.h"
 #include "Rendering/LuaObjectDrawer.h"
+#include "Rendering/OcclusionCuller.h"
 #include "Rendering/ShadowHandler.h"
 #include "Rendering/Shaders/Shader.h"
 #include "Rendering/Textures/Bitmap.h"
@@ -44,6 +46,7 @@
 #include "System/EventHandler.h"
 #include "System/myMath.h"
 #include "System/SafeUtil.h"
+#include "System/Threading/ThreadPool.h"
 
 #define UNIT_SHADOW_ALPHA_MASKING
 
@@ -63,17 +66,17 @@ CONFIG(bool, AdvUnitShading).defaultValue(true).headlessValue(false).safemodeVal
 
 
 static const void BindOpaqueTex(const CS3OTextureHandler::S3OTexMat* textureMat) {
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, textureMat->tex2);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, textureMat->tex1);
+	GL::ActiveTexture(GL_TEXTURE1);
+	GL::BindTexture(GL_TEXTURE_2D, textureMat->tex2);
+	GL::ActiveTexture(GL_TEXTURE0);
+	GL::BindTexture(GL_TEXTURE_2D, textureMat->tex1);
 }
 
 static const void BindOpaqueTexAtlas(const CS3OTextureHandler::S3OTexMat*) {
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, texturehandler3DO->GetAtlasTex2ID());
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, texturehandler3DO->GetAtlasTex1ID());
+	GL::ActiveTexture(GL_TEXTURE1);
+	GL::BindTexture(GL_TEXTURE_2D, texturehandler3DO->GetAtlasTex2ID());
+	GL::ActiveTexture(GL_TEXTURE0);
+	GL::BindTexture(GL_TEXTURE_2D, texturehandler3DO->GetAtlasTex1ID());
 }
 static const void BindOpaqueTexDummy(const CS3OTextureHandler::S3OTexMat*) {}
 
@@ -81,28 +84,28 @@ static const void BindShadowTexDummy(const CS3OTextureHandler::S3OTexMat*) {}
 static const void KillShadowTexDummy(const CS3OTextureHandler::S3OTexMat*) {}
 
 static const void BindShadowTex(const CS3OTextureHandler::S3OTexMat* textureMat) {
-	glActiveTexture(GL_TEXTURE0);
-	glEnable(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, textureMat->tex2);
+	GL::ActiveTexture(GL_TEXTURE0);
+	GL::Enable(GL_TEXTURE_2D);
+	GL::BindTexture(GL_TEXTURE_2D, textureMat->tex2);
 }
 
 static const void KillShadowTex(const CS3OTextureHandler::S3OTexMat*) {
-	glBindTexture(GL_TEXTURE_2D, 0);
-	glDisable(GL_TEXTURE_2D);
-	glActiveTexture(GL_TEXTURE0);
+	GL::BindTexture(GL_TEXTURE_2D, 0);
+	GL::Disable(GL_TEXTURE_2D);
+	GL::ActiveTexture(GL_TEXTURE0);
 }
 
 
 static const void BindShadowTexAtlas(const CS3OTextureHandler::S3OTexMat*) {
-	glActiveTexture(GL_TEXTURE0);
-	glEnable(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, texturehandler3DO->GetAtlasTex2ID());
+	GL::ActiveTexture(GL_TEXTURE0);
+	GL::Enable(GL_TEXTURE_2D);
+	GL::BindTexture(GL_TEXTURE_2D, texturehandler3DO->GetAtlasTex2ID());
 }
 
 static const void KillShadowTexAtlas(const CS3OTextureHandler::S3OTexMat*) {
-	glBindTexture(GL_TEXTURE_2D, 0);
-	glDisable(GL_TEXTURE_2D);
-	glActiveTexture(GL_TEXTURE0);
+	GL::BindTexture(GL_TEXTURE_2D, 0);
+	GL::Disable(GL_TEXTURE_2D);
+	GL::ActiveTexture(GL_TEXTURE0);
 }
 
 
@@ -111,7 +114,7 @@ static const void PushRenderState3DO() {
 	BindOpaqueTexAtlas(nullptr);
 
 	glPushAttrib(GL_POLYGON_BIT);
-	glDisable(GL_CULL_FACE);
+	GL::Disable(GL_CULL_FACE);
 }
 
 static const void PushRenderStateS3O() {
@@ -123,7 +126,7 @@ static const void PushRenderStateS3O() {
 static const void PushRenderStateOBJ() { /* no-op */ }
 static const void PushRenderStateASS() { /* no-op */ }
 
-static const void PopRenderState3DO() { glPopAttrib(); }
+static const void PopRenderState3DO() { glPopAttrib(); GL::InvalidateStateCache(); }
 static const void PopRenderStateS3O() {    /* no-op */ }
 static const void PopRenderStateOBJ() {    /* no-op */ }
 static const void PopRenderStateASS() {    /* no-op */ }
@@ -276,6 +279,10 @@ CUnitDrawer::CUnitDrawer(): CEventClient("[CUnitDrawer]", 271828, false)
 	drawDeferred = (geomBuffer->Valid());
 	wireFrameMode = false;
 
+	lastCullCam = nullptr;
+	lastCullDrawFrame = 0;
+	playerVisDrawFrame = 0;
+
 	// NOTE:
 	//   advShading can NOT change at runtime if initially false***
 	//   (see AdvModelShadingActionExecutor), so we will always use
@@ -359,10 +366,21 @@ void CUnitDrawer::Update()
 
 	{
 		iconUnits.clear();
+		iconUnitFlags.resize(unsortedUnits.size());
+
+		// icon-state and draw-position updates only touch their own
+		// unit, spread them over the pool workers; iconUnits itself
+		// is gathered below to keep a deterministic order
+		for_mt(0, unsortedUnits.size(), [this](const int i) {
+			CUnit* unit = unsortedUnits[i];
 
-		for (CUnit* unit: unsortedUnits) {
-			UpdateUnitIconState(unit);
+			iconUnitFlags[i] = UpdateUnitIconState(unit);
 			UpdateUnitDrawPos(unit);
+		});
+
+		for (unsigned int i = 0; i < unsortedUnits.size(); i++) {
+			if (iconUnitFlags[i])
+				iconUnits.push_back(unsortedUnits[i]);
 		}
 	}
 
@@ -378,7 +396,100 @@ void CUnitDrawer::Update()
 	}
 }
 
+void CUnitDrawer::UpdateUnitVisibility()
+{
+	const CCamera* cam = CCamera::GetActiveCamera();
+
+	// refresh the SoA sphere copies (and each unit's index into them)
+	// once per draw-frame; draw positions do not change between passes
+	if (lastCullDrawFrame != globalRendering->drawFrame) {
+		lastCullDrawFrame = globalRendering->drawFrame;
+		lastCullCam = nullptr;
+
+		cullSpheresX.resize(unsortedUnits.size());
+		cullSpheresY.resize(unsortedUnits.size());
+		cullSpheresZ.resize(unsortedUnits.size());
+		cullSpheresR.resize(unsortedUnits.size());
+		cullFlags.resize(unsortedUnits.size());
+
+		for_mt(0, unsortedUnits.size(), [this](const int i) {
+			CUnit* unit = unsortedUnits[i];
+
+			unit->drawIdx = i;
+
+			cullSpheresX[i] = unit->drawMidPos.x;
+			cullSpheresY[i] = unit->drawMidPos.y;
+			cullSpheresZ[i] = unit->drawMidPos.z;
+			cullSpheresR[i] = unit->GetDrawRadius();
+		});
+	}
+
+	// sweep all spheres against the camera of the current pass; opaque
+	// and alpha passes under the same camera share one sweep
+	if (cam == lastCullCam)
+		return;
+
+	lastCullCam = cam;
+
+	{
+		// each chunk writes its own slice of cullFlags, so the sweep
+		// parallelizes trivially
+		const int numSpheres = cullFlags.size();
+		const int chunkSize = 4096;
+
+		for_mt(0, numSpheres, chunkSize, [&](const int i) {
+			const int n = std::min(chunkSize, numSpheres - i);
+
+			cam->InViewBatched(&cullSpheresX[i], &cullSpheresY[i], &cullSpheresZ[i], &cullSpheresR[i], &cullFlags[i], n);
+		});
+	}
+
+	// fold in last frame's terrain occlusion results; these were issued
+	// from the player's view, so only its passes may consume them (the
+	// refraction pass shares that view and camera type)
+	if (cam->GetCamType() != CCamera::CAMTYPE_PLAYER)
+		return;
+
+	if (occlusionCuller != nullptr && occlusionCuller->Enabled()) {
+		for (unsigned int i = 0; i < cullFlags.size(); i++) {
+			if (cullFlags[i] == 0)
+				continue;
+
+			cullFlags[i] = occlusionCuller->SphereVisible(float3(cullSpheresX[i], cullSpheresY[i], cullSpheresZ[i]), cullSpheresR[i]);
+		}
+	}
+
+	// publish a frame-stamped snapshot of the player-camera results for
+	// Spring.GetVisibleUnits; the first player-cam sweep of the frame
+	// wins (the refraction pass reuses the camera type with a mirrored
+	// view). Stored as ids since unsortedUnits can change between the
+	// sweep and a Lua query
+	if (playerVisDrawFrame != globalRendering->drawFrame) {
+		playerVisDrawFrame = globalRendering->drawFrame;
+		playerVisUnitIDs.clear();
+
+		for (unsigned int i = 0; i < cullFlags.size(); i++) {
+			if (cullFlags[i] != 0) {
+				playerVisUnitIDs.push_back(unsortedUnits[i]->id);
+			}
+		}
+	}
+}
+
+const std::vector<int>* CUnitDrawer::GetPlayerVisUnitIDs() const
+{
+	// no sweep has happened yet (drawFrame 0 is never stamped)
+	if (playerVisDrawFrame == 0)
+		return nullptr;
+
+	// accept last frame's snapshot as well; queries issued before the
+	// first draw pass of the current frame (widget Update, ...) should
+	// see what is on screen rather than pay for a full re-cull
+	if ((globalRendering->drawFrame - playerVisDrawFrame) > 1)
+		return nullptr;
 
+	return &playerVisUnitIDs;
+}
 
 
 void CUnitDrawer::Draw(bool drawReflection, bool drawRefraction)
@@ -400,13 +511,15 @@ void CUnitDrawer::Draw(bool drawReflection, bool drawRefraction)
 
 	farTextureHandler->Draw();
 
-	glDisable(GL_FOG);
-	glDisable(GL_ALPHA_TEST);
-	glDisable(GL_TEXTURE_2D);
+	GL::Disable(GL_FOG);
+	GL::Disable(GL_ALPHA_TEST);
+	GL::Disable(GL_TEXTURE_2D);
 }
 
 void CUnitDrawer::DrawOpaquePass(bool deferredPass, bool drawReflection, bool drawRefraction)
 {
+	UpdateUnitVisibility();
+
 	SetupOpaqueDrawing(deferredPass);
 
 	for (int modelType = MODELTYPE_3DO; modelType < MODELTYPE_OTHER; modelType++) {
@@ -427,6 +540,9 @@ void CUnitDrawer::DrawOpaquePass(bool deferredPass, bool drawReflection, bool dr
 
 void CUnitDrawer::DrawOpaqueUnits(int modelType, bool drawReflection, bool drawRefraction)
 {
+	// scratch for sorting each bin without disturbing insertion order
+	static std::vector<CUnit*> binUnits;
+
 	const auto& unitBin = opaqueModelRenderers[modelType]->GetUnitBin();
 
 	for (const auto& unitBinPair: unitBin) {
@@ -435,13 +551,25 @@ void CUnitDrawer::DrawOpaqueUnits(int modelType, bool drawReflection, bool drawR
 
 		BindModelTypeTexture(modelType, textureType);
 
-		for (CUnit* unit: unitSet) {
-			DrawOpaqueUnit(unit, drawReflection, drawRefraction);
+		// draw each bin grouped by team so the colour state only has
+		// to be set up once per run of same-team units instead of
+		// once per unit; opaque draw order is otherwise irrelevant
+		binUnits.clear();
+		binUnits.insert(binUnits.end(), unitSet.begin(), unitSet.end());
+
+		std::sort(binUnits.begin(), binUnits.end(), [](const CUnit* a, const CUnit* b) {
+			return (a->team < b->team);
+		});
+
+		int prevTeam = -1;
+
+		for (CUnit* unit: binUnits) {
+			DrawOpaqueUnit(unit, prevTeam, drawReflection, drawRefraction);
 		}
 	}
 }
 
-inline void CUnitDrawer::DrawOpaqueUnit(CUnit* unit, bool drawReflection, bool drawRefraction)
+inline void CUnitDrawer::DrawOpaqueUnit(CUnit* unit, int& prevTeam, bool drawReflection, bool drawRefraction)
 {
 	if (!CanDrawOpaqueUnit(unit, drawReflection, drawRefraction))
 		return;
@@ -454,8 +582,12 @@ inline void CUnitDrawer::DrawOpaqueUnit(CUnit* unit, bool drawReflection, bool d
 	if (LuaObjectDrawer::AddOpaqueMaterialObject(unit, LUAOBJ_UNIT))
 		return;
 
-	// draw the unit with the default (non-Lua) material
-	SetTeamColour(unit->team);
+	// draw the unit with the default (non-Lua) material; Lua- and
+	// far-queued units above do not touch the colour state, so the
+	// cached team remains valid across them
+	if (unit->team != prevTeam)
+		SetTeamColour(prevTeam = unit->team);
+
 	DrawUnitTrans(unit, 0, 0, false, false);
 }
 
@@ -507,11 +639,54 @@ void CUnitDrawer::DrawUnitIcons()
 	if (globalRendering->msaaLevel >= 4)
 		glEnable(GL_SAMPLE_ALPHA_TO_COVERAGE_ARB);
 
+	// zoomed out every unit is an icon, so issuing a textured quad per
+	// unit means thousands of draws; sort them by icon texture instead
+	// and submit one array per texture (team tint rides per-vertex)
+	struct IconDrawRequest {
+		const icon::CIconData* data;
+		CUnit* unit;
+		bool asRadarBlip;
+	};
+	static std::vector<IconDrawRequest> drawIcons;
+
+	drawIcons.clear();
+	drawIcons.reserve(iconUnits.size());
+
 	for (CUnit* u: iconUnits) {
 		const unsigned short closBits = (u->losStatus[gu->myAllyTeam] & (LOS_INLOS                  ));
 		const unsigned short plosBits = (u->losStatus[gu->myAllyTeam] & (LOS_PREVLOS | LOS_CONTRADAR));
 
-		DrawIcon(u, !gu->spectatingFullView && closBits == 0 && plosBits != (LOS_PREVLOS | LOS_CONTRADAR));
+		const bool asRadarBlip = (!gu->spectatingFullView && closBits == 0 && plosBits != (LOS_PREVLOS | LOS_CONTRADAR));
+		const icon::CIconData* iconData = asRadarBlip?
+			icon::iconHandler->GetDefaultIconData():
+			u->unitDef->iconType.GetIconData();
+
+		drawIcons.push_back({iconData, u, asRadarBlip});
+	}
+
+	std::sort(drawIcons.begin(), drawIcons.end(), [](const IconDrawRequest& a, const IconDrawRequest& b) {
+		return (a.data->GetTextureID() < b.data->GetTextureID());
+	});
+
+	CVertexArray* va = GetVertexArray();
+	va->Initialize();
+
+	const icon::CIconData* batchIcon = nullptr;
+
+	for (const IconDrawRequest& req: drawIcons) {
+		if (batchIcon != nullptr && req.data->GetTextureID() != batchIcon->GetTextureID()) {
+			batchIcon->BindTexture();
+			va->DrawArrayTC(GL_QUADS);
+			va->Initialize();
+		}
+
+		batchIcon = req.data;
+		DrawIcon(req.unit, req.data, req.asRadarBlip, va);
+	}
+
+	if (batchIcon != nullptr) {
+		batchIcon->BindTexture();
+		va->DrawArrayTC(GL_QUADS);
 	}
 
 	glPopAttrib();
@@ -549,7 +724,8 @@ bool CUnitDrawer::CanDrawOpaqueUnit(
 	if (drawReflection && !ObjectVisibleReflection(unit->drawMidPos, cam->GetPos(), unit->GetDrawRadius()))
 		return false;
 
-	return (cam->InView(unit->drawMidPos, unit->GetDrawRadius()));
+	// batch-swept in UpdateUnitVisibility
+	return (cullFlags[unit->drawIdx] != 0);
 }
 
 bool CUnitDrawer::CanDrawOpaqueUnitShadow(const CUnit* unit) const
@@ -564,10 +740,9 @@ bool CUnitDrawer::CanDrawOpaqueUnitShadow(const CUnit* unit) const
 	if (unit->isCloaked)
 		return false;
 
-	const CCamera* cam = CCamera::GetActiveCamera();
-
 	const bool unitInLOS = ((unit->losStatus[gu->myAllyTeam] & LOS_INLOS) || gu->spectatingFullView);
-	const bool unitInView = cam->InView(unit->drawMidPos, unit->GetDrawRadius());
+	// batch-swept in UpdateUnitVisibility
+	const bool unitInView = (cullFlags[unit->drawIdx] != 0);
 
 	return (unitInLOS && unitInView);
 }
@@ -609,11 +784,14 @@ void CUnitDrawer::DrawShadowPass()
 {
 	glColor3f(1.0f, 1.0f, 1.0f);
 	glPolygonOffset(1.0f, 1.0f);
-	glEnable(GL_POLYGON_OFFSET_FILL);
+
+	// untracked code has run since the last pass; start from a clean shadow
+	GL::InvalidateStateCache();
+	GL::Enable(GL_POLYGON_OFFSET_FILL);
 
 	#ifdef UNIT_SHADOW_ALPHA_MASKING
-	glAlphaFunc(GL_GREATER, 0.5f);
-	glEnable(GL_ALPHA_TEST);
+	GL::AlphaFunc(GL_GREATER, 0.5f);
+	GL::Enable(GL_ALPHA_TEST);
 	#endif
 
 	Shader::IProgramObject* po =
@@ -623,12 +801,14 @@ void CUnitDrawer::DrawShadowPass()
 	{
 		assert((CCamera::GetActiveCamera())->GetCamType() == CCamera::CAMTYPE_SHADOW);
 
+		UpdateUnitVisibility();
+
 		// 3DO's have clockwise-wound faces and
 		// (usually) holes, so disable backface
 		// culling for them
-		glDisable(GL_CULL_FACE);
+		GL::Disable(GL_CULL_FACE);
 		DrawOpaqueUnitsShadow(MODELTYPE_3DO);
-		glEnable(GL_CULL_FACE);
+		GL::Enable(GL_CULL_FACE);
 
 		for (int modelType = MODELTYPE_S3O; modelType < MODELTYPE_OTHER; modelType++) {
 			// note: just use DrawOpaqueUnits()? would
@@ -641,10 +821,10 @@ void CUnitDrawer::DrawShadowPass()
 	po->Disable();
 
 	#ifdef UNIT_SHADOW_ALPHA_MASKING
-	glDisable(GL_ALPHA_TEST);
+	GL::Disable(GL_ALPHA_TEST);
 	#endif
 
-	glDisable(GL_POLYGON_OFFSET_FILL);
+	GL::Disable(GL_POLYGON_OFFSET_FILL);
 
 	LuaObjectDrawer::SetDrawPassGlobalLODFactor(LUAOBJ_UNIT);
 	LuaObjectDrawer::DrawShadowMaterialObjects(LUAOBJ_UNIT, false);
@@ -652,20 +832,11 @@ void CUnitDrawer::DrawShadowPass()
 
 
 
-void CUnitDrawer::DrawIcon(CUnit* unit, bool useDefaultIcon)
+void CUnitDrawer::DrawIcon(CUnit* unit, const icon::CIconData* iconData, bool useDefaultIcon, CVertexArray* va)
 {
 	// iconUnits should not never contain void-space units, see UpdateUnitIconState
 	assert(!unit->IsInVoid());
 
-	// If the icon is to be drawn as a radar blip, we want to get the default icon.
-	const icon::CIconData* iconData = nullptr;
-
-	if (useDefaultIcon) {
-		iconData = icon::iconHandler->GetDefaultIconData();
-	} else {
-		iconData = unit->unitDef->iconType.GetIconData();
-	}
-
 	// drawMidPos is auto-calculated now; can wobble on its own as pieces move
 	float3 pos = (!gu->spectatingFullView) ?
 		unit->GetObjDrawErrorPos(gu->myAllyTeam) :
@@ -694,11 +865,10 @@ void CUnitDrawer::DrawIcon(CUnit* unit, bool useDefaultIcon)
 	unit->iconRadius = scale;
 
 	// Is the unit selected? Then draw it white.
-	if (unit->isSelected) {
-		glColor3ub(255, 255, 255);
-	} else {
-		glColor3ubv(teamHandler->Team(unit->team)->color);
-	}
+	unsigned char color[4] = {255, 255, 255, 255};
+
+	if (!unit->isSelected)
+		memcpy(color, teamHandler->Team(unit->team)->color, 3 * sizeof(unsigned char));
 
 	// calculate the vertices
 	const float3 dy = camera->GetUp()    * scale;
@@ -710,8 +880,8 @@ void CUnitDrawer::DrawIcon(CUnit* unit, bool useDefaultIcon)
 	const float3 vnp = vn + dy;
 	const float3 vpp = vp + dy;
 
-	// Draw the icon.
-	iconData->Draw(vnn, vpn, vnp, vpp);
+	// append the icon to its texture batch
+	iconData->DrawArray(va, vnn, vpn, vnp, vpp, color);
 }
 
 
@@ -724,15 +894,18 @@ void CUnitDrawer::SetupAlphaDrawing(bool deferredPass)
 	glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_POLYGON_BIT);
 	glPolygonMode(GL_FRONT_AND_BACK, GL_LINE * wireFrameMode + GL_FILL * (1 - wireFrameMode));
 
+	// untracked code has run since the last pass; start from a clean shadow
+	GL::InvalidateStateCache();
+
 	unitDrawerStates[DRAWER_STATE_SEL] = const_cast<IUnitDrawerState*>(GetWantedDrawerState(true));
 	unitDrawerStates[DRAWER_STATE_SEL]->Enable(this, deferredPass && false, true);
 
-	glEnable(GL_TEXTURE_2D);
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glEnable(GL_ALPHA_TEST);
-	glAlphaFunc(GL_GREATER, 0.1f);
-	glDepthMask(GL_FALSE);
+	GL::Enable(GL_TEXTURE_2D);
+	GL::Enable(GL_BLEND);
+	GL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	GL::Enable(GL_ALPHA_TEST);
+	GL::AlphaFunc(GL_GREATER, 0.1f);
+	GL::DepthMask(GL_FALSE);
 }
 
 void CUnitDrawer::ResetAlphaDrawing(bool deferredPass)
@@ -740,6 +913,7 @@ void CUnitDrawer::ResetAlphaDrawing(bool deferredPass)
 	unitDrawerStates[DRAWER_STATE_SEL]->Disable(this, deferredPass && false);
 
 	glPopAttrib();
+	GL::InvalidateStateCache();
 }
 
 
@@ -748,11 +922,13 @@ void CUnitDrawer::DrawAlphaPass()
 {
 	SCOPED_GMARKER("CUnitDrawer::DrawAlphaPass");
 
+	UpdateUnitVisibility();
+
 	{
 		SetupAlphaDrawing(false);
 
 		if (UseAdvShading())
-			glDisable(GL_ALPHA_TEST);
+			GL::Disable(GL_ALPHA_TEST);
 
 		for (int modelType = MODELTYPE_3DO; modelType < MODELTYPE_OTHER; modelType++) {
 			PushModelRenderState(modelType);
@@ -762,7 +938,7 @@ void CUnitDrawer::DrawAlphaPass()
 		}
 
 		if (UseAdvShading())
-			glEnable(GL_ALPHA_TEST);
+			GL::Enable(GL_ALPHA_TEST);
 
 		ResetAlphaDrawing(false);
 	}
@@ -792,7 +968,8 @@ void CUnitDrawer::DrawAlphaUnits(int modelType)
 }
 
 inline void CUnitDrawer::DrawAlphaUnit(CUnit* unit, int modelType, bool drawGhostBuildingsPass) {
-	if (!camera->InView(unit->drawMidPos, unit->GetDrawRadius()))
+	// batch-swept in UpdateUnitVisibility
+	if (cullFlags[unit->drawIdx] == 0)
 		return;
 
 	if (LuaObjectDrawer::AddAlphaMaterialObject(unit, LUAOBJ_UNIT))
@@ -976,11 +1153,14 @@ void CUnitDrawer::SetupOpaqueDrawing(bool deferredPass)
 	glPushAttrib(GL_ENABLE_BIT | GL_POLYGON_BIT);
 	glPolygonMode(GL_FRONT_AND_BACK, GL_LINE * wireFrameMode + GL_FILL * (1 - wireFrameMode));
 
+	// untracked code has run since the last pass; start from a clean shadow
+	GL::InvalidateStateCache();
+
 	glCullFace(GL_BACK);
-	glEnable(GL_CULL_FACE);
+	GL::Enable(GL_CULL_FACE);
 
-	glAlphaFunc(GL_GREATER, 0.5f);
-	glEnable(GL_ALPHA_TEST);
+	GL::AlphaFunc(GL_GREATER, 0.5f);
+	GL::Enable(GL_ALPHA_TEST);
 
 	// pick base shaders (ARB/GLSL) or FFP; not used by custom-material models
 	unitDrawerStates[DRAWER_STATE_SEL] = const_cast<IUnitDrawerState*>(GetWantedDrawerState(false));
@@ -999,6 +1179,7 @@ void CUnitDrawer::ResetOpaqueDrawing(bool deferredPass)
 	unitDrawerStates[DRAWER_STATE_SEL]->Disable(this, deferredPass);
 
 	glPopAttrib();
+	GL::InvalidateStateCache();
 }
 
 const IUnitDrawerState* CUnitDrawer::GetWantedDrawerState(bool alphaPass) const
@@ -1033,8 +1214,8 @@ void CUnitDrawer::SetTeamColour(int team, const float2 alpha) const
  */
 void CUnitDrawer::SetupBasicS3OTexture0()
 {
-	glActiveTexture(GL_TEXTURE0);
-	glEnable(GL_TEXTURE_2D);
+	GL::ActiveTexture(GL_TEXTURE0);
+	GL::Enable(GL_TEXTURE_2D);
 
 	// RGB = Texture * (1 - Alpha) + Teamcolor * Alpha
 	glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB_ARB, GL_INTERPOLATE_ARB);
@@ -1059,8 +1240,8 @@ void CUnitDrawer::SetupBasicS3OTexture0()
  */
 void CUnitDrawer::SetupBasicS3OTexture1()
 {
-	glActiveTexture(GL_TEXTURE1);
-	glEnable(GL_TEXTURE_2D);
+	GL::ActiveTexture(GL_TEXTURE1);
+	GL::Enable(GL_TEXTURE_2D);
 
 	// RGB = Primary Color * Previous
 	glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE_ARB);
@@ -1080,8 +1261,8 @@ void CUnitDrawer::SetupBasicS3OTexture1()
 void CUnitDrawer::CleanupBasicS3OTexture1()
 {
 	// reset texture1 state
-	glActiveTexture(GL_TEXTURE1);
-	glDisable(GL_TEXTURE_2D);
+	GL::ActiveTexture(GL_TEXTURE1);
+	GL::Disable(GL_TEXTURE_2D);
 	glTexEnvi(GL_TEXTURE_ENV,GL_SOURCE1_ALPHA_ARB, GL_PREVIOUS_ARB);
 	glTexEnvi(GL_TEXTURE_ENV,GL_SOURCE0_RGB_ARB, GL_TEXTURE);
 	glTexEnvi(GL_TEXTURE_ENV,GL_TEXTURE_ENV_MODE,GL_MODULATE);
@@ -1090,7 +1271,7 @@ void CUnitDrawer::CleanupBasicS3OTexture1()
 void CUnitDrawer::CleanupBasicS3OTexture0()
 {
 	// reset texture0 state
-	glActiveTexture(GL_TEXTURE0);
+	GL::ActiveTexture(GL_TEXTURE0);
 	glTexEnvi(GL_TEXTURE_ENV,GL_SOURCE1_RGB_ARB, GL_PREVIOUS_ARB);
 	glTexEnvi(GL_TEXTURE_ENV,GL_SOURCE2_RGB_ARB, GL_CONSTANT_ARB);
 	glTexEnvi(GL_TEXTURE_ENV,GL_OPERAND2_RGB_ARB, GL_SRC_ALPHA);
@@ -1110,6 +1291,7 @@ void CUnitDrawer::PushIndividualOpaqueState(const S3DModel* model, int teamID, b
 	glDepthMask(GL_TRUE);
 	glEnable(GL_DEPTH_TEST);
 
+	// SetupOpaqueDrawing invalidates, no need to route the calls above
 	SetupOpaqueDrawing(deferredPass);
 	PushModelRenderState(model);
 	SetTeamColour(teamID);
@@ -1129,6 +1311,7 @@ void CUnitDrawer::PopIndividualOpaqueState(const S3DModel* model, int teamID, bo
 	ResetOpaqueDrawing(deferredPass);
 
 	glPopAttrib();
+	GL::InvalidateStateCache();
 }
 
 void CUnitDrawer::PopIndividualAlphaState(const S3DModel* model, int teamID, bool deferredPass)
@@ -1463,7 +1646,7 @@ void CUnitDrawer::DrawUnitTrans(const CUnit* unit, unsigned int preList, unsigne
 
 
 
-inline void CUnitDrawer::UpdateUnitIconState(CUnit* unit) {
+inline bool CUnitDrawer::UpdateUnitIconState(CUnit* unit) {
 	const unsigned short losStatus = unit->losStatus[gu->myAllyTeam];
 
 	// reset
@@ -1473,16 +1656,16 @@ inline void CUnitDrawer::UpdateUnitIconState(CUnit* unit) {
 		unit->isIcon = DrawAsIcon(unit, (unit->pos - camera->GetPos()).SqLength());
 
 	if (!unit->isIcon)
-		return;
+		return false;
 	if (unit->noDraw)
-		return;
+		return false;
 	if (unit->IsInVoid())
-		return;
+		return false;
 	// drawing icons is cheap but not free, avoid a perf-hit when many are offscreen
 	if (!camera->InView(unit->drawMidPos, unit->GetDrawRadius()))
-		return;
+		return false;
 
-	iconUnits.push_back(unit);
+	return true;
 }
 
 inline void CUnitDrawer::UpdateUnitDrawPos(CUnit* u) {
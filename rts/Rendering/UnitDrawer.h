@@ -17,6 +17,7 @@ struct SolidObjectDef;
 struct UnitDef;
 struct S3DModel;
 
+class CCamera;
 class IModelRenderContainer;
 class CSolidObject;
 class CUnit;
@@ -141,6 +142,11 @@ public:
 
 	const std::vector<CUnit*>& GetUnsortedUnits() const { return unsortedUnits; }
 
+	/// ids of the units visible to this (or the previous) draw-frame's
+	/// player-camera cull sweep, occlusion included; returns null when
+	/// no recent sweep exists (drawing disabled, game just started)
+	const std::vector<int>* GetPlayerVisUnitIDs() const;
+
 	IModelRenderContainer* GetOpaqueModelRenderer(int modelType) { return opaqueModelRenderers[modelType]; }
 	IModelRenderContainer* GetAlphaModelRenderer(int modelType) { return alphaModelRenderers[modelType]; }
 
@@ -182,10 +188,15 @@ private:
 	/// Returns true if the given unit should be drawn as icon in the current frame.
 	bool DrawAsIcon(const CUnit* unit, const float sqUnitCamDist) const;
 
+	/// batch-culls all units against the active camera; refreshes the
+	/// SoA sphere copies once per draw-frame and sweeps once per camera
+	/// pass, the per-unit Draw*Unit checks only read the cached flags
+	void UpdateUnitVisibility();
+
 	bool CanDrawOpaqueUnit(const CUnit* unit, bool drawReflection, bool drawRefraction) const;
 	bool CanDrawOpaqueUnitShadow(const CUnit* unit) const;
 
-	void DrawOpaqueUnit(CUnit* unit, bool drawReflection, bool drawRefraction);
+	void DrawOpaqueUnit(CUnit* unit, int& prevTeam, bool drawReflection, bool drawRefraction);
 	void DrawOpaqueUnitShadow(CUnit* unit);
 	void DrawOpaqueUnitsShadow(int modelType);
 	void DrawOpaqueUnits(int modelType, bool drawReflection, bool drawRefraction);
@@ -206,9 +217,11 @@ public:
 	void DrawUnitMiniMapIcon(const CUnit* unit, CVertexArray* va) const;
 private:
 	void UpdateUnitMiniMapIcon(const CUnit* unit, bool forced, bool killed);
-	void UpdateUnitIconState(CUnit* unit);
+	/// returns true if the unit should be drawn as an icon this frame;
+	/// only touches per-unit state so Update() can run it multithreaded
+	bool UpdateUnitIconState(CUnit* unit);
 
-	static void DrawIcon(CUnit* unit, bool asRadarBlip);
+	static void DrawIcon(CUnit* unit, const icon::CIconData* iconData, bool asRadarBlip, CVertexArray* va);
 	static void UpdateUnitDrawPos(CUnit* unit);
 
 public:
@@ -270,6 +283,26 @@ private:
 	/// unsorted set of 3DO, S3O, opaque, and cloaked models!)
 	std::vector<CUnit*> unsortedUnits;
 
+	/// bounding spheres of unsortedUnits in SoA layout, indexed by
+	/// CUnit::drawIdx; per-sweep visibility flags live in cullFlags
+	std::vector<float> cullSpheresX;
+	std::vector<float> cullSpheresY;
+	std::vector<float> cullSpheresZ;
+	std::vector<float> cullSpheresR;
+	std::vector<unsigned char> cullFlags;
+
+	/// per-unit results of the multithreaded icon-state update, gathered
+	/// into iconUnits on the main thread to keep a deterministic order
+	std::vector<unsigned char> iconUnitFlags;
+
+	const CCamera* lastCullCam;
+	unsigned int lastCullDrawFrame;
+
+	/// ids of units that passed the last player-camera cull sweep;
+	/// frame-stamped snapshot served through GetPlayerVisUnitIDs
+	std::vector<int> playerVisUnitIDs;
+	unsigned int playerVisDrawFrame;
+
 	/// AI unit ghosts
 	std::array< std::vector<TempDrawUnit>, MODELTYPE_OTHER> tempOpaqueUnits;
 	std::array< std::vector<TempDrawUnit>, MODELTYPE_OTHER> tempAlphaUnits;
@@ -4,6 +4,7 @@
 #include "UnitDrawer.h"
 #include "Game/Camera.h"
 #include "Rendering/GlobalRendering.h"
+#include "Rendering/GL/StateCache.h"
 #include "Rendering/ShadowHandler.h"
 #include "Rendering/Env/SunLighting.h"
 #include "Rendering/Env/ISky.h"
@@ -76,7 +77,7 @@ void IUnitDrawerState::EnableCommon(const CUnitDrawer* ud, bool deferredPass) {
 	assert(modelShaders[MODEL_SHADER_ACTIVE] != nullptr);
 	modelShaders[MODEL_SHADER_ACTIVE]->Enable();
 
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	GL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
 
 void IUnitDrawerState::DisableCommon(const CUnitDrawer* ud, bool deferredPass) {
@@ -91,39 +92,39 @@ void IUnitDrawerState::DisableCommon(const CUnitDrawer* ud, bool deferredPass) {
 
 
 void IUnitDrawerState::EnableTexturesCommon() const {
-	glActiveTexture(GL_TEXTURE1);
-	glEnable(GL_TEXTURE_2D);
+	GL::ActiveTexture(GL_TEXTURE1);
+	GL::Enable(GL_TEXTURE_2D);
 
 	if (shadowHandler->ShadowsLoaded())
 		shadowHandler->SetupShadowTexSampler(GL_TEXTURE2, true);
 
-	glActiveTexture(GL_TEXTURE3);
-	glEnable(GL_TEXTURE_CUBE_MAP_ARB);
-	glBindTexture(GL_TEXTURE_CUBE_MAP_ARB, cubeMapHandler->GetEnvReflectionTextureID());
+	GL::ActiveTexture(GL_TEXTURE3);
+	GL::Enable(GL_TEXTURE_CUBE_MAP_ARB);
+	GL::BindTexture(GL_TEXTURE_CUBE_MAP_ARB, cubeMapHandler->GetEnvReflectionTextureID());
 
-	glActiveTexture(GL_TEXTURE4);
-	glEnable(GL_TEXTURE_CUBE_MAP_ARB);
-	glBindTexture(GL_TEXTURE_CUBE_MAP_ARB, cubeMapHandler->GetSpecularTextureID());
+	GL::ActiveTexture(GL_TEXTURE4);
+	GL::Enable(GL_TEXTURE_CUBE_MAP_ARB);
+	GL::BindTexture(GL_TEXTURE_CUBE_MAP_ARB, cubeMapHandler->GetSpecularTextureID());
 
-	glActiveTexture(GL_TEXTURE0);
-	glEnable(GL_TEXTURE_2D);
+	GL::ActiveTexture(GL_TEXTURE0);
+	GL::Enable(GL_TEXTURE_2D);
 }
 
 void IUnitDrawerState::DisableTexturesCommon() const {
-	glActiveTexture(GL_TEXTURE1);
-	glDisable(GL_TEXTURE_2D);
+	GL::ActiveTexture(GL_TEXTURE1);
+	GL::Disable(GL_TEXTURE_2D);
 
 	if (shadowHandler->ShadowsLoaded())
 		shadowHandler->ResetShadowTexSampler(GL_TEXTURE2, true);
 
-	glActiveTexture(GL_TEXTURE3);
-	glDisable(GL_TEXTURE_CUBE_MAP_ARB);
+	GL::ActiveTexture(GL_TEXTURE3);
+	GL::Disable(GL_TEXTURE_CUBE_MAP_ARB);
 
-	glActiveTexture(GL_TEXTURE4);
-	glDisable(GL_TEXTURE_CUBE_MAP_ARB);
+	GL::ActiveTexture(GL_TEXTURE4);
+	GL::Disable(GL_TEXTURE_CUBE_MAP_ARB);
 
-	glActiveTexture(GL_TEXTURE0);
-	glDisable(GL_TEXTURE_2D);
+	GL::ActiveTexture(GL_TEXTURE0);
+	GL::Disable(GL_TEXTURE_2D);
 }
 
 
@@ -134,13 +135,13 @@ bool UnitDrawerStateFFP::CanEnable(const CUnitDrawer* ud) const {
 }
 
 void UnitDrawerStateFFP::Enable(const CUnitDrawer* ud, bool deferredPass, bool alphaPass) {
-	glEnable(GL_LIGHTING);
+	GL::Enable(GL_LIGHTING);
 	// only for the advshading=0 case
 	glLightfv(GL_LIGHT1, GL_POSITION, sky->GetLight()->GetLightDir());
 	glLightfv(GL_LIGHT1, GL_AMBIENT, sunLighting->modelAmbientColor);
 	glLightfv(GL_LIGHT1, GL_DIFFUSE, sunLighting->modelDiffuseColor);
 	glLightfv(GL_LIGHT1, GL_SPECULAR, sunLighting->modelSpecularColor);
-	glEnable(GL_LIGHT1);
+	GL::Enable(GL_LIGHT1);
 
 	CUnitDrawer::SetupBasicS3OTexture1();
 	CUnitDrawer::SetupBasicS3OTexture0();
@@ -158,8 +159,8 @@ void UnitDrawerStateFFP::Disable(const CUnitDrawer* ud, bool) {
 
 	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
 
-	glDisable(GL_LIGHTING);
-	glDisable(GL_LIGHT1);
+	GL::Disable(GL_LIGHTING);
+	GL::Disable(GL_LIGHT1);
 
 	CUnitDrawer::CleanupBasicS3OTexture1();
 	CUnitDrawer::CleanupBasicS3OTexture0();
@@ -167,28 +168,28 @@ void UnitDrawerStateFFP::Disable(const CUnitDrawer* ud, bool) {
 
 
 void UnitDrawerStateFFP::EnableTextures() const {
-	glEnable(GL_LIGHTING);
+	GL::Enable(GL_LIGHTING);
 	glColor3f(1.0f, 1.0f, 1.0f);
-	glEnable(GL_TEXTURE_2D);
-	glActiveTexture(GL_TEXTURE1);
-	glEnable(GL_TEXTURE_2D);
-	glActiveTexture(GL_TEXTURE0);
+	GL::Enable(GL_TEXTURE_2D);
+	GL::ActiveTexture(GL_TEXTURE1);
+	GL::Enable(GL_TEXTURE_2D);
+	GL::ActiveTexture(GL_TEXTURE0);
 }
 
 void UnitDrawerStateFFP::DisableTextures() const {
-	glDisable(GL_LIGHTING);
-	glDisable(GL_TEXTURE_2D);
-	glActiveTexture(GL_TEXTURE1);
-	glDisable(GL_TEXTURE_2D);
-	glActiveTexture(GL_TEXTURE0);
-	glDisable(GL_TEXTURE_2D);
+	GL::Disable(GL_LIGHTING);
+	GL::Disable(GL_TEXTURE_2D);
+	GL::ActiveTexture(GL_TEXTURE1);
+	GL::Disable(GL_TEXTURE_2D);
+	GL::ActiveTexture(GL_TEXTURE0);
+	GL::Disable(GL_TEXTURE_2D);
 }
 
 void UnitDrawerStateFFP::SetTeamColor(int team, const float2 alpha) const {
 	// non-shader case via texture combiners
 	const float4 m = {1.0f, 1.0f, 1.0f, alpha.x};
 
-	glActiveTexture(GL_TEXTURE0);
+	GL::ActiveTexture(GL_TEXTURE0);
 	glTexEnvfv(GL_TEXTURE_ENV, GL_TEXTURE_ENV_COLOR, std::move(GetTeamColor(team, alpha.x)));
 	glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, &m.x);
 }
@@ -13,9 +13,11 @@
 #include "Rendering/Env/IWater.h"
 #include "Rendering/CommandDrawer.h"
 #include "Rendering/DebugColVolDrawer.h"
+#include "Rendering/DeferredLightDrawer.h"
 #include "Rendering/FarTextureHandler.h"
 #include "Rendering/LineDrawer.h"
 #include "Rendering/LuaObjectDrawer.h"
+#include "Rendering/OcclusionCuller.h"
 #include "Rendering/FeatureDrawer.h"
 #include "Rendering/Env/Particles/ProjectileDrawer.h"
 #include "Rendering/UnitDrawer.h"
@@ -23,11 +25,13 @@
 #include "Rendering/SmoothHeightMeshDrawer.h"
 #include "Rendering/InMapDrawView.h"
 #include "Rendering/ShadowHandler.h"
+#include "Rendering/GL/GlobalUniforms.h"
 #include "Rendering/Map/InfoTexture/IInfoTextureHandler.h"
 #include "Rendering/Models/IModelParser.h"
 #include "Rendering/Shaders/ShaderHandler.h"
 #include "Rendering/Textures/3DOTextureHandler.h"
 #include "Rendering/Textures/S3OTextureHandler.h"
+#include "Rendering/Textures/TextureUploadService.h"
 #include "Lua/LuaUnsyncedCtrl.h"
 #include "Map/BaseGroundDrawer.h"
 #include "Map/HeightMapTexture.h"
@@ -47,14 +51,20 @@ CWorldDrawer::CWorldDrawer(): numUpdates(0)
 {
 	CShaderHandler::GetInstance(0);
 	LuaObjectDrawer::Init();
+
+	globalUniforms.Init();
 }
 
 CWorldDrawer::~CWorldDrawer()
 {
+	globalUniforms.Kill();
+
 	spring::SafeDelete(infoTextureHandler);
 
 	spring::SafeDelete(water);
 	spring::SafeDelete(sky);
+	spring::SafeDelete(deferredLightDrawer);
+	spring::SafeDelete(occlusionCuller);
 	spring::SafeDelete(treeDrawer);
 	spring::SafeDelete(grassDrawer);
 	spring::SafeDelete(pathDrawer);
@@ -70,6 +80,9 @@ CWorldDrawer::~CWorldDrawer()
 	spring::SafeDelete(farTextureHandler);
 	spring::SafeDelete(heightMapTexture);
 
+	// joins the upload worker, must precede texture-handler deletion
+	spring::SafeDelete(texUploadService);
+
 	spring::SafeDelete(texturehandler3DO);
 	spring::SafeDelete(texturehandlerS3O);
 
@@ -90,6 +103,9 @@ void CWorldDrawer::LoadPre() const
 	modelLoader.Init();
 
 	loadscreen->SetLoadMessage("Creating Unit Textures");
+	texUploadService = new CTextureUploadService();
+	texUploadService->Init();
+
 	texturehandler3DO = new C3DOTextureHandler();
 	texturehandlerS3O = new CS3OTextureHandler();
 
@@ -113,6 +129,8 @@ void CWorldDrawer::LoadPost() const
 	loadscreen->SetLoadMessage("Creating GroundDrawer");
 	readMap->InitGroundDrawer();
 
+	occlusionCuller = new COcclusionCuller();
+
 	loadscreen->SetLoadMessage("Creating TreeDrawer");
 	treeDrawer = ITreeDrawer::GetTreeDrawer();
 	grassDrawer = new CGrassDrawer();
@@ -133,9 +151,15 @@ void CWorldDrawer::LoadPost() const
 	// see ::LoadPre
 	// featureDrawer = new CFeatureDrawer();
 
+	// needs both the ground drawer's and the unit drawer's buffers
+	deferredLightDrawer = new CDeferredLightDrawer();
+
 	loadscreen->SetLoadMessage("Creating Water");
 	water = IWater::GetWater(NULL, -1);
 
+	loadscreen->SetLoadMessage("Compiling Shaders");
+	shaderHandler->WarmAll();
+
 	sky->SetupFog();
 }
 
@@ -200,11 +224,9 @@ void CWorldDrawer::GenerateIBLTextures() const
 			SCOPED_GMARKER("Draw::World::UpdateSkyTex");
 			sky->UpdateSkyTexture();
 		}
-		{
-			SCOPED_TIMER("Draw::World::UpdateShadingTexture");
-			SCOPED_GMARKER("Draw::World::UpdateShadingTexture");
-			readMap->UpdateShadingTexture();
-		}
+
+		// the progressive shading-texture refresh runs as a low-priority
+		// job under the shared dispatcher budget (CGame::AddTimedJobs)
 	}
 
 	if (FBO::IsSupported())
@@ -246,6 +268,13 @@ void CWorldDrawer::Draw() const
 	sky->Draw();
 
 	DrawOpaqueObjects();
+
+	{
+		SCOPED_TIMER("Draw::World::DeferredLights");
+		SCOPED_GMARKER("Draw::World::DeferredLights");
+		deferredLightDrawer->Draw();
+	}
+
 	DrawAlphaObjects();
 
 	{
@@ -292,6 +321,11 @@ void CWorldDrawer::DrawOpaqueObjects() const
 			treeDrawer->Draw();
 		}
 		smoothHeightMeshDrawer->Draw(1.0f);
+
+		// the depth buffer now contains only terrain, which is exactly
+		// the set of occluders we care about; issue the object queries
+		// here so they have time to finish before the model passes
+		occlusionCuller->RunQueries();
 	}
 
 	// run occlusion query here so it has more time to finish before UpdateWater
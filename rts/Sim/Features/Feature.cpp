@@ -9,6 +9,7 @@
 #include "Map/Ground.h"
 #include "Map/MapInfo.h"
 #include "Sim/Misc/DamageArray.h"
+#include "Sim/Misc/FeatureBVH.h"
 #include "Sim/Misc/QuadField.h"
 #include "Sim/Misc/CollisionVolume.h"
 #include "Sim/Misc/LosHandler.h"
@@ -599,6 +600,10 @@ bool CFeature::UpdatePosition()
 
 	// use an exact comparison for the y-component (gravity is small)
 	if (!pos.equals(oldPos, float3(float3::cmp_eps(), 0.0f, float3::cmp_eps()))) {
+		// vertical-only moves never pass through the QuadField
+		// registration paths, so invalidate the ray-BVH here too
+		featureBVH.SetDirty();
+
 		eventHandler.FeatureMoved(this, oldPos);
 		return true;
 	}
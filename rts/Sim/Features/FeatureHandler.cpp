@@ -8,6 +8,7 @@
 #include "Map/Ground.h"
 #include "Map/ReadMap.h"
 #include "Sim/Misc/SimObjectMemPool.h"
+#include "Sim/Misc/FeatureBVH.h"
 #include "Sim/Misc/QuadField.h"
 #include "Sim/Units/CommandAI/BuilderCAI.h"
 #include "System/creg/STL_Set.h"
@@ -88,6 +89,10 @@ void CFeatureHandler::LoadFeaturesFromMap()
 
 		LoadFeature(params);
 	}
+
+	// make map features visible to (pre-gamestart) GUI traces; the
+	// per-frame rebuild point only runs once the simulation starts
+	featureBVH.Update();
 }
 
 
@@ -184,6 +189,10 @@ void CFeatureHandler::Update()
 
 		updateFeatures.erase(iter, updateFeatures.end());
 	}
+
+	// fixed per-frame rebuild point for the ray-candidate BVH; all
+	// feature spawns, deaths and moves of this frame are now in
+	featureBVH.Update();
 }
 
 
@@ -72,6 +72,56 @@ bool CCollisionHandler::DetectHit(
 }
 
 
+CSolidObject* CCollisionHandler::DetectHitBatch(
+	const std::vector<CSolidObject*>& objects,
+	const float3 p0,
+	const float3 p1,
+	CollisionQuery* cq,
+	bool synced
+) {
+	const float3 seg = p1 - p0;
+	const float segLenSq = seg.SqLength();
+
+	float3 segDir = seg;
+	segDir.SafeNormalize();
+
+	CSolidObject* hitObject = nullptr;
+
+	float minHitDist = std::numeric_limits<float>::max();
+
+	CollisionQuery cqb;
+
+	for (CSolidObject* o: objects) {
+		const CollisionVolume* v = &o->collisionVolume;
+
+		// cheap segment-vs-bounding-sphere rejection; most of the
+		// batch never reaches the transform and exact volume test
+		// (same approximation as GetUnitsAndFeaturesColVol uses)
+		const float3 ofs = v->GetWorldSpacePos(o) - p0;
+		const float t = (segLenSq > 0.0f)? std::min(std::max(ofs.dot(seg) / segLenSq, 0.0f), 1.0f): 0.0f;
+
+		if ((ofs - seg * t).SqLength() > v->GetBoundingRadiusSq())
+			continue;
+
+		if (!DetectHit(o, o->GetTransformMatrix(synced), p0, p1, &cqb, true))
+			continue;
+
+		const float hitDist = cqb.GetHitPosDist(p0, segDir);
+
+		if (hitDist >= minHitDist)
+			continue;
+
+		minHitDist = hitDist;
+		hitObject = o;
+
+		if (cq != nullptr)
+			cq->Reset(&cqb);
+	}
+
+	return hitObject;
+}
+
+
 
 bool CCollisionHandler::Collision(
 	const CSolidObject* o,
@@ -7,6 +7,7 @@
 #include "System/float3.h"
 
 #include <algorithm>
+#include <vector>
 
 class CSolidObject;
 struct LocalModelPiece;
@@ -96,6 +97,21 @@ class CCollisionHandler {
 			CollisionQuery* cq = nullptr,
 			bool forceTrace = false
 		);
+		/**
+		 * Tests one ray segment against a whole batch of objects (as
+		 * gathered from eg. a QuadField query) and returns the object
+		 * whose intersection point lies nearest to <p0>, or null when
+		 * the segment hits none of them; candidates are pre-filtered
+		 * against their volume's bounding sphere so only likely hits
+		 * pay for the transform and the exact (continuous) test
+		 */
+		static CSolidObject* DetectHitBatch(
+			const std::vector<CSolidObject*>& objects,
+			const float3 p0,
+			const float3 p1,
+			CollisionQuery* cq = nullptr,
+			bool synced = true
+		);
 		static bool MouseHit(
 			const CSolidObject* o,
 			const CMatrix44f& m,
@@ -102,6 +102,13 @@ public:
 
 	DamageArray GetDynamicDamages(const float3& startPos, const float3& curPos) const;
 
+	/**
+	 * Whether damage actually falls off with distance; if not, callers
+	 * can use this array directly instead of paying for a copy of the
+	 * per-armor-class vector on every single hit.
+	 */
+	bool HasDynamicDamages() const { return (dynDamageExp > 0.0f); }
+
 	static const DynDamageArray* IncRef(const DynDamageArray* dda);
 	static void DecRef(const DynDamageArray* dda);
 	static DynDamageArray* GetMutable(const DynDamageArray*& dda);
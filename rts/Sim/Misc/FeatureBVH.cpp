@@ -0,0 +1,210 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include "FeatureBVH.h"
+#include "Sim/Features/Feature.h"
+#include "Sim/Features/FeatureHandler.h"
+#include "Sim/Misc/CollisionVolume.h"
+
+CFeatureBVH featureBVH;
+
+static const int MAX_LEAF_SIZE = 4;
+
+// balanced median splits bound the depth by ceil(log2(numLeaves)) + 1,
+// so this covers several million features
+static const int MAX_STACK_SIZE = 64;
+
+
+static inline bool RayIntersectsAABB(
+	const float3& mins,
+	const float3& maxs,
+	const float3& start,
+	const float3& dir,
+	const float3& invDir,
+	float maxDist
+) {
+	float tmin = 0.0f;
+	float tmax = maxDist;
+
+	for (int a = 0; a < 3; a++) {
+		if (dir[a] != 0.0f) {
+			const float t0 = (mins[a] - start[a]) * invDir[a];
+			const float t1 = (maxs[a] - start[a]) * invDir[a];
+
+			tmin = std::max(tmin, std::min(t0, t1));
+			tmax = std::min(tmax, std::max(t0, t1));
+		} else if (start[a] < mins[a] || start[a] > maxs[a]) {
+			// parallel to and outside of this slab
+			return false;
+		}
+	}
+
+	return (tmin <= tmax);
+}
+
+
+int CFeatureBVH::BuildNode(int firstLeaf, int numLeaves)
+{
+	const int nodeIdx = nodes.size();
+	nodes.emplace_back();
+
+	float3 mins( std::numeric_limits<float>::max());
+	float3 maxs(-std::numeric_limits<float>::max());
+
+	for (int i = firstLeaf; i < (firstLeaf + numLeaves); i++) {
+		mins = float3::min(mins, leaves[i].mins);
+		maxs = float3::max(maxs, leaves[i].maxs);
+	}
+
+	if (numLeaves <= MAX_LEAF_SIZE) {
+		nodes[nodeIdx] = {mins, maxs, firstLeaf, numLeaves};
+		return nodeIdx;
+	}
+
+	// split at the median along the widest centroid axis; centroid
+	// ties are broken by feature id so the tree layout never depends
+	// on the (implementation-defined) behavior of std::sort
+	float3 ctrMins( std::numeric_limits<float>::max());
+	float3 ctrMaxs(-std::numeric_limits<float>::max());
+
+	for (int i = firstLeaf; i < (firstLeaf + numLeaves); i++) {
+		const float3 ctr = (leaves[i].mins + leaves[i].maxs) * 0.5f;
+
+		ctrMins = float3::min(ctrMins, ctr);
+		ctrMaxs = float3::max(ctrMaxs, ctr);
+	}
+
+	const float3 ctrSize = ctrMaxs - ctrMins;
+
+	int axis = 0;
+
+	if (ctrSize.y > ctrSize[axis]) axis = 1;
+	if (ctrSize.z > ctrSize[axis]) axis = 2;
+
+	const auto leafCmp = [axis](const Leaf& a, const Leaf& b) {
+		const float ca = a.mins[axis] + a.maxs[axis];
+		const float cb = b.mins[axis] + b.maxs[axis];
+
+		if (ca != cb)
+			return (ca < cb);
+
+		return (a.feature->id < b.feature->id);
+	};
+
+	std::sort(leaves.begin() + firstLeaf, leaves.begin() + firstLeaf + numLeaves, leafCmp);
+
+	const int numLeft = numLeaves / 2;
+
+	// left child is built first and lands at nodeIdx + 1
+	BuildNode(firstLeaf, numLeft);
+	const int rightChild = BuildNode(firstLeaf + numLeft, numLeaves - numLeft);
+
+	nodes[nodeIdx] = {mins, maxs, rightChild, 0};
+	return nodeIdx;
+}
+
+
+void CFeatureBVH::Rebuild()
+{
+	nodes.clear();
+	leaves.clear();
+
+	if (featureHandler == nullptr)
+		return;
+
+	// iterate in id-order for deterministic construction; the active
+	// set itself is unordered
+	static std::vector<int> featureIDs;
+
+	featureIDs.clear();
+
+	for (const int id: featureHandler->GetActiveFeatureIDs()) {
+		featureIDs.push_back(id);
+	}
+
+	std::sort(featureIDs.begin(), featureIDs.end());
+
+	for (const int id: featureIDs) {
+		const CFeature* f = featureHandler->GetFeature(id);
+
+		if (f == nullptr)
+			continue;
+
+		// cover both volumes; TraceRay tests collisionVolume while
+		// GuiTraceRay tests selectionVolume, and their world-space
+		// positions and radii can differ
+		const CollisionVolume* cv = &f->collisionVolume;
+		const CollisionVolume* sv = &f->selectionVolume;
+
+		const float3 cvPos = cv->GetWorldSpacePos(f);
+		const float3 svPos = sv->GetWorldSpacePos(f);
+
+		const float cvRad = cv->GetBoundingRadius();
+		const float svRad = sv->GetBoundingRadius();
+
+		Leaf l;
+		l.mins = float3::min(cvPos - float3(cvRad, cvRad, cvRad), svPos - float3(svRad, svRad, svRad));
+		l.maxs = float3::max(cvPos + float3(cvRad, cvRad, cvRad), svPos + float3(svRad, svRad, svRad));
+		l.feature = const_cast<CFeature*>(f);
+
+		leaves.push_back(l);
+	}
+
+	if (leaves.empty())
+		return;
+
+	nodes.reserve((leaves.size() * 2) / MAX_LEAF_SIZE + 1);
+	BuildNode(0, leaves.size());
+}
+
+
+void CFeatureBVH::Update()
+{
+	if (!dirty)
+		return;
+
+	Rebuild();
+	dirty = false;
+}
+
+
+void CFeatureBVH::GetFeaturesOnRay(const float3& start, const float3& dir, float length, std::vector<CFeature*>& features)
+{
+	features.clear();
+
+	if (nodes.empty())
+		return;
+
+	const float3 invDir(1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z);
+
+	int stack[MAX_STACK_SIZE];
+	int stackSize = 0;
+
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0) {
+		const int nodeIdx = stack[--stackSize];
+		const Node& n = nodes[nodeIdx];
+
+		if (!RayIntersectsAABB(n.mins, n.maxs, start, dir, invDir, length))
+			continue;
+
+		if (n.count > 0) {
+			for (int i = 0; i < n.count; i++) {
+				const Leaf& l = leaves[n.childIdx + i];
+
+				if (RayIntersectsAABB(l.mins, l.maxs, start, dir, invDir, length)) {
+					features.push_back(l.feature);
+				}
+			}
+		} else {
+			assert((stackSize + 2) <= MAX_STACK_SIZE);
+
+			stack[stackSize++] = n.childIdx;
+			stack[stackSize++] = nodeIdx + 1;
+		}
+	}
+}
@@ -0,0 +1,73 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef FEATURE_BVH_H
+#define FEATURE_BVH_H
+
+#include <vector>
+
+#include "System/float3.h"
+#include "System/Misc/NonCopyable.h"
+
+class CFeature;
+
+/**
+ * Bounding-volume hierarchy over all live features, used by TraceRay
+ * and GuiTraceRay to collect ray candidates without walking QuadField
+ * quads (wreck fields put thousands of features on popular ray paths
+ * and every quad crossed pays for all features registered in it).
+ *
+ * Feature spawns, deaths and moves (both the QuadField registration
+ * paths and the vertical-only moves of CFeature::UpdatePosition) mark
+ * the tree dirty; CFeatureHandler::Update then rebuilds it at a fixed
+ * point of every sim frame from the live set in feature-id order, so
+ * construction never depends on container hashing or on client-local
+ * query timing and trees come out identical on every client. The
+ * amortized cost of a battle's worth of wreck churn is at most one
+ * rebuild per frame.
+ *
+ * Queries never rebuild (GuiTraceRay may also run them), they only
+ * read the tree built at the last frame boundary.
+ */
+class CFeatureBVH : spring::noncopyable
+{
+public:
+	void SetDirty() { dirty = true; }
+
+	/// rebuilds the tree if dirty; called once per sim frame from
+	/// CFeatureHandler::Update so every client rebuilds at the same
+	/// point regardless of local (unsynced) query activity
+	void Update();
+
+	/// collects all features whose bounding boxes intersect the ray
+	/// segment; callers apply their own collidability / LOS filters
+	/// and run the precise collision-volume tests on the result
+	void GetFeaturesOnRay(const float3& start, const float3& dir, float length, std::vector<CFeature*>& features);
+
+private:
+	struct Node {
+		float3 mins;
+		float3 maxs;
+		// right child if count == 0 (left child directly follows the
+		// node itself in preorder), index of the first leaf otherwise
+		int childIdx;
+		int count;
+	};
+
+	struct Leaf {
+		float3 mins;
+		float3 maxs;
+		CFeature* feature;
+	};
+
+	void Rebuild();
+	int BuildNode(int firstLeaf, int numLeaves);
+
+	std::vector<Node> nodes;
+	std::vector<Leaf> leaves;
+
+	bool dirty = true;
+};
+
+extern CFeatureBVH featureBVH;
+
+#endif // FEATURE_BVH_H
@@ -5,6 +5,8 @@
 #include "GroundBlockingObjectMap.h"
 #include "GlobalConstants.h"
 #include "Map/ReadMap.h"
+#include "Sim/MoveTypes/MoveDefHandler.h"
+#include "Sim/MoveTypes/MoveMath/MoveMath.h"
 #include "Sim/Path/IPathManager.h"
 #include "System/creg/STL_Map.h"
 #include "System/Sync/HsiehHash.h"
@@ -14,7 +16,18 @@ CGroundBlockingObjectMap* groundBlockingObjectMap = nullptr;
 
 CR_BIND(CGroundBlockingObjectMap, (1))
 CR_REG_METADATA(CGroundBlockingObjectMap, (
-	CR_MEMBER(groundBlockingMap)
+	CR_MEMBER(groundBlockingMap),
+	CR_MEMBER(spilledCells),
+	CR_MEMBER(spilledFreeSlots),
+	CR_MEMBER(structureChangeEpoch),
+	CR_MEMBER(structureBlockBits)
+))
+
+CR_BIND(CGroundBlockingObjectMap::Cell, )
+CR_REG_METADATA_SUB(CGroundBlockingObjectMap, Cell, (
+	CR_MEMBER(numObjs),
+	CR_MEMBER(poolIndex),
+	CR_MEMBER(objs)
 ))
 
 
@@ -39,10 +52,15 @@ void CGroundBlockingObjectMap::AddGroundBlockingObject(CSolidObject* object)
 
 	for (int zSqr = minZSqr; zSqr < maxZSqr; zSqr++) {
 		for (int xSqr = minXSqr; xSqr < maxXSqr; xSqr++) {
-			spring::VectorInsertUnique(GetCellUnsafe(xSqr + zSqr * mapDims.mapx), object, true);
+			CellInsertUnique(xSqr + zSqr * mapDims.mapx, object);
 		}
 	}
 
+	if (object->immobile) {
+		structureChangeEpoch += 1;
+		UpdateStructureBlockBits(object);
+	}
+
 	// FIXME: needs dependency injection (observer pattern?)
 	if (object->moveDef == nullptr && pathManager != nullptr) {
 		pathManager->TerrainChange(minXSqr, minZSqr, maxXSqr, maxZSqr, TERRAINCHANGE_OBJECT_INSERTED);
@@ -67,11 +85,16 @@ void CGroundBlockingObjectMap::AddGroundBlockingObject(CSolidObject* object, con
 			const float3 testPos = float3(x, 0.0f, z) * SQUARE_SIZE;
 
 			if (object->GetGroundBlockingMaskAtPos(testPos) & mask) {
-				spring::VectorInsertUnique(GetCellUnsafe(x + (z) * mapDims.mapx), object, true);
+				CellInsertUnique(x + (z) * mapDims.mapx, object);
 			}
 		}
 	}
 
+	if (object->immobile) {
+		structureChangeEpoch += 1;
+		UpdateStructureBlockBits(object);
+	}
+
 	// FIXME: needs dependency injection (observer pattern?)
 	if (object->moveDef == nullptr && pathManager != nullptr) {
 		pathManager->TerrainChange(minXSqr, minZSqr, maxXSqr, maxZSqr, TERRAINCHANGE_OBJECT_INSERTED_YM);
@@ -90,10 +113,15 @@ void CGroundBlockingObjectMap::RemoveGroundBlockingObject(CSolidObject* object)
 
 	for (int z = bz; z < bz + sz; ++z) {
 		for (int x = bx; x < bx + sx; ++x) {
-			spring::VectorErase(GetCellUnsafe(z * mapDims.mapx + x), object);
+			CellErase(z * mapDims.mapx + x, object);
 		}
 	}
 
+	if (object->immobile) {
+		structureChangeEpoch += 1;
+		UpdateStructureBlockBits(object);
+	}
+
 	// FIXME: needs dependency injection (observer pattern?)
 	if (object->moveDef == nullptr && pathManager != nullptr) {
 		pathManager->TerrainChange(bx, bz, bx + sx, bz + sz, TERRAINCHANGE_OBJECT_DELETED);
@@ -201,12 +229,145 @@ bool CGroundBlockingObjectMap::CanCloseYard(CSolidObject* yardUnit) const
 }
 
 
+bool CGroundBlockingObjectMap::CellInsertUnique(unsigned int mapSquare, CSolidObject* object)
+{
+	Cell& cell = groundBlockingMap[mapSquare];
+
+	if (ObjectInCell(mapSquare, object))
+		return false;
+
+	if (cell.numObjs < CELL_INLINE_SLOTS) {
+		cell.objs[cell.numObjs++] = object;
+		return true;
+	}
+
+	if (cell.numObjs == CELL_INLINE_SLOTS) {
+		// inline capacity exceeded, spill the whole cell into a pool slot
+		if (spilledFreeSlots.empty()) {
+			spilledFreeSlots.push_back(spilledCells.size());
+			spilledCells.emplace_back();
+		}
+
+		cell.poolIndex = spilledFreeSlots.back();
+		spilledFreeSlots.pop_back();
+
+		std::vector<CSolidObject*>& spill = spilledCells[cell.poolIndex];
+
+		spill.assign(&cell.objs[0], &cell.objs[0] + CELL_INLINE_SLOTS);
+		spill.push_back(object);
+
+		// the inline slots are dead while the cell is spilled; clear
+		// them so creg never serializes (soon to be) stale pointers
+		for (unsigned int i = 0; i < CELL_INLINE_SLOTS; i++) {
+			cell.objs[i] = nullptr;
+		}
+
+		cell.numObjs += 1;
+		return true;
+	}
+
+	spilledCells[cell.poolIndex].push_back(object);
+	cell.numObjs += 1;
+	return true;
+}
+
+
+bool CGroundBlockingObjectMap::CellErase(unsigned int mapSquare, CSolidObject* object)
+{
+	Cell& cell = groundBlockingMap[mapSquare];
+
+	if (cell.numObjs <= CELL_INLINE_SLOTS) {
+		for (unsigned int i = 0; i < cell.numObjs; i++) {
+			if (cell.objs[i] != object)
+				continue;
+
+			// cell contents are unordered, swap with the last object
+			cell.objs[i] = cell.objs[cell.numObjs - 1];
+			cell.objs[--cell.numObjs] = nullptr;
+			return true;
+		}
+
+		return false;
+	}
+
+	std::vector<CSolidObject*>& spill = spilledCells[cell.poolIndex];
+
+	if (!spring::VectorErase(spill, object))
+		return false;
+
+	if ((--cell.numObjs) == CELL_INLINE_SLOTS) {
+		// cell shrunk back below inline capacity; copy the objects
+		// in-place and recycle the pool slot (keeping its storage)
+		std::copy(spill.begin(), spill.end(), &cell.objs[0]);
+		spill.clear();
+
+		spilledFreeSlots.push_back(cell.poolIndex);
+		cell.poolIndex = 0;
+	}
+
+	return true;
+}
+
+
+void CGroundBlockingObjectMap::UpdateStructureBlockBits(const CSolidObject* object)
+{
+	// allocated lazily; MoveDefHandler does not exist yet when the
+	// map itself is constructed, but it does before the first object
+	// can be blocked (any earlier query falls back to cell scanning)
+	if (structureBlockBits.empty()) {
+		if (moveDefHandler == nullptr)
+			return;
+
+		structureBlockBits.resize((moveDefHandler->GetNumMoveDefs() * groundBlockingMap.size() + 7) / 8, 0);
+	}
+
+	const int bx = object->mapPos.x, sx = object->xsize;
+	const int bz = object->mapPos.y, sz = object->zsize;
+
+	for (int z = bz; z < bz + sz; ++z) {
+		for (int x = bx; x < bx + sx; ++x) {
+			UpdateCellStructureBits(z * mapDims.mapx + x);
+		}
+	}
+}
+
+
+void CGroundBlockingObjectMap::UpdateCellStructureBits(unsigned int mapSquare)
+{
+	const BlockingMapCell& cell = GetCellUnsafeConst(mapSquare);
+	const unsigned int numMoveDefs = moveDefHandler->GetNumMoveDefs();
+
+	for (unsigned int pathType = 0; pathType < numMoveDefs; pathType++) {
+		const MoveDef* moveDef = moveDefHandler->GetMoveDefByPathType(pathType);
+		const unsigned int idx = pathType * groundBlockingMap.size() + mapSquare;
+
+		bool blocked = false;
+
+		for (const CSolidObject* collidee: cell) {
+			if (!collidee->immobile)
+				continue;
+			if (CMoveMath::ObjectBlockType(*moveDef, collidee, nullptr) != CMoveMath::BLOCK_STRUCTURE)
+				continue;
+
+			blocked = true;
+			break;
+		}
+
+		if (blocked) {
+			structureBlockBits[idx >> 3] |= (1u << (idx & 7));
+		} else {
+			structureBlockBits[idx >> 3] &= ~(1u << (idx & 7));
+		}
+	}
+}
+
+
 unsigned int CGroundBlockingObjectMap::CalcChecksum() const
 {
 	unsigned int checksum = 666;
 
 	for (unsigned int i = 0; i < groundBlockingMap.size(); ++i) {
-		if (!groundBlockingMap[i].empty()) {
+		if (groundBlockingMap[i].numObjs != 0) {
 			checksum = HsiehHash(&i, sizeof(i), checksum);
 		}
 	}
@@ -3,6 +3,7 @@
 #ifndef GROUNDBLOCKINGOBJECTMAP_H
 #define GROUNDBLOCKINGOBJECTMAP_H
 
+#include <cstdint>
 #include <vector>
 
 #include "Sim/Objects/SolidObject.h"
@@ -10,13 +11,49 @@
 #include "System/float3.h"
 
 
-typedef std::vector<CSolidObject*> BlockingMapCell;
-typedef std::vector<BlockingMapCell> BlockingMap;
+/// contiguous view of one square's blockers; they are stored inline
+/// in the flat cell array (or wholly in a pool slot once spilled) so
+/// scans over a cell are sequential reads either way
+struct BlockingMapCell {
+	CSolidObject* const* begin() const { return objs; }
+	CSolidObject* const* end() const { return (objs + numObjs); }
+	CSolidObject* const* cbegin() const { return begin(); }
+	CSolidObject* const* cend() const { return end(); }
+
+	bool empty() const { return (numObjs == 0); }
+	unsigned int size() const { return numObjs; }
+
+	CSolidObject* operator [] (unsigned int i) const { return objs[i]; }
+
+	CSolidObject* const* objs;
+	unsigned int numObjs;
+};
 
 
 class CGroundBlockingObjectMap
 {
 	CR_DECLARE_STRUCT(CGroundBlockingObjectMap)
+	CR_DECLARE_SUB(Cell)
+
+public:
+	static const unsigned int CELL_INLINE_SLOTS = 4;
+
+	/// one square of the flat cell array; holds its blockers inline,
+	/// squares with more than CELL_INLINE_SLOTS of them (rare) spill
+	/// wholly into a recycled slot of the shared overflow pool
+	struct Cell {
+		CR_DECLARE_STRUCT(Cell)
+
+		Cell(): numObjs(0), poolIndex(0) {
+			for (unsigned int i = 0; i < CELL_INLINE_SLOTS; i++) {
+				objs[i] = nullptr;
+			}
+		}
+
+		unsigned int numObjs;
+		unsigned int poolIndex;
+		CSolidObject* objs[CELL_INLINE_SLOTS];
+	};
 
 public:
 	CGroundBlockingObjectMap(int numSquares) {
@@ -65,20 +102,64 @@ public:
 	}
 
 
-	const BlockingMapCell& GetCellUnsafeConst(unsigned int mapSquare) const {
+	BlockingMapCell GetCellUnsafeConst(unsigned int mapSquare) const {
 		assert(mapSquare < groundBlockingMap.size());
-		return groundBlockingMap[mapSquare];
+		const Cell& cell = groundBlockingMap[mapSquare];
+
+		if (cell.numObjs <= CELL_INLINE_SLOTS)
+			return {cell.objs, cell.numObjs};
+
+		return {spilledCells[cell.poolIndex].data(), cell.numObjs};
 	}
 
-	BlockingMapCell& GetCellUnsafe(unsigned int mapSquare) {
-		return (const_cast<BlockingMapCell&>(GetCellUnsafeConst(mapSquare)));
+
+	/// whether the per-MoveDef structure bits have been allocated yet
+	/// (they are not before the first immobile object gets blocked);
+	/// queries must fall back to scanning cells while this is false
+	bool HasStructureBlockBits() const { return (!structureBlockBits.empty()); }
+
+	/// true iff some immobile object in mapSquare structure-blocks the
+	/// given MoveDef under the collider-less ObjectBlockType rules, so
+	/// collider-less footprint tests reduce to single bit reads; exact
+	/// only for those since the water-based exemptions depend on the
+	/// collider instance
+	bool SquareIsStructureBlocked(unsigned int pathType, unsigned int mapSquare) const {
+		const unsigned int idx = pathType * groundBlockingMap.size() + mapSquare;
+		return ((structureBlockBits[idx >> 3] & (1u << (idx & 7))) != 0);
 	}
 
+	/// re-derives the structure bits for all squares of an (immobile)
+	/// object's footprint; also needed when the crushability or solid
+	/// collidability of an already-blocked object is changed from Lua
+	void UpdateStructureBlockBits(const CSolidObject* object);
+
+	/// bumped whenever an immobile object is (un)blocked, lets cached
+	/// obstruction-dependent results detect structure changes cheaply
+	unsigned int GetStructureChangeEpoch() const { return structureChangeEpoch; }
+
 private:
 	bool CheckYard(CSolidObject* yardUnit, const YardMapStatus& mask) const;
 
+	void UpdateCellStructureBits(unsigned int mapSquare);
+
+	bool CellInsertUnique(unsigned int mapSquare, CSolidObject* object);
+	bool CellErase(unsigned int mapSquare, CSolidObject* object);
+
 private:
-	BlockingMap groundBlockingMap;
+	std::vector<Cell> groundBlockingMap;
+
+	///< shared overflow arena for cells that outgrow their inline
+	///< capacity; emptied slots are recycled through spilledFreeSlots
+	///< (capacity intact) so steady-state traffic does not allocate
+	std::vector< std::vector<CSolidObject*> > spilledCells;
+	std::vector<unsigned int> spilledFreeSlots;
+
+	unsigned int structureChangeEpoch = 0;
+
+	///< one bit per (MoveDef, square) pair in pathType-major order;
+	///< maintained incrementally on (un)block events of immobiles so
+	///< the pathfinders do not rescan cell contents on every query
+	std::vector<std::uint8_t> structureBlockBits;
 };
 
 extern CGroundBlockingObjectMap* groundBlockingObjectMap;
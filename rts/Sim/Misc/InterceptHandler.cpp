@@ -48,6 +48,29 @@ void CInterceptHandler::Update(bool forced) {
 			if (teamHandler->IsValidAllyTeam(pAllyTeam) && teamHandler->Ally(wOwner->allyteam, pAllyTeam))
 				continue;
 
+			const float3& pTargetPos = p->GetTargetPos();
+			const float3  pWeaponVec = p->pos - w->aimFromPos;
+
+			{
+				// cheap conservative filter in front of the per-pair event
+				// and ground-intersection work below; cases 1-4 only test
+				// points on p's forward flight path (or its target), so if
+				// neither comes within the coverage circle in 2D the pair
+				// can not match and the expensive checks are skipped
+				float3 pFlatWeaponVec = pWeaponVec;
+				float3 pFlatDir = p->dir;
+
+				pFlatWeaponVec.y = 0.0f;
+				pFlatDir.y = 0.0f;
+
+				const float dirSq = pFlatDir.SqLength();
+				const float t = (dirSq > 0.0f)? std::max(0.0f, -(pFlatWeaponVec.dot(pFlatDir)) / dirSq): 0.0f;
+				const float trajSepSq = (pFlatWeaponVec + pFlatDir * t).SqLength();
+
+				if (trajSepSq >= Square(wDef->coverageRange) && w->aimFromPos.SqDistance2D(pTargetPos) >= Square(wDef->coverageRange))
+					continue;
+			}
+
 			// note: will be called every Update so long as gadget does not return true
 			if (!eventHandler.AllowWeaponInterceptTarget(wOwner, w, p))
 				continue;
@@ -64,8 +87,6 @@ void CInterceptHandler::Update(bool forced) {
 			const float impactDist = CGround::LineGroundCol(p->pos, p->pos + p->dir * weaponDist);
 
 			const float3& pImpactPos = p->pos + p->dir * impactDist;
-			const float3& pTargetPos = p->GetTargetPos();
-			const float3  pWeaponVec = p->pos - w->aimFromPos;
 
 			if (w->aimFromPos.SqDistance2D(pTargetPos) < Square(wDef->coverageRange)) {
 				w->AddDeathDependence(p, DEPENDENCE_INTERCEPT);
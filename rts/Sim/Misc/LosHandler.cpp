@@ -7,6 +7,7 @@
 #include "Sim/Units/UnitHandler.h"
 #include "Sim/Misc/TeamHandler.h"
 #include "Sim/Misc/ModInfo.h"
+#include "Game/GlobalUnsynced.h"
 #include "Map/ReadMap.h"
 #include "System/Log/ILog.h"
 #include "System/Sync/HsiehHash.h"
@@ -40,7 +41,8 @@ CR_REG_METADATA(CLosHandler,(
 	CR_MEMBER(baseRadarErrorSize),
 	CR_MEMBER(baseRadarErrorMult),
 	CR_MEMBER(radarErrorSizes),
-	CR_IGNORED(losTypes)
+	CR_IGNORED(losTypes),
+	CR_MEMBER(prevGlobalLOS)
 ))
 
 
@@ -180,8 +182,36 @@ inline void ILosType::UpdateUnit(CUnit* unit, bool ignore)
 	};
 
 	// unchanged?
-	if (CanRefInstance(uli))
+	if (CanRefInstance(uli)) {
+		// the unit returned to its previous square before the
+		// deadline, the whole remove/add pair is skipped
+		if (!deferredMoves.empty())
+			deferredMoves.erase(unit->id);
+
 		return;
+	}
+
+	// only the los-square position changed: defer the refresh for a
+	// few frames, units jittering around a square boundary (eg. in a
+	// chokepoint) tend to return to their previous square right away
+	if (modInfo.losDeferredUpdates > 0 && uli != nullptr
+	    && (uli->baseHeight == height)
+	    && (uli->radius     == radius)
+	    && (uli->allyteam   == allyteam)
+	) {
+		const auto it = deferredMoves.find(unit->id);
+
+		if (it == deferredMoves.end()) {
+			deferredMoves[unit->id] = gs->frameNum;
+			return;
+		}
+
+		if ((gs->frameNum - it->second) < modInfo.losDeferredUpdates)
+			return;
+	}
+
+	if (!deferredMoves.empty())
+		deferredMoves.erase(unit->id);
 
 	if (uli != nullptr) {
 		unit->los[type] = nullptr;
@@ -217,6 +247,9 @@ inline void ILosType::UpdateUnit(CUnit* unit, bool ignore)
 
 inline void ILosType::RemoveUnit(CUnit* unit, bool delayed)
 {
+	if (!deferredMoves.empty())
+		deferredMoves.erase(unit->id);
+
 	if (unit->los[type] == nullptr)
 		return;
 
@@ -504,11 +537,30 @@ void ILosType::Update()
 		}
 	}
 
+	// true for allyteams whose squares must inform ReadMap when they
+	// enter the local player's view (mirrors the conditions checked
+	// by CLosMap::AddRaycast)
+	const auto sendsReadmapEvents = [&](int allyTeam) {
+	#ifdef USE_UNSYNCED_HEIGHTMAP
+		return (losMaps[allyTeam].SendReadmapEvents() && (allyTeam == gu->myAllyTeam || gu->spectatingFullView));
+	#else
+		(void) allyTeam;
+		return false;
+	#endif
+	};
+
 	// remove sight
-	//FIXME multithread?
-	for (SLosInstance* li: losRemove) {
-		LosRemove(li);
-	}
+	// each allyteam's count map is a disjoint memory region and removing
+	// sight never raises readmap events, so the per-team merge queues can
+	// run in parallel; instances are still applied in queue order within
+	// every team, making the result independent of scheduling (sync-safe)
+	for_mt(0, losMaps.size(), [&](const int allyTeam) {
+		for (SLosInstance* li: losRemove) {
+			if (li->allyteam == allyTeam) {
+				LosRemove(li);
+			}
+		}
+	});
 
 	// raycast terrain
 	if (algoType == LOS_ALGO_RAYCAST)  {
@@ -520,10 +572,26 @@ void ILosType::Update()
 		});
 	}
 
-	// add sight
+	// add sight, split per allyteam as above; teams that have to raise
+	// readmap events are merged on the calling thread afterwards since
+	// ReadMap::UpdateLOS is not thread-safe
+	for_mt(0, losMaps.size(), [&](const int allyTeam) {
+		if (sendsReadmapEvents(allyTeam))
+			return;
+
+		for (SLosInstance* li: losAdd) {
+			if (li->allyteam == allyTeam) {
+				assert(li->refCount > 0);
+				LosAdd(li);
+			}
+		}
+	});
+
 	for (SLosInstance* li: losAdd) {
-		assert(li->refCount > 0);
-		LosAdd(li);
+		if (sendsReadmapEvents(li->allyteam)) {
+			assert(li->refCount > 0);
+			LosAdd(li);
+		}
 	}
 
 	// delete / move to cache unused instances
@@ -624,6 +692,7 @@ CLosHandler::CLosHandler()
 	, baseRadarErrorSize(defBaseRadarErrorSize)
 	, baseRadarErrorMult(defBaseRadarErrorMult)
 	, radarErrorSizes(teamHandler->ActiveAllyTeams(), defBaseRadarErrorSize)
+	, prevGlobalLOS{false}
 {
 	losTypes.reserve(ILosType::LOS_TYPE_COUNT);
 	losTypes.push_back(&los);
@@ -737,6 +806,49 @@ void CLosHandler::UpdateHeightMapSynced(SRectangle rect)
 }
 
 
+void CLosHandler::CollectChangedAreas(std::vector<std::vector<SRectangle>>& areas)
+{
+	for (auto& rects: areas) {
+		rects.clear();
+	}
+
+	for (ILosType* lt: losTypes) {
+		// without separate jammers every jammer writes to map 0 but
+		// affects the radar coverage of all allyteams (see InJammer)
+		const bool jammerType = (lt->type == ILosType::LOS_TYPE_JAMMER || lt->type == ILosType::LOS_TYPE_SONAR_JAMMER);
+		const bool sharedMap = (jammerType && !modInfo.separateJammers);
+
+		for (size_t at = 0; at < lt->losMaps.size(); ++at) {
+			CLosMap& losMap = lt->losMaps[at];
+
+			const std::vector<SRectangle>& changedRects = losMap.GetChangedRects();
+
+			if (changedRects.empty())
+				continue;
+
+			if (sharedMap) {
+				for (auto& rects: areas) {
+					rects.insert(rects.end(), changedRects.begin(), changedRects.end());
+				}
+			} else if (at < areas.size()) {
+				areas[at].insert(areas[at].end(), changedRects.begin(), changedRects.end());
+			}
+
+			losMap.ClearChangedRects();
+		}
+	}
+
+	// Lua can flip global los at any time, invalidating every status
+	for (size_t at = 0; at < areas.size(); ++at) {
+		if (prevGlobalLOS[at] == globalLOS[at])
+			continue;
+
+		prevGlobalLOS[at] = globalLOS[at];
+		areas[at].emplace_back(0, 0, mapDims.mapx, mapDims.mapy);
+	}
+}
+
+
 bool CLosHandler::InLos(const CUnit* unit, int allyTeam) const
 {
 	// NOTE: units are treated differently than world objects in two ways:
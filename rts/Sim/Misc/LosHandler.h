@@ -181,6 +181,9 @@ private:
 
 	std::deque<DelayedInstance> delayedDeleteQue;
 	std::deque<DelayedInstance> delayedTerraQue;
+	// unitID -> frame on which a (deferrable) los-square move was
+	// first seen; empty unless modInfo.losDeferredUpdates is active
+	spring::unordered_map<int, int> deferredMoves;
 	std::deque<SLosInstance*> losUpdate;
 	std::deque<SLosInstance*> losCache;
 	static constexpr int CACHE_SIZE = 4096;
@@ -280,6 +283,12 @@ public:
 	void Update() override;
 	void UpdateHeightMapSynced(SRectangle rect);
 
+	/// moves the coverage-change rectangles accumulated by every los-type
+	/// into <areas> (indexed by allyteam, in map squares); consumed once
+	/// per frame by CUnitHandler so only units that moved or stand inside
+	/// a changed area get their losStatus re-evaluated
+	void CollectChangedAreas(std::vector<std::vector<SRectangle>>& areas);
+
 public:
 	/**
 	* @brief global line-of-sight
@@ -305,6 +314,10 @@ private:
 	float baseRadarErrorMult;
 	std::vector<float> radarErrorSizes;
 	std::vector<ILosType*> losTypes;
+
+	/// globalLOS as of the previous CollectChangedAreas call; a flip
+	/// invalidates every unit's status for that allyteam at once
+	bool prevGlobalLOS[MAX_TEAMS];
 };
 
 
@@ -33,9 +33,18 @@ static void isqrtTableExpand(unsigned r, int threadNum)
 	if (r < isqrtTable.size())
 		return;
 
-	for (unsigned i = isqrtTable.size(); i <= r; ++i) {
-		isqrtTable.push_back(math::isqrt(std::max(i, 1u)));
+	const size_t base = isqrtTable.size();
+
+	// write the arguments into the new slots, then overwrite them with
+	// the vectorized kernel (bit-identical to scalar math::isqrt, the
+	// tables feed synced sight-line stepping)
+	isqrtTable.resize(r + 1);
+
+	for (size_t i = base; i <= r; ++i) {
+		isqrtTable[i] = std::max(unsigned(i), 1u);
 	}
+
+	fastmath::isqrt2_batch(&isqrtTable[base], &isqrtTable[base], isqrtTable.size() - base);
 }
 
 
@@ -392,6 +401,9 @@ void CLosMap::AddCircle(SLosInstance* instance, int amount)
 	//only AddRaycast supports UnsyncedHeightMap updates
 #endif
 
+	int2 cMin = {size.x, size.y};
+	int2 cMax = {-1, -1};
+
 	MidpointCircleAlgoPerLine(instance->radius, [&](int width, int y) {
 		const unsigned y_ = instance->basePos.y + y;
 		if (y_ < size.y) {
@@ -399,10 +411,21 @@ void CLosMap::AddCircle(SLosInstance* instance, int amount)
 			const unsigned ex = Clamp(instance->basePos.x + width + 1, 0, size.x);
 
 			for (unsigned x_ = sx; x_ < ex; ++x_) {
-				losmap[(y_ * size.x) + x_] += amount;
+				const unsigned idx = (y_ * size.x) + x_;
+
+				losmap[idx] += amount;
+
+				// skip squares that neither entered nor left coverage
+				if ((amount > 0)? (losmap[idx] != amount): (losmap[idx] != 0))
+					continue;
+
+				cMin.x = std::min(cMin.x, int(x_)); cMax.x = std::max(cMax.x, int(x_));
+				cMin.y = std::min(cMin.y, int(y_)); cMax.y = std::max(cMax.y, int(y_));
 			}
 		}
 	});
+
+	AddChangedRect(cMin, cMax);
 }
 
 
@@ -411,6 +434,9 @@ void CLosMap::AddRaycast(SLosInstance* instance, int amount)
 	if (instance->squares.empty() || instance->squares.front().length == SLosInstance::EMPTY_RLE.length)
 		return;
 
+	int2 cMin = {size.x, size.y};
+	int2 cMax = {-1, -1};
+
 #ifdef USE_UNSYNCED_HEIGHTMAP
 	// Inform ReadMap when squares enter LoS
 	const bool updateUnsyncedHeightMap = (instance->allyteam >= 0 && (instance->allyteam == gu->myAllyTeam || gu->spectatingFullView));
@@ -431,10 +457,14 @@ void CLosMap::AddRaycast(SLosInstance* instance, int amount)
 				const int2 p2 = (lm + int2(1, 1)) * LOS2HEIGHT;
 				const int2 p3 = {std::min(p2.x, mapDims.mapxm1), std::min(p2.y, mapDims.mapym1)};
 
+				cMin.x = std::min(cMin.x, lm.x); cMax.x = std::max(cMax.x, lm.x);
+				cMin.y = std::min(cMin.y, lm.y); cMax.y = std::max(cMax.y, lm.y);
+
 				readMap->UpdateLOS(SRectangle(p1.x, p1.y,  p3.x, p3.y));
 			}
 		}
 
+		AddChangedRect(cMin, cMax);
 		return;
 	}
 #endif
@@ -444,8 +474,32 @@ void CLosMap::AddRaycast(SLosInstance* instance, int amount)
 
 		for (int l = rle.length; l > 0; --l, ++idx) {
 			losmap[idx] += amount;
+
+			// skip squares that neither entered nor left coverage
+			if ((amount > 0)? (losmap[idx] != amount): (losmap[idx] != 0))
+				continue;
+
+			const int2 lm = IdxToCoord(idx, size.x);
+
+			cMin.x = std::min(cMin.x, lm.x); cMax.x = std::max(cMax.x, lm.x);
+			cMin.y = std::min(cMin.y, lm.y); cMax.y = std::max(cMax.y, lm.y);
 		}
 	}
+
+	AddChangedRect(cMin, cMax);
+}
+
+
+void CLosMap::AddChangedRect(const int2 cMin, const int2 cMax)
+{
+	if (cMax.x < cMin.x)
+		return;
+
+	// scale from los-squares up to full-resolution map squares
+	changedRects.emplace_back(
+		 cMin.x      * LOS2HEIGHT.x,  cMin.y      * LOS2HEIGHT.y,
+		(cMax.x + 1) * LOS2HEIGHT.x, (cMax.y + 1) * LOS2HEIGHT.y
+	);
 }
 
 
@@ -8,6 +8,7 @@
 #include <vector>
 #include "System/type2.h"
 #include "System/myMath.h"
+#include "System/Rectangle.h"
 
 
 struct SLosInstance;
@@ -45,7 +46,17 @@ public:
 	// FIXME temp fix for CBaseGroundDrawer and AI interface, which need raw data
 	unsigned short& front() { return losmap.front(); }
 
+	bool SendReadmapEvents() const { return sendReadmapEvents; }
+
+	/// bounding rectangles (in full-resolution map squares, max-exclusive)
+	/// around squares whose count crossed zero since the last clear; one
+	/// entry per applied instance that changed coverage anywhere
+	const std::vector<SRectangle>& GetChangedRects() const { return changedRects; }
+	void ClearChangedRects() { changedRects.clear(); }
+
 private:
+	void AddChangedRect(const int2 cMin, const int2 cMax);
+
 	void LosAdd(SLosInstance* instance) const;
 	void UnsafeLosAdd(SLosInstance* instance) const;
 	void SafeLosAdd(SLosInstance* instance) const;
@@ -56,6 +67,7 @@ protected:
 	const int2 size;
 	const int2 LOS2HEIGHT;
 	std::vector<unsigned short> losmap;
+	std::vector<SRectangle> changedRects;
 	bool sendReadmapEvents;
 	const float* const heightmap;
 };
@@ -5,6 +5,7 @@
 
 #include "Lua/LuaParser.h"
 #include "Lua/LuaSyncedRead.h"
+#include "Sim/Misc/GlobalConstants.h"
 #include "System/Log/ILog.h"
 #include "System/FileSystem/ArchiveScanner.h"
 #include "System/Exceptions.h"
@@ -70,6 +71,7 @@ void CModInfo::ResetState()
 	losMipLevel = 0;
 	airMipLevel = 0;
 	radarMipLevel = 0;
+	losDeferredUpdates = 0;
 
 	requireSonarUnderWater = true;
 	alwaysVisibleOverridesCloaked = false;
@@ -80,6 +82,10 @@ void CModInfo::ResetState()
 	pathFinderSystem = PFS_TYPE_DEFAULT;
 	pfUpdateRate     = 0.0f;
 
+	pfHeatMapping      = true;
+	pfHeatMapResolution = 1;
+	pfHeatMapDecayRate  = 1;
+
 	allowTake = true;
 }
 
@@ -118,6 +124,10 @@ void CModInfo::Init(const char* modArchive)
 		pathFinderSystem = system.GetInt("pathFinderSystem", PFS_TYPE_DEFAULT) % PFS_NUM_TYPES;
 		pfUpdateRate = system.GetFloat("pathFinderUpdateRate", 0.007f);
 
+		pfHeatMapping = system.GetBool("pathHeatMapping", true);
+		pfHeatMapResolution = std::max(1, system.GetInt("pathHeatMapResolution", 1));
+		pfHeatMapDecayRate = std::max(1, system.GetInt("pathHeatMapDecayRate", 1));
+
 		allowTake = system.GetBool("allowTake", true);
 	}
 
@@ -246,6 +256,12 @@ void CModInfo::Init(const char* modArchive)
 
 		radarMipLevel = los.GetInt("radarMipLevel", 2);
 
+		// trades up to <n> frames of sensor staleness for fewer
+		// LOS recalculations when units oscillate around square
+		// boundaries; cap at one second of simulated time
+		losDeferredUpdates = los.GetInt("losDeferredUpdates", 0);
+		losDeferredUpdates = Clamp(losDeferredUpdates, 0, GAME_SPEED);
+
 		if ((losMipLevel < 0) || (losMipLevel > 6)) {
 			throw content_error("Sensors\\Los\\LosMipLevel out of bounds. "
 				                "The minimum value is 0. The maximum value is 6.");
@@ -127,6 +127,11 @@ public:
 	/// miplevel to use for radar, sonar, seismic, jammer, ...
 	int radarMipLevel;
 
+	/// number of frames a pure los-square position change may be
+	/// deferred; jittering units that return to their previous
+	/// square in time skip the remove/add pair entirely (0 = off)
+	int losDeferredUpdates;
+
 	/// when underwater, units are not in LOS unless also in sonar
 	bool requireSonarUnderWater;
 	///
@@ -147,6 +152,15 @@ public:
 	int pathFinderSystem;
 	float pfUpdateRate;
 
+	/// whether the default PFS keeps a heat-map at all; games in which
+	/// crowding barely matters can turn the cost layer off completely
+	bool pfHeatMapping;
+	/// heat-map cell-size step; cells cover 2^N map squares per axis
+	/// (N = PATH_HEATMAP_XSCALE + pfHeatMapResolution - 1, default 2)
+	int pfHeatMapResolution;
+	/// amount by which heat decays per PathHeatMap::Update (sim frame)
+	int pfHeatMapDecayRate;
+
 	bool allowTake;
 };
 
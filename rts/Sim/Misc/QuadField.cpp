@@ -11,6 +11,7 @@
 
 #ifndef UNIT_TEST
 	#include "Sim/Features/Feature.h"
+	#include "Sim/Misc/FeatureBVH.h"
 	#include "Sim/Projectiles/Projectile.h"
 	#include "Sim/Units/Unit.h"
 	#include "Sim/Weapons/PlasmaRepulser.h"
@@ -19,10 +20,14 @@
 CR_BIND(CQuadField, (int2(1,1), 1))
 CR_REG_METADATA(CQuadField, (
 	CR_MEMBER(baseQuads),
+	CR_MEMBER(activityStamps),
 	CR_MEMBER(numQuadsX),
 	CR_MEMBER(numQuadsZ),
 	CR_MEMBER(quadSizeX),
 	CR_MEMBER(quadSizeZ),
+	CR_MEMBER(numActQuadsX),
+	CR_MEMBER(numActQuadsZ),
+	CR_MEMBER(numActAllyTeams),
 
 	CR_IGNORED(tempUnits),
 	CR_IGNORED(tempFeatures),
@@ -125,6 +130,18 @@ CQuadField::CQuadField(int2 mapDims, int quad_size)
 	assert((mapDims.y * SQUARE_SIZE) % quad_size == 0);
 
 	baseQuads.resize(numQuadsX * numQuadsZ);
+
+	numActQuadsX = std::max(1, (mapDims.x * SQUARE_SIZE) / int(BASE_QUAD_SIZE));
+	numActQuadsZ = std::max(1, (mapDims.y * SQUARE_SIZE) / int(BASE_QUAD_SIZE));
+
+#ifndef UNIT_TEST
+	numActAllyTeams = teamHandler->ActiveAllyTeams();
+#else
+	numActAllyTeams = 0;
+#endif
+
+	activityStamps.clear();
+	activityStamps.resize(numActQuadsX * numActQuadsZ * numActAllyTeams, -1);
 }
 
 
@@ -133,6 +150,117 @@ CQuadField::~CQuadField()
 }
 
 
+#ifndef UNIT_TEST
+void CQuadField::Resize(int quad_size)
+{
+	assert(quad_size >= MIN_QUAD_SIZE);
+
+	if (quad_size == quadSizeX)
+		return;
+
+	const int mapWidth  = numQuadsX * quadSizeX;
+	const int mapHeight = numQuadsZ * quadSizeZ;
+
+	assert((mapWidth  % quad_size) == 0);
+	assert((mapHeight % quad_size) == 0);
+
+	// collect all registered objects; quad-order iteration plus the
+	// tempNum filter keeps the relative order deterministic (the new
+	// per-quad lists must match on every client)
+	std::vector<CUnit*> units;
+	std::vector<CFeature*> features;
+	std::vector<CProjectile*> projectiles;
+	std::vector<CPlasmaRepulser*> repulsers;
+
+	const int tempNum = gs->GetTempNum();
+
+	for (const Quad& quad: baseQuads) {
+		for (CUnit* u: quad.units) {
+			if (u->tempNum == tempNum)
+				continue;
+
+			u->tempNum = tempNum;
+			units.push_back(u);
+		}
+		for (CFeature* f: quad.features) {
+			if (f->tempNum == tempNum)
+				continue;
+
+			f->tempNum = tempNum;
+			features.push_back(f);
+		}
+		for (CProjectile* p: quad.projectiles) {
+			if (p->tempNum == tempNum)
+				continue;
+
+			p->tempNum = tempNum;
+			projectiles.push_back(p);
+		}
+		for (CPlasmaRepulser* r: quad.repulsers) {
+			if (r->tempNum == tempNum)
+				continue;
+
+			r->tempNum = tempNum;
+			repulsers.push_back(r);
+		}
+	}
+
+	// rebuild the grid itself
+	quadSizeX = quad_size;
+	quadSizeZ = quad_size;
+	numQuadsX = mapWidth  / quad_size;
+	numQuadsZ = mapHeight / quad_size;
+
+	baseQuads.clear();
+	baseQuads.resize(numQuadsX * numQuadsZ);
+
+	// migrate the objects; their cached quad lists refer to the old
+	// grid and must be dropped before re-insertion
+	for (CUnit* u: units) {
+		u->quads.clear();
+		MovedUnit(u);
+	}
+	for (CFeature* f: features) {
+		AddFeature(f);
+	}
+	for (CProjectile* p: projectiles) {
+		p->quads.clear();
+		AddProjectile(p);
+	}
+	for (CPlasmaRepulser* r: repulsers) {
+		r->quads.clear();
+		MovedRepulser(r);
+	}
+}
+
+
+void CQuadField::Update()
+{
+	// dynamic resolution scaling; check whether the average loading
+	// factor has crossed the threshold only once per second, and at
+	// most halve the quad size each time so the cost of the rebuild
+	// stays spread out over multiple checks
+	if ((gs->frameNum % GAME_SPEED) != 0)
+		return;
+
+	if ((quadSizeX >> 1) < MIN_QUAD_SIZE)
+		return;
+
+	size_t numQuadObjs = 0;
+
+	for (const Quad& quad: baseQuads) {
+		numQuadObjs += quad.units.size();
+		numQuadObjs += quad.features.size();
+	}
+
+	if (numQuadObjs < (baseQuads.size() * RESIZE_OCCUPANCY))
+		return;
+
+	Resize(quadSizeX >> 1);
+}
+#endif // UNIT_TEST
+
+
 int2 CQuadField::WorldPosToQuadField(const float3 p) const
 {
 	return int2(
@@ -150,16 +278,22 @@ int CQuadField::WorldPosToQuadFieldIdx(const float3 p) const
 
 #ifndef UNIT_TEST
 const std::vector<int>& CQuadField::GetQuads(float3 pos, float radius)
+{
+	GetQuads(pos, radius, tempQuads);
+	return tempQuads;
+}
+
+void CQuadField::GetQuads(float3 pos, float radius, std::vector<int>& quads) const
 {
 	pos.AssertNaNs();
 	pos.ClampInBounds();
-	tempQuads.clear();
+	quads.clear();
 
 	const int2 min = WorldPosToQuadField(pos - radius);
 	const int2 max = WorldPosToQuadField(pos + radius);
 
 	if (max.y < min.y || max.x < min.x)
-		return tempQuads;
+		return;
 
 	// qsx and qsz are always equal
 	const float maxSqLength = (radius + quadSizeX * 0.72f) * (radius + quadSizeZ * 0.72f);
@@ -170,46 +304,54 @@ const std::vector<int>& CQuadField::GetQuads(float3 pos, float radius)
 			assert(z < numQuadsZ);
 			const float3 quadPos = float3(x * quadSizeX + quadSizeX * 0.5f, 0, z * quadSizeZ + quadSizeZ * 0.5f);
 			if (pos.SqDistance2D(quadPos) < maxSqLength) {
-				tempQuads.push_back(z * numQuadsX + x);
+				quads.push_back(z * numQuadsX + x);
 			}
 		}
 	}
-
-	return tempQuads;
 }
 
 
 const std::vector<int>& CQuadField::GetQuadsRectangle(const float3& mins, const float3& maxs)
+{
+	GetQuadsRectangle(mins, maxs, tempQuads);
+	return tempQuads;
+}
+
+void CQuadField::GetQuadsRectangle(const float3& mins, const float3& maxs, std::vector<int>& quads) const
 {
 	mins.AssertNaNs();
 	maxs.AssertNaNs();
-	tempQuads.clear();
+	quads.clear();
 
 	const int2 min = WorldPosToQuadField(mins);
 	const int2 max = WorldPosToQuadField(maxs);
 
 	if (max.y < min.y || max.x < min.x)
-		return tempQuads;
+		return;
 
 	for (int z = min.y; z <= max.y; ++z) {
 		for (int x = min.x; x <= max.x; ++x) {
 			assert(x < numQuadsX);
 			assert(z < numQuadsZ);
-			tempQuads.push_back(z * numQuadsX + x);
+			quads.push_back(z * numQuadsX + x);
 		}
 	}
-
-	return tempQuads;
 }
 #endif // UNIT_TEST
 
 
 /// note: this function got an UnitTest, check the tests/ folder!
 const std::vector<int>& CQuadField::GetQuadsOnRay(const float3& start, const float3& dir, float length)
+{
+	GetQuadsOnRay(start, dir, length, tempQuads);
+	return tempQuads;
+}
+
+void CQuadField::GetQuadsOnRay(const float3& start, const float3& dir, float length, std::vector<int>& quads) const
 {
 	dir.AssertNaNs();
 	start.AssertNaNs();
-	tempQuads.clear();
+	quads.clear();
 
 	const float3 to = start + (dir * length);
 	const float3 invQuadSize = float3(1.0f / quadSizeX, 1.0f, 1.0f / quadSizeZ);
@@ -219,9 +361,9 @@ const std::vector<int>& CQuadField::GetQuadsOnRay(const float3& start, const flo
 
 	// often happened special case
 	if (noXdir && noZdir) {
-		tempQuads.push_back(WorldPosToQuadFieldIdx(start));
-		assert(unsigned(tempQuads.back()) < baseQuads.size());
-		return tempQuads;
+		quads.push_back(WorldPosToQuadFieldIdx(start));
+		assert(unsigned(quads.back()) < baseQuads.size());
+		return;
 	}
 
 	// to prevent Div0
@@ -234,11 +376,11 @@ const std::vector<int>& CQuadField::GetQuadsOnRay(const float3& start, const flo
 		const int row = Clamp<int>(start.z * invQuadSize.z, 0, numQuadsZ - 1) * numQuadsX;
 
 		for (unsigned x = startX; x <= finalX; x++) {
-			tempQuads.push_back(row + x);
-			assert(unsigned(tempQuads.back()) < baseQuads.size());
+			quads.push_back(row + x);
+			assert(unsigned(quads.back()) < baseQuads.size());
 		}
 
-		return tempQuads;
+		return;
 	}
 
 	// all other
@@ -271,12 +413,10 @@ const std::vector<int>& CQuadField::GetQuadsOnRay(const float3& start, const flo
 		const int row = Clamp(z, 0, numQuadsZ - 1) * numQuadsX;
 
 		for (unsigned x = startX; x <= finalX; x++) {
-			tempQuads.push_back(row + x);
-			assert(unsigned(tempQuads.back()) < baseQuads.size());
+			quads.push_back(row + x);
+			assert(unsigned(quads.back()) < baseQuads.size());
 		}
 	}
-
-	return tempQuads;
 }
 
 
@@ -292,17 +432,81 @@ void CQuadField::MovedUnit(CUnit* unit)
 		}
 	}
 
-	for (const int qi: unit->quads) {
-		spring::VectorErase(baseQuads[qi].units, unit);
-		spring::VectorErase(baseQuads[qi].teamUnits[unit->allyteam], unit);
+	// quad set changed, i.e. the unit entered (or left) a region;
+	// record this for event-assisted idle target scanning
+	StampActivityCells(unit);
+
+	// GetQuads pushes indices in ascending (row-major) order, so both
+	// lists are sorted; walk them in lock-step and touch only the cells
+	// in the symmetric difference (consecutive quad sets of a moving
+	// object overlap almost entirely)
+	assert(std::is_sorted(newQuads.begin(), newQuads.end()));
+	assert(std::is_sorted(unit->quads.begin(), unit->quads.end()));
+
+	auto oldIt = unit->quads.cbegin();
+	auto newIt = newQuads.cbegin();
+
+	while (oldIt != unit->quads.cend() || newIt != newQuads.cend()) {
+		if (newIt == newQuads.cend() || (oldIt != unit->quads.cend() && *oldIt < *newIt)) {
+			spring::VectorErase(baseQuads[*oldIt].units, unit);
+			spring::VectorErase(baseQuads[*oldIt].teamUnits[unit->allyteam], unit);
+			++oldIt;
+		} else if (oldIt == unit->quads.cend() || *newIt < *oldIt) {
+			spring::VectorInsertUnique(baseQuads[*newIt].units, unit, false);
+			spring::VectorInsertUnique(baseQuads[*newIt].teamUnits[unit->allyteam], unit, false);
+			++newIt;
+		} else {
+			// present in both sets, leave the cell untouched
+			++oldIt;
+			++newIt;
+		}
 	}
 
-	for (const int qi: newQuads) {
-		spring::VectorInsertUnique(baseQuads[qi].units, unit, false);
-		spring::VectorInsertUnique(baseQuads[qi].teamUnits[unit->allyteam], unit, false);
+	unit->quads = std::move(newQuads);
+}
+
+void CQuadField::StampActivityCells(const CUnit* unit)
+{
+	if (activityStamps.empty())
+		return;
+
+	const int minX = Clamp(int((unit->pos.x - unit->radius) / BASE_QUAD_SIZE), 0, numActQuadsX - 1);
+	const int maxX = Clamp(int((unit->pos.x + unit->radius) / BASE_QUAD_SIZE), 0, numActQuadsX - 1);
+	const int minZ = Clamp(int((unit->pos.z - unit->radius) / BASE_QUAD_SIZE), 0, numActQuadsZ - 1);
+	const int maxZ = Clamp(int((unit->pos.z + unit->radius) / BASE_QUAD_SIZE), 0, numActQuadsZ - 1);
+
+	for (int z = minZ; z <= maxZ; z++) {
+		for (int x = minX; x <= maxX; x++) {
+			activityStamps[(z * numActQuadsX + x) * numActAllyTeams + unit->allyteam] = gs->frameNum;
+		}
 	}
+}
 
-	unit->quads = std::move(newQuads);
+bool CQuadField::HasEnemyActivitySince(const float3& pos, float radius, int allyTeam, int frame) const
+{
+	// no stamps means no information; never suppress the scan
+	if (activityStamps.empty())
+		return true;
+
+	const int minX = Clamp(int((pos.x - radius) / BASE_QUAD_SIZE), 0, numActQuadsX - 1);
+	const int maxX = Clamp(int((pos.x + radius) / BASE_QUAD_SIZE), 0, numActQuadsX - 1);
+	const int minZ = Clamp(int((pos.z - radius) / BASE_QUAD_SIZE), 0, numActQuadsZ - 1);
+	const int maxZ = Clamp(int((pos.z + radius) / BASE_QUAD_SIZE), 0, numActQuadsZ - 1);
+
+	for (int z = minZ; z <= maxZ; z++) {
+		for (int x = minX; x <= maxX; x++) {
+			const int* cellStamps = &activityStamps[(z * numActQuadsX + x) * numActAllyTeams];
+
+			for (int at = 0; at < numActAllyTeams; at++) {
+				if (teamHandler->Ally(allyTeam, at))
+					continue;
+				if (cellStamps[at] >= frame)
+					return true;
+			}
+		}
+	}
+
+	return false;
 }
 
 void CQuadField::RemoveUnit(CUnit* unit)
@@ -337,12 +541,25 @@ void CQuadField::MovedRepulser(CPlasmaRepulser* repulser)
 		}
 	}
 
-	for (const int qi: repulser->quads) {
-		spring::VectorErase(baseQuads[qi].repulsers, repulser);
-	}
-
-	for (const int qi: newQuads) {
-		spring::VectorInsertUnique(baseQuads[qi].repulsers, repulser, false);
+	// see MovedUnit; only touch the cells in the symmetric difference
+	assert(std::is_sorted(newQuads.begin(), newQuads.end()));
+	assert(std::is_sorted(repulser->quads.begin(), repulser->quads.end()));
+
+	auto oldIt = repulser->quads.cbegin();
+	auto newIt = newQuads.cbegin();
+
+	while (oldIt != repulser->quads.cend() || newIt != newQuads.cend()) {
+		if (newIt == newQuads.cend() || (oldIt != repulser->quads.cend() && *oldIt < *newIt)) {
+			spring::VectorErase(baseQuads[*oldIt].repulsers, repulser);
+			++oldIt;
+		} else if (oldIt == repulser->quads.cend() || *newIt < *oldIt) {
+			spring::VectorInsertUnique(baseQuads[*newIt].repulsers, repulser, false);
+			++newIt;
+		} else {
+			// present in both sets, leave the cell untouched
+			++oldIt;
+			++newIt;
+		}
 	}
 
 	repulser->quads = std::move(newQuads);
@@ -373,6 +590,10 @@ void CQuadField::AddFeature(CFeature* feature)
 	for (const int qi: newQuads) {
 		spring::VectorInsertUnique(baseQuads[qi].features, feature, false);
 	}
+
+	// single choke-point for spawns, deaths and moves; the ray-tracing
+	// acceleration structure only rebuilds lazily off this
+	featureBVH.SetDirty();
 }
 
 void CQuadField::RemoveFeature(CFeature* feature)
@@ -383,6 +604,8 @@ void CQuadField::RemoveFeature(CFeature* feature)
 		spring::VectorErase(baseQuads[qi].features, feature);
 	}
 
+	featureBVH.SetDirty();
+
 	#ifdef DEBUG_QUADFIELD
 	for (const Quad& q: baseQuads) {
 		for (CFeature* f: q.features) {
@@ -519,6 +742,32 @@ const std::vector<CUnit*>& CQuadField::GetUnitsExact(const float3& mins, const f
 	return tempUnits;
 }
 
+void CQuadField::GetUnitsExact(const float3& mins, const float3& maxs, std::vector<int>& quads, std::vector<CUnit*>& units) const
+{
+	GetQuadsRectangle(mins, maxs, quads);
+
+	const int tempNum = gs->GetTempNum();
+	units.clear();
+
+	for (const int qi: quads) {
+		for (CUnit* unit: baseQuads[qi].units) {
+
+			if (unit->tempNum == tempNum)
+				continue;
+
+			unit->tempNum = tempNum;
+
+			const float3& pos = unit->pos;
+			if (pos.x < mins.x || pos.x > maxs.x)
+				continue;
+			if (pos.z < mins.z || pos.z > maxs.z)
+				continue;
+
+			units.push_back(unit);
+		}
+	}
+}
+
 
 const std::vector<CFeature*>& CQuadField::GetFeaturesExact(const float3& pos, float radius, bool spherical)
 {
@@ -24,21 +24,33 @@ class CQuadField : spring::noncopyable
 
 public:
 
-/*
-needed to support dynamic resizing (not used yet)
-      in large games the average loading factor (number of objects per quad)
-      can grow too large to maintain amortized constant performance so more
-      quads are needed
-*/
-//	static void Resize(int quad_size);
-
 	CQuadField(int2 mapDims, int quad_size);
 	~CQuadField();
 
+	/**
+	 * Rebuilds the field at a new quad size and migrates all
+	 * registered objects; in large games the average loading factor
+	 * (number of objects per quad) can otherwise grow too large to
+	 * maintain amortized constant query performance. Expensive, so
+	 * Update rate-limits how often it may happen.
+	 */
+	void Resize(int quad_size);
+
+	/// called once per synced frame; halves the quad size whenever
+	/// the average occupancy crosses RESIZE_OCCUPANCY
+	void Update();
+
 	const std::vector<int>& GetQuads(float3 pos, float radius);
 	const std::vector<int>& GetQuadsRectangle(const float3& mins, const float3& maxs);
 	const std::vector<int>& GetQuadsOnRay(const float3& start, const float3& dir, float length);
 
+	// re-entrant variants of the above; overwrite a caller-provided
+	// (eg. thread-local) buffer instead of the shared temp vector so
+	// concurrent callers do not serialize on *this
+	void GetQuads(float3 pos, float radius, std::vector<int>& quads) const;
+	void GetQuadsRectangle(const float3& mins, const float3& maxs, std::vector<int>& quads) const;
+	void GetQuadsOnRay(const float3& start, const float3& dir, float length, std::vector<int>& quads) const;
+
 	void GetUnitsAndFeaturesColVol(
 		const float3& pos,
 		const float radius,
@@ -63,6 +75,12 @@ needed to support dynamic resizing (not used yet)
 	 * mins and maxs, which extends infinitely along the y-axis
 	 */
 	const std::vector<CUnit*>& GetUnitsExact(const float3& mins, const float3& maxs);
+	/**
+	 * Re-entrant variant of the rectangle query above; overwrites the
+	 * caller-provided buffers instead of the shared temp vectors, so
+	 * results survive nested queries (eg. issued from a Lua callback)
+	 */
+	void GetUnitsExact(const float3& mins, const float3& maxs, std::vector<int>& quads, std::vector<CUnit*>& units) const;
 	/**
 	 * Returns all features within @c radius of @c pos,
 	 * takes the 3D model radius of each feature into account,
@@ -95,6 +113,16 @@ needed to support dynamic resizing (not used yet)
 	void MovedUnit(CUnit* unit);
 	void RemoveUnit(CUnit* unit);
 
+	/**
+	 * Returns whether any unit not allied with @c allyTeam has changed
+	 * its quad set in a coarse cell overlapping the circle at @c pos
+	 * since @c frame. Lets idle target scans be skipped while nothing
+	 * moved nearby; callers must pair this with a slow fallback rescan
+	 * since enemies can also become targetable without moving (decloak,
+	 * LOS gained by a third unit, ...).
+	 */
+	bool HasEnemyActivitySince(const float3& pos, float radius, int allyTeam, int frame) const;
+
 	void AddFeature(CFeature* feature);
 	void RemoveFeature(CFeature* feature);
 
@@ -134,6 +162,10 @@ needed to support dynamic resizing (not used yet)
 	int GetQuadSizeZ() const { return quadSizeZ; }
 
 	const static unsigned int BASE_QUAD_SIZE =  128;
+	// never resize below this (lest the per-object quad lists explode)
+	const static int MIN_QUAD_SIZE = 32;
+	// average number of objects per quad tolerated before resizing
+	const static int RESIZE_OCCUPANCY = 8;
 
 private:
 	// optimized functions, somewhat less userfriendly
@@ -147,6 +179,8 @@ private:
 	int2 WorldPosToQuadField(const float3 p) const;
 	int WorldPosToQuadFieldIdx(const float3 p) const;
 
+	void StampActivityCells(const CUnit* unit);
+
 private:
 	std::vector<Quad> baseQuads;
 
@@ -157,11 +191,20 @@ private:
 	std::vector<CSolidObject*> tempSolids;
 	std::vector<int> tempQuads;
 
+	// per-allyteam frame stamps of the last quad-set change in each
+	// coarse cell; fixed BASE_QUAD_SIZE resolution so Resize() does
+	// not invalidate them, indexed [cell * numActAllyTeams + allyteam]
+	std::vector<int> activityStamps;
+
 	int numQuadsX;
 	int numQuadsZ;
 
 	int quadSizeX;
 	int quadSizeZ;
+
+	int numActQuadsX;
+	int numActQuadsZ;
+	int numActAllyTeams;
 };
 
 extern CQuadField* quadField;
@@ -18,11 +18,14 @@ using std::fclose;
 #include "Game/GameSetup.h"
 #include "Map/MapInfo.h"
 #include "Map/MetalMap.h"
+#include "System/FileSystem/ArchiveScanner.h"
 #include "System/FileSystem/DataDirsAccess.h"
 #include "System/FileSystem/FileQueryFlags.h"
 #include "System/FileSystem/FileSystem.h"
 #include "System/Log/ILog.h"
+#include "System/StringUtil.h"
 
+#include <algorithm>
 #include <stdexcept>
 
 static const float3 ERRORVECTOR(-1, 0, 0);
@@ -123,18 +126,22 @@ void CResourceMapAnalyzer::Init() {
 	squareRadius = xtractorRadius * xtractorRadius;
 	doubleSquareRadius = doubleRadius * doubleRadius;
 
-	rexArrayA.resize(totalCells);
-	rexArrayB.resize(totalCells);
-	// used for drawing the TGA, not really needed with a couple of changes
-	rexArrayC.resize(totalCells);
-
-	tempAverage.resize(totalCells);
-
 	// if there's no available load file, create one and save it
 	if (!LoadResourceMap()) {
 		GetResourcePoints();
 		SaveResourceMap();
 	}
+
+	// keep the spot list sorted by extraction worth (position breaks
+	// ties) so callback consumers see a stable best-first ordering
+	std::sort(vectoredSpots.begin(), vectoredSpots.end(), [](const float3& a, const float3& b) {
+		if (a.y != b.y)
+			return (a.y > b.y);
+		if (a.x != b.x)
+			return (a.x < b.x);
+
+		return (a.z < b.z);
+	});
 }
 
 float CResourceMapAnalyzer::GetAverageIncome() const {
@@ -143,6 +150,14 @@ float CResourceMapAnalyzer::GetAverageIncome() const {
 
 
 void CResourceMapAnalyzer::GetResourcePoints() {
+	// per-cell scratch buffers, several MB on 32x32 maps; extraction
+	// runs once per map (checksum) so they do not outlive this call
+	std::vector<unsigned char> rexArrayA(totalCells);
+	std::vector<unsigned char> rexArrayB(totalCells);
+	// used for drawing the TGA, not really needed with a couple of changes
+	std::vector<unsigned char> rexArrayC(totalCells);
+	std::vector<int> tempAverage(totalCells);
+
 	std::vector<int> xend(doubleRadius + 1);
 
 	for (int a = 0; a < doubleRadius + 1; a++) {
@@ -565,7 +580,12 @@ bool CResourceMapAnalyzer::LoadResourceMap() {
 std::string CResourceMapAnalyzer::GetCacheFileName() const {
 
 	const CResourceDescription* resource = resourceHandler->GetResource(resourceId);
-	std::string absFile = CACHE_BASE + gameSetup->mapName + resource->name;
+
+	// key on the content checksum; a map edited under the same name
+	// must not reuse stale spots
+	const unsigned int mapChecksum = archiveScanner->GetArchiveCompleteChecksum(gameSetup->mapName);
+
+	std::string absFile = CACHE_BASE + gameSetup->mapName + resource->name + IntToString(mapChecksum, ".%x");
 
 	return absFile;
 }
@@ -68,11 +68,6 @@ private:
 
 	float3 bufferSpot;
 
-	std::vector<unsigned char> rexArrayA;
-	std::vector<unsigned char> rexArrayB;
-	std::vector<unsigned char> rexArrayC;
-	std::vector<int> tempAverage;
-
 	std::vector<float3> vectoredSpots;
 };
 
@@ -3,10 +3,12 @@
 #ifndef SIMOBJECT_MEMPOOL_H
 #define SIMOBJECT_MEMPOOL_H
 
+#include <algorithm>
 #include <cassert>
 #include <cstring> // memset
 #include <array>
 #include <deque>
+#include <functional>
 #include <vector>
 
 #include "System/UnorderedMap.hpp"
@@ -74,6 +76,21 @@ public:
 	size_t alloc_size() const { return (pages.size() * page_size()); } // size of total number of pages added over the pool's lifetime
 	size_t freed_size() const { return (indcs.size() * page_size()); } // size of number of pages that were freed and are awaiting reuse
 
+	size_t num_total_pages() const { return (pages.size()); }
+	size_t num_live_pages() const { return (table.size()); }
+	size_t num_freed_pages() const { return (indcs.size()); }
+
+	// fraction of ever-grown pages sitting on the free list; high values
+	// mean live objects are scattered thinly over the whole page deque
+	float frag_ratio() const { return ((pages.empty())? 0.0f: (indcs.size() * 1.0f) / pages.size()); }
+
+	// sort the free list so the lowest page indices get recycled first
+	// (alloc pops from the back); LIFO death-order reuse would otherwise
+	// scatter new objects across all pages ever grown, costing iteration
+	// locality in long games -- live objects themselves can never move,
+	// raw pointers to them are held engine-wide
+	void defrag_free_pages() { std::sort(indcs.begin(), indcs.end(), std::greater<size_t>()); }
+
 	bool mapped(void* p) const { return (table.find(p) != table.end()); }
 	bool alloced(void* p) const { return ((curr_page_index < pages.size()) && (&pages[curr_page_index][0] == p)); }
 
@@ -166,6 +183,15 @@ public:
 	size_t total_size() const { return (num_pages() * page_size()); }
 	size_t base_offset(const void* p) const { return (reinterpret_cast<const uint8_t*>(p) - reinterpret_cast<const uint8_t*>(&pages[0][0])); }
 
+	size_t num_total_pages() const { return (used_page_count); }
+	size_t num_live_pages() const { return (used_page_count - free_page_count); }
+	size_t num_freed_pages() const { return (free_page_count); }
+
+	// see DynMemPool; high-water used_page_count stands in for page growth
+	float frag_ratio() const { return ((used_page_count == 0)? 0.0f: (free_page_count * 1.0f) / used_page_count); }
+
+	void defrag_free_pages() { std::sort(&indcs[0], &indcs[0] + free_page_count, std::greater<size_t>()); }
+
 	bool mapped(const void* p) const { return (((base_offset(p) / page_size()) < total_size()) && ((base_offset(p) % page_size()) == 0)); }
 	bool alloced(const void* p) const { return (&pages[curr_page_index][0] == p); }
 
@@ -8,6 +8,7 @@
 
 #include "Map/Ground.h"
 #include "Map/ReadMap.h"
+#include "Sim/Misc/GlobalConstants.h"
 #include "System/float3.h"
 #include "System/myMath.h"
 #include "System/TimeProfiler.h"
@@ -41,6 +42,20 @@ static float Interpolate(float x, float y, const int maxx, const int maxy, const
 }
 
 
+// tile-wise refreshing of the mesh after terrain deformation; kept
+// in sync with the blur constants in MakeSmoothMesh
+static const int SMOOTH_MESH_TILE_SIZE  = 32; // cells
+static const int SMOOTH_MESH_BLUR_RAD   =  3; // cells per pass
+static const int SMOOTH_MESH_BLUR_PASSES = 3;
+static const int SMOOTH_MESH_TILES_PER_FRAME = 2;
+
+// scratch buffers for RecomputeTile, sized on first use
+static std::vector<float> tileGround;
+static std::vector<float> tileColsMax;
+static std::vector<float> tileMeshBufA;
+static std::vector<float> tileMeshBufB;
+
+
 SmoothHeightMesh::SmoothHeightMesh(float mx, float my, float res, float smoothRad)
 	: maxx((mx / res) + 1)
 	, maxy((my / res) + 1)
@@ -48,7 +63,14 @@ SmoothHeightMesh::SmoothHeightMesh(float mx, float my, float res, float smoothRa
 	, fmaxy(my)
 	, resolution(res)
 	, smoothRadius(std::max(1.0f, smoothRad))
+	, tilesX((mx / res) / SMOOTH_MESH_TILE_SIZE + 1)
+	, tilesY((my / res) / SMOOTH_MESH_TILE_SIZE + 1)
+	, numDirtyTiles(0)
+	, tileScanPos(0)
 {
+	dirtyTiles.clear();
+	dirtyTiles.resize(tilesX * tilesY, 0);
+
 	MakeSmoothMesh();
 }
 
@@ -438,3 +460,187 @@ void SmoothHeightMesh::MakeSmoothMesh()
 	origMesh.resize(size);
 	std::copy(mesh.begin(), mesh.end(), origMesh.begin());
 }
+
+
+
+void SmoothHeightMesh::MapChanged(int x1, int y1, int x2, int y2)
+{
+	const int intrad = smoothRadius / resolution;
+	const int halo = intrad + (SMOOTH_MESH_BLUR_RAD * SMOOTH_MESH_BLUR_PASSES);
+
+	// heightmap squares to mesh cells (resolution is a multiple of SQUARE_SIZE)
+	const int scale = resolution / SQUARE_SIZE;
+
+	const int cx0 = Clamp((x1 / scale) - halo, 0, maxx);
+	const int cy0 = Clamp((y1 / scale) - halo, 0, maxy);
+	const int cx1 = Clamp((x2 / scale) + halo, 0, maxx);
+	const int cy1 = Clamp((y2 / scale) + halo, 0, maxy);
+
+	const int tx0 = cx0 / SMOOTH_MESH_TILE_SIZE, tx1 = std::min(cx1 / SMOOTH_MESH_TILE_SIZE, tilesX - 1);
+	const int ty0 = cy0 / SMOOTH_MESH_TILE_SIZE, ty1 = std::min(cy1 / SMOOTH_MESH_TILE_SIZE, tilesY - 1);
+
+	for (int ty = ty0; ty <= ty1; ++ty) {
+		for (int tx = tx0; tx <= tx1; ++tx) {
+			unsigned char& dirty = dirtyTiles[ty * tilesX + tx];
+
+			numDirtyTiles += (dirty == 0);
+			dirty = 1;
+		}
+	}
+}
+
+
+void SmoothHeightMesh::UpdateSmoothMesh()
+{
+	if (numDirtyTiles == 0)
+		return;
+
+	SCOPED_TIMER("Sim::SmoothHeightMesh");
+
+	const int numTiles = tilesX * tilesY;
+
+	// round-robin over the tile grid so no dirty region starves
+	for (int n = 0, budget = SMOOTH_MESH_TILES_PER_FRAME; n < numTiles && budget > 0; ++n) {
+		tileScanPos = (tileScanPos + 1 < numTiles)? tileScanPos + 1: 0;
+
+		if (dirtyTiles[tileScanPos] == 0)
+			continue;
+
+		dirtyTiles[tileScanPos] = 0;
+		numDirtyTiles -= 1;
+		budget -= 1;
+
+		RecomputeTile(tileScanPos % tilesX, tileScanPos / tilesX);
+	}
+}
+
+
+void SmoothHeightMesh::RecomputeTile(int tx, int ty)
+{
+	const int intrad = smoothRadius / resolution;
+	const int blurHalo = SMOOTH_MESH_BLUR_RAD * SMOOTH_MESH_BLUR_PASSES;
+
+	// cells whose refreshed values get committed back into the mesh;
+	// readers (Interpolate, Lua) index rows with a stride of <maxx>,
+	// so the last column and row are never committed
+	const int cx0 = tx * SMOOTH_MESH_TILE_SIZE;
+	const int cy0 = ty * SMOOTH_MESH_TILE_SIZE;
+	const int cx1 = std::min(cx0 + SMOOTH_MESH_TILE_SIZE - 1, maxx - 1);
+	const int cy1 = std::min(cy0 + SMOOTH_MESH_TILE_SIZE - 1, maxy - 1);
+
+	// region the blur passes run over; cells inside it but outside the
+	// committed rectangle absorb the window-clamping error at region
+	// edges and are never written back
+	const int mx0 = std::max(cx0 - blurHalo, 0), mx1 = std::min(cx1 + blurHalo, maxx);
+	const int my0 = std::max(cy0 - blurHalo, 0), my1 = std::min(cy1 + blurHalo, maxy);
+
+	// region of raw ground samples feeding the max-filter
+	const int gx0 = std::max(mx0 - intrad, 0), gx1 = std::min(mx1 + intrad, maxx);
+	const int gy0 = std::max(my0 - intrad, 0), gy1 = std::min(my1 + intrad, maxy);
+
+	const int gsx = gx1 - gx0 + 1, gsy = gy1 - gy0 + 1;
+	const int msx = mx1 - mx0 + 1, msy = my1 - my0 + 1;
+
+	tileGround.resize(gsx * gsy);
+	tileColsMax.resize(gsx * msy);
+	tileMeshBufA.resize(msx * msy);
+	tileMeshBufB.resize(msx * msy);
+
+	// sample the deformed ground once
+	for (int y = gy0; y <= gy1; ++y) {
+		for (int x = gx0; x <= gx1; ++x) {
+			tileGround[(y - gy0) * gsx + (x - gx0)] = CGround::GetHeightAboveWater(x * resolution, y * resolution);
+		}
+	}
+
+	// vertical max-filter pass, one column per task; the windows clamp
+	// to the g-region, which coincides with the map edges exactly where
+	// committed cells can see them
+	for_mt(0, gsx, [&](const int cx) {
+		for (int y = my0; y <= my1; ++y) {
+			const int wy0 = std::max(y - intrad, gy0);
+			const int wy1 = std::min(y + intrad, gy1);
+
+			float colMax = -std::numeric_limits<float>::max();
+
+			for (int y1 = wy0; y1 <= wy1; ++y1) {
+				colMax = std::max(colMax, tileGround[(y1 - gy0) * gsx + cx]);
+			}
+
+			tileColsMax[(y - my0) * gsx + cx] = colMax;
+		}
+	});
+
+	// horizontal max-filter pass
+	for (int y = my0; y <= my1; ++y) {
+		for (int x = mx0; x <= mx1; ++x) {
+			const int wx0 = std::max(x - intrad, gx0);
+			const int wx1 = std::min(x + intrad, gx1);
+
+			float rowMax = -std::numeric_limits<float>::max();
+
+			for (int x1 = wx0; x1 <= wx1; ++x1) {
+				rowMax = std::max(rowMax, tileColsMax[(y - my0) * gsx + (x1 - gx0)]);
+			}
+
+			tileMeshBufA[(y - my0) * msx + (x - mx0)] = rowMax;
+		}
+	}
+
+	// approximate Gaussian blur passes (cf. BlurHorizontal/BlurVertical);
+	// averaging over the clamped window reproduces both the interior and
+	// the map-border division of the full passes
+	const float curMaxHeight = readMap->GetCurrMaxHeight();
+
+	std::vector<float>* src = &tileMeshBufA;
+	std::vector<float>* dst = &tileMeshBufB;
+
+	for (int pass = 0; pass < SMOOTH_MESH_BLUR_PASSES; ++pass) {
+		for (int y = my0; y <= my1; ++y) {
+			for (int x = mx0; x <= mx1; ++x) {
+				const int wx0 = std::max(x - SMOOTH_MESH_BLUR_RAD, mx0);
+				const int wx1 = std::min(x + SMOOTH_MESH_BLUR_RAD, mx1);
+
+				float sum = 0.0f;
+
+				for (int x1 = wx0; x1 <= wx1; ++x1) {
+					sum += (*src)[(y - my0) * msx + (x1 - mx0)];
+				}
+
+				const float gh = tileGround[(y - gy0) * gsx + (x - gx0)];
+				const float sh = sum / (wx1 - wx0 + 1);
+
+				(*dst)[(y - my0) * msx + (x - mx0)] = std::min(curMaxHeight, std::max(gh, sh));
+			}
+		}
+
+		std::swap(src, dst);
+
+		for (int y = my0; y <= my1; ++y) {
+			for (int x = mx0; x <= mx1; ++x) {
+				const int wy0 = std::max(y - SMOOTH_MESH_BLUR_RAD, my0);
+				const int wy1 = std::min(y + SMOOTH_MESH_BLUR_RAD, my1);
+
+				float sum = 0.0f;
+
+				for (int y1 = wy0; y1 <= wy1; ++y1) {
+					sum += (*src)[(y1 - my0) * msx + (x - mx0)];
+				}
+
+				const float gh = tileGround[(y - gy0) * gsx + (x - gx0)];
+				const float sh = sum / (wy1 - wy0 + 1);
+
+				(*dst)[(y - my0) * msx + (x - mx0)] = std::min(curMaxHeight, std::max(gh, sh));
+			}
+		}
+
+		std::swap(src, dst);
+	}
+
+	// commit the inner rectangle using the reader stride
+	for (int y = cy0; y <= cy1; ++y) {
+		for (int x = cx0; x <= cx1; ++x) {
+			mesh[x + y * maxx] = (*src)[(y - my0) * msx + (x - mx0)];
+		}
+	}
+}
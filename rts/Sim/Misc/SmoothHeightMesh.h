@@ -31,16 +31,34 @@ public:
 	const float* GetMeshData() const { return &mesh[0]; }
 	const float* GetOriginalMeshData() const { return &origMesh[0]; }
 
+	/// marks every tile whose smoothed values can see the given
+	/// heightmap-square rectangle through the max-filter or blur
+	/// windows as dirty; called by BasicMapDamage on deformation
+	void MapChanged(int x1, int y1, int x2, int y2);
+
+	/// recomputes a budgeted number of dirty tiles per simframe so
+	/// large deformations are worked through over several frames
+	/// instead of spiking one; aircraft read slightly stale values
+	/// in the meantime
+	void UpdateSmoothMesh();
+
 private:
 	void MakeSmoothMesh();
+	void RecomputeTile(int tx, int ty);
 
 	const int maxx, maxy;
 	const float fmaxx, fmaxy;
 	const float resolution;
 	const float smoothRadius;
 
+	int tilesX, tilesY;
+	int numDirtyTiles;
+	int tileScanPos;
+
 	std::vector<float> mesh;
 	std::vector<float> origMesh;
+
+	std::vector<unsigned char> dirtyTiles;
 };
 
 extern SmoothHeightMesh* smoothGround;
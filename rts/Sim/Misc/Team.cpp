@@ -45,7 +45,10 @@ CR_REG_METADATA(CTeam, (
 	CR_MEMBER(resPrevReceived),
 	CR_MEMBER(resPrevExcess),
 	CR_MEMBER(nextHistoryEntry),
+	CR_MEMBER(statHistoryCount),
 	CR_MEMBER(statHistory),
+	CR_MEMBER(statSpillStaging),
+	CR_MEMBER(statSpill),
 	CR_MEMBER(modParams),
 	CR_IGNORED(highlight)
 ))
@@ -64,11 +67,26 @@ CTeam::CTeam():
 	resStorage(1000000, 1000000),
 	resShare(0.99f, 0.95f),
 	nextHistoryEntry(0),
+	statHistoryCount(0),
 	origColor(0, 0, 0, 0),
 	highlight(0.0f)
 {
-	statHistory.reserve(1024);
-	statHistory.push_back(TeamStatistics());
+	// fixed-size ring; slot 0 is the initial live entry
+	statHistory.resize(STAT_RING_SIZE);
+	statSpillStaging.reserve(STAT_SPILL_BATCH);
+}
+
+void CTeam::GetStatsHistory(std::vector<TeamStatistics>& out) const
+{
+	out.clear();
+	out.reserve(GetNumStatsEntries());
+
+	DecompressTeamStatistics(statSpill, out);
+	out.insert(out.end(), statSpillStaging.begin(), statSpillStaging.end());
+
+	for (int i = GetFirstStatsEntry(), n = GetNumStatsEntries(); i < n; i++) {
+		out.push_back(GetStatsEntry(i));
+	}
 }
 
 void CTeam::SetDefaultStartPos()
@@ -375,7 +393,24 @@ void CTeam::SlowUpdate()
 
 	if (nextHistoryEntry <= gs->frameNum) {
 		currentStats.frame = gs->frameNum;
-		statHistory.push_back(currentStats);
+
+		// advance the ring; if the slot the new live entry claims
+		// still holds the oldest committed entry, move that one to
+		// the spill staging area (and compress a batch once enough
+		// have piled up) before overwriting it
+		const int newSlot = (statHistoryCount + 1) % STAT_RING_SIZE;
+
+		if ((statHistoryCount + 1) >= STAT_RING_SIZE) {
+			statSpillStaging.push_back(statHistory[newSlot]);
+
+			if (statSpillStaging.size() >= STAT_SPILL_BATCH) {
+				CompressTeamStatistics(statSpillStaging.data(), statSpillStaging.size(), statSpill);
+				statSpillStaging.clear();
+			}
+		}
+
+		statHistory[newSlot] = currentStats;
+		statHistoryCount += 1;
 
 		nextHistoryEntry = gs->frameNum + (TeamStatistics::statsPeriod * GAME_SPEED);
 		GetCurrentStats().frame = nextHistoryEntry;
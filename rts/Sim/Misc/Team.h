@@ -3,6 +3,7 @@
 #ifndef TEAM_H
 #define TEAM_H
 
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <list>
@@ -47,8 +48,21 @@ public:
 	unsigned int GetMaxUnits() const { return maxUnits; }
 	bool AtUnitLimit() const { return (units.size() >= maxUnits); }
 
-	TeamStatistics& GetCurrentStats() { return statHistory.back(); }
-	const TeamStatistics& GetCurrentStats() const { return statHistory.back(); }
+	TeamStatistics& GetCurrentStats() { return statHistory[statHistoryCount % STAT_RING_SIZE]; }
+	const TeamStatistics& GetCurrentStats() const { return statHistory[statHistoryCount % STAT_RING_SIZE]; }
+
+	/// total number of statistics entries recorded so far (including
+	/// the live one), i.e. one past the highest valid entry index
+	int GetNumStatsEntries() const { return (statHistoryCount + 1); }
+	/// index of the oldest entry still held in the ring; anything
+	/// older has been compressed into statSpill
+	int GetFirstStatsEntry() const { return std::max(0, GetNumStatsEntries() - STAT_RING_SIZE); }
+	/// valid for indices in [GetFirstStatsEntry(), GetNumStatsEntries())
+	const TeamStatistics& GetStatsEntry(int i) const { return statHistory[i % STAT_RING_SIZE]; }
+
+	/// materializes the complete history (spill + ring); only meant
+	/// for the end-of-game paths (demo recorder, endgame graphs)
+	void GetStatsHistory(std::vector<TeamStatistics>& out) const;
 
 	CTeam& operator = (const TeamBase& base) {
 		TeamBase::operator = (base);
@@ -94,8 +108,18 @@ public:
 	SResourcePack resReceived, resPrevReceived;
 	SResourcePack resPrevExcess;
 
+	// statistics history is kept in a fixed ring so the periodic
+	// append never allocates and memory stays bounded in long games;
+	// entries falling out of the ring are batch-compressed into
+	// statSpill and only re-inflated by GetStatsHistory
+	static const int STAT_RING_SIZE = 256;
+	static const int STAT_SPILL_BATCH = 64;
+
 	int nextHistoryEntry;
+	int statHistoryCount;
 	std::vector<TeamStatistics> statHistory;
+	std::vector<TeamStatistics> statSpillStaging;
+	std::vector<std::uint8_t> statSpill;
 
 	/// mod controlled parameters
 	LuaRulesParams::Params  modParams;
@@ -4,6 +4,8 @@
 
 #include "System/Platform/byteorder.h"
 
+#include <zlib.h>
+
 
 CR_BIND(TeamStatistics, )
 CR_REG_METADATA(TeamStatistics, (
@@ -81,3 +83,67 @@ void TeamStatistics::swab()
 	swabDWordInPlace(unitsKilled);
 }
 
+
+
+// block layout: [uint32 numSamples][uint32 blockSize][blockSize bytes];
+// a blockSize equal to the raw sample size marks an uncompressed block
+// (the fallback when deflate cannot shrink the data)
+void CompressTeamStatistics(const TeamStatistics* samples, unsigned int count, std::vector<std::uint8_t>& spill)
+{
+	if (count == 0)
+		return;
+
+	const std::uint32_t rawSize = count * sizeof(TeamStatistics);
+
+	const size_t base = spill.size();
+	const size_t head = base + 2 * sizeof(std::uint32_t);
+
+	uLongf compSize = compressBound(rawSize);
+	spill.resize(head + compSize);
+
+	const int ret = compress2(&spill[head], &compSize, reinterpret_cast<const Bytef*>(samples), rawSize, Z_BEST_SPEED);
+
+	if (ret != Z_OK || compSize >= rawSize) {
+		compSize = rawSize;
+		spill.resize(head + rawSize);
+		std::memcpy(&spill[head], samples, rawSize);
+	} else {
+		spill.resize(head + compSize);
+	}
+
+	const std::uint32_t numSamples = count;
+	const std::uint32_t blockSize = compSize;
+
+	std::memcpy(&spill[base], &numSamples, sizeof(numSamples));
+	std::memcpy(&spill[base + sizeof(numSamples)], &blockSize, sizeof(blockSize));
+}
+
+void DecompressTeamStatistics(const std::vector<std::uint8_t>& spill, std::vector<TeamStatistics>& out)
+{
+	size_t pos = 0;
+
+	while ((pos + 2 * sizeof(std::uint32_t)) <= spill.size()) {
+		std::uint32_t numSamples = 0;
+		std::uint32_t blockSize = 0;
+
+		std::memcpy(&numSamples, &spill[pos], sizeof(numSamples));
+		std::memcpy(&blockSize, &spill[pos + sizeof(numSamples)], sizeof(blockSize));
+		pos += 2 * sizeof(std::uint32_t);
+
+		if ((pos + blockSize) > spill.size())
+			break;
+
+		const size_t base = out.size();
+		out.resize(base + numSamples);
+
+		uLongf rawSize = numSamples * sizeof(TeamStatistics);
+
+		if (blockSize == rawSize) {
+			std::memcpy(&out[base], &spill[pos], rawSize);
+		} else if (uncompress(reinterpret_cast<Bytef*>(&out[base]), &rawSize, &spill[pos], blockSize) != Z_OK) {
+			out.resize(base);
+		}
+
+		pos += blockSize;
+	}
+}
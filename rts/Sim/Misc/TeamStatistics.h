@@ -6,7 +6,9 @@
 #include "System/creg/creg_cond.h"
 #include "System/Platform/byteorder.h"
 
+#include <cstdint>
 #include <cstring>
+#include <vector>
 
 #pragma pack(push, 1)
 
@@ -46,4 +48,15 @@ struct TeamStatistics
 
 #pragma pack(pop)
 
+
+/**
+ * Deflate-compresses @c count samples and appends them to @c spill as a
+ * self-describing block; used by CTeam to keep the in-memory size of
+ * the per-team statistics history bounded in long games.
+ */
+void CompressTeamStatistics(const TeamStatistics* samples, unsigned int count, std::vector<std::uint8_t>& spill);
+
+/// Inflates every block previously appended by CompressTeamStatistics.
+void DecompressTeamStatistics(const std::vector<std::uint8_t>& spill, std::vector<TeamStatistics>& out);
+
 #endif
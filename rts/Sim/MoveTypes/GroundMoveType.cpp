@@ -66,6 +66,14 @@ LOG_REGISTER_SECTION_GLOBAL(LOG_SECTION_GMT)
 #define IGNORE_OBSTACLES                  0
 #define WAIT_FOR_PATH                     1
 
+// neighbor-set cache for HandleObjectCollisions; queries are padded by
+// SLACK elmos so their results stay usable for up to MAX_AGE frames:
+// half the slack covers the collider's own displacement (checked each
+// frame), the other half covers neighbors approaching at up to
+// (SLACK / 2) / MAX_AGE elmos per frame during the cache's lifetime
+#define COLL_QUERY_CACHE_SLACK   (SQUARE_SIZE * 4.0f)
+#define COLL_QUERY_CACHE_MAX_AGE          4
+
 #define UNIT_CMD_QUE_SIZE(u) (u->commandAI->commandQue.size())
 // Not using IsMoveCommand on purpose, as the following is changing the effective goalRadius
 #define UNIT_HAS_MOVE_CMD(u) (u->commandAI->commandQue.empty() || u->commandAI->commandQue[0].GetID() == CMD_MOVE || u->commandAI->commandQue[0].GetID() == CMD_FIGHT)
@@ -125,6 +133,12 @@ CR_REG_METADATA(CGroundMoveType, (
 
 	CR_MEMBER(nextObstacleAvoidanceFrame),
 
+	CR_MEMBER(nearUnitIDs),
+	CR_MEMBER(nearFeatureIDs),
+	CR_MEMBER(collQueryPos),
+	CR_MEMBER(collQueryRadius),
+	CR_MEMBER(collQueryFrame),
+
 	CR_MEMBER(reversing),
 	CR_MEMBER(idling),
 	CR_MEMBER(pushResistant),
@@ -215,6 +229,10 @@ CGroundMoveType::CGroundMoveType(CUnit* owner):
 
 	nextObstacleAvoidanceFrame(0),
 
+	collQueryPos(ZeroVector),
+	collQueryRadius(0.0f),
+	collQueryFrame(-1),
+
 	numIdlingUpdates(0),
 	numIdlingSlowUpdates(0),
 
@@ -1313,6 +1331,19 @@ unsigned int CGroundMoveType::GetNewPath()
 
 void CGroundMoveType::ReRequestPath(bool forceRequest) {
 	if (forceRequest) {
+		// collision detours set wantRepath; try to splice the unit
+		// back into its existing waypoint chain before paying for
+		// a full re-search (only valid while the goal is unchanged)
+		if (wantRepath && pathID != 0 && pathManager->RepairPath(owner, pathID, goalPos)) {
+			currWayPoint = pathManager->NextWayPoint(owner, pathID, 0,   owner->pos, 1.25f * SQUARE_SIZE, true);
+			nextWayPoint = pathManager->NextWayPoint(owner, pathID, 0, currWayPoint, 1.25f * SQUARE_SIZE, true);
+
+			pathController.SetTempGoalPosition(pathID, currWayPoint);
+
+			wantRepath = false;
+			return;
+		}
+
 		StopEngine(false);
 		StartEngine(false);
 		wantRepath = false;
@@ -1595,6 +1626,9 @@ void CGroundMoveType::HandleObjectCollisions()
 		const float colliderSpeed = collider->speed.w;
 		const float colliderRadius = FOOTPRINT_RADIUS(colliderMD->xsize, colliderMD->zsize, 0.75f);
 
+		// refresh the cached candidate sets only if they went stale
+		UpdateCollisionQueryCache(colliderSpeed + (colliderRadius * 2.0f));
+
 		HandleUnitCollisions(collider, colliderSpeed, colliderRadius, colliderUD, colliderMD);
 		HandleFeatureCollisions(collider, colliderSpeed, colliderRadius, colliderUD, colliderMD);
 
@@ -1611,6 +1645,35 @@ void CGroundMoveType::HandleObjectCollisions()
 	}
 }
 
+void CGroundMoveType::UpdateCollisionQueryCache(const float searchRadius)
+{
+	// neighbor sets change slowly, so most frames can reuse the result
+	// of an earlier padded QuadField query instead of running a new one
+	const bool cacheUsable =
+		((gs->frameNum - collQueryFrame) < COLL_QUERY_CACHE_MAX_AGE) &&
+		((searchRadius + COLL_QUERY_CACHE_SLACK) <= collQueryRadius) &&
+		(owner->pos.SqDistance(collQueryPos) < Square(COLL_QUERY_CACHE_SLACK * 0.5f));
+
+	if (cacheUsable)
+		return;
+
+	collQueryPos = owner->pos;
+	// pad with the speed headroom as well so acceleration does not
+	// outgrow the cached radius before the age limit forces a query
+	collQueryRadius = searchRadius + (maxSpeed - owner->speed.w) + COLL_QUERY_CACHE_SLACK;
+	collQueryFrame = gs->frameNum;
+
+	nearUnitIDs.clear();
+	nearFeatureIDs.clear();
+
+	for (const CUnit* u: quadField->GetUnitsExact(collQueryPos, collQueryRadius)) {
+		nearUnitIDs.push_back(u->id);
+	}
+	for (const CFeature* f: quadField->GetFeaturesExact(collQueryPos, collQueryRadius)) {
+		nearFeatureIDs.push_back(f->id);
+	}
+}
+
 void CGroundMoveType::HandleStaticObjectCollision(
 	CUnit* collider,
 	CSolidObject* collidee,
@@ -1803,15 +1866,23 @@ void CGroundMoveType::HandleUnitCollisions(
 ) {
 	const float searchRadius = colliderSpeed + (colliderRadius * 2.0f);
 
-	// copy on purpose, since the below can call Lua
-	const std::vector<CUnit*> nearUnits = quadField->GetUnitsExact(collider->pos, searchRadius);
-
 	// NOTE: probably too large for most units (eg. causes tree falling animations to be skipped)
 	const int dirSign = Sign(int(!reversing));
 	const float3 crushImpulse = collider->speed * collider->mass * dirSign;
 
-	for (CUnit* collidee: nearUnits) {
-		if (collidee == collider) continue;
+	// iterate the cached candidate set by id; entries have to be
+	// re-resolved and re-filtered since units can have died or moved
+	// out of range while the cache was alive, and the Lua called below
+	// can kill them in mid-loop
+	for (const int nearUnitID: nearUnitIDs) {
+		CUnit* collidee = unitHandler->GetUnitUnsafe(nearUnitID);
+
+		if (collidee == nullptr || collidee == collider)
+			continue;
+		// same instance-radius test an uncached GetUnitsExact would run
+		if (collider->pos.SqDistance(collidee->pos) >= Square(searchRadius + collidee->radius))
+			continue;
+
 		if (collidee->IsSkidding()) continue;
 		if (collidee->IsFlying()) continue;
 
@@ -2021,15 +2092,19 @@ void CGroundMoveType::HandleFeatureCollisions(
 ) {
 	const float searchRadius = colliderSpeed + (colliderRadius * 2.0f);
 
-	// copy on purpose, since DoDamage below can call Lua
-	const std::vector<CFeature*> nearFeatures = quadField->GetFeaturesExact(collider->pos, searchRadius);
-	      std::vector<CFeature*>::const_iterator fit;
-
 	const int dirSign = Sign(int(!reversing));
 	const float3 crushImpulse = collider->speed * collider->mass * dirSign;
 
-	for (fit = nearFeatures.begin(); fit != nearFeatures.end(); ++fit) {
-		CFeature* collidee = const_cast<CFeature*>(*fit);
+	// iterate the cached candidate set by id (cf. HandleUnitCollisions);
+	// re-resolved per entry since DoDamage below can call Lua
+	for (const int nearFeatureID: nearFeatureIDs) {
+		CFeature* collidee = featureHandler->GetFeature(nearFeatureID);
+
+		if (collidee == nullptr)
+			continue;
+		if (collider->pos.SqDistance(collidee->pos) >= Square(searchRadius + collidee->radius))
+			continue;
+
 		// const FeatureDef* collideeFD = collidee->def;
 
 		// use the collidee's Feature (not FeatureDef) footprint as radius
@@ -4,6 +4,7 @@
 #define GROUNDMOVETYPE_H
 
 #include <array>
+#include <vector>
 
 #include "MoveType.h"
 #include "Sim/Path/IPathController.hpp"
@@ -105,6 +106,7 @@ private:
 	void Fail(bool callScript);
 
 	void HandleObjectCollisions();
+	void UpdateCollisionQueryCache(const float searchRadius);
 	void HandleStaticObjectCollision(
 		CUnit* collider,
 		CSolidObject* collidee,
@@ -198,6 +200,16 @@ private:
 	unsigned int pathID;
 	unsigned int nextObstacleAvoidanceFrame;
 
+	/// cached QuadField candidates for HandleObjectCollisions, queried
+	/// with a padded radius so the sets stay valid for several frames;
+	/// stored as id's since objects can die while a cache is in use
+	std::vector<int> nearUnitIDs;
+	std::vector<int> nearFeatureIDs;
+
+	float3 collQueryPos;                /// position the collision cache was queried at
+	float collQueryRadius;              /// padded radius the collision cache was queried with
+	int collQueryFrame;                 /// frame the collision cache was queried on
+
 	unsigned int numIdlingUpdates;      /// {in, de}creased every Update if idling is true/false and pathId != 0
 	unsigned int numIdlingSlowUpdates;  /// {in, de}creased every SlowUpdate if idling is true/false and pathId != 0
 
@@ -118,6 +118,33 @@ CMoveMath::BlockType CMoveMath::IsBlockedNoSpeedModCheck(const MoveDef& moveDef,
 	BlockType ret = BLOCK_NONE;
 	const int xstep = 2, zstep = 2;
 
+	if (collider == nullptr && groundBlockingObjectMap->HasStructureBlockBits()) {
+		// collider-less query; the per-MoveDef structure bits match
+		// ObjectBlockType exactly for these, so the footprint test
+		// reduces to bit reads and any cell scan that remains only
+		// has to consider mobile objects
+		for (int z = zmin; z <= zmax; z += zstep) {
+			const int zOffset = z * mapDims.mapx;
+			for (int x = xmin; x <= xmax; x += xstep) {
+				if (groundBlockingObjectMap->SquareIsStructureBlocked(moveDef.pathType, zOffset + x))
+					return BLOCK_STRUCTURE;
+			}
+		}
+
+		for (int z = zmin; z <= zmax; z += zstep) {
+			const int zOffset = z * mapDims.mapx;
+			for (int x = xmin; x <= xmax; x += xstep) {
+				const BlockingMapCell& cell = groundBlockingObjectMap->GetCellUnsafeConst(zOffset + x);
+				for (const CSolidObject* collidee: cell) {
+					if (collidee->immobile)
+						continue;
+					ret |= ObjectBlockType(moveDef, collidee, nullptr);
+				}
+			}
+		}
+		return ret;
+	}
+
 	// (footprints are point-symmetric around <xSquare, zSquare>)
 	for (int z = zmin; z <= zmax; z += zstep) {
 		const int zOffset = z * mapDims.mapx;
@@ -61,6 +61,7 @@ IPathFinder::IPathFinder(unsigned int _BLOCK_SIZE)
 	, mGoalHeuristic(0.0f)
 	, maxBlocksToBeSearched(0)
 	, testedBlocks(0)
+	, sumTestedBlocks(0)
 	, instanceIndex(pathFinderInstances.size())
 {
 	pathFinderInstances.push_back(this);
@@ -134,24 +135,31 @@ IPath::SearchResult IPathFinder::GetPath(
 	mStartBlockIdx = BlockPosToIdx(mStartBlock);
 	assert((unsigned)mStartBlock.x < nbrOfBlocks.x && (unsigned)mStartBlock.y < nbrOfBlocks.y);
 
-	// check cache (when there is one)
+	// check cache (when there is one); multi-goal searches are keyed
+	// on just their primary goal-square so they must never touch it
 	const int2 goalBlock = {int(pfDef.goalSquareX / BLOCK_SIZE), int(pfDef.goalSquareZ / BLOCK_SIZE)};
-	const CPathCache::CacheItem& ci = GetCache(mStartBlock, goalBlock, pfDef.sqGoalRadius, moveDef.pathType, pfDef.synced);
 
-	if (ci.pathType != -1) {
-		path = ci.path;
-		return ci.result;
+	if (!pfDef.HasMultipleGoals()) {
+		const CPathCache::CacheItem& ci = GetCache(mStartBlock, goalBlock, pfDef.sqGoalRadius, moveDef.pathType, pfDef.synced);
+
+		if (ci.pathType != -1) {
+			path = ci.path;
+			return ci.result;
+		}
 	}
 
 	// start up a new search
 	IPath::SearchResult result = InitSearch(moveDef, pfDef, owner);
 
+	sumTestedBlocks += testedBlocks;
+
 	// if search was successful, generate new path
 	if (result == IPath::Ok || result == IPath::GoalOutOfRange) {
 		FinishSearch(moveDef, pfDef, path);
 
 		// save to cache
-		AddCache(&path, result, mStartBlock, goalBlock, pfDef.sqGoalRadius, moveDef.pathType, pfDef.synced);
+		if (!pfDef.HasMultipleGoals())
+			AddCache(&path, result, mStartBlock, goalBlock, pfDef.sqGoalRadius, moveDef.pathType, pfDef.synced);
 
 		if (LOG_IS_ENABLED(L_DEBUG)) {
 			LOG_L(L_DEBUG, "==== %s: Search completed ====", (BLOCK_SIZE != 1) ? "PE" : "PF");
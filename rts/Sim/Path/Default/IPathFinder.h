@@ -138,6 +138,8 @@ public:
 
 	unsigned int maxBlocksToBeSearched;
 	unsigned int testedBlocks;
+	// running total over all searches (never reset), used by PathReplayLog
+	unsigned int sumTestedBlocks;
 
 	unsigned int instanceIndex;
 
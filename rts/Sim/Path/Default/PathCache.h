@@ -59,6 +59,10 @@ private:
 		int pathType
 	) const;
 
+public:
+	std::uint32_t GetNumCacheHits() const { return numCacheHits; }
+	std::uint32_t GetNumCacheMisses() const { return numCacheMisses; }
+
 	float GetCacheHitPercentage() const {
 		if ((numCacheHits + numCacheMisses) == 0)
 			return 0.0f;
@@ -26,7 +26,27 @@ static const float MEDRES_SEARCH_DISTANCE_EXT = (MEDRES_SEARCH_DISTANCE * 0.4f)
 // how many recursive refinement attempts NextWayPoint should make
 static const unsigned int MAX_PATH_REFINEMENT_DEPTH = 4;
 
-static const unsigned int PATHESTIMATOR_VERSION = 83;
+// how many max-res waypoints ahead of its owner a path-repair
+// splice tries to rejoin the existing chain
+static const unsigned int PATH_REPAIR_REJOIN_WAYPOINTS = 8;
+
+// upper bound on the length (in squares) of the cost-homogeneous
+// runs the jump-point expansion mode of CPathFinder may skip over
+static const unsigned int PATHFINDER_MAX_JUMP_LENGTH = 32;
+
+// how many deferred path-requests the manager may drain per Update;
+// a fixed count (rather than a wallclock budget) keeps the drain in
+// lockstep on all clients
+static const unsigned int MAX_QUEUED_PATH_SEARCHES = 16;
+
+// shared-corridor bookkeeping for grouped move-orders; a synced
+// request may reuse the estimator-level path of an equal-goal
+// request made at most MAX_AGE frames earlier, instead of running
+// its own search
+static const unsigned int MAX_SHARED_CORRIDORS = 8;
+static const unsigned int SHARED_CORRIDOR_MAX_AGE = GAME_SPEED;
+
+static const unsigned int PATHESTIMATOR_VERSION = 84;
 
 static const unsigned int MEDRES_PE_BLOCKSIZE = 16;
 static const unsigned int LOWRES_PE_BLOCKSIZE = 32;
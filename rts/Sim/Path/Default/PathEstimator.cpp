@@ -2,7 +2,7 @@
 
 #include "System/Platform/Win/win32.h"
 
-#include "minizip/zip.h"
+#include <cstdio>
 
 #include "PathEstimator.h"
 #include "PathFinder.h"
@@ -20,8 +20,6 @@
 #include "System/Threading/ThreadPool.h" // for_mt
 #include "System/TimeProfiler.h"
 #include "System/Config/ConfigHandler.h"
-#include "System/FileSystem/Archives/IArchive.h"
-#include "System/FileSystem/ArchiveLoader.h"
 #include "System/FileSystem/DataDirsAccess.h"
 #include "System/FileSystem/FileSystem.h"
 #include "System/FileSystem/FileQueryFlags.h"
@@ -39,6 +37,24 @@ CONFIG(int, MaxPathCostsMemoryFootPrint).defaultValue(512).minimumValue(64).desc
 PCMemPool pcMemPool;
 PEMemPool peMemPool;
 
+// private pathfinders (one per ThreadPool worker) used by the threaded
+// dirty-block updates in Update, shared by the med-res and low-res
+// estimator instances
+static std::vector<CPathFinder*> updatePathFinders;
+
+
+// flat memory-mappable cache layout: header, then the per-pathtype
+// center-offset arrays, then the vertex-cost array
+struct PathCacheFileHeader {
+	std::uint32_t magic;
+	std::uint32_t hashCode;
+	std::uint32_t numPathTypes;
+	std::uint32_t numBlocks;
+	std::uint32_t numVertexCosts;
+};
+
+static const std::uint32_t PATHCACHE_MAGIC = 0x43505053; // "SPPC"
+
 
 static const std::string GetPathCacheDir() {
 	return (FileSystem::GetCacheDir() + "/paths/");
@@ -65,7 +81,7 @@ CPathEstimator::CPathEstimator(IPathFinder* pf, unsigned int BLOCK_SIZE, const s
 	, nextPathEstimator(nullptr)
 	, blockUpdatePenalty(0)
 {
-	vertexCosts.resize(moveDefHandler->GetNumMoveDefs() * blockStates.GetSize() * PATH_DIRECTION_VERTICES, PATHCOST_INFINITY);
+	numVertexCosts = moveDefHandler->GetNumMoveDefs() * blockStates.GetSize() * PATH_DIRECTION_VERTICES;
 	maxSpeedMods.resize(moveDefHandler->GetNumMoveDefs(), 0.001f);
 
 	CPathEstimator*  childPE = this;
@@ -122,6 +138,13 @@ CPathEstimator::CPathEstimator(IPathFinder* pf, unsigned int BLOCK_SIZE, const s
 
 CPathEstimator::~CPathEstimator()
 {
+	// freed by whichever estimator instance dies first
+	for (CPathFinder*& pf: updatePathFinders) {
+		pfMemPool.free(pf);
+	}
+
+	updatePathFinders.clear();
+
 	pcMemPool.free(pathCache[0]);
 	pcMemPool.free(pathCache[1]);
 }
@@ -148,6 +171,10 @@ void CPathEstimator::InitEstimator(const std::string& cacheFileName, const std::
 	InitBlocks();
 
 	if (!ReadFile(cacheFileName, mapName)) {
+		// no usable cache, compute the data into private storage
+		vertexCostsBuf.resize(numVertexCosts, PATHCOST_INFINITY);
+		vertexCosts = &vertexCostsBuf[0];
+
 		// start extra threads if applicable, but always keep the total
 		// memory-footprint made by CPathFinder instances within bounds
 		const unsigned int minMemFootPrint = sizeof(CPathFinder) + pathFinder->GetMemFootPrint();
@@ -200,15 +227,35 @@ void CPathEstimator::InitEstimator(const std::string& cacheFileName, const std::
 	// Calculate PreCached PathData Checksum
 	pathChecksum = CalcChecksum();
 
-	// switch to runtime wanted IPathFinder (maybe PF or PE)
+	// switch to the runtime update pathfinders; dirty-block vertices are
+	// recalculated by private CPathFinder instances (one per ThreadPool
+	// worker) so Update can drain many blocks concurrently, and thereby
+	// also stay consistent with the initial cache which is always built
+	// from CPathFinder searches
 	pfMemPool.free(pathFinders[0]);
-	pathFinders[0] = pathFinder;
+	InitUpdatePathFinders();
 
 	pathCache[0] = pcMemPool.alloc<CPathCache>(nbrOfBlocks.x, nbrOfBlocks.y);
 	pathCache[1] = pcMemPool.alloc<CPathCache>(nbrOfBlocks.x, nbrOfBlocks.y);
 }
 
 
+void CPathEstimator::InitUpdatePathFinders()
+{
+	const unsigned int numUpdateThreads = ThreadPool::GetNumThreads();
+
+	while (updatePathFinders.size() < numUpdateThreads) {
+		updatePathFinders.push_back(pfMemPool.alloc<CPathFinder>());
+	}
+
+	pathFinders.resize(numUpdateThreads);
+
+	for (unsigned int i = 0; i < numUpdateThreads; i++) {
+		pathFinders[i] = updatePathFinders[i];
+	}
+}
+
+
 void CPathEstimator::InitBlocks()
 {
 	blockStates.peNodeOffsets.resize(moveDefHandler->GetNumMoveDefs());
@@ -549,14 +596,19 @@ void CPathEstimator::Update()
 		});
 	}
 
-	// CalculateVertices (not threadsafe)
+	// CalculateVertices (threadsafe with per-worker pathfinders)
+	//
+	// each (block, movedef, direction) triple writes to a distinct
+	// vertexCosts slot and all workers search with identical private
+	// CPathFinder instances, so the result does not depend on which
+	// worker processes which block
 	{
 		SCOPED_TIMER("Sim::Path::Estimator::CalculateVertices");
-		for (unsigned int n = 0; n < consumedBlocks.size(); ++n) {
+		for_mt(0, consumedBlocks.size(), [&](const int n) {
 			// copy the next block in line
 			const SingleBlock sb = consumedBlocks[n];
-			CalculateVertices(*sb.moveDef, sb.blockPos);
-		}
+			CalculateVertices(*sb.moveDef, sb.blockPos, ThreadPool::GetThreadNum());
+		});
 	}
 }
 
@@ -670,7 +722,7 @@ bool CPathEstimator::TestBlock(
 	const unsigned int pathTypeBaseIdx = moveDef.pathType * blockStates.GetSize() * PATH_DIRECTION_VERTICES;
 	const unsigned int blockNumBaseIdx = parentOpenBlock->nodeNum * PATH_DIRECTION_VERTICES;
 	const unsigned int vertexIdx = pathTypeBaseIdx + blockNumBaseIdx + GetBlockVertexOffset(pathDir, nbrOfBlocks.x);
-	assert(vertexIdx < vertexCosts.size());
+	assert(vertexIdx < numVertexCosts);
 
 
 	if (vertexCosts[vertexIdx] >= PATHCOST_INFINITY) {
@@ -858,16 +910,17 @@ IPath::SearchResult CPathEstimator::FinishSearch(const MoveDef& moveDef, const C
 bool CPathEstimator::ReadFile(const std::string& baseFileName, const std::string& mapName)
 {
 	const std::string hashHexString = IntToString(fileHashCode, "%x");
-	const std::string cacheFileName = GetPathCacheDir() + mapName + "." + baseFileName + "-" + hashHexString + ".zip";
+	const std::string cacheFileName = GetPathCacheDir() + mapName + "." + baseFileName + "-" + hashHexString + ".bin";
 
 	LOG("[PathEstimator::%s] hash=%s file=\"%s\" (exists=%d)", __func__, hashHexString.c_str(), cacheFileName.c_str(), FileSystem::FileExists(cacheFileName));
 
 	if (!FileSystem::FileExists(cacheFileName))
 		return false;
 
-	std::unique_ptr<IArchive> upfile(archiveLoader.OpenArchive(dataDirsAccess.LocateFile(cacheFileName), "sdz"));
-
-	if (upfile == nullptr || !upfile->IsOpen()) {
+	// map copy-on-write; clean pages stay shared between all engine
+	// instances on this host, runtime vertex-cost updates only touch
+	// the private copies of this process
+	if (!cacheFileMap.Open(dataDirsAccess.LocateFile(cacheFileName), true)) {
 		FileSystem::Remove(cacheFileName);
 		return false;
 	}
@@ -876,49 +929,43 @@ bool CPathEstimator::ReadFile(const std::string& baseFileName, const std::string
 	sprintf(calcMsg, "Reading Estimate PathCosts [%d]", BLOCK_SIZE);
 	loadscreen->SetLoadMessage(calcMsg);
 
-	const unsigned fid = upfile->FindFile("pathinfo");
-	if (fid >= upfile->NumFiles()) {
-		FileSystem::Remove(cacheFileName);
-		return false;
-	}
-
-	// pointless; gets reassigned the output of CalcChecksum and CRC is not otherwise used
-	// pathChecksum = upfile->GetCrc32(fid);
+	const unsigned int numPathTypes = moveDefHandler->GetNumMoveDefs();
+	const unsigned int blockSize = blockStates.GetSize() * sizeof(short2);
 
-	std::vector<std::uint8_t> buffer;
+	const size_t wantedFileSize = sizeof(PathCacheFileHeader) + numPathTypes * blockSize + numVertexCosts * sizeof(float);
 
-	if (!upfile->GetFile(fid, buffer) || buffer.size() < 4) {
+	if (cacheFileMap.GetSize() < wantedFileSize) {
+		cacheFileMap.Close();
 		FileSystem::Remove(cacheFileName);
 		return false;
 	}
 
-	const unsigned int filehash = *(reinterpret_cast<unsigned int*>(&buffer[0]));
-	const unsigned int blockSize = blockStates.GetSize() * sizeof(short2);
-	unsigned int pos = sizeof(unsigned);
-
-	if (filehash != fileHashCode) {
+	std::uint8_t* fileData = cacheFileMap.GetData();
+	const PathCacheFileHeader* fileHeader = reinterpret_cast<const PathCacheFileHeader*>(fileData);
+
+	if (
+		fileHeader->magic          != PATHCACHE_MAGIC      ||
+		fileHeader->hashCode       != fileHashCode         ||
+		fileHeader->numPathTypes   != numPathTypes         ||
+		fileHeader->numBlocks      != blockStates.GetSize() ||
+		fileHeader->numVertexCosts != numVertexCosts
+	) {
+		cacheFileMap.Close();
 		FileSystem::Remove(cacheFileName);
 		return false;
 	}
 
-	if (buffer.size() < (pos + blockSize * moveDefHandler->GetNumMoveDefs())) {
-		FileSystem::Remove(cacheFileName);
-		return false;
-	}
+	unsigned int pos = sizeof(PathCacheFileHeader);
 
-	// read center-offset data
-	for (int pathType = 0; pathType < moveDefHandler->GetNumMoveDefs(); ++pathType) {
-		std::memcpy(&blockStates.peNodeOffsets[pathType][0], &buffer[pos], blockSize);
+	// copy the (small) center-offset arrays, these get rewritten by
+	// dirty-block updates at a high rate
+	for (unsigned int pathType = 0; pathType < numPathTypes; ++pathType) {
+		std::memcpy(&blockStates.peNodeOffsets[pathType][0], fileData + pos, blockSize);
 		pos += blockSize;
 	}
 
-	// read vertex-cost data
-	if (buffer.size() < pos + vertexCosts.size() * sizeof(float)) {
-		FileSystem::Remove(cacheFileName);
-		return false;
-	}
-
-	std::memcpy(&vertexCosts[0], &buffer[pos], vertexCosts.size() * sizeof(float));
+	// alias the bulky vertex-cost array straight from the mapping
+	vertexCosts = reinterpret_cast<float*>(fileData + pos);
 	return true;
 }
 
@@ -933,44 +980,34 @@ void CPathEstimator::WriteFile(const std::string& baseFileName, const std::strin
 		return;
 
 	const std::string hashHexString = IntToString(fileHashCode, "%x");
-	const std::string cacheFileName = GetPathCacheDir() + mapName + "." + baseFileName + "-" + hashHexString + ".zip";
+	const std::string cacheFileName = GetPathCacheDir() + mapName + "." + baseFileName + "-" + hashHexString + ".bin";
 
 	LOG("[PathEstimator::%s] hash=%s file=\"%s\" (exists=%d)", __func__, hashHexString.c_str(), cacheFileName.c_str(), FileSystem::FileExists(cacheFileName));
 
 	// open file for writing in a suitable location
-	zipFile file = zipOpen(dataDirsAccess.LocateFile(cacheFileName, FileQueryFlags::WRITE).c_str(), APPEND_STATUS_CREATE);
+	FILE* file = fopen(dataDirsAccess.LocateFile(cacheFileName, FileQueryFlags::WRITE).c_str(), "wb");
 
 	if (file == nullptr)
 		return;
 
-	zipOpenNewFileInZip(file, "pathinfo", nullptr, nullptr, 0, nullptr, 0, nullptr, Z_DEFLATED, Z_BEST_COMPRESSION);
+	PathCacheFileHeader fileHeader;
+	fileHeader.magic          = PATHCACHE_MAGIC;
+	fileHeader.hashCode       = fileHashCode;
+	fileHeader.numPathTypes   = moveDefHandler->GetNumMoveDefs();
+	fileHeader.numBlocks      = blockStates.GetSize();
+	fileHeader.numVertexCosts = numVertexCosts;
 
-	// write hash-code (NOTE: this also affects the CRC!)
-	zipWriteInFileInZip(file, (const void*) &fileHashCode, 4);
+	fwrite(&fileHeader, sizeof(fileHeader), 1, file);
 
 	// write center-offsets
 	for (int pathType = 0; pathType < moveDefHandler->GetNumMoveDefs(); ++pathType) {
-		zipWriteInFileInZip(file, (const void*) &blockStates.peNodeOffsets[pathType][0], blockStates.peNodeOffsets[pathType].size() * sizeof(short2));
+		fwrite(&blockStates.peNodeOffsets[pathType][0], sizeof(short2), blockStates.peNodeOffsets[pathType].size(), file);
 	}
 
 	// write vertex-costs
-	zipWriteInFileInZip(file, vertexCosts.data(), vertexCosts.size() * sizeof(float));
-
-	zipCloseFileInZip(file);
-	zipClose(file, nullptr);
-
-
-	// get the CRC over the written path data
-	std::unique_ptr<IArchive> upfile(archiveLoader.OpenArchive(dataDirsAccess.LocateFile(cacheFileName), "sdz"));
+	fwrite(vertexCosts, sizeof(float), numVertexCosts, file);
 
-	if (upfile == nullptr || !upfile->IsOpen()) {
-		FileSystem::Remove(cacheFileName);
-		return;
-	}
-
-	assert(upfile->FindFile("pathinfo") < upfile->NumFiles());
-	// pointless; gets reassigned the output of CalcChecksum and CRC is not otherwise used
-	// pathChecksum = upfile->GetCrc32(upfile->FindFile("pathinfo"));
+	fclose(file);
 }
 
 
@@ -984,7 +1021,8 @@ std::uint32_t CPathEstimator::CalcChecksum() const
 	std::array<   char,       sha512::SHA_LEN * 2 + 1> hexChars;
 	std::array<uint8_t,       sha512::SHA_LEN        > shaBytes;
 
-	std::vector<uint8_t> rawBytes;
+	sha512::stream_state shaState;
+	sha512::stream_init(shaState);
 	#endif
 
 	for (const auto& pathTypeOffsets: blockStates.peNodeOffsets) {
@@ -992,20 +1030,17 @@ std::uint32_t CPathEstimator::CalcChecksum() const
 		cs = HsiehHash(pathTypeOffsets.data(), nb, cs);
 
 		#if (ENABLE_NETLOG_CHECKSUM == 1)
-		rawBytes.resize(rawBytes.size() + nb, 0);
-		std::memcpy(&rawBytes[rawBytes.size() - nb], pathTypeOffsets.data(), nb);
+		sha512::stream_update(shaState, reinterpret_cast<const uint8_t*>(pathTypeOffsets.data()), nb);
 		#endif
 	}
 
-	nb = vertexCosts.size() * sizeof(float);
-	cs = HsiehHash(vertexCosts.data(), nb, cs);
+	nb = numVertexCosts * sizeof(float);
+	cs = HsiehHash(vertexCosts, nb, cs);
 
 	#if (ENABLE_NETLOG_CHECKSUM == 1)
 	{
-		rawBytes.resize(rawBytes.size() + nb);
-
-		std::memcpy(&rawBytes[rawBytes.size() - nb], vertexCosts.data(), nb);
-		sha512::calc_digest(rawBytes, shaBytes); // hash(offsets|costs)
+		sha512::stream_update(shaState, reinterpret_cast<const uint8_t*>(vertexCosts), nb);
+		sha512::stream_final(shaState, shaBytes.data()); // hash(offsets|costs)
 		sha512::dump_digest(shaBytes, hexChars); // hexify(hash)
 
 		SNPRINTF(msgChars.data(), msgChars.size(), "[PE::%s][BLK_SIZE=%d][SHA_DATA=%s]", __func__, BLOCK_SIZE, hexChars.data());
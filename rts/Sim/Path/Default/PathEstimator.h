@@ -13,6 +13,7 @@
 #include "IPathFinder.h"
 #include "PathConstants.h"
 #include "PathDataTypes.h"
+#include "System/FileSystem/MappedFile.h"
 #include "System/float3.h"
 #include "System/Threading/SpringThreading.h"
 
@@ -63,6 +64,8 @@ public:
 	 */
 	std::uint32_t GetPathChecksum() const { return pathChecksum; }
 
+	const CPathCache* GetPathCache(bool synced) const { return pathCache[synced]; }
+
 	static const int2* GetDirectionVectorsTable();
 
 protected: // IPathFinder impl
@@ -98,6 +101,7 @@ protected: // IPathFinder impl
 private:
 	void InitEstimator(const std::string& cacheFileName, const std::string& mapName);
 	void InitBlocks();
+	void InitUpdatePathFinders();
 
 	void CalcOffsetsAndPathCosts(unsigned int threadNum);
 	void CalculateBlockOffsets(unsigned int, unsigned int);
@@ -139,7 +143,16 @@ private:
 	CPathEstimator* nextPathEstimator;
 
 	std::vector<float> maxSpeedMods;
-	std::vector<float> vertexCosts;
+
+	// vertex-cost array; either backed by vertexCostsBuf (when the
+	// data had to be calculated) or aliased straight from the copy-
+	// on-write cache-file mapping
+	float* vertexCosts = nullptr;
+	unsigned int numVertexCosts = 0;
+
+	std::vector<float> vertexCostsBuf;
+	MappedFile cacheFileMap;
+
 	/// blocks that may need an update due to map changes
 	std::deque<int2> updatedBlocks;
 
@@ -179,6 +179,11 @@ void CPathFinder::TestNeighborSquares(
 		if (!CanTestSquareSM(dir))
 			continue;
 
+		// on uniform terrain, try to skip the whole homogeneous run
+		// in one jump rather than expanding it square-by-square
+		if (pfDef.useJumpPoints && CanTestSquareIS(dir) && TestBlockJump(moveDef, pfDef, square, owner, PathDir2PathOpt(dir), ngbStates[dir].speedMod))
+			continue;
+
 		TestBlock(moveDef, pfDef, square, owner, PathDir2PathOpt(dir), ngbStates[dir].blockMask, ngbStates[dir].speedMod);
 	}
 
@@ -222,6 +227,132 @@ void CPathFinder::TestNeighborSquares(
 	dirtyBlocks.push_back(square->nodeNum);
 }
 
+bool CPathFinder::TestBlockJump(
+	const MoveDef& moveDef,
+	const CPathFinderDef& pfDef,
+	const PathNode* parentSquare,
+	const CSolidObject* owner,
+	const unsigned int pathOptDir,
+	const float speedMod
+) {
+	const int2 dirVec2D = PF_DIRECTION_VECTORS_2D[pathOptDir];
+	const float3& dirVec3D = PF_DIRECTION_VECTORS_3D[pathOptDir];
+
+	// perpendicular to the (cardinal) jump direction
+	const int2 sideVec = int2(dirVec2D.y, dirVec2D.x);
+
+	// a square may only be skipped if entering, crossing and leaving
+	// it costs exactly what the first step of the run does, if it can
+	// never host a turn of an optimal path (no forced neighbors, not
+	// aligned with the goal) and if the search has no stake in it yet
+	const auto SquareIsJumpable = [&](const int2 sq) {
+		if (static_cast<unsigned>(sq.x) >= nbrOfBlocks.x || static_cast<unsigned>(sq.y) >= nbrOfBlocks.y)
+			return false;
+
+		if (blockStates.nodeMask[BlockPosToIdx(sq)] & (PATHOPT_OPEN | PATHOPT_CLOSED | PATHOPT_BLOCKED))
+			return false;
+		if (!pfDef.WithinConstraints(sq.x, sq.y))
+			return false;
+		if (pfDef.IsGoal(sq.x, sq.y))
+			return false;
+
+		// optimal paths turn on goal-aligned squares, keep those expandable
+		if (sq.x == int(pfDef.goalSquareX) || sq.y == int(pfDef.goalSquareZ))
+			return false;
+		if (std::abs(sq.x - int(pfDef.goalSquareX)) == std::abs(sq.y - int(pfDef.goalSquareZ)))
+			return false;
+
+		if (blockCheckFunc(moveDef, sq.x, sq.y, owner) & (CMoveMath::BLOCK_STRUCTURE | squareMobileBlockBits))
+			return false;
+		if (CMoveMath::GetPosSpeedMod(moveDef, sq.x, sq.y, dirVec3D) != speedMod)
+			return false;
+
+		if (pfDef.testMobile && (PathHeatMap::GetInstance())->GetHeatCost(sq.x, sq.y, moveDef, ((owner != NULL)? owner->id: -1U)) != 0.0f)
+			return false;
+		if (blockStates.GetNodeExtraCost(sq.x, sq.y, pfDef.synced) != 0.0f)
+			return false;
+
+		// no forced neighbors: both side squares must stay passable
+		for (const int side: {1, -1}) {
+			const int2 ssq = int2(sq.x + side * sideVec.x, sq.y + side * sideVec.y);
+
+			if (static_cast<unsigned>(ssq.x) >= nbrOfBlocks.x || static_cast<unsigned>(ssq.y) >= nbrOfBlocks.y)
+				return false;
+			if (CMoveMath::GetPosSpeedMod(moveDef, ssq.x, ssq.y) == 0.0f)
+				return false;
+			if (blockCheckFunc(moveDef, ssq.x, ssq.y, owner) & CMoveMath::BLOCK_STRUCTURE)
+				return false;
+		}
+
+		return true;
+	};
+
+	int2 square = parentSquare->nodePos;
+	unsigned int numJumped = 0;
+
+	while (numJumped < PATHFINDER_MAX_JUMP_LENGTH && SquareIsJumpable(square + dirVec2D)) {
+		square += dirVec2D;
+		numJumped += 1;
+	}
+
+	if (numJumped == 0)
+		return false;
+
+	// the landing square gets the normal open-list treatment; bail
+	// out (and expand square-by-square) if it can not be entered
+	const int2 landingSquare = square + dirVec2D;
+
+	if (static_cast<unsigned>(landingSquare.x) >= nbrOfBlocks.x || static_cast<unsigned>(landingSquare.y) >= nbrOfBlocks.y)
+		return false;
+	if (blockStates.nodeMask[BlockPosToIdx(landingSquare)] & (PATHOPT_CLOSED | PATHOPT_BLOCKED))
+		return false;
+
+	const CMoveMath::BlockType blockStatus = blockCheckFunc(moveDef, landingSquare.x, landingSquare.y, owner);
+
+	if (blockStatus & CMoveMath::BLOCK_STRUCTURE)
+		return false;
+
+	const float landingSpeedMod = CMoveMath::GetPosSpeedMod(moveDef, landingSquare.x, landingSquare.y, dirVec3D);
+
+	if (landingSpeedMod == 0.0f)
+		return false;
+
+	// commit; close the skipped run with its travel direction so the
+	// backtrack in FinishSearch can walk straight through it
+	int2 sq = parentSquare->nodePos;
+
+	for (unsigned int n = 0; n < numJumped; n++) {
+		sq += dirVec2D;
+
+		const unsigned int sqIdx = BlockPosToIdx(sq);
+
+		blockStates.nodeMask[sqIdx] |= (PATHOPT_CLOSED | pathOptDir);
+		dirtyBlocks.push_back(sqIdx);
+
+		// keep closest-square tracking exact across skipped squares
+		if (!pfDef.exactPath) {
+			const float hCost = pfDef.Heuristic(sq.x, sq.y, BLOCK_SIZE);
+
+			if (hCost < mGoalHeuristic) {
+				mGoalBlockIdx = sqIdx;
+				mGoalHeuristic = hCost;
+			}
+		}
+	}
+
+	// every skipped square costs exactly as much as the first step
+	PathNode jumpParent;
+	jumpParent.fCost = 0.0f;
+	jumpParent.gCost = parentSquare->gCost + numJumped * (PF_DIRECTION_COSTS[pathOptDir] / speedMod);
+	jumpParent.nodePos.x = square.x;
+	jumpParent.nodePos.y = square.y;
+	jumpParent.nodeNum = BlockPosToIdx(square);
+
+	TestBlock(moveDef, pfDef, &jumpParent, owner, pathOptDir, blockStatus, landingSpeedMod);
+	return true;
+}
+
+
 bool CPathFinder::TestBlock(
 	const MoveDef& moveDef,
 	const CPathFinderDef& pfDef,
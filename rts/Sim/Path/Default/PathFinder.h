@@ -45,6 +45,22 @@ protected: // IPathFinder impl
 		const unsigned int blockStatus,
 		float speedMod
 	);
+
+	/**
+	 * Jump-point style expansion along a cardinal direction: skips
+	 * over runs of cost-homogeneous open squares and only queues the
+	 * square terminating the run. Returns false when nothing could
+	 * be skipped; the caller then expands the neighbor normally.
+	 */
+	bool TestBlockJump(
+		const MoveDef& moveDef,
+		const CPathFinderDef& pfDef,
+		const PathNode* parentSquare,
+		const CSolidObject* owner,
+		const unsigned int pathOptDir,
+		const float speedMod
+	);
+
 	/**
 	 * Recreates the path found by pathfinder.
 	 * Starting at goalSquare and tracking backwards.
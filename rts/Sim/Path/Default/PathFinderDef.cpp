@@ -22,7 +22,10 @@ CPathFinderDef::CPathFinderDef(const float3& goalCenter, float goalRadius, float
 // keep PF and PE in sync
 , exactPath(false)
 , dirIndependent(false)
+, useJumpPoints(false)
 , synced(true)
+, goalPositions(nullptr)
+, reachedGoalIdx(-1)
 {
 	goalSquareX = goalCenter.x / SQUARE_SIZE;
 	goalSquareZ = goalCenter.z / SQUARE_SIZE;
@@ -34,7 +37,20 @@ CPathFinderDef::CPathFinderDef(const float3& goalCenter, float goalRadius, float
 
 // returns true when the goal is within our defined range
 bool CPathFinderDef::IsGoal(unsigned int xSquare, unsigned int zSquare) const {
-	return (SquareToFloat3(xSquare, zSquare).SqDistance2D(goal) <= sqGoalRadius);
+	const float3 sqrPos = SquareToFloat3(xSquare, zSquare);
+
+	if (goalPositions != nullptr) {
+		for (unsigned int i = 0; i < goalPositions->size(); i++) {
+			if (sqrPos.SqDistance2D((*goalPositions)[i]) <= sqGoalRadius) {
+				reachedGoalIdx = i;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	return (sqrPos.SqDistance2D(goal) <= sqGoalRadius);
 }
 
 // returns distance to goal center in heightmap-squares
@@ -42,6 +58,12 @@ float CPathFinderDef::Heuristic(unsigned int xSquare, unsigned int zSquare, unsi
 {
 	(void) blockSize;
 
+	// with multiple goals there is no single target to estimate
+	// against; fall back to a uniform-cost (Dijkstra) expansion
+	// which reaches the cheapest member first
+	if (goalPositions != nullptr)
+		return 0.0f;
+
 	const float dx = std::abs(int(xSquare) - int(goalSquareX));
 	const float dz = std::abs(int(zSquare) - int(goalSquareZ));
 
@@ -3,6 +3,8 @@
 #ifndef PATHFINDERDEF_HDR
 #define PATHFINDERDEF_HDR
 
+#include <vector>
+
 #include "Sim/MoveTypes/MoveMath/MoveMath.h"
 #include "System/float3.h"
 #include "System/type2.h"
@@ -25,6 +27,12 @@ public:
 	bool IsGoalBlocked(const MoveDef& moveDef, const CMoveMath::BlockType& blockMask, const CSolidObject* owner) const;
 	int2 GoalSquareOffset(unsigned int blockSize) const;
 
+	// turns this into a multi-goal definition; the search terminates
+	// on (and IsGoal records the index of) whichever member of goals
+	// is expanded first
+	void SetGoalPositions(const std::vector<float3>* goals) { goalPositions = goals; reachedGoalIdx = -1; }
+	bool HasMultipleGoals() const { return (goalPositions != nullptr); }
+
 public:
 	// world-space goal position
 	float3 goal;
@@ -39,10 +47,18 @@ public:
 	bool needPath;
 	bool exactPath;
 	bool dirIndependent;
+	// if true, the max-res finder may skip over runs of squares
+	// with uniform cost in single jumps (estimators ignore this)
+	bool useJumpPoints;
 	bool synced;
 
 	unsigned int goalSquareX;
 	unsigned int goalSquareZ;
+
+	// extra world-space goal positions (not owned, may be null)
+	const std::vector<float3>* goalPositions;
+	// which member of goalPositions (if any) the search reached
+	mutable int reachedGoalIdx;
 };
 
 
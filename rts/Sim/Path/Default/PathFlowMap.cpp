@@ -50,9 +50,11 @@ PathFlowMap::PathFlowMap(unsigned int scalex, unsigned int scalez) {
 	maxFlow[fBufferIdx] = 0.0f;
 	maxFlow[bBufferIdx] = 0.0f;
 
-	buffers[fBufferIdx].resize(xsize * zsize, FlowCell());
-	buffers[bBufferIdx].resize(xsize * zsize, FlowCell());
-
+	// NOTE:
+	//   all flow-mapping logic below is currently disabled, so the
+	//   full-map cell buffers would only ever hold their centers;
+	//   skip allocating them (several MB on large maps) until it is
+	//   resurrected
 	pathOptDirs.resize(PATH_DIRECTIONS << 1);
 
 	pathOptDirs[PATHOPT_LEFT                ] =  RgtVector;
@@ -63,15 +65,6 @@ PathFlowMap::PathFlowMap(unsigned int scalex, unsigned int scalez) {
 	pathOptDirs[PATHOPT_RIGHT | PATHOPT_UP  ] = (pathOptDirs[PATHOPT_RIGHT] + pathOptDirs[PATHOPT_UP  ]) * s;
 	pathOptDirs[PATHOPT_RIGHT | PATHOPT_DOWN] = (pathOptDirs[PATHOPT_RIGHT] + pathOptDirs[PATHOPT_DOWN]) * s;
 	pathOptDirs[PATHOPT_LEFT  | PATHOPT_DOWN] = (pathOptDirs[PATHOPT_LEFT ] + pathOptDirs[PATHOPT_DOWN]) * s;
-
-	for (unsigned int n = 0; n < xsize * zsize; n++) {
-		const unsigned int x = n % xsize;
-		const unsigned int z = n / xsize;
-		const float3 p = float3((x * xfact) + (xfact >> 1), 0.0f, (z * zfact) + (zfact >> 1));
-
-		buffers[fBufferIdx][n].cellCenter = p;
-		buffers[bBufferIdx][n].cellCenter = p;
-	}
 }
 
 PathFlowMap::~PathFlowMap() {
@@ -4,9 +4,11 @@
 #include "PathConstants.h"
 #include "PathManager.h"
 #include "Sim/Misc/GlobalSynced.h"
+#include "Sim/Misc/ModInfo.h"
 #include "Sim/Misc/SimObjectMemPool.h"
 #include "Sim/MoveTypes/MoveDefHandler.h"
 #include "Sim/Objects/SolidObject.h"
+#include "System/myMath.h"
 
 // not extern'ed, so static
 static StaticMemPool<1, sizeof(PathHeatMap)> phmMemPool;
@@ -16,7 +18,7 @@ static PathHeatMap* gPathHeatMap = nullptr;
 
 PathHeatMap* PathHeatMap::GetInstance() {
 	if (gPathHeatMap == nullptr)
-		gPathHeatMap = phmMemPool.alloc<PathHeatMap>(PATH_HEATMAP_XSCALE, PATH_HEATMAP_ZSCALE);
+		gPathHeatMap = phmMemPool.alloc<PathHeatMap>(PATH_HEATMAP_XSCALE + (modInfo.pfHeatMapResolution - 1), PATH_HEATMAP_ZSCALE + (modInfo.pfHeatMapResolution - 1));
 
 	return gPathHeatMap;
 }
@@ -28,14 +30,16 @@ void PathHeatMap::FreeInstance(PathHeatMap* phm) {
 
 
 
-PathHeatMap::PathHeatMap(unsigned int scalex, unsigned int scalez): enabled(true) {
-	xscale = std::max(1, std::min(mapDims.hmapx, int(scalex)));
-	zscale = std::max(1, std::min(mapDims.hmapy, int(scalez)));
-	xsize  = mapDims.hmapx / xscale;
-	zsize  = mapDims.hmapy / zscale;
+PathHeatMap::PathHeatMap(unsigned int scalex, unsigned int scalez): enabled(modInfo.pfHeatMapping) {
+	// scales are power-of-two shifts wrt. mapDims.mapi coords (GetHeatMapIndex)
+	xscale = Clamp(int(scalex), 1, 16);
+	zscale = Clamp(int(scalez), 1, 16);
+	xsize  = std::max(1, mapDims.mapx >> xscale);
+	zsize  = std::max(1, mapDims.mapy >> zscale);
 
 	heatMap.resize(xsize * zsize, HeatCell());
 	heatMapOffset = 0;
+	heatMapDecay = modInfo.pfHeatMapDecayRate;
 }
 
 PathHeatMap::~PathHeatMap() {
@@ -53,6 +57,8 @@ unsigned int PathHeatMap::GetHeatMapIndex(unsigned int hmx, unsigned int hmz) co
 }
 
 void PathHeatMap::AddHeat(const CSolidObject* owner, const CPathManager* pm, unsigned int pathID) {
+	if (!enabled)
+		return;
 	if (pathID == 0)
 		return;
 	if (!owner->moveDef->heatMapping)
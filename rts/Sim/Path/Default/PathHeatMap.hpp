@@ -22,7 +22,7 @@ public:
 	PathHeatMap(unsigned int sizex, unsigned int sizez);
 	~PathHeatMap();
 
-	void Update() { ++heatMapOffset; }
+	void Update() { heatMapOffset += heatMapDecay; }
 
 
 	unsigned int GetHeatMapIndex(unsigned int x, unsigned int y) const;
@@ -57,6 +57,7 @@ private:
 	unsigned int zscale, zsize;
 
 	unsigned int heatMapOffset;      // heatmap values are relative to this
+	unsigned int heatMapDecay;       // offset step per Update (modrules)
 };
 
 #endif
@@ -9,7 +9,9 @@
 #include "PathHeatMap.hpp"
 #include "PathLog.h"
 #include "PathMemPool.h"
+#include "Sim/Path/PathReplayLog.h"
 #include "Map/MapInfo.h"
+#include "Sim/Misc/GlobalSynced.h"
 #include "Sim/Objects/SolidObjectDef.h"
 #include "Sim/MoveTypes/MoveDefHandler.h"
 #include "System/Log/ILog.h"
@@ -26,6 +28,10 @@ CPathManager::CPathManager()
 , pathFlowMap(nullptr)
 , pathHeatMap(nullptr)
 , nextPathID(0)
+, numPathRequests(0)
+, numExecutedSearches(0)
+, numCorridorHits(0)
+, searchTimeMilliSecs(0.0f)
 {
 	IPathFinder::InitStatic();
 	CPathFinder::InitStatic();
@@ -116,7 +122,8 @@ IPath::SearchResult CPathManager::ArrangePath(
 	const MoveDef* moveDef,
 	const float3& startPos,
 	const float3& goalPos,
-	CSolidObject* caller
+	CSolidObject* caller,
+	bool allowMaxRes
 ) const {
 	CPathFinderDef* pfDef = &newPath->peDef;
 
@@ -158,6 +165,10 @@ IPath::SearchResult CPathManager::ArrangePath(
 		// with constraints disabled for all three since these break search
 		// completeness (CPU usage is still limited by MAX_SEARCHED_NODES_*)
 		for (int n = PATH_MAX_RES; n >= PATH_LOW_RES; n--) {
+			// deferred requests get an estimator-only interim path
+			// first, the max-res search runs when they are drained
+			if (n == PATH_MAX_RES && !allowMaxRes)
+				continue;
 
 			// distance-limits are in ascending order
 			if (heurGoalDist2D > searchDistances[n])
@@ -335,6 +346,8 @@ unsigned int CPathManager::RequestPath(
 	startPos.ClampInBounds();
 	goalPos.ClampInBounds();
 
+	PathReplayLog::RecordSearch(moveDef->pathType, startPos, goalPos, goalRadius);
+
 	// Create an estimator definition.
 	goalRadius = std::max<float>(goalRadius, PATH_NODE_SPACING * SQUARE_SIZE); //FIXME do on a per PE & PF level?
 	assert(moveDef == moveDefHandler->GetMoveDefByPathType(moveDef->pathType));
@@ -343,11 +356,48 @@ unsigned int CPathManager::RequestPath(
 	newPath.finalGoal = goalPos;
 	newPath.caller = caller;
 	newPath.peDef.synced = synced;
+	newPath.peDef.useJumpPoints = true;
 
 	if (caller != nullptr)
 		caller->UnBlock();
 
-	const IPath::SearchResult result = ArrangePath(&newPath, moveDef, startPos, goalPos, caller);
+	// requests from synced owners are only given a cheap estimator-level
+	// interim path now; their full-resolution search is queued and drained
+	// by Update so a wave of simultaneous move-orders can not stall this
+	// frame (callerless requests, eg. from Lua, expect a complete result
+	// on return and are always arranged synchronously)
+	bool deferSearch = (synced && caller != nullptr);
+
+	IPath::SearchResult result = IPath::Error;
+
+	numPathRequests += 1;
+
+	if (deferSearch && AttachToSharedCorridor(&newPath, moveDef, startPos)) {
+		// grouped move-order; reuse the corridor searched for by an
+		// earlier member, only the max-res refinement runs per unit
+		deferSearch = false;
+		result = IPath::Ok;
+
+		numCorridorHits += 1;
+	} else {
+		const spring_time searchStartTime = spring_gettime();
+
+		result = ArrangePath(&newPath, moveDef, startPos, goalPos, caller, !deferSearch);
+
+		// if the estimators can not see a path (eg. start and goal inside the
+		// same block), run the full search at once rather than failing a goal
+		// the fine-resolution search might still reach
+		if (deferSearch && result == IPath::Error) {
+			deferSearch = false;
+			result = ArrangePath(&newPath, moveDef, startPos, goalPos, caller, true);
+		}
+
+		if (deferSearch && result != IPath::Error)
+			RegisterSharedCorridor(&newPath, moveDef);
+
+		numExecutedSearches += 1;
+		searchTimeMilliSecs += (spring_gettime() - searchStartTime).toMilliSecsf();
+	}
 
 	unsigned int pathID = 0;
 
@@ -372,6 +422,9 @@ unsigned int CPathManager::RequestPath(
 		FinalizePath(&newPath, startPos, goalPos, result == IPath::CantGetCloser);
 		newPath.searchResult = result;
 		pathID = Store(newPath);
+
+		if (deferSearch)
+			pathRequestQueue.push_back(pathID);
 	}
 
 	if (caller != nullptr)
@@ -381,6 +434,53 @@ unsigned int CPathManager::RequestPath(
 }
 
 
+int CPathManager::GetCheapestGoalPosition(
+	CSolidObject* caller,
+	const MoveDef* moveDef,
+	float3 startPos,
+	const std::vector<float3>& goalPositions,
+	float goalRadius,
+	bool synced
+) {
+	if (!IsFinalized())
+		return -1;
+	if (goalPositions.empty())
+		return -1;
+	if (goalPositions.size() == 1)
+		return 0;
+
+	SCOPED_TIMER("Misc::Path::GetCheapestGoalPosition");
+	startPos.ClampInBounds();
+
+	goalRadius = std::max<float>(goalRadius, PATH_NODE_SPACING * SQUARE_SIZE);
+	assert(moveDef == moveDefHandler->GetMoveDefByPathType(moveDef->pathType));
+
+	// the circular constraint assumes a single goal position, so the
+	// multi-goal expansion has to run unconstrained; it also uses a
+	// zero heuristic (plain Dijkstra) which guarantees the candidate
+	// reached first is the cheapest one
+	CCircularSearchConstraint pfDef(startPos, goalPositions[0], goalRadius, 0.0f, 0);
+	pfDef.DisableConstraint(true);
+	pfDef.SetGoalPositions(&goalPositions);
+	pfDef.needPath = false;
+	pfDef.synced = synced;
+
+	if (caller != nullptr)
+		caller->UnBlock();
+
+	IPath::Path path;
+	const IPath::SearchResult result = medResPE->GetPath(*moveDef, pfDef, caller, startPos, path, MAX_SEARCHED_NODES_PE >> 3);
+
+	if (caller != nullptr)
+		caller->Block();
+
+	if (result == IPath::Ok || result == IPath::CantGetCloser)
+		return pfDef.reachedGoalIdx;
+
+	return -1;
+}
+
+
 // converts part of a med-res path into a max-res path
 void CPathManager::MedRes2MaxRes(MultiPath& multiPath, const float3& startPos, const CSolidObject* owner, bool synced) const
 {
@@ -409,6 +509,7 @@ void CPathManager::MedRes2MaxRes(MultiPath& multiPath, const float3& startPos, c
 	// define the search
 	CCircularSearchConstraint rangedGoalDef(startPos, goalPos, 0.0f, 2.0f, Square(MAXRES_SEARCH_DISTANCE));
 	rangedGoalDef.synced = synced;
+	rangedGoalDef.useJumpPoints = true;
 
 	// Perform the search.
 	// If this is the final improvement of the path, then use the original goal.
@@ -421,6 +522,80 @@ void CPathManager::MedRes2MaxRes(MultiPath& multiPath, const float3& startPos, c
 	}
 }
 
+
+// re-searches only the segment between the owner's current position
+// and a rejoin point a few waypoints down the existing max-res path,
+// keeping the still-valid tail; much cheaper than a full repath when
+// a collision detour pushed the owner off its waypoint chain
+bool CPathManager::RepairPath(CSolidObject* owner, unsigned int pathID, float3 goalPos)
+{
+	if (!IsFinalized())
+		return false;
+	if (owner == nullptr)
+		return false;
+
+	SCOPED_TIMER("Misc::Path::RepairPath");
+
+	MultiPath* multiPath = GetMultiPath(pathID);
+
+	if (multiPath == nullptr)
+		return false;
+
+	// splices only apply if the owner still wants its old goal
+	if (multiPath->finalGoal.SqDistance2D(goalPos) > Square(SQUARE_SIZE))
+		return false;
+
+	IPath::Path& maxResPath = multiPath->maxResPath;
+
+	// need enough of the chain left to be worth splicing into;
+	// let the caller run a full request otherwise
+	if (maxResPath.path.size() <= (PATH_REPAIR_REJOIN_WAYPOINTS + 1))
+		return false;
+	if (maxResPath.path.size() != maxResPath.squares.size())
+		return false;
+
+	// waypoints are stored in reverse order; the rejoin point sits
+	// a few waypoints further down the chain than the one the owner
+	// was pushed away from
+	const unsigned int rejoinIdx = maxResPath.path.size() - 1 - PATH_REPAIR_REJOIN_WAYPOINTS;
+	const float3 rejoinPos = maxResPath.path[rejoinIdx];
+
+	float3 startPos = owner->pos;
+	startPos.ClampInBounds();
+
+	// detours are local; if the owner ended up further away than
+	// this, the old chain is unlikely to still be worth keeping
+	if (startPos.SqDistance2D(rejoinPos) > Square(MAXRES_SEARCH_DISTANCE * SQUARE_SIZE))
+		return false;
+
+	CCircularSearchConstraint rangedGoalDef(startPos, rejoinPos, 0.0f, 2.0f, Square(MAXRES_SEARCH_DISTANCE));
+	rangedGoalDef.synced = multiPath->peDef.synced;
+	rangedGoalDef.useJumpPoints = true;
+
+	owner->UnBlock();
+
+	IPath::Path splicePath;
+	const IPath::SearchResult result = maxResPF->GetPath(*multiPath->moveDef, rangedGoalDef, owner, startPos, splicePath, MAX_SEARCHED_NODES_ON_REFINE);
+
+	owner->Block();
+
+	if (result != IPath::Ok)
+		return false;
+	if (splicePath.path.empty())
+		return false;
+
+	// drop the detoured prefix and graft the repaired segment onto
+	// the remaining tail; splicePath also runs rejoin-first, so it
+	// appends in the right order
+	maxResPath.path.resize(rejoinIdx + 1);
+	maxResPath.squares.resize(rejoinIdx + 1);
+
+	maxResPath.path.insert(maxResPath.path.end(), splicePath.path.begin(), splicePath.path.end());
+	maxResPath.squares.insert(maxResPath.squares.end(), splicePath.squares.begin(), splicePath.squares.end());
+
+	return true;
+}
+
 // converts part of a low-res path into a med-res path
 void CPathManager::LowRes2MedRes(MultiPath& multiPath, const float3& startPos, const CSolidObject* owner, bool synced) const
 {
@@ -586,6 +761,178 @@ void CPathManager::Update()
 
 	medResPE->Update();
 	lowResPE->Update();
+
+	PruneSharedCorridors();
+	ExecuteQueuedSearches();
+}
+
+
+// drain a fixed number of deferred full-resolution searches; the
+// count-based (rather than wallclock) budget keeps all clients in
+// lockstep
+void CPathManager::ExecuteQueuedSearches()
+{
+	for (unsigned int n = 0; (n < MAX_QUEUED_PATH_SEARCHES && !pathRequestQueue.empty()); n++) {
+		const unsigned int pathID = pathRequestQueue.front();
+		pathRequestQueue.pop_front();
+
+		MultiPath* multiPath = GetMultiPath(pathID);
+
+		// path may have been deleted while it sat in the queue
+		if (multiPath == nullptr)
+			continue;
+
+		ExecuteSearch(multiPath);
+	}
+}
+
+
+// tries to substitute a shared corridor for the estimator searches of
+// a grouped move-order member; the corridor segment between the goal
+// and the waypoint closest to startPos becomes this path's med-res
+// path, from which the usual on-demand max-res refinement proceeds
+bool CPathManager::AttachToSharedCorridor(MultiPath* multiPath, const MoveDef* moveDef, const float3& startPos) const
+{
+	for (const SharedCorridor& c: sharedCorridors) {
+		if (c.pathType != moveDef->pathType)
+			continue;
+		if (c.sqGoalRadius != multiPath->peDef.sqGoalRadius)
+			continue;
+		if (c.goalPos.SqDistance2D(multiPath->finalGoal) > Square(SQUARE_SIZE))
+			continue;
+
+		// waypoints are stored in reverse order (goal comes first)
+		const IPath::path_list_type& points = c.medResPath.path;
+
+		int bestIdx = -1;
+		float bestDistSq = Square(MEDRES_SEARCH_DISTANCE * SQUARE_SIZE);
+
+		for (unsigned int n = 0; n < points.size(); n++) {
+			const float distSq = points[n].SqDistance2D(startPos);
+
+			if (distSq < bestDistSq) {
+				bestDistSq = distSq;
+				bestIdx = n;
+			}
+		}
+
+		// corridor passes nowhere near this member, let it search
+		if (bestIdx < 0)
+			continue;
+
+		multiPath->medResPath.path.assign(points.begin(), points.begin() + bestIdx + 1);
+		multiPath->medResPath.squares.assign(c.medResPath.squares.begin(), c.medResPath.squares.begin() + bestIdx + 1);
+		multiPath->medResPath.desiredGoal = c.medResPath.desiredGoal;
+		multiPath->medResPath.pathGoal = c.medResPath.pathGoal;
+		multiPath->medResPath.goalRadius = c.medResPath.goalRadius;
+		multiPath->medResPath.pathCost = c.medResPath.pathCost;
+
+		multiPath->searchResult = IPath::Ok;
+		return true;
+	}
+
+	return false;
+}
+
+void CPathManager::RegisterSharedCorridor(const MultiPath* multiPath, const MoveDef* moveDef)
+{
+	if (multiPath->medResPath.path.empty())
+		return;
+	if (multiPath->medResPath.path.size() != multiPath->medResPath.squares.size())
+		return;
+
+	if (sharedCorridors.size() >= MAX_SHARED_CORRIDORS)
+		sharedCorridors.erase(sharedCorridors.begin());
+
+	sharedCorridors.emplace_back();
+	SharedCorridor& c = sharedCorridors.back();
+
+	c.pathType = moveDef->pathType;
+	c.sqGoalRadius = multiPath->peDef.sqGoalRadius;
+	c.goalPos = multiPath->finalGoal;
+	c.createdFrame = gs->frameNum;
+	c.lowResPath = multiPath->lowResPath;
+	c.medResPath = multiPath->medResPath;
+}
+
+void CPathManager::PruneSharedCorridors()
+{
+	// corridors only live for as long as a single grouped move-order
+	// plausibly keeps generating requests
+	for (size_t n = 0; n < sharedCorridors.size(); ) {
+		if ((gs->frameNum - sharedCorridors[n].createdFrame) > SHARED_CORRIDOR_MAX_AGE) {
+			sharedCorridors[n] = std::move(sharedCorridors.back());
+			sharedCorridors.pop_back();
+		} else {
+			n++;
+		}
+	}
+}
+
+// run the full multi-resolution search for a deferred request,
+// replacing its estimator-level interim path
+void CPathManager::ExecuteSearch(MultiPath* multiPath)
+{
+	CSolidObject* caller = multiPath->caller;
+
+	// the owner will have moved along its interim path since the
+	// request was made, so re-anchor the search at its current
+	// position
+	const float3 startPos = (caller != nullptr)? caller->pos : multiPath->start;
+	const float3& goalPos = multiPath->finalGoal;
+
+	const bool synced = multiPath->peDef.synced;
+
+	multiPath->peDef = CCircularSearchConstraint(startPos, goalPos, math::sqrt(multiPath->peDef.sqGoalRadius), 3.0f, 2000);
+	multiPath->peDef.synced = synced;
+	multiPath->peDef.useJumpPoints = true;
+
+	if (caller != nullptr)
+		caller->UnBlock();
+
+	const spring_time searchStartTime = spring_gettime();
+	const IPath::SearchResult result = ArrangePath(multiPath, multiPath->moveDef, startPos, goalPos, caller, true);
+
+	numExecutedSearches += 1;
+	searchTimeMilliSecs += (spring_gettime() - searchStartTime).toMilliSecsf();
+
+	if (result != IPath::Error) {
+		if (multiPath->maxResPath.path.empty()) {
+			if (result != IPath::CantGetCloser) {
+				LowRes2MedRes(*multiPath, startPos, caller, synced);
+				MedRes2MaxRes(*multiPath, startPos, caller, synced);
+			} else {
+				multiPath->maxResPath.path.push_back(startPos);
+				multiPath->maxResPath.squares.push_back(int2(startPos.x / SQUARE_SIZE, startPos.z / SQUARE_SIZE));
+			}
+		}
+
+		FinalizePath(multiPath, startPos, goalPos, result == IPath::CantGetCloser);
+		multiPath->searchResult = result;
+	}
+
+	// flag the path even if the full search failed; owners keep
+	// following the interim path until their own ETA checks kick
+	// in and force a regular repath
+	multiPath->updated = true;
+
+	if (caller != nullptr)
+		caller->Block();
+}
+
+// returns whether a deferred search finished for this path since
+// the last query; owners react by re-pulling their waypoints
+bool CPathManager::PathUpdated(unsigned int pathID)
+{
+	MultiPath* multiPath = GetMultiPath(pathID);
+
+	if (multiPath == nullptr)
+		return false;
+	if (!multiPath->updated)
+		return false;
+
+	multiPath->updated = false;
+	return true;
 }
 
 // used to deposit heat on the heat-map as a unit moves along its path
@@ -745,6 +1092,30 @@ const float* CPathManager::GetNodeExtraCosts(bool synced) const {
 	return costs;
 }
 
+IPathManager::PathStats CPathManager::GetPathStats() const {
+	PathStats stats;
+
+	stats.numPathRequests = numPathRequests;
+	stats.numQueuedSearches = pathRequestQueue.size();
+	stats.numExecutedSearches = numExecutedSearches;
+	stats.numLivePaths = pathMap.size();
+
+	// corridor attaches are the manager-level equivalent of a
+	// cache hit; the estimators track their block-cache behavior
+	stats.numCacheHits = numCorridorHits;
+	stats.searchTimeMilliSecs = searchTimeMilliSecs;
+
+	if (IsFinalized()) {
+		const CPathCache* medResCache = medResPE->GetPathCache(true);
+		const CPathCache* lowResCache = lowResPE->GetPathCache(true);
+
+		stats.numCacheHits += (medResCache->GetNumCacheHits() + lowResCache->GetNumCacheHits());
+		stats.numCacheMisses = (medResCache->GetNumCacheMisses() + lowResCache->GetNumCacheMisses());
+	}
+
+	return stats;
+}
+
 int2 CPathManager::GetNumQueuedUpdates() const {
 	int2 data;
 
@@ -4,6 +4,7 @@
 #define PATHMANAGER_H
 
 #include <cinttypes>
+#include <deque>
 
 #include "Sim/Path/IPathManager.h"
 #include "IPath.h"
@@ -26,10 +27,15 @@ public:
 	unsigned int GetPathFinderType() const override { return PFS_TYPE_DEFAULT; }
 	std::uint32_t GetPathCheckSum() const override;
 
+	const CPathFinder* GetMaxResPF() const { return maxResPF; }
+	const CPathEstimator* GetMedResPE() const { return medResPE; }
+	const CPathEstimator* GetLowResPE() const { return lowResPE; }
+
 	std::int64_t Finalize() override;
 
 	void Update() override;
 	void UpdatePath(const CSolidObject*, unsigned int) override;
+	bool PathUpdated(unsigned int pathID) override;
 	void DeletePath(unsigned int pathID) override {
 		if (pathID == 0)
 			return;
@@ -61,6 +67,17 @@ public:
 		bool synced
 	) override;
 
+	bool RepairPath(CSolidObject* owner, unsigned int pathID, float3 goalPos) override;
+
+	int GetCheapestGoalPosition(
+		CSolidObject* caller,
+		const MoveDef* moveDef,
+		float3 startPos,
+		const std::vector<float3>& goalPositions,
+		float goalRadius,
+		bool synced
+	) override;
+
 	/**
 	 * Returns waypoints of the max-resolution path segments.
 	 * @param pathID
@@ -90,16 +107,18 @@ public:
 	const float* GetNodeExtraCosts(bool) const override;
 
 	int2 GetNumQueuedUpdates() const override;
+	PathStats GetPathStats() const override;
 
 private:
 	struct MultiPath {
-		MultiPath(): moveDef(nullptr), caller(nullptr) {}
+		MultiPath(): moveDef(nullptr), caller(nullptr), updated(false) {}
 		MultiPath(const MoveDef* moveDef, const float3& startPos, const float3& goalPos, float goalRadius)
 			: searchResult(IPath::Error)
 			, start(startPos)
 			, peDef(startPos, goalPos, goalRadius, 3.0f, 2000)
 			, moveDef(moveDef)
 			, caller(nullptr)
+			, updated(false)
 		{}
 
 		MultiPath(const MultiPath& mp) = delete;
@@ -119,6 +138,7 @@ private:
 			peDef   = mp.peDef;
 			moveDef = mp.moveDef;
 			caller  = mp.caller;
+			updated = mp.updated;
 
 			mp.moveDef = nullptr;
 			mp.caller  = nullptr;
@@ -142,6 +162,25 @@ private:
 
 		// additional information
 		CSolidObject* caller;
+
+		// set when a deferred search finished for this path;
+		// consumed by PathUpdated so owners re-pull waypoints
+		bool updated;
+	};
+
+	// estimator-level path shared between the members of a grouped
+	// move-order; the first requester pays for the search, later
+	// equal-goal requesters just attach to the corridor
+	struct SharedCorridor {
+		unsigned int pathType;
+
+		float sqGoalRadius;
+		float3 goalPos;
+
+		int createdFrame;
+
+		IPath::Path lowResPath;
+		IPath::Path medResPath;
 	};
 
 private:
@@ -150,9 +189,17 @@ private:
 		const MoveDef* moveDef,
 		const float3& startPos,
 		const float3& goalPos,
-		CSolidObject* caller
+		CSolidObject* caller,
+		bool allowMaxRes
 	) const;
 
+	void ExecuteSearch(MultiPath* multiPath);
+	void ExecuteQueuedSearches();
+
+	bool AttachToSharedCorridor(MultiPath* multiPath, const MoveDef* moveDef, const float3& startPos) const;
+	void RegisterSharedCorridor(const MultiPath* multiPath, const MoveDef* moveDef);
+	void PruneSharedCorridors();
+
 	MultiPath* GetMultiPath(int pathID) { return (const_cast<MultiPath*>(GetMultiPathConst(pathID))); }
 
 	const MultiPath* GetMultiPathConst(int pathID) const {
@@ -185,7 +232,20 @@ private:
 
 	spring::unordered_map<unsigned int, MultiPath> pathMap;
 
+	// deferred full-resolution searches, drained by Update;
+	// stale entries (deleted paths) are skipped during drain
+	std::deque<unsigned int> pathRequestQueue;
+
+	// most recent grouped-order corridors, pruned by age in Update
+	std::vector<SharedCorridor> sharedCorridors;
+
 	unsigned int nextPathID;
+
+	// telemetry, see IPathManager::PathStats
+	unsigned int numPathRequests;
+	unsigned int numExecutedSearches;
+	unsigned int numCorridorHits;
+	float searchTimeMilliSecs;
 };
 
 #endif
@@ -15,6 +15,22 @@ class CSolidObject;
 
 class IPathManager {
 public:
+	/**
+	 * Aggregated runtime statistics for the active backend; counters
+	 * are cumulative since game start so consumers (debug overlay,
+	 * Spring.GetPathStats) can derive per-frame rates by differencing.
+	 * Updating them must stay cheap enough for release builds.
+	 */
+	struct PathStats {
+		unsigned int numPathRequests = 0;    // total RequestPath calls
+		unsigned int numQueuedSearches = 0;  // searches currently pending execution
+		unsigned int numExecutedSearches = 0; // searches actually run
+		unsigned int numLivePaths = 0;       // paths currently held by the manager
+		unsigned int numCacheHits = 0;       // requests served without a full search
+		unsigned int numCacheMisses = 0;
+		float searchTimeMilliSecs = 0.0f;    // wall-time spent inside searches
+	};
+
 	static IPathManager* GetInstance(unsigned int type);
 	static void FreeInstance(IPathManager*);
 
@@ -23,6 +39,8 @@ public:
 	virtual unsigned int GetPathFinderType() const = 0;
 	virtual std::uint32_t GetPathCheckSum() const = 0;
 
+	virtual PathStats GetPathStats() const { return PathStats(); }
+
 	virtual std::int64_t Finalize() = 0;
 
 	/**
@@ -138,6 +156,52 @@ public:
 		bool synced
 	) = 0;
 
+	/**
+	 * Attempts to repair the path with the given ID in-place after
+	 * its owner was pushed off the waypoint chain (eg. by collision
+	 * detours), re-searching only the segment between the owner's
+	 * current position and a rejoin point further down the chain.
+	 *
+	 * @param goalPos
+	 *     The goal the owner currently wants to reach; repairs only
+	 *     apply when this still matches the goal the path was made
+	 *     for.
+	 * @return
+	 *     true if the path was repaired (the caller should re-pull
+	 *     its waypoints), false if a full re-request is needed
+	 */
+	virtual bool RepairPath(CSolidObject* owner, unsigned int pathID, float3 goalPos) { return false; }
+
+	/**
+	 * Determines which member of goalPositions is cheapest to reach
+	 * from startPos, using a single multi-goal search instead of one
+	 * search per candidate. No path is generated.
+	 *
+	 * @param moveDef
+	 *     Defines the move details of the unit that wants to reach a goal.
+	 * @param startPos
+	 *     The position the candidates are evaluated from.
+	 * @param goalPositions
+	 *     The candidate goal positions; any square within goalRadius of
+	 *     one of them terminates the search.
+	 * @param goalRadius
+	 *     The acceptance radius around each candidate.
+	 * @param caller
+	 *     The unit the result will be used for, or NULL.
+	 * @return
+	 *     an index into goalPositions, or -1 if no candidate is
+	 *     reachable (also the default when a PFS implementation
+	 *     does not support multi-goal searches)
+	 */
+	virtual int GetCheapestGoalPosition(
+		CSolidObject* caller,
+		const MoveDef* moveDef,
+		float3 startPos,
+		const std::vector<float3>& goalPositions,
+		float goalRadius,
+		bool synced
+	) { return -1; }
+
 	/**
 	 * Whenever there are any changes in the terrain
 	 * (examples: explosions, new buildings, etc.)
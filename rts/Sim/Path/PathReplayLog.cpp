@@ -0,0 +1,193 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <cstdio>
+#include <vector>
+
+#include "PathReplayLog.h"
+#include "IPathManager.h"
+#include "Default/PathEstimator.h"
+#include "Default/PathFinder.h"
+#include "Default/PathManager.h"
+#include "Sim/Misc/GlobalSynced.h"
+#include "Sim/MoveTypes/MoveDefHandler.h"
+#include "System/Config/ConfigHandler.h"
+#include "System/Log/ILog.h"
+#include "System/Misc/SpringTime.h"
+
+CONFIG(bool, PathReplayLogRecord).defaultValue(false).description("Append every path request to path-replay.log in the write-dir, for later replay-benchmarking.");
+CONFIG(bool, PathReplayLogReplay).defaultValue(false).description("Replay path-replay.log against the PFS right after it is finalized and log search statistics. Local benchmarking only.");
+
+static const char* PATH_REPLAY_LOG_FILE = "path-replay.log";
+// bumped whenever LogEntry changes layout
+static const unsigned int PATH_REPLAY_LOG_MAGIC = 0x50524C30; // "PRL0"
+
+struct LogEntry {
+	int frame;
+	unsigned int pathType;
+
+	float startPos[3];
+	float goalPos[3];
+	float goalRadius;
+};
+
+static FILE* recordFile = nullptr;
+
+static bool recordingTested = false;
+static bool recordingWanted = false;
+static bool replayRunning = false;
+
+
+void PathReplayLog::RecordSearch(unsigned int pathType, const float3& startPos, const float3& goalPos, float goalRadius)
+{
+	// requests made by Replay itself must not be logged again
+	if (replayRunning)
+		return;
+
+	if (!recordingTested) {
+		recordingTested = true;
+		recordingWanted = configHandler->GetBool("PathReplayLogRecord");
+	}
+
+	if (!recordingWanted)
+		return;
+
+	if (recordFile == nullptr) {
+		if ((recordFile = fopen(PATH_REPLAY_LOG_FILE, "wb")) == nullptr) {
+			LOG_L(L_WARNING, "[PathReplayLog] could not open %s for writing", PATH_REPLAY_LOG_FILE);
+			recordingWanted = false;
+			return;
+		}
+
+		fwrite(&PATH_REPLAY_LOG_MAGIC, sizeof(PATH_REPLAY_LOG_MAGIC), 1, recordFile);
+	}
+
+	LogEntry e;
+	e.frame = gs->frameNum;
+	e.pathType = pathType;
+	e.startPos[0] = startPos.x; e.startPos[1] = startPos.y; e.startPos[2] = startPos.z;
+	e.goalPos[0] = goalPos.x; e.goalPos[1] = goalPos.y; e.goalPos[2] = goalPos.z;
+	e.goalRadius = goalRadius;
+
+	fwrite(&e, sizeof(LogEntry), 1, recordFile);
+}
+
+
+void PathReplayLog::Replay(IPathManager* pm)
+{
+	if (!configHandler->GetBool("PathReplayLogReplay"))
+		return;
+
+	FILE* f = fopen(PATH_REPLAY_LOG_FILE, "rb");
+
+	if (f == nullptr) {
+		LOG_L(L_WARNING, "[PathReplayLog] could not open %s for reading", PATH_REPLAY_LOG_FILE);
+		return;
+	}
+
+	unsigned int magic = 0;
+
+	if (fread(&magic, sizeof(magic), 1, f) != 1 || magic != PATH_REPLAY_LOG_MAGIC) {
+		LOG_L(L_WARNING, "[PathReplayLog] %s is not a path-replay log", PATH_REPLAY_LOG_FILE);
+		fclose(f);
+		return;
+	}
+
+	std::vector<LogEntry> entries;
+
+	{
+		LogEntry e;
+
+		while (fread(&e, sizeof(LogEntry), 1, f) == 1) {
+			entries.push_back(e);
+		}
+	}
+
+	fclose(f);
+
+	if (entries.empty()) {
+		LOG_L(L_WARNING, "[PathReplayLog] %s contains no requests", PATH_REPLAY_LOG_FILE);
+		return;
+	}
+
+	std::vector<unsigned int> pathIDs;
+	pathIDs.reserve(entries.size());
+
+	unsigned int numFailed = 0;
+
+	replayRunning = true;
+
+	const spring_time startTime = spring_gettime();
+
+	for (unsigned int n = 0; n < entries.size(); n++) {
+		const LogEntry& e = entries[n];
+
+		if (e.pathType >= moveDefHandler->GetNumMoveDefs()) {
+			numFailed += 1;
+			continue;
+		}
+
+		const MoveDef* moveDef = moveDefHandler->GetMoveDefByPathType(e.pathType);
+
+		const float3 startPos(e.startPos[0], e.startPos[1], e.startPos[2]);
+		const float3 goalPos(e.goalPos[0], e.goalPos[1], e.goalPos[2]);
+
+		// callerless requests are arranged synchronously by the default
+		// PFS; QTPFS only queues them, so drain its searches below
+		const unsigned int pathID = pm->RequestPath(nullptr, moveDef, startPos, goalPos, e.goalRadius, true);
+
+		if (pathID == 0) {
+			numFailed += 1;
+			continue;
+		}
+
+		pathIDs.push_back(pathID);
+	}
+
+	pm->Update();
+
+	const float elapsedSecs = (spring_gettime() - startTime).toMilliSecsf() * 0.001f;
+
+	replayRunning = false;
+
+	for (unsigned int n = 0; n < pathIDs.size(); n++) {
+		pm->DeletePath(pathIDs[n]);
+	}
+
+	LOG(
+		"[PathReplayLog] replayed %u searches in %.3fs (%.1f searches/sec, %u failed)",
+		unsigned(entries.size()), elapsedSecs,
+		(elapsedSecs > 0.0f)? (entries.size() / elapsedSecs): 0.0f,
+		numFailed
+	);
+
+	// the per-resolution totals only exist for the default PFS
+	const CPathManager* cpm = dynamic_cast<const CPathManager*>(pm);
+
+	if (cpm == nullptr)
+		return;
+
+	LOG(
+		"[PathReplayLog] tested nodes: %u (max-res PF), %u (med-res PE), %u (low-res PE)",
+		cpm->GetMaxResPF()->sumTestedBlocks,
+		cpm->GetMedResPE()->sumTestedBlocks,
+		cpm->GetLowResPE()->sumTestedBlocks
+	);
+	LOG(
+		"[PathReplayLog] synced cache hit-rates: %.1f%% (med-res PE), %.1f%% (low-res PE)",
+		cpm->GetMedResPE()->GetPathCache(true)->GetCacheHitPercentage(),
+		cpm->GetLowResPE()->GetPathCache(true)->GetCacheHitPercentage()
+	);
+}
+
+
+void PathReplayLog::Finish()
+{
+	if (recordFile == nullptr)
+		return;
+
+	fclose(recordFile);
+	recordFile = nullptr;
+
+	// force a config re-read in case we get reloaded
+	recordingTested = false;
+}
@@ -0,0 +1,34 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef PATH_REPLAY_LOG_H
+#define PATH_REPLAY_LOG_H
+
+#include "System/float3.h"
+
+class IPathManager;
+
+/**
+ * Benchmark harness for the pathfinding subsystems. When recording is
+ * enabled (PathReplayLogRecord), every request passed to the active
+ * IPathManager is appended to a compact binary log ("path-replay.log"
+ * in the write-dir). When replaying is enabled (PathReplayLogReplay),
+ * such a log is re-issued against the freshly finalized PFS right after
+ * map-load --- before any simulation state has diverged --- and the
+ * searches/sec, tested-node, and cache hit-rate totals are logged.
+ *
+ * Replaying pollutes the (synced) path caches, so it is only meant for
+ * local A/B runs of pathfinder changes, not for multiplayer games.
+ */
+namespace PathReplayLog {
+	/// appends one request to the log; no-op unless recording is enabled
+	void RecordSearch(unsigned int pathType, const float3& startPos, const float3& goalPos, float goalRadius);
+
+	/// re-issues every logged request against <pm> and logs statistics;
+	/// no-op unless replaying is enabled
+	void Replay(IPathManager* pm);
+
+	/// flushes and closes the recording (if any)
+	void Finish();
+}
+
+#endif
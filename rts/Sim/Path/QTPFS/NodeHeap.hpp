@@ -3,6 +3,8 @@
 #ifndef QTPFS_NODEHEAP_HDR
 #define QTPFS_NODEHEAP_HDR
 
+#include <algorithm>
+#include <cassert>
 #include <limits>
 #include <vector>
 #include "PathDefines.hpp"
@@ -291,6 +293,162 @@ namespace QTPFS {
 		size_t cur_idx; // index of first free (unused) slot
 		size_t max_idx; // index of last free (unused) slot
 	};
+
+
+
+	// priority-queue that buckets nodes by quantized f-cost; push,
+	// pop and resort all run in (amortized) constant time instead
+	// of the O(log N) sift-passes a heap needs, which matters for
+	// searches over heavily subdivided layers
+	//
+	// floor-quantization preserves the relative order of buckets,
+	// so scanning the lowest non-empty bucket for its best member
+	// still dequeues nodes in exact best-first order
+	template<class TNode> class bucket_queue {
+	public:
+		// must match the field-widths used by {bucket,slot}_of
+		static const size_t NUM_BUCKETS = 4096;
+		static const size_t NUM_SLOT_BITS = 20;
+
+		bucket_queue() { clear(); }
+		bucket_queue(size_t n) { reserve(n); }
+		~bucket_queue() { clear(); }
+
+		// interface functions
+		void push(TNode n) {
+			// derive the quantization scale from the first node pushed;
+			// its h-estimate approximates the final path cost, so most
+			// expansions fall within 4x of it (nodes beyond that range
+			// all land in the last bucket, which stays exact since its
+			// members only get dequeued after every lower-valued node)
+			if (num_nodes == 0)
+				inv_scale = NUM_BUCKETS / std::max(1.0f, n->GetHeapPriority() * 4.0f);
+
+			const size_t k = bucket_idx(n->GetHeapPriority());
+
+			assert(buckets[k].size() < (1u << NUM_SLOT_BITS));
+
+			buckets[k].push_back(n);
+			n->SetHeapIndex(heap_idx(k, buckets[k].size() - 1));
+
+			min_bucket = std::min(min_bucket, k);
+			num_nodes += 1;
+		}
+
+		void pop() {
+			TNode n = top();
+
+			remove_node(n);
+			n->SetHeapIndex(-1u);
+		}
+
+		TNode top() {
+			assert(!empty());
+
+			while (buckets[min_bucket].empty())
+				min_bucket += 1;
+
+			const std::vector<TNode>& bucket = buckets[min_bucket];
+
+			TNode best = bucket[0];
+
+			for (size_t i = 1; i < bucket.size(); i++) {
+				if (NODE_CMP_LT(bucket[i], best))
+					best = bucket[i];
+			}
+
+			return best;
+		}
+
+
+		// utility functions
+		bool empty() const { return (num_nodes == 0); }
+		size_t size() const { return num_nodes; }
+
+		void clear() {
+			buckets.clear();
+			buckets.resize(NUM_BUCKETS);
+
+			num_nodes = 0;
+			min_bucket = NUM_BUCKETS - 1;
+			inv_scale = 1.0f;
+		}
+
+		void reserve(size_t size) {
+			clear();
+
+			// spread the expected load over all buckets
+			for (size_t k = 0; k < NUM_BUCKETS; k++) {
+				buckets[k].reserve(std::max<size_t>(4, size / NUM_BUCKETS));
+			}
+		}
+
+		// acts like reserve(), but without re-allocating
+		void reset() {
+			assert(!buckets.empty());
+
+			for (size_t k = 0; k < NUM_BUCKETS; k++) {
+				buckets[k].clear();
+			}
+
+			num_nodes = 0;
+			min_bucket = NUM_BUCKETS - 1;
+		}
+
+		void resort(TNode n) {
+			assert(n != NULL);
+
+			// costs only ever decrease during a search,
+			// just move <n> to its new (lower) bucket
+			remove_node(n);
+			push(n);
+		}
+
+		void check_heap_property(size_t) const {}
+
+	private:
+		size_t bucket_idx(float priority) const { return std::min(NUM_BUCKETS - 1, size_t(priority * inv_scale)); }
+
+		size_t heap_idx(size_t k, size_t slot) const { return ((k << NUM_SLOT_BITS) | slot); }
+		size_t bucket_of(size_t heapIdx) const { return (heapIdx >> NUM_SLOT_BITS); }
+		size_t slot_of(size_t heapIdx) const { return (heapIdx & ((1u << NUM_SLOT_BITS) - 1)); }
+
+		void remove_node(TNode n) {
+			const size_t k = bucket_of(n->GetHeapIndex());
+			const size_t slot = slot_of(n->GetHeapIndex());
+
+			std::vector<TNode>& bucket = buckets[k];
+
+			assert(slot < bucket.size());
+			assert(bucket[slot] == n);
+
+			// swap-erase; fix up the index of the displaced node
+			bucket[slot] = bucket.back();
+			bucket.pop_back();
+
+			if (slot < bucket.size())
+				bucket[slot]->SetHeapIndex(heap_idx(k, slot));
+
+			num_nodes -= 1;
+		}
+
+	private:
+		std::vector< std::vector<TNode> > buckets;
+
+		size_t num_nodes;
+		size_t min_bucket; // no non-empty bucket exists below this index
+
+		float inv_scale;
+	};
+
+
+
+	// the open-list type used by PathSearch
+	#ifdef QTPFS_BUCKETED_NODE_HEAP
+	template<class TNode> using node_heap = bucket_queue<TNode>;
+	#else
+	template<class TNode> using node_heap = binary_heap<TNode>;
+	#endif
 }
 
 #endif
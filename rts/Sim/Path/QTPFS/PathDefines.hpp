@@ -10,6 +10,7 @@
 #define QTPFS_SMOOTH_PATHS
 // #define QTPFS_CONSERVATIVE_NODE_SPLITS
 // #define QTPFS_DEBUG_NODE_HEAP
+#define QTPFS_BUCKETED_NODE_HEAP
 #define QTPFS_CORNER_CONNECTED_NODES
 // #define QTPFS_SLOW_ACCURATE_TESSELATION
 // #define QTPFS_OPENMP_ENABLED
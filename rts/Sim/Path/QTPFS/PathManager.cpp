@@ -17,6 +17,7 @@
 #include "Sim/MoveTypes/MoveDefHandler.h"
 #include "Sim/MoveTypes/MoveMath/MoveMath.h"
 #include "Sim/Objects/SolidObject.h"
+#include "Sim/Path/PathReplayLog.h"
 #include "System/Config/ConfigHandler.h"
 #include "System/FileSystem/ArchiveScanner.h"
 #include "System/FileSystem/FileSystem.h"
@@ -177,6 +178,10 @@ void QTPFS::PathManager::Load() {
 	numPathRequests   = 0;
 	maxNumLeafNodes   = 0;
 
+	numExecutedSearches = 0;
+	numSharedPathHits   = 0;
+	searchTimeMilliSecs = 0.0f;
+
 	nodeTrees.resize(moveDefHandler->GetNumMoveDefs(), NULL);
 	nodeLayers.resize(moveDefHandler->GetNumMoveDefs());
 	pathCaches.resize(moveDefHandler->GetNumMoveDefs());
@@ -516,6 +521,31 @@ void QTPFS::PathManager::ExecQueuedNodeLayerUpdates(unsigned int layerNum, bool
 		}
 	}
 }
+
+void QTPFS::PathManager::ExecAllQueuedNodeLayerUpdates() {
+	// gather the layers that actually have work queued; each layer
+	// only touches its own tree, cache and queue so the whole batch
+	// can be spread across the ThreadPool workers (same granularity
+	// as the threaded tesselation pass at load-time)
+	updateableLayerNums.clear();
+
+	for (unsigned int layerNum = 0; layerNum < nodeLayers.size(); layerNum++) {
+		if (nodeLayers[layerNum].HaveQueuedUpdate())
+			updateableLayerNums.push_back(layerNum);
+	}
+
+	if (updateableLayerNums.empty())
+		return;
+
+	streflop::streflop_init<streflop::Simple>();
+
+	for_mt(0, updateableLayerNums.size(), [&](const int n) {
+		const unsigned int layerNum = updateableLayerNums[n];
+		ExecQueuedNodeLayerUpdates(layerNum, !pathSearches[layerNum].empty());
+	});
+
+	streflop::streflop_init<streflop::Simple>();
+}
 #endif
 
 
@@ -701,18 +731,19 @@ void QTPFS::PathManager::ThreadUpdate() {
 		static unsigned int minPathTypeUpdate = 0;
 		static unsigned int maxPathTypeUpdate = numPathTypeUpdates;
 
-		sharedPaths.clear();
+		#ifdef QTPFS_STAGGERED_LAYER_UPDATES
+		// drain every layer's update-queue in one parallel batch; a
+		// map-damage storm then costs one tesselation pass instead of
+		// one serial pass per MoveDef (must run before any queued
+		// searches execute, they expect an up-to-date tesselation)
+		ExecAllQueuedNodeLayerUpdates();
+		#endif
 
 		for (unsigned int pathTypeUpdate = minPathTypeUpdate; pathTypeUpdate < maxPathTypeUpdate; pathTypeUpdate++) {
 			#ifndef QTPFS_IGNORE_DEAD_PATHS
 			QueueDeadPathSearches(pathTypeUpdate);
 			#endif
 
-			#ifdef QTPFS_STAGGERED_LAYER_UPDATES
-			// NOTE: *must* be called between QueueDeadPathSearches and ExecuteQueuedSearches
-			ExecQueuedNodeLayerUpdates(pathTypeUpdate, !pathSearches[pathTypeUpdate].empty());
-			#endif
-
 			ExecuteQueuedSearches(pathTypeUpdate);
 		}
 
@@ -795,6 +826,8 @@ bool QTPFS::PathManager::ExecuteSearch(
 
 		if (sharedPathsIt != sharedPaths.end()) {
 			if (search->SharedFinalize(sharedPathsIt->second, path)) {
+				numSharedPathHits += 1;
+
 				DeleteSearch(search, searches, searchesIt);
 				return false;
 			}
@@ -813,6 +846,8 @@ bool QTPFS::PathManager::ExecuteSearch(
 		#endif
 	}
 
+	const spring_time searchStartTime = spring_gettime();
+
 	// removes path from temp-paths, adds it to live-paths
 	if (search->Execute(searchStateOffset, numTerrainChanges)) {
 		search->Finalize(path);
@@ -828,6 +863,9 @@ bool QTPFS::PathManager::ExecuteSearch(
 		DeletePath(path->GetID());
 	}
 
+	numExecutedSearches += 1;
+	searchTimeMilliSecs += (spring_gettime() - searchStartTime).toMilliSecsf();
+
 	DeleteSearch(search, searches, searchesIt);
 	return true;
 }
@@ -842,7 +880,12 @@ void QTPFS::PathManager::QueueDeadPathSearches(unsigned int pathType) {
 	if (!deadPaths.empty()) {
 		// re-request LIVE paths that were marked as DEAD by a TerrainChange
 		// for each of these now-dead paths, reset the active point-idx to 0
+		//
+		// also drop their shared-cache entries *before* any queued search
+		// for this layer executes, so no request can clone a path that a
+		// node-layer update just invalidated
 		for (deadPathsIt = deadPaths.begin(); deadPathsIt != deadPaths.end(); ++deadPathsIt) {
+			ErasePathFromSharedPaths(deadPathsIt->second);
 			QueueSearch(deadPathsIt->second, NULL, moveDef, ZeroVector, ZeroVector, -1.0f, true);
 		}
 
@@ -850,6 +893,15 @@ void QTPFS::PathManager::QueueDeadPathSearches(unsigned int pathType) {
 	}
 }
 
+void QTPFS::PathManager::ErasePathFromSharedPaths(const IPath* path) {
+	const SharedPathMapIt sharedPathsIt = sharedPaths.find(path->GetHash());
+
+	// compare pointers; another path may have claimed the hash since
+	if (sharedPathsIt != sharedPaths.end() && sharedPathsIt->second == path) {
+		sharedPaths.erase(sharedPathsIt);
+	}
+}
+
 unsigned int QTPFS::PathManager::QueueSearch(
 	const IPath* oldPath,
 	const CSolidObject* object,
@@ -951,6 +1003,14 @@ void QTPFS::PathManager::DeletePath(unsigned int pathID) {
 
 	if (pathTypeIt != pathTypes.end()) {
 		PathCache& pathCache = pathCaches[pathTypeIt->second];
+		const PathCache& constPathCache = pathCache;
+
+		// the path can sit in any of the three maps at this point; its
+		// object must not linger in the shared cache once deleted
+		ErasePathFromSharedPaths(constPathCache.GetTempPath(pathID));
+		ErasePathFromSharedPaths(constPathCache.GetLivePath(pathID));
+		ErasePathFromSharedPaths(constPathCache.GetDeadPath(pathID));
+
 		pathCache.DelPath(pathID);
 
 		pathTypes.erase(pathTypeIt);
@@ -976,6 +1036,8 @@ unsigned int QTPFS::PathManager::RequestPath(
 	if (!IsFinalized())
 		return 0;
 
+	PathReplayLog::RecordSearch(moveDef->pathType, sourcePoint, targetPoint, radius);
+
 	return (QueueSearch(NULL, object, moveDef, sourcePoint, targetPoint, radius, synced));
 }
 
@@ -1136,6 +1198,29 @@ void QTPFS::PathManager::GetPathWayPoints(
 	}
 }
 
+IPathManager::PathStats QTPFS::PathManager::GetPathStats() const {
+	PathStats stats;
+
+	stats.numPathRequests = numPathRequests;
+	stats.numExecutedSearches = numExecutedSearches;
+
+	// shared-path reuse plays the role the estimator
+	// block-cache does for the default PFS; searches
+	// that could not reuse one ran in full
+	stats.numCacheHits = numSharedPathHits;
+	stats.numCacheMisses = numExecutedSearches;
+	stats.searchTimeMilliSecs = searchTimeMilliSecs;
+
+	for (unsigned int pathType = 0; pathType < pathSearches.size(); pathType++) {
+		stats.numQueuedSearches += pathSearches[pathType].size();
+	}
+	for (unsigned int pathType = 0; pathType < pathCaches.size(); pathType++) {
+		stats.numLivePaths += (pathCaches[pathType].GetLivePaths()).size();
+	}
+
+	return stats;
+}
+
 int2 QTPFS::PathManager::GetNumQueuedUpdates() const {
 	int2 data;
 
@@ -69,6 +69,7 @@ namespace QTPFS {
 		) const;
 
 		int2 GetNumQueuedUpdates() const;
+		PathStats GetPathStats() const;
 
 	private:
 		void ThreadUpdate();
@@ -111,10 +112,12 @@ namespace QTPFS {
 		#ifdef QTPFS_STAGGERED_LAYER_UPDATES
 		void QueueNodeLayerUpdates(const SRectangle& r);
 		void ExecQueuedNodeLayerUpdates(unsigned int layerNum, bool flushQueue);
+		void ExecAllQueuedNodeLayerUpdates();
 		#endif
 
 		void ExecuteQueuedSearches(unsigned int pathType);
 		void QueueDeadPathSearches(unsigned int pathType);
+		void ErasePathFromSharedPaths(const IPath* path);
 
 		unsigned int QueueSearch(
 			const IPath* oldPath,
@@ -148,12 +151,19 @@ namespace QTPFS {
 		spring::unordered_map<unsigned int, unsigned int> pathTypes;
 		spring::unordered_map<unsigned int, PathSearchTrace::Execution*> pathTraces;
 
-		// maps "hashes" of executed searches to the found paths
+		// maps "hashes" (source-node, target-node, layer) of executed
+		// searches to the found paths; entries persist across updates,
+		// they are dropped when the backing path is deleted or becomes
+		// dead through a node-layer update
 		spring::unordered_map<std::uint64_t, IPath*> sharedPaths;
 
 		std::vector<unsigned int> numCurrExecutedSearches;
 		std::vector<unsigned int> numPrevExecutedSearches;
 
+		// work-list of layers with queued updates, drained in
+		// one parallel batch per sim-frame (see ThreadUpdate)
+		std::vector<unsigned int> updateableLayerNums;
+
 		static unsigned int LAYERS_PER_UPDATE;
 		static unsigned int MAX_TEAM_SEARCHES;
 
@@ -162,6 +172,11 @@ namespace QTPFS {
 		unsigned int numPathRequests;
 		unsigned int maxNumLeafNodes;
 
+		// telemetry, see IPathManager::PathStats
+		unsigned int numExecutedSearches;
+		unsigned int numSharedPathHits;
+		float searchTimeMilliSecs;
+
 		std::uint32_t pfsCheckSum;
 
 		bool layersInited;
@@ -15,7 +15,7 @@
 
 #include "System/float3.h"
 
-QTPFS::binary_heap<QTPFS::INode*> QTPFS::PathSearch::openNodes;
+QTPFS::node_heap<QTPFS::INode*> QTPFS::PathSearch::openNodes;
 
 
 
@@ -548,13 +548,35 @@ bool QTPFS::PathSearch::SharedFinalize(const IPath* srcPath, IPath* dstPath) {
 	const float3& p0 = srcPath->GetTargetPoint();
 	const float3& p1 = dstPath->GetTargetPoint();
 
-	if (p0.SqDistance(p1) < (SQUARE_SIZE * SQUARE_SIZE)) {
+	// tolerance within which a cached same-region path counts as
+	// reaching our own goal; wider goal radii allow wider reuse
+	const float sqTolRadius = std::max(float(SQUARE_SIZE * SQUARE_SIZE), dstPath->GetRadius() * dstPath->GetRadius());
+
+	if (p0.SqDistance(p1) < sqTolRadius) {
 		// copy <srcPath> to <dstPath>
 		dstPath->CopyPoints(*srcPath);
 		dstPath->SetSourcePoint(srcPoint);
 		dstPath->SetTargetPoint(tgtPoint);
 		dstPath->SetBoundingBox();
 
+		// re-anchor; start pulling waypoints from the one closest to
+		// our own source so we do not backtrack to the donor's origin
+		// (we only share a source *node* with it, which can span many
+		// squares)
+		unsigned int minIdx = 0;
+		float minDistSq = QTPFS_POSITIVE_INFINITY;
+
+		for (unsigned int i = 0; i < (dstPath->NumPoints() - 1); i++) {
+			const float distSq = srcPoint.SqDistance2D(dstPath->GetPoint(i));
+
+			if (distSq < minDistSq) {
+				minDistSq = distSq;
+				minIdx = i;
+			}
+		}
+
+		dstPath->SetNextPointIndex(minIdx);
+
 		pathCache->AddLivePath(dstPath);
 		return true;
 	}
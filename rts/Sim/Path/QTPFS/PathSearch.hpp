@@ -167,7 +167,7 @@ namespace QTPFS {
 
 		// global queue: allocated once, re-used by all searches without clear()'s
 		// this relies on INode::operator< to sort the INode*'s by increasing f-cost
-		static binary_heap<INode*> openNodes;
+		static node_heap<INode*> openNodes;
 
 		NodeLayer* nodeLayer;
 		PathCache* pathCache;
@@ -112,3 +112,24 @@ CExpGenSpawnable* CExpGenSpawnable::CreateSpawnable(int spawnableID)
 
 	return nullptr;
 }
+
+
+void CExpGenSpawnable::CreateSpawnables(int spawnableID, unsigned int count, std::vector<CExpGenSpawnable*>& spawnables)
+{
+	spawnables.clear();
+	spawnables.reserve(count);
+
+	int i = 0;
+#define CHECK_SPAWNABLE(spawnable)                                \
+	if (spawnableID == i) {                                       \
+		for (unsigned int n = 0; n < count; n++) {                \
+			spawnables.push_back(projMemPool.alloc<spawnable>()); \
+		}                                                         \
+		return;                                                   \
+	}                                                             \
+	++i;
+
+	CHECK_ALL_SPAWNABLES()
+
+#undef CHECK_SPAWNABLE
+}
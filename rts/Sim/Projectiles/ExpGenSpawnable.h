@@ -3,6 +3,8 @@
 #ifndef EXP_GEN_SPAWNABLE_H
 #define EXP_GEN_SPAWNABLE_H
 
+#include <vector>
+
 #include "Sim/Objects/WorldObject.h"
 
 struct SExpGenSpawnableMemberInfo;
@@ -22,6 +24,9 @@ public:
 
 	//Memory handled in projectileHandler
 	static CExpGenSpawnable* CreateSpawnable(int spawnableID);
+	///< batch version; resolves the ID to a concrete type once
+	///< instead of once per allocated instance
+	static void CreateSpawnables(int spawnableID, unsigned int count, std::vector<CExpGenSpawnable*>& spawnables);
 
 protected:
 	CExpGenSpawnable();
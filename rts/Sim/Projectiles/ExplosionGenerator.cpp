@@ -49,6 +49,17 @@ CR_REG_METADATA(IExplosionGenerator, (
 CR_BIND_DERIVED(CStdExplosionGenerator, IExplosionGenerator, )
 CR_REG_METADATA(CStdExplosionGenerator, )
 
+CR_BIND(CCustomExplosionGenerator::SpawnCodeInstr, )
+CR_REG_METADATA_SUB(CCustomExplosionGenerator, SpawnCodeInstr, (
+	CR_MEMBER(op),
+	CR_MEMBER(dstSize),
+	CR_MEMBER(dstOffset),
+	CR_MEMBER(fltArg),
+	CR_MEMBER(intArg),
+	// resolved again by Reload, never valid across save/load
+	CR_IGNORED(ptrArg)
+))
+
 CR_BIND(CCustomExplosionGenerator::ProjectileSpawnInfo, )
 CR_REG_METADATA_SUB(CCustomExplosionGenerator, ProjectileSpawnInfo, (
 	CR_MEMBER(spawnableID),
@@ -602,121 +613,91 @@ bool CStdExplosionGenerator::Explosion(
 
 
 
-void CCustomExplosionGenerator::ExecuteExplosionCode(const char* code, float damage, char* instance, int spawnIndex, const float3& dir)
+void CCustomExplosionGenerator::ExecuteExplosionCode(const std::vector<SpawnCodeInstr>& code, float damage, char* instance, int spawnIndex, const float3& dir)
 {
 	float val = 0.0f;
-	void* ptr = NULL;
 	float buffer[16];
 
 	std::memset(&buffer[0], 0, 16 * sizeof(float));
 
-	for (;;) {
-		switch (*(code++)) {
-			case OP_END: {
-				return;
-			}
+	for (const SpawnCodeInstr& si: code) {
+		switch (si.op) {
 			case OP_STOREI: {
-				std::uint8_t  size   = *(std::uint8_t*)  code; code++;
-				std::uint16_t offset = *(std::uint16_t*) code; code += 2;
-				switch (size) {
-					case 1: { *(std::int8_t*)  (instance + offset) = (int) val; } break;
-					case 2: { *(std::int16_t*) (instance + offset) = (int) val; } break;
-					case 4: { *(std::int32_t*) (instance + offset) = (int) val; } break;
-					case 8: { *(std::int64_t*) (instance + offset) = (int) val; } break;
+				switch (si.dstSize) {
+					case 1: { *(std::int8_t*)  (instance + si.dstOffset) = (int) val; } break;
+					case 2: { *(std::int16_t*) (instance + si.dstOffset) = (int) val; } break;
+					case 4: { *(std::int32_t*) (instance + si.dstOffset) = (int) val; } break;
+					case 8: { *(std::int64_t*) (instance + si.dstOffset) = (int) val; } break;
 					default: { /*no op*/ } break;
 				}
 				val = 0.0f;
 				break;
 			}
 			case OP_STOREF: {
-				std::uint8_t  size   = *(std::uint8_t*)  code; code++;
-				std::uint16_t offset = *(std::uint16_t*) code; code += 2;
-				switch (size) {
-					case 4: { *(float*)  (instance + offset) = val; } break;
-					case 8: { *(double*) (instance + offset) = val; } break;
+				switch (si.dstSize) {
+					case 4: { *(float*)  (instance + si.dstOffset) = val; } break;
+					case 8: { *(double*) (instance + si.dstOffset) = val; } break;
 					default: { /*no op*/ } break;
 				}
 				val = 0.0f;
 				break;
 			}
 			case OP_ADD: {
-				val += *(float*) code;
-				code += 4;
+				val += si.fltArg;
 				break;
 			}
 			case OP_RAND: {
-				val += guRNG.NextFloat() * (*(float*) code);
-				code += 4;
+				val += guRNG.NextFloat() * si.fltArg;
 				break;
 			}
 			case OP_DAMAGE: {
-				val += damage * (*(float*) code);
-				code += 4;
+				val += damage * si.fltArg;
 				break;
 			}
 			case OP_INDEX: {
-				val += spawnIndex * (*(float*) code);
-				code += 4;
-				break;
-			}
-			case OP_LOADP: {
-				ptr = *(void**) code;
-				code += sizeof(void*);
+				val += spawnIndex * si.fltArg;
 				break;
 			}
 			case OP_STOREP: {
-				std::uint16_t offset = *(std::uint16_t*) code;
-				code += 2;
-				*(void**) (instance + offset) = ptr;
-				ptr = NULL;
+				*(void**) (instance + si.dstOffset) = si.ptrArg;
 				break;
 			}
 			case OP_DIR: {
-				std::uint16_t offset = *(std::uint16_t*) code;
-				code += 2;
-				*reinterpret_cast<float3*>(instance + offset) = dir;
+				*reinterpret_cast<float3*>(instance + si.dstOffset) = dir;
 				break;
 			}
 			case OP_SAWTOOTH: {
 				// this translates to modulo except it works with floats
-				val -= (*(float*) code) * math::floor(val / (*(float*) code));
-				code += 4;
+				val -= si.fltArg * math::floor(val / si.fltArg);
 				break;
 			}
 			case OP_DISCRETE: {
-				val = (*(float*) code) * math::floor(spring::SafeDivide(val, (*(float*) code)));
-				code += 4;
+				val = si.fltArg * math::floor(spring::SafeDivide(val, si.fltArg));
 				break;
 			}
 			case OP_SINE: {
-				val = (*(float*) code) * math::sin(val);
-				code += 4;
+				val = si.fltArg * math::sin(val);
 				break;
 			}
 			case OP_YANK: {
-				buffer[(*(int*) code)] = val;
+				buffer[si.intArg] = val;
 				val = 0;
-				code += 4;
 				break;
 			}
 			case OP_MULTIPLY: {
-				val *= buffer[(*(int*) code)];
-				code += 4;
+				val *= buffer[si.intArg];
 				break;
 			}
 			case OP_ADDBUFF: {
-				val += buffer[(*(int*) code)];
-				code += 4;
+				val += buffer[si.intArg];
 				break;
 			}
 			case OP_POW: {
-				val = math::pow(val, (*(float*) code));
-				code += 4;
+				val = math::pow(val, si.fltArg);
 				break;
 			}
 			case OP_POWBUFF: {
-				val = math::pow(val, buffer[(*(int*) code)]);
-				code += 4;
+				val = math::pow(val, buffer[si.intArg]);
 				break;
 			}
 			default: {
@@ -733,7 +714,7 @@ void CCustomExplosionGenerator::ParseExplosionCode(
 	CCustomExplosionGenerator::ProjectileSpawnInfo* psi,
 	const string& script,
 	SExpGenSpawnableMemberInfo& memberInfo,
-	string& code)
+	std::vector<SpawnCodeInstr>& code)
 {
 	const std::string content = script.substr(0, script.find(';', 0));
 	const bool isFloat = memberInfo.type == SExpGenSpawnableMemberInfo::TYPE_FLOAT;
@@ -743,9 +724,10 @@ void CCustomExplosionGenerator::ParseExplosionCode(
 		if (memberInfo.length < 3 || !isFloat) // dir has to be float3
 			throw content_error("[CCEG::ParseExplosionCode] incorrect use of \"dir\" (" + script + ")");
 
-		code += OP_DIR;
-		std::uint16_t ofs = memberInfo.offset;
-		code.append((char*) &ofs, (char*) &ofs + sizeof(ofs));
+		SpawnCodeInstr si;
+		si.op = OP_DIR;
+		si.dstOffset = memberInfo.offset;
+		code.push_back(si);
 
 		return;
 	}
@@ -768,12 +750,11 @@ void CCustomExplosionGenerator::ParseExplosionCode(
 	//Textures, Colormaps, etc.
 	if (memberInfo.type == SExpGenSpawnableMemberInfo::TYPE_PTR) {
 		// Memory is managed by whomever this callback belongs to
-		void* ptr = memberInfo.ptrCallback(content);
-		code += OP_LOADP;
-		code.append((char*)(&ptr), ((char*)(&ptr)) + sizeof(void*));
-		code += OP_STOREP;
-		std::uint16_t ofs = memberInfo.offset;
-		code.append((char*)&ofs, (char*)&ofs + sizeof(ofs));
+		SpawnCodeInstr si;
+		si.op = OP_STOREP;
+		si.dstOffset = memberInfo.offset;
+		si.ptrArg = memberInfo.ptrCallback(content);
+		code.push_back(si);
 
 		return;
 	}
@@ -798,7 +779,7 @@ void CCustomExplosionGenerator::ParseExplosionCode(
 	// parse the code
 	int p = 0;
 	while (p < script.length()) {
-		char opcode = OP_END;
+		int opcode = OP_END;
 		char c = script[p++];
 
 		// consume whitespace
@@ -831,30 +812,29 @@ void CCustomExplosionGenerator::ParseExplosionCode(
 
 		char* endp = NULL;
 
+		SpawnCodeInstr si;
+		si.op = opcode;
+
 		if (!useInt) {
 			// strtod&co expect C-style strings with NULLs,
 			// c_str() is guaranteed to be NULL-terminated
 			// (whether .data() == .c_str() depends on the
 			// implementation of std::string)
-			const float v = (float)strtod(&script.c_str()[p], &endp);
-
-			p += (endp - &script.c_str()[p]);
-			code += opcode;
-			code.append((char*) &v, ((char*) &v) + sizeof(v));
+			si.fltArg = (float)strtod(&script.c_str()[p], &endp);
 		} else {
-			const int v = std::max(0, std::min(16, (int)strtol(&script.c_str()[p], &endp, 10)));
-
-			p += (endp - &script.c_str()[p]);
-			code += opcode;
-			code.append((char*) &v, ((char*) &v) + + sizeof(v));
+			si.intArg = std::max(0, std::min(16, (int)strtol(&script.c_str()[p], &endp, 10)));
 		}
+
+		p += (endp - &script.c_str()[p]);
+		code.push_back(si);
 	}
 
 	// store the final value
-	code.push_back(isFloat ? OP_STOREF : OP_STOREI);
-	code.push_back(memberInfo.size);
-	std::uint16_t ofs = memberInfo.offset;
-	code.append((char*)&ofs, (char*)&ofs + sizeof(ofs));
+	SpawnCodeInstr si;
+	si.op = isFloat ? OP_STOREF : OP_STOREI;
+	si.dstSize = memberInfo.size;
+	si.dstOffset = memberInfo.offset;
+	code.push_back(si);
 }
 
 
@@ -900,7 +880,6 @@ bool CCustomExplosionGenerator::Load(CExplosionGeneratorHandler* handler, const
 		psi.flags = GetFlagsFromTable(spawnTable);
 		psi.count = std::max(0, spawnTable.GetInt("count", 1));
 
-		string code;
 		spring::unordered_map<string, string> props;
 
 		spawnTable.SubTable("properties").GetMap(props);
@@ -909,16 +888,12 @@ bool CCustomExplosionGenerator::Load(CExplosionGeneratorHandler* handler, const
 			SExpGenSpawnableMemberInfo memberInfo = {0, 0, 0, STRING_HASH(std::move(StringToLower(propIt.first))), SExpGenSpawnableMemberInfo::TYPE_INT, nullptr};
 
 			if (CExpGenSpawnable::GetSpawnableMemberInfo(className, memberInfo)) {
-				ParseExplosionCode(&psi, propIt.second, memberInfo, code);
+				ParseExplosionCode(&psi, propIt.second, memberInfo, psi.code);
 			} else {
 				LOG_L(L_WARNING, "[CCEG::%s] %s: Unknown tag %s::%s", __FUNCTION__, tag.c_str(), className.c_str(), propIt.first.c_str());
 			}
 		}
 
-		code += (char)OP_END;
-		psi.code.resize(code.size());
-		copy(code.begin(), code.end(), psi.code.begin());
-
 		expGenParams.projectiles.push_back(psi);
 	}
 
@@ -981,9 +956,16 @@ bool CCustomExplosionGenerator::Explosion(
 		if (projectileHandler->GetParticleSaturation() > 1.0f)
 			break;
 
-		for (unsigned int c = 0; c < psi.count; c++) {
-			CExpGenSpawnable* projectile = CExpGenSpawnable::CreateSpawnable(psi.spawnableID);
-			ExecuteExplosionCode(&psi.code[0], damage, (char*) projectile, c, dir);
+		// batch-allocate, the ID only has to be resolved to
+		// a concrete spawnable type once per spawn-info here
+		static std::vector<CExpGenSpawnable*> spawned;
+
+		CExpGenSpawnable::CreateSpawnables(psi.spawnableID, psi.count, spawned);
+
+		for (unsigned int c = 0; c < spawned.size(); c++) {
+			CExpGenSpawnable* projectile = spawned[c];
+
+			ExecuteExplosionCode(psi.code, damage, (char*) projectile, c, dir);
 			projectile->Init(owner, pos);
 		}
 	}
@@ -3,6 +3,7 @@
 #ifndef EXPLOSION_GENERATOR_H
 #define EXPLOSION_GENERATOR_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -142,10 +143,38 @@ public:
 class CCustomExplosionGenerator: public IExplosionGenerator
 {
 	CR_DECLARE_DERIVED(CCustomExplosionGenerator)
+	CR_DECLARE_SUB(SpawnCodeInstr)
 	CR_DECLARE_SUB(ProjectileSpawnInfo)
 	CR_DECLARE_SUB(ExpGenParams)
 
 protected:
+	// one pre-decoded explosion-script instruction; operands are
+	// typed and aligned so executing a program is a plain walk over
+	// the vector instead of a byte-by-byte decode of a code string
+	struct SpawnCodeInstr {
+		CR_DECLARE_STRUCT(SpawnCodeInstr)
+
+		SpawnCodeInstr()
+			: op(OP_END)
+			, dstSize(0)
+			, dstOffset(0)
+			, fltArg(0.0f)
+			, intArg(0)
+			, ptrArg(nullptr)
+		{}
+
+		int op;
+
+		std::uint8_t dstSize;    ///< size of the written member (OP_STORE*)
+		std::uint16_t dstOffset; ///< offset of the written member within the instance
+
+		float fltArg;
+		int intArg;
+		/// immediate operand for OP_STOREP (texture, colormap, ...);
+		/// owned by whomever the ptrCallback resolving it belongs to
+		void* ptrArg;
+	};
+
 	struct ProjectileSpawnInfo {
 		CR_DECLARE_STRUCT(ProjectileSpawnInfo)
 
@@ -163,8 +192,8 @@ protected:
 
 		unsigned int spawnableID;
 
-		/// parsed explosion script code
-		std::vector<char> code;
+		/// explosion script compiled to a flat instruction array
+		std::vector<SpawnCodeInstr> code;
 
 		/// number of projectiles spawned of this type
 		unsigned int count;
@@ -204,15 +233,14 @@ public:
 	};
 
 	enum {
-		OP_END      =  0,
+		OP_END      =  0, // no-op, default for zero-initialized instructions
 		OP_STOREI   =  1, // int
 		OP_STOREF   =  2, // float
 		OP_ADD      =  4,
 		OP_RAND     =  5,
 		OP_DAMAGE   =  6,
 		OP_INDEX    =  7,
-		OP_LOADP    =  8, // load a void* into the pointer register
-		OP_STOREP   =  9, // store the pointer register into a void*
+		OP_STOREP   =  9, // store the immediate void* operand
 		OP_DIR      = 10, // store the float3 direction
 		OP_SAWTOOTH = 11, // Performs a modulo to create a sawtooth wave
 		OP_DISCRETE = 12, // Floors the value to a multiple of its parameter
@@ -225,8 +253,8 @@ public:
 	};
 
 private:
-	void ParseExplosionCode(ProjectileSpawnInfo* psi, const std::string& script, SExpGenSpawnableMemberInfo& memberInfo, std::string& code);
-	void ExecuteExplosionCode(const char* code, float damage, char* instance, int spawnIndex, const float3& dir);
+	void ParseExplosionCode(ProjectileSpawnInfo* psi, const std::string& script, SExpGenSpawnableMemberInfo& memberInfo, std::vector<SpawnCodeInstr>& code);
+	void ExecuteExplosionCode(const std::vector<SpawnCodeInstr>& code, float damage, char* instance, int spawnIndex, const float3& dir);
 
 protected:
 	ExpGenParams expGenParams;
@@ -29,6 +29,9 @@ CR_REG_METADATA(CProjectile,
 
 	CR_MEMBER(castShadow),
 	CR_MEMBER(drawSorted),
+	// both are constants of (or serialized by) the derived types
+	CR_IGNORED(linearMotion),
+	CR_IGNORED(deathFrame),
 
 	CR_MEMBER_BEGINFLAG(CM_Config),
 		CR_MEMBER(dir),
@@ -66,6 +69,8 @@ CProjectile::CProjectile()
 	, callEvent(true)
 	, castShadow(false)
 	, drawSorted(true)
+	, linearMotion(false)
+	, deathFrame(-1)
 
 	, mygravity(mapInfo? mapInfo->map.gravity: 0.0f)
 	, sortDist(0.0f)
@@ -104,6 +109,8 @@ CProjectile::CProjectile(
 	, callEvent(true)
 	, castShadow(false)
 	, drawSorted(true)
+	, linearMotion(false)
+	, deathFrame(-1)
 
 	, dir(ZeroVector) // set via Init()
 	, mygravity(mapInfo? mapInfo->map.gravity: 0.0f)
@@ -105,6 +105,13 @@ public:
 	bool castShadow;
 	bool drawSorted;
 
+	// set by particle-like projectiles whose Update() is plain linear
+	// motion with an optional expiry frame; lets ProjectileHandler run
+	// them through a batched lane without virtual dispatch
+	bool linearMotion;
+	// frame at which the batched lane marks us deleteMe (negative = never)
+	int deathFrame;
+
 	float3 dir;
 	float3 drawPos;
 
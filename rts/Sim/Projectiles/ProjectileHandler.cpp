@@ -28,6 +28,7 @@
 #include "System/EventHandler.h"
 #include "System/Log/ILog.h"
 #include "System/TimeProfiler.h"
+#include "System/UnorderedMap.hpp"
 #include "System/creg/STL_Deque.h"
 
 
@@ -234,8 +235,17 @@ void CProjectileHandler::UpdateProjectileContainer(ProjectileContainer& pc, bool
 
 		MAPPOS_SANITY_CHECK(p->pos);
 
-		p->Update();
-		quadField->MovedProjectile(p);
+		if (p->linearMotion && !p->luaMoveCtrl) {
+			// batched lane for particle-like projectiles; equivalent
+			// to their Update() but skips the virtual dispatch (these
+			// never move between quads either, cf. MovedProjectile)
+			assert(!p->synced);
+			p->SetPosition(p->pos + p->speed);
+			p->deleteMe |= (p->deathFrame >= 0 && gs->frameNum >= p->deathFrame);
+		} else {
+			p->Update();
+			quadField->MovedProjectile(p);
+		}
 
 		MAPPOS_SANITY_CHECK(p->pos);
 	}
@@ -324,6 +334,12 @@ void CProjectileHandler::Update()
 				std::stable_sort(fpc.begin(), fpc.end());
 			}
 		}
+
+		// recycle the lowest free pages first so long games keep new
+		// projectiles packed toward the front of the pool; only resort
+		// the free list when fragmentation is actually noticeable
+		if ((gs->frameNum % 300) == 0 && projMemPool.frag_ratio() > 0.25f)
+			projMemPool.defrag_free_pages();
 	}
 
 	// precache part of particles count calculation that else becomes very heavy
@@ -356,6 +372,10 @@ void CProjectileHandler::AddProjectile(CProjectile* p)
 		proIDs = &syncedProjectileIDs;
 		ASSERT_SYNCED(freeIDs->size());
 	} else {
+		// purely visual; flag for removal on the next container update
+		// when fast-forwarding so they do not pile up unseen
+		p->deleteMe |= gu->simCatchingUp;
+
 		unsyncedProjectiles.push_back(p);
 #if UNSYNCED_PROJ_NOEVENT
 		return;
@@ -540,7 +560,7 @@ void CProjectileHandler::CheckShieldCollisions(
 		// it's not 100% accurate so there's a bit of a FIXME here to do a real solution
 		// (keep track in the projectile which shields it's in)
 
-		const float3 effectivePPos0 = ppos0 + (ppos0 - ppos1) * repulser->deltaPos.Length();
+		const float3 effectivePPos0 = ppos0 + (ppos0 - ppos1) * repulser->GetDeltaPosLen();
 		if (CCollisionHandler::DetectHit(repulser->owner, &repulser->collisionVolume, repulser->owner->GetTransformMatrix(true), effectivePPos0, ppos1, &cq)) {
 			if (!cq.InsideHit() || !repulser->weaponDef->exteriorShield || repulser->IsRepulsing(wpro)) {
 				if (repulser->IncomingProjectile(wpro, cq.GetHitPos()))
@@ -552,11 +572,135 @@ void CProjectileHandler::CheckShieldCollisions(
 
 void CProjectileHandler::CheckUnitFeatureCollisions(ProjectileContainer& pc)
 {
+	// per-projectile candidate lists, filled by the bucketed broad-phase
+	static std::vector< std::vector<CUnit*> > candUnits;
+	static std::vector< std::vector<CFeature*> > candFeatures;
+	static std::vector< std::vector<CPlasmaRepulser*> > candRepulsers;
+	// indices of the projectiles covering each occupied quad
+	static spring::unordered_map<int, std::vector<unsigned int> > quadProjIdcs;
+	static std::vector<int> tempQuads;
+
 	static std::vector<CUnit*> tempUnits;
 	static std::vector<CFeature*> tempFeatures;
 	static std::vector<CPlasmaRepulser*> tempRepulsers;
 
-	for (size_t i = 0; i < pc.size(); ++i) {
+	const size_t numProjectiles = pc.size();
+
+	candUnits.resize(numProjectiles);
+	candFeatures.resize(numProjectiles);
+	candRepulsers.resize(numProjectiles);
+
+	// broad-phase: bucket projectiles by the quad they cover, so each
+	// occupied quad's object lists (maintained by CQuadField) are only
+	// walked once per frame no matter how many projectiles sit in it;
+	// decoupling this from the narrow-phase below is safe because the
+	// pre-filter is purely positional and object positions do not move
+	// during collision testing (cf. the batched terrain sampling in
+	// CheckGroundCollisions)
+	for (size_t i = 0; i < numProjectiles; ++i) {
+		CProjectile* p = pc[i];
+
+		candUnits[i].clear();
+		candFeatures[i].clear();
+		candRepulsers[i].clear();
+
+		if (!p->checkCol) continue;
+		if ( p->deleteMe) continue;
+
+		quadField->GetQuads(p->pos, p->radius + p->speed.w, tempQuads);
+
+		if (tempQuads.size() == 1) {
+			quadProjIdcs[tempQuads[0]].push_back(i);
+			continue;
+		}
+
+		// spans multiple quads (rare); query directly, objects that are
+		// registered in several of them would otherwise show up as
+		// duplicate candidates
+		quadField->GetUnitsAndFeaturesColVol(p->pos, p->radius + p->speed.w, candUnits[i], candFeatures[i], &candRepulsers[i]);
+	}
+
+	// the bucket iteration order is not deterministic, but each
+	// single-quad projectile draws its candidates from just its own
+	// quad so the per-projectile lists (and thereby the sim) do not
+	// depend on it
+	for (const auto& bucket: quadProjIdcs) {
+		const CQuadField::Quad& quad = quadField->GetQuad(bucket.first);
+		const std::vector<unsigned int>& projIdcs = bucket.second;
+
+		for (CUnit* u: quad.units) {
+			const CollisionVolume* colvol = &u->collisionVolume;
+			const float3 cvPos = colvol->GetWorldSpacePos(u);
+			const float cvRad = colvol->GetBoundingRadius();
+
+			for (const unsigned int i: projIdcs) {
+				const CProjectile* p = pc[i];
+				const float totRad = p->radius + p->speed.w + cvRad;
+
+				if (p->pos.SqDistance(cvPos) >= (totRad * totRad))
+					continue;
+
+				candUnits[i].push_back(u);
+			}
+		}
+
+		for (CFeature* f: quad.features) {
+			const CollisionVolume* colvol = &f->collisionVolume;
+			const float3 cvPos = colvol->GetWorldSpacePos(f);
+			const float cvRad = colvol->GetBoundingRadius();
+
+			for (const unsigned int i: projIdcs) {
+				const CProjectile* p = pc[i];
+				const float totRad = p->radius + p->speed.w + cvRad;
+
+				if (p->pos.SqDistance(cvPos) >= (totRad * totRad))
+					continue;
+
+				candFeatures[i].push_back(f);
+			}
+		}
+
+		for (CPlasmaRepulser* r: quad.repulsers) {
+			// disabled/stunned shields can not intercept anything this
+			// frame (the state only changes outside the collision pass),
+			// drop them once here instead of once per pair
+			if (!r->IsActive())
+				continue;
+
+			const float cvRad = r->collisionVolume.GetBoundingRadius();
+
+			for (const unsigned int i: projIdcs) {
+				const CProjectile* p = pc[i];
+				const float totRad = p->radius + p->speed.w + cvRad;
+
+				if (p->pos.SqDistance(r->weaponMuzzlePos) >= (totRad * totRad))
+					continue;
+
+				candRepulsers[i].push_back(r);
+			}
+		}
+	}
+
+	quadProjIdcs.clear();
+
+	// narrow-phase, in container order as before
+	for (size_t i = 0; i < numProjectiles; ++i) {
+		CProjectile* p = pc[i];
+
+		if (!p->checkCol) continue;
+		if ( p->deleteMe) continue;
+
+		const float3 ppos0 = p->pos;
+		const float3 ppos1 = p->pos + p->speed;
+
+		CheckShieldCollisions(p, candRepulsers[i], ppos0, ppos1);
+		CheckUnitCollisions(p, candUnits[i], ppos0, ppos1);
+		CheckFeatureCollisions(p, candFeatures[i], ppos0, ppos1);
+	}
+
+	// projectiles spawned by the Collision() calls above were appended
+	// to <pc> and still expect a collision test this frame
+	for (size_t i = numProjectiles; i < pc.size(); ++i) {
 		CProjectile* p = pc[i];
 
 		if (!p->checkCol) continue;
@@ -575,7 +719,20 @@ void CProjectileHandler::CheckUnitFeatureCollisions(ProjectileContainer& pc)
 
 void CProjectileHandler::CheckGroundCollisions(ProjectileContainer& pc)
 {
-	for (size_t i = 0; i < pc.size(); ++i) {
+	static std::vector<CProjectile*> tempProjectiles;
+	static std::vector<float3> tempPositions;
+	static std::vector<float> tempHeights;
+
+	tempProjectiles.clear();
+	tempPositions.clear();
+
+	// sample the terrain for all candidates in one batched call; safe
+	// because Collision() never moves other projectiles and explosions
+	// only deform the heightmap in CBasicMapDamage::Update, i.e. after
+	// this pass completes
+	const size_t numProjectiles = pc.size();
+
+	for (size_t i = 0; i < numProjectiles; ++i) {
 		CProjectile* p = pc[i];
 
 		if (!p->checkCol)
@@ -592,11 +749,21 @@ void CProjectileHandler::CheckGroundCollisions(ProjectileContainer& pc)
 		if (p->weapon && static_cast<const CWeaponProjectile*>(p)->HasScheduledBounce())
 			continue;
 
+		tempProjectiles.push_back(p);
+		tempPositions.push_back(p->pos);
+	}
+
+	tempHeights.resize(tempPositions.size());
+	CGround::GetHeightsReal(tempPositions.data(), tempHeights.data(), tempPositions.size());
+
+	for (size_t i = 0; i < tempProjectiles.size(); ++i) {
+		CProjectile* p = tempProjectiles[i];
+
 		// NOTE:
 		//   don't add p->radius to groundHeight, or most (esp. modelled)
 		//   projectiles will collide with the ground one or more frames
 		//   too early
-		const float groundHeight = CGround::GetHeightReal(p->pos.x, p->pos.z);
+		const float groundHeight = tempHeights[i];
 
 		const bool belowGround = (p->pos.y < groundHeight);
 		const bool insideWater = (p->pos.y <= 0.0f && !belowGround);
@@ -611,6 +778,30 @@ void CProjectileHandler::CheckGroundCollisions(ProjectileContainer& pc)
 			p->Collision();
 		}
 	}
+
+	// projectiles spawned by the Collision() calls above were appended
+	// to <pc> and still expect a ground-check this frame
+	for (size_t i = numProjectiles; i < pc.size(); ++i) {
+		CProjectile* p = pc[i];
+
+		if (!p->checkCol)
+			continue;
+		if (p->GetCollisionFlags() & Collision::NOGROUND)
+			continue;
+		if (p->weapon && static_cast<const CWeaponProjectile*>(p)->HasScheduledBounce())
+			continue;
+
+		const float groundHeight = CGround::GetHeightReal(p->pos.x, p->pos.z);
+
+		const bool belowGround = (p->pos.y < groundHeight);
+		const bool insideWater = (p->pos.y <= 0.0f && !belowGround);
+		const bool ignoreWater = p->ignoreWater;
+
+		if (belowGround || (insideWater && !ignoreWater)) {
+			p->SetPosition(p->pos * XZVector + UpVector * groundHeight * belowGround);
+			p->Collision();
+		}
+	}
 }
 
 void CProjectileHandler::CheckCollisions()
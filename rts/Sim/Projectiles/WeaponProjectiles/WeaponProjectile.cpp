@@ -158,7 +158,12 @@ void CWeaponProjectile::Explode(
 	float3 impactPos,
 	float3 impactDir
 ) {
-	const DamageArray& damageArray = damages->GetDynamicDamages(startPos, impactPos);
+	// scratch copy only made when damage actually falls off with distance
+	static DamageArray dynDamages;
+
+	const DamageArray& damageArray = damages->HasDynamicDamages()?
+		(dynDamages = damages->GetDynamicDamages(startPos, impactPos)):
+		static_cast<const DamageArray&>(*damages);
 	const CExplosionParams params = {
 		impactPos,
 		impactDir.SafeNormalize(),
@@ -17,6 +17,7 @@
 #include "Sim/Misc/Team.h"
 #include "Sim/Misc/TeamHandler.h"
 #include "Sim/MoveTypes/MoveType.h"
+#include "Sim/Path/IPathManager.h"
 #include "Sim/Units/UnitDefHandler.h"
 #include "Sim/Units/UnitHandler.h"
 #include "Sim/Units/UnitTypes/Builder.h"
@@ -1465,6 +1466,29 @@ bool CBuilderCAI::ReclaimObject(CSolidObject* object) {
 }
 
 
+const CSolidObject* CBuilderCAI::FindCheapestPathTarget(const std::vector<const CSolidObject*>& candidates, const CSolidObject* best) const
+{
+	if (candidates.size() <= 1 || owner->immobile || owner->moveDef == NULL)
+		return best;
+
+	std::vector<float3> goalPositions;
+	goalPositions.reserve(candidates.size());
+
+	for (unsigned int n = 0; n < candidates.size(); n++) {
+		goalPositions.push_back(candidates[n]->pos);
+	}
+
+	const int idx = pathManager->GetCheapestGoalPosition(owner, owner->moveDef, owner->pos, goalPositions, ownerBuilder->buildDistance, true);
+
+	// a PFS without multi-goal searches (or one that can not reach
+	// any candidate) leaves us with the euclidean-closest choice
+	if (idx < 0)
+		return best;
+
+	return candidates[idx];
+}
+
+
 int CBuilderCAI::FindReclaimTarget(const float3& pos, float radius, unsigned char cmdopt, ReclaimOption recoptions, float bestStartDist) const
 {
 	const bool noResCheck   = recoptions & REC_NORESCHECK;
@@ -1521,40 +1545,67 @@ int CBuilderCAI::FindReclaimTarget(const float3& pos, float radius, unsigned cha
 		best = NULL;
 		const CTeam* team = teamHandler->Team(owner->team);
 		const std::vector<CFeature*>& features = quadField->GetFeaturesExact(pos, radius, false);
+
+		std::vector<const CSolidObject*> candidates;
 		bool metal = false;
+
 		for (std::vector<CFeature*>::const_iterator fi = features.begin(); fi != features.end(); ++fi) {
 			const CFeature* f = *fi;
 			if (f->def->reclaimable && (recSpecial || f->def->autoreclaim) &&
 				(!recNonRez || !(f->def->destructable && f->udef != NULL))
 			) {
+				if (!(noResCheck ||
+					((f->def->metal  > 0.0f) && (team->res.metal  < team->resStorage.metal)) ||
+					((f->def->energy > 0.0f) && (team->res.energy < team->resStorage.energy)))
+				) {
+					continue;
+				}
+				if (!f->IsInLosForAllyTeam(owner->allyteam)) {
+					continue;
+				}
+				if (!owner->unitDef->canmove && !IsInBuildRange(f)) {
+					continue;
+				}
+				if (!(cmdopt & CONTROL_KEY) && IsFeatureBeingResurrected(f->id, owner)) {
+					continue;
+				}
 				if (recSpecial && metal && f->def->metal <= 0.0) {
 					continue;
 				}
 				const float dist = f3SqDist(f->pos, owner->pos);
-				if ((dist < bestDist || (recSpecial && !metal && f->def->metal > 0.0)) &&
-					(noResCheck ||
-					((f->def->metal  > 0.0f) && (team->res.metal  < team->resStorage.metal)) ||
-					((f->def->energy > 0.0f) && (team->res.energy < team->resStorage.energy)))
-				) {
-					if (!f->IsInLosForAllyTeam(owner->allyteam)) {
-						continue;
-					}
-					if (!owner->unitDef->canmove && !IsInBuildRange(f)) {
-						continue;
-					}
-					if (!(cmdopt & CONTROL_KEY) && IsFeatureBeingResurrected(f->id, owner)) {
-						continue;
-					}
+				if (dist < bestDist || (recSpecial && !metal && f->def->metal > 0.0)) {
 					if (recSpecial && !metal && f->def->metal > 0.0f) {
 						metal = true;
 					}
 					bestDist = dist;
 					best = f;
 				}
+
+				candidates.push_back(f);
 			}
 		}
-		if (best)
+		if (best) {
+			if (recSpecial && metal) {
+				// metal-bearing wrecks take priority, drop the others
+				// from the path-cost re-pick
+				unsigned int numMetal = 0;
+
+				for (unsigned int n = 0; n < candidates.size(); n++) {
+					const CFeature* f = static_cast<const CFeature*>(candidates[n]);
+
+					if (f->def->metal > 0.0f) {
+						candidates[numMetal++] = f;
+					}
+				}
+
+				candidates.resize(numMetal);
+			}
+
+			// among equally eligible wrecks, prefer the one that is
+			// cheapest to actually walk to over the closest-by-air
+			best = FindCheapestPathTarget(candidates, best);
 			rid = unitHandler->MaxUnits() + best->id;
+		}
 	}
 
 	return rid;
@@ -1593,9 +1644,11 @@ bool CBuilderCAI::FindResurrectableFeatureAndResurrect(const float3& pos,
 {
 	const std::vector<CFeature*> &features = quadField->GetFeaturesExact(pos, radius, false);
 
-	const CFeature* best = NULL;
+	const CSolidObject* best = NULL;
 	float bestDist = 1.0e30f;
 
+	std::vector<const CSolidObject*> candidates;
+
 	for (std::vector<CFeature*>::const_iterator fi = features.begin(); fi != features.end(); ++fi) {
 		const CFeature* f = *fi;
 		if (f->def->destructable && f->udef != NULL) {
@@ -1605,21 +1658,27 @@ bool CBuilderCAI::FindResurrectableFeatureAndResurrect(const float3& pos,
 			if (freshOnly && f->reclaimLeft < 1.0f && f->resurrectProgress <= 0.0f) {
 				continue;
 			}
-			float dist = f3SqDist(f->pos, owner->pos);
+			// dont lock-on to units outside of our reach (for immobile builders)
+			if (owner->immobile && !IsInBuildRange(f)) {
+				continue;
+			}
+			if(!(options & CONTROL_KEY) && IsFeatureBeingReclaimed(f->id, owner)) {
+				continue;
+			}
+			const float dist = f3SqDist(f->pos, owner->pos);
 			if (dist < bestDist) {
-				// dont lock-on to units outside of our reach (for immobile builders)
-				if (owner->immobile && !IsInBuildRange(f)) {
-					continue;
-				}
-				if(!(options & CONTROL_KEY) && IsFeatureBeingReclaimed(f->id, owner)) {
-					continue;
-				}
 				bestDist = dist;
 				best = f;
 			}
+
+			candidates.push_back(f);
 		}
 	}
 
+	// among equally resurrectable wrecks, prefer the one that is
+	// cheapest to actually walk to over the closest-by-air
+	best = FindCheapestPathTarget(candidates, best);
+
 	if (best) {
 		Command c2(CMD_RESURRECT, options | INTERNAL_ORDER, unitHandler->MaxUnits() + best->id);
 		commandQue.push_front(c2);
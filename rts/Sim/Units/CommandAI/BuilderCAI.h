@@ -9,6 +9,7 @@
 #include "System/UnorderedSet.hpp"
 
 #include <string>
+#include <vector>
 
 class CUnit;
 class CBuilder;
@@ -106,6 +107,12 @@ private:
 	bool FindCaptureTargetAndCapture(const float3& pos, float radius, unsigned char options, bool healthyOnly);
 
 	int FindReclaimTarget(const float3& pos, float radius, unsigned char cmdopt, ReclaimOption recoptions, float bestStartDist = 1.0e30f) const;
+	/**
+	 * Picks the member of candidates that is cheapest to actually
+	 * walk to with a single multi-goal path search; returns the given
+	 * (euclidean-closest) default when the search is unavailable.
+	 */
+	const CSolidObject* FindCheapestPathTarget(const std::vector<const CSolidObject*>& candidates, const CSolidObject* best) const;
 
 	float GetBuildRange(const float targetRadius) const;
 	bool MoveInBuildRange(const CWorldObject* obj, const bool checkMoveTypeForFailed = false);
@@ -4,13 +4,9 @@
 #define COMMAND_H
 
 #include <string>
+#include <algorithm>
 #include <climits> // for INT_MAX
-
-#ifdef BUILDING_AI
 #include <vector>
-#else
-#include "System/SafeVector.h"
-#endif
 
 #include "System/creg/creg_cond.h"
 #include "System/float3.h"
@@ -160,6 +156,127 @@ extern "C" {
 
 
 
+#ifdef BUILDING_AI
+
+typedef std::vector<float> CommandParamsVector;
+
+#else
+
+/**
+ * Storage for command parameters; the common case of at most four
+ * elements (position, position plus radius, single target id, ...)
+ * is kept inline so constructing and copying a Command causes no
+ * heap traffic, longer parameter lists spill into a plain vector
+ * which then holds *all* elements.
+ *
+ * Out-of-bounds accesses return a reference to a zeroed dummy
+ * element (like safe_vector did) since parameter indices can come
+ * from Lua or over the network.
+ */
+class CommandParamsVector {
+public:
+	typedef float value_type;
+	typedef size_t size_type;
+	typedef float* iterator;
+	typedef const float* const_iterator;
+
+	static const size_type INLINE_PARAMS = 4;
+
+	CommandParamsVector(): numParams(0) {}
+
+	size_type size() const { return numParams; }
+	bool empty() const { return (numParams == 0); }
+
+	float* begin() { return ((numParams <= INLINE_PARAMS)? &inlineParams[0]: &overflowParams[0]); }
+	float* end() { return (begin() + numParams); }
+	const float* begin() const { return ((numParams <= INLINE_PARAMS)? &inlineParams[0]: &overflowParams[0]); }
+	const float* end() const { return (begin() + numParams); }
+
+	float& operator[](size_type i) {
+		if (i >= numParams)
+			return dummy_element();
+		return begin()[i];
+	}
+	const float& operator[](size_type i) const {
+		if (i >= numParams)
+			return dummy_element();
+		return begin()[i];
+	}
+
+	float& at(size_type i) { return (*this)[i]; }
+	const float& at(size_type i) const { return (*this)[i]; }
+
+	void push_back(float v) {
+		if (numParams < INLINE_PARAMS) {
+			inlineParams[numParams++] = v;
+			return;
+		}
+		if (numParams == INLINE_PARAMS)
+			overflowParams.assign(&inlineParams[0], &inlineParams[0] + INLINE_PARAMS);
+
+		overflowParams.push_back(v);
+		numParams++;
+	}
+
+	void clear() {
+		numParams = 0;
+		overflowParams.clear();
+	}
+
+	void resize(size_type n) {
+		if (n > numParams) {
+			while (numParams < n) {
+				push_back(0.0f);
+			}
+			return;
+		}
+
+		if (numParams > INLINE_PARAMS && n <= INLINE_PARAMS) {
+			std::copy(overflowParams.begin(), overflowParams.begin() + n, &inlineParams[0]);
+			overflowParams.clear();
+		} else if (n > INLINE_PARAMS) {
+			overflowParams.resize(n);
+		}
+
+		numParams = n;
+	}
+
+	void reserve(size_type n) {
+		if (n > INLINE_PARAMS)
+			overflowParams.reserve(n);
+	}
+
+private:
+	static float& dummy_element() {
+		static float dummy = 0.0f;
+		// writes to the dummy element are discarded
+		dummy = 0.0f;
+		return dummy;
+	}
+
+	size_type numParams;
+
+	float inlineParams[INLINE_PARAMS];
+	/// holds all parameters whenever numParams > INLINE_PARAMS
+	std::vector<float> overflowParams;
+};
+
+
+#ifdef USING_CREG
+namespace creg {
+	template<>
+	struct DeduceType<CommandParamsVector> {
+		static std::shared_ptr<IType> Get() {
+			return std::shared_ptr<IType>(new DynamicArrayType<CommandParamsVector>(DeduceType<float>::Get()));
+		}
+	};
+}
+#endif // USING_CREG
+
+#endif // BUILDING_AI
+
+
+
 struct Command
 {
 private:
@@ -441,11 +558,7 @@ public:
 	unsigned char options;
 
 	/// command parameters
-	#ifdef BUILDING_AI
-	std::vector<float> params;
-	#else
-	safe_vector<float> params;
-	#endif
+	CommandParamsVector params;
 };
 
 #endif // COMMAND_H
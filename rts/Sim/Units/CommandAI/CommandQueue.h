@@ -24,6 +24,9 @@ class CCommandQueue {
 
 		inline QueueType GetType() const { return queueType; }
 
+		/// bumped on every mutation, lets renderers detect unchanged queues
+		inline unsigned int GetModCounter() const { return modCounter; }
+
 	public:
 		/// limit to a float's integer range
 		static const int maxTagValue = (1 << 24); // 16777216
@@ -48,23 +51,28 @@ class CCommandQueue {
 		inline void pop_back()
 		{
 			queue.pop_back();
+			modCounter++;
 		}
 		inline void pop_front()
 		{
 			queue.pop_front();
+			modCounter++;
 		}
 
 		inline iterator erase(iterator pos)
 		{
+			modCounter++;
 			return queue.erase(pos);
 		}
 		inline iterator erase(iterator first, iterator last)
 		{
+			modCounter++;
 			return queue.erase(first, last);
 		}
 		inline void clear()
 		{
 			queue.clear();
+			modCounter++;
 		}
 
 		inline iterator       end()         { return queue.end(); }
@@ -89,7 +97,7 @@ class CCommandQueue {
 		inline const Command& operator[](size_type i) const { return queue[i]; }
 
 	private:
-		CCommandQueue() : queueType(CommandQueueType), tagCounter(0) {};
+		CCommandQueue() : queueType(CommandQueueType), tagCounter(0), modCounter(0) {};
 		CCommandQueue(const CCommandQueue&);
 		CCommandQueue& operator=(const CCommandQueue&);
 
@@ -101,6 +109,7 @@ class CCommandQueue {
 		std::deque<Command> queue;
 		QueueType queueType;
 		int tagCounter;
+		unsigned int modCounter;
 };
 
 
@@ -118,6 +127,7 @@ inline void CCommandQueue::push_back(const Command& cmd)
 {
 	queue.push_back(cmd);
 	queue.back().tag = GetNextTag();
+	modCounter++;
 }
 
 
@@ -125,6 +135,7 @@ inline void CCommandQueue::push_front(const Command& cmd)
 {
 	queue.push_front(cmd);
 	queue.front().tag = GetNextTag();
+	modCounter++;
 }
 
 
@@ -133,6 +144,7 @@ inline CCommandQueue::iterator CCommandQueue::insert(iterator pos,
 {
 	Command tmpCmd = cmd;
 	tmpCmd.tag = GetNextTag();
+	modCounter++;
 	return queue.insert(pos, tmpCmd);
 }
 
@@ -28,6 +28,9 @@
 #define BUGGER_OFF_TTL 200
 #define MAX_CLOSE_IN_RETRY_TICKS 30
 #define MAX_USERGOAL_TOLERANCE_DIST 100.0f
+// idle units rescan for targets at this rate even without any reported
+// enemy activity nearby (see CQuadField::HasEnemyActivitySince)
+#define IDLE_SCAN_FALLBACK_PERIOD (GAME_SPEED * 5)
 
 #define AIRTRANSPORT_DOCKING_RADIUS 16
 #define AIRTRANSPORT_DOCKING_ANGLE 50
@@ -53,6 +56,7 @@ CR_REG_METADATA(CMobileCAI, (
 	CR_MEMBER(lastUserGoal),
 
 	CR_MEMBER(lastIdleCheck),
+	CR_MEMBER(lastEnemyScanFrame),
 	CR_MEMBER(tempOrder),
 
 	CR_MEMBER(lastPC),
@@ -78,6 +82,7 @@ CMobileCAI::CMobileCAI():
 	lastBuggerGoalPos(-1,0,-1),
 	lastUserGoal(ZeroVector),
 	lastIdleCheck(0),
+	lastEnemyScanFrame(0),
 	tempOrder(false),
 	lastPC(-1),
 	lastBuggerOffTime(-BUGGER_OFF_TTL),
@@ -98,6 +103,7 @@ CMobileCAI::CMobileCAI(CUnit* owner):
 	lastBuggerGoalPos(-1,0,-1),
 	lastUserGoal(owner->pos),
 	lastIdleCheck(0),
+	lastEnemyScanFrame(0),
 	tempOrder(false),
 	lastPC(-1),
 	lastBuggerOffTime(-BUGGER_OFF_TTL),
@@ -1095,24 +1101,38 @@ bool CMobileCAI::GenerateAttackCmd()
 		if (newAttackTargetId < 0 &&
 		    owner->fireState >= FIRESTATE_FIREATWILL && (gs->frameNum >= lastIdleCheck + 10)
 		) {
-			//Try getting target from weapons
-			for (CWeapon* w: owner->weapons) {
-				if (w->HaveTarget() || w->AutoTarget()) {
-					const auto t = w->GetCurrentTarget();
-					if (t.type == Target_Unit && IsValidTarget(t.unit)) {
-						newAttackTargetId = t.unit->id;
-						break;
+			const float searchRadius = owner->maxRange + 150.0f * owner->moveState * owner->moveState;
+
+			// event-assisted idle scanning; while no enemy has entered
+			// or crossed our neighbourhood since the last unsuccessful
+			// scan there is nothing new to find, so idle armies only
+			// pay for the slow fallback rescan (which catches enemies
+			// that became targetable without moving: decloak, LOS
+			// gained by a third unit, being unloaded in place, ...)
+			const bool regionActive = quadField->HasEnemyActivitySince(owner->pos, searchRadius, owner->allyteam, lastEnemyScanFrame);
+			const bool fallbackScan = (gs->frameNum >= (lastEnemyScanFrame + IDLE_SCAN_FALLBACK_PERIOD));
+
+			if (regionActive || fallbackScan) {
+				lastEnemyScanFrame = gs->frameNum;
+
+				//Try getting target from weapons
+				for (CWeapon* w: owner->weapons) {
+					if (w->HaveTarget() || w->AutoTarget()) {
+						const auto t = w->GetCurrentTarget();
+						if (t.type == Target_Unit && IsValidTarget(t.unit)) {
+							newAttackTargetId = t.unit->id;
+							break;
+						}
 					}
 				}
-			}
 
-			//Get target from wherever
-			if (newAttackTargetId < 0) {
-				const float searchRadius = owner->maxRange + 150.0f * owner->moveState * owner->moveState;
-				const CUnit* enemy = CGameHelper::GetClosestValidTarget(owner->pos, searchRadius, owner->allyteam, this);
+				//Get target from wherever
+				if (newAttackTargetId < 0) {
+					const CUnit* enemy = CGameHelper::GetClosestValidTarget(owner->pos, searchRadius, owner->allyteam, this);
 
-				if (enemy != nullptr) {
-					newAttackTargetId = enemy->id;
+					if (enemy != nullptr) {
+						newAttackTargetId = enemy->id;
+					}
 				}
 			}
 		}
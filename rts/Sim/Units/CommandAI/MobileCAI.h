@@ -78,6 +78,9 @@ public:
 	float3 lastUserGoal;
 
 	int lastIdleCheck;
+	/// frame of the last idle-attack enemy scan; scans are skipped
+	/// while the quadfield reports no enemy activity near us since
+	int lastEnemyScanFrame;
 	bool tempOrder;
 
 	/// helps avoid infinate loops
@@ -3,6 +3,7 @@
 
 #include "CobEngine.h"
 #include "CobThread.h"
+#include "CobThreadMemPool.h"
 #include "CobFile.h"
 #include "System/FileSystem/FileHandler.h"
 
@@ -10,6 +11,8 @@
 CCobEngine* cobEngine = nullptr;
 CCobFileHandler* cobFileHandler = nullptr;
 
+CobThreadMemPool cobThreadMemPool;
+
 
 /******************************************************************************/
 /******************************************************************************/
@@ -18,11 +21,13 @@ CR_BIND(CCobEngine, )
 
 CR_REG_METADATA(CCobEngine, (
 	CR_MEMBER(currentTime),
+	CR_MEMBER(currentSlot),
 	CR_MEMBER(running),
 	CR_MEMBER(sleeping),
 
 	//always null/empty when saving
 	CR_IGNORED(wantToRun),
+	CR_IGNORED(waking),
 	CR_IGNORED(curThread)
 ))
 
@@ -30,6 +35,7 @@ CR_REG_METADATA(CCobEngine, (
 CCobEngine::CCobEngine()
 	: curThread(nullptr)
 	, currentTime(0)
+	, currentSlot(0)
 
 { }
 
@@ -41,17 +47,24 @@ CCobEngine::~CCobEngine()
 		while (!running.empty()) {
 			CCobThread* tmp = running.back();
 			running.pop_back();
-			delete tmp;
+			cobThreadMemPool.free(tmp);
 		}
 		while (!wantToRun.empty()) {
 			CCobThread* tmp = wantToRun.back();
 			wantToRun.pop_back();
-			delete tmp;
+			cobThreadMemPool.free(tmp);
 		}
 		while (!sleeping.empty()) {
-			CCobThread* tmp = sleeping.top();
-			sleeping.pop();
-			delete tmp;
+			// swap the bucket out first; dtor callbacks may
+			// add new threads and thereby mutate the map
+			waking.swap(sleeping.begin()->second);
+			sleeping.erase(sleeping.begin()->first);
+
+			while (!waking.empty()) {
+				CCobThread* tmp = waking.back();
+				waking.pop_back();
+				cobThreadMemPool.free(tmp);
+			}
 		}
 		// callbacks may add new threads
 	} while (!running.empty() || !wantToRun.empty() || !sleeping.empty());
@@ -75,7 +88,7 @@ void CCobEngine::AddThread(CCobThread *thread)
 			wantToRun.push_back(thread);
 			break;
 		case CCobThread::Sleep:
-			sleeping.push(thread);
+			sleeping[thread->GetWakeTime() >> SLOT_SHIFT].push_back(thread);
 			break;
 		default:
 			LOG_L(L_ERROR, "thread added to scheduler with unknown state (%d)", thread->state);
@@ -89,7 +102,7 @@ void CCobEngine::TickThread(CCobThread* thread)
 	curThread = thread; // for error messages originating in CUnitScript
 
 	if (!thread->Tick())
-		delete thread;
+		cobThreadMemPool.free(thread);
 
 	curThread = nullptr;
 }
@@ -114,13 +127,29 @@ void CCobEngine::Tick(int deltaTime)
 	// The threads that just ran may have added new threads that should run next tick
 	std::swap(running, wantToRun);
 
-	//Check on the sleeping threads
-	if (!sleeping.empty()) {
-		CCobThread* cur = sleeping.top();
+	//Check on the sleeping threads, only the buckets of elapsed slots can hold any
+	const int lastDueSlot = currentTime >> SLOT_SHIFT;
+
+	for (int slot = currentSlot; slot <= lastDueSlot; slot++) {
+		const auto bucketIt = sleeping.find(slot);
+
+		if (bucketIt == sleeping.end())
+			continue;
+
+		// swap the bucket out before waking anything; woken threads can
+		// add new sleepers and thereby mutate the map under our feet
+		waking.swap(bucketIt->second);
+		sleeping.erase(slot);
 
-		while ((cur != nullptr) && (cur->GetWakeTime() < currentTime)) {
-			// Start with removing the executing thread from the queue
-			sleeping.pop();
+		while (!waking.empty()) {
+			CCobThread* cur = waking.back();
+			waking.pop_back();
+
+			// only possible in the newest (still partial) slot
+			if (cur->GetWakeTime() >= currentTime) {
+				sleeping[slot].push_back(cur);
+				continue;
+			}
 
 			//Run forward again. This can quite possibly readd the thread to the sleeping array again
 			//But it will not interfere since it is guaranteed to sleep > 0 ms
@@ -129,17 +158,14 @@ void CCobEngine::Tick(int deltaTime)
 				cur->state = CCobThread::Run;
 				TickThread(cur);
 			} else if (cur->state == CCobThread::Dead) {
-				delete cur;
+				cobThreadMemPool.free(cur);
 			} else {
 				LOG_L(L_ERROR, "Sleeping thread strange state %d", cur->state);
 			}
-
-			if (!sleeping.empty())
-				cur = sleeping.top();
-			else
-				cur = nullptr;
 		}
 	}
+
+	currentSlot = lastDueSlot;
 }
 
 
@@ -14,7 +14,7 @@
 #include "CobThread.h"
 #include "System/creg/creg_cond.h"
 
-#include "System/creg/STL_Queue.h"
+#include "System/creg/STL_Map.h"
 #include "System/UnorderedMap.hpp"
 
 
@@ -23,27 +23,33 @@ class CCobInstance;
 class CCobFile;
 
 
-class CCobThreadPtr_less : public std::binary_function<CCobThread*, CCobThread*, bool> {
-public:
-	bool operator() (const CCobThread* const& a, const CCobThread* const& b) const {
-		return a->GetWakeTime() > b->GetWakeTime();
-	}
-};
-
-
 class CCobEngine
 {
 	CR_DECLARE_STRUCT(CCobEngine)
 protected:
+	/// two-exponent of the wakeup-slot width (in milliseconds)
+	static const int SLOT_SHIFT = 5;
+
 	std::vector<CCobThread*> running;
 	/**
 	 * Threads are added here if they are in Running.
 	 * And moved to real running after running is empty.
 	 */
 	std::vector<CCobThread*> wantToRun;
-	std::priority_queue<CCobThread*, std::vector<CCobThread*>, CCobThreadPtr_less> sleeping;
+	/**
+	 * Sleeping threads, bucketed by wakeup slot (wake-time divided by
+	 * the slot width). Advancing the clock only inspects the buckets of
+	 * the slots that actually elapsed, so per-tick scheduling cost is
+	 * proportional to the number of threads waking up rather than to
+	 * the whole sleeping population.
+	 */
+	spring::unordered_map<int, std::vector<CCobThread*> > sleeping;
+	/// scratch buffer holding the bucket currently being woken
+	std::vector<CCobThread*> waking;
 	CCobThread* curThread;
 	int currentTime;
+	/// first wakeup slot that has not been fully processed yet
+	int currentSlot;
 	void TickThread(CCobThread* thread);
 public:
 	CCobEngine();
@@ -186,17 +186,21 @@ CCobFile::CCobFile(CFileHandler& in, const std::string& scriptName)
 
 
 	// create a reverse mapping (name->int)
+	scriptMap.reserve(scriptNames.size());
+
 	for (unsigned int i = 0; i < scriptNames.size(); ++i) {
 		scriptMap[scriptNames[i]] = i;
 	}
 
-	// map common function names to indices
-	const spring::unordered_map<std::string, int>& nameMap = CCobUnitScriptNames::GetScriptMap();
+	// map common function names to indices; resolve the entry-points
+	// this script actually defines instead of probing it for every
+	// name the engine knows (COBFN_Last + 16 weapon slots worth, an
+	// order of magnitude more than a typical script contains)
+	for (unsigned int i = 0; i < scriptNames.size(); ++i) {
+		const int fn = CCobUnitScriptNames::GetScriptNumber(scriptNames[i]);
 
-	for (auto it = nameMap.begin(); it != nameMap.end(); ++it) {
-		const int fn = GetFunctionId(it->first);
 		if (fn >= 0) {
-			scriptIndex[it->second] = fn;
+			scriptIndex[fn] = i;
 		}
 	}
 }
@@ -5,6 +5,7 @@
 #include "CobFile.h"
 #include "CobInstance.h"
 #include "CobThread.h"
+#include "CobThreadMemPool.h"
 
 #include "Game/GameHelper.h"
 #include "Game/GlobalUnsynced.h"
@@ -103,7 +104,7 @@ CCobInstance::~CCobInstance()
 		CCobThread* t = threads.back();
 		t->owner = nullptr;
 		if (t->IsWaiting()) {
-			delete t;
+			cobThreadMemPool.free(t);
 		} else {
 			t->state = CCobThread::Dead;
 		}
@@ -487,7 +488,7 @@ int CCobInstance::RealCall(int functionId, vector<int>& args, ThreadCallbackType
 	}
 
 
-	CCobThread* thread = new CCobThread(this);
+	CCobThread* thread = cobThreadMemPool.alloc<CCobThread>(this);
 	thread->Start(functionId, args, false);
 
 	//LOG_L(L_DEBUG, "Calling %s:%s", script->name.c_str(), script->scriptNames[functionId].c_str());
@@ -518,7 +519,7 @@ int CCobInstance::RealCall(int functionId, vector<int>& args, ThreadCallbackType
 		// dtor runs the callback
 		if (retCode != nullptr)
 			*retCode = thread->GetRetCode();
-		delete thread;
+		cobThreadMemPool.free(thread);
 		return 0;
 	}
 
@@ -2,6 +2,7 @@
 
 
 #include "CobThread.h"
+#include "CobThreadMemPool.h"
 #include "CobFile.h"
 #include "CobInstance.h"
 #include "CobEngine.h"
@@ -10,7 +11,7 @@
 
 #include <sstream>
 
-CR_BIND(CCobThread, )
+CR_BIND_POOL(CCobThread, , cobThreadMemPool.alloc, cobThreadMemPool.free)
 
 CR_REG_METADATA(CCobThread, (
 	CR_MEMBER(owner),
@@ -26,6 +27,7 @@ CR_REG_METADATA(CCobThread, (
 	CR_MEMBER(signalMask),
 	CR_MEMBER(luaArgs),
 	CR_MEMBER(stack),
+	CR_MEMBER(stackSize),
 	CR_MEMBER(callStack)
 ))
 
@@ -46,6 +48,7 @@ CCobThread::CCobThread(CCobInstance* owner)
 	: owner(owner)
 	, wakeTime(0)
 	, PC(0)
+	, stackSize(0)
 	, paramCount(0)
 	, retCode(-1)
 	, cbType(CCobInstance::CBNone)
@@ -56,6 +59,7 @@ CCobThread::CCobThread(CCobInstance* owner)
 	, signalMask(0)
 {
 	memset(&luaArgs[0], 0, MAX_LUA_COB_ARGS * sizeof(luaArgs[0]));
+	memset(&stack[0], 0, MAX_STACK_SLOTS * sizeof(stack[0]));
 	owner->threads.push_back(this);
 }
 
@@ -92,7 +96,8 @@ void CCobThread::Start(int functionId, const vector<int>& args, bool schedule)
 	paramCount = args.size();
 
 	// copy arguments
-	stack = args;
+	stackSize = std::min(int(args.size()), MAX_STACK_SLOTS);
+	std::copy(args.begin(), args.begin() + stackSize, &stack[0]);
 
 	// Add to scheduler
 	if (schedule)
@@ -106,18 +111,18 @@ const string& CCobThread::GetName()
 
 int CCobThread::CheckStack(unsigned int size, bool warn)
 {
-	if (size <= stack.size())
+	if (int(size) <= stackSize)
 		return size;
 
 	if (warn) {
 		static char msg[512];
 		static const char* fmt =
-			"stack-size mismatch: need %u but have %lu arguments "
+			"stack-size mismatch: need %u but have %d arguments "
 			"(too many passed to function or too few returned?)";
-		SNPRINTF(msg, sizeof(msg), fmt, size, stack.size());
+		SNPRINTF(msg, sizeof(msg), fmt, size, stackSize);
 		ShowError(msg);
 	}
-	return stack.size();
+	return stackSize;
 }
 
 int CCobThread::GetStackVal(int pos)
@@ -223,21 +228,28 @@ const int DROP   = 0x10084000;
 #define LUA9 119
 
 
-// Handy macros
-#define GET_LONG_PC() (owner->script->code[PC++])
-// #define POP() (stack.size() > 0) ? stack.back(), stack.pop_back(); : 0
+// Handy macros; GET_LONG_PC reads through a locally cached code
+// pointer so the hot loop does not chase owner->script every word
+#define GET_LONG_PC() (cobCode[PC++])
 
 int CCobThread::POP()
 {
-	if (!stack.empty()) {
-		int r = stack.back();
-		stack.pop_back();
-		return r;
-	}
+	if (stackSize > 0)
+		return stack[--stackSize];
 
 	return 0;
 }
 
+void CCobThread::PUSH(int v)
+{
+	if (stackSize < MAX_STACK_SLOTS) {
+		stack[stackSize++] = v;
+		return;
+	}
+
+	ShowError("stack overflow");
+}
+
 bool CCobThread::Tick()
 {
 	if (state == Sleep) {
@@ -251,6 +263,11 @@ bool CCobThread::Tick()
 
 	int r1, r2, r3, r4, r5, r6;
 
+	// cached for GET_LONG_PC; the code vector is never resized after
+	// load, so the pointer stays valid across the self-modifying CALL
+	// patch below (which writes through owner->script)
+	const int* cobCode = owner->script->code.data();
+
 	vector<int> args;
 	vector<int>::iterator ei;
 
@@ -271,7 +288,7 @@ bool CCobThread::Tick()
 		switch(opcode) {
 			case PUSH_CONSTANT:
 				r1 = GET_LONG_PC();
-				stack.push_back(r1);
+				PUSH(r1);
 				break;
 			case SLEEP:
 				r1 = POP();
@@ -305,9 +322,7 @@ bool CCobThread::Tick()
 				}
 
 				PC = callStack.back().returnAddr;
-				while (stack.size() > callStack.back().stackTop) {
-					stack.pop_back();
-				}
+				stackSize = std::min(stackSize, callStack.back().stackTop);
 				callStack.pop_back();
 				//LOG_L(L_DEBUG, "Returning to %s", owner->script->scriptNames[callStack.back().functionId].c_str());
 				break;
@@ -348,7 +363,7 @@ bool CCobThread::Tick()
 				CallInfo ci;
 				ci.functionId = r1;
 				ci.returnAddr = PC;
-				ci.stackTop = stack.size() - r2;
+				ci.stackTop = stackSize - r2;
 				callStack.push_back(ci);
 				paramCount = r2;
 
@@ -383,7 +398,7 @@ bool CCobThread::Tick()
 					args.push_back(r4);
 				}
 
-				CCobThread* thread = new CCobThread(owner);
+				CCobThread* thread = cobThreadMemPool.alloc<CCobThread>(owner);
 				thread->Start(r1, args, true);
 
 				// Seems that threads should inherit signal mask from creator
@@ -392,7 +407,7 @@ bool CCobThread::Tick()
 			} break;
 			case CREATE_LOCAL_VAR:
 				if (paramCount == 0) {
-					stack.push_back(0);
+					PUSH(0);
 				} else {
 					paramCount--;
 				}
@@ -400,11 +415,11 @@ bool CCobThread::Tick()
 			case GET_UNIT_VALUE:
 				r1 = POP();
 				if ((r1 >= LUA0) && (r1 <= LUA9)) {
-					stack.push_back(luaArgs[r1 - LUA0]);
+					PUSH(luaArgs[r1 - LUA0]);
 					break;
 				}
 				r1 = owner->GetUnitVal(r1, 0, 0, 0, 0);
-				stack.push_back(r1);
+				PUSH(r1);
 				break;
 			case JUMP_NOT_EQUAL:
 				r1 = GET_LONG_PC();
@@ -427,34 +442,34 @@ bool CCobThread::Tick()
 			case PUSH_LOCAL_VAR:
 				r1 = GET_LONG_PC();
 				r2 = stack[callStack.back().stackTop + r1];
-				stack.push_back(r2);
+				PUSH(r2);
 				break;
 			case SET_LESS_OR_EQUAL:
 				r2 = POP();
 				r1 = POP();
 				if (r1 <= r2)
-					stack.push_back(1);
+					PUSH(1);
 				else
-					stack.push_back(0);
+					PUSH(0);
 				break;
 			case BITWISE_AND:
 				r1 = POP();
 				r2 = POP();
-				stack.push_back(r1 & r2);
+				PUSH(r1 & r2);
 				break;
 			case BITWISE_OR: // seems to want stack contents or'd, result places on stack
 				r1 = POP();
 				r2 = POP();
-				stack.push_back(r1 | r2);
+				PUSH(r1 | r2);
 				break;
 			case BITWISE_XOR:
 				r1 = POP();
 				r2 = POP();
-				stack.push_back(r1 ^ r2);
+				PUSH(r1 ^ r2);
 				break;
 			case BITWISE_NOT:
 				r1 = POP();
-				stack.push_back(~r1);
+				PUSH(~r1);
 				break;
 			case EXPLODE:
 				r1 = GET_LONG_PC();
@@ -468,54 +483,54 @@ bool CCobThread::Tick()
 				break;
 			case PUSH_STATIC:
 				r1 = GET_LONG_PC();
-				stack.push_back(owner->staticVars[r1]);
+				PUSH(owner->staticVars[r1]);
 				//LOG_L(L_DEBUG, "Push static %d val %d", r1, owner->staticVars[r1]);
 				break;
 			case SET_NOT_EQUAL:
 				r1 = POP();
 				r2 = POP();
 				if (r1 != r2)
-					stack.push_back(1);
+					PUSH(1);
 				else
-					stack.push_back(0);
+					PUSH(0);
 				break;
 			case SET_EQUAL:
 				r1 = POP();
 				r2 = POP();
 				if (r1 == r2)
-					stack.push_back(1);
+					PUSH(1);
 				else
-					stack.push_back(0);
+					PUSH(0);
 				break;
 			case SET_LESS:
 				r2 = POP();
 				r1 = POP();
 				if (r1 < r2)
-					stack.push_back(1);
+					PUSH(1);
 				else
-					stack.push_back(0);
+					PUSH(0);
 				break;
 			case SET_GREATER:
 				r2 = POP();
 				r1 = POP();
 				if (r1 > r2)
-					stack.push_back(1);
+					PUSH(1);
 				else
-					stack.push_back(0);
+					PUSH(0);
 				break;
 			case SET_GREATER_OR_EQUAL:
 				r2 = POP();
 				r1 = POP();
 				if (r1 >= r2)
-					stack.push_back(1);
+					PUSH(1);
 				else
-					stack.push_back(0);
+					PUSH(0);
 				break;
 			case RAND:
 				r2 = POP();
 				r1 = POP();
 				r3 = gsRNG.NextInt(r2 - r1 + 1) + r1;
-				stack.push_back(r3);
+				PUSH(r3);
 				break;
 			case EMIT_SFX:
 				r1 = POP();
@@ -525,7 +540,7 @@ bool CCobThread::Tick()
 			case MUL:
 				r1 = POP();
 				r2 = POP();
-				stack.push_back(r1 * r2);
+				PUSH(r1 * r2);
 				break;
 			case SIGNAL:
 				r1 = POP();
@@ -550,22 +565,22 @@ bool CCobThread::Tick()
 				r2 = POP();
 				r1 = POP();
 				if ((r1 >= LUA0) && (r1 <= LUA9)) {
-					stack.push_back(luaArgs[r1 - LUA0]);
+					PUSH(luaArgs[r1 - LUA0]);
 					break;
 				}
 				r6 = owner->GetUnitVal(r1, r2, r3, r4, r5);
-				stack.push_back(r6);
+				PUSH(r6);
 				break;
 			case ADD:
 				r2 = POP();
 				r1 = POP();
-				stack.push_back(r1 + r2);
+				PUSH(r1 + r2);
 				break;
 			case SUB:
 				r2 = POP();
 				r1 = POP();
 				r3 = r1 - r2;
-				stack.push_back(r3);
+				PUSH(r3);
 				break;
 			case DIV:
 				r2 = POP();
@@ -576,15 +591,15 @@ bool CCobThread::Tick()
 					r3 = 1000; // infinity!
 					ShowError("division by zero");
 				}
-				stack.push_back(r3);
+				PUSH(r3);
 				break;
 			case MOD:
 				r2 = POP();
 				r1 = POP();
 				if (r2 != 0)
-					stack.push_back(r1 % r2);
+					PUSH(r1 % r2);
 				else {
-					stack.push_back(0);
+					PUSH(0);
 					ShowError("modulo division by zero");
 				}
 				break;
@@ -653,33 +668,33 @@ bool CCobThread::Tick()
 			case LOGICAL_NOT: // Like bitwise, but only on values 1 and 0.
 				r1 = POP();
 				if (r1 == 0)
-					stack.push_back(1);
+					PUSH(1);
 				else
-					stack.push_back(0);
+					PUSH(0);
 				break;
 			case LOGICAL_AND:
 				r1 = POP();
 				r2 = POP();
 				if (r1 && r2)
-					stack.push_back(1);
+					PUSH(1);
 				else
-					stack.push_back(0);
+					PUSH(0);
 				break;
 			case LOGICAL_OR:
 				r1 = POP();
 				r2 = POP();
 				if (r1 || r2)
-					stack.push_back(1);
+					PUSH(1);
 				else
-					stack.push_back(0);
+					PUSH(0);
 				break;
 			case LOGICAL_XOR:
 				r1 = POP();
 				r2 = POP();
 				if ( (!!r1) ^ (!!r2))
-					stack.push_back(1);
+					PUSH(1);
 				else
-					stack.push_back(0);
+					PUSH(0);
 				break;
 			case HIDE:
 				r1 = GET_LONG_PC();
@@ -815,11 +830,13 @@ string CCobThread::GetOpcodeName(int opcode)
 
 void CCobThread::LuaCall()
 {
+	const int* cobCode = owner->script->code.data();
+
 	const int r1 = GET_LONG_PC(); // script id
 	const int r2 = GET_LONG_PC(); // arg count
 
 	// setup the parameter array
-	const int size = (int) stack.size();
+	const int size = stackSize;
 	const int argCount = std::min(r2, MAX_LUA_COB_ARGS);
 	const int start = std::max(0, size - r2);
 	const int end = std::min(size, start + argCount);
@@ -828,11 +845,7 @@ void CCobThread::LuaCall()
 		luaArgs[a] = stack[i];
 		a++;
 	}
-	if (r2 >= size) {
-		stack.clear();
-	} else {
-		stack.resize(size - r2);
-	}
+	stackSize = std::max(0, size - r2);
 
 	if (!luaRules) {
 		luaArgs[0] = 0; // failure
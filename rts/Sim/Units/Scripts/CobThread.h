@@ -63,16 +63,24 @@ public:
 	int GetRetCode() const { return retCode; }
 	bool IsWaiting() const { return (waitAxis != -1); }
 
+	/// fixed stack depth; real-world scripts stay in the low dozens
+	static const int MAX_STACK_SLOTS = 256;
+
 	CCobInstance* owner;
 protected:
 	std::string GetOpcodeName(int opcode);
 	void LuaCall();
 
 	inline int POP();
+	inline void PUSH(int v);
 
 	int wakeTime;
 	int PC;
-	vector<int> stack;
+	// inline stack; stackSize indexes one past the topmost value
+	// (a plain array avoids the per-opcode push_back/pop_back churn
+	// that used to dominate Tick on animation-heavy frames)
+	int stack[MAX_STACK_SLOTS];
+	int stackSize;
 	//vector<int> execTrace;
 
 	int paramCount;
@@ -0,0 +1,13 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef COB_THREAD_MEMPOOL_H
+#define COB_THREAD_MEMPOOL_H
+
+#include "CobThread.h"
+#include "Sim/Misc/SimObjectMemPool.h"
+
+typedef DynMemPool<sizeof(CCobThread)> CobThreadMemPool;
+
+extern CobThreadMemPool cobThreadMemPool;
+
+#endif
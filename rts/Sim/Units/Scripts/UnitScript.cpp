@@ -172,24 +172,6 @@ bool CUnitScript::DoSpin(float& cur, float dest, float& speed, float accel, int
 
 
 
-void CUnitScript::TickAnims(int tickRate, const TickAnimFunc& tickAnimFunc, AnimContainerType& liveAnims, AnimContainerType& doneAnims) {
-	for (size_t i = 0; i < liveAnims.size(); ) {
-		AnimInfo& ai = liveAnims[i];
-		LocalModelPiece& lmp = *pieces[ai.piece];
-
-		if ((ai.done |= (this->*tickAnimFunc)(tickRate, lmp, ai))) {
-			if (ai.hasWaiting)
-				doneAnims.push_back(ai);
-
-			ai = liveAnims.back();
-			liveAnims.pop_back();
-			continue;
-		}
-
-		++i;
-	}
-}
-
 /**
  * @brief Called by the engine when we are registered as animating.
           If we return false there are no active animations left.
@@ -201,12 +183,12 @@ bool CUnitScript::Tick(int deltaTime)
 	// vector of indexes of finished animations,
 	// so we can get rid of them in constant time
 	static AnimContainerType doneAnims[AMove + 1];
-	// tick-functions; these never change address
-	static constexpr TickAnimFunc tickAnimFuncs[AMove + 1] = {&CUnitScript::TickTurnAnim, &CUnitScript::TickSpinAnim, &CUnitScript::TickMoveAnim};
 
-	for (int animType = ATurn; animType <= AMove; animType++) {
-		TickAnims(1000 / deltaTime, tickAnimFuncs[animType], anims[animType], doneAnims[animType]);
-	}
+	const int tickRate = 1000 / deltaTime;
+
+	TickAnims<&CUnitScript::TickTurnAnim>(tickRate, anims[ATurn], doneAnims[ATurn]);
+	TickAnims<&CUnitScript::TickSpinAnim>(tickRate, anims[ASpin], doneAnims[ASpin]);
+	TickAnims<&CUnitScript::TickMoveAnim>(tickRate, anims[AMove], doneAnims[AMove]);
 
 	// Tell listeners to unblock, and remove finished animations from the unit/script.
 	for (int animType = ATurn; animType <= AMove; animType++) {
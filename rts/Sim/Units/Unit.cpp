@@ -99,7 +99,7 @@ CUnit::CUnit()
 , script(nullptr)
 
 , los(ILosType::LOS_TYPE_COUNT, nullptr)
-, losStatus(teamHandler->ActiveAllyTeams(), 0)
+, losStatus(nullptr)
 
 , deathSpeed(ZeroVector)
 , lastMuzzleFlameDir(UpVector)
@@ -196,6 +196,7 @@ CUnit::CUnit()
 , isSelected(false)
 , isIcon(false)
 , iconRadius(0.0f)
+, drawIdx(0)
 , lastUnitUpdate(0)
 , group(nullptr)
 , myTrack(nullptr)
@@ -489,6 +490,9 @@ void CUnit::PostInit(const CUnit* builder)
 
 void CUnit::PostLoad()
 {
+	// the status data itself is saved (and loaded) by unitHandler
+	losStatus = unitHandler->GetUnitLosStatus(id);
+
 	blockMap = (unitDef->GetYardMap()).data();
 
 	if (unitDef->windGenerator > 0.0f)
@@ -648,7 +652,7 @@ void CUnit::ForcedMove(const float3& newPos)
 float3 CUnit::GetErrorVector(int argAllyTeam) const
 {
 	// LuaHandle without full read access
-	if (argAllyTeam < 0 || argAllyTeam >= losStatus.size())
+	if (argAllyTeam < 0 || argAllyTeam >= teamHandler->ActiveAllyTeams())
 		return (posErrorVector * losHandler->GetBaseRadarErrorSize() * 2.0f);
 
 	// it's one of our own, or it's in LOS, so don't add an error
@@ -1617,17 +1621,15 @@ void CUnit::ChangeTeamReset()
 	// stop friendly units shooting at us
 	std::vector<CUnit*> alliedunits;
 
-	for (const auto& objs: GetAllListeners()) {
-		for (CObject* obj: objs) {
-			CUnit* u = dynamic_cast<CUnit*>(obj);
+	for (const auto& l: GetAllListeners()) {
+		CUnit* u = dynamic_cast<CUnit*>(l.obj);
 
-			if (u == nullptr)
-				continue;
-			if (!teamHandler->AlliedTeams(team, u->team))
-				continue;
+		if (u == nullptr)
+			continue;
+		if (!teamHandler->AlliedTeams(team, u->team))
+			continue;
 
-			alliedunits.push_back(u);
-		}
+		alliedunits.push_back(u);
 	}
 	for (auto ui = alliedunits.cbegin(); ui != alliedunits.cend(); ++ui) {
 		(*ui)->StopAttackingAllyTeam(allyteam);
@@ -2831,7 +2833,7 @@ CR_REG_METADATA(CUnit, (
 
 	CR_MEMBER(weapons),
 	CR_IGNORED(los),
-	CR_MEMBER(losStatus),
+	CR_IGNORED(losStatus), // points into unitHandler's block, rebound in PostLoad
 	CR_MEMBER(quads),
 
 
@@ -2961,6 +2963,7 @@ CR_REG_METADATA(CUnit, (
 	CR_MEMBER_UN(isSelected),
 	CR_MEMBER_UN(isIcon),
 	CR_MEMBER(iconRadius),
+	CR_MEMBER_UN(drawIdx),
 
 	CR_MEMBER(lastUnitUpdate),
 
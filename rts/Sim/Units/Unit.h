@@ -304,8 +304,10 @@ public:
 	/// which squares the unit can currently observe
 	std::vector<SLosInstance*> los;
 
-	/// indicate the los/radar status the allyteam has on this unit
-	std::vector<unsigned short> losStatus;
+	/// indicate the los/radar status each allyteam has on this unit;
+	/// points into CUnitHandler's dense per-id status block so the
+	/// per-frame status scan does not have to touch every CUnit
+	unsigned short* losStatus;
 
 	/// quads the unit is part of
 	std::vector<int> quads;
@@ -531,6 +533,9 @@ public:
 	bool isIcon;
 	float iconRadius;
 
+	/// index into CUnitDrawer's batched-culling arrays
+	unsigned int drawIdx;
+
 	unsigned int lastUnitUpdate;
 
 	std::string tooltip;
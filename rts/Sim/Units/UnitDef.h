@@ -26,9 +26,6 @@ struct UnitDefWeapon {
 	UnitDefWeapon(const WeaponDef* weaponDef, const LuaTable& weaponTable);
 	UnitDefWeapon(const UnitDefWeapon& udw) { *this = udw; }
 
-	// unused
-	std::string name;
-
 	const WeaponDef* def;
 	int slavedTo;
 
@@ -1,5 +1,6 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
+#include <algorithm>
 #include <cassert>
 
 #include "UnitHandler.h"
@@ -11,10 +12,13 @@
 #include "UnitTypes/Factory.h"
 
 #include "CommandAI/BuilderCAI.h"
+#include "Sim/Misc/GlobalConstants.h"
 #include "Sim/Misc/GlobalSynced.h"
+#include "Sim/Misc/LosHandler.h"
 #include "Sim/Misc/TeamHandler.h"
 #include "Sim/MoveTypes/MoveType.h"
 #include "Sim/Weapons/Weapon.h"
+#include "Sim/Weapons/WeaponMemPool.h"
 #include "System/EventHandler.h"
 #include "System/Log/ILog.h"
 #include "System/myMath.h"
@@ -33,7 +37,13 @@ CR_REG_METADATA(CUnitHandler, (
 	CR_MEMBER(builderCAIs),
 	CR_MEMBER(idPool),
 	CR_MEMBER(unitsToBeRemoved),
-	CR_MEMBER(activeSlowUpdateUnit),
+	CR_MEMBER(slowUpdateSlots),
+	CR_MEMBER(slowUpdateSlotCosts),
+	CR_MEMBER(unitSlowUpdateSlot),
+	CR_MEMBER(unitLosStatus),
+	CR_MEMBER(unitLosPositions),
+	CR_MEMBER(unitLosFlags),
+	CR_IGNORED(losChangedAreas),
 	CR_MEMBER(activeUpdateUnit),
 	CR_MEMBER(maxUnits),
 	CR_MEMBER(maxUnitRadius)
@@ -102,7 +112,14 @@ CUnitHandler::CUnitHandler():
 	// (furthermore all id's are treated equally, none have special status)
 	idPool.Expand(0, units.size());
 
-	activeSlowUpdateUnit = 0;
+	slowUpdateSlots.resize(UNIT_SLOWUPDATE_RATE);
+	slowUpdateSlotCosts.resize(UNIT_SLOWUPDATE_RATE, 0.0f);
+	unitSlowUpdateSlot.resize(maxUnits, -1);
+
+	unitLosStatus.resize(maxUnits * teamHandler->ActiveAllyTeams(), 0);
+	unitLosPositions.resize(maxUnits, -OnesVector);
+	unitLosFlags.resize(maxUnits, 0);
+
 	activeUpdateUnit = 0;
 }
 
@@ -142,13 +159,24 @@ void CUnitHandler::InsertActiveUnit(CUnit* unit)
 	assert(insertionPos >= 0 && insertionPos <= activeUnits.size());
 	activeUnits.insert(activeUnits.begin() + insertionPos, unit);
 
-	if (insertionPos <= activeSlowUpdateUnit)
-		++activeSlowUpdateUnit;
-
 	if (insertionPos <= activeUpdateUnit)
 		++activeUpdateUnit;
 
 	units[unit->id] = unit;
+
+	// bind the unit's slice of the dense los-status block, clearing
+	// whatever a previous holder of this id left behind in it
+	unit->losStatus = GetUnitLosStatus(unit->id);
+	std::fill(unit->losStatus, unit->losStatus + teamHandler->ActiveAllyTeams(), 0);
+
+	// force a full status evaluation on the unit's first frame
+	unitLosPositions[unit->id] = -OnesVector;
+}
+
+
+unsigned short* CUnitHandler::GetUnitLosStatus(int unitID)
+{
+	return &unitLosStatus[unitID * teamHandler->ActiveAllyTeams()];
 }
 
 
@@ -162,6 +190,13 @@ bool CUnitHandler::AddUnit(CUnit* unit)
 	teamHandler->Team(unit->team)->AddUnit(unit, CTeam::AddBuilt);
 	spring::VectorInsertUnique(unitsByDefs[unit->team][unit->unitDef->id], unit, false);
 
+	// greedy bin-packing: assign to the cheapest SlowUpdate slot
+	const int slot = std::min_element(slowUpdateSlotCosts.begin(), slowUpdateSlotCosts.end()) - slowUpdateSlotCosts.begin();
+
+	slowUpdateSlots[slot].push_back(unit);
+	slowUpdateSlotCosts[slot] += EstimateSlowUpdateCost(unit);
+	unitSlowUpdateSlot[unit->id] = slot;
+
 	maxUnitRadius = std::max(unit->radius, maxUnitRadius);
 	return true;
 }
@@ -196,8 +231,11 @@ void CUnitHandler::DeleteUnitNow(CUnit* delUnit)
 
 		teamHandler->Team(delTeam)->RemoveUnit(delUnit, CTeam::RemoveDied);
 
-		if (activeSlowUpdateUnit > std::distance(activeUnits.begin(), it))
-			--activeSlowUpdateUnit;
+		const int slot = unitSlowUpdateSlot[delUnit->id];
+
+		spring::VectorErase(slowUpdateSlots[slot], delUnit);
+		slowUpdateSlotCosts[slot] -= EstimateSlowUpdateCost(delUnit);
+		unitSlowUpdateSlot[delUnit->id] = -1;
 
 		activeUnits.erase(it);
 
@@ -215,6 +253,34 @@ void CUnitHandler::DeleteUnitNow(CUnit* delUnit)
 }
 
 
+static unsigned char CalcUnitLosFlags(const CUnit* unit)
+{
+	// every non-positional per-unit input read by CLosHandler::InLos
+	// and InRadar; a change in any of them invalidates the losStatus
+	// of an otherwise stationary unit
+	unsigned char losFlags = 0;
+
+	losFlags |= (unit->isCloaked     << 0);
+	losFlags |= (unit->alwaysVisible << 1);
+	losFlags |= (unit->useAirLos     << 2);
+	losFlags |= (unit->stealth       << 3);
+	losFlags |= (unit->sonarStealth  << 4);
+	losFlags |= (unit->beingBuilt    << 5);
+
+	return losFlags;
+}
+
+static bool InChangedArea(const std::vector<SRectangle>& rects, const int2 mapSquare)
+{
+	for (const SRectangle& rect: rects) {
+		if (rect.Inside(mapSquare))
+			return true;
+	}
+
+	return false;
+}
+
+
 void CUnitHandler::Update()
 {
 	auto UNIT_SANITY_CHECK = [](const CUnit* unit) {
@@ -236,6 +302,11 @@ void CUnitHandler::Update()
 
 	DeleteUnitsNow();
 
+	// as for projMemPool: repack the weapon pool's free list now and
+	// then so unit churn does not scatter new weapons over all pages
+	if ((gs->frameNum % 300) == 150 && weaponMemPool.frag_ratio() > 0.25f)
+		weaponMemPool.defrag_free_pages();
+
 	{
 		SCOPED_TIMER("Sim::Unit::MoveType");
 
@@ -280,8 +351,41 @@ void CUnitHandler::Update()
 
 	{
 		SCOPED_TIMER("Sim::Unit::UpdateLosStatus");
+
+		const int numAllyTeams = teamHandler->ActiveAllyTeams();
+
+		losChangedAreas.resize(numAllyTeams);
+		losHandler->CollectChangedAreas(losChangedAreas);
+
+		// scan the dense status block and only call into the unit for
+		// pairs that are not fully masked; the common all-masked case
+		// is then decided from contiguous memory instead of chasing a
+		// per-unit heap allocation through UpdateLosStatus each frame
+		//
+		// pairs that are not masked still only need re-evaluation when
+		// one of their inputs changed: the unit moved (or has non-zero
+		// speed, which feeds into InLos), one of its visibility flags
+		// flipped, or coverage crossed zero in its part of the map
 		for (CUnit* unit: activeUnits) {
-			for (int at = 0; at < teamHandler->ActiveAllyTeams(); ++at) {
+			const unsigned short* status = unit->losStatus;
+
+			const unsigned char losFlags = CalcUnitLosFlags(unit);
+			const int2 mapSquare = {int(unit->pos.x / SQUARE_SIZE), int(unit->pos.z / SQUARE_SIZE)};
+
+			const bool changed =
+				(unit->pos != unitLosPositions[unit->id]) ||
+				(unit->speed.w != 0.0f) ||
+				(losFlags != unitLosFlags[unit->id]);
+
+			unitLosPositions[unit->id] = unit->pos;
+			unitLosFlags[unit->id] = losFlags;
+
+			for (int at = 0; at < numAllyTeams; ++at) {
+				if ((status[at] & LOS_ALL_MASK_BITS) == LOS_ALL_MASK_BITS)
+					continue;
+				if (!changed && !InChangedArea(losChangedAreas[at], mapSquare))
+					continue;
+
 				unit->UpdateLosStatus(at);
 			}
 		}
@@ -289,25 +393,25 @@ void CUnitHandler::Update()
 
 	{
 		SCOPED_TIMER("Sim::Unit::SlowUpdate");
-		assert(activeSlowUpdateUnit >= 0);
-		// reset the iterator every <UNIT_SLOWUPDATE_RATE> frames
-		if ((gs->frameNum % UNIT_SLOWUPDATE_RATE) == 0)
-			activeSlowUpdateUnit = 0;
 
-		// stagger the SlowUpdate's
-		unsigned int n = (activeUnits.size() / UNIT_SLOWUPDATE_RATE) + 1;
+		// stagger the SlowUpdate's; every unit was assigned to the
+		// cheapest slot on creation so the per-frame totals are flat
+		// rather than clustering all expensive units into one frame
+		std::vector<CUnit*>& slotUnits = slowUpdateSlots[gs->frameNum % UNIT_SLOWUPDATE_RATE];
 
-		for (; activeSlowUpdateUnit < activeUnits.size() && n != 0; ++activeSlowUpdateUnit) {
-			CUnit* unit = activeUnits[activeSlowUpdateUnit];
+		// iterate by index; units created from inside a SlowUpdate can
+		// be appended to any slot, including the one running right now
+		for (size_t i = 0; i < slotUnits.size(); ++i) {
+			CUnit* unit = slotUnits[i];
 
 			UNIT_SANITY_CHECK(unit);
 			unit->SlowUpdate();
 			unit->SlowUpdateWeapons();
 			unit->localModel.UpdateBoundingVolume();
 			UNIT_SANITY_CHECK(unit);
-
-			n--;
 		}
+
+		RebalanceSlowUpdateSlots();
 	}
 
 	{
@@ -329,6 +433,11 @@ void CUnitHandler::Update()
 			CUnit* unit = activeUnits[activeUpdateUnit];
 			if (unit->CanUpdateWeapons()) {
 				for (CWeapon* w: unit->weapons) {
+					// most weapons most of the time are idle and fully
+					// reloaded, with nothing for their Update to do
+					if (w->IsDormant())
+						continue;
+
 					w->Update();
 				}
 			}
@@ -339,6 +448,61 @@ void CUnitHandler::Update()
 
 
 
+float CUnitHandler::EstimateSlowUpdateCost(const CUnit* unit) const
+{
+	const UnitDef* ud = unit->unitDef;
+
+	// deterministic proxy for the relative cost of one SlowUpdate
+	// call; wall-clock measurements can not be used here since the
+	// slot assignments feed back into synced state while per-client
+	// timings differ
+	//
+	// must stay constant over a unit's lifetime, the cost subtracted
+	// on removal has to match the one added by AddUnit
+	float cost = 1.0f;
+
+	cost += (ud->weapons.size() * 1.0f);
+	// builders run CAI target-scans during their SlowUpdate
+	cost += (ud->builder? 4.0f: 0.0f);
+	cost += (ud->canKamikaze? 2.0f: 0.0f);
+	cost += ((ud->radarRadius > 0 || ud->sonarRadius > 0)? 1.0f: 0.0f);
+
+	return cost;
+}
+
+void CUnitHandler::RebalanceSlowUpdateSlots()
+{
+	// unit deaths can leave the greedy assignment lopsided, so
+	// migrate at most one unit per frame from the most to the
+	// least loaded slot (when that strictly shrinks the gap);
+	// a migrated unit has one SlowUpdate skipped or duplicated
+	// depending on whether its new slot ran this cycle already
+	const auto maxIt = std::max_element(slowUpdateSlotCosts.begin(), slowUpdateSlotCosts.end());
+	const auto minIt = std::min_element(slowUpdateSlotCosts.begin(), slowUpdateSlotCosts.end());
+
+	const int maxSlot = maxIt - slowUpdateSlotCosts.begin();
+	const int minSlot = minIt - slowUpdateSlotCosts.begin();
+
+	if (slowUpdateSlots[maxSlot].empty())
+		return;
+
+	CUnit* unit = slowUpdateSlots[maxSlot].back();
+
+	const float cost = EstimateSlowUpdateCost(unit);
+
+	// moving <unit> changes the gap by twice its cost
+	if ((cost * 2.0f) >= (*maxIt - *minIt))
+		return;
+
+	slowUpdateSlots[maxSlot].pop_back();
+	slowUpdateSlots[minSlot].push_back(unit);
+	slowUpdateSlotCosts[maxSlot] -= cost;
+	slowUpdateSlotCosts[minSlot] += cost;
+	unitSlowUpdateSlot[unit->id] = minSlot;
+}
+
+
+
 void CUnitHandler::AddBuilderCAI(CBuilderCAI* b)
 {
 	// called from CBuilderCAI --> owner is already valid
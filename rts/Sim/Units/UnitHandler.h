@@ -7,6 +7,7 @@
 
 #include "UnitDef.h"
 #include "Sim/Misc/SimObjectIDPool.h"
+#include "System/Rectangle.h"
 #include "System/creg/STL_Map.h"
 
 class CUnit;
@@ -49,6 +50,9 @@ public:
 	CUnit* GetUnitUnsafe(unsigned int id) const { return units[id]; }
 	CUnit* GetUnit(unsigned int id) const { return ((id < MaxUnits())? units[id]: nullptr); }
 
+	/// start of a unit's per-allyteam slice of the dense status block
+	unsigned short* GetUnitLosStatus(int unitID);
+
 	static CUnit* NewUnit(const UnitDef* ud);
 
 	const std::vector<CUnit*>& GetActiveUnits() const { return activeUnits; }
@@ -66,6 +70,9 @@ private:
 	void DeleteUnitsNow();
 	void InsertActiveUnit(CUnit* unit);
 
+	float EstimateSlowUpdateCost(const CUnit* unit) const;
+	void RebalanceSlowUpdateSlots();
+
 private:
 	SimObjectIDPool idPool;
 
@@ -73,9 +80,34 @@ private:
 	std::vector<CUnit*> activeUnits;                   ///< used to get all active units
 	std::vector<CUnit*> unitsToBeRemoved;              ///< units that will be removed at start of next update
 
+	///< units bucketed by the frame (modulo UNIT_SLOWUPDATE_RATE) in
+	///< which they get SlowUpdate'd; each unit goes to the slot with
+	///< the lowest estimated cost so per-frame totals stay flat
+	std::vector<std::vector<CUnit*>> slowUpdateSlots;
+	std::vector<float> slowUpdateSlotCosts;            ///< summed cost estimate per slot
+	std::vector<int> unitSlowUpdateSlot;               ///< slot of each unit, indexed by id (-1 if none)
+
+	///< per-allyteam los/radar status of all units in one dense block
+	///< (indexed by [id * ActiveAllyTeams() + allyTeam]); the status
+	///< scan in Update walks this contiguously instead of paying one
+	///< cache miss per CUnit, each unit's losStatus points into it
+	std::vector<unsigned short> unitLosStatus;
+
+	///< position (indexed by id) at which each unit's losStatus was last
+	///< evaluated; units that did not move since then only need to be
+	///< re-evaluated when los-coverage changed underneath them
+	std::vector<float3> unitLosPositions;
+
+	///< non-positional visibility inputs (cloak, stealth, ...) packed
+	///< into one byte per unit, sampled alongside unitLosPositions
+	std::vector<unsigned char> unitLosFlags;
+
+	///< scratch for CLosHandler::CollectChangedAreas, one list of
+	///< changed-coverage rectangles per allyteam
+	std::vector<std::vector<SRectangle>> losChangedAreas;
+
 	spring::unordered_map<unsigned int, CBuilderCAI*> builderCAIs;
 
-	size_t activeSlowUpdateUnit;  ///< first unit of batch that will be SlowUpdate'd this frame
 	size_t activeUpdateUnit;  ///< first unit of batch that will be SlowUpdate'd this frame
 
 	///< global unit-limit (derived from the per-team limit)
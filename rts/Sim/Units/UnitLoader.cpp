@@ -108,6 +108,51 @@ CUnit* CUnitLoader::LoadUnit(const UnitLoadParams& params)
 }
 
 
+void CUnitLoader::LoadUnits(const std::vector<UnitLoadParams>& paramsVec, std::vector<CUnit*>& units)
+{
+	// the per-unit sim insertions that look batchable here are already
+	// amortized elsewhere: LOS instances go through ILosType's delayed
+	// queue and get raycast in one parallel pass during the next
+	// LosHandler::Update, and QuadField insertion only touches the quads
+	// each footprint overlaps; what a batch can share is limit checking,
+	// watchdog handling and deferring terrain flattening until every
+	// unit exists so late entries do not spawn on half-levelled ground
+	std::vector<const CUnit*> flattenQueue;
+
+	units.reserve(units.size() + paramsVec.size());
+
+	for (const UnitLoadParams& params: paramsVec) {
+		// the other thread may be waiting for a mutex
+		// held by this one, triggering hang detection
+		Watchdog::ClearPrimaryTimers();
+
+		if (params.unitDef == nullptr)
+			continue;
+		// (LoadUnit substitutes the Gaia team for negative ID's)
+		if (teamHandler->IsValidTeam(params.teamID) && !unitHandler->CanBuildUnit(params.unitDef, params.teamID))
+			continue;
+
+		UnitLoadParams unitParams = params;
+		unitParams.flattenGround = false;
+
+		CUnit* unit = LoadUnit(unitParams);
+
+		if (unit == nullptr)
+			continue;
+
+		units.push_back(unit);
+
+		if (params.flattenGround)
+			flattenQueue.push_back(unit);
+	}
+
+	for (const CUnit* unit: flattenQueue) {
+		Watchdog::ClearPrimaryTimers();
+		FlattenGround(unit);
+	}
+}
+
+
 
 void CUnitLoader::ParseAndExecuteGiveUnitsCommand(const std::vector<std::string>& args, int team)
 {
@@ -190,8 +235,12 @@ void CUnitLoader::GiveUnits(const std::string& objectName, float3 pos, int amoun
 		pos.x = Clamp(pos.x, sqHalfMapSize, float3::maxxpos - sqHalfMapSize - 1);
 		pos.z = Clamp(pos.z, sqHalfMapSize, float3::maxzpos - sqHalfMapSize - 1);
 
+		std::vector<UnitLoadParams> batchParams;
+		std::vector<CUnit*> batchUnits;
+
+		batchParams.reserve(numRequestedUnits);
+
 		for (int a = 1; a <= numRequestedUnits; ++a) {
-			Watchdog::ClearPrimaryTimers(); // the other thread may be waiting for a mutex held by this one, triggering hang detection
 			const float px = pos.x + (a % sqSize - sqSize / 2) * 10 * SQUARE_SIZE;
 			const float pz = pos.z + (a / sqSize - sqSize / 2) * 10 * SQUARE_SIZE;
 			const UnitDef* ud = unitDefHandler->GetUnitDefByID(a);
@@ -211,8 +260,10 @@ void CUnitLoader::GiveUnits(const std::string& objectName, float3 pos, int amoun
 				true,
 			};
 
-			LoadUnit(unitParams);
+			batchParams.push_back(unitParams);
 		}
+
+		LoadUnits(batchParams, batchUnits);
 	} else {
 		unsigned int numRequestedUnits = amount;
 		unsigned int currentNumUnits = receivingTeam->units.size();
@@ -250,13 +301,16 @@ void CUnitLoader::GiveUnits(const std::string& objectName, float3 pos, int amoun
 
 			int unitsLoaded = numRequestedUnits;
 
+			std::vector<UnitLoadParams> batchParams;
+			std::vector<CUnit*> batchUnits;
+
+			batchParams.reserve(numRequestedUnits);
+
 			for (int z = 0; z < squareSize; ++z) {
 				for (int x = 0; x < squareSize && (unitsLoaded-- > 0); ++x) {
 					const float px = squarePos.x + x * xsize * SQUARE_SIZE;
 					const float pz = squarePos.z + z * zsize * SQUARE_SIZE;
 
-					Watchdog::ClearPrimaryTimers();
-
 					const UnitLoadParams unitParams = {
 						unitDef,
 						nullptr,
@@ -272,10 +326,12 @@ void CUnitLoader::GiveUnits(const std::string& objectName, float3 pos, int amoun
 						true,
 					};
 
-					LoadUnit(unitParams);
+					batchParams.push_back(unitParams);
 				}
 			}
 
+			LoadUnits(batchParams, batchUnits);
+
 			LOG("[%s] spawned %i %s unit(s) for team %i",
 					__FUNCTION__, numRequestedUnits, objectName.c_str(), team);
 		}
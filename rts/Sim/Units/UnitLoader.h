@@ -39,6 +39,11 @@ public:
 	CUnit* LoadUnit(const std::string& name, const UnitLoadParams& params);
 	CUnit* LoadUnit(const UnitLoadParams& params);
 
+	/// batch variant for mass spawns (scenario setups, /give); appends
+	/// the created units to <units>, entries that fail team or global
+	/// unit-limit checks are skipped rather than aborting the batch
+	void LoadUnits(const std::vector<UnitLoadParams>& paramsVec, std::vector<CUnit*>& units);
+
 	CWeapon* LoadWeapon(CUnit* owner, const UnitDefWeapon* udw);
 
 	void ParseAndExecuteGiveUnitsCommand(const std::vector<std::string>& args, int team);
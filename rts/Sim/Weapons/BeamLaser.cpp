@@ -198,6 +198,12 @@ void CBeamLaser::Update()
 	UpdateSweep();
 }
 
+bool CBeamLaser::IsDormant() const
+{
+	// a sweep can outlive the target that started it
+	return (CWeapon::IsDormant() && !sweepFireState.IsSweepFiring());
+}
+
 float3 CBeamLaser::GetFireDir(bool sweepFire, bool scriptCall)
 {
 	float3 dir = currentTargetPos - weaponMuzzlePos;
@@ -399,7 +405,12 @@ void CBeamLaser::FireInternal(float3 curDir)
 		// make it possible to always hit with some minimal intensity (melee weapons have use for that)
 		const float hitIntensity = std::max(weaponDef->minIntensity, 1.0f - curLength / (actualRange * 2.0f));
 
-		const DamageArray& baseDamages = damages->GetDynamicDamages(weaponMuzzlePos, curPos);
+		// scratch copy only made when damage actually falls off with distance
+		static DamageArray dynDamages;
+
+		const DamageArray& baseDamages = damages->HasDynamicDamages()?
+			(dynDamages = damages->GetDynamicDamages(weaponMuzzlePos, curPos)):
+			static_cast<const DamageArray&>(*damages);
 		const DamageArray da = baseDamages * (hitIntensity * salvoDamageMult);
 		const CExplosionParams params = {
 			hitPos,
@@ -16,6 +16,8 @@ public:
 	void Update() override final;
 	void Init() override final;
 
+	bool IsDormant() const override final;
+
 private:
 	float3 GetFireDir(bool sweepFire, bool scriptCall);
 
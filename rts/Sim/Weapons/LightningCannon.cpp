@@ -69,7 +69,12 @@ void CLightningCannon::FireImpl(const bool scriptCall)
 	if (hitUnit != nullptr)
 		hitUnit->SetLastHitPiece(hitColQuery.GetHitPiece(), gs->frameNum);
 
-	const DamageArray& damageArray = damages->GetDynamicDamages(weaponMuzzlePos, currentTargetPos);
+	// scratch copy only made when damage actually falls off with distance
+	static DamageArray dynDamages;
+
+	const DamageArray& damageArray = damages->HasDynamicDamages()?
+		(dynDamages = damages->GetDynamicDamages(weaponMuzzlePos, currentTargetPos)):
+		static_cast<const DamageArray&>(*damages);
 	const CExplosionParams params = {
 		curPos + curDir * boltLength,                     // hitPos (same as hitColQuery.GetHitPos() if no water or shield in way)
 		curDir,
@@ -15,6 +15,8 @@ public:
 	void SlowUpdate() override final {}
 	void Init() override final {}
 
+	bool IsDormant() const override final { return true; }
+
 private:
 	bool TestTarget(const float3 pos, const SWeaponTarget& trg) const override final { return false; }
 	void FireImpl(const bool scriptCall) override final {}
@@ -32,12 +32,14 @@ CR_REG_METADATA(CPlasmaRepulser, (
 	CR_MEMBER(quads),
 	CR_MEMBER(collisionVolume),
 	CR_MEMBER(tempNum),
-	CR_MEMBER(deltaPos)
+	CR_MEMBER(deltaPos),
+	CR_MEMBER(deltaPosLen)
 ))
 
 
 CPlasmaRepulser::CPlasmaRepulser(CUnit* owner, const WeaponDef* def): CWeapon(owner, def),
 	tempNum(0),
+	deltaPosLen(0.0f),
 	curPower(0.0f),
 	hitFrames(0),
 	rechargeDelay(0),
@@ -114,8 +116,10 @@ void CPlasmaRepulser::Update()
 	if (weaponMuzzlePos != lastPos)
 		quadField->MovedRepulser(this);
 
-	if (lastPos != ZeroVector)
+	if (lastPos != ZeroVector) {
 		deltaPos = weaponMuzzlePos - lastPos;
+		deltaPosLen = deltaPos.Length();
+	}
 
 	lastPos = weaponMuzzlePos;
 
@@ -133,7 +137,12 @@ bool CPlasmaRepulser::IncomingProjectile(CWeaponProjectile* p, const float3& hit
 	if (eventHandler.ShieldPreDamaged(p, this, owner, weaponDef->shieldRepulser, nullptr, nullptr, p->pos, hitPos))
 		return false;
 
-	const DamageArray& damageArray = p->damages->GetDynamicDamages(p->GetStartPos(), p->pos);
+	// scratch copy only made when damage actually falls off with distance
+	static DamageArray dynDamages;
+
+	const DamageArray& damageArray = p->damages->HasDynamicDamages()?
+		(dynDamages = p->damages->GetDynamicDamages(p->GetStartPos(), p->pos)):
+		static_cast<const DamageArray&>(*p->damages);
 	const float shieldDamage = damageArray.Get(weaponDef->shieldArmorType);
 
 	// shield does not have enough power, don't touch the projectile
@@ -216,7 +225,12 @@ bool CPlasmaRepulser::IncomingBeam(const CWeapon* emitter, const float3& startPo
 	if (eventHandler.ShieldPreDamaged(nullptr, this, owner, weaponDef->shieldRepulser, emitter, emitter->owner, startPos, hitPos))
 		return false;
 
-	const DamageArray& damageArray = emitter->damages->GetDynamicDamages(startPos, weaponMuzzlePos);
+	// scratch copy only made when damage actually falls off with distance
+	static DamageArray dynDamages;
+
+	const DamageArray& damageArray = emitter->damages->HasDynamicDamages()?
+		(dynDamages = emitter->damages->GetDynamicDamages(startPos, weaponMuzzlePos)):
+		static_cast<const DamageArray&>(*emitter->damages);
 	const float shieldDamage = damageArray.Get(weaponDef->shieldArmorType);
 
 	if (curPower < shieldDamage)
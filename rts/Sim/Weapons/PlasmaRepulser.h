@@ -25,6 +25,9 @@ public:
 	void Update() override final;
 	void SlowUpdate() override final;
 
+	// shields recharge and track their collision volume every frame
+	bool IsDormant() const override final { return false; }
+
 
 	void SetEnabled(bool b) { isEnabled = b; }
 	void SetCurPower(float p) { curPower = p; }
@@ -34,6 +37,8 @@ public:
 	bool IsRepulsing(CWeaponProjectile* p) const;
 	float GetCurPower() const { return curPower; }
 	float GetRadius() const { return radius; }
+	/// length of deltaPos, cached so per-projectile tests avoid the sqrt
+	float GetDeltaPosLen() const { return deltaPosLen; }
 	int GetHitFrames() const { return hitFrames; }
 	bool CanIntercept(unsigned interceptedType, int allyTeam) const;
 
@@ -45,6 +50,7 @@ public:
 	CollisionVolume collisionVolume;
 	int tempNum;
 	float3 deltaPos;
+	float deltaPosLen;
 
 private:
 	void FireImpl(const bool scriptCall) override final {}
@@ -8,8 +8,10 @@
 #include "Game/Players/Player.h"
 #include "Lua/LuaConfig.h"
 #include "Map/Ground.h"
+#include "Map/MapDamage.h"
 #include "Sim/Misc/CollisionHandler.h"
 #include "Sim/Misc/CollisionVolume.h"
+#include "Sim/Misc/GroundBlockingObjectMap.h"
 #include "Sim/Misc/InterceptHandler.h"
 #include "Sim/Misc/ModInfo.h"
 #include "Sim/Misc/TeamHandler.h"
@@ -94,7 +96,14 @@ CR_REG_METADATA(CWeapon, (
 	CR_MEMBER(currentTarget),
 	CR_MEMBER(currentTargetPos),
 
-	CR_MEMBER(incomingProjectileIDs)
+	CR_MEMBER(incomingProjectileIDs),
+
+	// rebuilt on demand, not worth saving
+	CR_IGNORED(lofCacheSrcPos),
+	CR_IGNORED(lofCacheTgtPos),
+	CR_IGNORED(lofCacheEpoch),
+	CR_IGNORED(lofCacheFrame),
+	CR_IGNORED(lofCacheVerdict)
 ))
 
 
@@ -161,7 +170,13 @@ CWeapon::CWeapon(CUnit* owner, const WeaponDef* def):
 	errorVectorAdd(ZeroVector),
 	muzzleFlareSize(1),
 	fireSoundId(0),
-	fireSoundVolume(0)
+	fireSoundVolume(0),
+
+	lofCacheSrcPos(ZeroVector),
+	lofCacheTgtPos(ZeroVector),
+	lofCacheEpoch(0),
+	lofCacheFrame(-1),
+	lofCacheVerdict(false)
 {
 	assert(weaponMemPool.alloced(this));
 }
@@ -258,6 +273,19 @@ float CWeapon::GetPredictedImpactTime(float3 p) const
 }
 
 
+bool CWeapon::IsDormant() const
+{
+	if (HaveTarget() || owner->curTarget.type != Target_None)
+		return false;
+
+	// salvo still being released, or stockpile production pending
+	if (salvoLeft > 0 || numStockpileQued > 0)
+		return false;
+
+	return true;
+}
+
+
 void CWeapon::Update()
 {
 	// update conditional cause last SlowUpdate maybe longer away than UNIT_SLOWUPDATE_RATE
@@ -403,7 +431,7 @@ void CWeapon::UpdateFire()
 	if (!CanFire(false, false, false))
 		return;
 
-	if (!TryTarget(currentTargetPos, currentTarget, true))
+	if (!TryTarget(currentTargetPos, currentTarget, true, true))
 		return;
 
 	// pre-check if we got enough resources (so CobBlockShot gets only called when really possible to shoot)
@@ -531,7 +559,7 @@ bool CWeapon::Attack(const SWeaponTarget& newTarget)
 		case Target_Unit:
 		case Target_Pos:
 		case Target_Intercept: {
-			if (!TryTarget(newTarget))
+			if (!TryTarget(newTarget, true))
 				return false;
 
 			SetAttackTarget(newTarget);
@@ -588,7 +616,7 @@ bool CWeapon::AllowWeaponAutoTarget() const
 	if (avoidTarget)   { return true; }
 
 	if (currentTarget.type == Target_Unit) {
-		if (!TryTarget(SWeaponTarget(currentTarget.unit, currentTarget.isUserTarget))) {
+		if (!TryTarget(SWeaponTarget(currentTarget.unit, currentTarget.isUserTarget), true)) {
 			// if we have a user-target (ie. a user attack order)
 			// then only allow generating opportunity targets iff
 			// it is not possible to hit the user's chosen unit
@@ -652,7 +680,7 @@ bool CWeapon::AutoTarget()
 		if (isBadTarget && (badTargetUnit != nullptr))
 			continue;
 
-		if (!TryTarget(SWeaponTarget(unit)))
+		if (!TryTarget(SWeaponTarget(unit), true))
 			continue;
 
 		if (unit->IsNeutral() && (owner->fireState < FIRESTATE_FIREATNEUTRAL))
@@ -722,7 +750,7 @@ void CWeapon::HoldIfTargetInvalid()
 	if (!HaveTarget())
 		return;
 
-	if (!TryTarget(currentTarget)) {
+	if (!TryTarget(currentTarget, true)) {
 		DropCurrentTarget();
 		return;
 	}
@@ -841,7 +869,7 @@ float3 CWeapon::GetTargetBorderPos(
 }
 
 
-bool CWeapon::TryTarget(const float3 tgtPos, const SWeaponTarget& trg, bool preFire) const
+bool CWeapon::TryTarget(const float3 tgtPos, const SWeaponTarget& trg, bool preFire, bool useLofCache) const
 {
 	assert(GetLeadTargetPos(trg).SqDistance(tgtPos) < Square(250.0f));
 
@@ -855,7 +883,69 @@ bool CWeapon::TryTarget(const float3 tgtPos, const SWeaponTarget& trg, bool preF
 		return false;
 
 	// TODO: add a forcedUserTarget (forced-fire mode enabled with CTRL e.g.) and skip the tests below
-	return (HaveFreeLineOfFire(GetAimFromPos(preFire), tgtPos, trg));
+	return (CheckFreeLineOfFire(GetAimFromPos(preFire), tgtPos, trg, useLofCache));
+}
+
+
+// line-of-fire verdicts are cached and refreshed under a shared
+// per-frame TraceRay budget, so massed weapons spread their ray
+// tests over several frames instead of spiking single ones
+#define LOF_CACHE_MAX_AGE      8
+#define LOF_TRACES_PER_FRAME  64
+// endpoint movement below this distance keeps a verdict valid
+#define LOF_CACHE_POS_TOLSQ   Square(SQUARE_SIZE)
+
+static int lofTraceFrame = -1;
+static int lofTraceCount = 0;
+
+bool CWeapon::CheckFreeLineOfFire(const float3 srcPos, const float3 tgtPos, const SWeaponTarget& trg, bool useLofCache) const
+{
+	// unsynced callers (GuiHandler, unsynced Lua handles) must not
+	// consume the shared budget or dirty cached verdicts that synced
+	// code reads, so they always pay for a full trace
+	if (!useLofCache)
+		return (HaveFreeLineOfFire(srcPos, tgtPos, trg));
+
+	// reset the shared ray budget on frame boundaries; synced code
+	// runs in lock-step, so this stays deterministic across clients
+	if (lofTraceFrame != gs->frameNum) {
+		lofTraceFrame = gs->frameNum;
+		lofTraceCount = 0;
+	}
+
+	const unsigned int epoch = mapDamage->terrainChangeEpoch + groundBlockingObjectMap->GetStructureChangeEpoch();
+
+	const bool sameQuery =
+		(lofCacheFrame >= 0) &&
+		(lofCacheEpoch == epoch) &&
+		(srcPos.SqDistance(lofCacheSrcPos) < LOF_CACHE_POS_TOLSQ) &&
+		(tgtPos.SqDistance(lofCacheTgtPos) < LOF_CACHE_POS_TOLSQ);
+
+	if (sameQuery) {
+		if ((gs->frameNum - lofCacheFrame) < LOF_CACHE_MAX_AGE)
+			return lofCacheVerdict;
+
+		// aged out but over budget; keep the previous verdict
+		// until the refreshed result lands on a later frame
+		if (lofTraceCount >= LOF_TRACES_PER_FRAME)
+			return lofCacheVerdict;
+	} else {
+		// no usable verdict for these endpoints; assume the line is
+		// free when over budget, a re-test follows before long since
+		// nothing was cached (TryTarget is re-run while aiming)
+		if (lofTraceCount >= LOF_TRACES_PER_FRAME)
+			return true;
+	}
+
+	lofTraceCount += 1;
+
+	lofCacheVerdict = HaveFreeLineOfFire(srcPos, tgtPos, trg);
+	lofCacheFrame = gs->frameNum;
+	lofCacheEpoch = epoch;
+	lofCacheSrcPos = srcPos;
+	lofCacheTgtPos = tgtPos;
+
+	return lofCacheVerdict;
 }
 
 
@@ -992,8 +1082,8 @@ bool CWeapon::HaveFreeLineOfFire(const float3 srcPos, const float3 tgtPos, const
 }
 
 
-bool CWeapon::TryTarget(const SWeaponTarget& trg) const {
-	return TryTarget(GetLeadTargetPos(trg), trg);
+bool CWeapon::TryTarget(const SWeaponTarget& trg, bool useLofCache) const {
+	return TryTarget(GetLeadTargetPos(trg), trg, false, useLofCache);
 }
 
 
@@ -30,6 +30,14 @@ public:
 	virtual void SlowUpdate();
 	virtual void Update();
 
+	/// true when the per-frame Update can be skipped entirely: no
+	/// current or pending owner target, no salvo being released and
+	/// no stockpile production (reloading is a frame-stamp compare
+	/// and needs no ticking); aim positions and error vectors then
+	/// only refresh during SlowUpdate, which also runs for dormant
+	/// weapons so (re)acquiring any target reactivates them
+	virtual bool IsDormant() const;
+
 public:
 	bool Attack(const SWeaponTarget& newTarget);
 	void SetAttackTarget(const SWeaponTarget& newTarget); //< does no validity checks!
@@ -54,7 +62,7 @@ public:
 
 	virtual bool CanFire(bool ignoreAngleGood, bool ignoreTargetType, bool ignoreRequestedDir) const;
 
-	bool TryTarget(const SWeaponTarget& trg) const;
+	bool TryTarget(const SWeaponTarget& trg, bool useLofCache = false) const;
 	bool TryTargetRotate(const CUnit* unit, bool userTarget, bool manualFire);
 	bool TryTargetRotate(float3 tgtPos, bool userTarget, bool manualFire);
 	bool TryTargetHeading(short heading, const SWeaponTarget& trg);
@@ -110,7 +118,8 @@ private:
 	void ReAimWeapon();
 	void HoldIfTargetInvalid();
 
-	bool TryTarget(const float3 tgtPos, const SWeaponTarget& trg, bool preFire = false) const;
+	bool TryTarget(const float3 tgtPos, const SWeaponTarget& trg, bool preFire = false, bool useLofCache = false) const;
+	bool CheckFreeLineOfFire(const float3 srcPos, const float3 tgtPos, const SWeaponTarget& trg, bool useLofCache = false) const;
 
 public:
 	CUnit* owner;
@@ -192,6 +201,18 @@ protected:
 	// projectiles that are on the way to our interception zone
 	// (eg. nuke toward a repulsor, or missile toward a shield)
 	std::vector<int> incomingProjectileIDs;
+
+	// cached verdict of the last (virtual) HaveFreeLineOfFire query;
+	// kept while the endpoints stay put and the terrain- / structure-
+	// epochs do not advance, aged out after a few frames to catch
+	// mobile blockers, and refreshed under a shared per-frame TraceRay
+	// budget (see CheckFreeLineOfFire); only the synced weapon-update
+	// callers may touch it, unsynced queries (GUI, Lua) bypass it
+	mutable float3 lofCacheSrcPos;
+	mutable float3 lofCacheTgtPos;
+	mutable unsigned int lofCacheEpoch;
+	mutable int lofCacheFrame;
+	mutable bool lofCacheVerdict;
 };
 
 #endif /* WEAPON_H */
@@ -8,9 +8,9 @@
 
 #if (defined(__x86_64) || defined(__x86_64__))
 // NOTE: ~742MB, way too big for 32-bit builds
-typedef StaticMemPool<MAX_UNITS * MAX_WEAPONS_PER_UNIT, 760> WeaponMemPool;
+typedef StaticMemPool<MAX_UNITS * MAX_WEAPONS_PER_UNIT, 768> WeaponMemPool;
 #else
-typedef DynMemPool<760> WeaponMemPool;
+typedef DynMemPool<768> WeaponMemPool;
 #endif
 
 extern WeaponMemPool weaponMemPool;
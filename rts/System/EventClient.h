@@ -4,6 +4,7 @@
 #define EVENT_CLIENT_H
 
 #include <algorithm>
+#include <cstdint>
 #include <typeinfo>
 #include <string>
 #include <vector>
@@ -66,6 +67,15 @@ class CEventClient
 		 */
 		virtual bool WantsEvent(const std::string& eventName);
 
+		// per-client call-in presence bits, indexed by the eventHandler's
+		// event ID and kept in sync with the managed EventClientList's on
+		// {Insert,Remove}Event (i.e. whenever UpdateCallIn runs)
+		static constexpr int MAX_EVENT_BITS = 256;
+
+		bool HasEventBit(int evtID) const { return ((eventBits[evtID / 64] & (std::uint64_t(1) << (evtID % 64))) != 0); }
+		void SetEventBit(int evtID) { eventBits[evtID / 64] |=  (std::uint64_t(1) << (evtID % 64)); }
+		void ClrEventBit(int evtID) { eventBits[evtID / 64] &= ~(std::uint64_t(1) << (evtID % 64)); }
+
 		// used by the eventHandler to route certain event types
 		virtual int  GetReadAllyTeam() const { return NoAccessTeam; }
 		virtual bool GetFullRead()     const { return GetReadAllyTeam() == AllAccessTeam; }
@@ -83,6 +93,8 @@ class CEventClient
 		const bool        synced_;
 		      bool        autoLinkEvents;
 
+		std::uint64_t eventBits[MAX_EVENT_BITS / 64] = {0, 0, 0, 0};
+
 	protected:
 		friend class CEventHandler;
 		typedef std::pair<std::string, bool> LinkPair;
@@ -2,6 +2,7 @@
 
 #include "System/EventHandler.h"
 
+#include "Game/GlobalUnsynced.h"
 #include "Lua/LuaCallInCheck.h"
 #include "Lua/LuaOpenGL.h"  // FIXME -- should be moved
 
@@ -51,6 +52,11 @@ void CEventHandler::SetupEvents()
 
 	// sort by name
 	std::stable_sort(eventMap.begin(), eventMap.end(), [](const EventPair& a, const EventPair& b) { return (a.first < b.first); });
+
+	assert(eventMap.size() <= CEventClient::MAX_EVENT_BITS);
+
+	eventTimings.clear();
+	eventTimings.resize(eventMap.size());
 }
 
 
@@ -79,9 +85,11 @@ void CEventHandler::RemoveClient(CEventClient* ec)
 
 	ListRemove(handles, ec);
 
-	for (auto it = eventMap.cbegin(); it != eventMap.cend(); ++it) {
+	int evtID = 0;
+
+	for (auto it = eventMap.cbegin(); it != eventMap.cend(); ++it, ++evtID) {
 		const EventInfo& ei = it->second;
-		if (ei.HasPropBit(MANAGED_BIT)) {
+		if (ei.HasPropBit(MANAGED_BIT) && ec->HasEventBit(evtID)) {
 			RemoveEvent(ec, it->first);
 		}
 	}
@@ -101,6 +109,18 @@ void CEventHandler::GetEventList(std::vector<std::string>& list) const
 }
 
 
+int CEventHandler::GetEventID(const std::string& eName) const
+{
+	const auto comp = [](const EventPair& a, const EventPair& b) { return (a.first < b.first); };
+	const auto iter = std::lower_bound(eventMap.begin(), eventMap.end(), EventPair{eName, {}}, comp);
+
+	if (iter == eventMap.end() || iter->first != eName)
+		return -1;
+
+	return (iter - eventMap.begin());
+}
+
+
 bool CEventHandler::IsKnown(const std::string& eName) const
 {
 	// std::binary_search does not return an iterator
@@ -147,7 +167,14 @@ bool CEventHandler::InsertEvent(CEventClient* ec, const std::string& ciName)
 	if (ec->GetSynced() && iter->second.HasPropBit(UNSYNCED_BIT))
 		return false;
 
+	const int evtID = (iter - eventMap.begin());
+
+	// presence bit is authoritative, skip the ordered-insert scan
+	if (ec->HasEventBit(evtID))
+		return true;
+
 	ListInsert(*iter->second.GetList(), ec);
+	ec->SetEventBit(evtID);
 	return true;
 }
 
@@ -160,7 +187,14 @@ bool CEventHandler::RemoveEvent(CEventClient* ec, const std::string& ciName)
 	if ((iter == eventMap.end()) || (iter->second.GetList() == nullptr) || (iter->first != ciName))
 		return false;
 
+	const int evtID = (iter - eventMap.begin());
+
+	// not subscribed, skip the list rebuild
+	if (!ec->HasEventBit(evtID))
+		return true;
+
 	ListRemove(*(iter->second.GetList()), ec);
+	ec->ClrEventBit(evtID);
 	return true;
 }
 
@@ -205,6 +239,7 @@ void CEventHandler::ListRemove(EventClientList& ecList, CEventClient* ec)
 /******************************************************************************/
 
 #define CONTROL_ITERATE_DEF_TRUE(name, ...)                        \
+	EVENT_TIMING_INFO(name)                                        \
 	bool result = true;                                            \
                                                                    \
 	for (size_t i = 0; i < list##name.size(); ) {                  \
@@ -218,6 +253,7 @@ void CEventHandler::ListRemove(EventClientList& ecList, CEventClient* ec)
 	return result;
 
 #define CONTROL_ITERATE_DEF_FALSE(name, ...)                       \
+	EVENT_TIMING_INFO(name)                                        \
 	bool result = false;                                           \
                                                                    \
 	for (size_t i = 0; i < list##name.size(); ) {                  \
@@ -318,6 +354,7 @@ bool CEventHandler::MoveCtrlNotify(const CUnit* unit, int data)
 
 int CEventHandler::AllowWeaponTargetCheck(unsigned int attackerID, unsigned int attackerWeaponNum, unsigned int attackerWeaponDefID)
 {
+	EVENT_TIMING_INFO(AllowWeaponTargetCheck)
 	int result = -1;
 
 	for (size_t i = 0; i < listAllowWeaponTargetCheck.size(); ) {
@@ -393,6 +430,7 @@ bool CEventHandler::ShieldPreDamaged(
 
 bool CEventHandler::SyncedActionFallback(const std::string& line, int playerID)
 {
+	EVENT_TIMING_INFO(SyncedActionFallback)
 	for (int i = 0; i < listSyncedActionFallback.size(); ) {
 		CEventClient* ec = listSyncedActionFallback[i];
 		if (ec->SyncedActionFallback(line, playerID))
@@ -408,6 +446,7 @@ bool CEventHandler::SyncedActionFallback(const std::string& line, int playerID)
 /******************************************************************************/
 
 #define ITERATE_EVENTCLIENTLIST(name, ...)                         \
+	EVENT_TIMING_INFO(name)                                        \
 	for (size_t i = 0; i < list##name.size(); ) {                  \
 		CEventClient* ec = list##name[i];                          \
 		ec->name(__VA_ARGS__);                                     \
@@ -494,6 +533,7 @@ void CEventHandler::PlayerRemoved(int playerID, int reason)
 
 void CEventHandler::UnitHarvestStorageFull(const CUnit* unit)
 {
+	EVENT_TIMING_INFO(UnitHarvestStorageFull)
 	const int unitAllyTeam = unit->allyteam;
 	const int count = listUnitHarvestStorageFull.size();
 	for (int i = 0; i < count; i++) {
@@ -527,6 +567,10 @@ void CEventHandler::Load(IArchive* archive)
 
 void CEventHandler::Update()
 {
+	// unsynced per-frame work is pointless while fast-forwarding
+	if (gu->simCatchingUp)
+		return;
+
 	ITERATE_EVENTCLIENTLIST(Update);
 }
 
@@ -552,6 +596,11 @@ void CEventHandler::GameProgress(int gameFrame)
 #define DRAW_CALLIN(name)                                                   \
 	void CEventHandler:: Draw ## name ()                                    \
 	{                                                                       \
+		EVENT_TIMING_INFO(Draw ## name)                                     \
+                                                                            \
+		if (gu->simCatchingUp)                                              \
+			return;                                                         \
+                                                                            \
 		if (listDraw ## name.empty())                                       \
 			return;                                                         \
                                                                             \
@@ -592,6 +641,11 @@ DRAW_CALLIN(InMiniMapBackground)
 #define DRAW_ENTITY_CALLIN(name, args, args2)                               \
 	bool CEventHandler:: Draw ## name args                                  \
 	{                                                                       \
+		EVENT_TIMING_INFO(Draw ## name)                                     \
+                                                                            \
+		if (gu->simCatchingUp)                                              \
+			return false;                                                   \
+                                                                            \
 		bool skipEngineDrawing = false;                                     \
                                                                             \
 		for (size_t i = 0; i < listDraw ## name.size(); ) {                 \
@@ -614,6 +668,7 @@ DRAW_ENTITY_CALLIN(Projectile, (const CProjectile* projectile), (projectile))
 /******************************************************************************/
 
 #define CONTROL_REVERSE_ITERATE_DEF_TRUE(name, ...)                \
+	EVENT_TIMING_INFO(name)                                        \
 	for (size_t i = 0; i < list##name.size(); ++i) {               \
 		CEventClient* ec = list##name[list##name.size() - 1 - i];  \
                                                                    \
@@ -622,6 +677,7 @@ DRAW_ENTITY_CALLIN(Projectile, (const CProjectile* projectile), (projectile))
 	}
 
 #define CONTROL_REVERSE_ITERATE_STRING(name, ...)                  \
+	EVENT_TIMING_INFO(name)                                        \
 	for (size_t i = 0; i < list##name.size(); ++i) {               \
 		CEventClient* ec = list##name[list##name.size() - 1 - i];  \
 		const std::string& str = ec->name(__VA_ARGS__);            \
@@ -660,6 +716,7 @@ bool CEventHandler::TextInput(const std::string& utf8)
 
 bool CEventHandler::MousePress(int x, int y, int button)
 {
+	EVENT_TIMING_INFO(MousePress)
 	for (size_t i = 0; i < listMousePress.size(); i++) {
 		CEventClient* ec = listMousePress[listMousePress.size() - 1 - i];
 
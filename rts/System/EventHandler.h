@@ -40,6 +40,22 @@ class CEventHandler
 		bool IsUnsynced(const std::string& ciName) const;
 		bool IsController(const std::string& ciName) const;
 
+		/// index of an event in the (sorted) eventMap, -1 if unknown;
+		/// stable for the lifetime of the process since the event set
+		/// is fixed at compile-time (Events.def)
+		int GetEventID(const std::string& ciName) const;
+
+		// per-event dispatch counters, gathered by the call-in loops below
+		struct EventTiming {
+			unsigned int numCalls = 0; // dispatches issued (incl. ones with no subscribers)
+			unsigned int numExecs = 0; // client call-ins iterated over
+			spring_time  execTime;     // time spent inside non-empty dispatches
+		};
+
+		size_t GetNumEvents() const { return eventMap.size(); }
+		const std::string& GetEventName(int evtID) const { return eventMap[evtID].first; }
+		const EventTiming& GetEventTiming(int evtID) const { return eventTimings[evtID]; }
+
 
 	public:
 		/**
@@ -318,12 +334,37 @@ class CEventHandler
 		void ListInsert(EventClientList& ciList, CEventClient* ec);
 		void ListRemove(EventClientList& ciList, CEventClient* ec);
 
+		// accumulates wall-time spent inside one dispatch; clock reads are
+		// skipped for empty lists so idle call-ins only pay two increments
+		struct ScopedCallinTimer {
+			ScopedCallinTimer(EventTiming& et, size_t numClients)
+				: timing(et)
+				, timed(numClients != 0)
+			{
+				timing.numCalls += 1;
+				timing.numExecs += numClients;
+
+				if (timed)
+					startTime = spring_gettime();
+			}
+			~ScopedCallinTimer() {
+				if (timed)
+					timing.execTime += (spring_gettime() - startTime);
+			}
+
+			EventTiming& timing;
+			spring_time startTime;
+			const bool timed;
+		};
+
 	private:
 		CEventClient* mouseOwner;
 
 	private:
 		EventMap eventMap;
 
+		std::vector<EventTiming> eventTimings;
+
 		EventClientList handles;
 
 	#define SETUP_EVENT(name, props) EventClientList list ## name;
@@ -343,7 +384,14 @@ extern CEventHandler eventHandler;
 // Inlined call-in loops
 //
 
+// resolves the event ID once per call-site; must be the first statement
+// of every dispatch loop so empty dispatches are counted as well
+#define EVENT_TIMING_INFO(name)                                    \
+	static const int evtID = GetEventID(#name);                    \
+	ScopedCallinTimer evtTimer(eventTimings[evtID], list##name.size());
+
 #define ITERATE_EVENTCLIENTLIST(name, ...)                         \
+	EVENT_TIMING_INFO(name)                                        \
 	for (size_t i = 0; i < list##name.size(); ) {                  \
 		CEventClient* ec = list##name[i];                          \
 		ec->name(__VA_ARGS__);                                     \
@@ -353,6 +401,7 @@ extern CEventHandler eventHandler;
 	}
 
 #define ITERATE_ALLYTEAM_EVENTCLIENTLIST(name, allyTeam, ...)      \
+	EVENT_TIMING_INFO(name)                                        \
 	for (size_t i = 0; i < list##name.size(); ) {                  \
 		CEventClient* ec = list##name[i];                          \
                                                                    \
@@ -364,6 +413,7 @@ extern CEventHandler eventHandler;
 	}
 
 #define ITERATE_UNIT_ALLYTEAM_EVENTCLIENTLIST(name, unit, ...)     \
+	EVENT_TIMING_INFO(name)                                        \
 	const auto unitAllyTeam = unit->allyteam;                      \
 	for (size_t i = 0; i < list##name.size(); ) {                  \
 		CEventClient* ec = list##name[i];                          \
@@ -389,6 +439,7 @@ inline void CEventHandler::UnitDestroyed(const CUnit* unit, const CUnit* attacke
 #define UNIT_CALLIN_NO_PARAM(name)                                 \
 	inline void CEventHandler:: name (const CUnit* unit)           \
 	{                                                              \
+		EVENT_TIMING_INFO(name)                                    \
 		const auto unitAllyTeam = unit->allyteam;                  \
 		for (size_t i = 0; i < list##name.size(); ) {              \
 			CEventClient* ec = list##name[i];                      \
@@ -635,6 +686,7 @@ inline void CEventHandler::UnsyncedHeightMapUpdate(const SRectangle& rect)
 
 inline bool CEventHandler::Explosion(int weaponDefID, int projectileID, const float3& pos, const CUnit* owner)
 {
+	EVENT_TIMING_INFO(Explosion)
 	const size_t count = listExplosion.size();
 	bool noGfx = false;
 
@@ -661,6 +713,7 @@ inline bool CEventHandler::DefaultCommand(const CUnit* unit,
                                               const CFeature* feature,
                                               int& cmd)
 {
+	EVENT_TIMING_INFO(DefaultCommand)
 	const size_t count = listDefaultCommand.size();
 
 	// reverse order, user has the override
@@ -7,6 +7,14 @@
 #include <xmmintrin.h>
 #endif
 #include <cinttypes>
+#include <cstddef>
+
+// the batch kernels need SSE2 integer ops for the initial-guess bit
+// trick; same guard style as READMAP_USE_SSE2 (see ReadMap.cpp)
+#if (defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))) && !defined(DEDICATED_NOSSE)
+#define FASTMATH_USE_SSE2 1
+#include <emmintrin.h>
+#endif
 
 #include "lib/streflop/streflop_cond.h"
 #include "System/MainDefines.h"
@@ -158,6 +166,120 @@ namespace fastmath {
 	}
 
 
+	/****************** Batch kernels ******************/
+
+#ifdef FASTMATH_USE_SSE2
+	/**
+	* @brief four isqrt_nosse lanes (one Newton iteration)
+	*
+	* every operation mirrors the scalar version bit for bit (pure
+	* adds and multiplies, no rsqrtps), so synced callers can batch
+	* spans without affecting checksums
+	*/
+	inline __m128 isqrt_ps(__m128 x) {
+		const __m128 xh = _mm_mul_ps(_mm_set1_ps(0.5f), x);
+		__m128i i = _mm_castps_si128(x);
+		i = _mm_sub_epi32(_mm_set1_epi32(0x5f375a86), _mm_srai_epi32(i, 1));
+		x = _mm_castsi128_ps(i);
+		x = _mm_mul_ps(x, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(xh, _mm_mul_ps(x, x))));
+		return x;
+	}
+
+	/** @brief four isqrt2_nosse lanes (two Newton iterations) */
+	inline __m128 isqrt2_ps(__m128 x) {
+		const __m128 xh = _mm_mul_ps(_mm_set1_ps(0.5f), x);
+		__m128i i = _mm_castps_si128(x);
+		i = _mm_sub_epi32(_mm_set1_epi32(0x5f375a86), _mm_srai_epi32(i, 1));
+		x = _mm_castsi128_ps(i);
+		x = _mm_mul_ps(x, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(xh, _mm_mul_ps(x, x))));
+		x = _mm_mul_ps(x, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(xh, _mm_mul_ps(x, x))));
+		return x;
+	}
+#endif
+
+	/**
+	* @brief isqrt2_nosse over a span; in-place (out == in) is allowed
+	*/
+	inline void isqrt2_batch(const float* in, float* out, size_t count) {
+		size_t i = 0;
+
+	#ifdef FASTMATH_USE_SSE2
+		for (; (i + 4) <= count; i += 4) {
+			_mm_storeu_ps(&out[i], isqrt2_ps(_mm_loadu_ps(&in[i])));
+		}
+	#endif
+
+		for (; i < count; i++) {
+			out[i] = isqrt2_nosse(in[i]);
+		}
+	}
+
+	/**
+	* @brief apxsqrt over a span; in-place (out == in) is allowed
+	*/
+	inline void apxsqrt_batch(const float* in, float* out, size_t count) {
+		size_t i = 0;
+
+	#ifdef FASTMATH_USE_SSE2
+		for (; (i + 4) <= count; i += 4) {
+			const __m128 x = _mm_loadu_ps(&in[i]);
+			_mm_storeu_ps(&out[i], _mm_mul_ps(x, isqrt_ps(x)));
+		}
+	#endif
+
+		for (; i < count; i++) {
+			out[i] = apxsqrt(in[i]);
+		}
+	}
+
+	/**
+	* @brief normalizes <count> packed xyz triples in place
+	*
+	* matches float3::SafeANormalize element for element (length
+	* computation, epsilon test and isqrt2 scale); only the scale
+	* factors go through SIMD since the triples are AoS
+	*/
+	inline void norm3_batch(float* xyz, size_t count) {
+		constexpr float eps = 1e-12f; // float3::nrm_eps()
+		size_t i = 0;
+
+	#ifdef FASTMATH_USE_SSE2
+		for (; (i + 4) <= count; i += 4) {
+			float* v = &xyz[i * 3];
+
+			alignas(16) float sqls[4];
+			alignas(16) float scls[4];
+
+			for (int j = 0; j < 4; j++) {
+				sqls[j] = v[j * 3 + 0] * v[j * 3 + 0] + v[j * 3 + 1] * v[j * 3 + 1] + v[j * 3 + 2] * v[j * 3 + 2];
+			}
+
+			_mm_store_ps(scls, isqrt2_ps(_mm_load_ps(sqls)));
+
+			for (int j = 0; j < 4; j++) {
+				if (sqls[j] > eps) {
+					v[j * 3 + 0] *= scls[j];
+					v[j * 3 + 1] *= scls[j];
+					v[j * 3 + 2] *= scls[j];
+				}
+			}
+		}
+	#endif
+
+		for (; i < count; i++) {
+			float* v = &xyz[i * 3];
+			const float sql = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+
+			if (sql > eps) {
+				const float s = isqrt2_nosse(sql);
+				v[0] *= s;
+				v[1] *= s;
+				v[2] *= s;
+			}
+		}
+	}
+
+
 	/****************** Trigonometric functions ******************/
 
 	/**
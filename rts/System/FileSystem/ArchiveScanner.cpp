@@ -3,7 +3,9 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <memory>
 
 #include <sys/types.h>
@@ -52,7 +54,7 @@ LOG_REGISTER_SECTION_GLOBAL(LOG_SECTION_ARCHIVESCANNER)
  * but mapping them all, every time to make the list is)
  */
 
-constexpr int INTERNAL_VER = 11;
+constexpr int INTERNAL_VER = 12;
 
 
 /*
@@ -362,7 +364,7 @@ static std::atomic<uint32_t> numScannedArchives{0};
 CArchiveScanner::CArchiveScanner(): isDirty(false)
 {
 	// the "cache" dir is created in DataDirLocater
-	ReadCacheData(cachefile = FileSystem::EnsurePathSepAtEnd(FileSystem::GetCacheDir()) + IntToString(INTERNAL_VER, "ArchiveCache%i.lua"));
+	ReadCacheData(cachefile = FileSystem::EnsurePathSepAtEnd(FileSystem::GetCacheDir()) + IntToString(INTERNAL_VER, "ArchiveCache%i.bin"));
 	ScanAllDirs();
 }
 
@@ -481,7 +483,9 @@ void CArchiveScanner::ScanDir(const std::string& curPath, std::deque<std::string
 				foundArchives.push_front(fileNameNoSep); // push in reverse order!
 				continue;
 			}
-			if (FileSystem::DirExists(fileNameNoSep)) {
+			// FindFiles marks directories with a trailing separator,
+			// no need to re-stat (which is slow on network mounts)
+			if (fileName.size() != fileNameNoSep.size()) {
 				subDirs.push_back(fileNameNoSep);
 			}
 		}
@@ -769,6 +773,7 @@ unsigned int CArchiveScanner::GetCRC(const std::string& arcName)
 		std::string* filename;
 		unsigned int nameCRC;
 		unsigned int dataCRC;
+		unsigned int modTime;
 	};
 
 	// try to open an archive
@@ -799,7 +804,17 @@ unsigned int CArchiveScanner::GetCRC(const std::string& arcName)
 	std::stable_sort(files.begin(), files.end());
 
 	for (std::string& f: files) {
-		crcs.push_back(CRCPair{&f, 0, 0});
+		crcs.push_back(CRCPair{&f, 0, 0, 0});
+	}
+
+	// per-member CRCs cached from the previous scan of this (dir) archive;
+	// read-only while the loop below runs
+	const std::map<std::string, FileCRCInfo>* oldFileCRCs = nullptr;
+	{
+		const auto it = dirFileCRCs.find(StringToLower(FileSystem::GetFilename(arcName)));
+
+		if (it != dirFileCRCs.end())
+			oldFileCRCs = &(it->second);
 	}
 
 	// compute CRCs of the files
@@ -812,14 +827,50 @@ unsigned int CArchiveScanner::GetCRC(const std::string& arcName)
 		assert(crcp.filename == &files[i]);
 		const unsigned int nameCRC = CRC::GetCRC(crcp.filename->data(), crcp.filename->size());
 		const unsigned fid = ar->FindFile(*crcp.filename);
-		const unsigned int dataCRC = ar->GetCrc32(fid);
+		const unsigned int modTime = ar->FileModTime(fid);
+
 		crcp.nameCRC = nameCRC;
-		crcp.dataCRC = dataCRC;
+		crcp.modTime = modTime;
+
+		// reuse the cached hash if the member was not modified since
+		if (modTime != 0 && oldFileCRCs != nullptr) {
+			const auto it = oldFileCRCs->find(*crcp.filename);
+
+			if (it != oldFileCRCs->end() && it->second.modified == modTime) {
+				crcp.dataCRC = it->second.dataCRC;
+				return;
+			}
+		}
+
+		crcp.dataCRC = ar->GetCrc32(fid);
 	#if !defined(DEDICATED) && !defined(UNITSYNC)
 		Watchdog::ClearTimer(WDT_MAIN);
 	#endif
 	});
 
+	// remember the per-member hashes of archives that report modification
+	// times (dir archives), so the next rescan only rehashes changed files
+	{
+		std::map<std::string, FileCRCInfo> newFileCRCs;
+
+		for (const CRCPair& crcp: crcs) {
+			if (crcp.modTime == 0)
+				continue;
+
+			FileCRCInfo& fci = newFileCRCs[*crcp.filename];
+			fci.modified = crcp.modTime;
+			fci.dataCRC = crcp.dataCRC;
+		}
+
+		const std::string lcName = StringToLower(FileSystem::GetFilename(arcName));
+
+		if (!newFileCRCs.empty()) {
+			dirFileCRCs[lcName] = std::move(newFileCRCs);
+		} else {
+			dirFileCRCs.erase(lcName);
+		}
+	}
+
 	// Add file CRCs to the main archive CRC
 	for (const CRCPair& crcp: crcs) {
 		crc.Update(crcp.nameCRC);
@@ -842,6 +893,74 @@ void CArchiveScanner::ComputeChecksumForArchive(const std::string& filePath)
 }
 
 
+// cache-file layout: [magic][internalVer][payload crc][payload]; fields
+// are native-endian since the cache is local to one machine and rebuilt
+// from scratch whenever it cannot be read back
+static const char CACHE_FILE_MAGIC[4] = {'S', 'A', 'C', '0'};
+
+namespace {
+
+struct CacheFileWriter {
+	std::vector<std::uint8_t> buf;
+
+	void PutU32(std::uint32_t v) {
+		const std::uint8_t* p = reinterpret_cast<const std::uint8_t*>(&v);
+		buf.insert(buf.end(), p, p + sizeof(v));
+	}
+	void PutFloat(float v) {
+		std::uint32_t u = 0;
+		std::memcpy(&u, &v, sizeof(u));
+		PutU32(u);
+	}
+	void PutStr(const std::string& s) {
+		PutU32(s.size());
+		buf.insert(buf.end(), s.begin(), s.end());
+	}
+};
+
+struct CacheFileReader {
+	const std::uint8_t* data;
+	std::size_t size;
+	std::size_t pos;
+	bool ok;
+
+	CacheFileReader(const std::uint8_t* d, std::size_t s): data(d), size(s), pos(0), ok(true) {}
+
+	std::uint32_t GetU32() {
+		std::uint32_t v = 0;
+
+		if (ok && (size - pos) >= sizeof(v)) {
+			std::memcpy(&v, data + pos, sizeof(v));
+			pos += sizeof(v);
+		} else {
+			ok = false;
+		}
+
+		return v;
+	}
+	float GetFloat() {
+		const std::uint32_t u = GetU32();
+		float v = 0.0f;
+		std::memcpy(&v, &u, sizeof(v));
+		return v;
+	}
+	std::string GetStr() {
+		std::string s;
+		const std::uint32_t len = GetU32();
+
+		if (ok && (size - pos) >= len) {
+			s.assign(reinterpret_cast<const char*>(data + pos), len);
+			pos += len;
+		} else {
+			ok = false;
+		}
+
+		return s;
+	}
+};
+
+}
+
 void CArchiveScanner::ReadCacheData(const std::string& filename)
 {
 	std::lock_guard<spring::recursive_mutex> lck(scannerMutex);
@@ -850,69 +969,124 @@ void CArchiveScanner::ReadCacheData(const std::string& filename)
 		return;
 	}
 
-	LuaParser p(filename, SPRING_VFS_RAW, SPRING_VFS_BASE);
-	if (!p.Execute()) {
-		LOG_L(L_ERROR, "Failed to parse ArchiveCache: %s", p.GetErrorLog().c_str());
+	// slurp the whole cache in one read and parse the flat payload in
+	// place; this replaces re-executing ArchiveCache.lua through the
+	// LuaParser at every startup, which dominated cold-start time with
+	// large map/mod collections
+	FILE* in = fopen(filename.c_str(), "rb");
+	if (in == nullptr) {
+		LOG_L(L_ERROR, "Failed to read from \"%s\"!", filename.c_str());
 		return;
 	}
 
-	const LuaTable& archiveCache = p.GetRoot();
-	const LuaTable& archives = archiveCache.SubTable("archives");
-	const LuaTable& brokenArchives = archiveCache.SubTable("brokenArchives");
+	fseek(in, 0, SEEK_END);
+	const long fileSize = ftell(in);
+	fseek(in, 0, SEEK_SET);
+
+	std::vector<std::uint8_t> fileBuf(std::max(0L, fileSize));
+	const bool readOK = (fread(fileBuf.data(), 1, fileBuf.size(), in) == fileBuf.size());
+	fclose(in);
+
+	constexpr std::size_t headerSize = sizeof(CACHE_FILE_MAGIC) + 2 * sizeof(std::uint32_t);
 
-	// Do not load old version caches
-	const int ver = archiveCache.GetInt("internalVer", (INTERNAL_VER + 1));
-	if (ver != INTERNAL_VER)
+	if (!readOK || fileBuf.size() < headerSize || memcmp(fileBuf.data(), CACHE_FILE_MAGIC, sizeof(CACHE_FILE_MAGIC)) != 0) {
+		LOG_L(L_WARNING, "ArchiveCache %s is not a valid cache file", filename.c_str());
 		return;
+	}
+
+	CacheFileReader r(fileBuf.data() + sizeof(CACHE_FILE_MAGIC), fileBuf.size() - sizeof(CACHE_FILE_MAGIC));
+
+	// do not load old version caches
+	if (r.GetU32() != INTERNAL_VER)
+		return;
+
+	const std::uint32_t payloadCRC = r.GetU32();
+
+	if (CRC::GetCRC(fileBuf.data() + headerSize, fileBuf.size() - headerSize) != payloadCRC) {
+		LOG_L(L_WARNING, "ArchiveCache %s is corrupted, rescanning", filename.c_str());
+		return;
+	}
+
+	const std::uint32_t numArchives = r.GetU32();
 
-	for (int i = 1; archives.KeyExists(i); ++i) {
-		const LuaTable& curArchive = archives.SubTable(i);
-		const LuaTable& archived = curArchive.SubTable("archivedata");
-		std::string name = curArchive.GetString("name", "");
+	for (std::uint32_t i = 0; (i < numArchives) && r.ok; i++) {
+		const std::string name = r.GetStr();
 
 		ArchiveInfo& ai = archiveInfos[StringToLower(name)];
 		ai.origName = name;
-		ai.path     = curArchive.GetString("path", "");
-
-		// do not use LuaTable.GetInt() for 32-bit integers: the Spring lua
-		// library uses 32-bit floats to represent numbers, which can only
-		// represent 2^24 consecutive integers
-		ai.modified = strtoul(curArchive.GetString("modified", "0").c_str(), 0, 10);
-		ai.checksum = strtoul(curArchive.GetString("checksum", "0").c_str(), 0, 10);
-		ai.updated = false;
-
-		ai.archiveData = CArchiveScanner::ArchiveData(archived, true);
-		if (ai.archiveData.IsMap()) {
-			AddDependency(ai.archiveData.GetDependencies(), GetMapHelperContentName());
-		} else if (ai.archiveData.IsGame()) {
-			AddDependency(ai.archiveData.GetDependencies(), GetSpringBaseContentName());
+		ai.path     = r.GetStr();
+		ai.modified = r.GetU32();
+		ai.checksum = r.GetU32();
+		ai.updated  = false;
+
+		// written for symmetry but (as with the old Lua cache) not
+		// restored, replacements are recomputed while scanning
+		r.GetStr();
+
+		ArchiveData& ad = ai.archiveData;
+
+		const std::uint32_t numInfoItems = r.GetU32();
+
+		for (std::uint32_t j = 0; (j < numInfoItems) && r.ok; j++) {
+			const std::string key = r.GetStr();
+
+			switch (r.GetU32()) {
+				case INFO_VALUE_TYPE_STRING : { ad.SetInfoItemValueString (key,      r.GetStr()      ); } break;
+				case INFO_VALUE_TYPE_INTEGER: { ad.SetInfoItemValueInteger(key, int( r.GetU32())     ); } break;
+				case INFO_VALUE_TYPE_FLOAT  : { ad.SetInfoItemValueFloat  (key,      r.GetFloat()    ); } break;
+				case INFO_VALUE_TYPE_BOOL   : { ad.SetInfoItemValueBool   (key,     (r.GetU32() != 0)); } break;
+				default                     : { r.ok = false;                                          } break;
+			}
+		}
+
+		const std::uint32_t numDeps = r.GetU32();
+
+		for (std::uint32_t j = 0; (j < numDeps) && r.ok; j++) {
+			ad.GetDependencies().push_back(r.GetStr());
+		}
+
+		if (ad.IsMap()) {
+			AddDependency(ad.GetDependencies(), GetMapHelperContentName());
+		} else if (ad.IsGame()) {
+			AddDependency(ad.GetDependencies(), GetSpringBaseContentName());
 		}
 	}
 
-	for (int i = 1; brokenArchives.KeyExists(i); ++i) {
-		const LuaTable& curArchive = brokenArchives.SubTable(i);
-		const std::string& name = StringToLower(curArchive.GetString("name", ""));
+	const std::uint32_t numBrokenArchives = r.GetU32();
+
+	for (std::uint32_t i = 0; (i < numBrokenArchives) && r.ok; i++) {
+		const std::string name = StringToLower(r.GetStr());
 
 		BrokenArchive& ba = this->brokenArchives[name];
-		ba.path = curArchive.GetString("path", "");
-		ba.modified = strtoul(curArchive.GetString("modified", "0").c_str(), 0, 10);
-		ba.updated = false;
-		ba.problem = curArchive.GetString("problem", "unknown");
+		ba.path     = r.GetStr();
+		ba.modified = r.GetU32();
+		ba.updated  = false;
+		ba.problem  = r.GetStr();
 	}
 
-	isDirty = false;
-}
+	const std::uint32_t numDirArchives = r.GetU32();
 
-static inline void SafeStr(FILE* out, const char* prefix, const std::string& str)
-{
-	if (str.empty())
-		return;
+	for (std::uint32_t i = 0; (i < numDirArchives) && r.ok; i++) {
+		std::map<std::string, FileCRCInfo>& fileCRCs = dirFileCRCs[StringToLower(r.GetStr())];
 
-	if ( (str.find_first_of("\\\"") != std::string::npos) || (str.find_first_of("\n") != std::string::npos )) {
-		fprintf(out, "%s[[%s]],\n", prefix, str.c_str());
-	} else {
-		fprintf(out, "%s\"%s\",\n", prefix, str.c_str());
+		const std::uint32_t numFiles = r.GetU32();
+
+		for (std::uint32_t j = 0; (j < numFiles) && r.ok; j++) {
+			FileCRCInfo& fci = fileCRCs[r.GetStr()];
+			fci.modified = r.GetU32();
+			fci.dataCRC  = r.GetU32();
+		}
 	}
+
+	if (!r.ok) {
+		LOG_L(L_WARNING, "ArchiveCache %s is truncated, rescanning", filename.c_str());
+		archiveInfos.clear();
+		brokenArchives.clear();
+		dirFileCRCs.clear();
+		return;
+	}
+
+	isDirty = false;
 }
 
 void FilterDep(std::vector<std::string>& deps, const std::string& exclude)
@@ -927,12 +1101,6 @@ void CArchiveScanner::WriteCacheData(const std::string& filename)
 	if (!isDirty)
 		return;
 
-	FILE* out = fopen(filename.c_str(), "wt");
-	if (out == nullptr) {
-		LOG_L(L_ERROR, "Failed to write to \"%s\"!", filename.c_str());
-		return;
-	}
-
 	// First delete all outdated information
 	spring::map_erase_if(archiveInfos, [](const decltype(archiveInfos)::value_type& p) {
 		return !p.second.updated;
@@ -940,73 +1108,96 @@ void CArchiveScanner::WriteCacheData(const std::string& filename)
 	spring::map_erase_if(brokenArchives, [](const decltype(brokenArchives)::value_type& p) {
 		return !p.second.updated;
 	});
+	// drop per-member hash tables of archives that no longer exist
+	spring::map_erase_if(dirFileCRCs, [&](const decltype(dirFileCRCs)::value_type& p) {
+		return (archiveInfos.find(p.first) == archiveInfos.end());
+	});
+
+	CacheFileWriter w;
 
-	fprintf(out, "local archiveCache = {\n\n");
-	fprintf(out, "\tinternalver = %i,\n\n", INTERNAL_VER);
-	fprintf(out, "\tarchives = {  -- count = %u\n", unsigned(archiveInfos.size()));
+	w.PutU32(archiveInfos.size());
 
 	for (const auto& arcIt: archiveInfos) {
 		const ArchiveInfo& arcInfo = arcIt.second;
 
-		fprintf(out, "\t\t{\n");
-		SafeStr(out, "\t\t\tname = ",              arcInfo.origName);
-		SafeStr(out, "\t\t\tpath = ",              arcInfo.path);
-		fprintf(out, "\t\t\tmodified = \"%u\",\n", arcInfo.modified);
-		fprintf(out, "\t\t\tchecksum = \"%u\",\n", arcInfo.checksum);
-		SafeStr(out, "\t\t\treplaced = ",          arcInfo.replaced);
+		w.PutStr(arcInfo.origName);
+		w.PutStr(arcInfo.path);
+		w.PutU32(arcInfo.modified);
+		w.PutU32(arcInfo.checksum);
+		w.PutStr(arcInfo.replaced);
 
-		// mod info?
 		const ArchiveData& archData = arcInfo.archiveData;
-		if (!archData.GetName().empty()) {
-			fprintf(out, "\t\t\tarchivedata = {\n");
-
-			for (const auto& ii: archData.GetInfo()) {
-				if (ii.second.valueType == INFO_VALUE_TYPE_STRING) {
-					SafeStr(out, std::string("\t\t\t\t" + ii.first + " = ").c_str(), ii.second.valueTypeString);
-				} else {
-					fprintf(out, "\t\t\t\t%s = %s,\n", ii.first.c_str(), ii.second.GetValueAsString(false).c_str());
-				}
-			}
+		const std::map<std::string, InfoItem>& infoItems = archData.GetInfo();
 
-			std::vector<std::string> deps = archData.GetDependencies();
-			if (archData.IsMap()) {
-				FilterDep(deps, GetMapHelperContentName());
-			} else if (archData.IsGame()) {
-				FilterDep(deps, GetSpringBaseContentName());
-			}
+		w.PutU32(infoItems.size());
 
-			if (!deps.empty()) {
-				fprintf(out, "\t\t\t\tdepend = {\n");
-				for (unsigned d = 0; d < deps.size(); d++) {
-					SafeStr(out, "\t\t\t\t\t", deps[d]);
-				}
-				fprintf(out, "\t\t\t\t},\n");
+		for (const auto& ii: infoItems) {
+			w.PutStr(ii.first);
+			w.PutU32(ii.second.valueType);
+
+			switch (ii.second.valueType) {
+				case INFO_VALUE_TYPE_STRING : { w.PutStr(ii.second.valueTypeString);                } break;
+				case INFO_VALUE_TYPE_INTEGER: { w.PutU32(std::uint32_t(ii.second.value.typeInteger)); } break;
+				case INFO_VALUE_TYPE_FLOAT  : { w.PutFloat(ii.second.value.typeFloat);              } break;
+				case INFO_VALUE_TYPE_BOOL   : { w.PutU32(ii.second.value.typeBool);                 } break;
+				default                     : {                                                     } break;
 			}
-			fprintf(out, "\t\t\t},\n");
 		}
 
-		fprintf(out, "\t\t},\n");
+		std::vector<std::string> deps = archData.GetDependencies();
+		if (archData.IsMap()) {
+			FilterDep(deps, GetMapHelperContentName());
+		} else if (archData.IsGame()) {
+			FilterDep(deps, GetSpringBaseContentName());
+		}
+
+		w.PutU32(deps.size());
+
+		for (const std::string& dep: deps) {
+			w.PutStr(dep);
+		}
 	}
 
-	fprintf(out, "\t},\n\n"); // close 'archives'
-	fprintf(out, "\tbrokenArchives = {  -- count = %u\n", unsigned(brokenArchives.size()));
+	w.PutU32(brokenArchives.size());
 
 	for (const auto& bai: brokenArchives) {
 		const BrokenArchive& ba = bai.second;
 
-		fprintf(out, "\t\t{\n");
-		SafeStr(out, "\t\t\tname = ", bai.first);
-		SafeStr(out, "\t\t\tpath = ", ba.path);
-		fprintf(out, "\t\t\tmodified = \"%u\",\n", ba.modified);
-		SafeStr(out, "\t\t\tproblem = ", ba.problem);
-		fprintf(out, "\t\t},\n");
+		w.PutStr(bai.first);
+		w.PutStr(ba.path);
+		w.PutU32(ba.modified);
+		w.PutStr(ba.problem);
+	}
+
+	w.PutU32(dirFileCRCs.size());
+
+	for (const auto& dfc: dirFileCRCs) {
+		w.PutStr(dfc.first);
+		w.PutU32(dfc.second.size());
+
+		for (const auto& fci: dfc.second) {
+			w.PutStr(fci.first);
+			w.PutU32(fci.second.modified);
+			w.PutU32(fci.second.dataCRC);
+		}
 	}
 
-	fprintf(out, "\t},\n"); // close 'brokenArchives'
-	fprintf(out, "}\n\n"); // close 'archiveCache'
-	fprintf(out, "return archiveCache\n");
+	FILE* out = fopen(filename.c_str(), "wb");
+	if (out == nullptr) {
+		LOG_L(L_ERROR, "Failed to write to \"%s\"!", filename.c_str());
+		return;
+	}
+
+	const std::uint32_t cacheVer   = INTERNAL_VER;
+	const std::uint32_t payloadCRC = CRC::GetCRC(w.buf.data(), w.buf.size());
+
+	bool writeOK = true;
+	writeOK &= (fwrite(CACHE_FILE_MAGIC, 1, sizeof(CACHE_FILE_MAGIC), out) == sizeof(CACHE_FILE_MAGIC));
+	writeOK &= (fwrite(&cacheVer, 1, sizeof(cacheVer), out) == sizeof(cacheVer));
+	writeOK &= (fwrite(&payloadCRC, 1, sizeof(payloadCRC), out) == sizeof(payloadCRC));
+	writeOK &= (fwrite(w.buf.data(), 1, w.buf.size(), out) == w.buf.size());
 
-	if (fclose(out) == EOF)
+	if (fclose(out) == EOF || !writeOK)
 		LOG_L(L_ERROR, "Failed to write to \"%s\"!", filename.c_str());
 
 	isDirty = false;
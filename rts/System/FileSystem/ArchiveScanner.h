@@ -160,6 +160,18 @@ private:
 		unsigned int checksum;
 		bool updated;
 	};
+	/**
+	 * Cached per-member hash of a dir (.sdd) archive; lets a rescan skip
+	 * rehashing members whose modification time did not change.
+	 */
+	struct FileCRCInfo {
+		FileCRCInfo()
+			: modified(0)
+			, dataCRC(0)
+			{}
+		unsigned int modified;
+		unsigned int dataCRC;
+	};
 	struct BrokenArchive {
 		BrokenArchive()
 			: modified(0)
@@ -223,6 +235,8 @@ private:
 private:
 	std::map<std::string, ArchiveInfo> archiveInfos;
 	std::map<std::string, BrokenArchive> brokenArchives;
+	/// <lower-case archive name, <lower-case member name, crc info>>
+	std::map<std::string, std::map<std::string, FileCRCInfo>> dirFileCRCs;
 
 	bool isDirty;
 	std::string cachefile;
@@ -10,9 +10,7 @@ CBufferedArchive::CBufferedArchive(const std::string& name, bool cache)
 	caching = cache;
 }
 
-CBufferedArchive::~CBufferedArchive()
-{
-}
+CBufferedArchive::~CBufferedArchive() = default;
 
 bool CBufferedArchive::GetFile(unsigned int fid, std::vector<std::uint8_t>& buffer)
 {
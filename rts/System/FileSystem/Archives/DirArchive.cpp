@@ -6,8 +6,10 @@
 #include <assert.h>
 #include <fstream>
 
+#include "System/CRC.h"
 #include "System/FileSystem/DataDirsAccess.h"
 #include "System/FileSystem/FileSystem.h"
+#include "System/FileSystem/FileSystemAbstraction.h"
 #include "System/FileSystem/FileQueryFlags.h"
 #include "System/StringUtil.h"
 
@@ -77,6 +79,35 @@ bool CDirArchive::GetFile(unsigned int fid, std::vector<std::uint8_t>& buffer)
 	}
 }
 
+unsigned int CDirArchive::GetCrc32(unsigned int fid)
+{
+	assert(IsFileId(fid));
+
+	// hash in chunks instead of slurping the whole file; keeps memory
+	// bounded and lets the OS read ahead while the previous chunk is
+	// being hashed
+	const std::string rawpath = dataDirsAccess.LocateFile(dirName + searchFiles[fid]);
+	std::ifstream ifs(rawpath.c_str(), std::ios::in | std::ios::binary);
+
+	if (ifs.bad() || !ifs.is_open())
+		return 0;
+
+	CRC crc;
+	std::vector<char> buffer(64 * 1024);
+
+	while (ifs.read(buffer.data(), buffer.size()), ifs.gcount() > 0) {
+		crc.Update(buffer.data(), ifs.gcount());
+	}
+
+	return crc.GetDigest();
+}
+
+unsigned int CDirArchive::FileModTime(unsigned int fid) const
+{
+	assert(IsFileId(fid));
+	return FileSystemAbstraction::GetFileModificationTime(dataDirsAccess.LocateFile(dirName + searchFiles[fid]));
+}
+
 void CDirArchive::FileInfo(unsigned int fid, std::string& name, int& size) const
 {
 	assert(IsFileId(fid));
@@ -37,6 +37,8 @@ public:
 	virtual unsigned int NumFiles() const;
 	virtual bool GetFile(unsigned int fid, std::vector<std::uint8_t>& buffer);
 	virtual void FileInfo(unsigned int fid, std::string& name, int& size) const;
+	virtual unsigned int GetCrc32(unsigned int fid);
+	virtual unsigned int FileModTime(unsigned int fid) const;
 
 private:
 	/// "ExampleArchive.sdd/"
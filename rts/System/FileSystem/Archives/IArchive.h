@@ -120,6 +120,13 @@ public:
 	 */
 	virtual unsigned int GetCrc32(unsigned int fid);
 
+	/**
+	 * Last-modification time of a file by its ID, where the backend can
+	 * provide one cheaply (dir archives); 0 otherwise. Non-zero values
+	 * let the scanner cache per-file hashes across rescans.
+	 */
+	virtual unsigned int FileModTime(unsigned int fid) const { return 0; }
+
 
 protected:
 	/// must be populated by the subclass
@@ -13,6 +13,7 @@
 
 #include "System/FileSystem/DataDirsAccess.h"
 #include "System/FileSystem/FileSystem.h"
+#include "System/FileSystem/MappedFile.h"
 #include "System/Exceptions.h"
 #include "System/StringUtil.h"
 #include "System/Log/ILog.h"
@@ -44,6 +45,29 @@ static bool gz_really_read(gzFile file, voidp buf, unsigned int len)
 	return gzread(file, (char*)buf, len) == len;
 }
 
+static bool inflate_chunk(std::uint8_t* in, size_t inSize, std::uint8_t* out, unsigned int outSize)
+{
+	z_stream zstream;
+	zstream.opaque = Z_NULL;
+	zstream.zalloc = Z_NULL;
+	zstream.zfree  = Z_NULL;
+	zstream.data_type = Z_BINARY;
+	zstream.next_in   = in;
+	zstream.avail_in  = inSize;
+	zstream.next_out  = out;
+	zstream.avail_out = outSize;
+
+	//+16 marks it's a gzip header
+	if (inflateInit2(&zstream, 15 + 16) != Z_OK)
+		return false;
+
+	const int ret = inflate(&zstream, Z_FINISH);
+	const bool ok = (ret == Z_STREAM_END && zstream.avail_out == 0);
+
+	inflateEnd(&zstream);
+	return ok;
+}
+
 CPoolArchive::CPoolArchive(const std::string& name)
 	: CBufferedArchive(name)
 	, isOpen(false)
@@ -137,14 +161,30 @@ bool CPoolArchive::GetFileImpl(unsigned int fid, std::vector<std::uint8_t>& buff
 
 	FileSystem::FixSlashes(rpath);
 	std::string path = dataDirsAccess.LocateFile(rpath);
+
+	unsigned int len = f->size;
+	buffer.resize(len);
+
+	// map the chunk read-only and inflate straight into the caller's
+	// buffer; this avoids the stdio copy and the (clean) compressed
+	// pages are shared with other engine instances reading the pool
+	MappedFile chunk;
+	if (chunk.Open(path, false)) {
+		if (len == 0 || inflate_chunk(chunk.GetData(), chunk.GetSize(), &buffer[0], len))
+			return true;
+
+		LOG_L(L_ERROR, "couldn't read %s", path.c_str());
+		buffer.clear();
+		return false;
+	}
+
+	// mapping can fail on exotic filesystems, fall back to gzread
 	gzFile in = gzopen(path.c_str(), "rb");
 	if (in == NULL){
+		buffer.clear();
 		return false;
 	}
 
-	unsigned int len = f->size;
-	buffer.resize(len);
-
 	int bytesread = (len == 0) ? 0 : gzread(in, (char *)&buffer[0], len);
 	gzclose(in);
 
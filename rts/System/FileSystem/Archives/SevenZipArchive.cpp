@@ -3,6 +3,7 @@
 #include "SevenZipArchive.h"
 
 #include <algorithm>
+#include <atomic>
 #include <stdexcept>
 #include <string.h> //memcpy
 
@@ -128,11 +129,16 @@ static inline std::string GetSystemErrorStr(WRes wres)
 
 
 
+// total decoded bytes held by the block caches of all open 7z archives
+static std::atomic<size_t> totalBlockCacheSize(0);
+
+
 CSevenZipArchive::CSevenZipArchive(const std::string& name):
 	CBufferedArchive(name, false),
 	blockIndex(0xFFFFFFFF),
 	outBuffer(NULL),
 	outBufferSize(0),
+	blockUseCounter(0),
 	tempBuf(NULL),
 	tempBufSize(0),
 	isOpen(false)
@@ -219,6 +225,11 @@ CSevenZipArchive::CSevenZipArchive(const std::string& name):
 
 CSevenZipArchive::~CSevenZipArchive()
 {
+	for (const CachedBlock& cb: blockCache) {
+		totalBlockCacheSize.fetch_sub(cb.bufferSize);
+		IAlloc_Free(&allocImp, cb.buffer);
+	}
+
 	if (outBuffer) {
 		IAlloc_Free(&allocImp, outBuffer);
 	}
@@ -245,6 +256,11 @@ bool CSevenZipArchive::GetFileImpl(unsigned int fid, std::vector<std::uint8_t>&
 {
 	assert(IsFileId(fid));
 
+	// swap a previously decoded copy of this file's solid block into the
+	// (blockIndex, outBuffer, outBufferSize) triple SzArEx_Extract checks
+	// before deciding to decode
+	SwapInCachedBlock(db.FileIndexToFolderIndexMap[fileData[fid].fp]);
+
 	// Get 7zip to decompress it
 	size_t offset;
 	size_t outSizeProcessed;
@@ -254,10 +270,70 @@ bool CSevenZipArchive::GetFileImpl(unsigned int fid, std::vector<std::uint8_t>&
 	if (res == SZ_OK) {
 		buffer.resize(outSizeProcessed);
 		memcpy(&buffer[0], (char*)outBuffer+offset, outSizeProcessed);
-		return true;
+	}
+
+	CacheCurrentBlock();
+	return (res == SZ_OK);
+}
+
+
+void CSevenZipArchive::SwapInCachedBlock(UInt32 folderIndex)
+{
+	for (size_t i = 0; i < blockCache.size(); i++) {
+		if (blockCache[i].blockIndex != folderIndex)
+			continue;
+
+		blockIndex = blockCache[i].blockIndex;
+		outBuffer = blockCache[i].buffer;
+		outBufferSize = blockCache[i].bufferSize;
+
+		totalBlockCacheSize.fetch_sub(blockCache[i].bufferSize);
+		blockCache.erase(blockCache.begin() + i);
+		return;
+	}
+
+	blockIndex = 0xFFFFFFFF;
+	outBuffer = NULL;
+	outBufferSize = 0;
+}
+
+void CSevenZipArchive::CacheCurrentBlock()
+{
+	if (outBuffer == NULL)
+		return;
+
+	if (blockIndex == ((UInt32)-1)) {
+		// no solid block attached to the decode, nothing to reuse
+		IAlloc_Free(&allocImp, outBuffer);
 	} else {
-		return false;
+		CachedBlock cb;
+		cb.blockIndex = blockIndex;
+		cb.buffer = outBuffer;
+		cb.bufferSize = outBufferSize;
+		cb.lastUse = ++blockUseCounter;
+
+		blockCache.push_back(cb);
+		totalBlockCacheSize.fetch_add(outBufferSize);
+
+		// evict least-recently-used blocks of this archive while over the
+		// shared budget; other archives shed theirs on their next access
+		while (blockCache.size() > 1 && totalBlockCacheSize.load() > BLOCK_CACHE_SIZE_LIMIT) {
+			size_t lru = 0;
+
+			for (size_t i = 1; i < blockCache.size(); i++) {
+				if (blockCache[i].lastUse < blockCache[lru].lastUse)
+					lru = i;
+			}
+
+			totalBlockCacheSize.fetch_sub(blockCache[lru].bufferSize);
+			IAlloc_Free(&allocImp, blockCache[lru].buffer);
+			blockCache.erase(blockCache.begin() + lru);
+		}
 	}
+
+	blockIndex = 0xFFFFFFFF;
+	outBuffer = NULL;
+	outBufferSize = 0;
 }
 
 void CSevenZipArchive::FileInfo(unsigned int fid, std::string& name, int& size) const
@@ -270,6 +346,7 @@ void CSevenZipArchive::FileInfo(unsigned int fid, std::string& name, int& size)
 
 const size_t CSevenZipArchive::COST_LIMIT_UNPACK_OVERSIZE = 32 * 1024;
 const size_t CSevenZipArchive::COST_LIMIT_DISC_READ       = 32 * 1024;
+const size_t CSevenZipArchive::BLOCK_CACHE_SIZE_LIMIT     = 128 * 1024 * 1024;
 
 bool CSevenZipArchive::HasLowReadingCost(unsigned int fid) const
 {
@@ -49,6 +49,27 @@ private:
 	Byte* outBuffer;
 	size_t outBufferSize;
 
+	/**
+	 * A decoded solid block kept around for reuse; extracting many small
+	 * files in non-block order re-decodes the same block otherwise.
+	 */
+	struct CachedBlock {
+		UInt32 blockIndex;
+		Byte* buffer;
+		size_t bufferSize;
+		unsigned int lastUse;
+	};
+
+	/// decoded blocks of this archive, LRU-evicted against a budget
+	/// shared by all open 7z archives
+	std::vector<CachedBlock> blockCache;
+	unsigned int blockUseCounter;
+
+	static const size_t BLOCK_CACHE_SIZE_LIMIT;
+
+	void SwapInCachedBlock(UInt32 folderIndex);
+	void CacheCurrentBlock();
+
 	/**
 	 * How much more unpacked data may be allowed in a solid block,
 	 * besides a meta-file.
@@ -52,6 +52,11 @@ bool CFileHandler::TryReadFromPWD(const string& fileName)
 	if (FileSystem::IsAbsolutePath(fileName))
 		return false;
 	const std::string fullpath(Platform::GetOrigCWD() + fileName);
+
+	if (fileMap.Open(fullpath, false)) {
+		fileSize = fileMap.GetSize();
+		return true;
+	}
 #else
 	const std::string fullpath(fileName);
 #endif
@@ -71,6 +76,15 @@ bool CFileHandler::TryReadFromRawFS(const string& fileName)
 {
 #ifndef TOOLS
 	const string rawpath = dataDirsAccess.LocateFile(fileName);
+
+	// map read-only; clean pages are shared with every other process
+	// reading the same file, and Read() turns into a plain memcpy
+	if (fileMap.Open(rawpath, false)) {
+		fileSize = fileMap.GetSize();
+		return true;
+	}
+
+	// mapping can fail on exotic filesystems or for empty files
 	ifs.open(rawpath.c_str(), std::ios::in | std::ios::binary);
 	if (ifs && !ifs.bad() && ifs.is_open()) {
 		ifs.seekg(0, std::ios_base::end);
@@ -126,6 +140,9 @@ void CFileHandler::Close()
 	fileSize = -1;
 
 	ifs.close();
+#ifndef TOOLS
+	fileMap.Close();
+#endif
 	fileBuffer.clear();
 }
 
@@ -169,6 +186,19 @@ bool CFileHandler::FileExists() const
 }
 
 
+const std::uint8_t* CFileHandler::GetMemoryData() const
+{
+#ifndef TOOLS
+	if (fileMap.IsOpen())
+		return fileMap.GetData();
+#endif
+	if (!fileBuffer.empty())
+		return fileBuffer.data();
+
+	return nullptr;
+}
+
+
 int CFileHandler::Read(void* buf, int length)
 {
 	if (ifs.is_open()) {
@@ -176,15 +206,16 @@ int CFileHandler::Read(void* buf, int length)
 		return ifs.gcount();
 	}
 
-	if (fileBuffer.empty())
+	const std::uint8_t* data = GetMemoryData();
+
+	if (data == nullptr)
 		return 0;
 
 	if ((length + filePos) > fileSize)
 		length = fileSize - filePos;
 
 	if (length > 0) {
-		assert(fileBuffer.size() >= (filePos + length));
-		memcpy(buf, &fileBuffer[filePos], length);
+		memcpy(buf, data + filePos, length);
 		filePos += length;
 	}
 
@@ -218,7 +249,7 @@ void CFileHandler::Seek(int length, std::ios_base::seekdir where)
 		ifs.seekg(length, where);
 		return;
 	}
-	if (fileBuffer.empty())
+	if (GetMemoryData() == nullptr)
 		return;
 
 	switch (where) {
@@ -234,7 +265,7 @@ bool CFileHandler::Eof() const
 	if (ifs.is_open())
 		return ifs.eof();
 
-	if (!fileBuffer.empty())
+	if (GetMemoryData() != nullptr)
 		return (filePos >= fileSize);
 
 	return true;
@@ -273,6 +304,37 @@ std::string CFileHandler::GetFileExt() const
 	return FileSystem::GetExtension(fileName);
 }
 
+
+const std::uint8_t* CFileHandler::GetView(size_t& size)
+{
+	size = 0;
+
+	if (!FileExists())
+		return nullptr;
+
+	if (ifs.is_open()) {
+		// stream-backed (mapping failed or refused); read the contents
+		// into memory once and serve the view from there
+		const int pos = GetPos();
+
+		fileBuffer.resize(fileSize);
+
+		ifs.clear();
+		ifs.seekg(0, std::ios_base::beg);
+		ifs.read(reinterpret_cast<char*>(fileBuffer.data()), fileSize);
+		ifs.close();
+
+		filePos = pos;
+	}
+
+	const std::uint8_t* data = GetMemoryData();
+
+	if (data != nullptr)
+		size = fileSize;
+
+	return data;
+}
+
 /******************************************************************************/
 
 std::vector<string> CFileHandler::FindFiles(const string& path,
@@ -11,6 +11,10 @@
 
 #include "VFSModes.h"
 
+#ifndef TOOLS
+	#include "MappedFile.h"
+#endif
+
 /**
  * This is for direct VFS file content access.
  * If you need data-dir related file and dir handling methods,
@@ -30,20 +34,30 @@ public:
 	void Open(const std::string& fileName, const std::string& modes = SPRING_VFS_RAW_FIRST);
 	void Close();
 
-	int Read(void* buf, int length);
+	virtual int Read(void* buf, int length);
 	int ReadString(void* buf, int length); //< stops after the first 0 char
-	void Seek(int pos, std::ios_base::seekdir where = std::ios_base::beg);
+	virtual void Seek(int pos, std::ios_base::seekdir where = std::ios_base::beg);
 
 	static bool FileExists(const std::string& filePath, const std::string& modes);
 	bool FileExists() const;
 
-	bool Eof() const;
-	int GetPos();
+	virtual bool Eof() const;
+	virtual int GetPos();
 	int FileSize() const;
 
 	bool LoadStringData(std::string& data);
 	std::string GetFileExt() const;
 
+	/**
+	 * Zero-copy view of the file contents for consumers that only need to
+	 * parse in place; backed by the memory-mapping for raw files (clean
+	 * pages are shared between engine instances) and by the load buffer
+	 * for VFS files. Stream-backed files are read into memory on first
+	 * use. The pointer stays valid until Close().
+	 * @return pointer to the contents, nullptr if no data is available
+	 */
+	virtual const std::uint8_t* GetView(size_t& size);
+
 	static bool InReadDir(const std::string& path);
 	static bool InWriteDir(const std::string& path);
 
@@ -68,8 +82,14 @@ protected:
 	static bool InsertRawDirs(std::set<std::string>& dirSet, const std::string& path, const std::string& pattern);
 	static bool InsertVFSDirs(std::set<std::string>& dirSet, const std::string& path, const std::string& pattern, int section);
 
+	/// in-memory contents, from the mapping or the VFS load buffer
+	const std::uint8_t* GetMemoryData() const;
+
 	std::string fileName;
 	std::ifstream ifs;
+#ifndef TOOLS
+	MappedFile fileMap;
+#endif
 	std::vector<std::uint8_t> fileBuffer;
 	int filePos;
 	int fileSize;
@@ -11,6 +11,7 @@
 #include "System/StringUtil.h"
 #include "System/Log/ILog.h"
 #include "System/Exceptions.h"
+#include "System/Threading/ThreadPool.h"
 
 #include <cassert>
 #include <sys/stat.h>
@@ -437,8 +438,17 @@ void FileSystemAbstraction::ChDir(const std::string& dir)
 	}
 }
 
-static void FindFiles(std::vector<std::string>& matches, const std::string& datadir, const std::string& dir, const boost::regex& regexPattern, int flags)
-{
+// enumerates a single directory level; sub-directories to descend
+// into are collected instead of recursed into so the caller can walk
+// them concurrently
+static void ListDirContent(
+	const std::string& datadir,
+	const std::string& dir,
+	const boost::regex& regexPattern,
+	int flags,
+	std::vector<std::string>& matches,
+	std::vector<std::string>& subDirs
+) {
 #ifdef _WIN32
 	WIN32_FIND_DATA wfd;
 	HANDLE hFind = FindFirstFile((datadir + dir + "\\*").c_str(), &wfd);
@@ -459,7 +469,7 @@ static void FindFiles(std::vector<std::string>& matches, const std::string& data
 						}
 					}
 					if (flags & FileQueryFlags::RECURSE) {
-						FindFiles(matches, datadir, dir + wfd.cFileName + "\\", regexPattern, flags);
+						subDirs.push_back(dir + wfd.cFileName + "\\");
 					}
 				}
 			}
@@ -478,13 +488,22 @@ static void FindFiles(std::vector<std::string>& matches, const std::string& data
 		if (ep->d_name[0] == '.')
 			continue;
 
-		// is it a file? (we just treat sockets / pipes / fifos / character&block devices as files...)
-		// (need to stat because d_type is DT_UNKNOWN on linux :-/)
-		struct stat info;
-		if (stat((datadir + dir + ep->d_name).c_str(), &info) != 0)
-			continue;
+		// most filesystems return the entry type together with the
+		// name; only fall back to a stat call for those that do not
+		// and for symlinks, which have to be resolved to whatever
+		// they point at (stat would follow them)
+		bool isDir = (ep->d_type == DT_DIR);
+
+		if (ep->d_type == DT_UNKNOWN || ep->d_type == DT_LNK) {
+			// (we just treat sockets / pipes / fifos / character&block devices as files...)
+			struct stat info;
+			if (stat((datadir + dir + ep->d_name).c_str(), &info) != 0)
+				continue;
 
-		if (!S_ISDIR(info.st_mode)) {
+			isDir = S_ISDIR(info.st_mode);
+		}
+
+		if (!isDir) {
 			if ((flags & FileQueryFlags::ONLY_DIRS) == 0) {
 				if (boost::regex_match(ep->d_name, regexPattern)) {
 					matches.push_back(dir + ep->d_name);
@@ -498,7 +517,7 @@ static void FindFiles(std::vector<std::string>& matches, const std::string& data
 				}
 			}
 			if (flags & FileQueryFlags::RECURSE) {
-				FindFiles(matches, datadir, dir + ep->d_name + "/", regexPattern, flags);
+				subDirs.push_back(dir + ep->d_name + "/");
 			}
 		}
 	}
@@ -507,6 +526,34 @@ static void FindFiles(std::vector<std::string>& matches, const std::string& data
 #endif
 }
 
+static void FindFiles(std::vector<std::string>& matches, const std::string& datadir, const std::string& dir, const boost::regex& regexPattern, int flags)
+{
+	std::vector<std::string> curDirs = {dir};
+	std::vector<std::string> nxtDirs;
+
+	// walk all directories of one depth level concurrently (latency
+	// from network mounts dominates large scans, not CPU); workers
+	// only touch their own slots so the results merge back in a
+	// deterministic order, level by level
+	while (!curDirs.empty()) {
+		std::vector< std::vector<std::string> > dirMatches(curDirs.size());
+		std::vector< std::vector<std::string> > dirSubDirs(curDirs.size());
+
+		for_mt(0, curDirs.size(), [&](const int i) {
+			ListDirContent(datadir, curDirs[i], regexPattern, flags, dirMatches[i], dirSubDirs[i]);
+		});
+
+		nxtDirs.clear();
+
+		for (size_t i = 0; i < curDirs.size(); i++) {
+			matches.insert(matches.end(), dirMatches[i].begin(), dirMatches[i].end());
+			nxtDirs.insert(nxtDirs.end(), dirSubDirs[i].begin(), dirSubDirs[i].end());
+		}
+
+		curDirs.swap(nxtDirs);
+	}
+}
+
 void FileSystemAbstraction::FindFiles(std::vector<std::string>& matches, const std::string& dataDir, const std::string& dir, const std::string& regex, int flags)
 {
 	const boost::regex regexPattern(regex);
@@ -3,21 +3,91 @@
 
 #include "GZFileHandler.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <string>
 #include <zlib.h>
 
 #include "FileQueryFlags.h"
 #include "FileSystem.h"
+#include "System/Log/ILog.h"
 
 
 #ifndef TOOLS
+	#include <chrono>
 	#include "DataDirsAccess.h"
 	#include "System/StringUtil.h"
 	#include "System/Platform/Misc.h"
+	#include "System/Threading/ThreadPool.h"
 #endif
 
-#define BUFFER_SIZE 8192
+const size_t CGZFileHandler::READAHEAD_SIZE = 1024 * 1024;
+
+
+// whether a plausible gzip member header (magic, no reserved flag
+// bits) starts at <src>; never produces a false negative for real
+// members, rare false positives only cost a sizing pass
+static bool IsMemberHeader(const std::uint8_t* src, size_t size)
+{
+	return (size >= 18 && src[0] == 0x1f && src[1] == 0x8b && src[2] == 0x08 && (src[3] & 0xe0) == 0);
+}
+
+static bool HasMultipleMembers(const std::uint8_t* src, size_t size)
+{
+	for (size_t i = 1; (i + 18) <= size; i++) {
+		if (IsMemberHeader(src + i, size - i))
+			return true;
+	}
+
+	return false;
+}
+
+// exact uncompressed size of a (possibly multi-member) gzip image;
+// decodes to the end discarding output, the per-member trailers only
+// store sizes mod 2^32 and give no member lengths to sum up-front
+static int SumInflatedSize(const std::uint8_t* src, size_t size)
+{
+	std::uint8_t scratch[64 * 1024];
+
+	z_stream zs;
+	zs.opaque = Z_NULL;
+	zs.zalloc = Z_NULL;
+	zs.zfree  = Z_NULL;
+	zs.data_type = Z_BINARY;
+	zs.next_in   = const_cast<std::uint8_t*>(src);
+	zs.avail_in  = size;
+
+	if (inflateInit2(&zs, 15 + 16) != Z_OK)
+		return -1;
+
+	int totalSize = 0;
+
+	for (int ret = Z_OK; ret != Z_STREAM_END || zs.avail_in > 0; ) {
+		zs.next_out  = scratch;
+		zs.avail_out = sizeof(scratch);
+
+		ret = inflate(&zs, Z_NO_FLUSH);
+		totalSize += (sizeof(scratch) - zs.avail_out);
+
+		if (ret == Z_STREAM_END) {
+			// trailing non-member bytes end the stream, like gzread()
+			if (!IsMemberHeader(zs.next_in, zs.avail_in))
+				break;
+
+			inflateReset(&zs);
+			continue;
+		}
+
+		if (ret != Z_OK) {
+			totalSize = -1;
+			break;
+		}
+	}
+
+	inflateEnd(&zs);
+	return totalSize;
+}
 
 
 //We must call Open from here since in the CFileHandler ctor
@@ -34,76 +104,341 @@ CGZFileHandler::CGZFileHandler(const std::string& fileName, const std::string& m
 }
 
 
-bool CGZFileHandler::ReadToBuffer(const std::string& path)
+CGZFileHandler::~CGZFileHandler()
 {
-	assert(fileBuffer.empty());
-
-	gzFile file = gzopen(path.c_str(), "rb");
-	if (file == Z_NULL)
-		return false;
+	WaitForReadAhead();
+	CloseStream();
+}
 
-	std::uint8_t unzipBuffer[BUFFER_SIZE];
 
-	while (true) {
-		int unzippedBytes = gzread(file, unzipBuffer, BUFFER_SIZE);
-		if (unzippedBytes < 0) {
-			fileBuffer.clear();
-			fileSize = -1;
-			gzclose(file);
-			return false;
-		}
-		if (unzippedBytes == 0)
-			break;
-		fileBuffer.insert(fileBuffer.end(), unzipBuffer, unzipBuffer + unzippedBytes);
-	}
-	gzclose(file);
+const std::uint8_t* CGZFileHandler::SrcData() const
+{
+#ifndef TOOLS
+	if (srcMap.IsOpen())
+		return srcMap.GetData();
+#endif
+	return srcBuffer.data();
+}
 
-	fileSize = fileBuffer.size();
-	return true;
+size_t CGZFileHandler::SrcSize() const
+{
+#ifndef TOOLS
+	if (srcMap.IsOpen())
+		return srcMap.GetSize();
+#endif
+	return srcBuffer.size();
 }
 
-bool CGZFileHandler::UncompressBuffer()
+
+bool CGZFileHandler::OpenStream()
 {
-	std::vector<std::uint8_t> compressed;
-	std::swap(compressed, fileBuffer);
+	const std::uint8_t* src = SrcData();
+	const size_t srcSize = SrcSize();
+
+	// files without a gzip header are served verbatim, like gzread() does
+	// (10 bytes member header + 8 bytes trailer is the smallest valid file)
+	if (srcSize < 18 || src[0] != 0x1f || src[1] != 0x8b) {
+		fileBuffer.assign(src, src + srcSize);
+		fileSize = fileBuffer.size();
 
+		srcBuffer.clear();
+#ifndef TOOLS
+		srcMap.Close();
+#endif
+		return true;
+	}
+
+	// ISIZE, the uncompressed length (mod 2^32) from the final member
+	// trailer; only valid for single-member files, images that (may)
+	// concatenate members - DemoRecorder streams one per flushed block -
+	// pay a sizing pass to measure all of them
+	fileSize = (src[srcSize - 4]) | (src[srcSize - 3] << 8) | (src[srcSize - 2] << 16) | (src[srcSize - 1] << 24);
+
+	if (HasMultipleMembers(src, srcSize))
+		fileSize = SumInflatedSize(src, srcSize);
+
+	if (fileSize < 0) {
+		srcBuffer.clear();
+#ifndef TOOLS
+		srcMap.Close();
+#endif
+		return false;
+	}
 
-	z_stream zstream;
 	zstream.opaque = Z_NULL;
 	zstream.zalloc = Z_NULL;
 	zstream.zfree  = Z_NULL;
 	zstream.data_type = Z_BINARY;
+	zstream.next_in   = const_cast<std::uint8_t*>(src);
+	zstream.avail_in  = srcSize;
 
 	//+16 marks it's a gzip header
-	inflateInit2(&zstream, 15 + 16);
+	if (inflateInit2(&zstream, 15 + 16) != Z_OK) {
+		fileSize = -1;
 
-	zstream.next_in   = &compressed[0];
-	zstream.avail_in  = compressed.size();
+		srcBuffer.clear();
+#ifndef TOOLS
+		srcMap.Close();
+#endif
+		return false;
+	}
 
-	std::uint8_t unzipBuffer[BUFFER_SIZE];
+	streaming = true;
+	streamEnded = false;
+	windowStart = 0;
+	window.clear();
+	return true;
+}
 
-	while (true) {
-		zstream.avail_out = BUFFER_SIZE;
-		zstream.next_out = unzipBuffer;
-		const int ret = inflate(&zstream, Z_NO_FLUSH);
-		if (ret != Z_OK) {
-			fileBuffer.clear();
-			fileSize = -1;
-			return false;
+
+void CGZFileHandler::RestartStream()
+{
+	inflateReset(&zstream);
+	zstream.next_in  = const_cast<std::uint8_t*>(SrcData());
+	zstream.avail_in = SrcSize();
+
+	window.clear();
+	windowStart = 0;
+	streamEnded = false;
+}
+
+
+void CGZFileHandler::CloseStream()
+{
+	if (streaming) {
+		inflateEnd(&zstream);
+		streaming = false;
+	}
+
+	streamEnded = true;
+	window.clear();
+	windowStart = 0;
+
+	srcBuffer.clear();
+#ifndef TOOLS
+	srcMap.Close();
+#endif
+}
+
+
+void CGZFileHandler::FillWindow()
+{
+	if (streamEnded)
+		return;
+
+	const size_t ofs = window.size();
+	window.resize(ofs + READAHEAD_SIZE);
+
+	zstream.next_out  = &window[ofs];
+	zstream.avail_out = READAHEAD_SIZE;
+
+	const int ret = inflate(&zstream, Z_NO_FLUSH);
+	window.resize(ofs + (READAHEAD_SIZE - zstream.avail_out));
+
+	if (ret == Z_STREAM_END) {
+		// continue across member boundaries of concatenated files
+		if (IsMemberHeader(zstream.next_in, zstream.avail_in)) {
+			inflateReset(&zstream);
+		} else {
+			streamEnded = true;
 		}
+	} else if (ret != Z_OK) {
+		LOG_L(L_ERROR, "[GZFileHandler] inflate error %d in \"%s\"", ret, fileName.c_str());
+		streamEnded = true;
+	}
+}
+
 
-		const size_t unzippedBytes = BUFFER_SIZE - zstream.avail_out;
-		fileBuffer.insert(fileBuffer.end(), unzipBuffer, unzipBuffer + unzippedBytes);
+void CGZFileHandler::SkipTo(int target)
+{
+	while (!streamEnded) {
+		const int windowEnd = windowStart + int(window.size());
 
-		if (ret == Z_STREAM_END)
+		if (windowEnd >= target)
 			break;
+
+		// everything decoded so far precedes the target, drop it
+		windowStart = windowEnd;
+		window.clear();
+		FillWindow();
 	}
+}
 
-	inflateEnd(&zstream);
 
+int CGZFileHandler::Read(void* buf, int length)
+{
+	if (!streaming)
+		return CFileHandler::Read(buf, length);
 
-	fileSize = fileBuffer.size();
-	return true;
+	if ((length + filePos) > fileSize)
+		length = fileSize - filePos;
+
+	int read = 0;
+	bool wantReadAhead = false;
+
+	{
+#ifndef TOOLS
+		std::lock_guard<spring::mutex> lck(streamMutex);
+#endif
+		// a backward seek happened, decode from the start again
+		if (filePos < windowStart)
+			RestartStream();
+
+		SkipTo(filePos);
+
+		while (read < length) {
+			const int windowEnd = windowStart + int(window.size());
+			const int avail = windowEnd - filePos;
+
+			if (avail <= 0) {
+				if (streamEnded)
+					break;
+
+				FillWindow();
+				continue;
+			}
+
+			const int take = std::min(length - read, avail);
+			memcpy(static_cast<std::uint8_t*>(buf) + read, &window[filePos - windowStart], take);
+			read += take;
+			filePos += take;
+		}
+
+		// drop consumed bytes once the window grows past the read-ahead size
+		if ((filePos - windowStart) > int(READAHEAD_SIZE)) {
+			window.erase(window.begin(), window.begin() + (filePos - windowStart));
+			windowStart = filePos;
+		}
+
+		wantReadAhead = (!streamEnded && ((windowStart + int(window.size())) - filePos) < int(READAHEAD_SIZE));
+	}
+
+	if (wantReadAhead)
+		StartReadAhead();
+
+	return read;
+}
+
+
+void CGZFileHandler::Seek(int length, std::ios_base::seekdir where)
+{
+	if (!streaming) {
+		CFileHandler::Seek(length, where);
+		return;
+	}
+
+#ifndef TOOLS
+	std::lock_guard<spring::mutex> lck(streamMutex);
+#endif
+	// just move the cursor; Read() restarts or skips the stream lazily,
+	// so the common save-and-restore seek pattern decodes nothing extra
+	switch (where) {
+		case std::ios_base::beg: { filePos = length; } break;
+		case std::ios_base::cur: { filePos += length; } break;
+		case std::ios_base::end: { filePos = fileSize + length; } break;
+		default: {} break;
+	}
+}
+
+
+bool CGZFileHandler::Eof() const
+{
+	if (!streaming)
+		return CFileHandler::Eof();
+
+	return (filePos >= fileSize);
+}
+
+
+int CGZFileHandler::GetPos()
+{
+	if (!streaming)
+		return CFileHandler::GetPos();
+
+	return filePos;
+}
+
+
+const std::uint8_t* CGZFileHandler::GetView(size_t& size)
+{
+	if (streaming) {
+		WaitForReadAhead();
+#ifndef TOOLS
+		std::lock_guard<spring::mutex> lck(streamMutex);
+#endif
+		// materialize the whole image; the window may sit anywhere
+		RestartStream();
+
+		while (!streamEnded && int(window.size()) < fileSize)
+			FillWindow();
+
+		fileBuffer.swap(window);
+		fileSize = fileBuffer.size();
+		filePos = std::min(filePos, fileSize);
+	}
+
+	// closing also parks any still-queued read-ahead job
+	CloseStream();
+	return CFileHandler::GetView(size);
+}
+
+
+void CGZFileHandler::StartReadAhead()
+{
+#ifndef TOOLS
+	if (readAheadPending.exchange(true))
+		return;
+
+	ThreadPool::Enqueue([this]() {
+		{
+			std::lock_guard<spring::mutex> lck(streamMutex);
+
+			if (streaming && !streamEnded && ((windowStart + int(window.size())) - filePos) < int(READAHEAD_SIZE))
+				FillWindow();
+		}
+		readAheadPending.store(false);
+	});
+#endif
+}
+
+
+void CGZFileHandler::WaitForReadAhead() const
+{
+#ifndef TOOLS
+	while (readAheadPending.load())
+		spring::this_thread::sleep_for(std::chrono::milliseconds(1));
+#endif
+}
+
+
+bool CGZFileHandler::ReadToBuffer(const std::string& path)
+{
+	assert(!streaming);
+
+#ifndef TOOLS
+	if (!srcMap.Open(path, false))
+#endif
+	{
+		// mapping can fail on exotic filesystems or for empty files
+		std::ifstream cifs(path.c_str(), std::ios::in | std::ios::binary);
+
+		if (!cifs || cifs.bad() || !cifs.is_open())
+			return false;
+
+		cifs.seekg(0, std::ios_base::end);
+		srcBuffer.resize(std::max<std::streamoff>(cifs.tellg(), 0));
+		cifs.seekg(0, std::ios_base::beg);
+		cifs.read(reinterpret_cast<char*>(srcBuffer.data()), srcBuffer.size());
+	}
+
+	return OpenStream();
+}
+
+bool CGZFileHandler::UncompressBuffer()
+{
+	srcBuffer.clear();
+	std::swap(srcBuffer, fileBuffer);
+	return OpenStream();
 }
 
 
@@ -134,4 +469,4 @@ bool CGZFileHandler::TryReadFromRawFS(const std::string& fileName)
 bool CGZFileHandler::TryReadFromVFS(const std::string& fileName, int section)
 {
 	return CFileHandler::TryReadFromVFS(fileName, section) && UncompressBuffer();
-}
\ No newline at end of file
+}
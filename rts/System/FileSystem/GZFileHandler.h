@@ -5,17 +5,39 @@
 
 #include "FileHandler.h"
 
+#include <atomic>
 #include <string>
+#include <vector>
+#include <zlib.h>
 
 #include "VFSModes.h"
+
+#ifndef TOOLS
+	#include "System/Threading/SpringThreading.h"
+#endif
+
 /**
- * Uncompresses the entire file to memory, so don't use with huge files.
+ * Serves the decompressed contents of a gzip file. Decompression is
+ * windowed: Read() inflates on demand (with read-ahead on a ThreadPool
+ * worker), so sequential consumers start immediately and only a small
+ * decoded window is ever held in memory, never the whole image.
+ * Files without a gzip header are served verbatim, like gzread() does.
  */
 class CGZFileHandler : public CFileHandler
 {
 public:
 	CGZFileHandler(const char* fileName, const char* modes = SPRING_VFS_RAW_FIRST);
 	CGZFileHandler(const std::string& fileName, const std::string& modes = SPRING_VFS_RAW_FIRST);
+	~CGZFileHandler();
+
+	int Read(void* buf, int length) override;
+	void Seek(int pos, std::ios_base::seekdir where = std::ios_base::beg) override;
+
+	bool Eof() const override;
+	int GetPos() override;
+
+	/// materializes the remaining contents, rarely wanted on gz files
+	const std::uint8_t* GetView(size_t& size) override;
 
 private:
 	bool TryReadFromPWD(const std::string& fileName) override;
@@ -23,6 +45,41 @@ private:
 	bool TryReadFromVFS(const std::string& fileName, int section) override;
 	bool ReadToBuffer(const std::string& path);
 	bool UncompressBuffer();
+
+	const std::uint8_t* SrcData() const;
+	size_t SrcSize() const;
+
+	bool OpenStream();
+	void RestartStream();
+	void CloseStream();
+	/// inflates the next chunk onto the back of the window, lock held
+	void FillWindow();
+	/// decodes up to an uncompressed offset, trimming as it goes
+	void SkipTo(int target);
+	void StartReadAhead();
+	void WaitForReadAhead() const;
+
+	/// compressed source for VFS (and TOOLS) files; raw files use srcMap
+	std::vector<std::uint8_t> srcBuffer;
+#ifndef TOOLS
+	MappedFile srcMap;
+	std::atomic<bool> readAheadPending{false};
+#endif
+
+	z_stream zstream;
+	bool streaming = false;
+	bool streamEnded = false;
+
+	/// decoded bytes [windowStart, windowStart + window.size())
+	std::vector<std::uint8_t> window;
+	int windowStart = 0;
+
+#ifndef TOOLS
+	/// guards the stream state against the read-ahead worker
+	mutable spring::mutex streamMutex;
+#endif
+
+	static const size_t READAHEAD_SIZE;
 };
 
 #endif // _GZ_FILE_HANDLER_H
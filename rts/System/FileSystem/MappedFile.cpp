@@ -0,0 +1,90 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "MappedFile.h"
+
+#ifdef WIN32
+#include "System/Platform/Win/win32.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+bool MappedFile::Open(const std::string& fileName, bool copyOnWrite)
+{
+	Close();
+
+#ifdef WIN32
+	HANDLE file = CreateFile(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0) {
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMapping(file, nullptr, copyOnWrite? PAGE_WRITECOPY: PAGE_READONLY, 0, 0, nullptr);
+
+	// neither handle needs to outlive the view
+	CloseHandle(file);
+
+	if (mapping == NULL)
+		return false;
+
+	data = reinterpret_cast<std::uint8_t*>(MapViewOfFile(mapping, copyOnWrite? FILE_MAP_COPY: FILE_MAP_READ, 0, 0, 0));
+	CloseHandle(mapping);
+
+	if (data == nullptr)
+		return false;
+
+	size = fileSize.QuadPart;
+#else
+	const int fd = open(fileName.c_str(), O_RDONLY);
+
+	if (fd < 0)
+		return false;
+
+	struct stat info;
+
+	if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+		close(fd);
+		return false;
+	}
+
+	const int prot = copyOnWrite? (PROT_READ | PROT_WRITE): PROT_READ;
+	void* addr = mmap(nullptr, info.st_size, prot, MAP_PRIVATE, fd, 0);
+
+	// the descriptor does not need to outlive the mapping
+	close(fd);
+
+	if (addr == MAP_FAILED)
+		return false;
+
+	data = reinterpret_cast<std::uint8_t*>(addr);
+	size = info.st_size;
+#endif
+
+	return true;
+}
+
+
+void MappedFile::Close()
+{
+	if (data == nullptr)
+		return;
+
+#ifdef WIN32
+	UnmapViewOfFile(data);
+#else
+	munmap(data, size);
+#endif
+
+	data = nullptr;
+	size = 0;
+}
@@ -0,0 +1,38 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Whole-file view memory-mapped into the address space, either
+ * read-only or copy-on-write. Clean pages are shared between all
+ * processes mapping the same file, so multiple engine instances on
+ * one host reuse them; copy-on-write mappings are writable but the
+ * changes stay private to this process and never hit the disk.
+ */
+class MappedFile {
+public:
+	MappedFile() = default;
+	MappedFile(const MappedFile&) = delete;
+	~MappedFile() { Close(); }
+
+	MappedFile& operator = (const MappedFile&) = delete;
+
+	bool Open(const std::string& fileName, bool copyOnWrite);
+	void Close();
+
+	bool IsOpen() const { return (data != nullptr); }
+
+	std::uint8_t* GetData() const { return data; }
+	size_t GetSize() const { return size; }
+
+private:
+	std::uint8_t* data = nullptr;
+	size_t size = 0;
+};
+
+#endif
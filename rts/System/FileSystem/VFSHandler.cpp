@@ -109,8 +109,10 @@ bool CVFSHandler::AddArchive(const std::string& archiveName, bool overwrite)
 		ar->FileInfo(fid, name, size);
 		StringToLowerInPlace(name);
 
+		const bool sameName = (files[section].find(name) != files[section].end());
+
 		if (!overwrite) {
-			if (files[section].find(name) != files[section].end()) {
+			if (sameName) {
 				LOG_L(L_DEBUG, "%s (skipping, exists)", name.c_str());
 				continue;
 			}
@@ -124,8 +126,11 @@ bool CVFSHandler::AddArchive(const std::string& archiveName, bool overwrite)
 		d.ar = ar;
 		d.size = size;
 		files[section][name] = d;
+
+		RegisterFileHash(section, HashNormalizedPath(name.data(), name.size()), d, sameName);
 	}
 
+	missedHashes[section].clear();
 	return true;
 }
 
@@ -180,6 +185,7 @@ bool CVFSHandler::RemoveArchive(const std::string& archiveName)
 	delete ar;
 	archives.erase(archivePath);
 
+	RebuildHashIndex(section);
 	return true;
 }
 
@@ -192,6 +198,55 @@ std::string CVFSHandler::GetNormalizedPath(const std::string& rawPath)
 }
 
 
+std::uint64_t CVFSHandler::HashNormalizedPath(const char* data, size_t len)
+{
+	// FNV-1a over the path as GetNormalizedPath would rewrite it
+	std::uint64_t hash = 0xcbf29ce484222325ull;
+
+	for (size_t i = 0; i < len; i++) {
+		char c = data[i];
+
+		if (c >= 'A' && c <= 'Z')
+			c += ('a' - 'A');
+		if (c == '\\')
+			c = '/';
+
+		hash ^= static_cast<std::uint8_t>(c);
+		hash *= 0x100000001b3ull;
+	}
+
+	return hash;
+}
+
+
+void CVFSHandler::RegisterFileHash(Section section, std::uint64_t hash, const FileData& data, bool sameName)
+{
+	if (collidedHashes[section].contains(hash))
+		return;
+
+	if (!sameName && fileHashIndex[section].contains(hash)) {
+		// two distinct names case-fold to the same hash; resolve both
+		// through the ordered map from now on
+		fileHashIndex[section].erase(hash);
+		collidedHashes[section].insert(hash);
+		return;
+	}
+
+	fileHashIndex[section][hash] = data;
+}
+
+void CVFSHandler::RebuildHashIndex(Section section)
+{
+	fileHashIndex[section].clear();
+	collidedHashes[section].clear();
+	missedHashes[section].clear();
+
+	for (const auto& file: files[section]) {
+		RegisterFileHash(section, HashNormalizedPath(file.first.data(), file.first.size()), file.second, false);
+	}
+}
+
+
 const CVFSHandler::FileData* CVFSHandler::GetFileData(const std::string& normalizedFilePath, Section section)
 {
 	assert(section < Section::Count);
@@ -205,14 +260,54 @@ const CVFSHandler::FileData* CVFSHandler::GetFileData(const std::string& normali
 }
 
 
+const CVFSHandler::FileData* CVFSHandler::FindFileData(const std::string& rawFilePath, Section section, std::string* normalizedPath)
+{
+	assert(section < Section::Count);
+
+	// hash-first resolution; no string allocation on misses
+	const std::uint64_t hash = HashNormalizedPath(rawFilePath.data(), rawFilePath.size());
+
+	{
+		std::lock_guard<spring::spinlock> lck(missedHashesLock);
+
+		if (missedHashes[section].contains(hash))
+			return nullptr;
+	}
+
+	if (collidedHashes[section].contains(hash)) {
+		// rare: ambiguous hash, fall back to the ordered map
+		const std::string& np = GetNormalizedPath(rawFilePath);
+
+		if (normalizedPath != nullptr)
+			*normalizedPath = np;
+
+		return GetFileData(np, section);
+	}
+
+	const auto fi = fileHashIndex[section].find(hash);
+
+	if (fi == fileHashIndex[section].end()) {
+		std::lock_guard<spring::spinlock> lck(missedHashesLock);
+
+		missedHashes[section].insert(hash);
+		return nullptr;
+	}
+
+	if (normalizedPath != nullptr)
+		*normalizedPath = GetNormalizedPath(rawFilePath);
+
+	return &(fi->second);
+}
+
+
 bool CVFSHandler::LoadFile(const std::string& filePath, std::vector<std::uint8_t>& buffer, Section section)
 {
 	assert(section < Section::Count);
 
 	LOG_L(L_DEBUG, "LoadFile(filePath = \"%s\", )", filePath.c_str());
 
-	const std::string& normalizedPath = GetNormalizedPath(filePath);
-	const FileData* fileData = GetFileData(normalizedPath, section);
+	std::string normalizedPath;
+	const FileData* fileData = FindFileData(filePath, section, &normalizedPath);
 
 	if (fileData == nullptr) {
 		LOG_L(L_DEBUG, "LoadFile: File '%s' does not exist in VFS.", filePath.c_str());
@@ -234,18 +329,23 @@ bool CVFSHandler::FileExists(const std::string& filePath, Section section)
 
 	LOG_L(L_DEBUG, "FileExists(filePath = \"%s\", )", filePath.c_str());
 
-	const std::string& normalizedPath = GetNormalizedPath(filePath);
-	const FileData* fileData = GetFileData(normalizedPath, section);
+	// the index mirrors the archive contents, no need to re-query them
+	return (FindFileData(filePath, section, nullptr) != nullptr);
+}
 
-	// the file does not exist in the VFS
-	if (fileData == nullptr)
-		return false;
 
-	// the file does not exist in the archive
-	if (!fileData->ar->FileExists(normalizedPath))
-		return false;
+std::vector<bool> CVFSHandler::FilesExist(const std::vector<std::string>& filePaths, Section section)
+{
+	assert(section < Section::Count);
 
-	return true;
+	std::vector<bool> ret;
+	ret.reserve(filePaths.size());
+
+	for (const std::string& filePath: filePaths) {
+		ret.push_back(FindFileData(filePath, section, nullptr) != nullptr);
+	}
+
+	return ret;
 }
 
 
@@ -9,6 +9,10 @@
 #include <vector>
 #include <cinttypes>
 
+#include "System/UnorderedMap.hpp"
+#include "System/UnorderedSet.hpp"
+#include "System/Threading/SpringThreading.h"
+
 class IArchive;
 
 /**
@@ -52,6 +56,13 @@ public:
 	 */
 	bool LoadFile(const std::string& filePath, std::vector<std::uint8_t>& buffer, Section section);
 
+	/**
+	 * Bulk version of FileExists for loaders that know their file lists
+	 * up front; resolves all paths against the hash-index in one pass.
+	 * @return per-path existence bits, parallel to filePaths
+	 */
+	std::vector<bool> FilesExist(const std::vector<std::string>& filePaths, Section section);
+
 	/**
 	 * Returns all the files in the given (virtual) directory without the
 	 * preceeding pathname.
@@ -95,9 +106,28 @@ protected:
 	std::array<std::map<std::string, FileData>, Section::Count> files;
 	std::map<std::string, IArchive*> archives;
 
+	/// open-addressing index over case-folded path hashes; the ordered
+	/// <files> maps stay canonical (directory listing needs their order)
+	std::array<spring::unordered_map<std::uint64_t, FileData>, Section::Count> fileHashIndex;
+	/// distinct names whose hashes collided, resolved via <files> instead
+	std::array<spring::unordered_set<std::uint64_t>, Section::Count> collidedHashes;
+	/// hashes of lookups known to miss; cleared whenever archives change
+	std::array<spring::unordered_set<std::uint64_t>, Section::Count> missedHashes;
+	/// guards <missedHashes>, the only index state mutated by lookups
+	/// (loading runs concurrent VFS reads from the pool's workers)
+	spring::spinlock missedHashesLock;
+
 private:
+	/// hashes a raw path as if it were normalized first (case-folded,
+	/// forward slashes) without allocating the normalized string
+	static std::uint64_t HashNormalizedPath(const char* data, size_t len);
+
 	std::string GetNormalizedPath(const std::string& rawPath);
 	const FileData* GetFileData(const std::string& normalizedFilePath, Section section);
+	const FileData* FindFileData(const std::string& rawFilePath, Section section, std::string* normalizedPath);
+
+	void RegisterFileHash(Section section, std::uint64_t hash, const FileData& data, bool sameName);
+	void RebuildHashIndex(Section section);
 };
 
 extern CVFSHandler* vfsHandler;
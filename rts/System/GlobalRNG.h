@@ -95,12 +95,101 @@ private:
 
 
 
+// counter-based generator (Threefry-2x64, 20 rounds); the output is a
+// pure function of (key, sequence, counter) so any number of streams
+// with distinct sequence-ids can be drawn from in any order (or from
+// multiple threads) while still producing identical values everywhere,
+// unlike PCG32 whose consumers all advance one shared state; uses only
+// 64-bit adds, rotates and xors and is therefore bit-exact across
+// platforms as synced code requires
+struct Threefry64 {
+public:
+	typedef uint32_t res_type;
+	typedef uint64_t val_type;
+
+	Threefry64(const val_type _val = def_val, const val_type _seq = def_seq) { seed(_val, _seq); }
+	Threefry64(const Threefry64& rng) { *this = rng; }
+
+	void seed(const val_type initval, const val_type initseq) {
+		key = initval;
+		seq = initseq;
+		ctr = 0;
+		cnt = 0;
+		blk = 0;
+	}
+
+	res_type next() {
+		if ((cnt & 1) == 0)
+			blk = Block(key, seq, ctr++);
+
+		return res_type(blk >> ((cnt++ & 1) * 32));
+	}
+
+	res_type bnext(const res_type bound) {
+		const res_type threshold = -bound % bound;
+		res_type r = 0;
+
+		// generate a uniformly distributed number, r, where 0 <= r < bound
+		for (r = next(); r < threshold; r = next());
+
+		return (r % bound);
+	}
+
+	val_type state() const { return ctr; }
+
+	// the keyed bijection itself; also usable directly for bulk
+	// generation (e.g. scatter volleys) since blocks at different
+	// counter values are independent
+	static val_type Block(const val_type k0, const val_type k1, const val_type n) {
+		constexpr val_type C240 = 0x1BD11BDAA9FC1A22ull;
+		constexpr unsigned int R[8] = {16, 42, 12, 31, 16, 32, 24, 21};
+
+		const val_type ks[3] = {k0, k1, C240 ^ k0 ^ k1};
+
+		val_type x0 = n + ks[0];
+		val_type x1 = ks[1];
+
+		for (unsigned int r = 0; r < 20; r++) {
+			x0 += x1;
+			x1 = (x1 << R[r & 7]) | (x1 >> ((64 - R[r & 7]) & 63));
+			x1 ^= x0;
+
+			if (((r + 1) & 3) == 0) {
+				const val_type s = (r + 1) >> 2;
+				x0 += ks[(s    ) % 3];
+				x1 += ks[(s + 1) % 3] + s;
+			}
+		}
+
+		return x0;
+	}
+
+public:
+	static constexpr res_type min_res = std::numeric_limits<res_type>::min();
+	static constexpr res_type max_res = std::numeric_limits<res_type>::max();
+	static constexpr val_type def_val = 0x853c49e6748fea9bULL;
+	static constexpr val_type def_seq = 0xda3e39cb94b95bdbULL;
+
+private:
+	val_type key;
+	val_type seq;
+	val_type ctr; // block counter
+	val_type blk; // current block
+	uint32_t cnt; // results drawn
+};
+
+
+
 template<typename RNG, bool synced> class CGlobalRNG {
 public:
 	typedef typename RNG::val_type rng_val_type;
 	typedef typename RNG::res_type rng_res_type;
 
 	void Seed(rng_val_type seed) { SetSeed(seed); }
+	// seeds an independent keyed stream (counter-based generators only,
+	// sequential generators would just correlate); seq encodes the stream
+	// identity, see SyncedRNGStreamID
+	void SeedStream(rng_val_type seed, rng_val_type seq) { gen.seed(lastSeed = seed, seq); }
 	void SetSeed(rng_val_type seed, bool init = false) {
 		// use address of this object as sequence-id for unsynced RNG, modern systems have ASLR
 		if (init) {
@@ -152,5 +241,24 @@ private:
 typedef CGlobalRNG<PCG32, true> CGlobalSyncedRNG;
 typedef CGlobalRNG<PCG32, false> CGlobalUnsyncedRNG;
 
+// construct (cheaply, on the stack) one per consumer and seed it via
+// SeedStream with the match seed and a SyncedRNGStreamID; draws neither
+// read nor advance gsRNG, so keyed consumers can roll dice in any order
+// or concurrently and still stay in sync
+typedef CGlobalRNG<Threefry64, true> CSyncedCounterRNG;
+
+// per-subsystem stream id's; keep stable, they are part of the synced key
+enum {
+	RNG_STREAM_PROJECTILE = 0,
+	RNG_STREAM_WEAPON     = 1,
+	RNG_STREAM_COB        = 2,
+	RNG_STREAM_LUA        = 3,
+};
+
+// packs (frame, subsystem, object id) into a stream sequence-id
+constexpr uint64_t SyncedRNGStreamID(int frame, unsigned int subsys, int objectID) {
+	return ((uint64_t(uint32_t(frame)) << 32) | (uint64_t(subsys & 0xFFu) << 24) | (uint64_t(uint32_t(objectID)) & 0x00FFFFFFull));
+}
+
 #endif
 
@@ -189,12 +189,15 @@ void CCregLoadSaveHandler::SaveGame(const std::string& path)
 void CCregLoadSaveHandler::LoadGameStartInfo(const std::string& path)
 {
 	CGZFileHandler saveFile(dataDirsAccess.LocateFile(FindSaveFile(path)), SPRING_VFS_RAW_FIRST);
+
+	// the handler already holds the whole uncompressed file in memory,
+	// grab it in one block instead of copying it out 4kB at a time
+	std::string saveData;
+	if (!saveFile.LoadStringData(saveData))
+		throw content_error("Save file not found: " + path);
+
 	iss = new std::stringstream;
-	std::stringbuf *sbuf = iss->rdbuf();
-	char buf[4096];
-	int len;
-	while ((len = saveFile.Read(buf, sizeof(buf))) > 0)
-		sbuf->sputn(buf, len);
+	iss->str(std::move(saveData));
 
 	//Check for compatible save versions
 	std::string saveVersion;
@@ -13,6 +13,7 @@ CONFIG(bool, DisableDemoVersionCheck).defaultValue(false).description("Allow to
 #include "System/Net/RawPacket.h"
 #include "Game/GameVersion.h"
 
+#include <algorithm>
 #include <limits.h>
 #include <stdexcept>
 #include <cassert>
@@ -172,3 +173,59 @@ void CDemoReader::LoadStats()
 
 	playbackDemo->Seek(curPos);
 }
+
+
+void CDemoReader::LoadFrameIndex()
+{
+	// The index is not available if Spring crashed while writing the demo.
+	if (fileHeader.demoStreamSize == 0 || fileHeader.numFrameIndexEntries == 0)
+		return;
+	if (fileHeader.frameIndexElemSize != sizeof(DemoFrameIndexEntry))
+		return;
+
+	const int curPos = playbackDemo->GetPos();
+
+	// The frame index follows the team statistics.
+	playbackDemo->Seek(fileHeader.headerSize + fileHeader.scriptSize + fileHeader.demoStreamSize +
+			fileHeader.winningAllyTeamsSize + fileHeader.playerStatSize + fileHeader.teamStatSize);
+
+	frameIndex.clear();
+	frameIndex.reserve(fileHeader.numFrameIndexEntries);
+
+	for (int i = 0; i < fileHeader.numFrameIndexEntries; ++i) {
+		DemoFrameIndexEntry indexEntry;
+		playbackDemo->Read(reinterpret_cast<char*>(&indexEntry), sizeof(DemoFrameIndexEntry));
+		indexEntry.swab();
+		frameIndex.push_back(indexEntry);
+	}
+
+	playbackDemo->Seek(curPos);
+}
+
+
+int CDemoReader::SeekToFrame(int frame, float curTime)
+{
+	if (frameIndex.empty())
+		LoadFrameIndex();
+	if (frameIndex.empty())
+		return -1;
+
+	// latest indexed chunk at or before the requested frame
+	auto it = std::upper_bound(frameIndex.begin(), frameIndex.end(), frame,
+			[](int f, const DemoFrameIndexEntry& e) { return (f < e.frame); });
+
+	if (it == frameIndex.begin())
+		return -1;
+	--it;
+
+	playbackDemo->Seek(fileHeader.headerSize + fileHeader.scriptSize + it->streamOffset);
+	bytesRemaining = fileHeader.demoStreamSize - it->streamOffset;
+
+	playbackDemo->Read((char*)&chunkHeader, sizeof(chunkHeader));
+	chunkHeader.swab();
+
+	demoTimeOffset = curTime - chunkHeader.modGameTime - 0.1f;
+	nextDemoReadTime = curTime - 0.01f;
+
+	return it->frame;
+}
@@ -55,6 +55,29 @@ public:
 	/// Not needed for normal demo watching
 	void LoadStats();
 
+	/**
+	@brief reposition the stream at the latest indexed chunk at or before frame
+	@return the game frame of that chunk, or -1 if no usable anchor exists
+
+	Playback continues from a chunk boundary, so the caller still has to
+	re-simulate from a matching state (a savegame, or frame zero at maximum
+	speed) up to the returned frame; this only skips the linear scan of the
+	demo stream itself.
+	*/
+	int SeekToFrame(int frame, float curTime);
+
+	/// the chunk-level frame index, empty for demos recorded without one
+	const std::vector<DemoFrameIndexEntry>& GetFrameIndex()
+	{
+		if (frameIndex.empty())
+			LoadFrameIndex();
+
+		return frameIndex;
+	}
+
+private:
+	void LoadFrameIndex();
+
 private:
 	CFileHandler* playbackDemo;
 
@@ -70,6 +93,7 @@ private:
 	std::vector<PlayerStatistics> playerStats; // one stat per player
 	std::vector< std::vector<TeamStatistics> > teamStats; // many stats per team
 	std::vector<unsigned char> winningAllyTeams;
+	std::vector<DemoFrameIndexEntry> frameIndex;
 };
 
 #endif
@@ -4,9 +4,11 @@
 #include <cerrno>
 #include <cstring>
 #include <memory>
+#include <zlib.h>
 
 #include "DemoRecorder.h"
 #include "Game/GameVersion.h"
+#include "Net/Protocol/BaseNetProtocol.h"
 #include "Sim/Misc/TeamStatistics.h"
 #include "System/TimeUtil.h"
 #include "System/StringUtil.h"
@@ -15,17 +17,27 @@
 #include "System/FileSystem/FileQueryFlags.h"
 #include "System/FileSystem/FileHandler.h"
 #include "System/Log/ILog.h"
+#include "System/Misc/SpringTime.h"
+#include "System/Threading/ThreadPool.h"
 
-// server and client memory-streams
-static std::unique_ptr<std::stringstream> demoStreams[2] = {nullptr, nullptr};
+// the demo is written as a sequence of independent gzip members which
+// zlib concatenates transparently on playback; whenever this much data
+// has accumulated it is compressed on a worker thread and appended to
+// disk, so memory usage stays bounded and a crashed game still leaves
+// every previously flushed block in a readable file
+static const unsigned int flushThresholdSize = 512 * 1024;
+
+// gzip member header (10), stored deflate-block header (5) and member
+// trailer (8) framing the DemoFileHeader member at the start of the file
+static const unsigned int gzipMemberOverhead = 10 + 5 + 8;
 
 CDemoRecorder::CDemoRecorder(const std::string& mapName, const std::string& modName, bool serverDemo): isServerDemo(serverDemo)
 {
-	SetStream();
 	SetName(mapName, modName);
 	SetFileHeader();
 
-	file = gzopen(demoName.c_str(), "wb9");
+	streamBuf.reserve(flushThresholdSize + 4096);
+	file = fopen(demoName.c_str(), "wb");
 }
 
 CDemoRecorder::~CDemoRecorder()
@@ -34,17 +46,13 @@ CDemoRecorder::~CDemoRecorder()
 	WriteWinnerList();
 	WritePlayerStats();
 	WriteTeamStats();
+	WriteFrameIndex();
+	FlushStreamBuf();
+	WaitForPendingFlush();
 	WriteFileHeader(true);
-	WriteDemoFile();
-}
-
-void CDemoRecorder::SetStream()
-{
-	if (demoStreams[isServerDemo].get() == nullptr)
-		demoStreams[isServerDemo].reset(new std::stringstream(std::ios::binary | std::ios::out));
 
-	demoStreams[isServerDemo]->clear();
-	demoStreams[isServerDemo]->seekp(0);
+	if (file != nullptr)
+		fclose(file);
 }
 
 void CDemoRecorder::SetFileHeader()
@@ -59,22 +67,6 @@ void CDemoRecorder::SetFileHeader()
 	fileHeader.teamStatElemSize = sizeof(TeamStatistics);
 	fileHeader.teamStatPeriod = TeamStatistics::statsPeriod;
 	fileHeader.winningAllyTeamsSize = 0;
-
-	demoStreams[isServerDemo]->seekp(WriteFileHeader(false) + sizeof(DemoFileHeader));
-}
-
-void CDemoRecorder::WriteDemoFile()
-{
-	// using operator<<(basic_stringbuf*) requires the stream to be opened with std::ios::in
-	// stringbuf::{eback(), egptr(), gptr()} are protected so we cannot access them directly
-	// (plus data is not guaranteed to be stored contiguously) ==> the only clean OO solution
-	// that avoids str()'s copy would be to supply our own stringbuffer backend to demoStream
-	// which is slightly overdoing it
-	const std::string data = demoStreams[isServerDemo]->str();
-
-	gzwrite(file, data.c_str(), data.size());
-	gzflush(file, Z_FINISH);
-	gzclose(file);
 }
 
 void CDemoRecorder::WriteSetupText(const std::string& text)
@@ -85,7 +77,11 @@ void CDemoRecorder::WriteSetupText(const std::string& text)
 	}
 
 	fileHeader.scriptSize = length;
-	demoStreams[isServerDemo]->write(text.c_str(), length);
+
+	// the script has to follow the header on disk; write both out
+	// immediately so a crashed game still leaves a readable demo
+	WriteFileHeader(false);
+	WriteGZipMember(reinterpret_cast<const std::uint8_t*>(text.c_str()), length);
 }
 
 void CDemoRecorder::SaveToDemo(const unsigned char* buf, const unsigned length, const float modGameTime)
@@ -95,9 +91,86 @@ void CDemoRecorder::SaveToDemo(const unsigned char* buf, const unsigned length,
 	chunkHeader.modGameTime = modGameTime;
 	chunkHeader.length = length;
 	chunkHeader.swab();
-	demoStreams[isServerDemo]->write((char*) &chunkHeader, sizeof(chunkHeader));
-	demoStreams[isServerDemo]->write((char*) buf, length);
+
+	// keyframes anchor the frame index; demoStreamSize has not been
+	// bumped yet, so it equals the offset of this chunk in the stream
+	if (length >= (sizeof(std::uint8_t) + sizeof(std::int32_t)) && buf[0] == NETMSG_KEYFRAME) {
+		DemoFrameIndexEntry indexEntry;
+		memcpy(&indexEntry.frame, buf + 1, sizeof(indexEntry.frame));
+		indexEntry.streamOffset = fileHeader.demoStreamSize;
+		frameIndex.push_back(indexEntry);
+	}
+
+	AppendToStreamBuf(&chunkHeader, sizeof(chunkHeader));
+	AppendToStreamBuf(buf, length);
 	fileHeader.demoStreamSize += (length + sizeof(chunkHeader));
+
+	if (streamBuf.size() >= flushThresholdSize)
+		FlushStreamBuf();
+}
+
+void CDemoRecorder::AppendToStreamBuf(const void* data, unsigned int length)
+{
+	const std::uint8_t* bytes = reinterpret_cast<const std::uint8_t*>(data);
+	streamBuf.insert(streamBuf.end(), bytes, bytes + length);
+}
+
+void CDemoRecorder::FlushStreamBuf()
+{
+	if (streamBuf.empty() || file == nullptr)
+		return;
+
+	if (!headerWritten)
+		WriteFileHeader(false);
+
+	// only one block is ever in flight; wait for the previous one so
+	// members reach the disk in order and memory stays bounded to two
+	// blocks
+	WaitForPendingFlush();
+
+	std::swap(streamBuf, flushBuf);
+	streamBuf.clear();
+
+	flushInFlight.store(true, std::memory_order_release);
+
+	ThreadPool::Enqueue([this]() {
+		WriteGZipMember(&flushBuf[0], flushBuf.size());
+		flushInFlight.store(false, std::memory_order_release);
+	});
+}
+
+void CDemoRecorder::WaitForPendingFlush()
+{
+	while (flushInFlight.load(std::memory_order_acquire)) {
+		spring_sleep(spring_msecs(1));
+	}
+}
+
+void CDemoRecorder::WriteGZipMember(const std::uint8_t* data, unsigned int length)
+{
+	z_stream zstream;
+	zstream.zalloc = Z_NULL;
+	zstream.zfree = Z_NULL;
+	zstream.opaque = Z_NULL;
+
+	// 15 + 16 selects a gzip wrapper, including the member trailer
+	deflateInit2(&zstream, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+
+	std::vector<std::uint8_t> compressed(deflateBound(&zstream, length));
+
+	zstream.next_in = const_cast<std::uint8_t*>(data);
+	zstream.avail_in = length;
+	zstream.next_out = &compressed[0];
+	zstream.avail_out = compressed.size();
+
+	const int ret = deflate(&zstream, Z_FINISH);
+	assert(ret == Z_STREAM_END); (void) ret;
+	deflateEnd(&zstream);
+
+	// a single write per member keeps a crashed demo intact up to the
+	// last block handed to the OS
+	fwrite(&compressed[0], compressed.size() - zstream.avail_out, 1, file);
+	fflush(file);
 }
 
 void CDemoRecorder::SetName(const std::string& mapName, const std::string& modName)
@@ -190,16 +263,14 @@ void CDemoRecorder::SetWinningAllyTeams(const std::vector<unsigned char>& winnin
 }
 
 /** @brief Write DemoFileHeader
-Write the DemoFileHeader at the start of the file and restores the original
-position in the file afterwards. */
-unsigned int CDemoRecorder::WriteFileHeader(bool updateStreamLength)
+The header lives in its own stored (uncompressed) gzip member at the start
+of the file; since stored members have a fixed compressed size, it can be
+rewritten in place once the gameID arrives and again when the final
+stream- and statistics-sizes are known at game end. */
+void CDemoRecorder::WriteFileHeader(bool updateStreamLength)
 {
-#ifdef _MSC_VER // MSVC8 behaves strange if tell/seek is called before anything has been written
-	const bool empty = (demoStreams[isServerDemo]->str() == "");
-	const unsigned int pos = empty? 0 : demoStreams[isServerDemo]->tellp();
-#else
-	const unsigned int pos = demoStreams[isServerDemo]->tellp();
-#endif
+	if (file == nullptr)
+		return;
 
 	DemoFileHeader tmpHeader;
 	memcpy(&tmpHeader, &fileHeader, sizeof(fileHeader));
@@ -207,76 +278,116 @@ unsigned int CDemoRecorder::WriteFileHeader(bool updateStreamLength)
 		tmpHeader.demoStreamSize = 0;
 	tmpHeader.swab(); // to little endian
 
-#ifdef _MSC_VER
-	if (!empty)
-#endif
-	{
-		demoStreams[isServerDemo]->seekp(0);
+	std::uint8_t member[gzipMemberOverhead + sizeof(DemoFileHeader)];
+	std::uint8_t* ptr = member;
+
+	// gzip member header; no flags, zero mtime, unknown OS
+	const std::uint8_t gzipHeader[10] = {0x1f, 0x8b, Z_DEFLATED, 0,  0, 0, 0, 0,  0, 0xff};
+	memcpy(ptr, gzipHeader, sizeof(gzipHeader));
+	ptr += sizeof(gzipHeader);
+
+	// single stored deflate block (BFINAL=1, BTYPE=00) with LEN and ~LEN
+	const std::uint16_t len = sizeof(DemoFileHeader);
+	*(ptr++) = 0x01;
+	*(ptr++) = ( len     ) & 0xff;
+	*(ptr++) = ( len >> 8) & 0xff;
+	*(ptr++) = (~len     ) & 0xff;
+	*(ptr++) = (~len >> 8) & 0xff;
+	memcpy(ptr, &tmpHeader, sizeof(tmpHeader));
+	ptr += sizeof(tmpHeader);
+
+	// member trailer, CRC32 and uncompressed size in little endian
+	const std::uint32_t crc = crc32(0L, reinterpret_cast<const std::uint8_t*>(&tmpHeader), sizeof(tmpHeader));
+	const std::uint32_t isize = sizeof(DemoFileHeader);
+	for (int i = 0; i < 4; i++) { *(ptr++) = (crc   >> (i * 8)) & 0xff; }
+	for (int i = 0; i < 4; i++) { *(ptr++) = (isize >> (i * 8)) & 0xff; }
+
+	// the worker owns the file while a block is in flight
+	WaitForPendingFlush();
+
+	if (headerWritten) {
+		const long pos = ftell(file);
+		fseek(file, 0, SEEK_SET);
+		fwrite(member, sizeof(member), 1, file);
+		fseek(file, pos, SEEK_SET);
+	} else {
+		fwrite(member, sizeof(member), 1, file);
+		headerWritten = true;
 	}
 
-
-	demoStreams[isServerDemo]->write((char*) &tmpHeader, sizeof(tmpHeader));
-	demoStreams[isServerDemo]->seekp(pos);
-
-	return pos;
+	fflush(file);
 }
 
-/** @brief Write the CPlayer::Statistics at the current position in the file. */
+/** @brief Write the CPlayer::Statistics at the current position in the stream. */
 void CDemoRecorder::WritePlayerStats()
 {
-	int pos = demoStreams[isServerDemo]->tellp();
+	const unsigned int pos = streamBuf.size();
 
 	for (PlayerStatistics& stats: playerStats) {
 		stats.swab();
-		demoStreams[isServerDemo]->write(reinterpret_cast<char*>(&stats), sizeof(PlayerStatistics));
+		AppendToStreamBuf(&stats, sizeof(PlayerStatistics));
 	}
 
 	fileHeader.numPlayers = playerStats.size();
-	fileHeader.playerStatSize = (int)demoStreams[isServerDemo]->tellp() - pos;
+	fileHeader.playerStatSize = streamBuf.size() - pos;
 
 	playerStats.clear();
 }
 
 
 
-/** @brief Write the winningAllyTeams at the current position in the file. */
+/** @brief Write the winningAllyTeams at the current position in the stream. */
 void CDemoRecorder::WriteWinnerList()
 {
 	if (fileHeader.numTeams == 0)
 		return;
 
-	const int pos = demoStreams[isServerDemo]->tellp();
+	const unsigned int pos = streamBuf.size();
 
 	// Write the array of winningAllyTeams.
 	for (std::vector<unsigned char>::const_iterator it = winningAllyTeams.begin(); it != winningAllyTeams.end(); ++it) {
-		demoStreams[isServerDemo]->write((char*) &(*it), sizeof(unsigned char));
+		AppendToStreamBuf(&(*it), sizeof(unsigned char));
 	}
 
 	winningAllyTeams.clear();
 
-	fileHeader.winningAllyTeamsSize = int(demoStreams[isServerDemo]->tellp()) - pos;
+	fileHeader.winningAllyTeamsSize = streamBuf.size() - pos;
 }
 
-/** @brief Write the TeamStatistics at the current position in the file. */
+/** @brief Write the TeamStatistics at the current position in the stream. */
 void CDemoRecorder::WriteTeamStats()
 {
-	int pos = demoStreams[isServerDemo]->tellp();
+	const unsigned int pos = streamBuf.size();
 
 	// Write array of dwords indicating number of TeamStatistics per team.
 	for (std::vector<TeamStatistics>& history: teamStats) {
 		unsigned int c = swabDWord(history.size());
-		demoStreams[isServerDemo]->write((char*)&c, sizeof(unsigned int));
+		AppendToStreamBuf(&c, sizeof(unsigned int));
 	}
 
 	// Write big array of TeamStatistics.
 	for (std::vector<TeamStatistics>& history: teamStats) {
 		for (TeamStatistics& stats: history) {
 			stats.swab();
-			demoStreams[isServerDemo]->write(reinterpret_cast<char*>(&stats), sizeof(TeamStatistics));
+			AppendToStreamBuf(&stats, sizeof(TeamStatistics));
 		}
 	}
 
-	fileHeader.teamStatSize = (int)demoStreams[isServerDemo]->tellp() - pos;
+	fileHeader.teamStatSize = streamBuf.size() - pos;
 
 	teamStats.clear();
 }
+
+/** @brief Write the frame index at the current position in the stream. */
+void CDemoRecorder::WriteFrameIndex()
+{
+	fileHeader.numFrameIndexEntries = frameIndex.size();
+	fileHeader.frameIndexElemSize = sizeof(DemoFrameIndexEntry);
+
+	for (DemoFrameIndexEntry& indexEntry: frameIndex) {
+		indexEntry.swab();
+		AppendToStreamBuf(&indexEntry, sizeof(DemoFrameIndexEntry));
+	}
+
+	frameIndex.clear();
+}
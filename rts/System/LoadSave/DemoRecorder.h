@@ -3,9 +3,10 @@
 #ifndef DEMO_RECORDER
 #define DEMO_RECORDER
 
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
 #include <vector>
-#include <sstream>
-#include <zlib.h>
 
 #include "Demo.h"
 #include "Game/Players/PlayerStatistics.h"
@@ -24,7 +25,6 @@ public:
 	void WriteSetupText(const std::string& text);
 	void SaveToDemo(const unsigned char* buf, const unsigned length, const float modGameTime);
 
-	void SetStream();
 	void SetName(const std::string& mapName, const std::string& modName);
 	const std::string& GetName() const { return demoName; }
 
@@ -38,23 +38,36 @@ public:
 	void SetWinningAllyTeams(const std::vector<unsigned char>& winningAllyTeams);
 
 private:
-	unsigned int WriteFileHeader(bool updateStreamLength);
+	void WriteFileHeader(bool updateStreamLength);
 	void SetFileHeader();
 	void WritePlayerStats();
 	void WriteTeamStats();
 	void WriteWinnerList();
-	void WriteDemoFile();
+	void WriteFrameIndex();
+
+	void AppendToStreamBuf(const void* data, unsigned int length);
+	void FlushStreamBuf();
+	void WaitForPendingFlush();
+	void WriteGZipMember(const std::uint8_t* data, unsigned int length);
 
 private:
-	gzFile file;
+	FILE* file;
+
+	/// demo-stream data not yet handed off to the compression worker
+	std::vector<std::uint8_t> streamBuf;
+	/// block currently being compressed and appended by the worker
+	std::vector<std::uint8_t> flushBuf;
+
+	std::atomic<bool> flushInFlight{false};
+	bool headerWritten = false;
 
 	std::vector<PlayerStatistics> playerStats;
 	std::vector< std::vector<TeamStatistics> > teamStats;
 	std::vector<unsigned char> winningAllyTeams;
+	std::vector<DemoFrameIndexEntry> frameIndex;
 
 	bool isServerDemo;
 };
 
 
 #endif
-
@@ -40,6 +40,8 @@
  *         CTeam::Statistics for each team.
  *       - Array of all CTeam::Statistics (total number of items is the
  *         sum of the elements in the array of dwords).
+ *     - Frame index, numFrameIndexEntries DemoFrameIndexEntry structs
+ *       mapping game frames to byte offsets into the demo stream.
  *
  * The header is designed to be extensible: it contains a version field and a
  * headerSize field to support this. The version field is a major version number
@@ -70,6 +72,8 @@ struct DemoFileHeader
 	int teamStatElemSize;         ///< sizeof(CTeam::Statistics)
 	int teamStatPeriod;           ///< Interval (in seconds) between team stats.
 	int winningAllyTeamsSize;     ///< The size of the vector of the winning ally teams
+	int numFrameIndexEntries;     ///< Number of DemoFrameIndexEntry structs in the frame index.
+	int frameIndexElemSize;       ///< sizeof(DemoFrameIndexEntry)
 
 
 	/// Change structure from host endian to little endian or vice versa.
@@ -89,6 +93,8 @@ struct DemoFileHeader
 		swabDWordInPlace(teamStatElemSize);
 		swabDWordInPlace(teamStatPeriod);
 		swabDWordInPlace(winningAllyTeamsSize);
+		swabDWordInPlace(numFrameIndexEntries);
+		swabDWordInPlace(frameIndexElemSize);
 	}
 };
 
@@ -115,6 +121,26 @@ struct DemoStreamChunkHeader
 	}
 };
 
+/**
+ * @brief Spring demo frame index entry
+ *
+ * Maps a game frame to the byte offset (relative to the start of the
+ * demo stream) of the chunk carrying its NETMSG_KEYFRAME, so readers
+ * can seek to a chunk boundary at or before any given frame without
+ * scanning the whole stream.
+ */
+struct DemoFrameIndexEntry
+{
+	int frame;                  ///< Game frame number of the keyframe.
+	std::uint32_t streamOffset; ///< Offset of its chunk within the demo stream.
+
+	/// Change structure from host endian to little endian or vice versa.
+	void swab() {
+		swabDWordInPlace(frame);
+		swabDWordInPlace(streamOffset);
+	}
+};
+
 #pragma pack(pop)
 
 #endif // DEMO_FILE_H
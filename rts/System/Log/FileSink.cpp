@@ -7,8 +7,12 @@
 #include "System/MainDefines.h"
 #include "System/Log/ILog.h"
 #include "System/Log/Level.h"
+#include "System/Threading/MPSCChannel.hpp"
+#include "System/Threading/SpringThreading.h"
 
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstdio>
 #include <string>
 #include <list>
@@ -109,10 +113,7 @@ namespace {
 		return (!log_file_getLogFiles().empty());
 	}
 
-	void log_file_writeToFile(FILE* outStream, const char* record, bool flush) {
-		char framePrefix[128] = {'\0'};
-		log_framePrefixer_createPrefix(framePrefix, sizeof(framePrefix));
-
+	void log_file_writeToFile(FILE* outStream, const char* framePrefix, const char* record, bool flush) {
 		FPRINTF(outStream, "%s%s\n", framePrefix, record);
 
 		if (flush)
@@ -122,13 +123,13 @@ namespace {
 	/**
 	 * Writes to the individual log files, if they do want to log the section.
 	 */
-	void log_file_writeToFiles(int level, const char* section, const char* record)
+	void log_file_writeToFiles(int level, const char* section, const char* framePrefix, const char* record)
 	{
 		const logFiles_t& logFiles = log_file_getLogFiles();
 
 		for (auto lfi = logFiles.begin(); lfi != logFiles.end(); ++lfi) {
 			if (lfi->second.IsLogging(level, section) && (lfi->second.GetOutStream() != NULL)) {
-				log_file_writeToFile(lfi->second.GetOutStream(), record, lfi->second.FlushOnWrite(level));
+				log_file_writeToFile(lfi->second.GetOutStream(), framePrefix, record, lfi->second.FlushOnWrite(level));
 			}
 		}
 	}
@@ -151,11 +152,14 @@ namespace {
 	 * files.
 	 */
 	void log_file_writeBufferToFiles() {
+		char framePrefix[128] = {'\0'};
+		log_framePrefixer_createPrefix(framePrefix, sizeof(framePrefix));
+
 		logRecords_t& logRecords = log_file_getRecordBuffer();
 
 		while (!logRecords.empty()) {
 			const auto lri = logRecords.begin();
-			log_file_writeToFiles(lri->GetLevel(), lri->GetSection().c_str(), lri->GetRecord().c_str());
+			log_file_writeToFiles(lri->GetLevel(), lri->GetSection().c_str(), framePrefix, lri->GetRecord().c_str());
 			logRecords.erase(lri);
 		}
 	}
@@ -164,6 +168,88 @@ namespace {
 	{
 		log_file_getRecordBuffer().push_back(LogRecord(level, section, record));
 	}
+
+
+	/**
+	 * A preformatted record in flight to the flush thread; the frame
+	 * prefix is captured at enqueue time so a record still names the
+	 * frame it was logged in once the sim has moved on.
+	 */
+	struct AsyncLogRecord {
+		AsyncLogRecord(): level(0) {
+			framePrefix[0] = '\0';
+		}
+		AsyncLogRecord(int level, const std::string& section, const std::string& record)
+			: level(level)
+			, section(section)
+			, record(record)
+		{
+			log_framePrefixer_createPrefix(framePrefix, sizeof(framePrefix));
+		}
+
+		int level;
+		char framePrefix[128];
+		std::string section;
+		std::string record;
+	};
+
+
+	struct AsyncLogState {
+		~AsyncLogState() {
+			// in case nothing stopped us explicitly; joins the flush thread
+			log_file_setAsyncWrites(false);
+		}
+
+		spring::mpsc_channel<AsyncLogRecord, 2048> ring;
+		spring::thread flushThread;
+
+		std::atomic<bool> enabled{false};
+		std::atomic<bool> stop{false};
+		std::atomic<unsigned int> numDropped{0};
+	};
+
+	inline AsyncLogState& log_file_getAsyncState() {
+		static AsyncLogState asyncState;
+		return asyncState;
+	}
+
+	/**
+	 * Writes all queued records; the ring is single-consumer, so this must
+	 * only run on the flush thread or after that thread has been joined.
+	 */
+	unsigned int log_file_drainAsyncRecords() {
+		AsyncLogState& asyncState = log_file_getAsyncState();
+
+		const unsigned int numDrained = asyncState.ring.drain([](AsyncLogRecord&& alr) {
+			log_file_writeToFiles(alr.level, alr.section.c_str(), alr.framePrefix, alr.record.c_str());
+		});
+
+		const unsigned int numDropped = asyncState.numDropped.exchange(0);
+
+		if (numDropped > 0) {
+			char framePrefix[128] = {'\0'};
+			char dropRecord[128];
+
+			log_framePrefixer_createPrefix(framePrefix, sizeof(framePrefix));
+			SNPRINTF(dropRecord, sizeof(dropRecord), "[AsyncLog] dropped %u records (buffer overflow)", numDropped);
+
+			log_file_writeToFiles(LOG_LEVEL_WARNING, LOG_SECTION_DEFAULT, framePrefix, dropRecord);
+		}
+
+		return numDrained;
+	}
+
+	void log_file_flushThreadLoop() {
+		AsyncLogState& asyncState = log_file_getAsyncState();
+
+		while (!asyncState.stop.load(std::memory_order_relaxed)) {
+			if (log_file_drainAsyncRecords() == 0)
+				spring::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+
+		// final drain, no record that made it into the ring is lost
+		log_file_drainAsyncRecords();
+	}
 }
 
 
@@ -220,12 +306,41 @@ void log_file_removeLogFile(const char* filePath) {
 }
 
 void log_file_removeAllLogFiles() {
+	// join the flush thread while its output streams are still open
+	log_file_setAsyncWrites(false);
+
 	while (!log_file_getLogFiles().empty()) {
 		const auto lfi = log_file_getLogFiles().begin();
 		log_file_removeLogFile(lfi->first.c_str());
 	}
 }
 
+void log_file_setAsyncWrites(bool enable) {
+	AsyncLogState& asyncState = log_file_getAsyncState();
+
+	if (enable == asyncState.enabled.load())
+		return;
+
+	if (enable) {
+		// write anything still held in the pre-init buffer in order
+		if (log_file_isActivelyLogging())
+			log_file_writeBufferToFiles();
+
+		asyncState.stop = false;
+		asyncState.flushThread = spring::thread(&log_file_flushThreadLoop);
+		asyncState.enabled = true;
+	} else {
+		// stop producers first, then let the flush thread finish the backlog
+		asyncState.enabled = false;
+		asyncState.stop = true;
+
+		if (asyncState.flushThread.joinable())
+			asyncState.flushThread.join();
+
+		log_file_drainAsyncRecords();
+	}
+}
+
 
 /**
  * @name logging_sink_file
@@ -237,11 +352,25 @@ void log_file_removeAllLogFiles() {
 static void log_sink_record_file(int level, const char* section, const char* record)
 {
 	if (logFilesValidTracker && log_file_isActivelyLogging()) {
+		AsyncLogState& asyncState = log_file_getAsyncState();
+
+		if (asyncState.enabled.load(std::memory_order_relaxed)) {
+			// hand the record to the flush thread; never block the
+			// logging thread on disk I/O, drop and count instead
+			if (!asyncState.ring.push(AsyncLogRecord(level, section, record)))
+				asyncState.numDropped.fetch_add(1, std::memory_order_relaxed);
+
+			return;
+		}
+
+		char framePrefix[128] = {'\0'};
+		log_framePrefixer_createPrefix(framePrefix, sizeof(framePrefix));
+
 		// write buffer to log file
 		log_file_writeBufferToFiles();
 
 		// write current record to log file
-		log_file_writeToFiles(level, section, record);
+		log_file_writeToFiles(level, section, framePrefix, record);
 	} else {
 		// buffer until a log file is ready for output
 		log_file_writeToBuffer(level, section, record);
@@ -253,6 +382,12 @@ static void log_sink_cleanup_file() {
 	if (!log_file_isActivelyLogging())
 		return;
 
+	// during crash handling the flush thread might never run again; write
+	// whatever is still queued from this thread (racing a live consumer
+	// can at worst garble a few trailing records)
+	if (log_file_getAsyncState().enabled.load())
+		log_file_drainAsyncRecords();
+
 	// flush the log buffers to files
 	log_file_flushFiles();
 }
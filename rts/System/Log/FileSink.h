@@ -37,6 +37,15 @@ void log_file_removeLogFile(const char* filePath);
 
 void log_file_removeAllLogFiles();
 
+/**
+ * Enables or disables asynchronous file writes.
+ * While enabled, records are pushed onto a lock-free ring and written to
+ * disk by a dedicated flush thread instead of on the thread that logged;
+ * if the ring overflows, records are dropped (and the drops counted)
+ * rather than ever blocking a producer.
+ */
+void log_file_setAsyncWrites(bool enable);
+
 ///@}
 
 #ifdef __cplusplus
@@ -43,6 +43,10 @@ CONFIG(int, LogRepeatLimit)
 	.defaultValue(10)
 	.description("Allow at most this many consecutive identical messages to be logged.");
 
+CONFIG(bool, LogAsyncWrites)
+	.defaultValue(true)
+	.description("Write the logfile from a background thread so disk stalls never block the thread that logged; messages are dropped (and the drops counted) if its buffer overflows.");
+
 /******************************************************************************/
 /******************************************************************************/
 
@@ -264,6 +268,8 @@ void CLogOutput::Initialize()
 	log_file_addLogFile(filePath.c_str(), NULL, LOG_LEVEL_ALL, configHandler->GetInt("LogFlushLevel"));
 	InitializeLogSections();
 
+	log_file_setAsyncWrites(configHandler->GetBool("LogAsyncWrites"));
+
 	LOG("LogOutput initialized.");
 }
 
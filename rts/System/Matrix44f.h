@@ -6,6 +6,11 @@
 #include "System/float3.h"
 #include "System/float4.h"
 
+// NOT alignas(16): heap-allocating owners (pooled sim objects among
+// them) only get default operator-new alignment, which is 8 bytes on
+// 32-bit builds, and there is no aligned-new fallback in C++11; the
+// SSE kernels in Matrix44f.cpp use unaligned loads/stores throughout,
+// which cost nothing on addresses that happen to be aligned
 class CMatrix44f
 {
 public:
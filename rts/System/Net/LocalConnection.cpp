@@ -5,15 +5,19 @@
 #include "Exception.h"
 #include "ProtocolDef.h"
 #include "System/Log/ILog.h"
+#include "System/Misc/SpringTime.h"
 #include "System/SpringFormat.h"
 
 namespace netcode {
 
+// each DrainChannel call moves at most this many packets out of the
+// ring; roughly a frame's worth of traffic per synchronization point
+static const unsigned int drainBatchSize = 256;
+
 // static stuff
 unsigned CLocalConnection::instances = 0;
 
-std::deque< std::shared_ptr<const RawPacket> > CLocalConnection::pqueues[2];
-spring::mutex CLocalConnection::mutexes[2];
+spring::mpsc_channel< std::shared_ptr<const RawPacket>, 4096 > CLocalConnection::channels[2];
 
 CLocalConnection::CLocalConnection()
 {
@@ -25,7 +29,8 @@ CLocalConnection::CLocalConnection()
 	instances++;
 
 	// clear data that might have been left over (if we reloaded)
-	pqueues[instance].clear();
+	channels[instance].drain([](std::shared_ptr<const RawPacket>&& packet) {});
+	readBuf.clear();
 
 	// make sure protocoldef is initialized
 	CBaseNetProtocol::Get();
@@ -39,8 +44,8 @@ CLocalConnection::~CLocalConnection()
 void CLocalConnection::Close(bool flush)
 {
 	if (flush) {
-		std::lock_guard<spring::mutex> scoped_lock(mutexes[instance]);
-		pqueues[instance].clear();
+		DrainChannel();
+		readBuf.clear();
 	}
 }
 
@@ -56,18 +61,29 @@ void CLocalConnection::SendData(std::shared_ptr<const RawPacket> packet)
 
 	dataSent += packet->length;
 
-	// when sending from A to B we must lock B's queue
-	std::lock_guard<spring::mutex> scoped_lock(mutexes[OtherInstance()]);
-	pqueues[OtherInstance()].push_back(packet);
+	// when sending from A to B we push into B's ring; the link is
+	// reliable so on a full ring (receiver has not consumed anything
+	// for minutes) we must wait for it to drain rather than drop
+	while (!channels[OtherInstance()].push(packet)) {
+		spring_sleep(spring_msecs(1));
+	}
+}
+
+void CLocalConnection::DrainChannel() const
+{
+	// batch-move whatever the other instance pushed since the last call
+	channels[instance].drain([&](std::shared_ptr<const RawPacket>&& packet) {
+		readBuf.push_back(std::move(packet));
+	}, drainBatchSize);
 }
 
 std::shared_ptr<const RawPacket> CLocalConnection::GetData()
 {
-	std::lock_guard<spring::mutex> scoped_lock(mutexes[instance]);
+	DrainChannel();
 
-	if (!pqueues[instance].empty()) {
-		std::shared_ptr<const RawPacket> next = pqueues[instance].front();
-		pqueues[instance].pop_front();
+	if (!readBuf.empty()) {
+		std::shared_ptr<const RawPacket> next = readBuf.front();
+		readBuf.pop_front();
 		dataRecv += next->length;
 		return next;
 	}
@@ -78,10 +94,10 @@ std::shared_ptr<const RawPacket> CLocalConnection::GetData()
 
 std::shared_ptr<const RawPacket> CLocalConnection::Peek(unsigned ahead) const
 {
-	std::lock_guard<spring::mutex> scoped_lock(mutexes[instance]);
+	DrainChannel();
 
-	if (ahead < pqueues[instance].size())
-		return pqueues[instance][ahead];
+	if (ahead < readBuf.size())
+		return readBuf[ahead];
 
 	std::shared_ptr<const RawPacket> empty;
 	return empty;
@@ -89,12 +105,12 @@ std::shared_ptr<const RawPacket> CLocalConnection::Peek(unsigned ahead) const
 
 void CLocalConnection::DeleteBufferPacketAt(unsigned index)
 {
-	std::lock_guard<spring::mutex> scoped_lock(mutexes[instance]);
+	DrainChannel();
 
-	if (index >= pqueues[instance].size())
+	if (index >= readBuf.size())
 		return;
 
-	pqueues[instance].erase(pqueues[instance].begin() + index);
+	readBuf.erase(readBuf.begin() + index);
 }
 
 
@@ -114,14 +130,14 @@ std::string CLocalConnection::GetFullAddress() const
 
 bool CLocalConnection::HasIncomingData() const
 {
-	std::lock_guard<spring::mutex> scoped_lock(mutexes[instance]);
-	return (!pqueues[instance].empty());
+	DrainChannel();
+	return (!readBuf.empty());
 }
 
 unsigned int CLocalConnection::GetPacketQueueSize() const
 {
-	std::lock_guard<spring::mutex> scoped_lock(mutexes[instance]);
-	return (!pqueues[instance].size());
+	DrainChannel();
+	return (readBuf.size());
 }
 
 } // namespace netcode
@@ -4,7 +4,7 @@
 #define _LOCAL_CONNECTION_H
 
 #include <deque>
-#include "System/Threading/SpringThreading.h"
+#include "System/Threading/MPSCChannel.hpp"
 
 #include "Connection.h"
 
@@ -53,8 +53,15 @@ public:
 	// END overriding CConnection
 
 private:
-	static std::deque< std::shared_ptr<const RawPacket> > pqueues[2];
-	static spring::mutex mutexes[2];
+	/// lock-free handoff rings, one per direction; each instance consumes
+	/// from channels[instance] and produces into the other instance's ring
+	static spring::mpsc_channel< std::shared_ptr<const RawPacket>, 4096 > channels[2];
+
+	/// packets already drained from our ring; only the consumer (owning
+	/// thread) of this instance touches it, so no locking is needed
+	mutable std::deque< std::shared_ptr<const RawPacket> > readBuf;
+
+	void DrainChannel() const;
 
 	unsigned int OtherInstance() const { return ((instance + 1) % 2); }
 
@@ -62,6 +62,25 @@ public:
 	}
 #endif
 
+	/// packs an unsigned integer as a 7-bit little-endian varint (LEB128)
+	PackPacket& PackUVarint(uint32_t val) {
+		while (val >= 0x80) {
+			*this << static_cast<uint8_t>((val & 0x7F) | 0x80);
+			val >>= 7;
+		}
+		return (*this << static_cast<uint8_t>(val));
+	}
+
+	/// number of bytes PackUVarint will use for the given value
+	static uint32_t UVarintSize(uint32_t val) {
+		uint32_t size = 1;
+		while (val >= 0x80) {
+			val >>= 7;
+			size += 1;
+		}
+		return size;
+	}
+
 	uint8_t* GetWritingPos() { return (data + pos); }
 
 private:
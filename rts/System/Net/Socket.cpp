@@ -2,6 +2,14 @@
 
 #include "Socket.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+	#include <sys/socket.h>
+#endif
+
 #include "lib/streflop/streflop_cond.h"
 
 #include "System/Log/ILog.h"
@@ -13,6 +21,134 @@ namespace netcode
 
 asio::io_service netservice;
 
+// maximum number of datagrams moved per syscall, and the size of each
+// receive slot; engine datagrams never exceed udpMaxPacketSize (4096)
+static const unsigned int maxBatchDgrams = 64;
+static const unsigned int recvSlotSize = 4096;
+
+
+unsigned int ReceiveDatagrams(asio::ip::udp::socket& socket, std::vector<Datagram>& dgrams)
+{
+	unsigned int numReceived = 0;
+
+#ifdef __linux__
+	std::vector<std::uint8_t> slots(maxBatchDgrams * recvSlotSize);
+
+	mmsghdr msgs[maxBatchDgrams];
+	iovec iovs[maxBatchDgrams];
+	sockaddr_storage addrs[maxBatchDgrams];
+
+	int numMsgs = 0;
+
+	do {
+		std::memset(msgs, 0, sizeof(msgs));
+
+		for (unsigned int i = 0; i < maxBatchDgrams; i++) {
+			iovs[i].iov_base = &slots[i * recvSlotSize];
+			iovs[i].iov_len = recvSlotSize;
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+			msgs[i].msg_hdr.msg_name = &addrs[i];
+			msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+		}
+
+		// EAGAIN (empty queue) just ends the loop, like try_again below
+		if ((numMsgs = recvmmsg(socket.native_handle(), msgs, maxBatchDgrams, MSG_DONTWAIT, nullptr)) <= 0)
+			break;
+
+		for (int i = 0; i < numMsgs; i++) {
+			dgrams.emplace_back();
+			Datagram& dgram = dgrams.back();
+
+			// recover the sender's endpoint from the raw sockaddr
+			std::memcpy(dgram.endpoint.data(), &addrs[i], msgs[i].msg_hdr.msg_namelen);
+			dgram.endpoint.resize(msgs[i].msg_hdr.msg_namelen);
+
+			const std::uint8_t* slot = &slots[i * recvSlotSize];
+			dgram.data.assign(slot, slot + msgs[i].msg_len);
+		}
+
+		numReceived += numMsgs;
+	} while (numMsgs == int(maxBatchDgrams));
+#else
+	asio::error_code err;
+
+	while (socket.available(err) > 0 && !err) {
+		dgrams.emplace_back();
+		Datagram& dgram = dgrams.back();
+		dgram.data.resize(socket.available());
+
+		asio::ip::udp::socket::message_flags flags = 0;
+		const size_t numBytes = socket.receive_from(asio::buffer(dgram.data), dgram.endpoint, flags, err);
+
+		if (CheckErrorCode(err)) {
+			dgrams.pop_back();
+			break;
+		}
+
+		dgram.data.resize(numBytes);
+		numReceived += 1;
+	}
+#endif
+
+	return numReceived;
+}
+
+void SendDatagrams(asio::ip::udp::socket& socket, const std::vector<Datagram>& dgrams)
+{
+#ifdef __linux__
+	for (size_t base = 0; base < dgrams.size(); base += maxBatchDgrams) {
+		const unsigned int numMsgs = std::min(dgrams.size() - base, size_t(maxBatchDgrams));
+
+		mmsghdr msgs[maxBatchDgrams];
+		iovec iovs[maxBatchDgrams];
+
+		std::memset(msgs, 0, sizeof(msgs));
+
+		for (unsigned int i = 0; i < numMsgs; i++) {
+			const Datagram& dgram = dgrams[base + i];
+
+			iovs[i].iov_base = const_cast<std::uint8_t*>(&dgram.data[0]);
+			iovs[i].iov_len = dgram.data.size();
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+			msgs[i].msg_hdr.msg_name = const_cast<sockaddr*>(reinterpret_cast<const sockaddr*>(dgram.endpoint.data()));
+			msgs[i].msg_hdr.msg_namelen = dgram.endpoint.size();
+		}
+
+		unsigned int numSent = 0;
+
+		while (numSent < numMsgs) {
+			const int n = sendmmsg(socket.native_handle(), msgs + numSent, numMsgs - numSent, 0);
+
+			if (n > 0) {
+				numSent += n;
+				continue;
+			}
+			if (errno == EINTR)
+				continue;
+
+			// dropping the rest on a full send-buffer matches the old
+			// per-packet behavior; the resend logic recovers from it
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+				LOG_L(L_WARNING, "Network error %i: %s", errno, std::strerror(errno));
+
+			return;
+		}
+	}
+#else
+	for (const Datagram& dgram: dgrams) {
+		asio::ip::udp::socket::message_flags flags = 0;
+		asio::error_code err;
+
+		socket.send_to(asio::buffer(dgram.data), dgram.endpoint, flags, err);
+
+		if (CheckErrorCode(err))
+			return;
+	}
+#endif
+}
+
 bool CheckErrorCode(asio::error_code& err)
 {
 	// connection reset can happen when host did not start up
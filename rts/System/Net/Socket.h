@@ -3,6 +3,9 @@
 #ifndef SOCKET_H
 #define SOCKET_H
 
+#include <cstdint>
+#include <vector>
+
 #include <asio/io_service.hpp>
 #include <asio/ip/udp.hpp>
 #include <asio/ip/tcp.hpp>
@@ -13,6 +16,28 @@ namespace netcode
 
 extern asio::io_service netservice;
 
+/**
+ * A single datagram for the batch I/O helpers below.
+ */
+struct Datagram {
+	asio::ip::udp::endpoint endpoint;
+	std::vector<std::uint8_t> data;
+};
+
+/**
+ * Receives all currently queued datagrams from a (non-blocking) socket,
+ * using a single recvmmsg syscall per batch where the platform provides
+ * one and falling back to one receive_from per datagram elsewhere.
+ * Appends to dgrams and returns the number of datagrams received.
+ */
+unsigned int ReceiveDatagrams(asio::ip::udp::socket& socket, std::vector<Datagram>& dgrams);
+
+/**
+ * Sends the given datagrams, batched into a single sendmmsg syscall
+ * where the platform provides one.
+ */
+void SendDatagrams(asio::ip::udp::socket& socket, const std::vector<Datagram>& dgrams);
+
 /**
  * Check if a network error occured and eventually log it.
  * @returns true if a network error occured, false otherwise
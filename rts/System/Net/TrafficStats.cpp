@@ -0,0 +1,55 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "TrafficStats.h"
+
+#include "System/Misc/SpringTime.h"
+
+namespace netcode {
+
+TrafficStats::TypeStats TrafficStats::stats[256];
+
+static spring_time lastRollTime;
+
+
+void TrafficStats::RollWindows()
+{
+	const spring_time now = spring_gettime();
+
+	if ((now - lastRollTime) < spring_secs(1))
+		return;
+
+	for (TypeStats& ts: stats) {
+		ts.sentBytesPerSec = ts.curSentBytes;
+		ts.recvBytesPerSec = ts.curRecvBytes;
+		ts.curSentBytes = 0;
+		ts.curRecvBytes = 0;
+	}
+
+	lastRollTime = now;
+}
+
+void TrafficStats::RecordSent(std::uint8_t msgID, std::uint32_t numBytes)
+{
+	RollWindows();
+
+	stats[msgID].sentPackets += 1;
+	stats[msgID].sentBytes += numBytes;
+	stats[msgID].curSentBytes += numBytes;
+}
+
+void TrafficStats::RecordRecv(std::uint8_t msgID, std::uint32_t numBytes)
+{
+	RollWindows();
+
+	stats[msgID].recvPackets += 1;
+	stats[msgID].recvBytes += numBytes;
+	stats[msgID].curRecvBytes += numBytes;
+}
+
+const TrafficStats::TypeStats& TrafficStats::GetStats(std::uint8_t msgID)
+{
+	RollWindows();
+	return stats[msgID];
+}
+
+} // namespace netcode
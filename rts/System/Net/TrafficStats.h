@@ -0,0 +1,50 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef NET_TRAFFIC_STATS_H
+#define NET_TRAFFIC_STATS_H
+
+#include <cstdint>
+
+namespace netcode {
+
+/**
+ * @brief Per-message-type network traffic accounting
+ *
+ * Accumulates packet and byte counts per NETMSG type in both directions,
+ * plus a rolling one-second rate window, so that bandwidth hogs (e.g. a
+ * gadget spamming NETMSG_LUAMSG) can be identified without a packet
+ * capture. All entry points are called from the main thread only
+ * (ClientReadNet and CNetProtocol::Send), so no locking is needed.
+ */
+class TrafficStats {
+public:
+	struct TypeStats {
+		std::uint32_t sentPackets = 0;
+		std::uint32_t recvPackets = 0;
+		std::uint32_t sentBytes = 0;
+		std::uint32_t recvBytes = 0;
+
+		/// bytes moved during the last completed one-second window
+		std::uint32_t sentBytesPerSec = 0;
+		std::uint32_t recvBytesPerSec = 0;
+
+		/// bytes accumulated in the window currently being filled
+		std::uint32_t curSentBytes = 0;
+		std::uint32_t curRecvBytes = 0;
+	};
+
+	static void RecordSent(std::uint8_t msgID, std::uint32_t numBytes);
+	static void RecordRecv(std::uint8_t msgID, std::uint32_t numBytes);
+
+	static const TypeStats& GetStats(std::uint8_t msgID);
+
+private:
+	/// completes the rate windows if at least a second has passed
+	static void RollWindows();
+
+	static TypeStats stats[256];
+};
+
+} // namespace netcode
+
+#endif // NET_TRAFFIC_STATS_H
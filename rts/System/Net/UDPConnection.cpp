@@ -29,6 +29,17 @@ static const unsigned udpMaxPacketSize = 4096;
 static const int maxChunkSize = 254;
 static const int chunksPerSec = 30;
 
+// flush deadlines (in milliseconds) for queued outgoing data; frames
+// and sync responses go out almost immediately, bulk traffic may
+// linger a bit longer so it coalesces into MTU-sized chunks
+static const int prioFlushDeadline =  3;
+static const int bulkFlushDeadline = 10;
+
+static inline bool IsPrioMessage(std::uint8_t msgID)
+{
+	return (msgID == NETMSG_KEYFRAME || msgID == NETMSG_NEWFRAME || msgID == NETMSG_SYNCRESPONSE);
+}
+
 
 
 #if NETWORK_TEST
@@ -272,6 +283,7 @@ void UDPConnection::Init()
 	lastPacketSendTime = spring_gettime();
 	lastPacketRecvTime = spring_gettime();
 	lastChunkCreatedTime = spring_gettime();
+	firstQueuedTime = spring_gettime();
 
 	#ifdef ENABLE_DEBUG_STATS
 	lastDebugMessageTime = spring_gettime();
@@ -296,6 +308,9 @@ void UDPConnection::Init()
 	lastNak = -1;
 	sentOverhead = 0;
 	recvOverhead = 0;
+	prioLaneMsgs = bulkLaneMsgs = 0;
+	prioLaneBytes = bulkLaneBytes = 0;
+	numQueuedPrioMsgs = 0;
 	fragmentBuffer = 0;
 	resentChunks = 0;
 	sentPackets = recvPackets = 0;
@@ -344,6 +359,22 @@ UDPConnection::~UDPConnection()
 void UDPConnection::SendData(std::shared_ptr<const RawPacket> data)
 {
 	assert(data->length > 0);
+
+	if (outgoingData.empty())
+		firstQueuedTime = spring_gettime();
+
+	// the stream is ordered so priority messages can not be moved
+	// ahead of older data, but their presence shortens the deadline
+	// by which the queue must be flushed
+	if (IsPrioMessage(data->data[0])) {
+		numQueuedPrioMsgs += 1;
+		prioLaneMsgs += 1;
+		prioLaneBytes += data->length;
+	} else {
+		bulkLaneMsgs += 1;
+		bulkLaneBytes += data->length;
+	}
+
 	outgoingData.push_back(data);
 }
 
@@ -635,7 +666,13 @@ void UDPConnection::Flush(const bool forced)
 		}
 	}
 
-	if (forced || (!waitMore && outgoingLength > requiredLength)) {
+	// deadline scheduling; a queue holding priority messages must be
+	// flushed almost immediately, bulk-only traffic may coalesce a
+	// little longer but never waits for the size heuristic above
+	const int flushDeadline = (numQueuedPrioMsgs > 0)? prioFlushDeadline: bulkFlushDeadline;
+	const bool deadlineExpired = (!outgoingData.empty() && (curTime - firstQueuedTime) > spring_msecs(flushDeadline));
+
+	if (forced || deadlineExpired || (!waitMore && outgoingLength > requiredLength)) {
 		std::uint8_t buffer[udpMaxPacketSize];
 		unsigned pos = 0;
 
@@ -681,6 +718,13 @@ void UDPConnection::Flush(const bool forced)
 				pos = 0;
 			}
 		} while (!outgoingData.empty() && sendMore);
+
+		if (outgoingData.empty()) {
+			numQueuedPrioMsgs = 0;
+		} else {
+			// bandwidth-limited partial drain, restart the deadline
+			firstQueuedTime = curTime;
+		}
 	}
 
 	SendIfNecessary(forced);
@@ -732,6 +776,8 @@ std::string UDPConnection::Statistics() const
 			spring::SafeDivide(sentOverhead, dataSent), spring::SafeDivide(recvOverhead, dataRecv) );
 	msg += spring::format("\t%u incoming chunks dropped, %u outgoing chunks resent\n",
 			droppedChunks, resentChunks);
+	msg += spring::format("\tPriority lane: %u messages / %u bytes, bulk lane: %u messages / %u bytes\n",
+			prioLaneMsgs, prioLaneBytes, bulkLaneMsgs, bulkLaneBytes);
 	return msg;
 }
 
@@ -931,6 +977,8 @@ void UDPConnection::SendIfNecessary(bool flushed)
 				RequestResend(unackedChunks[i]);
 		}
 	}
+
+	FlushSendBatch();
 }
 
 void UDPConnection::SendPacket(Packet& pkt)
@@ -940,18 +988,26 @@ void UDPConnection::SendPacket(Packet& pkt)
 
 	outgoing.DataSent(data.size());
 	lastPacketSendTime = spring_gettime();
+	dataSent += data.size();
+	++sentPackets;
+
 	ip::udp::socket::message_flags flags = 0;
 	asio::error_code err;
 
 	EMULATE_LATENCY( !EMULATE_PACKET_LOSS( LOSS_COUNTER ) ) {
-		mySocket->send_to(buffer(data), addr, flags, err);
+		sendBatch.emplace_back();
+		sendBatch.back().endpoint = addr;
+		sendBatch.back().data = std::move(data);
 	}
+}
 
-	if (CheckErrorCode(err))
+void UDPConnection::FlushSendBatch()
+{
+	if (sendBatch.empty())
 		return;
 
-	dataSent += data.size();
-	++sentPackets;
+	SendDatagrams(*mySocket, sendBatch);
+	sendBatch.clear();
 }
 
 void UDPConnection::AckChunks(int lastAck)
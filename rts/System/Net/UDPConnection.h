@@ -10,6 +10,7 @@
 #include <list>
 
 #include "Connection.h"
+#include "Socket.h"
 #include "System/Misc/SpringTime.h"
 
 class CRC;
@@ -142,9 +143,13 @@ private:
 	void AckChunks(int lastAck);
 
 	void RequestResend(ChunkPtr ptr);
+	/// serialize a packet into the send batch
 	void SendPacket(Packet& pkt);
+	/// push all batched packets to the socket with as few syscalls as possible
+	void FlushSendBatch();
 
 	spring_time lastChunkCreatedTime;
+	spring_time firstQueuedTime;
 	spring_time lastPacketSendTime;
 	spring_time lastPacketRecvTime;
 
@@ -188,6 +193,9 @@ private:
 	/// complete packets we received but did not yet consume
 	std::deque< std::shared_ptr<const RawPacket> > msgQueue;
 
+	/// serialized packets waiting for the next FlushSendBatch
+	std::vector<Datagram> sendBatch;
+
 	std::int32_t lastMidChunk;
 
 #if	NETWORK_TEST
@@ -224,6 +232,13 @@ private:
 	unsigned int sentOverhead, recvOverhead;
 	unsigned int sentPackets, recvPackets;
 
+	// per-lane statistics for flush scheduling; sim-critical messages
+	// (frames, sync responses) form the priority lane, the rest is bulk
+	unsigned int prioLaneMsgs, prioLaneBytes;
+	unsigned int bulkLaneMsgs, bulkLaneBytes;
+	// priority messages currently waiting in outgoingData
+	unsigned int numQueuedPrioMsgs;
+
 	class BandwidthUsage {
 	public:
 		BandwidthUsage();
@@ -115,16 +115,13 @@ std::string UDPListener::TryBindSocket(int port, SocketPtr* socket, const std::s
 void UDPListener::Update() {
 	netservice.poll();
 
-	size_t bytes_avail = 0;
+	// move all queued datagrams out of the kernel in large batches
+	// (one syscall each), instead of paying one syscall per datagram
+	std::vector<Datagram> dgrams;
+	ReceiveDatagrams(*mySocket, dgrams);
 
-	while ((bytes_avail = mySocket->available()) > 0) {
-		std::vector<std::uint8_t> buffer(bytes_avail);
-
-		ip::udp::endpoint sender_endpoint;
-		asio::ip::udp::socket::message_flags flags = 0;
-		asio::error_code err;
-
-		const size_t bytesReceived = mySocket->receive_from(asio::buffer(buffer), sender_endpoint, flags, err);
+	for (const Datagram& dgram: dgrams) {
+		const ip::udp::endpoint& sender_endpoint = dgram.endpoint;
 
 		const auto ci = connMap.find(sender_endpoint);
 		const bool knownConnection = (ci != connMap.end());
@@ -132,13 +129,10 @@ void UDPListener::Update() {
 		if (knownConnection && ci->second.expired())
 			continue;
 
-		if (CheckErrorCode(err))
-			break;
-
-		if (bytesReceived < Packet::headerSize)
+		if (dgram.data.size() < Packet::headerSize)
 			continue;
 
-		Packet data(&buffer[0], bytesReceived);
+		Packet data(&dgram.data[0], dgram.data.size());
 
 		if (knownConnection) {
 			ci->second.lock()->ProcessRawPacket(data);
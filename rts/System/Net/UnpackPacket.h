@@ -60,6 +60,22 @@ public:
 		pos += text.size() + 1;
 	}
 
+	/// unpacks an integer packed by PackPacket::PackUVarint
+	uint32_t UnpackUVarint()
+	{
+		uint32_t val = 0;
+
+		for (unsigned int shift = 0; shift < 32; shift += 7) {
+			uint8_t byte = 0; (*this) >> byte;
+			val |= (uint32_t(byte & 0x7F) << shift);
+
+			if ((byte & 0x80) == 0)
+				return val;
+		}
+
+		throw UnpackPacketException("Unpack failure (varint)");
+	}
+
 private:
 	std::shared_ptr<const RawPacket> pckt;
 	size_t pos;
@@ -1,9 +1,9 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
 
+#include <algorithm>
+
 #include "System/Object.h"
-#include "System/ContainerUtil.h"
-#include "System/creg/STL_Map.h"
 #include "System/Log/ILog.h"
 #include "System/Platform/CrashHandler.h"
 
@@ -15,28 +15,58 @@ CR_REG_METADATA(CObject, (
 	CR_MEMBER(detached),
 
 	CR_MEMBER(listening),
-	CR_MEMBER(listeners),
-	CR_MEMBER(listenersDepTbl),
-	CR_MEMBER(listeningDepTbl)
+	CR_MEMBER(listeners)
+))
+
+CR_BIND(CObject::DependenceLink, )
+
+CR_REG_METADATA_SUB(CObject, DependenceLink, (
+	CR_MEMBER(dep),
+	CR_MEMBER(obj)
 ))
 
+
+
+typedef CObject::DependenceLink DependenceLink;
+
 std::atomic<std::int64_t> CObject::cur_sync_id(0);
 
 
+static bool LinkLess(const DependenceLink& a, const DependenceLink& b)
+{
+	if (a.obj->GetSyncID() != b.obj->GetSyncID())
+		return (a.obj->GetSyncID() < b.obj->GetSyncID());
 
-static bool VectorInsertSorted(std::vector<CObject*>& v, CObject* o)
+	return (a.dep < b.dep);
+}
+
+static bool LinkInsertUnique(CObject::TDependenceLinks& v, const DependenceLink& l)
 {
-	return (spring::VectorInsertUniqueSorted(v, o, [](const CObject* a, const CObject* b) { return (a->GetSyncID() < b->GetSyncID()); }));
+	// the same dependence can legitimately be requested from several
+	// places at once, only the first registration stores the link
+	const auto it = std::lower_bound(v.begin(), v.end(), l, LinkLess);
+
+	if (it != v.end() && *it == l)
+		return false;
+
+	v.insert(it, l);
+	return true;
 }
 
-static bool VectorEraseSorted(std::vector<CObject*>& v, CObject* o)
+static bool LinkErase(CObject::TDependenceLinks& v, const DependenceLink& l)
 {
-	return (spring::VectorEraseUniqueSorted(v, o, [](const CObject* a, const CObject* b) { return (a->GetSyncID() < b->GetSyncID()); }));
+	const auto it = std::lower_bound(v.begin(), v.end(), l, LinkLess);
+
+	if (it == v.end() || !(*it == l))
+		return false;
+
+	v.erase(it);
+	return true;
 }
 
 
 
-CObject::CObject() : detached(false), listeners(), listening()
+CObject::CObject() : detached(false)
 {
 	// Note1: this static var is shared between all different types of classes synced & unsynced (CUnit, CFeature, CProjectile, ...)
 	//  Still it doesn't break syncness even when synced objects have different sync_ids between clients as long as the sync_id is
@@ -54,34 +84,17 @@ CObject::~CObject()
 	assert(!detached);
 	detached = true;
 
-	for (const auto& p: listenersDepTbl) {
-		assert(p.first >= DEPENDENCE_ATTACKER && p.first < DEPENDENCE_COUNT);
-		assert(p.second < listeners.size());
-
-		for (CObject* obj: listeners[p.second]) {
-			obj->DependentDied(this);
-
-			const auto jt = obj->listeningDepTbl.find(p.first);
+	for (const DependenceLink& l: listeners) {
+		assert(l.dep >= DEPENDENCE_ATTACKER && l.dep < DEPENDENCE_COUNT);
 
-			if (jt == obj->listeningDepTbl.end())
-				continue;
-
-			VectorEraseSorted(obj->listening[ jt->second ], this);
-		}
+		l.obj->DependentDied(this);
+		LinkErase(l.obj->listening, DependenceLink(l.dep, this));
 	}
 
-	for (const auto& p: listeningDepTbl) {
-		assert(p.first >= DEPENDENCE_ATTACKER && p.first < DEPENDENCE_COUNT);
-		assert(p.second < listening.size());
-
-		for (CObject* obj: listening[p.second]) {
-			const auto jt = obj->listenersDepTbl.find(p.first);
-
-			if (jt == obj->listenersDepTbl.end())
-				continue;
+	for (const DependenceLink& l: listening) {
+		assert(l.dep >= DEPENDENCE_ATTACKER && l.dep < DEPENDENCE_COUNT);
 
-			VectorEraseSorted(obj->listeners[ jt->second ], this);
-		}
+		LinkErase(l.obj->listeners, DependenceLink(l.dep, this));
 	}
 }
 
@@ -99,8 +112,8 @@ void CObject::AddDeathDependence(CObject* obj, DependenceType dep)
 	if (detached || obj->detached)
 		return;
 
-	VectorInsertSorted(const_cast<TSyncSafeSet&>(     GetListening(dep)),  obj);
-	VectorInsertSorted(const_cast<TSyncSafeSet&>(obj->GetListeners(dep)), this);
+	LinkInsertUnique(     listening, DependenceLink(dep,  obj));
+	LinkInsertUnique(obj->listeners, DependenceLink(dep, this));
 }
 
 
@@ -111,10 +124,6 @@ void CObject::DeleteDeathDependence(CObject* obj, DependenceType dep)
 	if (detached || obj->detached)
 		return;
 
-	const auto it =      listeningDepTbl.find(dep);
-	const auto jt = obj->listenersDepTbl.find(dep);
-
-	if (it !=      listeningDepTbl.end()) VectorEraseSorted(     listening[ it->second ],  obj);
-	if (jt != obj->listenersDepTbl.end()) VectorEraseSorted(obj->listeners[ jt->second ], this);
+	LinkErase(     listening, DependenceLink(dep,  obj));
+	LinkErase(obj->listeners, DependenceLink(dep, this));
 }
-
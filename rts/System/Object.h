@@ -4,16 +4,17 @@
 #define OBJECT_H
 
 #include <atomic>
-#include <vector>
+#include <cstdint>
 
 #include "ObjectDependenceTypes.h"
 #include "System/creg/creg_cond.h"
-#include "System/UnorderedMap.hpp"
+#include "System/SmallVector.h"
 
 class CObject
 {
 public:
 	CR_DECLARE(CObject)
+	CR_DECLARE_SUB(DependenceLink)
 
 	CObject();
 	virtual ~CObject();
@@ -68,49 +69,40 @@ public:
 
 private:
 	// Note, this has nothing to do with the UnitID, FeatureID, ...
-	// Its only purpose is to make the sorting in TSyncSafeSet syncsafe
+	// Its only purpose is to make the sorting of dependence links syncsafe
 	std::int64_t sync_id;
 	static std::atomic<std::int64_t> cur_sync_id;
 
 public:
-	typedef std::vector<CObject*> TSyncSafeSet;
-	typedef std::vector<TSyncSafeSet> TDependenceMap;
+	struct DependenceLink {
+		CR_DECLARE_STRUCT(DependenceLink)
 
-	bool detached;
-
-protected:
-	const TSyncSafeSet& GetListeners(const DependenceType dep) {
-		const auto it = listenersDepTbl.find(dep);
-
-		if (it == listenersDepTbl.end()) {
-			listeners.emplace_back();
-			listenersDepTbl[dep] = listeners.size() - 1;
-			return (listeners.back());
-		}
+		DependenceLink(): dep(DEPENDENCE_NONE), obj(nullptr) {}
+		DependenceLink(int dep, CObject* obj): dep(dep), obj(obj) {}
 
-		return (listeners[it->second]);
-	}
-	const TSyncSafeSet& GetListening(const DependenceType dep) {
-		const auto it = listeningDepTbl.find(dep);
+		bool operator == (const DependenceLink& l) const { return (dep == l.dep && obj == l.obj); }
 
-		if (it == listeningDepTbl.end()) {
-			listening.emplace_back();
-			listeningDepTbl[dep] = listening.size() - 1;
-			return (listening.back());
-		}
+		int dep;
+		CObject* obj;
+	};
 
-		return (listening[it->second]);
-	}
+	// objects rarely hold more than a few dependences at once (across all
+	// types), so both directions are stored as flat (type, object) links
+	// with inline capacity; the common add/delete cycle then never touches
+	// the heap and lookups stay linear over a single cache line. links are
+	// kept ordered by sync_id so ~CObject fires DependentDied in the same
+	// order on every client no matter the add/delete history
+	typedef spring::SmallVector<DependenceLink, 4> TDependenceLinks;
 
-	const TDependenceMap& GetAllListeners() const { return listeners; }
-	const TDependenceMap& GetAllListening() const { return listening; }
+	bool detached;
 
 protected:
-	spring::unordered_map<int, size_t> listenersDepTbl; // maps dependence-type to index into listeners
-	spring::unordered_map<int, size_t> listeningDepTbl; // maps dependence-type to index into listening
+	const TDependenceLinks& GetAllListeners() const { return listeners; }
+	const TDependenceLinks& GetAllListening() const { return listening; }
 
-	TDependenceMap listeners;
-	TDependenceMap listening;
+protected:
+	TDependenceLinks listeners;
+	TDependenceLinks listening;
 };
 
 #endif /* OBJECT_H */
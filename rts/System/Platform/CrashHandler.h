@@ -25,6 +25,13 @@ namespace CrashHandler {
 	 *   the parameter is specific to the needs of one platform.
 	 */
 	void SuspendedStacktrace(Threading::ThreadControls* ctls, const std::string& threadName);
+
+	/*
+	 * Lightweight variant for the Watchdog's stall sampler: suspends the
+	 * thread, unwinds only the raw instruction pointers (no symbolization,
+	 * no logging) and resumes it. Returns the number of frames collected.
+	 */
+	int SuspendedSampleIPs(Threading::ThreadControls* ctls, void** iparray, int maxDepth);
 #else
 	bool InitImageHlpDll();
 #endif
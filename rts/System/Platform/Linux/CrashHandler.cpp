@@ -809,6 +809,43 @@ namespace CrashHandler
     }
 
 
+    /**
+     * Collects only the raw instruction pointers of a suspended thread, for
+     * the Watchdog's high-frequency stall sampler. Symbolization is left to
+     * the caller (and done once per distinct stack, not per sample), so the
+     * suspend window stays as short as possible.
+     */
+    int SuspendedSampleIPs(Threading::ThreadControls* ctls, void** iparray, int maxDepth)
+    {
+        assert(ctls != nullptr);
+        assert(ctls->handle != 0);
+
+        ctls->Suspend();
+
+        unw_cursor_t cursor;
+        int depth = 0;
+
+#if (defined(__arm__) || defined(__APPLE__))
+        // cannot use the foreign ucontext_t here, see thread_unwind
+        unw_context_t thisctx;
+        unw_getcontext(&thisctx);
+
+        if (unw_init_local(&cursor, &thisctx) == 0) {
+#else
+        if (unw_init_local(&cursor, &ctls->ucontext) == 0) {
+#endif
+            for (; depth < maxDepth && unw_step(&cursor) > 0; depth++) {
+                unw_word_t ip;
+                unw_get_reg(&cursor, UNW_REG_IP, &ip);
+                iparray[depth] = reinterpret_cast<void*>(ip);
+            }
+        }
+
+        ctls->Resume();
+        return depth;
+    }
+
+
     /**
      * This stack trace is tailored for the SIGSEGV / SIGILL / SIGFPE etc signal handler.
      * The thread to be traced is usually in a halted state, but the signal handler can provide siginfo_t and ucontext_t structures to help produce the trace using libunwind.
@@ -11,9 +11,12 @@
 	#include "System/Sync/FPUCheck.h"
 #endif
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
 #if defined(__APPLE__) || defined(__FreeBSD__)
 #elif defined(WIN32)
 	#include <windows.h>
@@ -202,6 +205,223 @@ namespace Threading {
 	}
 
 
+
+	static CoreTopology coreTopology;
+	static bool haveCoreTopology = false;
+
+	static int pinPolicy = PIN_POLICY_NONE;
+	static std::atomic<std::uint32_t> appliedPinMasks[3];
+
+
+	#ifdef __linux__
+	/// parses "0-3" / "0,16" style cpu lists from sysfs into a bitmask
+	static std::uint32_t ParseCpuList(const char* buf)
+	{
+		std::uint32_t mask = 0;
+
+		const char* p = buf;
+
+		while (*p != 0) {
+			char* end = nullptr;
+			const long lo = strtol(p, &end, 10);
+
+			if (end == p)
+				break;
+
+			long hi = lo;
+			p = end;
+
+			if (*p == '-') {
+				hi = strtol(p + 1, &end, 10);
+				p = end;
+			}
+
+			for (long n = std::max(lo, 0L); n <= hi && n < 32; n++) {
+				mask |= (1u << n);
+			}
+
+			if (*p == ',')
+				p++;
+		}
+
+		return mask;
+	}
+	#endif
+
+
+	const CoreTopology& GetCoreTopology()
+	{
+		if (haveCoreTopology)
+			return coreTopology;
+
+		DetectCores();
+
+		coreTopology.availableMask = GetAvailableCoresMask();
+
+		bool haveSiblingInfo = false;
+
+	#ifdef __linux__
+		for (int cpu = 0; cpu < 32; cpu++) {
+			if ((coreTopology.availableMask & (1u << cpu)) == 0)
+				continue;
+
+			char path[128];
+			snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", cpu);
+
+			FILE* file = fopen(path, "r");
+
+			if (file == nullptr)
+				continue;
+
+			char buf[64] = {0};
+
+			if (fgets(buf, sizeof(buf), file) != nullptr) {
+				const std::uint32_t siblings = ParseCpuList(buf);
+
+				if (siblings != 0) {
+					coreTopology.siblingMasks[cpu] = siblings & ~(1u << cpu);
+
+					// the lowest-numbered sibling counts as its core's primary thread
+					if ((siblings & ((1u << cpu) - 1)) == 0) {
+						coreTopology.primaryCoreMask |= (1u << cpu);
+					} else {
+						coreTopology.smtSiblingMask |= (1u << cpu);
+					}
+
+					haveSiblingInfo = true;
+				}
+			}
+
+			fclose(file);
+		}
+	#endif
+
+		if (!haveSiblingInfo) {
+			// fall back to cpuid-based enumeration
+			springproc::CPUID cpuid;
+
+			for (int core = 0; core < cpuid.getTotalNumCores(); core++) {
+				const std::uint32_t coreMask = static_cast<std::uint32_t>(cpuid.getCoreAffinityMask(core));
+
+				if (coreMask == 0)
+					continue;
+
+				const std::uint32_t primBit = coreMask & (~coreMask + 1);
+
+				coreTopology.primaryCoreMask |= primBit;
+				coreTopology.smtSiblingMask |= (coreMask & ~primBit);
+
+				for (int cpu = 0; cpu < 32; cpu++) {
+					if ((coreMask & (1u << cpu)) != 0) {
+						coreTopology.siblingMasks[cpu] = coreMask & ~(1u << cpu);
+					}
+				}
+			}
+		}
+
+		if ((coreTopology.primaryCoreMask & coreTopology.availableMask) == 0) {
+			// last resort; treat every available cpu as its own physical core
+			coreTopology.primaryCoreMask = coreTopology.availableMask;
+			coreTopology.smtSiblingMask = 0;
+		}
+
+		haveCoreTopology = true;
+		return coreTopology;
+	}
+
+
+	void SetPinPolicy(int policy) { pinPolicy = policy; }
+	int GetPinPolicy() { return pinPolicy; }
+
+
+	std::uint32_t GetPinPolicyMask(PinRole role, int index)
+	{
+		if (pinPolicy == PIN_POLICY_NONE)
+			return 0;
+
+		const CoreTopology& topo = GetCoreTopology();
+
+		const std::uint32_t avail = topo.availableMask;
+		const std::uint32_t prim = topo.primaryCoreMask & avail;
+		const std::uint32_t sibl = topo.smtSiblingMask & avail;
+
+		if (prim == 0)
+			return 0;
+
+		// the main (sim) thread always owns the lowest-numbered physical core
+		const std::uint32_t mainCore = prim & (~prim + 1);
+
+		if (role == PIN_ROLE_MAIN)
+			return mainCore;
+
+		int mainCpu = 0;
+
+		while ((mainCore & (1u << mainCpu)) == 0)
+			mainCpu++;
+
+		const std::uint32_t mainSibs = topo.siblingMasks[mainCpu] & avail;
+
+		// workers prefer distinct physical cores; SMT siblings only get used
+		// when there are more workers than cores, and under ISOLATE the main
+		// core and its sibling(s) stay off-limits entirely
+		std::uint32_t pool[32];
+		int numPoolCpus = 0;
+
+		for (int pass = 0; pass < 2; pass++) {
+			const std::uint32_t passMask = (pass == 0) ? (prim & ~mainCore) : (sibl & ~mainSibs);
+
+			for (int cpu = 0; cpu < 32; cpu++) {
+				if ((passMask & (1u << cpu)) != 0) {
+					pool[numPoolCpus++] = (1u << cpu);
+				}
+			}
+		}
+
+		if (pinPolicy != PIN_POLICY_ISOLATE) {
+			// overflow onto the main core's sibling(s), never the main core itself
+			for (int cpu = 0; cpu < 32; cpu++) {
+				if ((mainSibs & (1u << cpu)) != 0) {
+					pool[numPoolCpus++] = (1u << cpu);
+				}
+			}
+		}
+
+		if (numPoolCpus == 0)
+			return 0;
+
+		if (role == PIN_ROLE_LOAD) {
+			// transient; may roam over every cpu the workers can use
+			std::uint32_t loadMask = 0;
+
+			for (int n = 0; n < numPoolCpus; n++) {
+				loadMask |= pool[n];
+			}
+
+			return loadMask;
+		}
+
+		return pool[index % numPoolCpus];
+	}
+
+
+	std::uint32_t ApplyPinPolicy(PinRole role, int index)
+	{
+		const std::uint32_t mask = GetPinPolicyMask(role, index);
+
+		if (mask == 0)
+			return 0;
+
+		static const char* roleNames[] = {"Main", "GameLoad", "Worker"};
+
+		SetAffinityHelper(roleNames[role], mask);
+
+		appliedPinMasks[role] |= mask;
+		return mask;
+	}
+
+	std::uint32_t GetAppliedPinMask(PinRole role) { return appliedPinMasks[role].load(); }
+
+
 	int GetLogicalCpuCores() {
 		// auto-detect number of system threads (including hyperthreading)
 		return spring::thread::hardware_concurrency();
@@ -340,6 +560,11 @@ namespace Threading {
 		}
 
 		SetCurrentThreadControls(true);
+
+		// when loading runs threaded, keep it off the main (sim) core;
+		// no-op while no pin policy is configured or with LoadingMT=0
+		if (!IsMainThread())
+			ApplyPinPolicy(PIN_ROLE_LOAD);
 	}
 
 	bool IsGameLoadThread() {
@@ -107,6 +107,44 @@ namespace Threading {
 	void SetAffinityHelper(const char* threadName, std::uint32_t affinity);
 	std::uint32_t GetAvailableCoresMask();
 
+
+	/**
+	 * Topology-aware thread-placement policy; pins the main (sim) thread,
+	 * the threaded game-load (GL) thread and the ThreadPool workers onto
+	 * physical cores so that multiple engine instances on one host do not
+	 * pile their hot threads onto the same SMT pairs (see ThreadPinPolicy)
+	 */
+	enum PinPolicy {
+		PIN_POLICY_NONE    = 0, // leave placement to the OS scheduler
+		PIN_POLICY_COMPACT = 1, // one distinct physical core per thread, SMT siblings only on overflow
+		PIN_POLICY_ISOLATE = 2, // as COMPACT, but workers never share the main core or its SMT sibling
+	};
+	enum PinRole {
+		PIN_ROLE_MAIN   = 0,
+		PIN_ROLE_LOAD   = 1,
+		PIN_ROLE_WORKER = 2,
+	};
+
+	struct CoreTopology {
+		std::uint32_t availableMask;    // logical cpus this process may run on
+		std::uint32_t primaryCoreMask;  // lowest-numbered logical cpu of every physical core
+		std::uint32_t smtSiblingMask;   // all remaining SMT threads
+		std::uint32_t siblingMasks[32]; // per logical cpu, its SMT siblings (excluding itself)
+	};
+
+	/// detected once on first use; sysfs topology on Linux, cpuid elsewhere
+	const CoreTopology& GetCoreTopology();
+
+	void SetPinPolicy(int policy);
+	int GetPinPolicy();
+
+	/// the cpu mask the active policy assigns to <role>; 0 when no policy is set
+	std::uint32_t GetPinPolicyMask(PinRole role, int index = 0);
+	/// pins the calling thread to GetPinPolicyMask() and records the result
+	std::uint32_t ApplyPinPolicy(PinRole role, int index = 0);
+	/// union of the masks actually applied so far for <role>, for debug display
+	std::uint32_t GetAppliedPinMask(PinRole role);
+
 	/**
 	 * returns count of cpu cores/ hyperthreadings cores
 	 */
@@ -7,8 +7,14 @@
 #endif
 
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <functional>
 
+#ifndef WIN32
+	#include <execinfo.h>
+#endif
+
 #include "Game/GameVersion.h"
 #include "System/Config/ConfigHandler.h"
 #include "System/Log/ILog.h"
@@ -18,9 +24,12 @@
 #include "System/Platform/Misc.h"
 #include "System/Platform/Threading.h"
 #include "System/Threading/SpringThreading.h"
+#include "System/TimeProfiler.h"
 
 CONFIG(int, HangTimeout).defaultValue(10).minimumValue(-1).maximumValue(600)
 		.description("Number of seconds that, if spent in the same code segment, indicate a hang; -1 to disable.");
+CONFIG(int, StallSampleTimeout).defaultValue(1).minimumValue(-1).maximumValue(600)
+		.description("Number of seconds in the same code segment after which the watchdog starts stack-sampling the thread for an aggregated stall report; -1 to disable. Must be smaller than HangTimeout.");
 
 namespace Watchdog
 {
@@ -86,8 +95,25 @@ namespace Watchdog
 
 	static spring::thread* hangDetectorThread = NULL;
 	static spring_time hangTimeout = spring_msecs(0);
+	static spring_time stallSampleTimeout = spring_msecs(0);
 	static volatile bool hangDetectorThreadInterrupted = false;
 
+#ifndef WIN32
+	// ring of raw-IP stack samples taken while a thread is past the soft
+	// (StallSampleTimeout) but not yet the hard (HangTimeout) deadline;
+	// only ever touched by the watchdog thread itself
+	static const unsigned int MAX_STALL_SAMPLES = 512;
+	static const unsigned int MAX_STALL_DEPTH = 32;
+
+	struct StallSample {
+		void* iparray[MAX_STALL_DEPTH];
+		int depth;
+		int count; // merged duplicates; -1 when folded into an earlier sample
+	};
+
+	static StallSample stallSamples[MAX_STALL_SAMPLES];
+#endif
+
 	static inline void UpdateActiveThreads(Threading::NativeThreadId num) {
 		unsigned int active = WDT_COUNT;
 
@@ -107,6 +133,107 @@ namespace Watchdog
 	}
 
 
+#ifndef WIN32
+	static void LogStallReport(unsigned int threadNum, unsigned int numSamples, float stallSecs)
+	{
+		const unsigned int numStored = std::min(numSamples, MAX_STALL_SAMPLES);
+
+		// merge identical stacks; quadratic, but over at most 512 samples
+		// and only ever run by the watchdog thread after a stall happened
+		for (unsigned int i = 0; i < numStored; ++i) {
+			StallSample& si = stallSamples[i];
+
+			if (si.count < 0)
+				continue;
+
+			si.count = 1;
+
+			for (unsigned int j = i + 1; j < numStored; ++j) {
+				StallSample& sj = stallSamples[j];
+
+				if (sj.count < 0 || sj.depth != si.depth)
+					continue;
+				if (memcmp(si.iparray, sj.iparray, si.depth * sizeof(void*)) != 0)
+					continue;
+
+				si.count += 1;
+				sj.count = -1;
+			}
+		}
+
+		LOG_L(L_WARNING, "[Watchdog] thread [%s] stalled for %.2fs; %u stack samples (Spring %s):",
+				threadNames[threadNum], stallSecs, numSamples, SpringVersion::GetFull().c_str());
+
+		// print the most frequent stacks, symbolizing each distinct one once
+		for (unsigned int numPrinted = 0; numPrinted < 5; ++numPrinted) {
+			StallSample* top = nullptr;
+
+			for (unsigned int i = 0; i < numStored; ++i) {
+				if (stallSamples[i].count > 0 && (top == nullptr || stallSamples[i].count > top->count))
+					top = &stallSamples[i];
+			}
+
+			if (top == nullptr)
+				break;
+
+			LOG_L(L_WARNING, "  %3.0f%% of samples (%d) in:", (top->count * 100.0f) / numStored, top->count);
+
+			char** lines = backtrace_symbols(top->iparray, top->depth);
+
+			for (int d = 0; d < top->depth; ++d) {
+				LOG_L(L_WARNING, "    <%02d> %s", d, (lines != nullptr)? lines[d]: "??");
+			}
+
+			free(lines);
+			top->count = 0;
+		}
+
+		// the span ring holds the TimeProfiler scopes covering the stall
+		// window, dump it so samples can be correlated with scope data
+		profiler.DumpSpanTrace();
+	}
+
+	static void SampleStalledThread(unsigned int threadNum)
+	{
+		WatchDogThreadInfo* threadInfo = registeredThreads[threadNum];
+		Threading::ThreadControls* ctls = threadInfo->ctls.get();
+
+		if (ctls == nullptr || ctls->handle == 0)
+			return;
+
+		// sample until the thread passes a watchdog point again (timer
+		// reset ends the stall) or the hard deadline takes over
+		const spring_time stallStartTime = threadInfo->timer;
+
+		unsigned int numSamples = 0;
+
+		while (!hangDetectorThreadInterrupted) {
+			const spring_time curwdt = threadInfo->timer;
+
+			if (!spring_istime(curwdt) || curwdt.toNanoSecsi() != stallStartTime.toNanoSecsi())
+				break;
+			if ((spring_gettime() - stallStartTime) > hangTimeout)
+				return;
+
+			StallSample& sample = stallSamples[numSamples % MAX_STALL_SAMPLES];
+
+			sample.depth = CrashHandler::SuspendedSampleIPs(ctls, sample.iparray, MAX_STALL_DEPTH);
+			sample.count = 0;
+
+			numSamples += (sample.depth > 0);
+
+			spring::this_thread::sleep_for(std::chrono::milliseconds(2));
+		}
+
+		// too few samples to say anything useful
+		if (numSamples < 5)
+			return;
+
+		LogStallReport(threadNum, numSamples, (spring_gettime() - stallStartTime).toSecsf());
+	}
+#endif
+
+
 	__FORCE_ALIGN_STACK__
 	static void HangDetectorLoop()
 	{
@@ -152,6 +279,30 @@ namespace Watchdog
 				CrashHandler::CleanupStacktrace(LOG_LEVEL_WARNING);
 			}
 
+#ifndef WIN32
+			if (!hangDetected && spring_istime(stallSampleTimeout)) {
+				// soft deadline passed for some thread; burst-sample it
+				// (one stalled thread at a time, main before sim etc. by
+				// slot order) until the stall ends or HangTimeout fires
+				for (unsigned int i = 0; i < WDT_COUNT; ++i) {
+					if (!threadSlots[i].active)
+						continue;
+
+					const spring_time curwdt = registeredThreads[i]->timer;
+
+					if (spring_istime(curwdt) && (curtime - curwdt) > stallSampleTimeout) {
+						SampleStalledThread(i);
+						break;
+					}
+				}
+
+				// poll often enough to catch stalls barely above the
+				// soft deadline before they end
+				spring::this_thread::sleep_for(std::chrono::milliseconds(100));
+				continue;
+			}
+#endif
+
 			spring::this_thread::sleep_for(std::chrono::seconds(1));
 		}
 	}
@@ -357,10 +508,15 @@ namespace Watchdog
 
 		hangTimeout = spring_secs(hangTimeoutSecs);
 
+		const int stallSampleTimeoutSecs = configHandler->GetInt("StallSampleTimeout");
+
+		if (stallSampleTimeoutSecs > 0 && stallSampleTimeoutSecs < hangTimeoutSecs)
+			stallSampleTimeout = spring_secs(stallSampleTimeoutSecs);
+
 		// start the watchdog thread
 		hangDetectorThread = new spring::thread(&HangDetectorLoop);
 
-		LOG("[WatchDog%s] Installed (HangTimeout: %isec)", __FUNCTION__, hangTimeoutSecs);
+		LOG("[WatchDog%s] Installed (HangTimeout: %isec, StallSampleTimeout: %isec)", __FUNCTION__, hangTimeoutSecs, stallSampleTimeoutSecs);
 	}
 
 
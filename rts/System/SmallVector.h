@@ -0,0 +1,176 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef SMALL_VECTOR_H
+#define SMALL_VECTOR_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "System/creg/creg_cond.h"
+
+namespace spring {
+	/**
+	 * Contiguous sequence with a fixed inline capacity; spills to the heap
+	 * only when more than N elements are stored at once. Intended for hot
+	 * bookkeeping paths that usually hold a handful of elements (eg. the
+	 * death-dependence links of CObject) where per-node or per-container
+	 * allocations dominate profiles. Elements must be trivially copyable
+	 * so growth and erasure can move them with plain copies.
+	 */
+	template<typename T, size_t N>
+	class SmallVector {
+		static_assert(std::is_trivially_copyable<T>::value, "element type must be trivially copyable");
+		static_assert(N > 0, "inline capacity must be non-zero");
+
+	public:
+		typedef T value_type;
+		typedef T* iterator;
+		typedef const T* const_iterator;
+
+		SmallVector(): elems(inlineBuf), numElems(0), maxElems(N) {}
+		SmallVector(const SmallVector& v): SmallVector() { *this = v; }
+		SmallVector(SmallVector&& v): SmallVector() { *this = std::move(v); }
+
+		~SmallVector() {
+			if (!IsInlined())
+				delete[] elems;
+		}
+
+		SmallVector& operator = (const SmallVector& v) {
+			if (this == &v)
+				return *this;
+
+			clear();
+			reserve(v.numElems);
+			std::memcpy(elems, v.elems, v.numElems * sizeof(T));
+			numElems = v.numElems;
+			return *this;
+		}
+
+		SmallVector& operator = (SmallVector&& v) {
+			if (this == &v)
+				return *this;
+
+			// only a heap buffer can be stolen, inline
+			// elements are cheap enough to copy instead
+			if (v.IsInlined())
+				return (*this = v);
+
+			if (!IsInlined())
+				delete[] elems;
+
+			elems = v.elems;
+			numElems = v.numElems;
+			maxElems = v.maxElems;
+
+			v.elems = v.inlineBuf;
+			v.numElems = 0;
+			v.maxElems = N;
+			return *this;
+		}
+
+		iterator begin() { return elems; }
+		iterator end() { return (elems + numElems); }
+		const_iterator begin() const { return elems; }
+		const_iterator end() const { return (elems + numElems); }
+
+		T& operator [] (size_t i) { assert(i < numElems); return elems[i]; }
+		const T& operator [] (size_t i) const { assert(i < numElems); return elems[i]; }
+
+		T& front() { assert(numElems > 0); return elems[0]; }
+		T& back() { assert(numElems > 0); return elems[numElems - 1]; }
+		const T& front() const { assert(numElems > 0); return elems[0]; }
+		const T& back() const { assert(numElems > 0); return elems[numElems - 1]; }
+
+		T* data() { return elems; }
+		const T* data() const { return elems; }
+
+		bool empty() const { return (numElems == 0); }
+		size_t size() const { return numElems; }
+		size_t capacity() const { return maxElems; }
+
+		void clear() { numElems = 0; }
+
+		void reserve(size_t n) {
+			if (n <= maxElems)
+				return;
+
+			const size_t newMaxElems = std::max(n, maxElems * 2);
+
+			T* buf = new T[newMaxElems];
+			std::memcpy(buf, elems, numElems * sizeof(T));
+
+			if (!IsInlined())
+				delete[] elems;
+
+			elems = buf;
+			maxElems = newMaxElems;
+		}
+
+		void resize(size_t n) {
+			reserve(n);
+
+			for (size_t i = numElems; i < n; i++) {
+				elems[i] = T();
+			}
+
+			numElems = n;
+		}
+
+		void push_back(const T& e) {
+			reserve(numElems + 1);
+			elems[numElems++] = e;
+		}
+
+		void pop_back() {
+			assert(numElems > 0);
+			numElems--;
+		}
+
+		iterator insert(iterator pos, const T& e) {
+			assert(pos >= begin() && pos <= end());
+			const size_t i = pos - begin();
+
+			reserve(numElems + 1);
+			std::memmove(elems + i + 1, elems + i, (numElems - i) * sizeof(T));
+
+			elems[i] = e;
+			numElems += 1;
+			return (elems + i);
+		}
+
+		iterator erase(iterator pos) {
+			assert(pos >= begin() && pos < end());
+			const size_t i = pos - begin();
+
+			std::memmove(elems + i, elems + i + 1, (numElems - i - 1) * sizeof(T));
+			numElems -= 1;
+			return (elems + i);
+		}
+
+	private:
+		bool IsInlined() const { return (elems == inlineBuf); }
+
+		T* elems;
+		size_t numElems;
+		size_t maxElems;
+		T inlineBuf[N];
+	};
+}
+
+
+#ifdef USING_CREG
+namespace creg {
+	template<typename T, size_t N>
+	struct DeduceType<spring::SmallVector<T, N> > {
+		static std::shared_ptr<IType> Get() {
+			return std::shared_ptr<IType>(new DynamicArrayType<spring::SmallVector<T, N> >(DeduceType<T>::Get()));
+		}
+	};
+}
+#endif
+
+#endif // SMALL_VECTOR_H
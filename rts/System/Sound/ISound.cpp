@@ -31,6 +31,7 @@ CONFIG(int, snd_volbattle).defaultValue(100).minimumValue(0).maximumValue(200).d
 CONFIG(int, snd_volui).defaultValue(100).minimumValue(0).maximumValue(200).description("Volume for \"ui\" sound channel.");
 CONFIG(int, snd_volmusic).defaultValue(100).minimumValue(0).maximumValue(200).description("Volume for \"music\" sound channel.");
 CONFIG(std::string, snd_device).defaultValue("").description("Sets the used output device. See \"Available Devices\" section in infolog.txt.");
+CONFIG(int, snd_pcmCacheMB).defaultValue(64).minimumValue(0).description("Size budget (in MB) of the decoded-audio cache in the writable data directory, 0 disables it.");
 
 CONFIG(float, snd_airAbsorption).defaultValue(0.1f);
 CONFIG(bool, UseEFX).defaultValue(true).safemodeValue(false);
@@ -71,6 +71,10 @@ void AudioChannel::FindSourceAndPlay(size_t id, const float3& pos, const float3&
 	if (volume <= 0.0f)
 		return;
 
+	// no point hearing hours of compressed history while fast-forwarding
+	if (gu->simCatchingUp)
+		return;
+
 	// generate the sound item
 	SoundItem* sndItem = sound->GetSoundItem(id);
 
@@ -97,11 +101,18 @@ void AudioChannel::FindSourceAndPlay(size_t id, const float3& pos, const float3&
 		CSoundSource* src = nullptr;
 
 		int prio = INT_MAX;
+		float audibility = 0.0f;
 
+		// find the least significant source in this channel; lowest
+		// priority and among equals the least audible at the listener
 		for (auto it = curSources.begin(); it != curSources.end(); ++it) {
-			if ((*it)->GetCurrentPriority() < prio) {
+			const int srcPrio = (*it)->GetCurrentPriority();
+			const float srcAudibility = (*it)->GetCurrentAudibility();
+
+			if ((srcPrio < prio) || (srcPrio == prio && srcAudibility < audibility)) {
 				src  = *it;
-				prio = src->GetCurrentPriority();
+				prio = srcPrio;
+				audibility = srcAudibility;
 			}
 		}
 
@@ -128,25 +139,52 @@ void AudioChannel::FindSourceAndPlay(size_t id, const float3& pos, const float3&
 	curSources.insert(sndSource);
 }
 
+spring::mpsc_channel<AudioChannel::PlayRequest, 512> AudioChannel::playRequests;
+
+void AudioChannel::EnqueuePlay(size_t id, const float3& pos, const float3& velocity, float volume, bool relative)
+{
+	PlayRequest req;
+	req.channel = this;
+	req.id = id;
+	req.pos = pos;
+	req.velocity = velocity;
+	req.volume = volume;
+	req.relative = relative;
+
+	// hand off to the audio thread (ProcessPlayRequests) instead of
+	// fighting it for soundMutex here; if the ring is ever full that
+	// many queued sounds would be inaudible anyway, dropping is fine
+	if (!playRequests.push(req))
+		LOG_L(L_DEBUG, "AudioChannel::%s: play-request ring full, dropping sample %d", __func__, (int)id);
+}
+
+void AudioChannel::ProcessPlayRequests()
+{
+	playRequests.drain([](PlayRequest&& req) {
+		req.channel->FindSourceAndPlay(req.id, req.pos, req.velocity, req.volume, req.relative);
+	});
+}
+
+
 void AudioChannel::PlaySample(size_t id, float volume)
 {
-	FindSourceAndPlay(id, -FwdVector, ZeroVector, volume, true);
+	EnqueuePlay(id, -FwdVector, ZeroVector, volume, true);
 }
 
 void AudioChannel::PlaySample(size_t id, const float3& pos, float volume)
 {
-	FindSourceAndPlay(id, pos, ZeroVector, volume, false);
+	EnqueuePlay(id, pos, ZeroVector, volume, false);
 }
 
 void AudioChannel::PlaySample(size_t id, const float3& pos, const float3& velocity, float volume)
 {
-	FindSourceAndPlay(id, pos, velocity, volume, false);
+	EnqueuePlay(id, pos, velocity, volume, false);
 }
 
 
 void AudioChannel::PlaySample(size_t id, const CWorldObject* obj, float volume)
 {
-	FindSourceAndPlay(id, obj->pos, obj->speed, volume, false);
+	EnqueuePlay(id, obj->pos, obj->speed, volume, false);
 }
 
 
@@ -7,6 +7,7 @@
 #include <cstring>
 
 #include "System/Sound/IAudioChannel.h"
+#include "System/Threading/MPSCChannel.hpp"
 #include "System/UnorderedSet.hpp"
 
 struct GuiSoundSet;
@@ -51,12 +52,29 @@ public:
 	float StreamGetTime();
 	float StreamGetPlayTime();
 
+	/// executes all queued play requests; called by the audio thread
+	static void ProcessPlayRequests();
+
 protected:
 	void FindSourceAndPlay(size_t id, const float3& pos, const float3& velocity, float volume, bool relative);
+	void EnqueuePlay(size_t id, const float3& pos, const float3& velocity, float volume, bool relative);
 
 	void SoundSourceFinished(CSoundSource* sndSource);
 
 private:
+	struct PlayRequest {
+		AudioChannel* channel;
+		size_t id;
+		float3 pos;
+		float3 velocity;
+		float volume;
+		bool relative;
+	};
+
+	/// pending play requests for all channels; producers are the gameplay
+	/// threads, the single consumer is the audio thread
+	static spring::mpsc_channel<PlayRequest, 512> playRequests;
+
 	spring::unsynced_set<CSoundSource*> curSources;
 	std::vector<StreamQueueItem> streamQueue;
 
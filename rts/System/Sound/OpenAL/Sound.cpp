@@ -18,6 +18,7 @@
 
 #include "System/Sound/ISoundChannels.h"
 #include "System/Sound/SoundLog.h"
+#include "AudioChannel.h"
 #include "SoundSource.h"
 #include "SoundBuffer.h"
 #include "SoundItem.h"
@@ -45,7 +46,8 @@ spring::recursive_mutex soundMutex;
 
 
 CSound::CSound()
-	: listenerNeedsUpdate(false)
+	: prevListenerPos(-1e9f, -1e9f, -1e9f)
+	, listenerNeedsUpdate(false)
 	, soundThread(nullptr)
 	, soundThreadQuit(false)
 	, canLoadDefs(false)
@@ -160,18 +162,24 @@ CSoundSource* CSound::GetNextBestSource(bool lock)
 		}
 	}
 
-	// check the next best free source
+	// check the next best free source; among equal priorities steal
+	// the least audible one so the N most significant sounds survive
 	CSoundSource* bestSrc = nullptr;
 	int bestPriority = INT_MAX;
+	float bestAudibility = 0.0f;
 
 	for (CSoundSource& src: soundSources) {
 		#if 0
 		if (!src.IsPlaying(true))
 			return &src;
 		#endif
-		if (src.GetCurrentPriority() <= bestPriority) {
+		const int srcPriority = src.GetCurrentPriority();
+		const float srcAudibility = src.GetCurrentAudibility();
+
+		if ((srcPriority < bestPriority) || (srcPriority == bestPriority && srcAudibility <= bestAudibility)) {
 			bestSrc = &src;
-			bestPriority = src.GetCurrentPriority();
+			bestPriority = srcPriority;
+			bestAudibility = srcAudibility;
 		}
 	}
 
@@ -429,8 +437,17 @@ void CSound::Update()
 {
 	std::lock_guard<spring::recursive_mutex> lck(soundMutex); // lock
 
-	for (CSoundSource& source: soundSources)
+	// batch-execute play requests queued by the gameplay threads
+	AudioChannel::ProcessPlayRequests();
+
+	for (CSoundSource& source: soundSources) {
+		// in big battles most of the pool cycles through one-shots;
+		// idle sources have no state worth ticking at 30Hz
+		if (!source.IsPlaying(false))
+			continue;
+
 		source.Update();
+	}
 
 	CheckError("CSound::Update");
 	UpdateListenerReal();
@@ -474,16 +491,23 @@ void CSound::UpdateListenerReal()
 	// not 100% threadsafe, but worst case we would skip a single listener update (and it runs at multiple Hz!)
 	listenerNeedsUpdate = false;
 
-	const float3 myPosInMeters = myPos * ELMOS_TO_METERS;
-	alListener3f(AL_POSITION, myPosInMeters.x, myPosInMeters.y, myPosInMeters.z);
+	// only push listener state whose inputs moved beyond an epsilon;
+	// sub-elmo camera jitter cannot audibly change any attenuation but
+	// would otherwise touch AL (and every source's rolloff) per update
+	if (myPos.SqDistance(prevListenerPos) > Square(0.5f)) {
+		prevListenerPos = myPos;
 
-	// reduce the rolloff when the camera is high above the ground (so we still hear something in tab mode or far zoom)
-	// for altitudes up to and including 600 elmos, the rolloff is always clamped to 1
-	const float camHeight = std::max(1.0f, myPos.y - CGround::GetHeightAboveWater(myPos.x, myPos.z));
-	const float newMod = std::min(600.0f / camHeight, 1.0f);
+		const float3 myPosInMeters = myPos * ELMOS_TO_METERS;
+		alListener3f(AL_POSITION, myPosInMeters.x, myPosInMeters.y, myPosInMeters.z);
 
-	CSoundSource::SetHeightRolloffModifer(newMod);
-	efx->SetHeightRolloffModifer(newMod);
+		// reduce the rolloff when the camera is high above the ground (so we still hear something in tab mode or far zoom)
+		// for altitudes up to and including 600 elmos, the rolloff is always clamped to 1
+		const float camHeight = std::max(1.0f, myPos.y - CGround::GetHeightAboveWater(myPos.x, myPos.z));
+		const float newMod = std::min(600.0f / camHeight, 1.0f);
+
+		CSoundSource::SetHeightRolloffModifer(newMod);
+		efx->SetHeightRolloffModifer(newMod);
+	}
 
 	// Result were bad with listener related doppler effects.
 	// The user experiences the camera/listener not as a world-interacting object.
@@ -502,8 +526,14 @@ void CSound::UpdateListenerReal()
 	alListener3f(AL_VELOCITY, velocityAvg.x, velocityAvg.y, velocityAvg.z);
 	*/
 
-	ALfloat ListenerOri[] = {camDir.x, camDir.y, camDir.z, camUp.x, camUp.y, camUp.z};
-	alListenerfv(AL_ORIENTATION, ListenerOri);
+	if ((camDir.dot(prevCamDir) < 0.999999f) || (camUp.dot(prevCamUp) < 0.999999f)) {
+		prevCamDir = camDir;
+		prevCamUp = camUp;
+
+		ALfloat ListenerOri[] = {camDir.x, camDir.y, camDir.z, camUp.x, camUp.y, camUp.z};
+		alListenerfv(AL_ORIENTATION, ListenerOri);
+	}
+
 	CheckError("CSound::UpdateListener");
 }
 
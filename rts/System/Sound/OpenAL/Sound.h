@@ -85,6 +85,12 @@ private:
 	float3 camDir;
 	float3 camUp;
 	float3 prevVelocity;
+
+	/// last values actually pushed to AL; epsilon-gate the listener updates
+	float3 prevListenerPos;
+	float3 prevCamDir;
+	float3 prevCamUp;
+
 	bool listenerNeedsUpdate;
 
 	SoundItemNameMap defaultItemNameMap;
@@ -6,12 +6,20 @@
 #include "System/Sound/SoundLog.h"
 #include "ALShared.h"
 #include "VorbisShared.h"
+#include "System/CRC.h"
+#include "System/StringUtil.h"
+#include "System/Config/ConfigHandler.h"
+#include "System/FileSystem/DataDirsAccess.h"
+#include "System/FileSystem/FileQueryFlags.h"
+#include "System/FileSystem/FileSystem.h"
+#include "System/FileSystem/FileSystemAbstraction.h"
 #include "System/Platform/byteorder.h"
 
 #include <vorbis/vorbisfile.h>
 #include <ogg/ogg.h>
 #include <algorithm>
 #include <cassert>
+#include <cstdio>
 #include <cstring>
 
 namespace
@@ -41,6 +49,30 @@ int	VorbisClose(void* datasource)
 SoundBuffer::bufferMapT SoundBuffer::bufferMap; // filename, index into Buffers
 SoundBuffer::bufferVecT SoundBuffer::buffers;
 
+size_t SoundBuffer::pcmCacheBudget = 0;
+size_t SoundBuffer::pcmCacheUsed = 0;
+
+
+#pragma pack(push, 1)
+// flat layout of a cached decode: header followed by the raw PCM data
+struct PCMCacheFileHeader
+{
+	std::uint32_t magic;
+	std::uint32_t srcCRC;    // CRC of the compressed source bytes
+	std::uint32_t format;    // AL_FORMAT_*
+	std::uint32_t rate;
+	std::uint32_t channels;
+	std::uint32_t dataLen;
+	float length;
+};
+#pragma pack(pop)
+
+static const std::uint32_t PCMCACHE_MAGIC = 0x4D435053; // "SPCM"
+
+static const std::string GetPCMCacheDir() {
+	return (FileSystem::GetCacheDir() + "/sounds/");
+}
+
 SoundBuffer::SoundBuffer() : id(0), channels(0), length(0.0f)
 {
 }
@@ -152,6 +184,14 @@ bool SoundBuffer::LoadWAV(const std::string& file, std::vector<std::uint8_t> buf
 
 bool SoundBuffer::LoadVorbis(const std::string& file, std::vector<std::uint8_t> buffer)
 {
+	// decoding is by far the most expensive part of loading a sound,
+	// warm starts pull the PCM straight from the on-disk cache (keyed
+	// by source checksum, so patched archives simply miss)
+	const std::uint32_t srcCRC = CRC::GetCRC(&buffer[0], buffer.size());
+
+	if (LoadCachedPCM(file, srcCRC))
+		return true;
+
 	VorbisInputBuffer buf;
 	buf.data = &buffer[0];
 	buf.pos = 0;
@@ -222,9 +262,97 @@ bool SoundBuffer::LoadVorbis(const std::string& file, std::vector<std::uint8_t>
 	filename = file;
 	channels = vorbisInfo->channels;
 	length   = ov_time_total(&oggStream, -1);
+
+	WriteCachedPCM(srcCRC, format, vorbisInfo->rate, &decodeBuffer[0], pos);
 	return true;
 }
 
+
+bool SoundBuffer::LoadCachedPCM(const std::string& file, std::uint32_t srcCRC)
+{
+	if (pcmCacheBudget == 0)
+		return false;
+
+	const std::string cacheFileName = GetPCMCacheDir() + IntToString(srcCRC, "%x") + ".pcm";
+
+	if (!FileSystem::FileExists(cacheFileName))
+		return false;
+
+	FILE* cacheFile = fopen(dataDirsAccess.LocateFile(cacheFileName).c_str(), "rb");
+
+	if (cacheFile == nullptr)
+		return false;
+
+	PCMCacheFileHeader fileHeader;
+	std::vector<std::uint8_t> pcmData;
+
+	bool valid = (fread(&fileHeader, sizeof(fileHeader), 1, cacheFile) == 1);
+
+	valid &= (fileHeader.magic == PCMCACHE_MAGIC);
+	valid &= (fileHeader.srcCRC == srcCRC);
+	valid &= (fileHeader.channels >= 1 && fileHeader.channels <= 2);
+	valid &= (fileHeader.dataLen > 0);
+
+	if (valid) {
+		pcmData.resize(fileHeader.dataLen);
+		valid = (fread(&pcmData[0], 1, pcmData.size(), cacheFile) == pcmData.size());
+	}
+
+	fclose(cacheFile);
+
+	if (!valid) {
+		// stale or truncated entry; redecode and let it be rewritten
+		FileSystem::Remove(cacheFileName);
+		return false;
+	}
+
+	if (!AlGenBuffer(file, fileHeader.format, &pcmData[0], pcmData.size(), fileHeader.rate))
+		return false;
+
+	filename = file;
+	channels = fileHeader.channels;
+	length   = fileHeader.length;
+	return true;
+}
+
+
+void SoundBuffer::WriteCachedPCM(std::uint32_t srcCRC, ALenum format, int rate, const std::uint8_t* data, size_t dataLen)
+{
+	if (pcmCacheBudget == 0)
+		return;
+
+	// keep the cache bounded; entries past the budget are simply not
+	// persisted (old files get pruned again at the next Initialise)
+	if ((pcmCacheUsed + sizeof(PCMCacheFileHeader) + dataLen) > pcmCacheBudget)
+		return;
+
+	// we need this directory to exist
+	if (!FileSystem::CreateDirectory(GetPCMCacheDir()))
+		return;
+
+	const std::string cacheFileName = GetPCMCacheDir() + IntToString(srcCRC, "%x") + ".pcm";
+
+	FILE* cacheFile = fopen(dataDirsAccess.LocateFile(cacheFileName, FileQueryFlags::WRITE).c_str(), "wb");
+
+	if (cacheFile == nullptr)
+		return;
+
+	PCMCacheFileHeader fileHeader;
+	fileHeader.magic    = PCMCACHE_MAGIC;
+	fileHeader.srcCRC   = srcCRC;
+	fileHeader.format   = format;
+	fileHeader.rate     = rate;
+	fileHeader.channels = channels;
+	fileHeader.dataLen  = dataLen;
+	fileHeader.length   = length;
+
+	fwrite(&fileHeader, sizeof(fileHeader), 1, cacheFile);
+	fwrite(data, 1, dataLen, cacheFile);
+	fclose(cacheFile);
+
+	pcmCacheUsed += (sizeof(fileHeader) + dataLen);
+}
+
 int SoundBuffer::BufferSize() const
 {
 	ALint size;
@@ -235,6 +363,27 @@ int SoundBuffer::BufferSize() const
 void SoundBuffer::Initialise()
 {
 	buffers.resize(1); // empty ("zero") buffer
+
+	pcmCacheBudget = configHandler->GetInt("snd_pcmCacheMB") * size_t(1024 * 1024);
+	pcmCacheUsed = 0;
+
+	if (pcmCacheBudget == 0)
+		return;
+
+	// prune the on-disk cache back under budget, oldest entries first
+	std::vector<std::string> cacheFiles = dataDirsAccess.FindFiles(GetPCMCacheDir(), "*.pcm");
+
+	std::sort(cacheFiles.begin(), cacheFiles.end(), [](const std::string& a, const std::string& b) {
+		return (FileSystemAbstraction::GetFileModificationTime(a) < FileSystemAbstraction::GetFileModificationTime(b));
+	});
+
+	for (const std::string& cacheFile: cacheFiles)
+		pcmCacheUsed += FileSystem::GetFileSize(cacheFile);
+
+	for (size_t n = 0; n < cacheFiles.size() && pcmCacheUsed > pcmCacheBudget; n++) {
+		pcmCacheUsed -= FileSystem::GetFileSize(cacheFiles[n]);
+		FileSystem::Remove(cacheFiles[n]);
+	}
 }
 
 void SoundBuffer::Deinitialise()
@@ -66,6 +66,9 @@ public:
 private:
 	bool AlGenBuffer(const std::string& file, ALenum format, const std::uint8_t* data, size_t datalength, int rate);
 
+	bool LoadCachedPCM(const std::string& file, std::uint32_t srcCRC);
+	void WriteCachedPCM(std::uint32_t srcCRC, ALenum format, int rate, const std::uint8_t* data, size_t dataLen);
+
 	std::string filename;
 	ALuint id;
 	ALuint channels;
@@ -76,6 +79,10 @@ private:
 
 	static bufferMapT bufferMap; // filename, index into Buffers
 	static bufferVecT buffers;
+
+	/// size budget of the on-disk decoded-PCM cache, 0 disables it
+	static size_t pcmCacheBudget;
+	static size_t pcmCacheUsed;
 };
 
 
@@ -2,6 +2,7 @@
 
 #include "SoundSource.h"
 
+#include <algorithm>
 #include <climits>
 #include <alc.h>
 
@@ -29,7 +30,9 @@ CSoundSource::CSoundSource()
 	: curPlaying(nullptr)
 	, curChannel(nullptr)
 	, curVolume(1.f)
+	, curAudibility(0.f)
 	, loopStop(1e9)
+	, playEnd(0)
 	, in3D(false)
 	, efxEnabled(false)
 	, efxUpdates(0)
@@ -73,12 +76,17 @@ void CSoundSource::Update()
 			efxUpdates = efx->updates;
 		}
 
-		if (heightRolloffModifier != curHeightRolloffModifier) {
+		// epsilon-gated so slow camera-height drift does not rewrite
+		// AL_ROLLOFF_FACTOR on every playing source each tick
+		if (math::fabs(heightRolloffModifier - curHeightRolloffModifier) > 0.01f) {
 			curHeightRolloffModifier = heightRolloffModifier;
 			alSourcef(id, AL_ROLLOFF_FACTOR, ROLLOFF_FACTOR * curPlaying->rolloff * heightRolloffModifier);
 		}
 
-		if (!IsPlaying(true) || ((curPlaying->loopTime > 0) && (spring_gettime() > loopStop)))
+		// a finite one-shot is known to still play until <playEnd>, so
+		// only ask OpenAL for AL_SOURCE_STATE (a round-trip per source
+		// per tick) once the timestamp says it should be over
+		if (!IsPlaying(spring_gettime() >= playEnd) || ((curPlaying->loopTime > 0) && (spring_gettime() > loopStop)))
 			Stop();
 	}
 
@@ -99,6 +107,22 @@ void CSoundSource::Update()
 	}
 }
 
+//! estimated gain at the listener under the inverse-distance-clamped model;
+//! only used to rank sources for stealing, playback attenuation is AL-side
+float CSoundSource::EstimateAudibility(const SoundItem* item, float itemGain, const IAudioChannel* channel, const float3& pos, float volume, bool relative) const
+{
+	const float gain = volume * itemGain * channel->volume;
+
+	if (relative || !item->in3D)
+		return gain;
+
+	const float refDist = referenceDistance * ELMOS_TO_METERS;
+	const float srcDist = std::max(pos.distance(sound->GetListenerPos()) * ELMOS_TO_METERS, refDist);
+	const float rolloff = ROLLOFF_FACTOR * item->rolloff * heightRolloffModifier;
+
+	return (gain * (refDist / (refDist + rolloff * (srcDist - refDist))));
+}
+
 int CSoundSource::GetCurrentPriority() const
 {
 	if (asyncPlay.buffer != nullptr)
@@ -139,6 +163,8 @@ bool CSoundSource::IsPlaying(const bool checkOpenAl) const
 void CSoundSource::Stop()
 {
 	alSourceStop(id);
+	curAudibility = 0.0f;
+
 	if (curPlaying != nullptr) {
 		curPlaying->StopPlay();
 		curPlaying = nullptr;
@@ -167,13 +193,29 @@ void CSoundSource::Play(IAudioChannel* channel, SoundItem* item, float3 pos, flo
 	curVolume = volume;
 	curPlaying = item;
 	curChannel = channel;
+
+	// capture these once, gain and pitch are randomly modulated per query
+	const float itemGain = item->GetGain();
+	const float curPitch = item->GetPitch() * globalPitch;
+
+	curAudibility = EstimateAudibility(item, itemGain, channel, pos, volume, relative);
+
 	alSourcei(id, AL_BUFFER, item->buffer->GetId());
-	alSourcef(id, AL_GAIN, volume * item->GetGain() * channel->volume);
-	alSourcef(id, AL_PITCH, item->GetPitch() * globalPitch);
+	alSourcef(id, AL_GAIN, volume * itemGain * channel->volume);
+	alSourcef(id, AL_PITCH, curPitch);
 	velocity *= item->dopplerScale * ELMOS_TO_METERS;
 	alSource3f(id, AL_VELOCITY, velocity.x, velocity.y, velocity.z);
 	alSourcei(id, AL_LOOPING, (item->loopTime > 0) ? AL_TRUE : AL_FALSE);
 	loopStop = spring_gettime() + spring_msecs(item->loopTime);
+
+	// finite one-shots tick by timestamp alone until this expires; loops
+	// keep the zero sentinel so Update always polls AL for their state
+	if (item->loopTime == 0) {
+		playEnd = spring_gettime() + spring_secs(item->buffer->GetLength() / std::max(curPitch, 0.01f));
+	} else {
+		playEnd = spring_time(0);
+	}
+
 	if (relative || !item->in3D) {
 		in3D = false;
 		if (efxEnabled) {
@@ -209,7 +251,7 @@ void CSoundSource::Play(IAudioChannel* channel, SoundItem* item, float3 pos, flo
 #ifdef __APPLE__
 		alSourcef(id, AL_MAX_DISTANCE, 1000000.0f);
 		//! Max distance is too small by default on my Mac...
-		ALfloat gain = channel->volume * item->GetGain() * volume;
+		ALfloat gain = channel->volume * itemGain * volume;
 		if (gain > 1.0f) {
 			//! OpenAL on Mac cannot handle AL_GAIN > 1 well, so we will adjust settings to get the same output with AL_GAIN = 1.
 			ALint model = alGetInteger(AL_DISTANCE_MODEL);
@@ -242,6 +284,9 @@ void CSoundSource::PlayAsync(IAudioChannel* channel, SoundItem* buffer, float3 p
 	asyncPlay.velocity = velocity;
 	asyncPlay.volume   = volume;
 	asyncPlay.relative = relative;
+
+	// so the eviction scans can rank this source before Play() runs
+	curAudibility = EstimateAudibility(buffer, buffer->GetGain(), channel, pos, volume, relative);
 }
 
 
@@ -256,6 +301,7 @@ void CSoundSource::PlayStream(IAudioChannel* channel, const std::string& file, f
 	//! setup OpenAL params
 	curChannel = channel;
 	curVolume = volume;
+	curAudibility = volume * channel->volume;
 	in3D = false;
 	if (efxEnabled) {
 		alSource3i(id, AL_AUXILIARY_SEND_FILTER, AL_EFFECTSLOT_NULL, 0, AL_FILTER_NULL);
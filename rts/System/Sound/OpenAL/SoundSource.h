@@ -40,6 +40,8 @@ public:
 	bool IsValid() const { return (id != 0); };
 
 	int GetCurrentPriority() const;
+	/// estimated gain at the listener; ranks equal-priority sources for stealing
+	float GetCurrentAudibility() const { return (IsPlaying(false) ? curAudibility : 0.0f); }
 	bool IsPlaying(const bool checkOpenAl = false) const;
 	void Stop();
 
@@ -74,6 +76,9 @@ private:
 		{}
 	};
 
+private:
+	float EstimateAudibility(const SoundItem* item, float itemGain, const IAudioChannel* channel, const float3& pos, float volume, bool relative) const;
+
 private:
 	static float referenceDistance;
 
@@ -91,7 +96,10 @@ private:
 	COggStream curStream;
 
 	float curVolume;
+	float curAudibility;
 	spring_time loopStop;
+	//! expected end of a finite one-shot; until then Update ticks the source by timestamp alone
+	spring_time playEnd;
 	bool in3D;
 	bool efxEnabled;
 	int efxUpdates;
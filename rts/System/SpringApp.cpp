@@ -2,6 +2,8 @@
 
 #include "System/Input/InputHandler.h"
 
+#include <atomic>
+#include <cstring>
 #include <functional>
 #include <iostream>
 
@@ -44,6 +46,7 @@
 #include "Rendering/GlobalRendering.h"
 #include "Rendering/Fonts/glFont.h"
 #include "Rendering/GL/FBO.h"
+#include "Rendering/GL/StreamBuffer.h"
 #include "Rendering/Textures/Bitmap.h"
 #include "Rendering/Textures/NamedTextures.h"
 #include "Rendering/Textures/TextureAtlas.h"
@@ -92,6 +95,7 @@
 
 CONFIG(unsigned, SetCoreAffinity).defaultValue(0).safemodeValue(1).description("Defines a bitmask indicating which CPU cores the main-thread should use.");
 CONFIG(unsigned, SetCoreAffinitySim).defaultValue(0).safemodeValue(1).description("Defines a bitmask indicating which CPU cores the sim-thread should use.");
+CONFIG(int, ThreadPinPolicy).defaultValue(0).minimumValue(0).maximumValue(2).description("Topology-aware thread placement: 0 none, 1 one physical core per thread (SMT siblings only on overflow), 2 additionally isolates the main/sim core from ThreadPool workers. Overrides SetCoreAffinity when non-zero.");
 CONFIG(bool, UseLuaMemPools).defaultValue(__archBits__ == 64).description("Whether Lua VM memory allocations are made from pools.");
 CONFIG(bool, UseHighResTimer).defaultValue(false).description("On Windows, sets whether Spring will use low- or high-resolution timer functions for tasks like graphical interpolation between game frames.");
 CONFIG(int, PathingThreadCount).defaultValue(0).safemodeValue(1).minimumValue(0);
@@ -119,7 +123,7 @@ DEFINE_bool     (hidden,                                   false, "Start in back
 DEFINE_bool     (nocolor,                                  false, "Disables colorized stdout");
 DEFINE_string   (server,                                   "",    "Set listening IP for server");
 DEFINE_bool     (textureatlas,                             false, "Dump each finalized textureatlas in textureatlasN.tga");
-DEFINE_int32    (benchmark,                                -1,    "Enable benchmark mode (writes a benchmark.data file). The given number specifies the timespan to test.");
+DEFINE_int32    (benchmark,                                -1,    "Enable benchmark mode (writes benchmark.data and a machine-readable benchmark.json). The given number specifies the timespan to test.");
 DEFINE_int32    (benchmarkstart,                           -1,    "Benchmark start time in minutes.");
 
 DEFINE_bool_EX  (list_ai_interfaces, "list-ai-interfaces", false, "Dump a list of available AI Interfaces to stdout");
@@ -223,6 +227,115 @@ static void ShowSplashScreen(const std::string& splashScreenFile)
 
 
 
+/**
+ * One stage of the startup dependency graph. Stages pinned to the main
+ * thread (SDL, GL) are executed inline by RunInitStages as soon as their
+ * dependencies have finished, all others are handed to the ThreadPool.
+ * Per-stage wall time is recorded into TimeProfiler, so regressions in
+ * cold-start time show up in profile dumps.
+ */
+struct InitStage {
+	const char* name;
+	bool mainThread;
+	std::vector<const char*> deps;
+	std::function<bool()> func;
+};
+
+static bool RunInitStages(std::vector<InitStage>& stages)
+{
+	enum { STAGE_PENDING = 0, STAGE_RUNNING = 1, STAGE_DONE = 2 };
+
+	std::vector< std::atomic<int> > stageStates(stages.size());
+	std::atomic<bool> anyFailed(false);
+
+	const auto stageIndex = [&stages](const char* name) -> size_t {
+		for (size_t i = 0; i < stages.size(); i++) {
+			if (strcmp(stages[i].name, name) == 0)
+				return i;
+		}
+
+		assert(false);
+		return 0;
+	};
+	const auto depsDone = [&](const InitStage& stage) {
+		for (const char* dep: stage.deps) {
+			if (stageStates[ stageIndex(dep) ].load() != STAGE_DONE)
+				return false;
+		}
+
+		return true;
+	};
+	const auto runStage = [&anyFailed](InitStage& stage, std::atomic<int>& state) {
+		const spring_time startTime = spring_now();
+
+		if (!stage.func())
+			anyFailed.store(true);
+
+		const spring_time deltaTime = spring_now() - startTime;
+
+		profiler.AddTime(std::string("Misc::InitStage::") + stage.name, startTime, deltaTime);
+		LOG("[SpringApp::Init] stage \"%s\" finished in %.0fms", stage.name, deltaTime.toMilliSecsf());
+
+		state.store(STAGE_DONE);
+	};
+
+	while (true) {
+		bool progressed = false;
+
+		// hand all dependency-ready pool stages to their workers before
+		// touching any main-thread stage, so they actually overlap with
+		// the (serial) window/GL/font work instead of queueing behind it
+		for (size_t i = 0; i < stages.size() && !anyFailed.load(); i++) {
+			if (stages[i].mainThread)
+				continue;
+			if (stageStates[i].load() != STAGE_PENDING || !depsDone(stages[i]))
+				continue;
+
+			stageStates[i].store(STAGE_RUNNING);
+			progressed = true;
+
+			ThreadPool::Enqueue([&stages, &stageStates, &runStage, i]() {
+				runStage(stages[i], stageStates[i]);
+			});
+		}
+
+		// run at most one main-thread stage per pass; its completion can
+		// unblock pool stages, which the next pass then launches first
+		for (size_t i = 0; i < stages.size() && !anyFailed.load(); i++) {
+			if (!stages[i].mainThread)
+				continue;
+			if (stageStates[i].load() != STAGE_PENDING || !depsDone(stages[i]))
+				continue;
+
+			stageStates[i].store(STAGE_RUNNING);
+			progressed = true;
+
+			runStage(stages[i], stageStates[i]);
+			break;
+		}
+
+		size_t numDone = 0;
+		size_t numRunning = 0;
+
+		for (size_t i = 0; i < stages.size(); i++) {
+			numDone += (stageStates[i].load() == STAGE_DONE);
+			numRunning += (stageStates[i].load() == STAGE_RUNNING);
+		}
+
+		// on failure only drain stages already in flight, they
+		// reference local state and must not outlive this frame
+		if (numDone == stages.size() || (anyFailed.load() && numRunning == 0))
+			break;
+
+		if (!progressed)
+			spring_sleep(spring_msecs(1));
+	}
+
+	return (!anyFailed.load());
+}
+
+
+
 /**
  * Initializes SpringApp variables
  *
@@ -289,28 +402,83 @@ bool SpringApp::Init()
 	Watchdog::Install();
 	Watchdog::RegisterThread(WDT_MAIN, true);
 
-	// Create Window
-	if (!InitWindow(("Spring " + SpringVersion::GetSync()).c_str())) {
-		SDL_Quit();
-		return false;
-	}
+	// ArchiveScanner uses for_mt, so must set a thread-count
+	// (employ all available threads, then switch to default)
+	ThreadPool::SetMaximumThreadCount();
+
+	#ifndef HEADLESS
+	// look up splash screens before the filesystem stage touches the
+	// data-dirs (at this point neither the platform CWD nor data-dirs
+	// have been set yet by FSI, can only use absolute paths)
+	const std::string cwd = std::move(FileSystem::EnsurePathSepAtEnd(FileSystemAbstraction::GetCwd()));
+	const std::string ssd = std::move(FileSystem::EnsurePathSepAtEnd(configHandler->GetString("SplashScreenDir")));
+
+	std::vector<std::string> splashScreenFiles(dataDirsAccess.FindFiles(FileSystem::IsAbsolutePath(ssd)? ssd: cwd + ssd, "*.png", 0));
+	#endif
+
+	// startup dependency graph; window, GL-state and font stages are
+	// pinned to the main thread while archive scanning and the sound
+	// device run concurrently with them on the pool
+	std::vector<InitStage> initStages;
+
+	initStages.push_back({"window", true, {}, [&]() {
+		if (!InitWindow(("Spring " + SpringVersion::GetSync()).c_str())) {
+			SDL_Quit();
+			return false;
+		}
 
-	// Init OpenGL
-	globalRendering->PostInit();
-	globalRendering->UpdateGLConfigs();
-	globalRendering->UpdateGLGeometry();
-	globalRendering->InitGLState();
-	CCamera::InitializeStatic();
-	UpdateInterfaceGeometry();
-	LoadFonts();
-	ClearScreen();
-
-	if (!InitFileSystem())
+		return true;
+	}});
+	initStages.push_back({"opengl-state", true, {"window"}, [&]() {
+		globalRendering->PostInit();
+		globalRendering->UpdateGLConfigs();
+		globalRendering->UpdateGLGeometry();
+		globalRendering->InitGLState();
+		CCamera::InitializeStatic();
+		UpdateInterfaceGeometry();
+		return true;
+	}});
+	initStages.push_back({"fonts", true, {"opengl-state"}, [&]() {
+		LoadFonts();
+		ClearScreen();
+		return true;
+	}});
+	initStages.push_back({"filesystem", false, {}, [&]() {
+		bool ret = false;
+		FileSystemInitializer::InitializeThr(&ret);
+		return ret;
+	}});
+	initStages.push_back({"sound", false, {}, [&]() {
+		// spends most of its time waiting on the device thread
+		ISound::Initialize();
+		return true;
+	}});
+	#ifndef HEADLESS
+	initStages.push_back({"splash", true, {"fonts"}, [&]() {
+		// renders until the filesystem stage flags completion,
+		// s.t. the window gets CPU time during the archive scan
+		if (!splashScreenFiles.empty()) {
+			ShowSplashScreen(splashScreenFiles[ guRNG.NextInt(splashScreenFiles.size()) ]);
+		} else {
+			ShowSplashScreen("");
+		}
+
+		return true;
+	}});
+	#endif
+
+	if (!RunInitStages(initStages))
 		return false;
 
+	ThreadPool::SetDefaultThreadCount();
+	// see InputHandler::PushEvents
+	streflop::streflop_init<streflop::Simple>();
+
 	// Multithreading & Affinity
 	Threading::SetThreadName("spring-main"); // set default threadname for pstree
 	Threading::SetThreadScheduler();
+	Threading::SetPinPolicy(configHandler->GetInt("ThreadPinPolicy"));
+	Threading::ApplyPinPolicy(Threading::PIN_ROLE_MAIN);
 
 	mouseInput = IMouseInput::GetInstance();
 	input.AddHandler(std::bind(&SpringApp::MainEventHandler, this, std::placeholders::_1));
@@ -325,7 +493,6 @@ bool SpringApp::Init()
 
 	CNamedTextures::Init();
 	LuaOpenGL::Init();
-	ISound::Initialize();
 	InitJoystick();
 
 	// Lua socket restrictions
@@ -367,42 +534,6 @@ bool SpringApp::InitPlatformLibs()
 	return true;
 }
 
-bool SpringApp::InitFileSystem()
-{
-	bool ret = false;
-
-	// ArchiveScanner uses for_mt, so must set a thread-count
-	// (employ all available threads, then switch to default)
-	ThreadPool::SetMaximumThreadCount();
-
-	#ifndef HEADLESS
-	// threaded initialization s.t. the window gets CPU time
-	// FileSystem is mostly self-contained, don't need locks
-	// (at this point neither the platform CWD nor data-dirs
-	// have been set yet by FSI, can only use absolute paths)
-	const std::string cwd = std::move(FileSystem::EnsurePathSepAtEnd(FileSystemAbstraction::GetCwd()));
-	const std::string ssd = std::move(FileSystem::EnsurePathSepAtEnd(configHandler->GetString("SplashScreenDir")));
-
-	std::vector<std::string> splashScreenFiles(dataDirsAccess.FindFiles(FileSystem::IsAbsolutePath(ssd)? ssd: cwd + ssd, "*.png", 0));
-	spring::thread fsInitThread(FileSystemInitializer::InitializeThr, &ret);
-
-	if (!splashScreenFiles.empty()) {
-		ShowSplashScreen(splashScreenFiles[ guRNG.NextInt(splashScreenFiles.size()) ]);
-	} else {
-		ShowSplashScreen("");
-	}
-
-	fsInitThread.join();
-	#else
-	FileSystemInitializer::InitializeThr(&ret);
-	#endif
-
-	ThreadPool::SetDefaultThreadCount();
-	// see InputHandler::PushEvents
-	streflop::streflop_init<streflop::Simple>();
-	return ret;
-}
-
 /**
  * @return whether window initialization succeeded
  * @param title char* string with window title
@@ -954,6 +1085,7 @@ void SpringApp::Kill(bool fromRun)
 
 	LOG("[SpringApp::%s][5]", __func__);
 	CNamedTextures::Kill(true);
+	CStreamBuffer::Kill();
 	GlobalConfig::Deallocate();
 
 	FreeJoystick();
@@ -4,6 +4,8 @@
 #define _SPRING_HASH_H_
 
 #include "Sync/HsiehHash.h"
+#include <cstring>
+#include <functional>
 #include <string>
 
 namespace spring {
@@ -56,6 +58,33 @@ namespace spring {
 		{
 			return HsiehHash(&s.data()[0], s.size(), 0);
 		}
+		// heterogeneous overload; lets string-keyed maps be probed with
+		// c-string literals without constructing a temporary std::string
+		std::uint32_t operator()(const char* s) const
+		{
+			return HsiehHash(s, std::strlen(s), 0);
+		}
+	};
+
+
+	// non-determinism-safe variant for unsynced containers; forwards to
+	// std::hash except for strings, which reuse HsiehHash so c-string
+	// probing hashes identically to the std::string overload
+	template<typename T>
+	struct unsynced_hash: public std::hash<T> {
+	};
+
+	template<>
+	struct unsynced_hash<std::string> {
+	public:
+		std::uint32_t operator()(const std::string& s) const
+		{
+			return HsiehHash(&s.data()[0], s.size(), 0);
+		}
+		std::uint32_t operator()(const char* s) const
+		{
+			return HsiehHash(s, std::strlen(s), 0);
+		}
 	};
 }
 
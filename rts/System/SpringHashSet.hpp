@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdlib> // malloc
 #include <iterator>
 #include <utility>
@@ -24,6 +25,14 @@ struct HashSetEqualTo
 	{
 		return lhs == rhs;
 	}
+
+	// heterogeneous comparison (eg. std::string keys against c-strings),
+	// avoids constructing a temporary T on the right-hand side
+	template<typename U>
+	constexpr bool operator()(const T &lhs, const U &rhs) const
+	{
+		return lhs == rhs;
+	}
 };
 
 // A cache-friendly hash set with open addressing, linear probing and power-of-two capacity
@@ -317,6 +326,43 @@ public:
 		return find_filled_bucket(k) != (size_t)-1 ? 1 : 0;
 	}
 
+	// ------------------------------------------------------------
+	// heterogeneous lookups; probe with any key type the hasher and
+	// comparator accept (eg. c-strings against std::string keys, see
+	// spring::synced_hash<std::string>) without constructing a KeyT
+
+	template<typename KeyLike>
+	iterator find(const KeyLike& key)
+	{
+		auto bucket = this->find_filled_bucket(key);
+		if (bucket == (size_t)-1) {
+			return this->end();
+		}
+		return iterator(this, bucket);
+	}
+
+	template<typename KeyLike>
+	const_iterator find(const KeyLike& key) const
+	{
+		auto bucket = this->find_filled_bucket(key);
+		if (bucket == (size_t)-1) {
+			return this->end();
+		}
+		return const_iterator(this, bucket);
+	}
+
+	template<typename KeyLike>
+	bool contains(const KeyLike& k) const
+	{
+		return find_filled_bucket(k) != (size_t)-1;
+	}
+
+	template<typename KeyLike>
+	size_t count(const KeyLike& k) const
+	{
+		return find_filled_bucket(k) != (size_t)-1 ? 1 : 0;
+	}
+
 	// -----------------------------------------------------
 
 	// Insert an element, unless it already exists.
@@ -391,9 +437,7 @@ public:
 	{
 		auto bucket = find_filled_bucket(key);
 		if (bucket != (size_t)-1) {
-			_states[bucket] = State::ACTIVE;
-			_keys[bucket].~KeyT();
-			_num_filled -= 1;
+			erase_bucket(bucket);
 			return true;
 		} else {
 			return false;
@@ -406,9 +450,12 @@ public:
 	{
 		DCHECK_EQ_F(it._set, this);
 		DCHECK_LT_F(it._bucket, _num_buckets);
-		_states[it._bucket] = State::ACTIVE;
-		_keys[it._bucket].~KeyT();
-		_num_filled -= 1;
+		erase_bucket(it._bucket);
+		// backward-shifting can pull a chain successor into the erased
+		// bucket, which then has to be revisited rather than skipped
+		if (_states[it._bucket] == State::FILLED) {
+			return it;
+		}
 		return ++it;
 	}
 
@@ -491,8 +538,15 @@ private:
 		reserve(_num_filled + 1);
 	}
 
-	// Find the bucket with this key, or return nullptr
-	size_t find_filled_bucket(const KeyT& key) const
+	// probe distance of the resident of <bucket> from its home bucket
+	int resident_probe_dist(size_t bucket) const
+	{
+		return (int)((bucket - (_hasher(_keys[bucket]) & _mask)) & _mask);
+	}
+
+	// Find the bucket with this key, or return (size_t)-1
+	template<typename KeyLike>
+	size_t find_filled_bucket(const KeyLike& key) const
 	{
 		if (empty()) { return (size_t)-1; } // Optimization
 
@@ -503,7 +557,9 @@ private:
 				return bucket;
 			}
 			if (_states[bucket] == State::INACTIVE) {
-				return (size_t)-1; // End of the chain!
+				// backward-shift deletion leaves no holes inside chains,
+				// so hitting an empty bucket always ends the search
+				return (size_t)-1;
 			}
 		}
 		return (size_t)-1;
@@ -514,39 +570,27 @@ private:
 	size_t find_or_allocate(const KeyT& key)
 	{
 		auto hash_value = _hasher(key);
-		size_t hole = (size_t)-1;
-		int offset=0;
-		for (; offset<=_max_probe_length; ++offset) {
+		for (int offset=0; ; ++offset) {
 			auto bucket = (hash_value + offset) & _mask;
 
-			if (_states[bucket] == State::FILLED) {
-				if (_comp(_keys[bucket], key)) {
-					return bucket;
+			if (_states[bucket] != State::FILLED) {
+				if (offset > _max_probe_length) {
+					_max_probe_length = offset;
 				}
-			} else if (_states[bucket] == State::INACTIVE) {
 				return bucket;
-			} else {
-				// ACTIVE: keep searching
-				if (hole == (size_t)-1) {
-					hole = bucket;
-				}
 			}
-		}
-
-		// No key found - but maybe a hole for it
-
-		DCHECK_EQ_F(offset, _max_probe_length+1);
-
-		if (hole != (size_t)-1) {
-			return hole;
-		}
-
-		// No hole found within _max_probe_length
-		for (; ; ++offset) {
-			auto bucket = (hash_value + offset) & _mask;
+			if (_comp(_keys[bucket], key)) {
+				return bucket;
+			}
+			// robin-hood: a resident closer to its home bucket than we are
+			// to ours gets displaced, evening out probe lengths; it also
+			// proves the key cannot sit further down this chain
+			if (resident_probe_dist(bucket) < offset) {
+				displace(bucket);
 
-			if (_states[bucket] != State::FILLED) {
-				_max_probe_length = offset;
+				if (offset > _max_probe_length) {
+					_max_probe_length = offset;
+				}
 				return bucket;
 			}
 		}
@@ -564,15 +608,84 @@ private:
 				}
 				return bucket;
 			}
+			// as in find_or_allocate; keeps the robin-hood invariant
+			// intact across reserve()-triggered rehashes
+			if (resident_probe_dist(bucket) < offset) {
+				displace(bucket);
+
+				if (offset > _max_probe_length) {
+					_max_probe_length = offset;
+				}
+				return bucket;
+			}
+		}
+	}
+
+	// move the resident of <bucket> one or more steps down its own chain
+	// to make room; cascades by swapping with any poorer resident met on
+	// the way (standard robin-hood insertion)
+	void displace(size_t bucket)
+	{
+		KeyT tmp = std::move(_keys[bucket]);
+		_keys[bucket].~KeyT();
+		_states[bucket] = State::INACTIVE;
+
+		auto hash_value = _hasher(tmp);
+		for (int offset = (int)((bucket - hash_value) & _mask) + 1; ; ++offset) {
+			auto next = (hash_value + offset) & _mask;
+
+			if (_states[next] != State::FILLED) {
+				if (offset > _max_probe_length) {
+					_max_probe_length = offset;
+				}
+				_states[next] = State::FILLED;
+				new(_keys + next) KeyT(std::move(tmp));
+				return;
+			}
+			if (resident_probe_dist(next) < offset) {
+				std::swap(tmp, _keys[next]);
+
+				if (offset > _max_probe_length) {
+					_max_probe_length = offset;
+				}
+				// adopt the evicted resident's home chain and distance
+				hash_value = _hasher(tmp);
+				offset = (int)((next - hash_value) & _mask);
+			}
+		}
+	}
+
+	// destroy the key in <bucket>, then pull trailing chain members one
+	// step back toward their home buckets so no tombstone state is needed
+	void erase_bucket(size_t bucket)
+	{
+		_keys[bucket].~KeyT();
+		_states[bucket] = State::INACTIVE;
+		_num_filled -= 1;
+
+		size_t hole = bucket;
+		for (auto next = (hole + 1) & _mask; _states[next] == State::FILLED; next = (next + 1) & _mask) {
+			auto home = _hasher(_keys[next]) & _mask;
+
+			// move <next> back iff the hole lies on its probe path, ie.
+			// no closer to <next> than its own home bucket; stop at the
+			// first empty bucket, nothing past it can belong to a chain
+			// crossing the hole
+			if (((next - home) & _mask) >= ((next - hole) & _mask)) {
+				new(_keys + hole) KeyT(std::move(_keys[next]));
+				_keys[next].~KeyT();
+
+				_states[hole] = State::FILLED;
+				_states[next] = State::INACTIVE;
+				hole = next;
+			}
 		}
-		return (size_t(-1));
 	}
 
 private:
 	enum class State : uint8_t
 	{
-		INACTIVE, // Never been touched
-		ACTIVE,   // Is inside a search-chain, but is empty
+		INACTIVE, // Empty, terminates every search-chain that reaches it
 		FILLED    // Is set with key/value
 	};
 
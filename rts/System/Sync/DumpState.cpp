@@ -2,9 +2,13 @@
 
 #include <string>
 #include <fstream>
+#include <sstream>
 #include <vector>
 #include <list>
 
+#include <atomic>
+#include <chrono>
+
 #include "DumpState.h"
 
 #include "Game/GameSetup.h"
@@ -26,15 +30,133 @@
 #include "Sim/Weapons/WeaponDefHandler.h"
 #include "System/StringUtil.h"
 #include "System/Log/ILog.h"
-
-static std::fstream file;
+#include "System/Threading/MPSCChannel.hpp"
+#include "System/Threading/SpringThreading.h"
 
 static int gMinFrameNum = -1;
 static int gMaxFrameNum = -1;
 static int gFramePeriod =  1;
+static int gDumpMask    = DUMP_STATE_DEFAULT;
+
+
+namespace {
+	struct DumpJob {
+		DumpJob() = default;
+		DumpJob(std::string&& fn, std::string&& txt): fileName(std::move(fn)), text(std::move(txt)) {}
+
+		std::string fileName; ///< non-empty: close the current dump-file and open this one
+		std::string text;
+	};
+
+	/**
+	 * The snapshotting (sim) thread only serializes state into memory;
+	 * this writer owns the dump-file and does all the blocking IO, so a
+	 * dump no longer freezes the game right when a desync needs it to
+	 * stay responsive.
+	 */
+	struct DumpWriterState {
+		~DumpWriterState() { Stop(); }
+
+		void Start();
+		void Stop();
+
+		spring::mpsc_channel<DumpJob, 16> jobs;
+		spring::thread writeThread;
+
+		std::atomic<bool> running{false};
+		std::atomic<bool> stop{false};
+
+		std::fstream file;
+	};
+
+	DumpWriterState& GetDumpWriterState()
+	{
+		static DumpWriterState state;
+		return state;
+	}
+
+	void DumpWriteThreadLoop()
+	{
+		DumpWriterState& ws = GetDumpWriterState();
+		DumpJob job;
+
+		while (true) {
+			bool wrote = false;
+
+			while (ws.jobs.pop(job)) {
+				if (!job.fileName.empty()) {
+					if (ws.file.is_open()) {
+						ws.file.flush();
+						ws.file.close();
+					}
+
+					ws.file.open(job.fileName.c_str(), std::ios::out);
+				}
+
+				if (ws.file.is_open() && !ws.file.bad())
+					ws.file << job.text;
+
+				wrote = true;
+			}
+
+			if (wrote && ws.file.is_open())
+				ws.file.flush();
+
+			if (ws.stop.load(std::memory_order_relaxed) && ws.jobs.empty())
+				break;
+
+			spring::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+
+		if (ws.file.is_open()) {
+			ws.file.flush();
+			ws.file.close();
+		}
+	}
+
+	void DumpWriterState::Start()
+	{
+		if (running.load(std::memory_order_relaxed))
+			return;
+
+		running = true;
+		stop = false;
+		writeThread = spring::thread(DumpWriteThreadLoop);
+	}
 
+	void DumpWriterState::Stop()
+	{
+		if (!running.load(std::memory_order_relaxed))
+			return;
 
-void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod)
+		stop = true;
+
+		if (writeThread.joinable())
+			writeThread.join();
+
+		running = false;
+	}
+
+	void QueueDumpJob(std::string&& fileName, std::string&& text)
+	{
+		DumpWriterState& ws = GetDumpWriterState();
+		ws.Start();
+
+		// dumps are desync evidence; wait (bounded) for the writer to
+		// catch up rather than dropping snapshots when it falls behind
+		for (int i = 0; !ws.jobs.push(DumpJob(std::move(fileName), std::move(text))); i++) {
+			if (i >= 1000) {
+				LOG_L(L_WARNING, "[%s] dump-writer stalled, dropping a snapshot", __func__);
+				return;
+			}
+
+			spring::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+}
+
+
+void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod, int newDumpMask)
 {
 	#ifdef NDEBUG
 	// must be in debug-mode for this
@@ -54,14 +176,10 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod)
 	if (newMinFrameNum >= 0) gMinFrameNum = newMinFrameNum;
 	if (newMaxFrameNum >= 0) gMaxFrameNum = newMaxFrameNum;
 	if (newFramePeriod >= 1) gFramePeriod = newFramePeriod;
+	if (newDumpMask   >= 1) gDumpMask    = newDumpMask;
 
 	if ((gMinFrameNum != oldMinFrameNum) || (gMaxFrameNum != oldMaxFrameNum)) {
-		// bounds changed, open a new file
-		if (file.is_open()) {
-			file.flush();
-			file.close();
-		}
-
+		// bounds changed, have the writer open a new file
 		std::string name = (gameServer != nullptr)? "Server": "Client";
 		name += "GameState-";
 		name += IntToString(guRNG.NextInt());
@@ -71,22 +189,19 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod)
 		name += IntToString(gMaxFrameNum);
 		name += "].txt";
 
-		file.open(name.c_str(), std::ios::out);
+		std::ostringstream header;
+		header << " mapName: " << gameSetup->mapName << "\n";
+		header << " modName: " << gameSetup->modName << "\n";
+		header << "minFrame: " << gMinFrameNum << "\n";
+		header << "maxFrame: " << gMaxFrameNum << "\n";
+		header << "randSeed: " << gsRNG.GetLastSeed() << "\n";
+		header << "initSeed: " << gsRNG.GetInitSeed() << "\n";
 
-		if (file.is_open()) {
-			file << " mapName: " << gameSetup->mapName << "\n";
-			file << " modName: " << gameSetup->modName << "\n";
-			file << "minFrame: " << gMinFrameNum << "\n";
-			file << "maxFrame: " << gMaxFrameNum << "\n";
-			file << "randSeed: " << gsRNG.GetLastSeed() << "\n";
-			file << "initSeed: " << gsRNG.GetInitSeed() << "\n";
-		}
+		LOG("[%s] using dump-file \"%s\" (mask 0x%x)", __func__, name.c_str(), gDumpMask);
 
-		LOG("[%s] using dump-file \"%s\"", __func__, name.c_str());
+		QueueDumpJob(std::move(name), header.str());
 	}
 
-	if (file.bad() || !file.is_open())
-		return;
 	// check if the CURRENT frame lies within the bounds
 	if (gs->frameNum < gMinFrameNum)
 		return;
@@ -100,20 +215,13 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod)
 	const auto& activeFeatureIDs = featureHandler->GetActiveFeatureIDs();
 	const ProjectileContainer& projectiles = projectileHandler->syncedProjectiles;
 
+	// snapshot into memory only; the writer thread does the disk IO
+	std::ostringstream file;
+
 	file << "frame: " << gs->frameNum << ", seed: " << gsRNG.GetLastSeed() << "\n";
 	file << "\tunits: " << activeUnits.size() << "\n";
 
-	#define DUMP_UNIT_DATA
-	#define DUMP_UNIT_PIECE_DATA
-	#define DUMP_UNIT_WEAPON_DATA
-	#define DUMP_UNIT_COMMANDAI_DATA
-	#define DUMP_UNIT_MOVETYPE_DATA
-	#define DUMP_FEATURE_DATA
-	#define DUMP_PROJECTILE_DATA
-	#define DUMP_TEAM_DATA
-	// #define DUMP_ALLYTEAM_DATA
-
-	#ifdef DUMP_UNIT_DATA
+	if ((gDumpMask & DUMP_STATE_UNIT) != 0) {
 	for (const CUnit* u: activeUnits) {
 		const std::vector<CWeapon*>& weapons = u->weapons;
 		const LocalModel& lm = u->localModel;
@@ -136,7 +244,7 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod)
 		file << "\t\t\tfireState: " << u->fireState << ", moveState: " << u->moveState << "\n";
 		file << "\t\t\tpieces: " << pieces.size() << "\n";
 
-		#ifdef DUMP_UNIT_PIECE_DATA
+		if ((gDumpMask & DUMP_STATE_UNIT_PIECE) != 0) {
 		for (const LocalModelPiece& lmp: pieces) {
 			const S3DModelPiece* omp = lmp.original;
 			const S3DModelPiece* par = omp->parent;
@@ -149,11 +257,11 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod)
 			file << "\t\t\t\tvisible: " << lmp.scriptSetVisible << "\n";
 			file << "\n";
 		}
-		#endif
+		}
 
 		file << "\t\t\tweapons: " << weapons.size() << "\n";
 
-		#ifdef DUMP_UNIT_WEAPON_DATA
+		if ((gDumpMask & DUMP_STATE_UNIT_WEAPON) != 0) {
 		for (const CWeapon* w: weapons) {
 			const float3& awp = w->aimFromPos;
 			const float3& rwp = w->relAimFromPos;
@@ -168,9 +276,9 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod)
 			file << "\t\t\t\trelWeaponMuzzlePos: <" << rmp.x << ", " << rmp.y << ", " << rmp.z << ">\n";
 			file << "\n";
 		}
-		#endif
+		}
 
-		#ifdef DUMP_UNIT_COMMANDAI_DATA
+		if ((gDumpMask & DUMP_STATE_UNIT_COMMANDAI) != 0) {
 		const CCommandAI* cai = u->commandAI;
 		const CCommandQueue& cq = cai->commandQue;
 
@@ -187,9 +295,9 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod)
 				file << "\t\t\t\t\t\t" << c.GetParam(n) << "\n";
 			}
 		}
-		#endif
+		}
 
-		#ifdef DUMP_UNIT_MOVETYPE_DATA
+		if ((gDumpMask & DUMP_STATE_UNIT_MOVETYPE) != 0) {
 		const AMoveType* amt = u->moveType;
 		const float3& goalPos = amt->goalPos;
 		const float3& oldUpdatePos = amt->oldPos;
@@ -201,13 +309,13 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod)
 		file << "\t\t\t\toldSlowUpPos: <" << oldSlowUpPos.x << ", " << oldSlowUpPos.y << ", " << oldSlowUpPos.z << ">\n";
 		file << "\t\t\t\tmaxSpeed: " << amt->GetMaxSpeed() << ", maxWantedSpeed: " << amt->GetMaxWantedSpeed() << "\n";
 		file << "\t\t\t\tprogressState: " << amt->progressState << "\n";
-		#endif
+		}
+	}
 	}
-	#endif
 
 	file << "\tfeatures: " << activeFeatureIDs.size() << "\n";
 
-	#ifdef DUMP_FEATURE_DATA
+	if ((gDumpMask & DUMP_STATE_FEATURE) != 0) {
 	for (const int featureID: activeFeatureIDs) {
 		const CFeature* f = featureHandler->GetFeature(featureID);
 
@@ -215,11 +323,11 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod)
 		file << "\t\t\tpos: <" << f->pos.x << ", " << f->pos.y << ", " << f->pos.z << ">\n";
 		file << "\t\t\thealth: " << f->health << ", reclaimLeft: " << f->reclaimLeft << "\n";
 	}
-	#endif
+	}
 
 	file << "\tprojectiles: " << projectiles.size() << "\n";
 
-	#ifdef DUMP_PROJECTILE_DATA
+	if ((gDumpMask & DUMP_STATE_PROJECTILE) != 0) {
 	for (const CProjectile* p: projectiles) {
 		file << "\t\tprojectileID: " << p->id << "\n";
 		file << "\t\t\tpos: <" << p->pos.x << ", " << p->pos.y << ", " << p->pos.z << ">\n";
@@ -228,11 +336,11 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod)
 		file << "\t\t\tweapon: " << p->weapon << ", piece: " << p->piece << "\n";
 		file << "\t\t\tcheckCol: " << p->checkCol << ", deleteMe: " << p->deleteMe << "\n";
 	}
-	#endif
+	}
 
 	file << "\tteams: " << teamHandler->ActiveTeams() << "\n";
 
-	#ifdef DUMP_TEAM_DATA
+	if ((gDumpMask & DUMP_STATE_TEAM) != 0) {
 	for (int a = 0; a < teamHandler->ActiveTeams(); ++a) {
 		const CTeam* t = teamHandler->Team(a);
 
@@ -242,11 +350,13 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod)
 		file << "\t\t\tmetalIncome: " << t->resIncome.metal << ", energyIncome: " << t->resIncome.energy << "\n";
 		file << "\t\t\tmetalExpense: " << t->resExpense.metal << ", energyExpense: " << t->resExpense.energy << "\n";
 	}
-	#endif
+	}
 
 	file << "\tallyteams: " << teamHandler->ActiveAllyTeams() << "\n";
 
 	#ifdef DUMP_ALLYTEAM_DATA
+	// LOS-map dumps are huge and the accessors below have bitrotted,
+	// left out of the runtime mask until someone revives them
 	for (int a = 0; a < teamHandler->ActiveAllyTeams(); ++a) {
 		file << "\t\tallyteamID: " << a << ", LOS-map:" << "\n";
 
@@ -262,5 +372,5 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod)
 	}
 	#endif
 
-	file.flush();
+	QueueDumpJob(std::string(), file.str());
 }
@@ -3,6 +3,24 @@
 #ifndef DUMPSTATE_H
 #define DUMPSTATE_H
 
-extern void DumpState(int startFrameNum, int endFrameNum, int newFramePeriod);
+/**
+ * Selectable state subsets for DumpState; the per-frame header (frame
+ * number and RNG seed) is always written. The unit sub-bits only apply
+ * when DUMP_STATE_UNIT itself is set.
+ */
+enum {
+	DUMP_STATE_UNIT           = (1 << 0),
+	DUMP_STATE_UNIT_PIECE     = (1 << 1),
+	DUMP_STATE_UNIT_WEAPON    = (1 << 2),
+	DUMP_STATE_UNIT_COMMANDAI = (1 << 3),
+	DUMP_STATE_UNIT_MOVETYPE  = (1 << 4),
+	DUMP_STATE_FEATURE        = (1 << 5),
+	DUMP_STATE_PROJECTILE     = (1 << 6),
+	DUMP_STATE_TEAM           = (1 << 7),
+
+	DUMP_STATE_DEFAULT        = (1 << 8) - 1,
+};
+
+extern void DumpState(int startFrameNum, int endFrameNum, int newFramePeriod, int newDumpMask = 0);
 
 #endif /* DUMPSTATE_H */
@@ -1,5 +1,6 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 
@@ -136,6 +137,77 @@ void sha512::dm_compress(uint64_t state[NUM_STATE_CONSTS], const uint8_t blocks[
 }
 
 
+void sha512::stream_init(stream_state& ss) {
+	assert(sizeof(STATE_CONSTS) == (NUM_STATE_CONSTS * sizeof(uint64_t)));
+	std::memcpy(&ss.state[0], &STATE_CONSTS[0], sizeof(STATE_CONSTS));
+	std::memset(ss.block, 0, BLK_LEN);
+
+	ss.num_bytes = 0;
+}
+
+void sha512::stream_update(stream_state& ss, const uint8_t msg_bytes[], size_t len) {
+	const size_t fill = ss.num_bytes & (BLK_LEN - 1);
+
+	ss.num_bytes += len;
+
+	// top up a partially filled block first
+	if (fill > 0) {
+		const size_t take = std::min(len, static_cast<size_t>(BLK_LEN) - fill);
+
+		std::memcpy(&ss.block[fill], msg_bytes, take);
+		msg_bytes += take;
+		len -= take;
+
+		if ((fill + take) < BLK_LEN)
+			return;
+
+		dm_compress(ss.state, ss.block, BLK_LEN);
+	}
+
+	const size_t ofs = len & (~static_cast<size_t>(BLK_LEN - 1));
+
+	dm_compress(ss.state, msg_bytes, ofs);
+
+	// buffer the trailing partial block
+	if ((len - ofs) > 0)
+		std::memcpy(ss.block, &msg_bytes[ofs], len - ofs);
+}
+
+void sha512::stream_final(stream_state& ss, uint8_t sha_bytes[SHA_LEN]) {
+	uint8_t block[BLK_LEN] = {0};
+	uint64_t len = ss.num_bytes;
+
+	size_t ofs = ss.num_bytes & (BLK_LEN - 1);
+
+	std::memmove(block, ss.block, ofs);
+
+	ofs += 1;
+
+	block[ofs - 1] = 0x80;
+
+	// apply padding
+	if ((ofs + 16) > BLK_LEN) {
+		dm_compress(ss.state, block, BLK_LEN);
+		std::memset(block, 0, BLK_LEN);
+	}
+
+	block[BLK_LEN - 1] = static_cast<uint8_t>((len & 0x1Fu) << 3);
+	len >>= 5;
+
+	// write lengths
+	for (uint8_t i = 1; i < 16; i++, len >>= 8) {
+		block[BLK_LEN - 1 - i] = static_cast<uint8_t>(len);
+	}
+
+	dm_compress(ss.state, block, BLK_LEN);
+
+	// convert state to digest bytes; big-endian order
+	for (uint8_t i = 0; i < SHA_LEN; i++) {
+		sha_bytes[i] = static_cast<uint8_t>(ss.state[i >> 3] >> ((7 - (i & 7)) << 3));
+	}
+}
+
+
 bool sha512::unit_test(const char* msg_str, const char* sha_str) {
 	std::vector<uint8_t> msg_bytes = {};
 	std::array<uint8_t, SHA_LEN> sha_bytes = {0};
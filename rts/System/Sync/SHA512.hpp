@@ -50,11 +50,27 @@ namespace sha512 {
 	};
 
 
+	/**
+	 * Incremental digest context; lets callers hash a message in chunks
+	 * as it is produced (or read from disk) instead of concatenating it
+	 * into one buffer first.
+	 */
+	struct stream_state {
+		uint64_t state[NUM_STATE_CONSTS];
+		uint8_t block[BLK_LEN];
+		uint64_t num_bytes;
+	};
+
+
 	void dump_digest(const std::array<uint8_t, SHA_LEN>& sha_bytes, std::array<char, SHA_LEN * 2 + 1>& hex_chars);
 	void calc_digest(const std::vector<uint8_t>& msg_bytes, std::array<uint8_t, SHA_LEN>& sha_bytes);
 	void calc_digest(const uint8_t msg_bytes[], size_t len, uint8_t sha_bytes[SHA_LEN]);
 	void dm_compress(uint64_t state[NUM_STATE_CONSTS], const uint8_t blocks[], size_t len);
 
+	void stream_init(stream_state& ss);
+	void stream_update(stream_state& ss, const uint8_t msg_bytes[], size_t len);
+	void stream_final(stream_state& ss, uint8_t sha_bytes[SHA_LEN]);
+
 	bool unit_test(const char* msg_str = TEST_STR_PAIR[0], const char* sha_str = TEST_STR_PAIR[1]);
 };
 
@@ -6,7 +6,9 @@
 #include "SyncChecker.h"
 
 
-unsigned CSyncChecker::g_checksum;
+unsigned CSyncChecker::g_checksums[CSyncChecker::MAX_SYNC_THREADS];
+unsigned CSyncChecker::g_mutationCounts[CSyncChecker::MAX_SYNC_THREADS];
+_threadlocal int CSyncChecker::g_threadSlot = 0;
 int CSyncChecker::inSyncedCode;
 
 
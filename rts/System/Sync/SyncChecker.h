@@ -13,8 +13,19 @@
 	#include "HsiehHash.h"
 #endif
 
+#include "System/MainDefines.h" // for _threadlocal
+
 #include <assert.h>
 
+/**
+ * Hash only every Nth synced mutation (must be a power of two, 1 checks
+ * everything). Site selection advances with the synced mutation stream
+ * itself, so all clients sample the same subset of sites.
+ */
+#ifndef SYNCCHECK_SAMPLE_RATE
+#define SYNCCHECK_SAMPLE_RATE 1
+#endif
+
 /**
  * @brief sync checker class
  *
@@ -24,6 +35,12 @@
 class CSyncChecker {
 
 	public:
+		/**
+		 * Number of per-thread accumulators; slot 0 belongs to the main
+		 * (sim) thread, ThreadPool workers claim 1 + their worker index.
+		 */
+		static constexpr int MAX_SYNC_THREADS = 32;
+
 		/**
 		 * Whether one thread (doesn't have to be the current thread!!!) is currently processing a SimFrame.
 		 */
@@ -32,12 +49,51 @@ class CSyncChecker {
 		static void LeaveSyncedCode() { assert(InSyncedCode()); --inSyncedCode; }
 
 		/**
-		 * Keeps a running checksum over all assignments to synced variables.
+		 * Selects the accumulator the calling thread folds its mutations
+		 * into, so parallel sim paths can hash without racing each other.
 		 */
-		static unsigned GetChecksum() { return g_checksum; }
-		static void NewFrame() { g_checksum = 0xfade1eaf; }
+		static void SetThreadSlot(int index) {
+			assert(index >= 0 && index < MAX_SYNC_THREADS);
+			g_threadSlot = index;
+		}
+
+		/**
+		 * Folds the per-thread accumulators together in ascending slot
+		 * order; execution timing never changes the combined value, only
+		 * what each thread hashed does.
+		 */
+		static unsigned GetChecksum() {
+			unsigned checksum = g_checksums[0];
+
+			for (int i = 1; i < MAX_SYNC_THREADS; ++i) {
+				checksum += g_checksums[i];
+				checksum ^= checksum << 16;
+				checksum += checksum >> 11;
+			}
+
+			return checksum;
+		}
+
+		static void NewFrame() {
+			g_checksums[0] = 0xfade1eaf;
+			g_mutationCounts[0] = 0;
+
+			for (int i = 1; i < MAX_SYNC_THREADS; ++i) {
+				g_checksums[i] = 0;
+				g_mutationCounts[i] = 0;
+			}
+		}
 
 		static void Sync(const void* p, unsigned size) {
+#if (SYNCCHECK_SAMPLE_RATE > 1)
+			// sampled mode; the counter advances deterministically with
+			// the synced mutation sequence of the owning thread
+			if ((g_mutationCounts[g_threadSlot]++ & (SYNCCHECK_SAMPLE_RATE - 1)) != 0)
+				return;
+#endif
+
+			unsigned& g_checksum = g_checksums[g_threadSlot];
+
 			// most common cases first, make it easy for compiler to optimize for it
 			// simple xor is not enough to detect multiple zeroes, e.g.
 #ifdef TRACE_SYNC_HEAVY
@@ -89,9 +145,19 @@ class CSyncChecker {
 	private:
 
 		/**
-		 * The sync checksum
+		 * The per-thread sync checksum accumulators
+		 */
+		static unsigned g_checksums[MAX_SYNC_THREADS];
+
+		/**
+		 * Per-thread mutation counters driving the sampled mode
+		 */
+		static unsigned g_mutationCounts[MAX_SYNC_THREADS];
+
+		/**
+		 * The accumulator slot owned by the calling thread
 		 */
-		static unsigned g_checksum;
+		static _threadlocal int g_threadSlot;
 
 		/**
 		 * @brief in synced code
@@ -0,0 +1,107 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef MPSC_CHANNEL_HPP
+#define MPSC_CHANNEL_HPP
+
+#include <atomic>
+#include <utility>
+
+namespace spring {
+	// bounded lock-free multi-producer single-consumer ring channel
+	// (sequence-numbered slots a la Vyukov); producers hand items to a
+	// single consumer which drains them in batches, i.e. one acquire
+	// per drained item instead of a mutex round-trip per item and no
+	// possibility of a lock convoy between producer and consumer
+	//
+	// N must be a power of two; pop(), drain() and empty() must all be
+	// called from the same (consumer) thread
+	template<typename T, unsigned int N>
+	class mpsc_channel {
+	public:
+		static_assert(N != 0 && (N & (N - 1)) == 0, "capacity must be a power of two");
+
+		mpsc_channel(): pushPos(0), popPos(0) {
+			for (unsigned int i = 0; i < N; i++) {
+				slots[i].seq.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		mpsc_channel(const mpsc_channel&) = delete;
+		mpsc_channel& operator=(const mpsc_channel&) = delete;
+
+		// returns false without blocking if the ring is full
+		bool push(const T& item) {
+			Slot* slot = nullptr;
+			unsigned int pos = pushPos.load(std::memory_order_relaxed);
+
+			for (;;) {
+				slot = &slots[pos & (N - 1)];
+				const int dif = static_cast<int>(slot->seq.load(std::memory_order_acquire)) - static_cast<int>(pos);
+
+				if (dif == 0) {
+					// slot is free, try to claim it
+					if (pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						break;
+				} else if (dif < 0) {
+					return false;
+				} else {
+					// another producer claimed the slot, retry
+					pos = pushPos.load(std::memory_order_relaxed);
+				}
+			}
+
+			slot->item = item;
+			slot->seq.store(pos + 1, std::memory_order_release);
+			return true;
+		}
+
+		// returns false if the ring is empty
+		bool pop(T& item) {
+			Slot& slot = slots[popPos & (N - 1)];
+
+			if (static_cast<int>(slot.seq.load(std::memory_order_acquire)) - static_cast<int>(popPos + 1) != 0)
+				return false;
+
+			item = std::move(slot.item);
+			// drop any reference the slot might still hold
+			slot.item = T();
+			slot.seq.store(popPos + N, std::memory_order_release);
+			popPos += 1;
+			return true;
+		}
+
+		// batch dequeue; calls f(item) for up to maxItems queued items
+		// and returns the number actually consumed
+		template<typename F>
+		unsigned int drain(F&& f, unsigned int maxItems = N) {
+			unsigned int numItems = 0;
+			T item;
+
+			while (numItems < maxItems && pop(item)) {
+				f(std::move(item));
+				numItems += 1;
+			}
+
+			return numItems;
+		}
+
+		bool empty() const {
+			const Slot& slot = slots[popPos & (N - 1)];
+			return (static_cast<int>(slot.seq.load(std::memory_order_acquire)) - static_cast<int>(popPos + 1) != 0);
+		}
+
+	private:
+		struct Slot {
+			std::atomic<unsigned int> seq;
+			T item;
+		};
+
+		Slot slots[N];
+
+		// keep the producer- and consumer-side cursors on separate cache lines
+		alignas(64) std::atomic<unsigned int> pushPos;
+		alignas(64) unsigned int popPos;
+	};
+}
+
+#endif // MPSC_CHANNEL_HPP
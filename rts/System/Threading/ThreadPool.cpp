@@ -15,7 +15,9 @@
 #endif
 #include "System/Log/ILog.h"
 #include "System/Platform/Threading.h"
+#include "System/Sync/SyncChecker.h"
 #include "System/Threading/SpringThreading.h"
+#include "System/Threading/WSDeque.hpp"
 
 #ifdef   likely
 #undef   likely
@@ -46,6 +48,8 @@ CONFIG(int, WorkerThreadCount).defaultValue(-1).safemodeValue(0).minimumValue(-1
 
 struct ThreadStats {
 	uint64_t numTasksRun;
+	uint64_t numTasksStolen;
+	uint64_t numIdleWaits;
 	uint64_t sumExecTime;
 	uint64_t minExecTime;
 	uint64_t maxExecTime;
@@ -65,6 +69,13 @@ static std::array<boost::lockfree::queue<ITaskGroup*>, ThreadPool::MAX_THREADS>
 static std::array<moodycamel::ConcurrentQueue<ITaskGroup*>, ThreadPool::MAX_THREADS> taskQueues[2];
 #endif
 
+// per-worker work-stealing deques [idx > 0] for unpinned tasks pushed from
+// within a worker (for-task slice re-inserts, nested for_mt's); the owner
+// pushes and pops at the bottom, idle threads steal from the top so uneven
+// slice costs no longer leave workers idle at the tail of parallel regions
+// pinned tasks (wantedThread != 0) stay in taskQueues and are never stolen
+static std::array<spring::ws_deque<ITaskGroup*, 1024>, ThreadPool::MAX_THREADS> workerDeques[2];
+
 static std::vector<void*> workerThreads[2];
 static std::array<bool, ThreadPool::MAX_THREADS> exitFlags;
 static std::array<ThreadStats, ThreadPool::MAX_THREADS> threadStats[2];
@@ -134,6 +145,26 @@ bool HasThreads() { return !workerThreads[false].empty(); }
 
 
 
+static void ExecuteTask(ITaskGroup* tg, int tid, bool async)
+{
+	assert(!async || tg->IsAsyncTask());
+
+	#ifdef USE_TASK_STATS_TRACKING
+	const uint64_t wdt = tg->GetDeltaTime(spring_now());
+	const uint64_t edt = tg->ExecuteLoop(tid, false);
+
+	threadStats[async][tid].numTasksRun += 1;
+	threadStats[async][tid].sumExecTime += edt;
+	threadStats[async][tid].sumWaitTime += wdt;
+	threadStats[async][tid].minExecTime  = std::min(threadStats[async][tid].minExecTime, edt);
+	threadStats[async][tid].maxExecTime  = std::max(threadStats[async][tid].maxExecTime, edt);
+	threadStats[async][tid].minWaitTime  = std::min(threadStats[async][tid].minWaitTime, wdt);
+	threadStats[async][tid].maxWaitTime  = std::max(threadStats[async][tid].maxWaitTime, wdt);
+	#else
+	tg->ExecuteLoop(tid, false);
+	#endif
+}
+
 static bool DoTask(int tid, bool async)
 {
 	#ifndef UNIT_TEST
@@ -142,8 +173,17 @@ static bool DoTask(int tid, bool async)
 
 	ITaskGroup* tg = nullptr;
 
+	// drain our own deque first; its bottom holds the most recently
+	// pushed (cache-hot) slices and popping it is nearly always free
+	// of contention (threads with id=0 own no deque, they only steal)
+	if (tid > 0) {
+		while (workerDeques[async][tid].pop_bottom(tg)) {
+			ExecuteTask(tg, tid, async);
+		}
+	}
+
 	// any external thread calling WaitForFinished will have
-	// id=0 and *only* processes tasks from the global queue
+	// id=0 and *only* processes tasks from the shared queues
 	for (int idx = 0; idx <= tid; idx += std::max(tid, 1)) {
 		auto& queue = taskQueues[async][idx];
 
@@ -159,22 +199,7 @@ static bool DoTask(int tid, bool async)
 			if (idx == 0)
 				NotifyWorkerThreads(true, async);
 
-			assert(!async || tg->IsAsyncTask());
-
-			#ifdef USE_TASK_STATS_TRACKING
-			const uint64_t wdt = tg->GetDeltaTime(spring_now());
-			const uint64_t edt = tg->ExecuteLoop(tid, false);
-
-			threadStats[async][tid].numTasksRun += 1;
-			threadStats[async][tid].sumExecTime += edt;
-			threadStats[async][tid].sumWaitTime += wdt;
-			threadStats[async][tid].minExecTime  = std::min(threadStats[async][tid].minExecTime, edt);
-			threadStats[async][tid].maxExecTime  = std::max(threadStats[async][tid].maxExecTime, edt);
-			threadStats[async][tid].minWaitTime  = std::min(threadStats[async][tid].minWaitTime, wdt);
-			threadStats[async][tid].maxWaitTime  = std::max(threadStats[async][tid].maxWaitTime, wdt);
-			#else
-			tg->ExecuteLoop(tid, false);
-			#endif
+			ExecuteTask(tg, tid, async);
 		}
 
 		#ifdef USE_BOOST_LOCKFREE_QUEUE
@@ -182,26 +207,35 @@ static bool DoTask(int tid, bool async)
 		#else
 		while (queue.try_dequeue(tg)) {
 		#endif
-			assert(!async || tg->IsAsyncTask());
+			ExecuteTask(tg, tid, async);
+		}
+	}
+
+	if (tg == nullptr) {
+		// nothing queued for us; steal the oldest unpinned task from
+		// another worker's deque so uneven slice costs do not leave us
+		// idling until the whole parallel region retires
+		const int numThreads = ThreadPool::GetNumThreads();
+
+		for (int victim = 1; victim < numThreads; victim++) {
+			if (victim == tid)
+				continue;
+
+			if (!workerDeques[async][victim].steal(tg)) {
+				tg = nullptr;
+				continue;
+			}
 
 			#ifdef USE_TASK_STATS_TRACKING
-			const uint64_t wdt = tg->GetDeltaTime(spring_now());
-			const uint64_t edt = tg->ExecuteLoop(tid, false);
-
-			threadStats[async][tid].numTasksRun += 1;
-			threadStats[async][tid].sumExecTime += edt;
-			threadStats[async][tid].sumWaitTime += wdt;
-			threadStats[async][tid].minExecTime  = std::min(threadStats[async][tid].minExecTime, edt);
-			threadStats[async][tid].maxExecTime  = std::max(threadStats[async][tid].maxExecTime, edt);
-			threadStats[async][tid].minWaitTime  = std::min(threadStats[async][tid].minWaitTime, wdt);
-			threadStats[async][tid].maxWaitTime  = std::max(threadStats[async][tid].maxWaitTime, wdt);
-			#else
-			tg->ExecuteLoop(tid, false);
+			threadStats[async][tid].numTasksStolen += 1;
 			#endif
+
+			ExecuteTask(tg, tid, async);
+			break;
 		}
 	}
 
-	// if true, queue contained at least one element
+	// if true, some queue contained at least one element
 	return (tg != nullptr);
 }
 
@@ -214,6 +248,11 @@ static void WorkerLoop(int tid, bool async)
 	#ifndef UNIT_TEST
 	Threading::SetThreadName(IntToString(tid, "worker%i"));
 	#endif
+	#ifdef SYNCCHECK
+	// claim this worker's checksum accumulator so parallel synced
+	// sections can hash without racing (see CSyncChecker::GetChecksum)
+	CSyncChecker::SetThreadSlot(std::min(tid, CSyncChecker::MAX_SYNC_THREADS - 1));
+	#endif
 
 	// make first worker spin a while before sleeping/waiting on the thread signal
 	// this increases the chance that at least one worker is awake when a new task
@@ -231,6 +270,10 @@ static void WorkerLoop(int tid, bool async)
 			if (spring_now() < spinlockEnd)
 				continue;
 
+			#ifdef USE_TASK_STATS_TRACKING
+			threadStats[async][tid].numIdleWaits += 1;
+			#endif
+
 			newTasksSignal[async].wait_for(sleepTime = std::min(sleepTime * 1.25f, maxSleepTime));
 		}
 	}
@@ -313,6 +356,19 @@ void PushTaskGroup(ITaskGroup* taskGroup)
 
 	taskGroup->SetTimeStamp(spring_now());
 
+	// unpinned tasks pushed from within a worker go onto that worker's own
+	// deque; the worker keeps popping them LIFO (cache-hot) while any idle
+	// thread can steal them, so they never queue up behind global work
+	// falls through to the shared queue if the deque is full
+	if (taskGroup->WantedThread() == 0 && threadnum > 0) {
+		if (workerDeques[ taskGroup->IsAsyncTask() ][threadnum].push_bottom(taskGroup)) {
+			if (!taskGroup->IsAsyncTask())
+				NotifyWorkerThreads(false, false);
+
+			return;
+		}
+	}
+
 	#ifdef USE_BOOST_LOCKFREE_QUEUE
 	while (!queue.push(taskGroup));
 	#else
@@ -330,6 +386,36 @@ void PushTaskGroup(ITaskGroup* taskGroup)
 	#endif
 }
 
+uint64_t GetNumTasksStolen()
+{
+	uint64_t numStolen = 0;
+
+	#ifdef USE_TASK_STATS_TRACKING
+	for (bool async: {false, true}) {
+		for (int i = 0; i < MAX_THREADS; i++) {
+			numStolen += threadStats[async][i].numTasksStolen;
+		}
+	}
+	#endif
+
+	return numStolen;
+}
+
+uint64_t GetNumIdleWaits()
+{
+	uint64_t numIdles = 0;
+
+	#ifdef USE_TASK_STATS_TRACKING
+	for (bool async: {false, true}) {
+		for (int i = 0; i < MAX_THREADS; i++) {
+			numIdles += threadStats[async][i].numIdleWaits;
+		}
+	}
+	#endif
+
+	return numIdles;
+}
+
 void NotifyWorkerThreads(bool force, bool async)
 {
 	// OPTIMIZATION
@@ -412,6 +498,10 @@ static void KillThreads(int wantedNumThreads, int curNumThreads)
 		while (taskQueues[false][i].try_dequeue(tg));
 		while (taskQueues[ true][i].try_dequeue(tg));
 		#endif
+
+		// the owning worker is joined at this point, draining is safe
+		while (workerDeques[false][i].steal(tg));
+		while (workerDeques[ true][i].steal(tg));
 	}
 
 	assert((wantedNumThreads != 0) || workerThreads[false].empty());
@@ -462,12 +552,14 @@ void SetThreadCount(int wantedNumThreads)
 	const char* fmts[4] = {
 		"[ThreadPool::%s][1] wanted=%d current=%d maximum=%d",
 		"[ThreadPool::%s][2] workers=%lu",
-		"\t[async=%d] threads=%d tasks=%lu {sum,avg}{exec,wait}time={{%.3f, %.3f}, {%.3f, %.3f}}ms",
-		"\t\tthread=%d tasks=%lu (%3.3f%%) {sum,min,max,avg}{exec,wait}time={{%.3f, %.3f, %.3f, %.3f}, {%.3f, %.3f, %.3f, %.3f}}ms",
+		"\t[async=%d] threads=%d tasks=%lu stolen=%lu idles=%lu {sum,avg}{exec,wait}time={{%.3f, %.3f}, {%.3f, %.3f}}ms",
+		"\t\tthread=%d tasks=%lu (%3.3f%%) stolen=%lu idles=%lu {sum,min,max,avg}{exec,wait}time={{%.3f, %.3f, %.3f, %.3f}, {%.3f, %.3f, %.3f, %.3f}}ms",
 	};
 
 	// total number of tasks executed by pool; total time spent in DoTask
 	uint64_t pNumTasksRun [2] = {0lu, 0lu};
+	uint64_t pNumTasksStln[2] = {0lu, 0lu};
+	uint64_t pNumIdleWaits[2] = {0lu, 0lu};
 	uint64_t pSumExecTimes[2] = {0lu, 0lu};
 	uint64_t pSumWaitTimes[2] = {0lu, 0lu};
 
@@ -485,6 +577,8 @@ void SetThreadCount(int wantedNumThreads)
 		for (bool async: {false, true}) {
 			for (int i = 0; i < MAX_THREADS; i++) {
 				threadStats[async][i].numTasksRun =  0lu;
+				threadStats[async][i].numTasksStolen = 0lu;
+				threadStats[async][i].numIdleWaits = 0lu;
 				threadStats[async][i].sumExecTime =  0lu;
 				threadStats[async][i].minExecTime = -1lu;
 				threadStats[async][i].maxExecTime =  0lu;
@@ -509,6 +603,8 @@ void SetThreadCount(int wantedNumThreads)
 		for (bool async: {false, true}) {
 			for (int i = 0; i < curNumThreads; i++) {
 				pNumTasksRun [async] += threadStats[async][i].numTasksRun;
+				pNumTasksStln[async] += threadStats[async][i].numTasksStolen;
+				pNumIdleWaits[async] += threadStats[async][i].numIdleWaits;
 				pSumExecTimes[async] += threadStats[async][i].sumExecTime;
 				pSumWaitTimes[async] += threadStats[async][i].sumWaitTime;
 			}
@@ -520,7 +616,7 @@ void SetThreadCount(int wantedNumThreads)
 			const float pAvgExecTime = (pSumExecTimes[async] * 1e-6f) / std::max(pNumTasksRun[async], uint64_t(1));
 			const float pAvgWaitTime = (pSumWaitTimes[async] * 1e-6f) / std::max(pNumTasksRun[async], uint64_t(1));
 
-			LOG(fmts[2], async, curNumThreads, pNumTasksRun[async],  pSumExecTime, pAvgExecTime,  pSumWaitTime, pAvgWaitTime);
+			LOG(fmts[2], async, curNumThreads, pNumTasksRun[async], pNumTasksStln[async], pNumIdleWaits[async],  pSumExecTime, pAvgExecTime,  pSumWaitTime, pAvgWaitTime);
 
 			for (int i = 0; i < curNumThreads; i++) {
 				const ThreadStats& ts = threadStats[async][i];
@@ -538,7 +634,7 @@ void SetThreadCount(int wantedNumThreads)
 				const float tAvgWaitTime = tSumWaitTime / std::max(ts.numTasksRun, uint64_t(1));
 				const float tRelExecFrac = (ts.numTasksRun * 1e2f) / std::max(pNumTasksRun[async], uint64_t(1));
 
-				LOG(fmts[3], i, ts.numTasksRun, tRelExecFrac,  tSumExecTime, tMinExecTime, tMaxExecTime, tAvgExecTime,  tSumWaitTime, tMinWaitTime, tMaxWaitTime, tAvgWaitTime);
+				LOG(fmts[3], i, ts.numTasksRun, tRelExecFrac, ts.numTasksStolen, ts.numIdleWaits,  tSumExecTime, tMinExecTime, tMaxExecTime, tAvgExecTime,  tSumWaitTime, tMinWaitTime, tMaxWaitTime, tAvgWaitTime);
 			}
 		}
 	}
@@ -592,6 +688,10 @@ void SetDefaultThreadCount()
 			if (i == 0)
 				return 0;
 
+			// topology-aware placement takes precedence when configured
+			if (Threading::GetPinPolicy() != Threading::PIN_POLICY_NONE)
+				return (Threading::ApplyPinPolicy(Threading::PIN_ROLE_WORKER, i - 1));
+
 			const std::uint32_t workerCore = FindWorkerThreadCore(i - 1, workerAvailCores, mainAffinity);
 			// const std::uint32_t workerCore = workerAvailCores;
 
@@ -602,6 +702,11 @@ void SetDefaultThreadCount()
 		const std::uint32_t poolCoreAffinity = parallel_reduce(AffinityFunc, ReduceFunc);
 		const std::uint32_t mainCoreAffinity = ~poolCoreAffinity;
 
+		if (Threading::GetPinPolicy() != Threading::PIN_POLICY_NONE) {
+			Threading::ApplyPinPolicy(Threading::PIN_ROLE_MAIN);
+			return;
+		}
+
 		if (mainAffinity == 0)
 			mainAffinity = systemCores;
 
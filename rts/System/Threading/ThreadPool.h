@@ -4,6 +4,7 @@
 #define _THREADPOOL_H
 
 #ifndef THREADPOOL
+#include <cstdint>
 #include  <functional>
 
 namespace ThreadPool {
@@ -21,6 +22,8 @@ namespace ThreadPool {
 	static inline int GetNumThreads() { return 1; }
 	static inline void NotifyWorkerThreads(bool force, bool async) {}
 	static inline bool HasThreads() { return false; }
+	static inline std::uint64_t GetNumTasksStolen() { return 0; }
+	static inline std::uint64_t GetNumIdleWaits() { return 0; }
 
 	static constexpr int MAX_THREADS = 1;
 }
@@ -67,7 +70,9 @@ static inline auto parallel_reduce(F&& f, G&& g) -> typename std::result_of<F()>
 #include  <array>
 #include <vector>
 #include <numeric>
+#include <algorithm>
 #include <atomic>
+#include <cstdint>
 
 #undef gt
 #include <memory>
@@ -101,6 +106,10 @@ namespace ThreadPool {
 	int GetNumThreads();
 	void NotifyWorkerThreads(bool force, bool async);
 
+	// work-stealing statistics, accumulated across all threads
+	uint64_t GetNumTasksStolen();
+	uint64_t GetNumIdleWaits();
+
 	static constexpr int MAX_THREADS = 16;
 }
 
@@ -581,48 +590,96 @@ private:
 
 #else
 
+// per-call-site cost feedback for for_mt; one instance lives as a static
+// behind each for_mt template instantiation (i.e. each lambda type) and
+// carries the measured per-item cost over to subsequent invocations
+struct ForMTProfile {
+	std::atomic<int> avgItemCostNs = {0};
+};
+
+
 template<typename F>
 class ForTaskGroup: public ITaskGroup
 {
 public:
 	typedef  TTaskGroup<F, void, int>  ChildTaskType;
 
+	// slices are sized toward this duration once a call-site is profiled;
+	// long enough to amortize the atomic RMW's and queue re-inserts, short
+	// enough that the tail of a region never idles workers for visible time
+	static constexpr int TARGET_SLICE_TIME_NS = 100 * 1000;
+
 	ForTaskGroup(bool pooled) : ITaskGroup(false, pooled) {}
 
-	void Enqueue(const int from, const int to, const int step, F& func)
+	void Enqueue(const int from, const int to, const int step, F& func, ForMTProfile* profile = nullptr)
 	{
 		assert(to >= from);
 
-		remainingTasks.store((step == 1) ? (to - from) : ((to - from + step - 1) / step));
+		numItems = (step == 1) ? (to - from) : ((to - from + step - 1) / step);
+
+		remainingTasks.store(numItems);
 		ctr.store(0);
 
 		this->from = from;
 		this->to   = to;
 		this->step = step;
 		this->func = func;
+		this->profile = profile;
 	}
 
 	bool IsSliceTask() const override { return true; }
 	bool ExecuteStep() override
 	{
-		const int i = from + (step * ctr.fetch_add(1, std::memory_order_relaxed));
+		// lazy splitting; claim half an even share of the still-unclaimed
+		// items at once, so slices start large (few atomic RMW's and queue
+		// re-inserts) and shrink toward the tail of the range where they
+		// matter for load balance when per-item costs are uneven
+		const int numClaimed = ctr.load(std::memory_order_relaxed);
 
-		if (i < to) {
-			func(i);
-			remainingTasks -= 1;
-			return true;
+		int sliceSize = std::max(1, (numItems - numClaimed) / (ThreadPool::GetNumThreads() * 2));
+
+		// cost feedback; once earlier invocations of this call-site have
+		// been measured, resize slices toward equal wall-time instead of
+		// equal item counts (per-item costs vary by 100x in e.g. LosMap)
+		const int itemCostNs = (profile != nullptr) ? profile->avgItemCostNs.load(std::memory_order_relaxed) : 0;
+
+		if (itemCostNs > 0)
+			sliceSize = std::max(1, std::min(TARGET_SLICE_TIME_NS / itemCostNs, numItems - numClaimed));
+
+		const int slicePos = ctr.fetch_add(sliceSize, std::memory_order_relaxed);
+
+		if (slicePos >= numItems)
+			return false;
+
+		const int sliceEnd = std::min(slicePos + sliceSize, numItems);
+		const spring_time t0 = spring_now();
+
+		for (int n = slicePos; n < sliceEnd; n++) {
+			func(from + (step * n));
 		}
 
-		return false;
+		if (profile != nullptr) {
+			// races between slices only lose an update, which is benign
+			const int newCostNs = std::max(1, int((spring_now() - t0).toNanoSecsi() / (sliceEnd - slicePos)));
+			const int oldCostNs = profile->avgItemCostNs.load(std::memory_order_relaxed);
+
+			// converges within a handful of invocations, then tracks drift
+			profile->avgItemCostNs.store((oldCostNs == 0) ? newCostNs : ((oldCostNs * 3 + newCostNs) / 4), std::memory_order_relaxed);
+		}
+
+		remainingTasks -= (sliceEnd - slicePos);
+		return true;
 	}
 
 private:
 	std::atomic<int> ctr;
 	std::function<void(const int)> func;
+	ForMTProfile* profile;
 
 	int from;
 	int to;
 	int step;
+	int numItems;
 };
 #endif
 
@@ -683,9 +740,13 @@ static inline void for_mt(int start, int end, int step, F&& f)
 
 	// static, so TaskGroup's are recycled
 	static TaskPool<ForTaskGroup, F> pool;
+	// also static, so per-item cost measurements survive across invocations
+	// of this call-site (every lambda type instantiates its own copy)
+	static ForMTProfile costProfile;
+
 	auto taskGroup = pool.GetTaskGroup();
 
-	taskGroup->Enqueue(start, end, step, f);
+	taskGroup->Enqueue(start, end, step, f, &costProfile);
 	taskGroup->UpdateId();
 
 	assert(taskGroup->IsInJobQueue());
@@ -0,0 +1,96 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef WS_DEQUE_HPP
+#define WS_DEQUE_HPP
+
+#include <atomic>
+
+namespace spring {
+	// bounded lock-free work-stealing deque (Chase-Lev); the owning thread
+	// pushes and pops at the bottom in LIFO order (cache-hot, uncontended in
+	// the common case) while any other thread steals from the top in FIFO
+	// order, so idle workers drain the oldest work first
+	//
+	// N must be a power of two and T must be trivially copyable (the slots
+	// are atomics); push_bottom() and pop_bottom() may only be called by the
+	// owning thread, steal() by any thread
+	template<typename T, unsigned int N>
+	class ws_deque {
+	public:
+		static_assert(N != 0 && (N & (N - 1)) == 0, "capacity must be a power of two");
+
+		ws_deque(): top(0), bottom(0) {}
+
+		ws_deque(const ws_deque&) = delete;
+		ws_deque& operator=(const ws_deque&) = delete;
+
+		// returns false without blocking if the deque is full
+		bool push_bottom(T item) {
+			const long b = bottom.load(std::memory_order_relaxed);
+			const long t = top.load(std::memory_order_acquire);
+
+			if ((b - t) >= static_cast<long>(N))
+				return false;
+
+			slots[b & (N - 1)].store(item, std::memory_order_relaxed);
+			bottom.store(b + 1, std::memory_order_release);
+			return true;
+		}
+
+		// returns false if the deque is empty (or the last item was stolen)
+		bool pop_bottom(T& item) {
+			const long b = bottom.load(std::memory_order_relaxed) - 1;
+			bottom.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			long t = top.load(std::memory_order_relaxed);
+
+			if (t > b) {
+				// deque was already empty, undo the decrement
+				bottom.store(b + 1, std::memory_order_relaxed);
+				return false;
+			}
+
+			item = slots[b & (N - 1)].load(std::memory_order_relaxed);
+
+			if (t == b) {
+				// last item, race any concurrent stealers for it
+				if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+					bottom.store(b + 1, std::memory_order_relaxed);
+					return false;
+				}
+
+				bottom.store(b + 1, std::memory_order_relaxed);
+			}
+
+			return true;
+		}
+
+		// returns false if the deque is empty or the CAS lost to a
+		// concurrent steal/pop; callers are expected to move on to
+		// the next victim rather than retry
+		bool steal(T& item) {
+			long t = top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			const long b = bottom.load(std::memory_order_acquire);
+
+			if (t >= b)
+				return false;
+
+			item = slots[t & (N - 1)].load(std::memory_order_relaxed);
+			return (top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed));
+		}
+
+		bool empty() const {
+			return (top.load(std::memory_order_relaxed) >= bottom.load(std::memory_order_relaxed));
+		}
+
+	private:
+		std::atomic<T> slots[N];
+
+		// keep the steal- and owner-side cursors on separate cache lines
+		alignas(64) std::atomic<long> top;
+		alignas(64) std::atomic<long> bottom;
+	};
+}
+
+#endif // WS_DEQUE_HPP
@@ -2,7 +2,9 @@
 
 #include <algorithm>
 #include <climits>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
 
 #include "System/TimeProfiler.h"
 #include "System/GlobalRNG.h"
@@ -196,6 +198,14 @@ ScopedMtTimer::~ScopedMtTimer()
 
 CTimeProfiler::CTimeProfiler()
 {
+	// the span ring is deliberately not part of ResetState; workers might
+	// already be writing to it lock-free when the aggregates are reset
+	memset(spans, 0, sizeof(spans));
+	spanWritePos = 0;
+
+	spanDumpThreshMs = 0.0f;
+	lastSpanDumpTime = spring_notime;
+
 	ResetState();
 }
 
@@ -365,6 +375,10 @@ void CTimeProfiler::AddTime(
 ) {
 	const spring_time t0 = spring_now();
 
+	// always feed the span ring; a stutter has to be inspectable
+	// even when the aggregating profiler itself is switched off
+	RecordSpan(name, startTime, deltaTime);
+
 	if (!enabled) {
 		if (!specialTimer)
 			return;
@@ -420,6 +434,111 @@ void CTimeProfiler::AddTimeRaw(
 	}
 }
 
+void CTimeProfiler::RecordSpan(const std::string& name, const spring_time startTime, const spring_time deltaTime)
+{
+	if (deltaTime.toNanoSecsi() < minSpanTimeNs)
+		return;
+
+	// claiming a slot is a single relaxed RMW; a producer lapping the ring
+	// during another producer's write could tear a span, which a timeline
+	// viewer renders as one bogus entry at worst
+	ProfileSpan& span = spans[spanWritePos.fetch_add(1, std::memory_order_relaxed) & (numSpans - 1)];
+
+	strncpy(span.name, name.c_str(), sizeof(span.name) - 1);
+	span.name[sizeof(span.name) - 1] = 0;
+
+	#ifdef THREADPOOL
+	span.tid = ThreadPool::GetThreadNum();
+	#else
+	span.tid = 0;
+	#endif
+
+	span.beginNs = startTime.toNanoSecsi();
+	span.endNs = span.beginNs + deltaTime.toNanoSecsi();
+}
+
+void CTimeProfiler::GetSpans(std::vector<ProfileSpan>& out) const
+{
+	const unsigned writePos = spanWritePos.load();
+
+	out.clear();
+	out.reserve(numSpans);
+
+	// oldest first; slots ahead of writePos wrapped around longest ago
+	for (unsigned i = 0; i < numSpans; i++) {
+		const ProfileSpan& span = spans[(writePos + i) & (numSpans - 1)];
+
+		if (span.beginNs == 0 || span.endNs < span.beginNs)
+			continue;
+
+		out.push_back(span);
+	}
+}
+
+bool CTimeProfiler::DumpSpanTrace(const char* fileName)
+{
+	char nameBuf[128];
+
+	if (fileName == nullptr) {
+		snprintf(nameBuf, sizeof(nameBuf), "profile-trace-%u.json", unsigned(spring_gettime().toSecsi()));
+		fileName = nameBuf;
+	}
+
+	std::ofstream file(fileName);
+
+	if (!file.is_open()) {
+		LOG_L(L_WARNING, "[TimeProfiler::%s] could not open \"%s\" for writing", __func__, fileName);
+		return false;
+	}
+
+	// trace-event format (chrome://tracing, https://ui.perfetto.dev);
+	// "ts" and "dur" are in fractional microseconds, "ph":"X" denotes
+	// a complete (begin+duration) event
+	file << "{\"traceEvents\":[";
+
+	const unsigned writePos = spanWritePos.load();
+
+	unsigned numWritten = 0;
+
+	// oldest first; slots ahead of writePos wrapped around longest ago
+	for (unsigned i = 0; i < numSpans; i++) {
+		const ProfileSpan& span = spans[(writePos + i) & (numSpans - 1)];
+
+		if (span.beginNs == 0)
+			continue;
+
+		if (numWritten > 0)
+			file << ",";
+
+		file << "\n{\"name\":\"" << span.name << "\"";
+		file << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << span.tid;
+		file << ",\"ts\":" << (span.beginNs * 0.001);
+		file << ",\"dur\":" << ((span.endNs - span.beginNs) * 0.001) << "}";
+
+		numWritten += 1;
+	}
+
+	file << "\n]}\n";
+
+	LOG("[TimeProfiler::%s] wrote %u spans to \"%s\"", __func__, numWritten, fileName);
+	return true;
+}
+
+void CTimeProfiler::AutoDumpSpanTrace(const float frameTimeMs)
+{
+	if (spanDumpThreshMs <= 0.0f || frameTimeMs < spanDumpThreshMs)
+		return;
+
+	// rate-limit; a sustained stall would otherwise dump every frame
+	if ((spring_gettime() - lastSpanDumpTime).toMilliSecsf() < 10.0f * 1000.0f)
+		return;
+
+	lastSpanDumpTime = spring_gettime();
+
+	LOG_L(L_WARNING, "[TimeProfiler::%s] sim-frame took %.1fms (threshold %.1fms)", __func__, frameTimeMs, spanDumpThreshMs);
+	DumpSpanTrace();
+}
+
 void CTimeProfiler::PrintProfilingInfo() const
 {
 	if (sortedProfile.empty())
@@ -4,6 +4,7 @@
 #define TIME_PROFILER_H
 
 #include <atomic>
+#include <cstdint>
 #include <cstring> // memset
 #include <string>
 #include <deque>
@@ -136,6 +137,18 @@ public:
 		const bool threadTimer
 	);
 
+	/// lock-free; also called when the aggregating profiler is disabled
+	void RecordSpan(const std::string& name, const spring_time startTime, const spring_time deltaTime);
+
+	/// write the span ring as Chrome trace-event JSON (chrome://tracing,
+	/// https://ui.perfetto.dev); pass nullptr for a generated file name
+	bool DumpSpanTrace(const char* fileName = nullptr);
+	/// dump automatically (rate-limited) when a sim-frame exceeded the threshold
+	void AutoDumpSpanTrace(const float frameTimeMs);
+
+	void SetSpanDumpThreshold(const float timeMs) { spanDumpThreshMs = timeMs; }
+	float GetSpanDumpThreshold() const { return spanDumpThreshMs; }
+
 public:
 	struct TimeRecord {
 		TimeRecord()
@@ -170,12 +183,37 @@ public:
 		bool showGraph;
 	};
 
+	// one completed scoped-timer interval; the ring holds the most recent
+	// numSpans of these across all threads so stutters can be re-examined
+	// on a timeline after the fact
+	struct ProfileSpan {
+		char name[40];
+		int tid;
+		std::int64_t beginNs; // 0 while the slot was never written
+		std::int64_t endNs;
+	};
+
+	/// racy-but-benign snapshot of the span ring for offline aggregation
+	/// (benchmark mode); never-written and torn slots are skipped
+	void GetSpans(std::vector<ProfileSpan>& out) const;
+
 	spring::unordered_map<std::string, TimeRecord> profile;
 
 	std::vector< std::pair<std::string, TimeRecord> > sortedProfile;
 	std::vector< std::deque< std::pair<spring_time, spring_time> > > profileCore;
 
 private:
+	static constexpr unsigned numSpans = 1 << 15;
+	// idle worker-thread polls produce masses of sub-microsecond scopes,
+	// skip everything too short to be visible on a timeline anyway
+	static constexpr std::int64_t minSpanTimeNs = 5 * 1000;
+
+	ProfileSpan spans[numSpans];
+	std::atomic<unsigned> spanWritePos;
+
+	float spanDumpThreshMs;
+	spring_time lastSpanDumpTime;
+
 	spring_time lastBigUpdate;
 
 	/// increases each update, from 0 to (numFrames-1)
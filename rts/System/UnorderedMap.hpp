@@ -37,7 +37,7 @@
 	namespace spring {
 		template<typename K, typename V, typename H = spring::synced_hash<K>, typename C = emilib::HashMapEqualTo<K>>
 		using unordered_map = emilib::HashMap<K, V, H, C>;
-		template<typename K, typename V, typename H = std::hash<K>, typename C = emilib::HashMapEqualTo<K>>
+		template<typename K, typename V, typename H = spring::unsynced_hash<K>, typename C = emilib::HashMapEqualTo<K>>
 		using unsynced_map = emilib::HashMap<K, V, H, C>;
 	};
 #endif
@@ -35,7 +35,7 @@
 	namespace spring {
 		template<typename K, typename H = spring::synced_hash<K>, typename C = emilib::HashSetEqualTo<K>>
 		using unordered_set = emilib::HashSet<K, H, C>;
-		template<typename K, typename H = std::hash<K>, typename C = emilib::HashSetEqualTo<K>>
+		template<typename K, typename H = spring::unsynced_hash<K>, typename C = emilib::HashSetEqualTo<K>>
 		using unsynced_set = emilib::HashSet<K, H, C>;
 	};
 #endif
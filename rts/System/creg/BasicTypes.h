@@ -12,6 +12,13 @@ namespace creg {
 		typedef typename T::iterator iterator;
 		typedef typename T::value_type ElemT;
 
+		// only contiguous containers of arithmetic/enum elements may take
+		// the packed-blob path below (deques give no contiguity guarantee,
+		// creg'ed element structs have an identity pointers can refer to)
+		static const bool isPackable =
+			(std::is_arithmetic<ElemT>::value || std::is_enum<ElemT>::value) &&
+			(std::is_same<T, std::vector<ElemT>>::value || std::is_same<T, std::string>::value);
+
 		std::shared_ptr<IType> elemType;
 
 		DynamicArrayType(std::shared_ptr<IType> et)
@@ -23,19 +30,30 @@ namespace creg {
 			if (s->IsWriting()) {
 				int size = (int)ct.size();
 				s->SerializeInt(&size, sizeof(int));
-				for (int a = 0; a < size; a++) {
-					elemType->Serialize(s, &ct[a]);
-				}
+				SerializeElems(s, ct, size);
 			} else {
 				ct.clear();
 				int size;
 				s->SerializeInt(&size, sizeof(int));
 				ct.resize(size);
-				for (int a = 0; a < size; a++) {
-					elemType->Serialize(s, &ct[a]);
-				}
+				SerializeElems(s, ct, size);
 			}
 		}
+
+		// packed-blob fast path, bulk-copies the element data in one go
+		// instead of dispatching per element (package format v2)
+		template<bool P = isPackable>
+		typename std::enable_if<P>::type SerializeElems(ISerializer* s, T& ct, int size) {
+			if (size > 0)
+				s->Serialize(&ct[0], size * sizeof(ElemT));
+		}
+		template<bool P = isPackable>
+		typename std::enable_if<!P>::type SerializeElems(ISerializer* s, T& ct, int size) {
+			for (int a = 0; a < size; a++) {
+				elemType->Serialize(s, &ct[a]);
+			}
+		}
+
 		std::string GetName() const { return elemType->GetName() + "[]"; }
 		size_t GetSize() const { return sizeof(T); }
 	};
@@ -59,10 +77,23 @@ namespace creg {
 	{
 	public:
 		typedef T ArrayType[Size];
+
+		static const bool isPackable = (std::is_arithmetic<T>::value || std::is_enum<T>::value);
+
 		StaticArrayType(std::shared_ptr<IType> et)
 			: StaticArrayBaseType(et, Size, sizeof(ArrayType)/Size) {}
 		void Serialize(ISerializer* s, void* instance)
 		{
+			SerializeElems(s, instance);
+		}
+
+		// @see DynamicArrayType::SerializeElems
+		template<bool P = isPackable>
+		typename std::enable_if<P>::type SerializeElems(ISerializer* s, void* instance) {
+			s->Serialize(instance, sizeof(ArrayType));
+		}
+		template<bool P = isPackable>
+		typename std::enable_if<!P>::type SerializeElems(ISerializer* s, void* instance) {
 			T* array = (T*)instance;
 			for (int a = 0; a < Size; a++)
 				elemType->Serialize(s, &array[a]);
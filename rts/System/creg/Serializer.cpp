@@ -31,8 +31,9 @@ using std::vector;
 
 LOG_REGISTER_SECTION_GLOBAL(LOG_SECTION_CREG_SERIALIZER)
 
-//
-#define CREG_PACKAGE_FILE_ID "CRPK"
+// format v2: packed blobs for trivially-copyable array data, raw floats,
+// no per-member size tables in the object table
+#define CREG_PACKAGE_FILE_ID "CRP2"
 
 // File format structures
 struct PackageHeader
@@ -143,16 +144,12 @@ COutputStreamSerializer::ObjectRef* COutputStreamSerializer::FindObjectRef(void*
 	return nullptr;
 }
 
-void COutputStreamSerializer::SerializeObject(Class* c, void* ptr, ObjectRef* objr)
+void COutputStreamSerializer::SerializeObject(Class* c, void* ptr)
 {
 	const unsigned objstart = stream->tellp();
 
 	if (c->base())
-		SerializeObject(c->base(), ptr, objr);
-
-	ObjectMemberGroup omg;
-	omg.membersClass = c;
-	omg.size = 0;
+		SerializeObject(c->base(), ptr);
 
 	for (uint a = 0; a < c->members.size(); a++)
 	{
@@ -160,34 +157,14 @@ void COutputStreamSerializer::SerializeObject(Class* c, void* ptr, ObjectRef* ob
 		if (m->flags & CM_NoSerialize)
 			continue;
 
-		ObjectMember om;
-		om.member = m;
-		om.memberId = a;
 		void* memberAddr = ((char*)ptr) + m->offset;
-		unsigned mstart = stream->tellp();
 		LOG_SL(LOG_SECTION_CREG_SERIALIZER, L_DEBUG, "Serialized %s::%s type:%s", c->name.c_str(), m->name, m->type->GetName().c_str());
 		m->type->Serialize(this, memberAddr);
-		unsigned mend = stream->tellp();
-		om.size = mend - mstart;
-		omg.members.push_back(om);
-		omg.size += om.size;
-		LOG_SL(LOG_SECTION_CREG_SERIALIZER, L_DEBUG, "Serialized %s::%s type:%s size:%d", c->name.c_str(), m->name, m->type->GetName().c_str(), om.size);
 	}
 
 
-	if (c->HasSerialize()) {
-		ObjectMember om;
-		om.member = nullptr;
-		om.memberId = -1;
-		unsigned mstart = stream->tellp();
+	if (c->HasSerialize())
 		c->CallSerializeProc(ptr, this);
-		unsigned mend = stream->tellp();
-		om.size = mend - mstart;
-		omg.members.push_back(om);
-		omg.size += om.size;
-	}
-
-	objr->memberGroups.push_back(omg);
 
 	const unsigned objend = stream->tellp();
 	const int sz = objend - objstart;
@@ -220,7 +197,7 @@ void COutputStreamSerializer::SerializeObjectInstance(void* inst, creg::Class* o
 	WriteVarSizeUInt(stream, obj->id);
 
 	// write the object
-	SerializeObject(objClass, inst, obj);
+	SerializeObject(objClass, inst);
 }
 
 void COutputStreamSerializer::SerializeObjectPtr(void** ptr, creg::Class* objClass)
@@ -304,7 +281,7 @@ void COutputStreamSerializer::SavePackage(std::ostream* s, void* rootObj, Class*
 		for (std::vector<ObjectRef*>::const_iterator i = po.begin(); i != po.end(); ++i)
 		{
 			ObjectRef* obj = *i;
-			SerializeObject(obj->class_, obj->ptr, obj);
+			SerializeObject(obj->class_, obj->ptr);
 			//LOG_SL(LOG_SECTION_CREG_SERIALIZER, L_DEBUG, "Serialized %s size:%i", obj->class_->name.c_str(), sz);
 		}
 	}
@@ -351,45 +328,14 @@ void COutputStreamSerializer::SavePackage(std::ostream* s, void* rootObj, Class*
 		WriteZStr(*stream, c->name);
 	};
 
-	// Write object info
+	// Write object info; v2 carries no per-member size tables, the
+	// class layouts (schema) written above fully describe the data
 	ph.objTableOffset = (int)stream->tellp();
 	ph.numObjects = objects.size();
 	for (ObjectRef& oRef: objects) {
-		int classRefIndex = oRef.classIndex;
 		char isEmbedded = oRef.isEmbedded ? 1 : 0;
-		WriteVarSizeUInt(stream, classRefIndex);
+		WriteVarSizeUInt(stream, oRef.classIndex);
 		stream->write((char*)&isEmbedded, sizeof(char));
-
-		char mgcnt = oRef.memberGroups.size();
-		WriteVarSizeUInt(stream, mgcnt);
-
-		std::vector<COutputStreamSerializer::ObjectMemberGroup>::iterator j;
-		for (j = oRef.memberGroups.begin(); j != oRef.memberGroups.end(); ++j) {
-			std::map<creg::Class*, ClassRef>::iterator cr = classMap.find(j->membersClass);
-			if (cr == classMap.end()) throw "Cannot find member class ref";
-			int cid = cr->second.index;
-			WriteVarSizeUInt(stream, cid);
-
-			unsigned int mcnt = j->members.size();
-			WriteVarSizeUInt(stream, mcnt);
-
-			bool hasSerializerMember = false;
-			char groupFlags = 0;
-			if (!j->members.empty() && (j->members.back().memberId == -1)) {
-				groupFlags |= 0x01;
-				hasSerializerMember = true;
-			}
-			stream->write((char*)&groupFlags, sizeof(char));
-
-			int midx = 0;
-			std::vector<COutputStreamSerializer::ObjectMember>::iterator k;
-			for (k = j->members.begin(); k != j->members.end(); ++k, ++midx) {
-				if ((k->memberId != midx) && (!hasSerializerMember || k != (j->members.end() - 1))) {
-					throw "Invalid member id";
-				}
-				WriteVarSizeUInt(stream, k->size);
-			}
-		}
 	}
 
 	// Calculate a checksum for metadata verification
@@ -579,22 +525,8 @@ void CInputStreamSerializer::LoadPackage(std::istream* s, void*& root, creg::Cla
 	{
 		unsigned int classRefIndex;
 		char isEmbedded;
-		unsigned int mgcnt;
 		ReadVarSizeUInt(stream, &classRefIndex);
 		stream->read((char*)&isEmbedded, sizeof(char));
-		ReadVarSizeUInt(stream, &mgcnt);
-
-		for (unsigned int b = 0; b < mgcnt; b++) {
-			unsigned int cid, mcnt;
-			char groupFlags;
-			ReadVarSizeUInt(stream, &cid);
-			ReadVarSizeUInt(stream, &mcnt);
-			stream->read((char*)&groupFlags, sizeof(char));
-			for (unsigned int c = 0; c < mcnt; c++) {
-				unsigned int size;
-				ReadVarSizeUInt(stream, &size);
-			}
-		}
 
 		objects[a].obj = NULL;
 		if (!isEmbedded) {
@@ -23,16 +23,6 @@ namespace creg {
 	class COutputStreamSerializer : public ISerializer
 	{
 	protected:
-		struct ObjectMember {
-			Class::Member* member;
-			int memberId;
-			int size;
-		};
-		struct ObjectMemberGroup {
-			Class* membersClass;
-			std::vector<COutputStreamSerializer::ObjectMember> members;
-			int size;
-		};
 		struct ObjectRef {
 			ObjectRef() {
 				ptr = 0;
@@ -48,18 +38,10 @@ namespace creg {
 				this->isEmbedded=isEmbedded;
 				this->class_=class_;
 			}
-			ObjectRef(const ObjectRef&src) :memberGroups(src.memberGroups){
-				ptr=src.ptr;
-				id=src.id;
-				classIndex=src.classIndex;
-				isEmbedded=src.isEmbedded;
-				class_=src.class_;
-			}
 			void* ptr;
 			int id, classIndex;
 			bool isEmbedded;
 			Class* class_;
-			std::vector<COutputStreamSerializer::ObjectMemberGroup> memberGroups;
 			bool isThisObject(void* objPtr, Class* objClass, bool objEmbedded) const
 			{
 				if (ptr != objPtr) return false;
@@ -94,7 +76,7 @@ namespace creg {
 
 		ObjectRef* FindObjectRef(void* inst, Class* objClass, bool isEmbedded);
 
-		void SerializeObject(Class* c, void* ptr, ObjectRef* objr);
+		void SerializeObject(Class* c, void* ptr);
 
 	public:
 		COutputStreamSerializer();
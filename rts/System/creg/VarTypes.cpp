@@ -20,7 +20,20 @@ using std::string;
 
 void BasicType::Serialize(ISerializer* s, void* inst)
 {
-	s->SerializeInt(inst, GetSize());
+	switch (id) {
+#if defined(SYNCDEBUG) || defined(SYNCCHECK)
+		case crSyncedFloat:
+#endif
+		case crFloat: {
+			// raw copy; var-size int encoding only inflates float bit patterns
+			s->Serialize(inst, GetSize());
+			break;
+		}
+		default: {
+			s->SerializeInt(inst, GetSize());
+			break;
+		}
+	}
 }
 
 std::string BasicType::GetName() const
@@ -272,6 +272,22 @@ public: \
 	void TCls::_DestructInstance(void* d) { ((MyType*)d)->~MyType(); } \
 	creg::ClassBinder TCls::binder(#TCls, creg::CF_None, nullptr, &TCls::_CregRegisterMembers, sizeof(TCls), alignof(TCls), TCls::creg_hasVTable, TCls::creg_isStruct, TCls::_ConstructInstance, TCls::_DestructInstance, nullptr, nullptr);
 
+/** @def CR_BIND_POOL
+ * Bind a class not derived from CObject which is pool-allocated
+ * should be used in the source file
+ * @param TCls class to bind
+ * @param ctor_args constructor arguments
+ * @param poolAlloc pool function used to allocate
+ * @param poolFree pool function used to free
+ */
+#define CR_BIND_POOL(TCls, ctor_args, poolAlloc, poolFree) \
+	bool TCls::creg_hasVTable = std::is_polymorphic<TCls>::value; \
+	void* TCls::_Alloc() { return poolAlloc<MyType>(ctor_args); } \
+	void TCls::_Free(void* d) { MyType* mt = (MyType*) d; return poolFree<MyType>(mt); } \
+	void TCls::_ConstructInstance(void* d) { } \
+	void TCls::_DestructInstance(void* d) { } \
+	creg::ClassBinder TCls::binder(#TCls, creg::CF_None, nullptr, &TCls::_CregRegisterMembers, sizeof(TCls), alignof(TCls), TCls::creg_hasVTable, TCls::creg_isStruct, nullptr, nullptr, TCls::_Alloc, TCls::_Free);
+
 /** @def CR_BIND_DERIVED
  * Bind a derived class declared with CR_DECLARE to creg
  * Should be used in the source file
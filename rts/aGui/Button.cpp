@@ -21,6 +21,7 @@ void Button::Label(const std::string& _label)
 	label = _label;
 	clicked = false;
 	hovered = false;
+	SetDrawDirty();
 }
 
 void Button::DrawSelf()
@@ -67,6 +68,7 @@ bool Button::HandleEventSelf(const SDL_Event& ev)
 					&& gui->MouseOverElement(GetRoot(), ev.button.x, ev.button.y))
 			{
 				clicked = true;
+				SetDrawDirty();
 			}
 			break;
 		}
@@ -81,19 +83,22 @@ bool Button::HandleEventSelf(const SDL_Event& ev)
 					LOG_L(L_WARNING, "Button %s clicked without callback", label.c_str());
 				}
 				clicked = false;
+				SetDrawDirty();
 				return true;
 			}
 			break;
 		}
 		case SDL_MOUSEMOTION: {
-			if (MouseOver(ev.motion.x, ev.motion.y)
-					&& gui->MouseOverElement(GetRoot(), ev.motion.x, ev.motion.y))
-			{
-				hovered = true;
-			} else {
-				hovered = false;
-				clicked = false;
-			}
+			const bool over = MouseOver(ev.motion.x, ev.motion.y)
+					&& gui->MouseOverElement(GetRoot(), ev.motion.x, ev.motion.y);
+
+			// only rebuild the retained geometry on actual transitions,
+			// not on every motion event
+			if (hovered != over || (!over && clicked))
+				SetDrawDirty();
+
+			hovered = over;
+			clicked = (clicked && over);
 			break;
 		}
 	}
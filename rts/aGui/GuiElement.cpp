@@ -9,8 +9,9 @@ namespace agui
 
 int GuiElement::screensize[2];
 int GuiElement::screenoffset[2];
+int GuiElement::displayGeoEpoch = 0;
 
-GuiElement::GuiElement(GuiElement* _parent) : parent(_parent), fixedSize(false), weight(1)
+GuiElement::GuiElement(GuiElement* _parent) : parent(_parent), fixedSize(false), weight(1), drawList(0), drawListEpoch(-1), drawDirty(true)
 {
 	size[0] = size[1] = 0.0f;
 	pos[0] = pos[1] = 0.0f;
@@ -21,6 +22,9 @@ GuiElement::GuiElement(GuiElement* _parent) : parent(_parent), fixedSize(false),
 
 GuiElement::~GuiElement()
 {
+	if (drawList != 0)
+		glDeleteLists(drawList, 1);
+
 	for (ChildList::iterator it = children.begin(); it != children.end(); ++it)
 	{
 		delete *it;
@@ -29,7 +33,25 @@ GuiElement::~GuiElement()
 
 void GuiElement::Draw()
 {
-	DrawSelf();
+	if (!CanCacheDrawSelf()) {
+		DrawSelf();
+	} else if (drawDirty || drawList == 0 || drawListEpoch != displayGeoEpoch) {
+		// rebuild the retained geometry and draw it in the same pass;
+		// widgets only go dirty on state changes (resize, hover, text
+		// edits) so most frames just replay the compiled list
+		if (drawList == 0)
+			drawList = glGenLists(1);
+
+		glNewList(drawList, GL_COMPILE_AND_EXECUTE);
+		DrawSelf();
+		glEndList();
+
+		drawListEpoch = displayGeoEpoch;
+		drawDirty = false;
+	} else {
+		glCallList(drawList);
+	}
+
 	for (ChildList::iterator it = children.begin(); it != children.end(); ++it)
 	{
 		(*it)->Draw();
@@ -65,6 +87,10 @@ void GuiElement::UpdateDisplayGeo(int x, int y, int xOffset, int yOffset)
 	screensize[1] = y;
 	screenoffset[0] = xOffset;
 	screenoffset[1] = yOffset;
+
+	// text wrapping and pixel conversions depend on these, force every
+	// element to rebuild its retained geometry
+	displayGeoEpoch += 1;
 }
 
 float GuiElement::PixelToGlX(int x)
@@ -110,8 +136,14 @@ void GuiElement::SetSize(float x, float y, bool fixed)
 	GeometryChange();
 }
 
+void GuiElement::SetDrawDirty()
+{
+	drawDirty = true;
+}
+
 void GuiElement::GeometryChange()
 {
+	drawDirty = true;
 	GeometryChangeSelf();
 	for (ChildList::iterator it = children.begin(); it != children.end(); ++it)
 	{
@@ -128,6 +160,7 @@ void GuiElement::Move(float x, float y)
 {
 	pos[0] += x;
 	pos[1] += y;
+	drawDirty = true;
 	for (ChildList::iterator it = children.begin(); it != children.end(); ++it)
 	{
 		(*it)->Move(x, y);
@@ -90,14 +90,30 @@ protected:
 		return false;
 	};
 	virtual void GeometryChangeSelf() {};
-	
+	// widgets whose DrawSelf output changes without a state change on the
+	// element itself (time-based caret, mouse-position hover) return false
+	// and keep drawing immediate-mode every frame
+	virtual bool CanCacheDrawSelf() const
+	{
+		return true;
+	};
+	// marks the retained draw list stale, must be called by any widget
+	// state change that affects its DrawSelf output (geometry changes do
+	// this automatically)
+	void SetDrawDirty();
+
 	static int screensize[2];
 	static int screenoffset[2];
-	
+	static int displayGeoEpoch;
+
 	bool fixedSize;
 	float pos[2];
 	float size[2];
 	unsigned weight;
+
+	unsigned int drawList;
+	int drawListEpoch;
+	bool drawDirty;
 };
 
 }
@@ -21,11 +21,13 @@ LineEdit::LineEdit(GuiElement* parent)
 void LineEdit::SetFocus(bool focus)
 {
 	hasFocus = focus;
+	SetDrawDirty();
 }
 
 void LineEdit::SetCrypt(bool focus)
 {
 	crypt = focus;
+	SetDrawDirty();
 }
 
 void LineEdit::SetContent(const std::string& line, bool moveCursor)
@@ -34,6 +36,7 @@ void LineEdit::SetContent(const std::string& line, bool moveCursor)
 	if (moveCursor) {
 		cursorPos = content.size();
 	}
+	SetDrawDirty();
 }
 
 void LineEdit::DrawSelf()
@@ -84,11 +87,10 @@ bool LineEdit::HandleEventSelf(const SDL_Event& ev)
 {
 	switch (ev.type) {
 		case SDL_MOUSEBUTTONDOWN: {
-			if (MouseOver(ev.button.x, ev.button.y)) {
-				hasFocus = true;
-			} else {
-				hasFocus = false;
-			}
+			if (hasFocus != MouseOver(ev.button.x, ev.button.y))
+				SetDrawDirty();
+
+			hasFocus = MouseOver(ev.button.x, ev.button.y);
 			break;
 		}
 		case SDL_KEYDOWN: {
@@ -111,6 +113,7 @@ bool LineEdit::HandleEventSelf(const SDL_Event& ev)
 				}
 				case SDLK_ESCAPE: {
 					hasFocus = false;
+					SetDrawDirty();
 					break;
 				}
 				case SDLK_RIGHT: {
@@ -30,6 +30,11 @@ public:
 private:
 	virtual void DrawSelf();
 	virtual bool HandleEventSelf(const SDL_Event& ev);
+	// the blinking caret is time-based, draw immediate while focused
+	virtual bool CanCacheDrawSelf() const
+	{
+		return !hasFocus;
+	};
 
 	bool hasFocus;
 	bool crypt;
@@ -48,6 +48,13 @@ public:
 	void RefreshQuery();
 
 private:
+	// hover highlights and scrollbar drags depend on the live mouse
+	// position and mutate state inside DrawSelf, keep drawing immediate
+	virtual bool CanCacheDrawSelf() const
+	{
+		return false;
+	};
+
 	bool Filter(bool reset);
 	void UpOne();
 	void DownOne();
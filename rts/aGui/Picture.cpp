@@ -34,6 +34,7 @@ void Picture::Load(const std::string& _file)
 		LOG_L(L_WARNING, "Failed to load: %s", file.c_str());
 		texture = 0;
 	}
+	SetDrawDirty();
 }
 
 void Picture::DrawSelf()
@@ -14,6 +14,7 @@ TextElement::TextElement(const std::string& _text, GuiElement* parent) : GuiElem
 void TextElement::SetText(const std::string& str)
 {
 	text = str;
+	SetDrawDirty();
 }
 
 void TextElement::DrawSelf()
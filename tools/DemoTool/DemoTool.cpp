@@ -5,6 +5,14 @@
 #include <iostream>
 #include <gflags/gflags.h>
 #include <iomanip> //hex
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 #include "StringSerializer.h"
 
@@ -32,10 +40,24 @@ no console output (you still could use this.exe > z.tzt though).
 	DEFINE_bool  (teamstats,    false, "Print teamstats");
 	DEFINE_int32 (team,         -1,    "Select team");
 	DEFINE_string(teamsstatcsv, "",    "Write teamstats in a csv file");
+	DEFINE_string(batch,        "",    "File with one demo path per line ('-' = stdin), processed by a worker pool");
+	DEFINE_int32 (threads,      0,     "Worker threads for --batch and --split (0 = one per hardware core)");
+	DEFINE_string(format,       "csv", "Batch output format, csv or json (one record per line)");
+	DEFINE_bool  (split,        false, "Count per-NETMSG traffic of a single demo, split across threads via its frame index");
 
 
 void TrafficDump(CDemoReader& reader, bool trafficStats);
 void WriteTeamstatHistory(CDemoReader& reader, unsigned team, const std::string& file);
+int RunBatch(const std::string& listFile, unsigned numWorkers, bool json);
+int RunSplitTrafficCount(const std::string& filename, unsigned numWorkers);
+
+static unsigned GetNumWorkers()
+{
+	if (FLAGS_threads > 0)
+		return FLAGS_threads;
+
+	return std::max(1u, std::thread::hardware_concurrency());
+}
 
 int main (int argc, char* argv[])
 {
@@ -43,6 +65,10 @@ int main (int argc, char* argv[])
 
 	gflags::SetUsageMessage(std::string("Usage: ") + argv[0] + " [options] path_to_demo.sdfz");
 	gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+	if (!FLAGS_batch.empty())
+		return RunBatch(FLAGS_batch, GetNumWorkers(), FLAGS_format == "json");
+
 	if (!FLAGS_demofile.empty()) {
 		filename = FLAGS_demofile;
 	} else if (argc >= 2) {
@@ -52,6 +78,9 @@ int main (int argc, char* argv[])
 		gflags::ShowUsageWithFlags(argv[0]);
 	}
 
+	if (FLAGS_split)
+		return RunSplitTrafficCount(filename, GetNumWorkers());
+
 	CDemoReader reader(filename, 0.0f);
 	reader.LoadStats();
 	if (FLAGS_dump)
@@ -490,3 +519,184 @@ void WriteTeamstatHistory(CDemoReader& reader, unsigned team, const std::string&
 		exit(1);
 	}
 };
+
+
+static std::string GameIDToHex(const DemoFileHeader& header)
+{
+	std::ostringstream buf;
+	buf << std::hex << std::setfill('0');
+	for (int i = 0; i < 16; ++i)
+		buf << std::setw(2) << (unsigned)header.gameID[i];
+	return buf.str();
+}
+
+static std::string MakeDemoRecord(const std::string& path, bool json)
+{
+	std::ostringstream buf;
+
+	try {
+		CDemoReader reader(path, 0.0f);
+		reader.LoadStats();
+
+		const DemoFileHeader header = reader.GetFileHeader();
+		const std::vector<unsigned char>& winningAllyTeams = reader.GetWinningAllyTeams();
+
+		std::ostringstream winners;
+		for (unsigned i = 0; i < winningAllyTeams.size(); ++i)
+		{
+			if (i > 0)
+				winners << (json ? "," : " ");
+			winners << (unsigned)winningAllyTeams[i];
+		}
+
+		if (json)
+		{
+			buf << "{\"demo\":\"" << path << "\""
+			    << ",\"engine\":\"" << header.versionString << "\""
+			    << ",\"gameID\":\"" << GameIDToHex(header) << "\""
+			    << ",\"unixTime\":" << header.unixTime
+			    << ",\"gameTime\":" << header.gameTime
+			    << ",\"wallclockTime\":" << header.wallclockTime
+			    << ",\"numPlayers\":" << header.numPlayers
+			    << ",\"numTeams\":" << header.numTeams
+			    << ",\"winningAllyTeams\":[" << winners.str() << "]}";
+		}
+		else
+		{
+			buf << path << ";" << header.versionString << ";" << GameIDToHex(header) << ";"
+			    << header.unixTime << ";" << header.gameTime << ";" << header.wallclockTime << ";"
+			    << header.numPlayers << ";" << header.numTeams << ";" << winners.str();
+		}
+	} catch (const std::exception& ex) {
+		if (json)
+			buf << "{\"demo\":\"" << path << "\",\"error\":\"" << ex.what() << "\"}";
+		else
+			buf << path << ";ERROR:" << ex.what();
+	}
+
+	return buf.str();
+}
+
+int RunBatch(const std::string& listFile, unsigned numWorkers, bool json)
+{
+	std::vector<std::string> paths;
+	{
+		std::ifstream fileStream;
+		if (listFile != "-")
+		{
+			fileStream.open(listFile.c_str());
+			if (!fileStream)
+			{
+				std::cout << "Could not open demo list " << listFile << std::endl;
+				return 1;
+			}
+		}
+		std::istream& in = (listFile == "-") ? std::cin : fileStream;
+
+		std::string line;
+		while (std::getline(in, line))
+		{
+			if (!line.empty())
+				paths.push_back(line);
+		}
+	}
+
+	if (!json)
+		std::cout << "demo;engine;gameID;unixTime;gameTime;wallclockTime;numPlayers;numTeams;winningAllyTeams" << std::endl;
+
+	numWorkers = std::max(1u, std::min(numWorkers, (unsigned)paths.size()));
+
+	std::atomic<unsigned> nextPath(0);
+	std::mutex outputMutex;
+	std::vector<std::thread> workers;
+
+	for (unsigned w = 0; w < numWorkers; ++w)
+	{
+		workers.emplace_back([&]() {
+			unsigned i;
+			while ((i = nextPath.fetch_add(1)) < paths.size())
+			{
+				// records stream out as workers finish, endl flushes
+				const std::string record = MakeDemoRecord(paths[i], json);
+				std::lock_guard<std::mutex> lock(outputMutex);
+				std::cout << record << std::endl;
+			}
+		});
+	}
+	for (std::thread& worker: workers)
+		worker.join();
+
+	return 0;
+}
+
+int RunSplitTrafficCount(const std::string& filename, unsigned numWorkers)
+{
+	std::vector<DemoFrameIndexEntry> index;
+
+	try {
+		CDemoReader reader(filename, 0.0f);
+		index = reader.GetFrameIndex();
+	} catch (const std::exception& ex) {
+		std::cout << "Could not open demo " << filename << ": " << ex.what() << std::endl;
+		return 1;
+	}
+
+	// demos recorded without a frame index fall back to a linear scan
+	if (index.size() < 2 * numWorkers)
+		numWorkers = 1;
+
+	std::vector< std::vector<unsigned long> > counters(numWorkers, std::vector<unsigned long>(NETMSG_LAST, 0));
+	std::vector<std::thread> workers;
+
+	for (unsigned w = 0; w < numWorkers; ++w)
+	{
+		workers.emplace_back([&, w]() {
+			// every worker gets its own reader; byte counts per message
+			// type do not depend on global packet order, so each worker
+			// can scan its keyframe range of the stream independently
+			CDemoReader reader(filename, 0.0f);
+			int stopFrame = INT_MAX;
+
+			if (numWorkers > 1)
+			{
+				const size_t begin = (index.size() * w) / numWorkers;
+				const size_t end = (index.size() * (w + 1)) / numWorkers;
+
+				if (end < index.size())
+					stopFrame = index[end].frame;
+				if (w > 0 && reader.SeekToFrame(index[begin].frame, 0.0f) < 0)
+					return;
+			}
+
+			std::vector<unsigned long>& counter = counters[w];
+			while (!reader.ReachedEnd())
+			{
+				netcode::RawPacket* packet = reader.GetData(3.402823466e+38f);
+				if (packet == NULL)
+					continue;
+				// the keyframe at stopFrame belongs to the next worker's range
+				if (packet->data[0] == NETMSG_KEYFRAME && *(int*)(packet->data + 1) >= stopFrame)
+				{
+					delete packet;
+					break;
+				}
+				if (packet->data[0] < NETMSG_LAST)
+					counter[packet->data[0]] += packet->length;
+				delete packet;
+			}
+		});
+	}
+	for (std::thread& worker: workers)
+		worker.join();
+
+	for (unsigned msg = 0; msg < NETMSG_LAST; ++msg)
+	{
+		unsigned long total = 0;
+		for (unsigned w = 0; w < numWorkers; ++w)
+			total += counters[w][msg];
+		if (total > 0)
+			std::cout << "Msg " << msg << ": " << total << std::endl;
+	}
+
+	return 0;
+}
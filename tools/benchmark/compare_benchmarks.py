@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+# Compares two benchmark.json reports (written by the engine when run
+# with --benchmark, see rts/Game/Benchmark.cpp) and flags regressions.
+#
+# usage: compare_benchmarks.py baseline.json candidate.json [threshold%]
+#
+# exits non-zero if any metric regressed by more than the threshold
+# (default 5%), so it can gate CI on a headless demo-replay run.
+
+import json
+import sys
+
+
+def load(path):
+	with open(path) as f:
+		return json.load(f)
+
+
+def rel_change(old, new):
+	if old == 0:
+		return 0.0
+	return (new - old) / old * 100.0
+
+
+def main():
+	if len(sys.argv) < 3:
+		sys.stderr.write("usage: compare_benchmarks.py baseline.json candidate.json [threshold%]\n")
+		return 2
+
+	base = load(sys.argv[1])
+	cand = load(sys.argv[2])
+	threshold = float(sys.argv[3]) if len(sys.argv) > 3 else 5.0
+
+	regressions = []
+
+	def check(name, old, new, higher_is_better):
+		change = rel_change(old, new)
+		regressed = (change < -threshold) if higher_is_better else (change > threshold)
+		flag = " <-- REGRESSION" if regressed else ""
+		print("%-60s %12.3f -> %12.3f  (%+6.1f%%)%s" % (name, old, new, change, flag))
+		if regressed:
+			regressions.append(name)
+
+	print("baseline:  %s" % base.get("engine", "?"))
+	print("candidate: %s" % cand.get("engine", "?"))
+	print()
+
+	# throughput series: higher is better, compare the bad (low) end too
+	for series in sorted(set(base.get("series", {})) & set(cand.get("series", {}))):
+		for stat in ("mean", "p01"):
+			check("series.%s.%s" % (series, stat),
+			      base["series"][series][stat], cand["series"][series][stat], True)
+
+	# memory: lower is better
+	if base.get("peakRSSKB", 0) and cand.get("peakRSSKB", 0):
+		check("peakRSSKB", base["peakRSSKB"], cand["peakRSSKB"], False)
+
+	for pool in sorted(set(base.get("allocCounts", {})) & set(cand.get("allocCounts", {}))):
+		check("allocCounts.%s" % pool,
+		      base["allocCounts"][pool], cand["allocCounts"][pool], False)
+
+	# per-subsystem scope durations: lower is better; skip scopes with too
+	# few samples in either build for percentiles to mean anything
+	print()
+	base_subs = base.get("subsystems", {})
+	cand_subs = cand.get("subsystems", {})
+
+	for name in sorted(set(base_subs) & set(cand_subs)):
+		if min(base_subs[name]["count"], cand_subs[name]["count"]) < 30:
+			continue
+		for stat in ("p50Ms", "p99Ms"):
+			check("subsystems.%s.%s" % (name, stat),
+			      base_subs[name][stat], cand_subs[name][stat], False)
+
+	print()
+	if regressions:
+		print("%d metric(s) regressed more than %.1f%%:" % (len(regressions), threshold))
+		for name in regressions:
+			print("  " + name)
+		return 1
+
+	print("no regressions above %.1f%%" % threshold)
+	return 0
+
+
+if __name__ == "__main__":
+	sys.exit(main())
@@ -0,0 +1,44 @@
+#!/bin/bash
+# Replays a fixed set of demos through spring-headless in benchmark mode
+# and collects the machine-readable benchmark.json reports, one per demo.
+# Demo replay is deterministic, so two engine builds run over the same
+# set are directly comparable with compare_benchmarks.py:
+#
+#   ./run_headless.sh /path/to/old/spring-headless demos/*.sdf
+#   mv bench_results_* baseline
+#   ./run_headless.sh /path/to/new/spring-headless demos/*.sdf
+#   for f in baseline/*.json; do
+#       ./compare_benchmarks.py "$f" bench_results_*/"$(basename "$f")"
+#   done
+
+set -e
+
+if [ $# -lt 2 ]; then
+	echo "usage: $0 <spring-headless binary> <demo.sdf> [demo.sdf ...]" >&2
+	exit 2
+fi
+
+ENGINE="$1"
+shift
+
+BENCHTIME=${BENCHTIME:-5}   # minutes measured
+BENCHSTART=${BENCHSTART:-0} # minutes skipped first (warmup)
+
+PREFIX=$PWD/bench_results_$(date +"%Y-%m-%d_%H-%M-%S")
+mkdir "$PREFIX"
+
+for DEMO in "$@"; do
+	NAME=$(basename "$DEMO" .sdf)
+	echo "Replaying $NAME"
+
+	"$ENGINE" --benchmark "$BENCHTIME" --benchmarkstart "$BENCHSTART" "$DEMO" >/dev/null 2>&1 || true
+
+	if [ -s benchmark.json ]; then
+		mv benchmark.json "$PREFIX/$NAME.json"
+		mv benchmark.data "$PREFIX/$NAME.data" 2>/dev/null || true
+	else
+		echo "  no benchmark.json produced, check infolog.txt" >&2
+	fi
+done
+
+echo "Reports in $PREFIX"
@@ -27,6 +27,8 @@
 #include "System/FileSystem/DataDirsAccess.h"
 #include "System/FileSystem/DataDirLocater.h"
 #include "System/FileSystem/FileHandler.h"
+#include "System/FileSystem/FileQueryFlags.h"
+#include "System/FileSystem/MappedFile.h"
 #include "System/FileSystem/VFSHandler.h"
 #include "System/FileSystem/FileSystem.h"
 #include "System/FileSystem/FileSystemInitializer.h"
@@ -934,11 +936,14 @@ static unsigned short* GetMinimapSMF(std::string mapFileName, int mipLevel)
 
 	unsigned char* temp = &buffer[0];
 
+	// each DXT1 block decodes into its own 4x4 pixel area, so the blocks
+	// can be unpacked independently across the pool's workers
 	const int numblocks = buffer.size()/8;
-	for ( int i = 0; i < numblocks; i++ ) {
-		unsigned short color0 = (*(unsigned short*)&temp[0]);
-		unsigned short color1 = (*(unsigned short*)&temp[2]);
-		unsigned int bits = (*(unsigned int*)&temp[4]);
+	for_mt(0, numblocks, [&](const int i) {
+		unsigned char* block = &temp[i * 8];
+		unsigned short color0 = (*(unsigned short*)&block[0]);
+		unsigned short color1 = (*(unsigned short*)&block[2]);
+		unsigned int bits = (*(unsigned int*)&block[4]);
 
 		for ( int a = 0; a < 4; a++ ) {
 			for ( int b = 0; b < 4; b++ ) {
@@ -977,8 +982,7 @@ static unsigned short* GetMinimapSMF(std::string mapFileName, int mipLevel)
 				}
 			}
 		}
-		temp += 8;
-	}
+	});
 
 	return colors;
 }
@@ -993,12 +997,46 @@ EXPORT(unsigned short*) GetMinimap(const char* mapName, int mipLevel)
 			throw std::out_of_range("Miplevel must be between 0 and 8 (inclusive) in GetMinimap.");
 
 		const std::string mapFile = GetMapFile(mapName);
+		const std::string extension = FileSystem::GetExtension(mapFile);
+
+		const size_t imgSize = (1024 >> mipLevel) * (1024 >> mipLevel) * sizeof(imgbuf[0]);
+
+		std::string cacheFile;
+
+		if (extension == "smf") {
+			// extraction is deterministic, so decoded minimaps can be reused
+			// across calls and processes; keying the file name on the map's
+			// complete checksum invalidates entries when the content changes
+			const unsigned int checksum = archiveScanner->GetArchiveCompleteChecksum(mapName);
+
+			if (checksum != 0) {
+				cacheFile = FileSystem::GetCacheDir() + "/minimaps/" + FileSystem::GetBasename(mapFile) + IntToString(mipLevel, ".mip%i-") + IntToString(checksum, "%x") + ".bin";
+
+				MappedFile cacheFileMap;
+
+				if (cacheFileMap.Open(dataDirsAccess.LocateFile(cacheFile), false) && cacheFileMap.GetSize() == imgSize) {
+					memcpy(imgbuf, cacheFileMap.GetData(), imgSize);
+					return imgbuf;
+				}
+			}
+		}
+
 		ScopedMapLoader mapLoader(mapName, mapFile);
 
 		unsigned short* ret = NULL;
-		const std::string extension = FileSystem::GetExtension(mapFile);
 		if (extension == "smf") {
+			ThreadPool::SetThreadCount(ThreadPool::GetMaxThreads());
 			ret = GetMinimapSMF(mapFile, mipLevel);
+			ThreadPool::SetThreadCount(0);
+
+			if (ret != NULL && !cacheFile.empty() && FileSystem::CreateDirectory(FileSystem::GetCacheDir() + "/minimaps/")) {
+				FILE* file = fopen(dataDirsAccess.LocateFile(cacheFile, FileQueryFlags::WRITE).c_str(), "wb");
+
+				if (file != NULL) {
+					fwrite(ret, 1, imgSize, file);
+					fclose(file);
+				}
+			}
 		} else if (extension == "sm3") {
 			ret = GetMinimapSM3(mapFile, mipLevel);
 		}